@@ -3176,6 +3176,22 @@ time_t qMkTime(struct tm *when)
     return mktime(when);
 }
 
+/*
+  Returns true if the TZ environment variable is set to \a tz, or is unset and
+  \a tz is null. Lets callers that cache zone data cheaply check whether it is
+  still what tzset() would use.
+*/
+#ifdef Q_OS_UNIX
+bool qTzMatches(const char *tz)
+{
+    const auto locker = qt_scoped_lock(environmentMutex);
+    const char *value = getenv("TZ");
+    if (!value || !tz)
+        return value == tz;
+    return qstrcmp(value, tz) == 0;
+}
+#endif
+
 // Also specified to behave as if they call tzset():
 // localtime() -- but not localtime_r(), which we use when threaded
 // strftime() -- not used (except in tests)
@@ -71,6 +71,9 @@ QT_BEGIN_NAMESPACE
 // These behave as if they consult the environment, so need to share its locking:
 Q_CORE_EXPORT void qTzSet();
 Q_CORE_EXPORT time_t qMkTime(struct tm *when);
+#ifdef Q_OS_UNIX
+Q_CORE_EXPORT bool qTzMatches(const char *tz);
+#endif
 
 QT_END_NAMESPACE
 
@@ -60,6 +60,10 @@
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
 #include <qtcore_tracepoints_p.h>
+#if QT_CONFIG(thread)
+#include "qdeadlinetimer.h"
+#include "qwaitcondition.h"
+#endif
 #endif
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
@@ -161,6 +165,7 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -1094,12 +1099,15 @@ struct QMessagePattern
 
     bool fromEnvironment;
     static QBasicMutex mutex;
+    // whether the pattern needs the stack of the thread that logs the message
+    static QBasicAtomicInt usesBacktrace;
 };
 #ifdef QLOGGING_HAVE_BACKTRACE
 Q_DECLARE_TYPEINFO(QMessagePattern::BacktraceParams, Q_MOVABLE_TYPE);
 #endif
 
 QBasicMutex QMessagePattern::mutex;
+QBasicAtomicInt QMessagePattern::usesBacktrace = Q_BASIC_ATOMIC_INITIALIZER(0);
 
 QMessagePattern::QMessagePattern()
 {
@@ -1265,6 +1273,10 @@ void QMessagePattern::setPattern(const QString &pattern)
     if (!error.isEmpty())
         qt_message_print(error);
 
+#ifdef QLOGGING_HAVE_BACKTRACE
+    usesBacktrace.storeRelaxed(!backtraceArgs.isEmpty());
+#endif
+
     literals.reset(new std::unique_ptr<const char[]>[literalsVar.size() + 1]);
     std::move(literalsVar.begin(), literalsVar.end(), &literals[0]);
 }
@@ -1354,6 +1366,21 @@ static QString formatBacktraceForLogMessage(const QMessagePattern::BacktracePara
 
 Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
 
+#ifndef QT_BOOTSTRAPPED
+// Where and when a message was logged, for messages that the asynchronous
+// logging writer thread passes to the message handler.
+struct QLogMessageOrigin
+{
+    qint64 threadId;
+    QThread *thread;
+    qint64 msecsSinceEpoch;
+    qint64 monotonicNSecs;      // QDeadlineTimer::current()
+};
+
+// set on the writer thread while a message handler runs
+static thread_local const QLogMessageOrigin *currentLogMessageOrigin = nullptr;
+#endif
+
 /*!
     \relates <QtGlobal>
     \since 5.4
@@ -1388,6 +1415,7 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
 #ifdef QLOGGING_HAVE_BACKTRACE
     int backtraceArgsIdx = 0;
 #endif
+    const QLogMessageOrigin *origin = currentLogMessageOrigin;
 #endif
 
     // we do not convert file, function, line literals to local encoding due to overhead
@@ -1437,10 +1465,11 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             message.append(QCoreApplication::applicationName());
         } else if (token == threadidTokenC) {
             // print the TID as decimal
-            message.append(QString::number(qt_gettid()));
+            message.append(QString::number(origin ? origin->threadId : qt_gettid()));
         } else if (token == qthreadptrTokenC) {
+            QThread *thread = origin ? origin->thread : QThread::currentThread();
             message.append(QLatin1String("0x"));
-            message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+            message.append(QString::number(qlonglong(thread), 16));
 #ifdef QLOGGING_HAVE_BACKTRACE
         } else if (token == backtraceTokenC) {
             QMessagePattern::BacktraceParams backtraceParams = pattern->backtraceArgs.at(backtraceArgsIdx);
@@ -1451,20 +1480,26 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             QString timeFormat = pattern->timeArgs.at(timeArgsIdx);
             timeArgsIdx++;
             if (timeFormat == QLatin1String("process")) {
-                    quint64 ms = pattern->timer.elapsed();
+                    quint64 ms = origin
+                            ? origin->monotonicNSecs / 1000000 - pattern->timer.msecsSinceReference()
+                            : pattern->timer.elapsed();
                     message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
             } else if (timeFormat ==  QLatin1String("boot")) {
                 // just print the milliseconds since the elapsed timer reference
                 // like the Linux kernel does
                 QElapsedTimer now;
                 now.start();
-                uint ms = now.msecsSinceReference();
+                uint ms = origin ? origin->monotonicNSecs / 1000000 : now.msecsSinceReference();
                 message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
 #if QT_CONFIG(datestring)
-            } else if (timeFormat.isEmpty()) {
-                    message.append(QDateTime::currentDateTime().toString(Qt::ISODate));
             } else {
-                message.append(QDateTime::currentDateTime().toString(timeFormat));
+                const QDateTime time = origin
+                        ? QDateTime::fromMSecsSinceEpoch(origin->msecsSinceEpoch)
+                        : QDateTime::currentDateTime();
+                if (timeFormat.isEmpty())
+                    message.append(time.toString(Qt::ISODate));
+                else
+                    message.append(time.toString(timeFormat));
 #endif // QT_CONFIG(datestring)
             }
 #endif // !QT_BOOTSTRAPPED
@@ -1734,6 +1769,12 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+// set on the asynchronous logging writer thread, which writes the output of a
+// batch of messages at once
+static thread_local QByteArray *stderrBatch = nullptr;
+#endif
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
     QString formattedMessage = qFormatLogMessage(type, context, message);
@@ -1743,6 +1784,13 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     if (formattedMessage.isNull())
         return;
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    if (stderrBatch) {
+        stderrBatch->append(formattedMessage.toLocal8Bit()).append('\n');
+        return;
+    }
+#endif
+
     fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1806,6 +1854,606 @@ static bool grabMessageHandler() { return true; }
 static void ungrabMessageHandler() { }
 #endif // (Q_COMPILER_THREAD_LOCAL)
 
+static void qt_message_deliver(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
+{
+    // prevent recursion in case the message handler generates messages
+    // itself, e.g. by using Qt API
+    if (grabMessageHandler()) {
+        const auto ungrab = qScopeGuard([]{ ungrabMessageHandler(); });
+        auto msgHandler = messageHandler.loadAcquire();
+        (msgHandler ? msgHandler : qDefaultMessageHandler)(msgType, context, message);
+    } else {
+        fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+    }
+}
+
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+
+// ------------------------ Asynchronous logging ----------------------------
+//
+// Each thread that logs appends its messages to a ring buffer of its own,
+// which only the writer thread reads, so logging a message takes no lock
+// unless the writer thread has to be woken up. The writer thread collects
+// the messages of all buffers, orders them by time and passes them to the
+// message handler, writing the output of the default stderr handler once per
+// batch.
+
+namespace {
+
+// The header of a message in a LogBuffer. It is followed by the message and
+// the category, file and function names, including their terminating nulls.
+struct LogRecord
+{
+    quint32 size;               // of the record including the strings, 0 for wrapping to the start
+    qint32 type;
+    int line;
+    int categorySize;           // -1 for null strings
+    int fileSize;
+    int functionSize;
+    qsizetype messageSize;      // in QChars
+    QLogMessageOrigin origin;
+
+    const QChar *message() const { return reinterpret_cast<const QChar *>(this + 1); }
+    const char *category() const
+    { return categorySize < 0 ? nullptr : reinterpret_cast<const char *>(message() + messageSize); }
+    const char *file() const
+    { return fileSize < 0 ? nullptr : category() + qMax(categorySize, 0); }
+    const char *function() const
+    { return functionSize < 0 ? nullptr : category() + qMax(categorySize, 0) + qMax(fileSize, 0); }
+};
+
+// A single producer, single consumer ring buffer of LogRecords. Positions
+// increase monotonically and are taken modulo the capacity.
+struct LogBuffer
+{
+    explicit LogBuffer(quint64 capacity, qint64 threadId, QThread *thread)
+        : data(new char[capacity]), capacity(capacity), threadId(threadId), thread(thread)
+    {}
+
+    // Returns the offset at which to write a record of the given size and
+    // the new tail to store once it is written, or -1 if the buffer is full.
+    qint64 reserve(quint32 size, quint64 *newTail)
+    {
+        const quint64 t = tail.loadRelaxed();
+        const quint64 offset = t & (capacity - 1);
+        const quint64 contiguous = capacity - offset;
+        const quint64 needed = size <= contiguous ? size : contiguous + size;
+        if (t - head.loadAcquire() + needed > capacity)
+            return -1;
+        *newTail = t + needed;
+        if (size <= contiguous)
+            return qint64(offset);
+        reinterpret_cast<LogRecord *>(data.get() + offset)->size = 0;
+        return 0;
+    }
+
+    std::unique_ptr<char[]> data;
+    const quint64 capacity;             // a power of two
+    const qint64 threadId;
+    QThread * const thread;
+    alignas(64) QAtomicInteger<quint64> head;   // advanced by the writer thread
+    alignas(64) QAtomicInteger<quint64> tail;   // advanced by the logging thread
+    quint64 delivered = 0;              // guarded by AsyncLogger::mutex
+    QAtomicInt orphaned;                // the logging thread has exited
+    QAtomicInt producing;               // the logging thread is queuing a message
+};
+
+static thread_local bool threadLogBufferDestroyed = false;
+
+// Marks the buffer of a thread as orphaned when the thread exits, so that the
+// writer thread deletes it once it is empty.
+struct ThreadLogBuffer
+{
+    ~ThreadLogBuffer()
+    {
+        if (buffer)
+            buffer->orphaned.storeRelease(1);
+        threadLogBufferDestroyed = true;
+    }
+
+    LogBuffer *buffer = nullptr;
+};
+
+static thread_local ThreadLogBuffer threadLogBuffer;
+static thread_local bool isAsyncLogWriterThread = false;
+
+class AsyncLogger : public QThread
+{
+public:
+    AsyncLogger() { setObjectName(QStringLiteral("Qt logging")); }
+
+    void stop();
+    void enable(const QtPrivate::AsyncLoggingOptions &options);
+    bool enqueue(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    bool flush(QDeadlineTimer deadline);
+
+    QAtomicInteger<quint64> dropped;    // not reported yet
+
+protected:
+    void run() override;
+
+private:
+    LogBuffer *createThreadBuffer();
+    bool waitForSpace(LogBuffer *buffer, quint32 size);
+    void wakeWriter();
+    bool hasPendingMessages() const;
+    void deliverDroppedMessageCount(quint64 count);
+
+    QMutex mutex;
+    QWaitCondition workAvailable;       // for the writer thread
+    QWaitCondition spaceAvailable;      // for blocked logging threads and flush()
+    QList<LogBuffer *> buffers;         // guarded by mutex
+    QAtomicInteger<quint64> droppedTotal;
+    quint64 droppedReported = 0;        // guarded by mutex
+    quint64 bufferCapacity = 0;
+    QAtomicInt overflowPolicy;
+    QAtomicInt writerSleeping;
+    QAtomicInt stopping;                // new messages are printed directly
+    bool writerDone = false;            // guarded by mutex, no message is being queued
+};
+
+// The logger is stopped when the static objects of QtCore are destroyed, but
+// never deleted: threads that still log then use it to print directly.
+struct AsyncLoggerHolder
+{
+    AsyncLogger *logger = new AsyncLogger;
+    ~AsyncLoggerHolder() { logger->stop(); }
+};
+
+Q_GLOBAL_STATIC(AsyncLoggerHolder, asyncLoggerHolder)
+
+static AsyncLogger *asyncLogger()
+{
+    AsyncLoggerHolder *holder = asyncLoggerHolder();
+    return holder ? holder->logger : nullptr;
+}
+
+enum AsyncLoggingState { AsyncLoggingUndecided, AsyncLoggingOff, AsyncLoggingOn };
+static QBasicAtomicInt asyncLoggingState = Q_BASIC_ATOMIC_INITIALIZER(AsyncLoggingUndecided);
+static QBasicMutex asyncLoggingStateMutex;
+
+void AsyncLogger::stop()
+{
+    QVarLengthArray<LogBuffer *, 32> snapshot;
+    {
+        QMutexLocker locker(&mutex);
+        stopping.storeRelaxed(1);
+        workAvailable.wakeOne();
+        spaceAvailable.wakeAll();
+        snapshot.append(buffers.constData(), buffers.size());
+    }
+    // pairs with the fence in enqueue(): a thread that did not see stopping
+    // is still queuing its message, which the writer thread has to print
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (LogBuffer *buffer : snapshot) {
+        while (buffer->producing.loadAcquire())
+            QThread::yieldCurrentThread();
+    }
+    {
+        QMutexLocker locker(&mutex);
+        writerDone = true;
+        workAvailable.wakeOne();
+    }
+    wait();
+
+    // buffers of threads that are still running are kept, they may still
+    // log; their messages are printed directly from now on
+    QMutexLocker locker(&mutex);
+    const auto isOrphaned = [](LogBuffer *buffer) {
+        if (!buffer->orphaned.loadAcquire())
+            return false;
+        delete buffer;
+        return true;
+    };
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), isOrphaned), buffers.end());
+}
+
+void AsyncLogger::enable(const QtPrivate::AsyncLoggingOptions &options)
+{
+    QMutexLocker locker(&mutex);
+    const qsizetype size = qBound(qsizetype(4096), options.bufferSize, qsizetype(1) << 30);
+    bufferCapacity = quint64(1) << (64 - qCountLeadingZeroBits(quint64(size - 1)));
+    overflowPolicy.storeRelaxed(int(options.overflowPolicy));
+    if (!isRunning())
+        start();
+}
+
+LogBuffer *AsyncLogger::createThreadBuffer()
+{
+    QMutexLocker locker(&mutex);
+    if (stopping.loadRelaxed())
+        return nullptr;
+    auto buffer = new LogBuffer(bufferCapacity, qt_gettid(), QThread::currentThread());
+    buffers.append(buffer);
+    return buffer;
+}
+
+bool AsyncLogger::enqueue(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    // messages logged by message handlers on the writer thread, and messages
+    // whose output needs the stack of the logging thread, are printed directly
+    if (isAsyncLogWriterThread || QMessagePattern::usesBacktrace.loadRelaxed())
+        return false;
+
+    // the main thread's thread_local objects are destroyed before the static
+    // ones, whose destructors may still log
+    if (threadLogBufferDestroyed) {
+        flush(QDeadlineTimer::Forever);
+        return false;
+    }
+    LogBuffer *buffer = threadLogBuffer.buffer;
+    if (!buffer && !(buffer = threadLogBuffer.buffer = createThreadBuffer()))
+        return false;
+
+    const auto stringSize = [](const char *s) { return s ? int(strlen(s)) + 1 : -1; };
+    const int categorySize = stringSize(context.category);
+    const int fileSize = stringSize(context.file);
+    const int functionSize = stringSize(context.function);
+    const qsizetype unalignedSize = sizeof(LogRecord) + message.size() * sizeof(QChar)
+            + qMax(categorySize, 0) + qMax(fileSize, 0) + qMax(functionSize, 0);
+    const quint32 size = quint32((unalignedSize + 7) & ~qsizetype(7));
+    if (quint64(unalignedSize) > buffer->capacity / 4) {
+        // too large to queue; print it after what was queued before it
+        flush(QDeadlineTimer::Forever);
+        return false;
+    }
+
+    // Once the logger is stopping, the writer thread may be gone: messages
+    // are printed directly, after the ones queued before. The destructor
+    // waits for the messages being queued when it started.
+    const auto printDirectly = [this, buffer] {
+        buffer->producing.storeRelease(0);
+        flush(QDeadlineTimer::Forever);
+        return false;
+    };
+    buffer->producing.storeRelaxed(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (stopping.loadRelaxed())
+        return printDirectly();
+
+    quint64 newTail;
+    qint64 offset;
+    while ((offset = buffer->reserve(size, &newTail)) < 0) {
+        if (overflowPolicy.loadRelaxed() == int(QtPrivate::LogOverflowPolicy::Drop)) {
+            dropped.fetchAndAddRelaxed(1);
+            droppedTotal.fetchAndAddRelaxed(1);
+            buffer->producing.storeRelease(0);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writerSleeping.loadRelaxed())
+                wakeWriter();
+            return true;
+        }
+        if (!waitForSpace(buffer, size))
+            return printDirectly();
+    }
+
+    auto record = reinterpret_cast<LogRecord *>(buffer->data.get() + offset);
+    record->size = size;
+    record->type = type;
+    record->line = context.line;
+    record->categorySize = categorySize;
+    record->fileSize = fileSize;
+    record->functionSize = functionSize;
+    record->messageSize = message.size();
+    record->origin.threadId = buffer->threadId;
+    record->origin.thread = buffer->thread;
+    record->origin.msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    record->origin.monotonicNSecs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    char *out = reinterpret_cast<char *>(record + 1);
+    memcpy(out, message.constData(), message.size() * sizeof(QChar));
+    out += message.size() * sizeof(QChar);
+    for (auto s : { std::make_pair(context.category, categorySize),
+                    std::make_pair(context.file, fileSize),
+                    std::make_pair(context.function, functionSize) }) {
+        if (s.second > 0) {
+            memcpy(out, s.first, s.second);
+            out += s.second;
+        }
+    }
+    buffer->tail.storeRelease(newTail);
+    buffer->producing.storeRelease(0);
+
+    // pairs with the fence in run(): either we see that the writer thread is
+    // about to sleep, or it sees the message
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.loadRelaxed())
+        wakeWriter();
+    return true;
+}
+
+// Returns false if the message has to be printed directly, because the
+// writer thread is stopping or gone and will not make room anymore.
+bool AsyncLogger::waitForSpace(LogBuffer *buffer, quint32 size)
+{
+    QMutexLocker locker(&mutex);
+    if (stopping.loadRelaxed() || !isRunning())
+        return false;
+    workAvailable.wakeOne();
+    quint64 newTail;
+    if (buffer->reserve(size, &newTail) < 0)
+        spaceAvailable.wait(&mutex);
+    return true;
+}
+
+void AsyncLogger::wakeWriter()
+{
+    QMutexLocker locker(&mutex);
+    workAvailable.wakeOne();
+}
+
+bool AsyncLogger::hasPendingMessages() const
+{
+    for (const LogBuffer *buffer : buffers) {
+        if (buffer->head.loadRelaxed() != buffer->tail.loadAcquire())
+            return true;
+    }
+    return dropped.loadRelaxed() != 0;
+}
+
+// Waits until the messages logged by all threads before the call have been
+// passed to the message handler.
+bool AsyncLogger::flush(QDeadlineTimer deadline)
+{
+    if (isAsyncLogWriterThread)
+        return false;
+
+    QMutexLocker locker(&mutex);
+    QVarLengthArray<std::pair<LogBuffer *, quint64>, 32> targets;
+    for (LogBuffer *buffer : qAsConst(buffers)) {
+        const quint64 tail = buffer->tail.loadAcquire();
+        if (buffer->delivered != tail)
+            targets.append({ buffer, tail });
+    }
+    const quint64 droppedTarget = droppedTotal.loadRelaxed();
+    while (!targets.isEmpty() || droppedReported < droppedTarget) {
+        if (!isRunning())
+            return false;
+        workAvailable.wakeOne();
+        if (!spaceAvailable.wait(&mutex, deadline))
+            return false;
+        const auto done = [this](const std::pair<LogBuffer *, quint64> &target) {
+            return !buffers.contains(target.first) || target.first->delivered >= target.second;
+        };
+        targets.erase(std::remove_if(targets.begin(), targets.end(), done), targets.end());
+    }
+    return true;
+}
+
+void AsyncLogger::deliverDroppedMessageCount(quint64 count)
+{
+    const QLogMessageOrigin origin = {
+        qt_gettid(), this, QDateTime::currentMSecsSinceEpoch(),
+        QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs()
+    };
+    const QMessageLogContext context(nullptr, 0, nullptr, "qt.core.logging");
+    currentLogMessageOrigin = &origin;
+    qt_message_deliver(QtWarningMsg, context,
+                       QStringLiteral("Dropped %1 messages because the asynchronous logging buffer was full")
+                               .arg(count));
+    currentLogMessageOrigin = nullptr;
+}
+
+void AsyncLogger::run()
+{
+    constexpr qsizetype MaximumBatchSize = 1024 * 1024;
+    isAsyncLogWriterThread = true;
+
+    // the records of a batch are copied out of the buffers, so that the
+    // logging threads can go on while the batch is printed
+    QByteArray batch;
+    struct Entry { qint64 time; qsizetype offset; };
+    QList<Entry> entries;
+    QList<std::pair<LogBuffer *, quint64>> consumed;
+    QByteArray output;
+
+    while (true) {
+        QVarLengthArray<LogBuffer *, 32> snapshot;
+        bool stop;
+        {
+            QMutexLocker locker(&mutex);
+            const auto isDone = [](LogBuffer *buffer) {
+                if (!buffer->orphaned.loadAcquire() || buffer->head.loadRelaxed() != buffer->tail.loadAcquire())
+                    return false;
+                delete buffer;
+                return true;
+            };
+            buffers.erase(std::remove_if(buffers.begin(), buffers.end(), isDone), buffers.end());
+            snapshot.append(buffers.constData(), buffers.size());
+            stop = writerDone;
+        }
+
+        batch.clear();
+        entries.clear();
+        consumed.clear();
+        for (LogBuffer *buffer : snapshot) {
+            quint64 head = buffer->head.loadRelaxed();
+            const quint64 tail = buffer->tail.loadAcquire();
+            if (head == tail)
+                continue;
+            while (head != tail && batch.size() < MaximumBatchSize) {
+                const quint64 offset = head & (buffer->capacity - 1);
+                const auto record = reinterpret_cast<const LogRecord *>(buffer->data.get() + offset);
+                if (record->size == 0) {
+                    head += buffer->capacity - offset;
+                    continue;
+                }
+                entries.append({ record->origin.monotonicNSecs, batch.size() });
+                batch.append(reinterpret_cast<const char *>(record), record->size);
+                head += record->size;
+            }
+            buffer->head.storeRelease(head);
+            consumed.append({ buffer, head });
+        }
+
+        const quint64 droppedCount = dropped.fetchAndStoreRelaxed(0);
+        if (!consumed.isEmpty()) {
+            QMutexLocker locker(&mutex);
+            spaceAvailable.wakeAll();
+        }
+
+        if (entries.isEmpty() && !droppedCount) {
+            QMutexLocker locker(&mutex);
+            if (stop && !hasPendingMessages())
+                break;
+            writerSleeping.storeRelaxed(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!writerDone && !hasPendingMessages())
+                workAvailable.wait(&mutex);
+            writerSleeping.storeRelaxed(0);
+            continue;
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+            return lhs.time < rhs.time;
+        });
+
+        output.clear();
+        stderrBatch = &output;
+        if (droppedCount)
+            deliverDroppedMessageCount(droppedCount);
+        for (const Entry &entry : qAsConst(entries)) {
+            const auto record = reinterpret_cast<const LogRecord *>(batch.constData() + entry.offset);
+            const QMessageLogContext context(record->file(), record->line, record->function(),
+                                             record->category());
+            currentLogMessageOrigin = &record->origin;
+            qt_message_deliver(QtMsgType(record->type), context,
+                               QString(record->message(), record->messageSize));
+            currentLogMessageOrigin = nullptr;
+        }
+        stderrBatch = nullptr;
+        if (!output.isEmpty()) {
+            fwrite(output.constData(), 1, output.size(), stderr);
+            fflush(stderr);
+        }
+
+        QMutexLocker locker(&mutex);
+        for (const auto &c : qAsConst(consumed))
+            c.first->delivered = c.second;
+        droppedReported += droppedCount;
+        spaceAvailable.wakeAll();
+    }
+}
+} // unnamed namespace
+
+// The writer thread formats messages until the logger is stopped, and
+// enqueue() checks QMessagePattern::usesBacktrace, so the pattern has to be
+// created first.
+static void ensureMessagePatternOutlivesLogger()
+{
+    qMessagePattern();
+}
+
+static bool enqueueAsyncLogMessage(QtMsgType type, const QMessageLogContext &context,
+                                   const QString &message)
+{
+    int state = asyncLoggingState.loadAcquire();
+    if (Q_UNLIKELY(state == AsyncLoggingUndecided)) {
+        const QByteArray mode = qgetenv("QT_LOGGING_ASYNC");
+        QtPrivate::AsyncLoggingOptions options;
+        if (mode == "drop")
+            options.overflowPolicy = QtPrivate::LogOverflowPolicy::Drop;
+        const bool enable = !mode.isEmpty() && mode != "0";
+        {
+            const auto locker = qt_scoped_lock(asyncLoggingStateMutex);
+            if (asyncLoggingState.loadRelaxed() == AsyncLoggingUndecided) {
+                if (enable) {
+                    ensureMessagePatternOutlivesLogger();
+                    if (AsyncLogger *logger = asyncLogger())
+                        logger->enable(options);
+                }
+                asyncLoggingState.storeRelease(enable ? AsyncLoggingOn : AsyncLoggingOff);
+            }
+        }
+        state = asyncLoggingState.loadAcquire();
+    }
+    if (state != AsyncLoggingOn)
+        return false;
+
+    AsyncLogger *logger = asyncLogger();
+    if (!logger)
+        return false;
+    if (type == QtFatalMsg) {
+        // print it after everything logged before it
+        logger->flush(QDeadlineTimer(5000));
+        return false;
+    }
+    return logger->enqueue(type, context, message);
+}
+
+static void flushAsyncLogMessagesBeforeFatal()
+{
+    if (asyncLoggingState.loadAcquire() != AsyncLoggingOn)
+        return;
+    // don't wait forever, the writer thread may be what failed
+    if (AsyncLogger *logger = asyncLogger())
+        logger->flush(QDeadlineTimer(5000));
+}
+
+namespace QtPrivate {
+
+/*!
+    \internal
+
+    Enables or disables asynchronous logging, overriding the QT_LOGGING_ASYNC
+    environment variable. While it is enabled, messages other than fatal ones
+    are queued in a buffer of the logging thread and passed to the message
+    handler by a writer thread, in the order they were logged. The options
+    apply to the buffers of threads that have not logged yet.
+
+    Disabling asynchronous logging waits for the queued messages to be
+    printed.
+*/
+void setAsyncLoggingEnabled(bool enable, const AsyncLoggingOptions &options)
+{
+    ensureMessagePatternOutlivesLogger();
+    AsyncLogger *logger = asyncLogger();
+    if (!logger)
+        return;
+    const auto locker = qt_scoped_lock(asyncLoggingStateMutex);
+    if (enable) {
+        logger->enable(options);
+        asyncLoggingState.storeRelease(AsyncLoggingOn);
+    } else {
+        asyncLoggingState.storeRelease(AsyncLoggingOff);
+        logger->flush(QDeadlineTimer::Forever);
+    }
+}
+
+bool isAsyncLoggingEnabled()
+{
+    return asyncLoggingState.loadAcquire() == AsyncLoggingOn;
+}
+
+/*!
+    \internal
+
+    Waits until the messages queued by asynchronous logging before the call
+    have been passed to the message handler, or \a deadline expires. Returns
+    \c false if the deadline expired, or if called from a message handler on
+    the writer thread.
+*/
+bool flushAsyncLogging(QDeadlineTimer deadline)
+{
+    AsyncLogger *logger = asyncLoggerHolder.exists() ? asyncLogger() : nullptr;
+    return !logger || logger->flush(deadline);
+}
+
+/*!
+    \internal
+
+    Returns the number of messages dropped with LogOverflowPolicy::Drop that
+    have not been reported by the writer thread yet.
+*/
+quint64 droppedAsyncLogMessages()
+{
+    AsyncLogger *logger = asyncLoggerHolder.exists() ? asyncLogger() : nullptr;
+    return logger ? logger->dropped.loadRelaxed() : 0;
+}
+
+} // namespace QtPrivate
+
+#endif // !QT_BOOTSTRAPPED && QT_CONFIG(thread)
+
 static void qt_message_print(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
 #ifndef QT_BOOTSTRAPPED
@@ -1819,16 +2467,12 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
         }
     }
 #endif
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    if (enqueueAsyncLogMessage(msgType, context, message))
+        return;
+#endif
 
-    // prevent recursion in case the message handler generates messages
-    // itself, e.g. by using Qt API
-    if (grabMessageHandler()) {
-        const auto ungrab = qScopeGuard([]{ ungrabMessageHandler(); });
-        auto msgHandler = messageHandler.loadAcquire();
-        (msgHandler ? msgHandler : qDefaultMessageHandler)(msgType, context, message);
-    } else {
-        fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
-    }
+    qt_message_deliver(msgType, context, message);
 }
 
 static void qt_message_print(const QString &message)
@@ -1845,6 +2489,12 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    // print what was logged before, such as the warning that QT_FATAL_WARNINGS
+    // made fatal
+    flushAsyncLogMessagesBeforeFatal();
+#endif
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -2051,6 +2701,10 @@ void qErrnoWarning(int code, const char *msg, ...)
 
 QtMessageHandler qInstallMessageHandler(QtMessageHandler h)
 {
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    // messages logged before belong to the previous handler
+    QtPrivate::flushAsyncLogging();
+#endif
     const auto old = messageHandler.fetchAndStoreOrdered(h);
     if (old)
         return old;
@@ -2060,6 +2714,10 @@ QtMessageHandler qInstallMessageHandler(QtMessageHandler h)
 
 void qSetMessagePattern(const QString &pattern)
 {
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    // format messages logged before with the previous pattern
+    QtPrivate::flushAsyncLogging();
+#endif
     const auto locker = qt_scoped_lock(QMessagePattern::mutex);
 
     if (!qMessagePattern()->fromEnvironment)
@@ -51,12 +51,39 @@
 // We mean it.
 //
 
+#include <QtCore/private/qglobal_p.h>
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+#include <QtCore/qdeadlinetimer.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 namespace QtPrivate {
 
 Q_CORE_EXPORT bool shouldLogToStderr();
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+// Asynchronous logging: messages are queued in a buffer of the logging thread
+// and passed to the message handler by a writer thread. Enabled by setting
+// QT_LOGGING_ASYNC to 1 (Block) or "drop" (Drop), or by calling
+// setAsyncLoggingEnabled().
+enum class LogOverflowPolicy {
+    Block,      // wait for the writer thread to make room
+    Drop        // drop the message and count it in droppedAsyncLogMessages()
+};
+
+struct AsyncLoggingOptions
+{
+    qsizetype bufferSize = 256 * 1024;  // per logging thread, in bytes
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Block;
+};
+
+Q_CORE_EXPORT void setAsyncLoggingEnabled(bool enable, const AsyncLoggingOptions &options = {});
+Q_CORE_EXPORT bool isAsyncLoggingEnabled();
+Q_CORE_EXPORT bool flushAsyncLogging(QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever));
+Q_CORE_EXPORT quint64 droppedAsyncLogMessages();
+#endif
+
 }
 
 QT_END_NAMESPACE
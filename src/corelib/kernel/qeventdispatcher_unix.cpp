@@ -59,6 +59,10 @@
 #  include <sys/eventfd.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#  include <sys/timerfd.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -226,10 +230,22 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if defined(Q_OS_LINUX)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") && !initEpoll())
+        perror("QEventDispatcherUNIXPrivate(): Unable to use epoll, falling back to poll");
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if defined(Q_OS_LINUX)
+    if (timerFd >= 0)
+        qt_safe_close(timerFd);
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
@@ -249,46 +265,258 @@ int QEventDispatcherUNIXPrivate::activateTimers()
     return timerList.activateTimers();
 }
 
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifier(QHash<int, QSocketNotifierSetUNIX>::const_iterator it,
+                                                            short revents)
+{
+    const QSocketNotifierSetUNIX &sn_set = it.value();
+
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (!notifier)
+            continue;
+
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     it.key(), socketType(n.type));
+            notifier->setEnabled(false);
+        }
+
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
+}
+
 void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
 {
     for (const pollfd &pfd : qAsConst(pollfds)) {
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
-        auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
+        auto it = socketNotifiers.constFind(pfd.fd);
+        Q_ASSERT(it != socketNotifiers.cend());
+
+        markPendingSocketNotifier(it, pfd.revents);
+    }
+
+    pollfds.clear();
+}
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
+#if defined(Q_OS_LINUX)
+// the socket notifier sets describe their interest with poll(2) flags
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI
+              && EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
 
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+// Registrations carry a tag besides the descriptor, see updateEpollNotifiers()
+static inline quint64 epollData(int fd, quint32 tag)
+{
+    return (quint64(tag) << 32) | quint32(fd);
+}
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    // same clock as qt_gettime(), which QTimerInfoList uses for its deadlines
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd >= 0 && createEpollSet())
+        return true;
 
-            if (!notifier)
-                continue;
+    if (timerFd >= 0)
+        qt_safe_close(timerFd);
+    timerFd = -1;
+    return false;
+}
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+bool QEventDispatcherUNIXPrivate::createEpollSet()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return false;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = epollData(threadPipe.fds[0], 0);
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, threadPipe.fds[0], &ev) == 0) {
+        ev.data.u64 = epollData(timerFd, 0);
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev) == 0) {
+            epollTags.clear();
+            epollUnsupportedFds.clear();
+            for (auto it = socketNotifiers.cbegin(); it != socketNotifiers.cend(); ++it)
+                updateEpollNotifiers(it.key(), 0, it.value().events());
+            return true;
         }
     }
 
-    pollfds.clear();
+    qt_safe_close(epollFd);
+    epollFd = -1;
+    return false;
 }
 
+// An epoll registration belongs to the open file rather than to the
+// descriptor: it outlives close() while a duplicate of the descriptor is
+// open, keeps reporting events under the old number even once that number
+// is reused, and can then no longer be removed. Starting over with a new
+// set is the only way to get rid of it.
+void QEventDispatcherUNIXPrivate::rebuildEpollSet()
+{
+    qt_safe_close(epollFd);
+    if (createEpollSet())
+        return;
+
+    perror("QEventDispatcherUNIXPrivate: Unable to recreate the epoll set, falling back to poll");
+    qt_safe_close(timerFd);
+    timerFd = -1;
+    timerFdDeadline = timespec{ 0, 0 };
+    epollTags.clear();
+    epollUnsupportedFds.clear();
+}
+
+void QEventDispatcherUNIXPrivate::updateEpollNotifiers(int fd, short oldEvents, short newEvents)
+{
+    if (epollFd < 0 || oldEvents == newEvents)
+        return;
+
+    if (epollUnsupportedFds.contains(fd)) {
+        if (!newEvents)
+            epollUnsupportedFds.remove(fd);
+        return;
+    }
+
+    if (!newEvents) {
+        // fails harmlessly if the descriptor has already been closed; a
+        // registration kept alive by a duplicate is caught by its stale tag
+        epoll_event ev = {};
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+        epollTags.remove(fd);
+        return;
+    }
+
+    // every new registration gets a tag of its own, so that events of one
+    // that should be gone can be told apart from those of its successor
+    epoll_event ev = {};
+    ev.events = quint32(newEvents);
+    const auto tag = epollTags.constFind(fd);
+    if (oldEvents && tag != epollTags.cend()) {
+        ev.data.u64 = epollData(fd, tag.value());
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0)
+            return;
+    }
+
+    // either a new registration, or the descriptor was closed behind our
+    // back and its number reused
+    if (++epollTagCounter == 0)
+        epollTagCounter = 1;
+    ev.data.u64 = epollData(fd, epollTagCounter);
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0
+        || (errno == EEXIST && epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0)) {
+        epollTags.insert(fd, epollTagCounter);
+        return;
+    }
+    epollTags.remove(fd);
+
+    // regular files and directories can't be watched by epoll; poll(2) always
+    // reports them as ready, so emulate that
+    if (errno == EPERM) {
+        epollUnsupportedFds.insert(fd);
+        return;
+    }
+
+    qWarning("QSocketNotifier: Unable to watch socket %d with epoll: %ls",
+             fd, qUtf16Printable(qt_error_string()));
+}
+
+bool QEventDispatcherUNIXPrivate::armEpollTimer(const timespec &deadline)
+{
+    // most iterations wait for the same timer, so avoid re-arming needlessly
+    if (deadline == timerFdDeadline)
+        return true;
+
+    itimerspec spec = {};
+    spec.it_value = deadline;
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+        timerFdDeadline = deadline;
+        return true;
+    }
+
+    perror("QEventDispatcherUNIXPrivate: Unable to arm timerfd");
+    timerFdDeadline = timespec{ 0, 0 };
+    return false;
+}
+
+int QEventDispatcherUNIXPrivate::epollWait(const timespec *tm)
+{
+    int timeout = -1;
+    if (!epollUnsupportedFds.isEmpty()) {
+        timeout = 0;
+    } else if (tm) {
+        if (tm->tv_sec == 0 && tm->tv_nsec == 0) {
+            timeout = 0;
+        } else if (!armEpollTimer(timerList.currentTime + *tm)) {
+            // wake up in time anyway, at epoll_wait's millisecond precision
+            const qint64 msecs = tm->tv_sec * 1000 + (tm->tv_nsec + 999999) / 1000000;
+            timeout = int(qMin<qint64>(msecs, INT_MAX));
+        }
+    }
+
+    // two extra slots for the thread pipe and the timerfd; anything beyond
+    // the cap is simply reported on the next iteration
+    const qsizetype maxEvents = qMin<qsizetype>(socketNotifiers.size(), 1024) + 2;
+    if (epollEvents.size() < maxEvents)
+        epollEvents.resize(maxEvents);
+
+    int ret;
+    EINTR_LOOP(ret, epoll_wait(epollFd, epollEvents.data(), int(maxEvents), timeout));
+    return ret;
+}
+
+int QEventDispatcherUNIXPrivate::markPendingEpollNotifiers(int nevents)
+{
+    int wakeUps = 0;
+    bool staleRegistrations = false;
+
+    for (int i = 0; i < nevents; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        const int fd = int(quint32(ev.data.u64));
+        const quint32 tag = quint32(ev.data.u64 >> 32);
+
+        if (tag == 0 && fd == threadPipe.fds[0]) {
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = short(ev.events);
+            wakeUps += threadPipe.check(pfd);
+        } else if (tag == 0 && fd == timerFd) {
+            quint64 expirations;
+            qt_safe_read(timerFd, &expirations, sizeof(expirations));
+            timerFdDeadline = timespec{ 0, 0 };
+        } else if (epollTags.value(fd) == tag) {
+            auto it = socketNotifiers.constFind(fd);
+            Q_ASSERT(it != socketNotifiers.cend());
+            markPendingSocketNotifier(it, short(ev.events));
+        } else {
+            staleRegistrations = true;
+        }
+    }
+
+    for (int fd : qAsConst(epollUnsupportedFds)) {
+        auto it = socketNotifiers.constFind(fd);
+        Q_ASSERT(it != socketNotifiers.cend());
+        markPendingSocketNotifier(it, it.value().events() & (POLLIN | POLLOUT));
+    }
+
+    if (staleRegistrations)
+        rebuildEpollSet();
+
+    return wakeUps;
+}
+#endif
+
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
 {
     markPendingSocketNotifiers();
@@ -411,7 +639,13 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if defined(Q_OS_LINUX)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = notifier;
+    d->updateEpollNotifiers(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = notifier;
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,7 +684,13 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if defined(Q_OS_LINUX)
+    const short oldEvents = sn_set.events();
     sn_set.notifiers[type] = nullptr;
+    d->updateEpollNotifiers(sockfd, oldEvents, sn_set.events());
+#else
+    sn_set.notifiers[type] = nullptr;
+#endif
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
@@ -487,6 +727,23 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
+    int nevents = 0;
+
+#if defined(Q_OS_LINUX)
+    if (d->epollFd >= 0 && include_notifiers) {
+        const int ready = d->epollWait(tm);
+        if (ready == -1)
+            perror("epoll_wait");
+        nevents += d->markPendingEpollNotifiers(qMax(ready, 0));
+        nevents += d->activateSocketNotifiers();
+
+        if (include_timers)
+            nevents += d->activateTimers();
+
+        return (nevents > 0);
+    }
+#endif
+
     d->pollfds.clear();
     d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
@@ -497,8 +754,6 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
 
-    int nevents = 0;
-
     switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
     case -1:
         perror("qt_safe_poll");
@@ -53,11 +53,16 @@
 
 #include "QtCore/qabstracteventdispatcher.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qset.h"
 #include "private/qabstracteventdispatcher_p.h"
 #include "private/qcore_unix_p.h"
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if defined(Q_OS_LINUX)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -138,9 +143,34 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+    void markPendingSocketNotifier(QHash<int, QSocketNotifierSetUNIX>::const_iterator it,
+                                   short revents);
+
+#if defined(Q_OS_LINUX)
+    bool initEpoll();
+    bool createEpollSet();
+    void rebuildEpollSet();
+    void updateEpollNotifiers(int fd, short oldEvents, short newEvents);
+    bool armEpollTimer(const timespec &deadline);
+    int epollWait(const timespec *tm);
+    int markPendingEpollNotifiers(int nevents);
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
+#if defined(Q_OS_LINUX)
+    // epoll(7) backend, enabled with QT_EVENT_DISPATCHER_EPOLL=1: socket
+    // notifiers are registered incrementally and timers wake us up via timerfd
+    int epollFd = -1;
+    int timerFd = -1;
+    timespec timerFdDeadline = { 0, 0 };
+    QList<epoll_event> epollEvents;
+    QHash<int, quint32> epollTags;
+    quint32 epollTagCounter = 0;
+    QSet<int> epollUnsupportedFds;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QList<QSocketNotifier *> pendingNotifiers;
 
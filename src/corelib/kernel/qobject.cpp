@@ -620,6 +620,127 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+
+    Deletes the calls that were never delivered.
+ */
+QBatchedMetaCallQueue::~QBatchedMetaCallQueue()
+{
+    takeIncoming();
+    while (QMetaCallEvent *call = dequeue())
+        delete call;
+}
+
+/*!
+    \internal
+
+    Appends the calls enqueued so far to the pending ones, in the order they
+    were enqueued, and returns the number of pending calls. Must only be called
+    from the receiver's thread.
+ */
+int QBatchedMetaCallQueue::takeIncoming()
+{
+    QMetaCallEvent *taken = nullptr;
+    QMetaCallEvent *call = incoming.fetchAndStoreOrdered(nullptr);
+    while (call) {
+        QMetaCallEvent *next = call->nextBatched_;
+        call->nextBatched_ = taken;
+        taken = call;
+        call = next;
+    }
+
+    // calls left over from a batch that was cut short come first
+    int count = 0;
+    QMetaCallEvent **tail = &pending;
+    while (*tail) {
+        tail = &(*tail)->nextBatched_;
+        ++count;
+    }
+    *tail = taken;
+    for (; taken; taken = taken->nextBatched_)
+        ++count;
+    return count;
+}
+
+/*!
+    \internal
+
+    Returns the oldest pending call, or \nullptr if there is none. Must only
+    be called from the receiver's thread.
+ */
+QMetaCallEvent *QBatchedMetaCallQueue::dequeue()
+{
+    QMetaCallEvent *call = pending;
+    if (call)
+        pending = call->nextBatched_;
+    return call;
+}
+
+/*!
+    \internal
+
+    Returns true if calls are left over while no QBatchedMetaCallEvent is
+    posted for them, and marks the event as posted. Called with the receiver's
+    lock held, which keeps new calls out.
+ */
+bool QBatchedMetaCallQueue::needsEventAfterMove()
+{
+    if (!pending && !incoming.loadRelaxed())
+        return false;
+    return eventPosted.testAndSetOrdered(0, 1);
+}
+
+/*!
+    \internal
+
+    Lets the next batched call post a new event if this one was discarded,
+    for instance by QCoreApplication::removePostedEvents(). The calls already
+    queued are then delivered along with the next batch.
+ */
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    if (delivered)
+        return;
+    if (QBatchedMetaCallQueue *queue = connections->batchedMetaCalls.loadAcquire())
+        queue->eventDiscarded();
+}
+
+/*!
+    \internal
+
+    Delivers the calls of the batched connections that were queued for
+    \a object when the event started being delivered, unless a slot deletes
+    \a object or moves it to another thread first. Calls queued meanwhile are
+    left to the next event, so that a sender that keeps emitting cannot keep
+    the receiver's thread from processing its other events.
+ */
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    delivered = true;
+    QBatchedMetaCallQueue *queue = connections->batchedMetaCalls.loadAcquire();
+    if (!queue)
+        return;
+
+    // calls enqueued from now on need a new event
+    for (int count = queue->beginBatch(); count > 0; --count) {
+        QMetaCallEvent *call = queue->dequeue();
+        QScopedPointer<QMetaCallEvent> deleter(call);
+        QObjectPrivate::Sender sender(object, const_cast<QObject *>(call->sender()), call->signalId());
+        call->placeMetaCall(object);
+        // Sender::receiverDeleted() clears the receiver when the object is
+        // deleted or moved to another thread, neither of which allows
+        // touching the object or the queue anymore
+        if (!sender.receiver)
+            return;
+    }
+}
+
+void QObjectPrivate::ConnectionData::deleteBatchedMetaCalls(QBatchedMetaCallQueue *queue)
+{
+    delete queue;
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals().
@@ -1613,13 +1734,23 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
             ++eventsMoved;
         }
     }
+
+    // the batch being delivered, if any, stops when this returns, so the
+    // target thread needs an event of its own for the rest of it
+    ConnectionData *cd = connections.loadRelaxed();
+    QBatchedMetaCallQueue *batchedMetaCalls = cd ? cd->batchedMetaCalls.loadRelaxed() : nullptr;
+    if (batchedMetaCalls && batchedMetaCalls->needsEventAfterMove()) {
+        targetData->postEventList.addEvent(QPostEvent(q, new QBatchedMetaCallEvent(cd), Qt::NormalEventPriority));
+        ++postedEvents;
+        ++eventsMoved;
+    }
+
     if (eventsMoved > 0 && targetData->hasEventDispatcher()) {
         targetData->canWait = false;
         targetData->eventDispatcher.loadRelaxed()->wakeUp();
     }
 
     // the current emitting thread shouldn't restore currentSender after calling moveToThread()
-    ConnectionData *cd = connections.loadRelaxed();
     if (cd) {
         if (cd->currentSender) {
             cd->currentSender->receiverDeleted();
@@ -3341,6 +3472,9 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const bool isBatched = type & Qt::BatchedConnection;
+    type &= ~Qt::BatchedConnection;
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -3358,6 +3492,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->argumentTypes.storeRelaxed(types);
     c->callFunction = callFunction;
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
 
@@ -3692,6 +3827,19 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         return;
     }
 
+    if (c->isBatched) {
+        QObjectPrivate::ConnectionData *cd = QObjectPrivate::get(receiver)->connections.loadRelaxed();
+        QBatchedMetaCallQueue *queue = cd->batchedMetaCalls.loadRelaxed();
+        if (!queue) {
+            // all producers hold the receiver's lock, so there is no race here
+            queue = new QBatchedMetaCallQueue;
+            cd->batchedMetaCalls.storeRelease(queue);
+        }
+        if (queue->enqueue(ev))
+            QCoreApplication::postEvent(receiver, new QBatchedMetaCallEvent(cd));
+        return;
+    }
+
     QCoreApplication::postEvent(receiver, ev);
 }
 
@@ -4943,6 +5091,9 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const bool isBatched = type & Qt::BatchedConnection;
+    type &= ~Qt::BatchedConnection;
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -4961,6 +5112,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
         c->ownArgumentTypes = false;
     }
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
     QMetaObject::Connection ret(c.release());
@@ -61,12 +61,14 @@
 #include "QtCore/qsharedpointer.h"
 #include "QtCore/qvariant.h"
 #include "QtCore/qproperty.h"
+#include "QtCore/private/qslaballocator_p.h"
 
 QT_BEGIN_NAMESPACE
 
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+class QBatchedMetaCallQueue;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -101,6 +103,8 @@ class Q_CORE_EXPORT QObjectPrivate : public QObjectData
     Q_DECLARE_PUBLIC(QObject)
 
 public:
+    Q_DECLARE_SLAB_ALLOCATED
+
     struct ExtraData
     {
         ExtraData() {}
@@ -136,6 +140,8 @@ public:
 
     struct Connection : public ConnectionOrSignalVector
     {
+        Q_DECLARE_SLAB_ALLOCATED
+
         // linked list of connections connected to slots in this object, next is in base class
         Connection **prev;
         // linked list of connections connected to signals in this object
@@ -159,6 +165,7 @@ public:
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
         ushort isSingleShot : 1;
+        ushort isBatched : 1;
         Connection() : ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
@@ -254,6 +261,8 @@ public:
         Connection *senders = nullptr;
         Sender *currentSender = nullptr;   // object currently activating the object
         QAtomicPointer<Connection> orphaned;
+        // queued calls of batched connections to slots in this object, created on demand
+        QAtomicPointer<QBatchedMetaCallQueue> batchedMetaCalls;
 
         ~ConnectionData()
         {
@@ -261,6 +270,8 @@ public:
             SignalVector *v = signalVector.loadRelaxed();
             if (v)
                 free(v);
+            if (QBatchedMetaCallQueue *queue = batchedMetaCalls.loadRelaxed())
+                deleteBatchedMetaCalls(queue);
         }
 
         // must be called on the senders connection data
@@ -307,6 +318,7 @@ public:
         }
 
         static void deleteOrphaned(ConnectionOrSignalVector *c);
+        static void deleteBatchedMetaCalls(QBatchedMetaCallQueue *queue);
     };
 
     QObjectPrivate(int version = QObjectPrivateVersion);
@@ -529,6 +541,8 @@ private:
 class Q_CORE_EXPORT QMetaCallEvent : public QAbstractMetaCallEvent
 {
 public:
+    Q_DECLARE_SLAB_ALLOCATED
+
     // blocking queued with semaphore - args always owned by caller
     QMetaCallEvent(ushort method_offset, ushort method_relative,
                    QObjectPrivate::StaticMetaCallFunction callFunction,
@@ -558,6 +572,8 @@ public:
     virtual void placeMetaCall(QObject *object) override;
 
 private:
+    friend class QBatchedMetaCallQueue;
+
     inline void allocArgs();
 
     struct Data {
@@ -570,6 +586,68 @@ private:
     } d;
     // preallocate enough space for three arguments
     alignas(void *) char prealloc_[3 * sizeof(void *) + 3 * sizeof(QMetaType)];
+    QMetaCallEvent *nextBatched_ = nullptr;
+};
+
+// Queued calls of batched connections to one receiver. Any thread may enqueue
+// (holding the receiver's signal slot lock), only the receiver's thread
+// dequeues. Only the first call after a QBatchedMetaCallEvent started being
+// delivered posts a new one, so a burst of emissions costs a single posted
+// event and a single wake-up of the receiver's thread.
+class QBatchedMetaCallQueue
+{
+    Q_DISABLE_COPY_MOVE(QBatchedMetaCallQueue)
+public:
+    QBatchedMetaCallQueue() = default;
+    ~QBatchedMetaCallQueue();
+
+    // returns true if the caller needs to post a QBatchedMetaCallEvent
+    bool enqueue(QMetaCallEvent *call)
+    {
+        QMetaCallEvent *head = incoming.loadRelaxed();
+        do {
+            call->nextBatched_ = head;
+        } while (!incoming.testAndSetOrdered(head, call, head));
+        return eventPosted.testAndSetOrdered(0, 1);
+    }
+
+    // called by the receiver's thread when a QBatchedMetaCallEvent is
+    // delivered, returns the number of calls that belong to the batch
+    int beginBatch()
+    {
+        eventPosted.fetchAndStoreOrdered(0);
+        return takeIncoming();
+    }
+    QMetaCallEvent *dequeue();
+
+    // receiver is being moved to another thread, see setThreadData_helper()
+    bool needsEventAfterMove();
+
+    // a QBatchedMetaCallEvent was deleted without being delivered
+    void eventDiscarded() { eventPosted.storeRelease(0); }
+
+private:
+    int takeIncoming();
+
+    QAtomicPointer<QMetaCallEvent> incoming;    // most recently enqueued first
+    QMetaCallEvent *pending = nullptr;          // receiver's thread only, oldest first
+    QAtomicInt eventPosted;
+};
+
+class QBatchedMetaCallEvent : public QAbstractMetaCallEvent
+{
+public:
+    explicit QBatchedMetaCallEvent(QObjectPrivate::ConnectionData *connections)
+        : QAbstractMetaCallEvent(nullptr, -1), connections(connections)
+    {}
+    ~QBatchedMetaCallEvent() override;
+
+    void placeMetaCall(QObject *object) override;
+
+private:
+    // keeps the receiver's queue alive until the event is delivered or discarded
+    QObjectPrivate::ConnectionDataPointer connections;
+    bool delivered = false;
 };
 
 class QBoolBlocker
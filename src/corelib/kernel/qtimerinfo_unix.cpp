@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -170,18 +171,124 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+static inline bool timerLess(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    return t1->timeout < t2->timeout
+            || (t1->timeout == t2->timeout && t1->sequence < t2->sequence);
+}
+
+void QTimerInfoList::siftUp(qsizetype index)
+{
+    QTimerInfo **timers = data();
+    QTimerInfo *t = timers[index];
+    while (index > 0) {
+        const qsizetype parent = (index - 1) / 2;
+        if (!timerLess(t, timers[parent]))
+            break;
+        timers[index] = timers[parent];
+        timers[index]->heapIndex = index;
+        index = parent;
+    }
+    timers[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::siftDown(qsizetype index)
+{
+    QTimerInfo **timers = data();
+    const qsizetype count = size();
+    QTimerInfo *t = timers[index];
+    for (;;) {
+        qsizetype child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerLess(timers[child + 1], timers[child]))
+            ++child;
+        if (!timerLess(timers[child], t))
+            break;
+        timers[index] = timers[child];
+        timers[index]->heapIndex = index;
+        index = child;
+    }
+    timers[index] = t;
+    t->heapIndex = index;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->sequence = ++insertionCounter;
+    append(ti);
+    siftUp(size() - 1);
+}
+
+/*
+  remove timer info from list
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const qsizetype index = ti->heapIndex;
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+
+    // move the last timer into the hole, then restore the heap property,
+    // which can only be broken in one direction
+    data()[index] = last;
+    siftDown(index);
+    if (last->heapIndex == index)
+        siftUp(index);
+}
+
+/*
+  Returns the timer that expires first among those not being activated
+  right now, or null if there is none.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer() const
+{
+    // A subtree can only contain a better candidate if its root is being
+    // activated, which is rare, so this usually only looks at the first timer.
+    QTimerInfo *first = nullptr;
+    QVarLengthArray<qsizetype, 16> pending;
+    if (!isEmpty())
+        pending.append(0);
+    while (!pending.isEmpty()) {
+        const qsizetype index = pending.last();
+        pending.removeLast();
+        QTimerInfo *t = at(index);
+        if (first && !timerLess(t, first))
+            continue;
+        if (!t->activateRef) {
+            first = t;
+            continue;
+        }
+        for (qsizetype child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
+    }
+    return first;
+}
+
+/*
+  Returns how many timers have expired by currentTime.
+*/
+qsizetype QTimerInfoList::expiredTimerCount() const
+{
+    qsizetype count = 0;
+    QVarLengthArray<qsizetype, 64> pending;
+    if (!isEmpty())
+        pending.append(0);
+    while (!pending.isEmpty()) {
+        const qsizetype index = pending.last();
+        pending.removeLast();
+        if (currentTime < at(index)->timeout)
+            continue;
+        ++count;
+        for (qsizetype child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
     }
-    insert(index+1, ti);
+    return count;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -385,13 +492,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
+    QTimerInfo *t = firstWaitingTimer();
 
     if (!t)
       return false;
@@ -419,16 +520,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -489,6 +587,7 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
             ++t->timeout.tv_sec;
     }
 
+    timersById.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -503,42 +602,45 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t)
+        return false; // id not found
+
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+
+    // compact the remaining timers in place and rebuild the heap from them
+    QTimerInfo **timers = data();
+    qsizetype remaining = 0;
+    for (qsizetype i = 0; i < size(); ++i) {
+        QTimerInfo *t = timers[i];
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            timersById.remove(t->id);
             if (t == firstTimerInfo)
                 firstTimerInfo = nullptr;
             if (t->activateRef)
                 *(t->activateRef) = nullptr;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            timers[remaining++] = t;
         }
     }
+    resize(remaining);
+    for (qsizetype i = remaining / 2; i-- > 0; )
+        siftDown(i);
     return true;
 }
 
@@ -566,7 +668,8 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
+    int n_act = 0;
+    qsizetype maxCount = 0;
     firstTimerInfo = nullptr;
 
     timespec currentTime = updateCurrentTime();
@@ -575,11 +678,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = expiredTimerCount();
 
     //fire the timers.
     while (maxCount--) {
@@ -601,7 +700,7 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -69,6 +70,8 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    qsizetype heapIndex; // - position in QTimerInfoList
+    quint64 sequence; // - insertion order, breaks ties between equal timeouts
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,6 +80,8 @@ struct QTimerInfo {
 #endif
 };
 
+// The list is a binary min-heap ordered by timeout, so constFirst() is the
+// next timer to expire; timers with equal timeouts expire in insertion order.
 class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
@@ -92,6 +97,15 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    QHash<int, QTimerInfo *> timersById;
+    quint64 insertionCounter = 0;
+
+    void timerRemove(QTimerInfo *);
+    void siftUp(qsizetype index);
+    void siftDown(qsizetype index);
+    QTimerInfo *firstWaitingTimer() const;
+    qsizetype expiredTimerCount() const;
+
 public:
     QTimerInfoList();
 
@@ -58,6 +58,9 @@
 #include "qjsonobject.h"
 #include "qjsonarray.h"
 #include "private/qduplicatetracker_p.h"
+#if QT_CONFIG(library)
+#include "qpluginmetadatacache_p.h"
+#endif
 
 #include <qtcore_tracepoints_p.h>
 
@@ -284,6 +287,9 @@ void QFactoryLoader::update()
             }
         }
     }
+
+    if (QPluginMetaDataCache *cache = QPluginMetaDataCache::instance())
+        cache->save();
 #else
     Q_D(QFactoryLoader);
     if (qt_debug_component()) {
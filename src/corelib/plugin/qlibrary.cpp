@@ -63,6 +63,7 @@
 #include <qjsonvalue.h>
 #include "qelfparser_p.h"
 #include "qmachparser_p.h"
+#include "qpluginmetadatacache_p.h"
 
 #include <qtcore_tracepoints_p.h>
 
@@ -763,8 +764,27 @@ void QLibraryPrivate::updatePluginState()
 #endif
 
     if (!pHnd.loadRelaxed()) {
-        // scan for the plugin metadata without loading
-        success = findPatternUnloaded(fileName, this);
+        // scan for the plugin metadata without loading, unless a previous
+        // run already did so and the file hasn't changed since
+        QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+        const QPluginMetaDataCache::FileStamp stamp =
+                cache ? QPluginMetaDataCache::stamp(fileName) : QPluginMetaDataCache::FileStamp();
+        switch (cache ? cache->lookup(fileName, stamp, &metaData, &errorString)
+                      : QPluginMetaDataCache::NotCached) {
+        case QPluginMetaDataCache::IsAPlugin:
+            success = true;
+            break;
+        case QPluginMetaDataCache::IsNotAPlugin:
+            success = false;
+            break;
+        case QPluginMetaDataCache::NotCached:
+            success = findPatternUnloaded(fileName, this);
+            if (cache) {
+                cache->insert(fileName, stamp, success ? metaData : QJsonObject(),
+                              success ? QString() : errorString);
+            }
+            break;
+        }
     } else {
         // library is already loaded (probably via QLibrary)
         // simply get the target function and call it.
@@ -94,6 +94,17 @@ QT_BEGIN_NAMESPACE
     every instance has called unload(). Right before the unloading
     happens, the root component will also be deleted.
 
+    To tell whether a file is a plugin, and to provide metaData(), the
+    plugin's metadata is read from the file without loading it. Qt
+    remembers the outcome for every file it reads in a cache, so that the
+    plugin directories do not have to be read again each time an
+    application starts. For files that are not plugins, the cache keeps the
+    reason that errorString() reports. A cached result is only used as long
+    as the file's size and modification time do not change. The cache is
+    stored in the \c qtplugincache subdirectory of
+    QStandardPaths::GenericCacheLocation, in a file specific to the Qt build.
+    Setting the \c QT_NO_PLUGIN_CACHE environment variable disables it.
+
     See \l{How to Create Qt Plugins} for more information about
     how to make your application extensible through plugins.
 
@@ -0,0 +1,305 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpluginmetadatacache_p.h"
+#include "qlibrary_p.h"
+
+#include <qcborarray.h>
+#include <qcbormap.h>
+#include <qcryptographichash.h>
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qlibraryinfo.h>
+#include <qsavefile.h>
+#include <qstandardpaths.h>
+#include <qsysinfo.h>
+#include <qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QPluginMetaDataCache remembers the result of scanning a shared library for
+    Qt plugin metadata, so that QFactoryLoader does not have to open and parse
+    every file in the plugin directories each time an application starts.
+
+    The cache is stored as a CBOR file in the generic cache location. Entries
+    are keyed by the absolute file name and are only trusted while the file's
+    size and modification time match what they were when it was scanned;
+    files that turned out not to be plugins are remembered as well, together
+    with the error that QLibrary::errorString() reported for them. The cache
+    file name and contents depend on the Qt build and ABI, so differently
+    configured Qt builds sharing a home directory do not see each other's
+    results.
+
+    Setting the QT_NO_PLUGIN_CACHE environment variable disables the cache.
+    Both are documented for users in the QPluginLoader class documentation.
+*/
+
+namespace {
+enum CacheKeys : qint64 {
+    BuildKey = 0,
+    Entries = 1
+};
+enum EntryFields : qint64 {
+    ModificationTime = 0,
+    Size = 1,
+    MetaData = 2,
+    ErrorString = 3
+};
+}
+
+static QByteArray cacheBuildKey()
+{
+    return QByteArray(QLibraryInfo::build()) + ' ' + QSysInfo::buildAbi().toLatin1();
+}
+
+struct QPluginMetaDataCacheHolder
+{
+    QPluginMetaDataCache cache;
+};
+Q_GLOBAL_STATIC(QPluginMetaDataCacheHolder, pluginMetaDataCache)
+
+/*
+    Returns the process-wide cache, or \nullptr if caching is disabled.
+*/
+QPluginMetaDataCache *QPluginMetaDataCache::instance()
+{
+#if QT_CONFIG(cborstreamreader) && QT_CONFIG(cborstreamwriter)
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        return nullptr;
+    if (QPluginMetaDataCacheHolder *holder = pluginMetaDataCache())
+        return &holder->cache;
+#endif
+    return nullptr;
+}
+
+/*
+    Returns the size and modification time of \a fileName. The returned stamp
+    is invalid if the file cannot be read, in which case the result of scanning
+    it must not be cached.
+*/
+QPluginMetaDataCache::FileStamp QPluginMetaDataCache::stamp(const QString &fileName)
+{
+    FileStamp result;
+    const QFileInfo info(fileName);
+    if (info.isFile() && info.isReadable()) {
+        result.modificationTime = info.lastModified().toMSecsSinceEpoch();
+        result.size = info.size();
+    }
+    return result;
+}
+
+/*
+    Looks up the result of scanning \a fileName, whose size and modification
+    time are \a stamp now. If the file is a plugin, its metadata is stored in
+    \a metaData; if it is not, the error found when it was scanned is stored
+    in \a errorString, unless that is \nullptr.
+*/
+QPluginMetaDataCache::LookupResult
+QPluginMetaDataCache::lookup(const QString &fileName, const FileStamp &stamp, QJsonObject *metaData,
+                             QString *errorString)
+{
+    if (!stamp.isValid())
+        return NotCached;
+
+    QMutexLocker locker(&mutex);
+    ensureLoaded();
+    const auto it = entries.constFind(fileName);
+    if (it == entries.constEnd() || it->stamp != stamp)
+        return NotCached;
+
+    if (qt_debug_component())
+        qDebug() << "Using cached plugin metadata for" << fileName;
+    if (it->metaData.isNull()) {
+        if (errorString)
+            *errorString = it->errorString;
+        return IsNotAPlugin;
+    }
+    *metaData = it->metaData.toMap().toJsonObject();
+    return IsAPlugin;
+}
+
+/*
+    Records the result of scanning \a fileName, whose size and modification
+    time were \a stamp before it was scanned. An empty \a metaData means that
+    the file is not a plugin, for the reason given by \a errorString.
+*/
+void QPluginMetaDataCache::insert(const QString &fileName, const FileStamp &stamp,
+                                  const QJsonObject &metaData, const QString &errorString)
+{
+    if (!stamp.isValid())
+        return;
+
+    QMutexLocker locker(&mutex);
+    ensureLoaded();
+    Entry &entry = entries[fileName];
+    entry.stamp = stamp;
+    if (metaData.isEmpty()) {
+        entry.metaData = QCborValue(nullptr);
+        entry.errorString = errorString;
+    } else {
+        entry.metaData = QCborMap::fromJsonObject(metaData);
+        entry.errorString.clear();
+    }
+    modified = true;
+}
+
+/*
+    Writes the cache back to disk if anything changed since it was loaded.
+    Entries for files that no longer exist are dropped.
+*/
+void QPluginMetaDataCache::save()
+{
+#if QT_CONFIG(cborstreamwriter)
+    QMutexLocker locker(&mutex);
+    if (!modified || filePath.isEmpty())
+        return;
+    modified = false;
+
+    QCborMap map;
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (!QFileInfo::exists(it.key())) {
+            it = entries.erase(it);
+            continue;
+        }
+        map.insert(it.key(), QCborArray{ it->stamp.modificationTime, it->stamp.size,
+                                         it->metaData, it->errorString });
+        ++it;
+    }
+
+    QCborMap root;
+    root.insert(BuildKey, QString::fromLatin1(cacheBuildKey()));
+    root.insert(Entries, map);
+
+    const QFileInfo info(filePath);
+    if (!QDir().mkpath(info.absolutePath()))
+        return;
+#if QT_CONFIG(temporaryfile)
+    QSaveFile file(filePath);
+#else
+    QFile file(filePath);
+#endif
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(root.toCborValue().toCbor());
+#if QT_CONFIG(temporaryfile)
+    if (!file.commit())
+        return;
+#endif
+    if (qt_debug_component())
+        qDebug() << "Wrote plugin metadata cache" << filePath << "with" << entries.size() << "entries";
+#endif
+}
+
+/*
+    Forgets all cached results and removes the cache file.
+*/
+void QPluginMetaDataCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    updateFilePath();
+    if (!filePath.isEmpty())
+        QFile::remove(filePath);
+    entries.clear();
+    loaded = false;
+    modified = false;
+}
+
+QString QPluginMetaDataCache::cacheFilePath()
+{
+    QMutexLocker locker(&mutex);
+    ensureLoaded();
+    return filePath;
+}
+
+void QPluginMetaDataCache::updateFilePath()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (dir.isEmpty()) {
+        filePath.clear();
+        return;
+    }
+    const QByteArray hash = QCryptographicHash::hash(cacheBuildKey(), QCryptographicHash::Sha1);
+    filePath = dir + QLatin1String("/qtplugincache/")
+            + QLatin1String(hash.toHex().left(16)) + QLatin1String(".cbor");
+}
+
+void QPluginMetaDataCache::ensureLoaded()
+{
+    if (loaded)
+        return;
+    loaded = true;
+    updateFilePath();
+
+#if QT_CONFIG(cborstreamreader)
+    QFile file(filePath);
+    if (filePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return;
+
+    QCborParserError error;
+    const QCborMap root = QCborValue::fromCbor(file.readAll(), &error).toMap();
+    if (error.error != QCborError::NoError
+            || root.value(BuildKey).toString() != QLatin1String(cacheBuildKey())) {
+        if (qt_debug_component())
+            qDebug() << "Ignoring stale or corrupt plugin metadata cache" << filePath;
+        return;
+    }
+
+    const QCborMap map = root.value(Entries).toMap();
+    entries.reserve(map.size());
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        const QCborArray fields = it.value().toArray();
+        const QCborValue metaData = fields.at(MetaData);
+        if (!it.key().isString() || fields.size() != 4 || !(metaData.isMap() || metaData.isNull()))
+            continue;
+        Entry &entry = entries[it.key().toString()];
+        entry.stamp.modificationTime = fields.at(ModificationTime).toInteger(-1);
+        entry.stamp.size = fields.at(Size).toInteger(-1);
+        entry.metaData = metaData;
+        entry.errorString = fields.at(ErrorString).toString();
+    }
+    if (qt_debug_component())
+        qDebug() << "Loaded plugin metadata cache" << filePath << "with" << entries.size() << "entries";
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPLUGINMETADATACACHE_P_H
+#define QPLUGINMETADATACACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QLibrary class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include "QtCore/qcborvalue.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qjsonobject.h"
+#include "QtCore/qmutex.h"
+#include "QtCore/qstring.h"
+
+QT_REQUIRE_CONFIG(library);
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QPluginMetaDataCache
+{
+public:
+    enum LookupResult {
+        NotCached,
+        IsAPlugin,
+        IsNotAPlugin
+    };
+
+    struct FileStamp
+    {
+        qint64 modificationTime = -1;
+        qint64 size = -1;
+
+        bool isValid() const { return size >= 0; }
+        bool operator==(const FileStamp &other) const
+        { return modificationTime == other.modificationTime && size == other.size; }
+        bool operator!=(const FileStamp &other) const { return !(*this == other); }
+    };
+
+    static QPluginMetaDataCache *instance();
+    static FileStamp stamp(const QString &fileName);
+
+    LookupResult lookup(const QString &fileName, const FileStamp &stamp, QJsonObject *metaData,
+                        QString *errorString = nullptr);
+    void insert(const QString &fileName, const FileStamp &stamp, const QJsonObject &metaData,
+                const QString &errorString = QString());
+    void save();
+    void clear();
+
+    QString cacheFilePath();
+
+private:
+    QPluginMetaDataCache() = default;
+    Q_DISABLE_COPY_MOVE(QPluginMetaDataCache)
+    friend struct QPluginMetaDataCacheHolder;
+
+    struct Entry
+    {
+        FileStamp stamp;
+        QCborValue metaData;        // Null if the file is not a plugin
+        QString errorString;        // why the file is not a plugin
+    };
+
+    void ensureLoaded();
+    void updateFilePath();
+
+    QMutex mutex;
+    QString filePath;
+    QHash<QString, Entry> entries;
+    bool loaded = false;
+    bool modified = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLUGINMETADATACACHE_P_H
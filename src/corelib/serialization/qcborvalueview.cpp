@@ -0,0 +1,823 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qcborvalueview.h"
+
+#include <private/qnumeric_p.h>
+#include <qendian.h>
+#include <qfloat16.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+   \class QCborValueView
+   \inmodule QtCore
+   \ingroup cbor
+   \ingroup shared
+   \reentrant
+   \since 6.1
+
+   \brief The QCborValueView class provides read-only access to a CBOR value
+   without decoding it.
+
+   QCborValue::fromCbor() decodes a complete CBOR stream into memory,
+   duplicating all strings and byte arrays it contains. For large documents
+   of which only a few elements are needed, QCborValueView can be used
+   instead: it refers to the encoded data directly and only decodes the
+   elements that are accessed, so that looking up a value costs time
+   proportional to the path to it, not to the size of the document.
+
+   A QCborValueView is created by fromCbor(), which keeps a reference to the
+   QByteArray it was created from, or by fromRawData(), in which case the
+   caller must ensure that the data outlives all views into it. The latter
+   is useful for files mapped into memory with QFile::map():
+
+   \snippet code/src_corelib_serialization_qcborvalueview.cpp 0
+
+   Arrays and maps are navigated with at(), value() and operator[](), which
+   return views of the child elements, or an invalid view if there is no
+   such element. Children are found by skipping over their preceding
+   siblings in the encoded data. The first lookup by key in a map records
+   the offsets of all its keys, and the first access to an array element
+   beyond the first records the offsets of all elements, so subsequent
+   lookups into the same container take constant time. These indexes are
+   shared by all views into the same data.
+
+   Since elements are decoded on access, the data is only validated as far
+   as it is read: a view of a malformed element is invalid, but other parts
+   of the same document may still be accessible. Tagged values are reported
+   as QCborValue::Tag; use toCborValue() to obtain the extended types, like
+   QCborValue::DateTime, that QCborValue recognizes.
+
+   \sa QCborValue, QCborStreamReader
+*/
+
+enum {
+    MaximumRecursionDepth = 1024,
+    IndefiniteLength = 31,
+    BreakByte = 0xff
+};
+
+namespace {
+struct Header
+{
+    quint64 value;          // the argument: the value, length or count
+    qsizetype size;         // size of the initial byte and the argument
+    quint8 majorType;
+    quint8 additional;
+    bool indefinite;        // indefinite length, or a break for major type 7
+};
+}
+
+class QCborValueViewPrivate : public QSharedData
+{
+public:
+    struct MapIndex
+    {
+        // key offsets and value offsets
+        QHash<QByteArray, qsizetype> stringKeys;    // definite-length text strings
+        QHash<qint64, qsizetype> integerKeys;
+        QList<QPair<qsizetype, qsizetype>> otherKeys;
+    };
+
+    bool readHeader(qsizetype pos, Header *h) const;
+    qsizetype skip(qsizetype pos, int depth = MaximumRecursionDepth) const;
+    qsizetype containerStart(qsizetype pos, quint8 majorType, Header *h) const;
+    QByteArrayView definiteString(qsizetype pos, quint8 majorType) const;
+    QByteArray concatenatedString(qsizetype pos, quint8 majorType, bool *ok) const;
+
+    const QList<qsizetype> *arrayIndex(qsizetype pos);
+    const MapIndex *mapIndex(qsizetype pos);
+
+    QByteArray owner;       // keeps the data alive for fromCbor()
+    const uchar *data = nullptr;
+    qsizetype size = 0;
+
+    // the indexes are heap-allocated so that they are not moved by a rehash
+    // while another thread is using them
+    QBasicMutex mutex;
+    QHash<qsizetype, QList<qsizetype> *> arrayIndexes;
+    QHash<qsizetype, MapIndex *> mapIndexes;
+
+    ~QCborValueViewPrivate()
+    {
+        qDeleteAll(arrayIndexes);
+        qDeleteAll(mapIndexes);
+    }
+};
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QCborValueViewPrivate)
+
+bool QCborValueViewPrivate::readHeader(qsizetype pos, Header *h) const
+{
+    if (pos < 0 || pos >= size)
+        return false;
+
+    const uchar initial = data[pos];
+    h->majorType = initial >> 5;
+    h->additional = initial & 0x1f;
+    h->indefinite = false;
+
+    qsizetype argumentSize = 0;
+    switch (h->additional) {
+    case 24:
+        argumentSize = 1;
+        break;
+    case 25:
+        argumentSize = 2;
+        break;
+    case 26:
+        argumentSize = 4;
+        break;
+    case 27:
+        argumentSize = 8;
+        break;
+    case 28:
+    case 29:
+    case 30:
+        return false;       // reserved
+    case IndefiniteLength:
+        // integers and tags have no indefinite form
+        if (h->majorType <= 1 || h->majorType == 6)
+            return false;
+        h->indefinite = true;
+        h->value = 0;
+        break;
+    default:
+        h->value = h->additional;
+        break;
+    }
+
+    if (argumentSize > size - pos - 1)
+        return false;
+    const uchar *argument = data + pos + 1;
+    switch (argumentSize) {
+    case 1:
+        h->value = *argument;
+        break;
+    case 2:
+        h->value = qFromBigEndian<quint16>(argument);
+        break;
+    case 4:
+        h->value = qFromBigEndian<quint32>(argument);
+        break;
+    case 8:
+        h->value = qFromBigEndian<quint64>(argument);
+        break;
+    }
+    h->size = 1 + argumentSize;
+    return true;
+}
+
+/*
+    Returns the offset just past the element at \a pos, or -1 if the element
+    is malformed or truncated.
+*/
+qsizetype QCborValueViewPrivate::skip(qsizetype pos, int depth) const
+{
+    Header h;
+    if (depth == 0 || !readHeader(pos, &h))
+        return -1;
+    pos += h.size;
+
+    switch (h.majorType) {
+    case 0:
+    case 1:
+        return pos;
+
+    case 2:
+    case 3:
+        if (!h.indefinite)
+            return h.value <= quint64(size - pos) ? pos + qsizetype(h.value) : -1;
+        forever {
+            // a sequence of definite-length chunks, terminated by a break
+            Header chunk;
+            if (!readHeader(pos, &chunk))
+                return -1;
+            if (chunk.majorType == 7 && chunk.indefinite)
+                return pos + 1;
+            if (chunk.majorType != h.majorType || chunk.indefinite)
+                return -1;
+            pos += chunk.size;
+            if (chunk.value > quint64(size - pos))
+                return -1;
+            pos += qsizetype(chunk.value);
+        }
+
+    case 4:
+    case 5:
+        if (h.indefinite) {
+            while (pos < size && data[pos] != BreakByte) {
+                pos = skip(pos, depth - 1);
+                if (pos < 0)
+                    return -1;
+            }
+            return pos < size ? pos + 1 : -1;
+        }
+        // each element takes at least one byte
+        if (h.value > quint64(size - pos))
+            return -1;
+        for (quint64 count = h.majorType == 5 ? h.value * 2 : h.value; count; --count) {
+            pos = skip(pos, depth - 1);
+            if (pos < 0)
+                return -1;
+        }
+        return pos;
+
+    case 6:
+        return skip(pos, depth - 1);
+
+    case 7:
+        return h.indefinite ? -1 : pos;
+    }
+    Q_UNREACHABLE();
+    return -1;
+}
+
+/*
+    Returns the offset of the first child of the container of type
+    \a majorType at \a pos, or -1 if there is no such container.
+*/
+qsizetype QCborValueViewPrivate::containerStart(qsizetype pos, quint8 majorType, Header *h) const
+{
+    if (!readHeader(pos, h) || h->majorType != majorType)
+        return -1;
+    return pos + h->size;
+}
+
+QByteArrayView QCborValueViewPrivate::definiteString(qsizetype pos, quint8 majorType) const
+{
+    Header h;
+    if (!readHeader(pos, &h) || h.majorType != majorType || h.indefinite)
+        return QByteArrayView();
+    pos += h.size;
+    if (h.value > quint64(size - pos))
+        return QByteArrayView();
+    return QByteArrayView(data + pos, qsizetype(h.value));
+}
+
+QByteArray QCborValueViewPrivate::concatenatedString(qsizetype pos, quint8 majorType, bool *ok) const
+{
+    *ok = false;
+    Header h;
+    if (!readHeader(pos, &h) || h.majorType != majorType)
+        return QByteArray();
+    if (!h.indefinite) {
+        const QByteArrayView view = definiteString(pos, majorType);
+        *ok = view.data() != nullptr;
+        return QByteArray(view.data(), view.size());
+    }
+
+    QByteArray result;
+    pos += h.size;
+    forever {
+        Header chunk;
+        if (!readHeader(pos, &chunk))
+            return QByteArray();
+        if (chunk.majorType == 7 && chunk.indefinite)
+            break;
+        const QByteArrayView view = definiteString(pos, majorType);
+        if (!view.data())
+            return QByteArray();
+        result.append(view.data(), view.size());
+        pos = view.data() + view.size() - reinterpret_cast<const char *>(data);
+    }
+    *ok = true;
+    return result;
+}
+
+const QList<qsizetype> *QCborValueViewPrivate::arrayIndex(qsizetype pos)
+{
+    QMutexLocker locker(&mutex);
+    if (QList<qsizetype> *index = arrayIndexes.value(pos))
+        return index;
+
+    Header h;
+    qsizetype child = containerStart(pos, 4, &h);
+    if (child < 0)
+        return nullptr;
+
+    auto offsets = new QList<qsizetype>;
+    if (!h.indefinite)
+        offsets->reserve(qsizetype(qMin(h.value, quint64(size - child))));
+    for (quint64 i = 0; h.indefinite || i < h.value; ++i) {
+        if (h.indefinite && (child >= size || data[child] == BreakByte))
+            break;
+        const qsizetype next = skip(child);
+        if (next < 0)
+            break;      // the elements before a malformed one remain accessible
+        offsets->append(child);
+        child = next;
+    }
+    arrayIndexes.insert(pos, offsets);
+    return offsets;
+}
+
+const QCborValueViewPrivate::MapIndex *QCborValueViewPrivate::mapIndex(qsizetype pos)
+{
+    QMutexLocker locker(&mutex);
+    if (MapIndex *index = mapIndexes.value(pos))
+        return index;
+
+    Header h;
+    qsizetype key = containerStart(pos, 5, &h);
+    if (key < 0)
+        return nullptr;
+
+    auto index = new MapIndex;
+    for (quint64 i = 0; h.indefinite || i < h.value; ++i) {
+        if (h.indefinite && (key >= size || data[key] == BreakByte))
+            break;
+        const qsizetype value = skip(key);
+        if (value < 0 || value >= size)
+            break;
+
+        // as in QCborMap, the first of duplicate keys wins
+        Header keyHeader;
+        readHeader(key, &keyHeader);
+        const QByteArrayView string = definiteString(key, 3);
+        if (string.data()) {
+            const QByteArray rawKey = QByteArray::fromRawData(string.data(), string.size());
+            if (!index->stringKeys.contains(rawKey))
+                index->stringKeys.insert(rawKey, value);
+        } else if (keyHeader.majorType <= 1 && qint64(keyHeader.value) >= 0) {
+            const qint64 n = keyHeader.majorType == 0 ? qint64(keyHeader.value)
+                                                      : -1 - qint64(keyHeader.value);
+            if (!index->integerKeys.contains(n))
+                index->integerKeys.insert(n, value);
+        } else {
+            index->otherKeys.append(qMakePair(key, value));
+        }
+
+        key = skip(value);
+        if (key < 0)
+            break;
+    }
+    mapIndexes.insert(pos, index);
+    return index;
+}
+
+/*!
+   Creates an invalid QCborValueView.
+*/
+QCborValueView::QCborValueView() noexcept = default;
+
+/*!
+   Creates a view referring to the same value as \a other.
+*/
+QCborValueView::QCborValueView(const QCborValueView &other) noexcept = default;
+
+/*!
+   Makes this view refer to the same value as \a other.
+*/
+QCborValueView &QCborValueView::operator=(const QCborValueView &other) noexcept = default;
+
+/*!
+   \fn QCborValueView::QCborValueView(QCborValueView &&other)
+
+   Move-constructs a view from \a other.
+*/
+
+/*!
+   \fn QCborValueView &QCborValueView::operator=(QCborValueView &&other)
+
+   Move-assigns \a other to this view.
+*/
+
+/*!
+   \fn void QCborValueView::swap(QCborValueView &other)
+
+   Swaps this view with \a other. This operation is very fast and never
+   fails.
+*/
+
+/*!
+   Destroys this view.
+*/
+QCborValueView::~QCborValueView() = default;
+
+QCborValueView::QCborValueView(QCborValueViewPrivate *dd, qsizetype p) noexcept
+    : d(dd), pos(p)
+{
+}
+
+/*!
+   Returns a view of the first CBOR value encoded in \a data. The view keeps
+   a reference to \a data, so no copy is made unless \a data is modified
+   later.
+
+   \sa fromRawData()
+*/
+QCborValueView QCborValueView::fromCbor(const QByteArray &data)
+{
+    QCborValueView result = fromRawData(data.constData(), data.size());
+    result.d->owner = data;
+    return result;
+}
+
+/*!
+   \fn QCborValueView QCborValueView::fromRawData(const quint8 *data, qsizetype len)
+   \overload
+*/
+
+/*!
+   Returns a view of the first CBOR value encoded in the \a len bytes
+   starting at \a data. The data is not copied: the caller must ensure that
+   it stays valid and unmodified while any view into it exists.
+
+   \sa fromCbor()
+*/
+QCborValueView QCborValueView::fromRawData(const char *data, qsizetype len)
+{
+    auto dd = new QCborValueViewPrivate;
+    dd->data = reinterpret_cast<const uchar *>(data);
+    dd->size = len;
+    return QCborValueView(dd, 0);
+}
+
+/*!
+   Returns the type of the value this view refers to, or QCborValue::Invalid
+   if the view is invalid or the value's header is malformed.
+
+   Integers that do not fit in a qint64 are reported as QCborValue::Double,
+   like QCborValue does.
+*/
+QCborValue::Type QCborValueView::type() const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h))
+        return QCborValue::Invalid;
+
+    switch (h.majorType) {
+    case 0:
+    case 1:
+        return qint64(h.value) < 0 ? QCborValue::Double : QCborValue::Integer;
+    case 2:
+        return QCborValue::ByteArray;
+    case 3:
+        return QCborValue::String;
+    case 4:
+        return QCborValue::Array;
+    case 5:
+        return QCborValue::Map;
+    case 6:
+        return QCborValue::Tag;
+    case 7:
+        if (h.indefinite)
+            return QCborValue::Invalid;
+        if (h.additional >= 25)
+            return QCborValue::Double;
+        return QCborValue::Type(QCborValue::SimpleType + int(h.value));
+    }
+    Q_UNREACHABLE();
+    return QCborValue::Invalid;
+}
+
+/*!
+   Returns the integer value this view refers to. If it is a double,
+   returns it converted to an integer; otherwise, returns \a defaultValue.
+
+   \sa toDouble()
+*/
+qint64 QCborValueView::toInteger(qint64 defaultValue) const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h))
+        return defaultValue;
+    if (h.majorType <= 1 && qint64(h.value) >= 0)
+        return h.majorType == 0 ? qint64(h.value) : -1 - qint64(h.value);
+    return isDouble() ? qint64(toDouble()) : defaultValue;
+}
+
+/*!
+   Returns the floating-point value this view refers to. If it is an
+   integer, returns it converted to double; otherwise, returns
+   \a defaultValue.
+
+   \sa toInteger()
+*/
+double QCborValueView::toDouble(double defaultValue) const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h))
+        return defaultValue;
+
+    if (h.majorType == 0)
+        return double(h.value);
+    if (h.majorType == 1)
+        return -1 - double(h.value);
+    if (h.majorType != 7)
+        return defaultValue;
+
+    switch (h.additional) {
+    case 25: {
+        const quint16 bits = quint16(h.value);
+        qfloat16 f;
+        memcpy(static_cast<void *>(&f), &bits, sizeof(f));
+        return double(f);
+    }
+    case 26: {
+        const quint32 bits = quint32(h.value);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return double(f);
+    }
+    case 27: {
+        double f;
+        memcpy(&f, &h.value, sizeof(f));
+        return f;
+    }
+    }
+    return defaultValue;
+}
+
+/*!
+   Returns true if this view refers to \c true, false if it refers to
+   \c false, or \a defaultValue otherwise.
+*/
+bool QCborValueView::toBool(bool defaultValue) const
+{
+    const QCborValue::Type t = type();
+    return t == QCborValue::True || (t != QCborValue::False && defaultValue);
+}
+
+/*!
+   Returns the simple type this view refers to, or \a defaultValue if it
+   is not a simple type.
+*/
+QCborSimpleType QCborValueView::toSimpleType(QCborSimpleType defaultValue) const
+{
+    return isSimpleType() ? QCborSimpleType(type() - QCborValue::SimpleType) : defaultValue;
+}
+
+/*!
+   Returns the text string this view refers to, decoded from UTF-8, or
+   \a defaultValue if it is not a string.
+
+   \sa rawStringData(), toByteArray()
+*/
+QString QCborValueView::toString(const QString &defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    const QByteArrayView view = d->definiteString(pos, 3);
+    if (view.data())
+        return QString::fromUtf8(view);
+
+    bool ok;
+    const QByteArray chunks = d->concatenatedString(pos, 3, &ok);
+    return ok ? QString::fromUtf8(chunks) : defaultValue;
+}
+
+/*!
+   Returns a copy of the byte array this view refers to, or \a defaultValue
+   if it is not a byte array.
+
+   \sa rawStringData(), toString()
+*/
+QByteArray QCborValueView::toByteArray(const QByteArray &defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    bool ok;
+    const QByteArray result = d->concatenatedString(pos, 2, &ok);
+    return ok ? result : defaultValue;
+}
+
+/*!
+   Returns the contents of the text string or byte array this view refers
+   to, without copying them. For text strings, this is UTF-8.
+
+   Returns a null view if this view does not refer to a string or byte
+   array, or if it was encoded in indefinite-length chunks: use toString()
+   or toByteArray() for those.
+*/
+QByteArrayView QCborValueView::rawStringData() const
+{
+    if (!d)
+        return QByteArrayView();
+    const QByteArrayView view = d->definiteString(pos, 3);
+    return view.data() ? view : d->definiteString(pos, 2);
+}
+
+/*!
+   Returns the tag of the tagged value this view refers to, or
+   \a defaultValue if it is not a tagged value.
+
+   \sa taggedValue()
+*/
+QCborTag QCborValueView::tag(QCborTag defaultValue) const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h) || h.majorType != 6)
+        return defaultValue;
+    return QCborTag(h.value);
+}
+
+/*!
+   Returns a view of the value wrapped by the tagged value this view refers
+   to, or an invalid view if it is not a tagged value.
+
+   \sa tag()
+*/
+QCborValueView QCborValueView::taggedValue() const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h) || h.majorType != 6)
+        return QCborValueView();
+    return QCborValueView(d.data(), pos + h.size);
+}
+
+/*!
+   Returns the number of elements in the array, or of key-value pairs in the
+   map, this view refers to. Returns 0 for other values.
+
+   For containers encoded with definite length, this does not require
+   decoding their contents.
+*/
+qsizetype QCborValueView::size() const
+{
+    Header h;
+    if (!d || !d->readHeader(pos, &h))
+        return 0;
+    if (h.majorType == 4) {
+        if (!h.indefinite)
+            return qsizetype(h.value);
+        const QList<qsizetype> *index = d->arrayIndex(pos);
+        return index ? index->size() : 0;
+    }
+    if (h.majorType == 5) {
+        if (!h.indefinite)
+            return qsizetype(h.value);
+        qsizetype count = 0;
+        for (qsizetype key = pos + h.size; key >= 0 && key < d->size && d->data[key] != BreakByte;
+             key = d->skip(d->skip(key)))
+            ++count;
+        return count;
+    }
+    return 0;
+}
+
+/*!
+   Returns a view of the element at index \a i of the array this view
+   refers to, or an invalid view if this is not an array or \a i is out of
+   range.
+
+   \sa operator[](), value()
+*/
+QCborValueView QCborValueView::at(qsizetype i) const
+{
+    Header h;
+    if (!d || i < 0)
+        return QCborValueView();
+    if (i == 0) {
+        // no need to build an index for the first element
+        const qsizetype child = d->containerStart(pos, 4, &h);
+        if (child < 0 || (h.indefinite ? child >= d->size || d->data[child] == BreakByte
+                                       : h.value == 0))
+            return QCborValueView();
+        return QCborValueView(d.data(), child);
+    }
+
+    const QList<qsizetype> *index = d->arrayIndex(pos);
+    if (!index || i >= index->size())
+        return QCborValueView();
+    return QCborValueView(d.data(), index->at(i));
+}
+
+/*!
+   Returns a view of the value associated with the integer \a key in the map
+   this view refers to, or an invalid view if this is not a map or it does
+   not contain \a key.
+*/
+QCborValueView QCborValueView::value(qint64 key) const
+{
+    const QCborValueViewPrivate::MapIndex *index = d ? d->mapIndex(pos) : nullptr;
+    if (!index)
+        return QCborValueView();
+    const qsizetype value = index->integerKeys.value(key, -1);
+    return value < 0 ? QCborValueView() : QCborValueView(d.data(), value);
+}
+
+/*!
+   \overload
+*/
+QCborValueView QCborValueView::value(QLatin1String key) const
+{
+    const QCborValueViewPrivate::MapIndex *index = d ? d->mapIndex(pos) : nullptr;
+    if (!index)
+        return QCborValueView();
+
+    // US-ASCII is the same in Latin 1 and UTF-8
+    bool isAscii = true;
+    for (char c : key)
+        isAscii = isAscii && uchar(c) < 0x80;
+    if (!isAscii)
+        return value(QString(key));
+
+    const qsizetype value = index->stringKeys.value(QByteArray::fromRawData(key.data(), key.size()), -1);
+    if (value >= 0)
+        return QCborValueView(d.data(), value);
+    for (const auto &pair : index->otherKeys) {
+        if (QCborValueView(d.data(), pair.first).toString() == key)
+            return QCborValueView(d.data(), pair.second);
+    }
+    return QCborValueView();
+}
+
+/*!
+   \overload
+*/
+QCborValueView QCborValueView::value(QStringView key) const
+{
+    const QCborValueViewPrivate::MapIndex *index = d ? d->mapIndex(pos) : nullptr;
+    if (!index)
+        return QCborValueView();
+
+    const qsizetype value = index->stringKeys.value(key.toUtf8(), -1);
+    if (value >= 0)
+        return QCborValueView(d.data(), value);
+    for (const auto &pair : index->otherKeys) {
+        if (QCborValueView(d.data(), pair.first).toString() == key)
+            return QCborValueView(d.data(), pair.second);
+    }
+    return QCborValueView();
+}
+
+/*!
+   \fn QCborValueView QCborValueView::value(const QString &key) const
+   \overload
+*/
+
+/*!
+   Returns the encoded bytes of the value this view refers to, including any
+   nested elements, or a null view if it is invalid or malformed.
+*/
+QByteArrayView QCborValueView::rawData() const
+{
+    if (!d)
+        return QByteArrayView();
+    const qsizetype end = d->skip(pos);
+    if (end < 0)
+        return QByteArrayView();
+    return QByteArrayView(d->data + pos, end - pos);
+}
+
+/*!
+   Decodes the value this view refers to, including all nested elements,
+   and returns it as a QCborValue. Returns an invalid QCborValue if the view
+   is invalid or the value is malformed.
+
+   \sa QCborValue::fromCbor()
+*/
+#if QT_CONFIG(cborstreamreader)
+QCborValue QCborValueView::toCborValue() const
+{
+    const QByteArrayView raw = rawData();
+    if (raw.isNull())
+        return QCborValue(QCborValue::Invalid);
+    return QCborValue::fromCbor(QByteArray::fromRawData(raw.data(), raw.size()));
+}
+#endif
+
+QT_END_NAMESPACE
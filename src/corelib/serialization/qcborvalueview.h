@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QCBORVALUEVIEW_H
+#define QCBORVALUEVIEW_H
+
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+class QCborValueViewPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QCborValueViewPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QCborValueView
+{
+public:
+    QCborValueView() noexcept;
+    QCborValueView(const QCborValueView &other) noexcept;
+    QCborValueView &operator=(const QCborValueView &other) noexcept;
+    QCborValueView(QCborValueView &&other) noexcept = default;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QCborValueView)
+    ~QCborValueView();
+
+    void swap(QCborValueView &other) noexcept
+    {
+        d.swap(other.d);
+        qSwap(pos, other.pos);
+    }
+
+    static QCborValueView fromCbor(const QByteArray &data);
+    static QCborValueView fromRawData(const char *data, qsizetype len);
+    static QCborValueView fromRawData(const quint8 *data, qsizetype len)
+    { return fromRawData(reinterpret_cast<const char *>(data), len); }
+
+    QCborValue::Type type() const;
+    bool isInteger() const          { return type() == QCborValue::Integer; }
+    bool isByteArray() const        { return type() == QCborValue::ByteArray; }
+    bool isString() const           { return type() == QCborValue::String; }
+    bool isArray() const            { return type() == QCborValue::Array; }
+    bool isMap() const              { return type() == QCborValue::Map; }
+    bool isTag() const              { return type() == QCborValue::Tag; }
+    bool isFalse() const            { return type() == QCborValue::False; }
+    bool isTrue() const             { return type() == QCborValue::True; }
+    bool isBool() const             { return isFalse() || isTrue(); }
+    bool isNull() const             { return type() == QCborValue::Null; }
+    bool isUndefined() const        { return type() == QCborValue::Undefined; }
+    bool isDouble() const           { return type() == QCborValue::Double; }
+    bool isSimpleType() const       { return type() >> 8 == QCborValue::SimpleType >> 8; }
+    bool isInvalid() const          { return type() == QCborValue::Invalid; }
+
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    double toDouble(double defaultValue = 0) const;
+    bool toBool(bool defaultValue = false) const;
+    QString toString(const QString &defaultValue = {}) const;
+    QByteArray toByteArray(const QByteArray &defaultValue = {}) const;
+    QByteArrayView rawStringData() const;
+    QCborSimpleType toSimpleType(QCborSimpleType defaultValue = QCborSimpleType::Undefined) const;
+    QCborTag tag(QCborTag defaultValue = QCborTag(-1)) const;
+    QCborValueView taggedValue() const;
+
+    qsizetype size() const;
+    QCborValueView at(qsizetype i) const;
+    QCborValueView value(qint64 key) const;
+    QCborValueView value(QLatin1String key) const;
+    QCborValueView value(QStringView key) const;
+    QCborValueView value(const QString &key) const { return value(qToStringViewIgnoringNull(key)); }
+    bool contains(qint64 key) const { return !value(key).isInvalid(); }
+    bool contains(QLatin1String key) const { return !value(key).isInvalid(); }
+    bool contains(QStringView key) const { return !value(key).isInvalid(); }
+
+    QCborValueView operator[](qsizetype i) const { return at(i); }
+    QCborValueView operator[](QLatin1String key) const { return value(key); }
+    QCborValueView operator[](QStringView key) const { return value(key); }
+    QCborValueView operator[](const QString &key) const { return value(key); }
+
+    QByteArrayView rawData() const;
+#if QT_CONFIG(cborstreamreader)
+    QCborValue toCborValue() const;
+#endif
+
+private:
+    QCborValueView(QCborValueViewPrivate *dd, qsizetype p) noexcept;
+
+    QExplicitlySharedDataPointer<QCborValueViewPrivate> d;
+    qsizetype pos = -1;
+};
+
+Q_DECLARE_SHARED(QCborValueView)
+
+QT_END_NAMESPACE
+
+#endif // QCBORVALUEVIEW_H
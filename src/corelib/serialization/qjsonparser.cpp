@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -283,18 +284,108 @@ void Parser::eatBOM()
         json += 3;
 }
 
-bool Parser::eatSpace()
+/*
+    The scanners below process 16 (or, with AVX2, 32) bytes at a time and
+    leave the remainder to the scalar loops at their end.
+*/
+static inline bool isJsonWhitespace(char c)
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Returns a pointer to the first byte that is not JSON whitespace
+static const char *skipWhitespace(const char *json, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    while (end - json >= 16) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                               _mm_cmpeq_epi8(data, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                               _mm_cmpeq_epi8(data, carriageReturn)));
+        uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 16;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vmaxvq is only available on Aarch64
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t lineFeed = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+    while (end - json >= 16) {
+        uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(data, space), vceqq_u8(data, tab)),
+                                 vorrq_u8(vceqq_u8(data, lineFeed), vceqq_u8(data, carriageReturn)));
+        if (vmaxvq_u8(vmvnq_u8(ws)))
+            break;      // the scalar loop below finds the exact position
+        json += 16;
+    }
+#endif
+
+    while (json < end && isJsonWhitespace(*json))
         ++json;
+    return json;
+}
+
+// Returns a pointer to the first quotation mark, backslash or non-ASCII byte
+static const char *skipPlainAscii(const char *json, const char *end)
+{
+#if defined(__SSE2__)
+#  if defined(__AVX2__)
+    const __m256i quote256 = _mm256_set1_epi8('"');
+    const __m256i backslash256 = _mm256_set1_epi8('\\');
+    while (end - json >= 32) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quote256),
+                                          _mm256_cmpeq_epi8(data, backslash256));
+        // the sign bit of data is set for non-ASCII bytes
+        uint mask = uint(_mm256_movemask_epi8(_mm256_or_si256(special, data)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 32;
+    }
+#  endif
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - json >= 16) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                       _mm_cmpeq_epi8(data, backslash));
+        uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, data)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 16;
     }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t nonAscii = vdupq_n_u8(0x80);
+    while (end - json >= 16) {
+        uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, quote), vceqq_u8(data, backslash)),
+                                      vcgeq_u8(data, nonAscii));
+        if (vmaxvq_u8(special))
+            break;
+        json += 16;
+    }
+#endif
+
+    while (json < end && *json != '"' && *json != '\\' && uchar(*json) < 0x80)
+        ++json;
+    return json;
+}
+
+bool Parser::eatSpace()
+{
+    // most tokens are not preceded by whitespace at all
+    if (json < end && *json > Space)
+        return true;
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -670,6 +761,94 @@ bool Parser::parseValue()
 
 */
 
+/*
+    Converts numbers with at most 18 significant digits and a small decimal
+    exponent without going through QByteArray::toDouble(). Such numbers are
+    exactly representable as integers and powers of ten as doubles, so one
+    multiplication or division gives the correctly rounded result. Returns
+    false for anything else, including malformed numbers, which the caller
+    then converts and diagnoses the regular way.
+*/
+static bool parseSimpleNumber(const char *json, const char *end, QCborValue *value)
+{
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    constexpr int MaxDigits = 18;
+    constexpr int MaxExponent = sizeof(powersOfTen) / sizeof(powersOfTen[0]) - 1;
+
+    const bool negative = json < end && *json == '-';
+    if (negative)
+        ++json;
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    const char *intStart = json;
+    while (json < end && *json >= '0' && *json <= '9') {
+        mantissa = mantissa * 10 + (*json++ - '0');
+        ++digits;
+    }
+    if (json == intStart)
+        return false;
+
+    int exponent = 0;
+    bool isInt = true;
+    if (json < end && *json == '.') {
+        const char *fracStart = ++json;
+        while (json < end && *json >= '0' && *json <= '9') {
+            mantissa = mantissa * 10 + (*json++ - '0');
+            ++digits;
+        }
+        if (json == fracStart)
+            return false;
+        exponent = -int(json - fracStart);
+        isInt = false;
+    }
+    if (digits > MaxDigits)
+        return false;
+
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        ++json;
+        const bool negativeExponent = json < end && *json == '-';
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        const char *expStart = json;
+        int e = 0;
+        while (json < end && *json >= '0' && *json <= '9') {
+            if (e < 10000)
+                e = e * 10 + (*json - '0');
+            ++json;
+        }
+        if (json == expStart)
+            return false;
+        exponent += negativeExponent ? -e : e;
+        isInt = false;
+    }
+    if (json != end)
+        return false;
+
+    if (isInt) {
+        const qint64 n = qint64(mantissa);
+        *value = QCborValue(negative ? -n : n);
+        return true;
+    }
+
+    if (mantissa > (quint64(1) << 53) || exponent < -MaxExponent || exponent > MaxExponent)
+        return false;
+    double d = double(mantissa);
+    d = exponent < 0 ? d / powersOfTen[-exponent] : d * powersOfTen[exponent];
+    if (negative)
+        d = -d;
+
+    qint64 n;
+    if (convertDoubleTo(d, &n))
+        *value = QCborValue(n);
+    else
+        *value = QCborValue(d);
+    return true;
+}
+
 bool Parser::parseNumber()
 {
     BEGIN << "parseNumber" << json;
@@ -713,6 +892,13 @@ bool Parser::parseNumber()
         return false;
     }
 
+    QCborValue simple;
+    if (parseSimpleNumber(start, json, &simple)) {
+        container->append(simple);
+        END;
+        return true;
+    }
+
     const QByteArray number = QByteArray::fromRawData(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -847,9 +1033,11 @@ bool Parser::parseString()
     BEGIN << "parse string" << json;
     bool isUtf8 = true;
     bool isAscii = true;
+    const char *firstEscape = nullptr;
     while (json < end) {
         uint ch = 0;
-        if (*json == '"')
+        json = skipPlainAscii(json, end);
+        if (json >= end || *json == '"')
             break;
         if (*json == '\\') {
             isAscii = false;
@@ -857,14 +1045,14 @@ bool Parser::parseString()
             // escape sequences which are hard to represent in UTF-8.
             // (plain "\\ud800" for example)
             isUtf8 = false;
+            firstEscape = json;
             break;
         }
         if (!scanUtf8Char(json, end, &ch)) {
             lastError = QJsonParseError::IllegalUTF8String;
             return false;
         }
-        if (ch > 0x7f)
-            isAscii = false;
+        isAscii = false;
         DEBUG << "  " << ch << char(ch);
     }
     ++json;
@@ -886,11 +1074,18 @@ bool Parser::parseString()
 
     DEBUG << "has escape sequences";
 
-    json = start;
+    // the part before the first escape sequence has been validated already
+    json = firstEscape;
 
-    QString ucs4;
+    QString ucs4 = QString::fromUtf8(start, firstEscape - start);
     while (json < end) {
         uint ch = 0;
+        if (const char *ascii = skipPlainAscii(json, end); ascii != json) {
+            ucs4.append(QLatin1String(json, int(ascii - json)));
+            json = ascii;
+            if (json >= end)
+                break;
+        }
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -0,0 +1,948 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamreader.h"
+
+#include <private/qnumeric_p.h>
+#include <private/qstringconverter_p.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int nestingLimit = 1024;
+
+/*!
+   \class QJsonStreamReader
+   \inmodule QtCore
+   \ingroup json
+   \reentrant
+   \since 6.1
+
+   \brief The QJsonStreamReader class is a pull parser for JSON text, operating
+   on either a QByteArray or a QIODevice.
+
+   QJsonStreamReader provides a StAX-like API, similar to that of
+   \l{QXmlStreamReader} and \l{QCborStreamReader}. Instead of building a
+   QJsonDocument in memory, it reports the structure of the input as a
+   sequence of tokens, one for each call to readNext():
+
+   \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+   Tokens that carry a value refer directly to the reader's input buffer
+   whenever possible: rawText() returns a view of the UTF-8 bytes of a name or
+   string, and numbers are only converted when toInteger() or toDouble() is
+   called. Strings containing escape sequences are decoded by text() into a
+   buffer that is reused from token to token. Consequently, all views returned
+   by the reader are only valid until the next call to readNext(), addData()
+   or clear().
+
+   \section1 Incremental parsing
+
+   The reader does not require the whole input to be available. When it
+   operates on a QIODevice, readNext() reads more data from the device as
+   needed. When the device has no more data available for the moment, or when
+   all data passed to addData() has been consumed, readNext() returns
+   NoToken without modifying the parser state; parsing resumes once more data
+   has been made available. The input is considered complete once a
+   non-sequential device is at its end, or, for a reader constructed from a
+   QByteArray, at the end of that array.
+
+   QJsonStreamReader accepts a sequence of top-level values, such as the
+   newline-delimited JSON written by many logging systems. atEnd() returns
+   true once the complete input has been consumed or an error occurred.
+
+   \section1 Error handling
+
+   Errors are reported with the same codes as QJsonDocument::fromJson(): once
+   readNext() returns Invalid, hasError() returns true and error() contains
+   the error code and the offset in the input at which it was detected. The
+   reader cannot recover from an error; call clear() to restart.
+
+   \sa QJsonDocument, QCborStreamReader, QXmlStreamReader
+*/
+
+/*!
+   \enum QJsonStreamReader::TokenType
+
+   This enum describes the token last read by readNext().
+
+   \value NoToken       No token has been read yet, or more data is required
+                        to read the next one.
+   \value Invalid       An error occurred; see error().
+   \value StartObject   The start of an object (\c{\{}).
+   \value EndObject     The end of an object (\c{\}}).
+   \value StartArray    The start of an array (\c{[}).
+   \value EndArray      The end of an array (\c{]}).
+   \value Name          The name of an object member; see text().
+   \value String        A string value; see text().
+   \value Number        A number; see toInteger() and toDouble().
+   \value Bool          \c true or \c false; see toBool().
+   \value Null          \c null.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum { ReadChunkSize = 16384 };
+    enum State : quint8 {
+        ExpectValue,
+        ExpectValueOrEndArray,
+        ExpectNameOrEndObject,
+        ExpectName,
+        ExpectNameSeparator,
+        ExpectValueSeparatorOrEnd
+    };
+    enum ScanResult { Complete, Separator, NeedMoreData, Failed };
+
+    QJsonStreamReader::TokenType readNext();
+    void clear();
+    void addData(const QByteArray &data);
+
+    bool inputComplete() const
+    {
+        if (device)
+            return !device->isSequential() && device->atEnd();
+        return dataComplete;
+    }
+    bool fetchMore();
+    void compact();
+
+    QJsonStreamReader::TokenType endOfInput();
+    ScanResult scanToken();
+    ScanResult scanValue();
+    ScanResult scanString();
+    ScanResult scanNumber();
+    ScanResult scanLiteral(QByteArrayView literal);
+    ScanResult startContainer(QJsonStreamReader::TokenType type);
+    ScanResult endContainer(QJsonStreamReader::TokenType type);
+    ScanResult fail(QJsonParseError::ParseError code)
+    {
+        error = code;
+        errorOffset = bufferOffset + pos;
+        token = QJsonStreamReader::Invalid;
+        return Failed;
+    }
+    void afterValue()
+    {
+        state = containers.isEmpty() ? ExpectValue : ExpectValueSeparatorOrEnd;
+    }
+
+    void decodeText() const;
+    void convertNumber() const;
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qint64 bufferOffset = 0;       // offset of buffer[0] in the whole input
+    qsizetype pos = 0;             // first byte not consumed yet
+    QVarLengthArray<QJsonStreamReader::TokenType, 16> containers;
+
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    qint64 errorOffset = -1;
+
+    // the current token; tokenStart is relative to buffer
+    qsizetype tokenStart = 0;
+    qsizetype tokenLength = 0;
+    // progress of a string spanning more than the available data
+    qsizetype scannedLength = 0;
+    bool scannedEscapes = false;
+
+    QJsonStreamReader::TokenType token = QJsonStreamReader::NoToken;
+    State state = ExpectValue;
+    bool dataComplete = false;
+    bool reachedEnd = false;
+    bool tokenHasEscapes = false;
+    bool numberLooksIntegral = false;
+    bool boolValue = false;
+
+    mutable bool textDecoded = false;
+    mutable bool numberConverted = false;
+    mutable bool numberIsInteger = false;
+    mutable qint64 integerValue = 0;
+    mutable double doubleValue = 0;
+    mutable QString decodedText;
+};
+
+static inline bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline bool addHexDigit(char digit, uint *result)
+{
+    *result <<= 4;
+    if (digit >= '0' && digit <= '9')
+        *result |= (digit - '0');
+    else if (digit >= 'a' && digit <= 'f')
+        *result |= (digit - 'a') + 10;
+    else if (digit >= 'A' && digit <= 'F')
+        *result |= (digit - 'A') + 10;
+    else
+        return false;
+    return true;
+}
+
+void QJsonStreamReaderPrivate::clear()
+{
+    buffer.clear();
+    bufferOffset = 0;
+    pos = 0;
+    containers.clear();
+    error = QJsonParseError::NoError;
+    errorOffset = -1;
+    tokenStart = tokenLength = 0;
+    scannedLength = 0;
+    scannedEscapes = false;
+    token = QJsonStreamReader::NoToken;
+    state = ExpectValue;
+    dataComplete = false;
+    reachedEnd = false;
+    textDecoded = numberConverted = false;
+}
+
+void QJsonStreamReaderPrivate::addData(const QByteArray &data)
+{
+    compact();
+    buffer += data;
+    dataComplete = false;
+    reachedEnd = false;
+}
+
+// Drops the consumed part of the buffer once it makes up at least half of
+// it, so that the cost of moving the unconsumed data is amortized.
+void QJsonStreamReaderPrivate::compact()
+{
+    if (pos == 0 || pos < buffer.size() - pos)
+        return;
+    buffer.remove(0, pos);
+    bufferOffset += pos;
+    tokenStart -= pos;
+    pos = 0;
+}
+
+bool QJsonStreamReaderPrivate::fetchMore()
+{
+    if (!device)
+        return false;
+
+    compact();
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(oldSize + ReadChunkSize);
+    const qint64 n = device->read(buffer.data() + oldSize, ReadChunkSize);
+    buffer.resize(oldSize + qMax(n, qint64(0)));
+    return n > 0;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error != QJsonParseError::NoError)
+        return token = QJsonStreamReader::Invalid;
+
+    textDecoded = numberConverted = false;
+    forever {
+        const char *data = buffer.constData();
+        const qsizetype size = buffer.size();
+        while (pos < size && isJsonWhitespace(data[pos]))
+            ++pos;
+        if (pos == size) {
+            if (fetchMore())
+                continue;
+            return endOfInput();
+        }
+
+        switch (scanToken()) {
+        case Complete:
+        case Failed:
+            return token;
+        case Separator:
+            continue;
+        case NeedMoreData:
+            break;
+        }
+
+        if (fetchMore())
+            continue;
+        if (!inputComplete())
+            return token = QJsonStreamReader::NoToken;
+        fail(buffer.at(pos) == '"' ? QJsonParseError::UnterminatedString
+                                   : QJsonParseError::IllegalValue);
+        return token;
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endOfInput()
+{
+    if (!inputComplete())
+        return token = QJsonStreamReader::NoToken;
+    if (containers.isEmpty()) {
+        reachedEnd = true;
+        return token = QJsonStreamReader::NoToken;
+    }
+    fail(containers.last() == QJsonStreamReader::StartObject
+         ? QJsonParseError::UnterminatedObject : QJsonParseError::UnterminatedArray);
+    return token;
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanToken()
+{
+    const char c = buffer.at(pos);
+    const bool inObject = !containers.isEmpty()
+            && containers.last() == QJsonStreamReader::StartObject;
+
+    switch (state) {
+    case ExpectValueSeparatorOrEnd:
+        if (c == ',') {
+            ++pos;
+            state = inObject ? ExpectName : ExpectValue;
+            return Separator;
+        }
+        if (inObject)
+            return c == '}' ? endContainer(QJsonStreamReader::EndObject)
+                            : fail(QJsonParseError::UnterminatedObject);
+        return c == ']' ? endContainer(QJsonStreamReader::EndArray)
+                        : fail(QJsonParseError::MissingValueSeparator);
+
+    case ExpectNameSeparator:
+        if (c != ':')
+            return fail(QJsonParseError::MissingNameSeparator);
+        ++pos;
+        state = ExpectValue;
+        return Separator;
+
+    case ExpectNameOrEndObject:
+        if (c == '}')
+            return endContainer(QJsonStreamReader::EndObject);
+        Q_FALLTHROUGH();
+    case ExpectName:
+        if (c == '}')
+            return fail(QJsonParseError::MissingObject);
+        if (c != '"')
+            return fail(QJsonParseError::UnterminatedObject);
+        if (ScanResult r = scanString(); r != Complete)
+            return r;
+        state = ExpectNameSeparator;
+        token = QJsonStreamReader::Name;
+        return Complete;
+
+    case ExpectValueOrEndArray:
+        if (c == ']')
+            return endContainer(QJsonStreamReader::EndArray);
+        Q_FALLTHROUGH();
+    case ExpectValue:
+        return scanValue();
+    }
+    Q_UNREACHABLE();
+    return Failed;
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanValue()
+{
+    ScanResult r;
+    switch (buffer.at(pos)) {
+    case '{':
+        return startContainer(QJsonStreamReader::StartObject);
+    case '[':
+        return startContainer(QJsonStreamReader::StartArray);
+    case '"':
+        r = scanString();
+        token = QJsonStreamReader::String;
+        break;
+    case 't':
+        r = scanLiteral("true");
+        token = QJsonStreamReader::Bool;
+        boolValue = true;
+        break;
+    case 'f':
+        r = scanLiteral("false");
+        token = QJsonStreamReader::Bool;
+        boolValue = false;
+        break;
+    case 'n':
+        r = scanLiteral("null");
+        token = QJsonStreamReader::Null;
+        break;
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        r = scanNumber();
+        token = QJsonStreamReader::Number;
+        break;
+    default:
+        return fail(QJsonParseError::IllegalValue);
+    }
+
+    if (r == Complete)
+        afterValue();
+    else if (r == Failed)
+        token = QJsonStreamReader::Invalid;
+    return r;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::startContainer(QJsonStreamReader::TokenType type)
+{
+    if (containers.size() >= nestingLimit)
+        return fail(QJsonParseError::DeepNesting);
+    ++pos;
+    containers.append(type);
+    state = type == QJsonStreamReader::StartObject ? ExpectNameOrEndObject : ExpectValueOrEndArray;
+    token = type;
+    return Complete;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::endContainer(QJsonStreamReader::TokenType type)
+{
+    ++pos;
+    containers.removeLast();
+    afterValue();
+    token = type;
+    return Complete;
+}
+
+/*
+    Scans the string starting with the quotation mark at pos and validates
+    its UTF-8 and escape sequences, without decoding it. If the closing
+    quotation mark is not available yet, the validated length is remembered
+    so that scanning resumes there once more data has been read.
+*/
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanString()
+{
+    const char *begin = buffer.constData() + pos + 1;
+    const char *end = buffer.constData() + buffer.size();
+    const char *json = begin + scannedLength;
+
+    while (json < end) {
+        const uchar c = uchar(*json);
+        if (c == '"') {
+            tokenStart = pos + 1;
+            tokenLength = json - begin;
+            tokenHasEscapes = scannedEscapes;
+            pos = tokenStart + tokenLength + 1;
+            scannedLength = 0;
+            scannedEscapes = false;
+            return Complete;
+        }
+
+        if (c < 0x80 && c != '\\') {
+            ++json;
+        } else if (c == '\\') {
+            if (end - json < 2)
+                break;
+            if (json[1] == 'u') {
+                if (end - json < 6)
+                    break;
+                uint ch = 0;
+                for (int i = 2; i < 6; ++i) {
+                    if (!addHexDigit(json[i], &ch)) {
+                        pos += json - begin + 1;
+                        return fail(QJsonParseError::IllegalEscapeSequence);
+                    }
+                }
+                json += 6;
+            } else {
+                json += 2;
+            }
+            scannedEscapes = true;
+        } else {
+            const uchar *src = reinterpret_cast<const uchar *>(json) + 1;
+            const uchar *uend = reinterpret_cast<const uchar *>(end);
+            uint ucs4;
+            uint *dst = &ucs4;
+            const int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(c, dst, src, uend);
+            if (res == QUtf8BaseTraits::EndOfString)
+                break;
+            if (res < 0) {
+                pos += json - begin + 1;
+                return fail(QJsonParseError::IllegalUTF8String);
+            }
+            json = reinterpret_cast<const char *>(src);
+        }
+    }
+
+    scannedLength = json - begin;
+    return NeedMoreData;
+}
+
+/*
+    The number grammar is that of RFC 8259, section 6; the value is converted
+    lazily by convertNumber().
+*/
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanNumber()
+{
+    const char *start = buffer.constData() + pos;
+    const char *end = buffer.constData() + buffer.size();
+    const char *json = start;
+    bool isInt = true;
+    bool valid;
+
+    // minus
+    if (*json == '-')
+        ++json;
+
+    // int = zero / ( digit1-9 *DIGIT )
+    const char *digits = json;
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && isDigit(*json))
+            ++json;
+    }
+    valid = json > digits;
+
+    // frac = decimal-point 1*DIGIT
+    if (json < end && *json == '.') {
+        const char *frac = ++json;
+        while (json < end && isDigit(*json)) {
+            isInt = isInt && *json == '0';
+            ++json;
+        }
+        valid = valid && json > frac;
+    }
+
+    // exp = e [ minus / plus ] 1*DIGIT
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        const char *exp = json;
+        while (json < end && isDigit(*json))
+            ++json;
+        valid = valid && json > exp;
+    }
+
+    if (json == end && !inputComplete())
+        return NeedMoreData;
+    if (!valid || (json < end && isDigit(*json)))
+        return fail(QJsonParseError::IllegalNumber);
+
+    tokenStart = pos;
+    tokenLength = json - start;
+    numberLooksIntegral = isInt;
+    pos += tokenLength;
+    return Complete;
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanLiteral(QByteArrayView literal)
+{
+    const qsizetype available = qMin(buffer.size() - pos, literal.size());
+    if (memcmp(buffer.constData() + pos, literal.data(), available) != 0)
+        return fail(QJsonParseError::IllegalValue);
+    if (available < literal.size())
+        return NeedMoreData;
+
+    tokenStart = pos;
+    tokenLength = literal.size();
+    pos += literal.size();
+    return Complete;
+}
+
+void QJsonStreamReaderPrivate::decodeText() const
+{
+    const char *json = buffer.constData() + tokenStart;
+    const char *end = json + tokenLength;
+
+    // the decoded text never has more code units than the UTF-8 input
+    decodedText.resize(tokenLength);
+    QChar *out = decodedText.data();
+    if (!tokenHasEscapes) {
+        out = QUtf8::convertToUnicode(out, QByteArrayView(json, end));
+    } else {
+        while (json < end) {
+            const char *backslash = static_cast<const char *>(memchr(json, '\\', end - json));
+            if (!backslash)
+                backslash = end;
+            out = QUtf8::convertToUnicode(out, QByteArrayView(json, backslash));
+            json = backslash;
+            if (json == end)
+                break;
+
+            // scanString() has validated the escape sequence already
+            uint ch = 0;
+            switch (json[1]) {
+            case 'b': ch = 0x8; break;
+            case 'f': ch = 0xc; break;
+            case 'n': ch = 0xa; break;
+            case 'r': ch = 0xd; break;
+            case 't': ch = 0x9; break;
+            case 'u':
+                for (int i = 2; i < 6; ++i)
+                    addHexDigit(json[i], &ch);
+                json += 4;
+                break;
+            default:
+                // like QJsonDocument, pass unknown escapes through
+                ch = uchar(json[1]);
+                break;
+            }
+            json += 2;
+            *out++ = QChar(ch);
+        }
+    }
+    decodedText.truncate(out - decodedText.constData());
+    textDecoded = true;
+}
+
+void QJsonStreamReaderPrivate::convertNumber() const
+{
+    const QByteArray number =
+            QByteArray::fromRawData(buffer.constData() + tokenStart, tokenLength);
+    bool ok = false;
+    if (numberLooksIntegral) {
+        integerValue = number.toLongLong(&ok);
+        if (ok) {
+            doubleValue = double(integerValue);
+            numberIsInteger = true;
+        }
+    }
+    if (!ok) {
+        doubleValue = number.toDouble();
+        numberIsInteger = convertDoubleTo(doubleValue, &integerValue);
+    }
+    numberConverted = true;
+}
+
+/*!
+   Creates a QJsonStreamReader object with no source data. Use addData() or
+   setDevice() to provide the input.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+   Creates a QJsonStreamReader object that reads from \a device. The device
+   must be open for reading.
+
+   \sa setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    setDevice(device);
+}
+
+/*!
+   Creates a QJsonStreamReader object that parses the JSON text in \a data.
+   The reader treats \a data as the complete input, unless more is appended
+   with addData().
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    d->buffer = data;
+    d->dataComplete = true;
+}
+
+/*!
+   Destroys this QJsonStreamReader object. The device, if any, is not closed.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+   Sets the source of data to \a device, resetting the parser to its initial
+   state.
+
+   \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->clear();
+    d->device = device;
+}
+
+/*!
+   Returns the QIODevice that was set with either setDevice() or the
+   QJsonStreamReader constructor, or \nullptr if the reader operates on
+   data passed to addData().
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+   Appends \a data to the input of this reader. The parser state is kept, so
+   a token split across two calls is reported once its remaining bytes have
+   been added. This function must not be used when reading from a device.
+
+   All views returned by rawText() and text() are invalidated.
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->addData(data);
+}
+
+/*!
+   Discards the input and resets the parser to its initial state. The device,
+   if any, is kept.
+*/
+void QJsonStreamReader::clear()
+{
+    d->clear();
+}
+
+/*!
+   Returns true if the complete input has been parsed, or if an error
+   occurred. Returns false if more data may still arrive.
+
+   \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->reachedEnd || d->error != QJsonParseError::NoError;
+}
+
+/*!
+   Reads the next token and returns its type.
+
+   Returns NoToken if the end of the input has been reached, or if more data
+   is required to complete the next token. Returns Invalid if the input is
+   not valid JSON.
+
+   \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    return d->readNext();
+}
+
+/*!
+   Returns the type of the token last read by readNext().
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->token;
+}
+
+/*!
+   Returns the number of objects and arrays that enclose the current parser
+   position. After a StartObject or StartArray token, this includes the
+   container that was just started.
+*/
+int QJsonStreamReader::depth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+   Returns the offset in the input of the first byte not consumed by the
+   parser yet.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+   Returns the UTF-8 text of the current Name or String token as it appears in
+   the input, without the enclosing quotation marks and with escape sequences
+   left undecoded, or an empty view for other tokens.
+
+   This function never copies or allocates. If hasEscapeSequences() returns
+   false, the view is the exact UTF-8 text of the token. The view is only
+   valid until the next call to readNext().
+
+   \sa text(), hasEscapeSequences()
+*/
+QByteArrayView QJsonStreamReader::rawText() const
+{
+    if (d->token != Name && d->token != String)
+        return QByteArrayView();
+    return QByteArrayView(d->buffer.constData() + d->tokenStart, d->tokenLength);
+}
+
+/*!
+   Returns true if the current Name or String token contains escape
+   sequences, in which case rawText() differs from its decoded text.
+*/
+bool QJsonStreamReader::hasEscapeSequences() const
+{
+    return (d->token == Name || d->token == String) && d->tokenHasEscapes;
+}
+
+/*!
+   Returns the decoded text of the current Name or String token, or an empty
+   view for other tokens.
+
+   The text is decoded on first use into a buffer owned by the reader, which
+   is reused for subsequent tokens, so the view is only valid until the next
+   call to readNext().
+
+   \sa toString(), rawText()
+*/
+QStringView QJsonStreamReader::text() const
+{
+    if (d->token != Name && d->token != String)
+        return QStringView();
+    if (!d->textDecoded)
+        d->decodeText();
+    return d->decodedText;
+}
+
+/*!
+   \fn QString QJsonStreamReader::toString() const
+
+   Returns a copy of text().
+*/
+
+/*!
+   Returns true if the current token is a Number that can be represented
+   exactly as a 64-bit integer.
+
+   \sa toInteger(), toDouble()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    if (d->token != Number)
+        return false;
+    if (!d->numberConverted)
+        d->convertNumber();
+    return d->numberIsInteger;
+}
+
+/*!
+   Returns the value of the current Number token as a 64-bit integer, or 0
+   if it is not a number or cannot be represented exactly as one.
+
+   \sa isInteger(), toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return isInteger() ? d->integerValue : 0;
+}
+
+/*!
+   Returns the value of the current Number token as a double, or 0 if the
+   current token is not a number.
+
+   \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    if (d->token != Number)
+        return 0;
+    if (!d->numberConverted)
+        d->convertNumber();
+    return d->doubleValue;
+}
+
+/*!
+   Returns the value of the current Bool token, or false if the current token
+   is not a boolean.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->token == Bool && d->boolValue;
+}
+
+/*!
+   Skips the current value. If the current token is a Name, the member value
+   following it is skipped; if it is StartObject or StartArray, all tokens
+   up to and including the matching end token are skipped.
+
+   Returns true on success, or false if an error occurred or the input ended
+   before the value was complete.
+*/
+bool QJsonStreamReader::skipCurrentValue()
+{
+    TokenType type = tokenType();
+    if (type == Name)
+        type = readNext();
+    if (type != StartObject && type != StartArray)
+        return type != NoToken && type != Invalid;
+
+    const int target = depth() - 1;
+    while (depth() > target) {
+        type = readNext();
+        if (type == NoToken || type == Invalid)
+            return false;
+    }
+    return true;
+}
+
+/*!
+   Returns true if the input is not valid JSON.
+
+   \sa error(), errorString()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != QJsonParseError::NoError;
+}
+
+/*!
+   Returns the error that occurred while parsing, if any, together with the
+   offset in the input at which it was detected.
+
+   \sa hasError(), errorString()
+*/
+QJsonParseError QJsonStreamReader::error() const
+{
+    QJsonParseError result;
+    result.error = d->error;
+    result.offset = int(d->errorOffset);
+    return result;
+}
+
+/*!
+   Returns a human-readable description of the last error.
+
+   \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    return error().errorString();
+}
+
+QT_END_NAMESPACE
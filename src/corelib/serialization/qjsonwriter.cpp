@@ -45,6 +45,7 @@
 #include "private/qstringconverter_p.h"
 #include <private/qnumeric_p.h>
 #include <private/qcborvalue_p.h>
+#include <private/qlocale_tools_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -143,10 +144,18 @@ static void valueToJson(const QCborValue &v, QByteArray &json, int indent, bool
         break;
     case QCborValue::Double: {
         const double d = v.toDouble();
-        if (qIsFinite(d))
-            json += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
-        else
+        if (qIsFinite(d)) {
+            // Same as QByteArray::number(d, 'g', QLocale::FloatingPointShortest)
+            char buffer[QDoubleToCLocaleBufferSize];
+            const qsizetype length = qt_doubleToCLocale(d, QLocaleData::DFSignificantDigits,
+                                                        QLocale::FloatingPointShortest,
+                                                        QLocaleData::ZeroPadExponent,
+                                                        buffer, sizeof(buffer));
+            Q_ASSERT(length > 0);
+            json.append(buffer, length);
+        } else {
             json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+        }
         break;
     }
     case QCborValue::String:
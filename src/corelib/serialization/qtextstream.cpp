@@ -233,6 +233,7 @@ static const int QTEXTSTREAM_BUFFERSIZE = 16384;
 
 #include <locale.h>
 #include "private/qlocale_p.h"
+#include "private/qlocale_tools_p.h"
 #include "private/qstringconverter_p.h"
 
 #include <stdlib.h>
@@ -2497,6 +2498,15 @@ QTextStream &QTextStream::operator<<(double f)
         flags |= QLocaleData::AddTrailingZeroes;
 
     const QLocaleData *dd = d->locale.d->m_data;
+    if (dd == QLocaleData::c()) {
+        char16_t buffer[QDoubleToCLocaleBufferSize];
+        const qsizetype length = qt_doubleToCLocale(f, form, d->params.realNumberPrecision, flags,
+                                                    buffer, QDoubleToCLocaleBufferSize);
+        if (length >= 0) {
+            d->putString(reinterpret_cast<const QChar *>(buffer), int(length), true);
+            return *this;
+        }
+    }
     QString num = dd->doubleToString(f, d->params.realNumberPrecision, form, -1, flags);
     d->putString(num, true);
     return *this;
@@ -8,6 +8,7 @@ HEADERS += \
     serialization/qcborstream.h \
     serialization/qcborvalue.h \
     serialization/qcborvalue_p.h \
+    serialization/qcborvalueview.h \
     serialization/qdatastream.h \
     serialization/qdatastream_p.h \
     serialization/qjson_p.h \
@@ -17,6 +18,7 @@ HEADERS += \
     serialization/qjsonarray.h \
     serialization/qjsonwriter_p.h \
     serialization/qjsonparser_p.h \
+    serialization/qjsonstreamreader.h \
     serialization/qtextstream.h \
     serialization/qtextstream_p.h \
     serialization/qxmlstream.h \
@@ -29,6 +31,7 @@ SOURCES += \
     serialization/qcborcommon.cpp \
     serialization/qcbordiagnostic.cpp \
     serialization/qcborvalue.cpp \
+    serialization/qcborvalueview.cpp \
     serialization/qdatastream.cpp \
     serialization/qjsoncbor.cpp \
     serialization/qjsondocument.cpp \
@@ -37,6 +40,7 @@ SOURCES += \
     serialization/qjsonvalue.cpp \
     serialization/qjsonwriter.cpp \
     serialization/qjsonparser.cpp \
+    serialization/qjsonstreamreader.cpp \
     serialization/qtextstream.cpp \
     serialization/qxmlstream.cpp \
     serialization/qxmlstreamgrammar.cpp \
@@ -51,6 +51,7 @@
 #include "qstringalgorithms_p.h"
 #include "qscopedpointer.h"
 #include "qbytearray_p.h"
+#include "qstringconverter_p.h"
 #include <qdatastream.h>
 #include <qmath.h>
 
@@ -2656,6 +2657,21 @@ bool QByteArray::isLower() const
     return true;
 }
 
+/*!
+    \fn bool QByteArray::isValidUtf8() const
+    \since 6.1
+
+    Returns \c true if this byte array contains valid UTF-8 encoded data,
+    or \c false otherwise.
+
+    \sa QByteArrayView::isValidUtf8(), QString::fromUtf8()
+*/
+
+bool QtPrivate::isValidUtf8(QByteArrayView s) noexcept
+{
+    return QUtf8::isValidUtf8(s).isValidUtf8;
+}
+
 /*!
     Returns a byte array that contains the first \a len bytes of this byte
     array.
@@ -3928,7 +3944,12 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
             break;
     }
 
-    *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toUtf8();
+    char buffer[QDoubleToCLocaleBufferSize];
+    const qsizetype length = qt_doubleToCLocale(n, form, prec, flags, buffer, sizeof(buffer));
+    if (length >= 0)
+        *this = QByteArray(buffer, length);
+    else
+        *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toUtf8();
     return *this;
 }
 
@@ -69,6 +69,9 @@ qsizetype count(QByteArrayView haystack, QByteArrayView needle) noexcept;
 
 [[nodiscard]] Q_CORE_EXPORT int compareMemory(QByteArrayView lhs, QByteArrayView rhs);
 
+[[nodiscard]] Q_CORE_EXPORT Q_DECL_PURE_FUNCTION
+bool isValidUtf8(QByteArrayView s) noexcept;
+
 } // namespace QtPrivate
 
 QT_END_NAMESPACE
@@ -291,6 +291,7 @@ public:
     //
     [[nodiscard]] constexpr bool isNull() const noexcept { return !m_data; }
     [[nodiscard]] constexpr bool isEmpty() const noexcept { return empty(); }
+    [[nodiscard]] bool isValidUtf8() const noexcept { return QtPrivate::isValidUtf8(*this); }
 #if QT_DEPRECATED_SINCE(6, 0)
     [[nodiscard]]
     Q_DECL_DEPRECATED_X("Use size() and port callers to qsizetype.")
@@ -3824,6 +3824,34 @@ bool QLocaleData::validateChars(QStringView str, NumberMode numMode, QByteArray
 double QLocaleData::stringToDouble(QStringView str, bool *ok,
                                    QLocale::NumberOptions number_options) const
 {
+    // In the C locale, a number made only of ASCII digits, points, signs and
+    // exponent markers reads the same after numberToCLocale(), so skip that
+    // unless it has to check for leading or trailing zeros:
+    if (this == c() && !(number_options & (QLocale::RejectLeadingZeroInExponent
+                                           | QLocale::RejectTrailingZeroesAfterDot))) {
+        const QStringView trimmed = str.trimmed();
+        char plain[64];
+        qsizetype length = 0;
+        if (trimmed.size() <= qsizetype(sizeof(plain))) {
+            for (QChar ch : trimmed) {
+                const char16_t c = ch.unicode();
+                if ((c < u'0' || c > u'9') && c != u'.' && c != u'+' && c != u'-'
+                    && c != u'e' && c != u'E') {
+                    break;
+                }
+                plain[length++] = char(c);
+            }
+        }
+        if (length > 0 && length == trimmed.size()) {
+            int processed = 0;
+            bool nonNullOk = false;
+            double d = qt_asciiToDouble(plain, length, nonNullOk, processed);
+            if (ok != nullptr)
+                *ok = nonNullOk;
+            return d;
+        }
+    }
+
     CharBuff buff;
     if (!numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
@@ -282,6 +282,178 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, cha
         --length;
 }
 
+namespace {
+template <typename Char>
+class CLocaleNumberWriter
+{
+public:
+    CLocaleNumberWriter(Char *buf, qsizetype size, bool upper)
+        : m_out(buf), m_end(buf + size), m_upper(upper) {}
+
+    void put(char c)
+    {
+        if (m_out == m_end) {
+            m_overflow = true;
+            return;
+        }
+        if (m_upper && c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+        *m_out++ = Char(c);
+    }
+    void putZeros(int count)
+    {
+        for (; count > 0; --count)
+            put('0');
+    }
+    void putExponent(int exponent, int minDigits)
+    {
+        put('e');
+        put(exponent < 0 ? '-' : '+');
+        char digits[8];
+        int count = 0;
+        for (uint value = qAbs(exponent); value || count < minDigits; value /= 10)
+            digits[count++] = char('0' + value % 10);
+        while (count > 0)
+            put(digits[--count]);
+    }
+    qsizetype finish(Char *buf) const { return m_overflow ? -1 : m_out - buf; }
+
+private:
+    Char *m_out;
+    Char *const m_end;
+    const bool m_upper;
+    bool m_overflow = false;
+};
+
+// Mirrors QLocaleData::doubleToString() for the C locale, see qt_doubleToCLocale()
+template <typename Char>
+qsizetype doubleToCLocale(double d, QLocaleData::DoubleForm form, int precision, uint flags,
+                          Char *buf, qsizetype bufSize)
+{
+    if (flags & (QLocaleData::GroupDigits | QLocaleData::ZeroPadded))
+        return -1;
+    if (precision != QLocale::FloatingPointShortest && precision < 0)
+        precision = 6;
+
+    int digitsSize = 1;
+    if (precision == QLocale::FloatingPointShortest)
+        digitsSize += std::numeric_limits<double>::max_digits10;
+    else if (form == QLocaleData::DFDecimal)
+        digitsSize += wholePartSpace(qAbs(d)) + precision;
+    else
+        digitsSize += qMax(2, precision) + 1;
+    char digits[64];
+    if (digitsSize > int(sizeof(digits)))
+        return -1;
+    int length;
+    int decpt;
+    bool negative = false;
+    qt_doubleToAscii(d, form, precision, digits, digitsSize, negative, length, decpt);
+
+    CLocaleNumberWriter<Char> out(buf, bufSize, flags & QLocaleData::CapitalEorX);
+    if (negative && !isZero(d))
+        out.put('-');
+    else if (flags & QLocaleData::AlwaysShowSign)
+        out.put('+');
+    else if (flags & QLocaleData::BlankBeforePositive)
+        out.put(' ');
+
+    if (qstrncmp(digits, "inf", 3) == 0 || qstrncmp(digits, "nan", 3) == 0) {
+        for (int i = 0; i < length; ++i)
+            out.put(digits[i]);
+        return out.finish(buf);
+    }
+
+    const bool mustMarkDecimal = flags & QLocaleData::ForcePoint;
+    const int minExponentDigits = flags & QLocaleData::ZeroPadExponent ? 2 : 1;
+    bool useDecimal = form == QLocaleData::DFDecimal;
+    bool chopTrailingZeros = false;
+    if (form == QLocaleData::DFSignificantDigits) {
+        chopTrailingZeros = !(flags & QLocaleData::AddTrailingZeroes);
+        if (precision == QLocale::FloatingPointShortest) {
+            // Same choice as QLocaleData::doubleToString(), without grouping
+            int bias = 2 + minExponentDigits;
+            if (decpt > 10 && minExponentDigits == 1)
+                ++bias;
+            if (!mustMarkDecimal) {
+                if (length <= decpt && length > 1)
+                    ++bias;
+                else if (length == 1 && decpt <= 0)
+                    --bias;
+            }
+            useDecimal = (decpt <= 0 ? 1 - decpt <= bias
+                          : decpt <= length ? 0 <= bias
+                          : decpt <= length + bias);
+        } else {
+            useDecimal = decpt > -4 && decpt <= (precision ? precision : 1);
+        }
+    }
+
+    if (useDecimal) {
+        // Leading zeros for negative decpt, then the digits, padded to decpt
+        const int leadingZeros = decpt < 0 ? -decpt : 0;
+        const int point = qMax(decpt, 0);
+        int total = leadingZeros + (decpt < 0 ? length : qMax(length, decpt));
+        if (form == QLocaleData::DFDecimal)
+            total = qMax(total, point + precision);
+        else if (!chopTrailingZeros)
+            total = qMax(total, precision);
+        if (point == 0)
+            out.put('0');
+        for (int i = 0; i < total; ++i) {
+            if (i == point)
+                out.put('.');
+            const int digit = i - leadingZeros;
+            out.put(digit >= 0 && digit < length ? digits[digit] : '0');
+        }
+        if (mustMarkDecimal && point == total)
+            out.put('.');
+    } else {
+        int total = length;
+        if (form == QLocaleData::DFExponent)
+            total = qMax(total, precision + 1);
+        else if (!chopTrailingZeros)
+            total = qMax(total, precision);
+        out.put(digits[0]);
+        if (mustMarkDecimal || total > 1)
+            out.put('.');
+        for (int i = 1; i < total; ++i)
+            out.put(i < length ? digits[i] : '0');
+        out.putExponent(decpt - 1, minExponentDigits);
+    }
+    return out.finish(buf);
+}
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Formats \a d in the C locale into \a buf, which has room for \a bufSize
+    characters, producing what QLocaleData::c()->doubleToString() would with
+    the same \a form, \a precision and \a flags and no field width. This avoids
+    the intermediate strings of that function.
+
+    Returns the number of characters written, or -1 if \a buf is too short or
+    \a flags asks for grouping or zero-padding; callers then fall back to
+    doubleToString(). QDoubleToCLocaleBufferSize is always enough for
+    QLocale::FloatingPointShortest.
+*/
+qsizetype qt_doubleToCLocale(double d, QLocaleData::DoubleForm form, int precision, uint flags,
+                             char *buf, qsizetype bufSize)
+{
+    return doubleToCLocale(d, form, precision, flags, buf, bufSize);
+}
+
+/*!
+    \internal
+    \overload
+*/
+qsizetype qt_doubleToCLocale(double d, QLocaleData::DoubleForm form, int precision, uint flags,
+                             char16_t *buf, qsizetype bufSize)
+{
+    return doubleToCLocale(d, form, precision, flags, buf, bufSize);
+}
+
 double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &processed,
                         StrayCharacterMode strayCharMode)
 {
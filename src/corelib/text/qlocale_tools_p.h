@@ -68,6 +68,13 @@ double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &proces
 void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *buf, int bufSize,
                       bool &sign, int &length, int &decpt);
 
+// Enough for any double in QLocale::FloatingPointShortest precision
+enum { QDoubleToCLocaleBufferSize = 32 };
+Q_CORE_EXPORT qsizetype qt_doubleToCLocale(double d, QLocaleData::DoubleForm form, int precision,
+                                           uint flags, char *buf, qsizetype bufSize);
+Q_CORE_EXPORT qsizetype qt_doubleToCLocale(double d, QLocaleData::DoubleForm form, int precision,
+                                           uint flags, char16_t *buf, qsizetype bufSize);
+
 QString qulltoa(qulonglong l, int base, const QStringView zero);
 Q_CORE_EXPORT QString qdtoa(qreal d, int *decpt, int *sign);
 
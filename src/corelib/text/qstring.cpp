@@ -7276,6 +7276,11 @@ QString QString::number(double n, char f, int prec)
             break;
     }
 
+    char16_t buffer[QDoubleToCLocaleBufferSize];
+    const qsizetype length = qt_doubleToCLocale(n, form, prec, flags, buffer,
+                                                QDoubleToCLocaleBufferSize);
+    if (length >= 0)
+        return QString(reinterpret_cast<const QChar *>(buffer), length);
     return QLocaleData::c()->doubleToString(n, prec, form, -1, flags);
 }
 
@@ -482,6 +482,545 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && defined(Q_PROCESSOR_X86_64)
+#  define QT_UTF8_SIMD_MULTIBYTE
+// Classification of the bytes of a block of UTF-8 text, as used by the
+// vectorized decoders below. Bit i of each mask describes the byte at offset i.
+struct Utf8BlockMasks
+{
+    quint64 ascii;          // 0x00 to 0x7f
+    quint64 continuation;   // 0x80 to 0xbf
+    quint64 lead2;          // 0xc2 to 0xdf
+    quint64 lead3;          // 0xe0 to 0xef
+    quint64 lead4;          // 0xf0 to 0xf4
+    quint64 badSecondByte;  // lead bytes whose next byte starts an overlong
+                            // form, a surrogate or a code point > U+10FFFF
+};
+
+// Builds the block masks from the bytes that are at least, or equal to, the
+// given values.
+static inline Utf8BlockMasks utf8BlockMasks(quint64 nonAscii, quint64 atLeast90, quint64 atLeastA0,
+                                            quint64 atLeastC0, quint64 atLeastC2, quint64 atLeastE0,
+                                            quint64 atLeastF0, quint64 atLeastF5,
+                                            quint64 isE0, quint64 isED, quint64 isF0, quint64 isF4)
+{
+    // E0 80-9F and F0 80-8F are overlong, ED A0-BF are surrogates and
+    // F4 90-BF are past U+10FFFF
+    const quint64 badSecondByte = (isE0 & ~(atLeastA0 >> 1)) | (isED & (atLeastA0 >> 1))
+            | (isF0 & ~(atLeast90 >> 1)) | (isF4 & (atLeast90 >> 1));
+    return { ~nonAscii, nonAscii & ~atLeastC0, atLeastC2 & ~atLeastE0, atLeastE0 & ~atLeastF0,
+             atLeastF0 & ~atLeastF5, badSecondByte };
+}
+
+// Validates the sequences starting in the first BlockSize bytes, which may
+// extend up to three bytes past them, and sets in \a keep the offsets that
+// produce a UTF-16 code unit: the first byte of each sequence plus the second
+// byte of four-byte sequences, which holds the low surrogate. Returns the
+// number of bytes that those sequences span or 0 if the block needs to be
+// decoded by the scalar code.
+template <int BlockSize>
+static inline int utf8BlockLayout(const Utf8BlockMasks &m, quint64 &keep)
+{
+    constexpr quint64 blockMask = (Q_UINT64_C(1) << BlockSize) - 1;
+    const quint64 lead2 = m.lead2 & blockMask;
+    const quint64 lead3 = m.lead3 & blockMask;
+    const quint64 lead4 = m.lead4 & blockMask;
+    const quint64 required = (lead2 << 1)
+            | (lead3 << 1) | (lead3 << 2)
+            | (lead4 << 1) | (lead4 << 2) | (lead4 << 3);
+
+    // 0xc0, 0xc1 and 0xf5 to 0xff never appear in UTF-8
+    if (~(m.ascii | m.continuation | m.lead2 | m.lead3 | m.lead4) & blockMask)
+        return 0;
+
+    // continuation bytes must appear exactly where the sequences need them
+    if ((m.continuation & (blockMask | required)) != required)
+        return 0;
+
+    // the low surrogate of a four-byte sequence is stored from inside the block
+    if ((m.badSecondByte & blockMask) || (lead4 >> (BlockSize - 1)))
+        return 0;
+
+    keep = (m.ascii & blockMask) | lead2 | lead3 | lead4 | (lead4 << 1);
+    return BlockSize + qPopulationCount(required >> BlockSize);
+}
+
+// For each combination of eight 16-bit lanes to keep, the PSHUFB control that
+// moves them to the front.
+struct Utf16CompressTable
+{
+    uchar shuffle[256][16];
+    constexpr Utf16CompressTable() : shuffle{}
+    {
+        for (uint keep = 0; keep < 256; ++keep) {
+            uint n = 0;
+            for (uint lane = 0; lane < 8; ++lane) {
+                if (keep & (1U << lane)) {
+                    shuffle[keep][n++] = uchar(2 * lane);
+                    shuffle[keep][n++] = uchar(2 * lane + 1);
+                }
+            }
+            while (n < 16)
+                shuffle[keep][n++] = 0x80;
+        }
+    }
+};
+static constexpr Utf16CompressTable utf16CompressTable;
+
+// For each combination of the lengths of four UTF-8 sequences stored in
+// 32-bit lanes (two bits per lane, holding the length minus one), the PSHUFB
+// control that moves their bytes together.
+struct Utf8CompressTable
+{
+    uchar shuffle[256][16];
+    constexpr Utf8CompressTable() : shuffle{}
+    {
+        for (uint lengths = 0; lengths < 256; ++lengths) {
+            uint n = 0;
+            for (uint lane = 0; lane < 4; ++lane) {
+                const uint length = ((lengths >> (2 * lane)) & 3) + 1;
+                for (uint i = 0; i < length; ++i)
+                    shuffle[lengths][n++] = uchar(4 * lane + i);
+            }
+            while (n < 16)
+                shuffle[lengths][n++] = 0x80;
+        }
+    }
+};
+static constexpr Utf8CompressTable utf8CompressTable;
+
+// For each combination of eight 16-bit lanes holding a one-byte sequence,
+// the others holding two-byte ones, the PSHUFB control that moves the bytes
+// of the sequences together.
+struct Utf8TwoByteCompressTable
+{
+    uchar shuffle[256][16];
+    constexpr Utf8TwoByteCompressTable() : shuffle{}
+    {
+        for (uint ascii = 0; ascii < 256; ++ascii) {
+            uint n = 0;
+            for (uint lane = 0; lane < 8; ++lane) {
+                shuffle[ascii][n++] = uchar(2 * lane);
+                if (!(ascii & (1U << lane)))
+                    shuffle[ascii][n++] = uchar(2 * lane + 1);
+            }
+            while (n < 16)
+                shuffle[ascii][n++] = 0x80;
+        }
+    }
+};
+static constexpr Utf8TwoByteCompressTable utf8TwoByteCompressTable;
+
+// \a data holds the bytes with their top bit flipped, so that the signed
+// comparison orders them as unsigned
+static QT_FUNCTION_TARGET(AVX2)
+quint64 bytesAtLeastAvx2(__m256i data, uchar n)
+{
+    const __m256i bound = _mm256_set1_epi8(char((n ^ 0x80) - 1));
+    return uint(_mm256_movemask_epi8(_mm256_cmpgt_epi8(data, bound)));
+}
+
+static QT_FUNCTION_TARGET(AVX2)
+quint64 bytesEqualAvx2(__m256i data, uchar n)
+{
+    return uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(n ^ 0x80)))));
+}
+
+static QT_FUNCTION_TARGET(AVX2)
+Utf8BlockMasks classifyUtf8Avx2(__m256i data)
+{
+    const quint64 nonAscii = uint(_mm256_movemask_epi8(data));
+    data = _mm256_xor_si256(data, _mm256_set1_epi8(char(0x80)));
+    const quint64 atLeastC0 = bytesAtLeastAvx2(data, 0xc0);
+    const quint64 atLeastC2 = bytesAtLeastAvx2(data, 0xc2);
+    const quint64 atLeastE0 = bytesAtLeastAvx2(data, 0xe0);
+    if (!atLeastE0) {
+        // only two-byte sequences, which need no further checks
+        return utf8BlockMasks(nonAscii, 0, 0, atLeastC0, atLeastC2, 0, 0, 0, 0, 0, 0, 0);
+    }
+    return utf8BlockMasks(nonAscii,
+                          bytesAtLeastAvx2(data, 0x90), bytesAtLeastAvx2(data, 0xa0),
+                          atLeastC0, atLeastC2, atLeastE0,
+                          bytesAtLeastAvx2(data, 0xf0), bytesAtLeastAvx2(data, 0xf5),
+                          bytesEqualAvx2(data, 0xe0), bytesEqualAvx2(data, 0xed),
+                          bytesEqualAvx2(data, 0xf0), bytesEqualAvx2(data, 0xf4));
+}
+
+static QT_FUNCTION_TARGET(AVX2)
+__m256i loadBytesAvx2(const uchar *src)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+}
+
+// Decodes the sequences that may start at each of the 16 bytes at \a src,
+// returning one 16-bit lane per byte; reads 18 bytes. The lanes whose bit is
+// set in \a lowSurrogates get the second half of the surrogate pair started
+// in the previous lane. The result is only meaningful for the lanes that
+// start a valid sequence, which may only be one or two bytes long unless
+// \a AllLengths is true.
+template <bool AllLengths> static QT_FUNCTION_TARGET(AVX2)
+__m256i decodeUtf8Avx2(const uchar *src, uint lowSurrogates)
+{
+    const __m256i continuationBits = _mm256_set1_epi16(0x3f);
+    const __m256i b0 = loadBytesAvx2(src);
+    const __m256i c1 = _mm256_and_si256(loadBytesAvx2(src + 1), continuationBits);
+
+    // 110xxxxx 10xxxxxx
+    const __m256i cp2 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1f)), 6), c1);
+    __m256i result = _mm256_blendv_epi8(b0, cp2, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xbf)));
+    if constexpr (!AllLengths) {
+        Q_UNUSED(lowSurrogates);
+        return result;
+    }
+
+    const __m256i c2 = _mm256_and_si256(loadBytesAvx2(src + 2), continuationBits);
+    // 1110xxxx 10xxxxxx 10xxxxxx (the shift drops the 1110 bits)
+    const __m256i cp3 = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(b0, 12), _mm256_slli_epi16(c1, 6)), c2);
+    // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx: the high surrogate needs the top
+    // 11 bits of the code point minus 0x10000, while the low surrogate is
+    // produced by the next lane, which sees the last two bytes as c1 and c2
+    const __m256i highSurrogate = _mm256_add_epi16(_mm256_set1_epi16(short(0xd7c0)),
+            _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x07)), 8),
+                            _mm256_or_si256(_mm256_slli_epi16(c1, 2), _mm256_srli_epi16(c2, 4))));
+    const __m256i lowSurrogate = _mm256_or_si256(_mm256_set1_epi16(short(0xdc00)),
+            _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(c1, _mm256_set1_epi16(0x0f)), 6), c2));
+
+    const __m256i laneBits = _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+                                               0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000,
+                                               short(0x8000));
+    const __m256i isLowSurrogate =
+            _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16(short(lowSurrogates)), laneBits), laneBits);
+
+    result = _mm256_blendv_epi8(result, cp3, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xdf)));
+    result = _mm256_blendv_epi8(result, highSurrogate, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xef)));
+    return _mm256_blendv_epi8(result, lowSurrogate, isLowSurrogate);
+}
+
+// Stores the lanes of \a utf16 whose bit is set in \a keep. Always writes
+// eight code units.
+static QT_FUNCTION_TARGET(AVX2)
+void storeUtf16Avx2(ushort *&dst, __m128i utf16, uint keep)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16CompressTable.shuffle[keep]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(utf16, shuffle));
+    dst += qPopulationCount(keep);
+}
+
+// Decodes blocks of UTF-8 that may contain multibyte sequences, stopping at
+// one that needs the scalar decoder or near the end of the input, and sets
+// nextAscii to the end of the part that the scalar decoder should handle.
+// US-ASCII blocks are decoded too, so that text with a few non-ASCII
+// characters doesn't alternate between this and simdDecodeAscii.
+//
+// The output is written with up to 8 extra code units, which always fit in a
+// buffer large enough for the whole input.
+template <bool WriteOutput> static QT_FUNCTION_TARGET(AVX2)
+void simdDecodeUtf8Avx2(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    // the masks come from 32 bytes, the last three of which may only belong
+    // to sequences that start in the block
+    constexpr int BlockSize = 29;
+    // the vector stores may alias the pointers the arguments refer to
+    ushort *out = dst;
+    const uchar *in = src;
+
+    while (end - in >= 32 + 3) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        if (!_mm256_movemask_epi8(data)) {
+            if constexpr (WriteOutput) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out) + 1,
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)));
+                out += 32;
+            }
+            in += 32;
+            continue;
+        }
+
+        const Utf8BlockMasks masks = classifyUtf8Avx2(data);
+
+        quint64 keep;
+        const int length = utf8BlockLayout<BlockSize>(masks, keep);
+        if (!length)
+            break;
+
+        if constexpr (WriteOutput) {
+            const uint lowSurrogates = uint(masks.lead4 << 1);
+            __m256i utf16_1, utf16_2;
+            if (masks.lead3 | masks.lead4) {
+                utf16_1 = decodeUtf8Avx2<true>(in, lowSurrogates & 0xffff);
+                utf16_2 = decodeUtf8Avx2<true>(in + 16, lowSurrogates >> 16);
+            } else {
+                utf16_1 = decodeUtf8Avx2<false>(in, 0);
+                utf16_2 = decodeUtf8Avx2<false>(in + 16, 0);
+            }
+            storeUtf16Avx2(out, _mm256_castsi256_si128(utf16_1), uint(keep) & 0xff);
+            storeUtf16Avx2(out, _mm256_extracti128_si256(utf16_1, 1), uint(keep >> 8) & 0xff);
+            storeUtf16Avx2(out, _mm256_castsi256_si128(utf16_2), uint(keep >> 16) & 0xff);
+            storeUtf16Avx2(out, _mm256_extracti128_si256(utf16_2, 1), uint(keep >> 24) & 0xff);
+        }
+        in += length;
+    }
+    dst = out;
+    src = in;
+    nextAscii = end - in > 32 ? in + 32 : end;
+}
+
+// Encodes the 8 UTF-16 code units at \a src, none of which may be a
+// surrogate, to UTF-8, returning up to three bytes per 32-bit lane.
+static QT_FUNCTION_TARGET(AVX2)
+__m256i encodeUtf8Avx2(const ushort *src)
+{
+    const __m256i u = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    const __m256i continuationBits = _mm256_set1_epi32(0x3f);
+
+    // 110xxxxx 10xxxxxx
+    const __m256i utf8_2 = _mm256_or_si256(_mm256_set1_epi32(0x80c0),
+            _mm256_or_si256(_mm256_srli_epi32(u, 6), _mm256_slli_epi32(_mm256_and_si256(u, continuationBits), 8)));
+    // 1110xxxx 10xxxxxx 10xxxxxx
+    const __m256i utf8_3 = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0x8080e0), _mm256_srli_epi32(u, 12)),
+            _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(u, 6), continuationBits), 8),
+                            _mm256_slli_epi32(_mm256_and_si256(u, continuationBits), 16)));
+
+    const __m256i result = _mm256_blendv_epi8(u, utf8_2, _mm256_cmpgt_epi32(u, _mm256_set1_epi32(0x7f)));
+    return _mm256_blendv_epi8(result, utf8_3, _mm256_cmpgt_epi32(u, _mm256_set1_epi32(0x7ff)));
+}
+
+// Stores the sequences of the four 32-bit lanes of \a utf8, whose lengths
+// minus one are in \a lengths (two bits per lane). Always writes 16 bytes.
+static QT_FUNCTION_TARGET(AVX2)
+void storeUtf8Avx2(uchar *&dst, __m128i utf8, uint lengths)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8CompressTable.shuffle[lengths]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(utf8, shuffle));
+    dst += 4 + qPopulationCount(lengths & 0x55) + 2 * qPopulationCount(lengths & 0xaa);
+}
+
+// Stores the sequences of the eight 16-bit lanes of \a utf8, which hold one
+// byte for the lanes whose bit is set in \a ascii and two otherwise. Always
+// writes 16 bytes.
+static QT_FUNCTION_TARGET(AVX2)
+void storeUtf8TwoBytesAvx2(uchar *&dst, __m128i utf8, uint ascii)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8TwoByteCompressTable.shuffle[ascii]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(utf8, shuffle));
+    dst += 16 - qPopulationCount(ascii);
+}
+
+// Encodes blocks of 16 UTF-16 code units, with the same stopping rules as
+// simdDecodeUtf8Avx2; blocks containing surrogates are left to the scalar
+// code. Up to 16 bytes are written past the end of the output, which always
+// fit in a buffer large enough for the worst case of the whole input.
+static QT_FUNCTION_TARGET(AVX2)
+void simdEncodeUtf8Avx2(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+    constexpr int BlockSize = 16;
+    // the vector stores may alias the pointers the arguments refer to
+    uchar *out = dst;
+    const ushort *in = src;
+
+    // a block writes up to 52 bytes, which fit in the output for 18 code units
+    while (end - in >= BlockSize + 2) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        if (_mm256_testz_si256(data, _mm256_set1_epi16(short(0xff80)))) {
+            const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(data), _mm256_extracti128_si256(data, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), packed);
+            out += BlockSize;
+            in += BlockSize;
+            continue;
+        }
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i isAscii = _mm256_cmpeq_epi16(_mm256_and_si256(data, _mm256_set1_epi16(short(0xff80))), zero);
+        const __m256i threeByteBits = _mm256_and_si256(data, _mm256_set1_epi16(short(0xf800)));
+        // two bits per code unit
+        const uint upToTwoBytes = _mm256_movemask_epi8(_mm256_cmpeq_epi16(threeByteBits, zero));
+
+        if (upToTwoBytes == 0xffffffffU) {
+            // 110xxxxx 10xxxxxx, in 16-bit lanes
+            const __m256i utf8_2 = _mm256_or_si256(_mm256_set1_epi16(short(0x80c0)),
+                    _mm256_or_si256(_mm256_srli_epi16(data, 6),
+                                    _mm256_slli_epi16(_mm256_and_si256(data, _mm256_set1_epi16(0x3f)), 8)));
+            const __m256i utf8 = _mm256_blendv_epi8(utf8_2, data, isAscii);
+            // one bit per code unit: 0-7 and 16-23
+            const uint ascii = _mm256_movemask_epi8(_mm256_packs_epi16(isAscii, zero));
+            storeUtf8TwoBytesAvx2(out, _mm256_castsi256_si128(utf8), ascii & 0xff);
+            storeUtf8TwoBytesAvx2(out, _mm256_extracti128_si256(utf8, 1), (ascii >> 16) & 0xff);
+            in += BlockSize;
+            continue;
+        }
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(threeByteBits, _mm256_set1_epi16(short(0xd800)))))
+            break;
+
+        // lengths minus one, two bits per code unit
+        const uint multiByte = ~uint(_mm256_movemask_epi8(isAscii));
+        const uint lengths = (multiByte & 0x55555555U) + (~upToTwoBytes & 0x55555555U);
+        const __m256i utf8_1 = encodeUtf8Avx2(in);
+        const __m256i utf8_2 = encodeUtf8Avx2(in + 8);
+        storeUtf8Avx2(out, _mm256_castsi256_si128(utf8_1), lengths & 0xff);
+        storeUtf8Avx2(out, _mm256_extracti128_si256(utf8_1, 1), (lengths >> 8) & 0xff);
+        storeUtf8Avx2(out, _mm256_castsi256_si128(utf8_2), (lengths >> 16) & 0xff);
+        storeUtf8Avx2(out, _mm256_extracti128_si256(utf8_2, 1), lengths >> 24);
+        in += BlockSize;
+    }
+    dst = out;
+    src = in;
+    nextAscii = end - in > BlockSize ? in + BlockSize : end;
+}
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+QT_WARNING_PUSH
+// GCC 12's _mm512_undefined_epi32(), used by many intrinsics, is self-initialized
+QT_WARNING_DISABLE_GCC("-Wuninitialized")
+QT_WARNING_DISABLE_GCC("-Wmaybe-uninitialized")
+
+static QT_FUNCTION_TARGET(AVX512BW)
+quint64 bytesAtLeastAvx512(__m512i data, uchar n)
+{
+    return _mm512_cmpge_epu8_mask(data, _mm512_set1_epi8(char(n)));
+}
+
+static QT_FUNCTION_TARGET(AVX512BW)
+quint64 bytesEqualAvx512(__m512i data, uchar n)
+{
+    return _mm512_cmpeq_epi8_mask(data, _mm512_set1_epi8(char(n)));
+}
+
+static QT_FUNCTION_TARGET(AVX512BW)
+Utf8BlockMasks classifyUtf8Avx512(__m512i data)
+{
+    return utf8BlockMasks(_mm512_movepi8_mask(data),
+                          bytesAtLeastAvx512(data, 0x90), bytesAtLeastAvx512(data, 0xa0),
+                          bytesAtLeastAvx512(data, 0xc0), bytesAtLeastAvx512(data, 0xc2),
+                          bytesAtLeastAvx512(data, 0xe0), bytesAtLeastAvx512(data, 0xf0),
+                          bytesAtLeastAvx512(data, 0xf5),
+                          bytesEqualAvx512(data, 0xe0), bytesEqualAvx512(data, 0xed),
+                          bytesEqualAvx512(data, 0xf0), bytesEqualAvx512(data, 0xf4));
+}
+
+static QT_FUNCTION_TARGET(AVX512BW)
+__m512i loadBytesAvx512(const uchar *src)
+{
+    return _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+}
+
+// Same as decodeUtf8Avx2, for the 32 bytes at src + \a offset, with the
+// sequence classes taken from the block masks; reads 34 bytes.
+static QT_FUNCTION_TARGET(AVX512BW)
+__m512i decodeUtf8Avx512(const uchar *src, int offset, const Utf8BlockMasks &masks)
+{
+    const __m512i continuationBits = _mm512_set1_epi16(0x3f);
+    const __m512i b0 = loadBytesAvx512(src + offset);
+    const __m512i c1 = _mm512_and_si512(loadBytesAvx512(src + offset + 1), continuationBits);
+    const __m512i c2 = _mm512_and_si512(loadBytesAvx512(src + offset + 2), continuationBits);
+
+    const __m512i cp2 = _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(b0, _mm512_set1_epi16(0x1f)), 6), c1);
+    const __m512i cp3 = _mm512_or_si512(_mm512_or_si512(_mm512_slli_epi16(b0, 12), _mm512_slli_epi16(c1, 6)), c2);
+    const __m512i highSurrogate = _mm512_add_epi16(_mm512_set1_epi16(short(0xd7c0)),
+            _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(b0, _mm512_set1_epi16(0x07)), 8),
+                            _mm512_or_si512(_mm512_slli_epi16(c1, 2), _mm512_srli_epi16(c2, 4))));
+    const __m512i lowSurrogate = _mm512_or_si512(_mm512_set1_epi16(short(0xdc00)),
+            _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(c1, _mm512_set1_epi16(0x0f)), 6), c2));
+
+    const auto lanes = [offset](quint64 mask) { return __mmask32(mask >> offset); };
+    __m512i result = _mm512_mask_mov_epi16(b0, lanes(masks.lead2), cp2);
+    result = _mm512_mask_mov_epi16(result, lanes(masks.lead3), cp3);
+    result = _mm512_mask_mov_epi16(result, lanes(masks.lead4), highSurrogate);
+    return _mm512_mask_mov_epi16(result, lanes(masks.lead4 << 1), lowSurrogate);
+}
+
+// Stores the lanes of \a utf16 whose bit is set in \a keep. Always writes
+// 16 code units.
+static QT_FUNCTION_TARGET(AVX512BW)
+void storeUtf16Avx512(ushort *&dst, __m256i utf16, __mmask16 keep)
+{
+    const __m512i lanes = _mm512_maskz_compress_epi32(keep, _mm512_cvtepu16_epi32(utf16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm512_cvtepi32_epi16(lanes));
+    dst += qPopulationCount(keep);
+}
+
+// Same as simdDecodeUtf8Avx2, for blocks of 61 bytes. The output is written
+// with up to 16 extra code units.
+template <bool WriteOutput> static QT_FUNCTION_TARGET(AVX512BW)
+void simdDecodeUtf8Avx512(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    constexpr int BlockSize = 61;
+    // the vector stores may alias the pointers the arguments refer to
+    ushort *out = dst;
+    const uchar *in = src;
+
+    while (end - in >= 64 + 3) {
+        const __m512i data = _mm512_loadu_si512(in);
+        if (!_mm512_movepi8_mask(data)) {
+            if constexpr (WriteOutput) {
+                _mm512_storeu_si512(out, _mm512_cvtepu8_epi16(_mm512_castsi512_si256(data)));
+                _mm512_storeu_si512(out + 32, _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(data, 1)));
+                out += 64;
+            }
+            in += 64;
+            continue;
+        }
+
+        const Utf8BlockMasks masks = classifyUtf8Avx512(data);
+
+        quint64 keep;
+        const int length = utf8BlockLayout<BlockSize>(masks, keep);
+        if (!length)
+            break;
+
+        if constexpr (WriteOutput) {
+            const __m512i utf16_1 = decodeUtf8Avx512(in, 0, masks);
+            const __m512i utf16_2 = decodeUtf8Avx512(in, 32, masks);
+            storeUtf16Avx512(out, _mm512_castsi512_si256(utf16_1), __mmask16(keep));
+            storeUtf16Avx512(out, _mm512_extracti64x4_epi64(utf16_1, 1), __mmask16(keep >> 16));
+            storeUtf16Avx512(out, _mm512_castsi512_si256(utf16_2), __mmask16(keep >> 32));
+            storeUtf16Avx512(out, _mm512_extracti64x4_epi64(utf16_2, 1), __mmask16(keep >> 48));
+        }
+        in += length;
+    }
+    dst = out;
+    src = in;
+    nextAscii = end - in > 64 ? in + 64 : end;
+}
+QT_WARNING_POP
+#  endif // AVX512BW
+#endif // AVX2 && x86-64
+
+// Decodes UTF-8 with multibyte sequences in whole blocks while the input is
+// valid. On return, nextAscii indicates how far the scalar decoder should go
+// before trying the SIMD code again.
+template <bool WriteOutput = true>
+static inline void simdDecodeUtf8(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+#ifdef QT_UTF8_SIMD_MULTIBYTE
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (qCpuHasFeature(AVX512BW))
+        return simdDecodeUtf8Avx512<WriteOutput>(dst, nextAscii, src, end);
+#  endif
+    if (qCpuHasFeature(AVX2))
+        return simdDecodeUtf8Avx2<WriteOutput>(dst, nextAscii, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+static inline void simdEncodeUtf8(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+#ifdef QT_UTF8_SIMD_MULTIBYTE
+    if (qCpuHasFeature(AVX2))
+        return simdEncodeUtf8Avx2(dst, nextAscii, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -498,6 +1037,7 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        simdEncodeUtf8(dst, nextAscii, src, end);
 
         do {
             ushort u = *src++;
@@ -565,6 +1105,7 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         const ushort *nextAscii = end;
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
+        simdEncodeUtf8(cursor, nextAscii, src, end);
 
         do {
             ushort uc = *src++;
@@ -652,6 +1193,7 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            simdDecodeUtf8(dst, nextAscii, src, end);
 
             do {
                 uchar b = *src++;
@@ -754,8 +1296,11 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            simdDecodeUtf8(dst, nextAscii, src, end);
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -803,10 +1348,18 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
     bool isValidAscii = true;
 
     while (src < end) {
-        if (src >= nextAscii)
+        if (src >= nextAscii) {
             src = simdFindNonAscii(src, end, nextAscii);
-        if (src == end)
-            break;
+            if (src == end)
+                break;
+
+            if (*src & 0x80) {
+                // validate the multibyte sequences in whole blocks
+                isValidAscii = false;
+                ushort *noOutput = nullptr;
+                simdDecodeUtf8<false>(noOutput, nextAscii, src, end);
+            }
+        }
 
         do {
             uchar b = *src++;
@@ -0,0 +1,624 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qstringrope_p.h"
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QStringRope
+    \inmodule QtCore
+    \internal
+
+    \brief The QStringRope class is a string that can be edited in
+    logarithmic time.
+
+    See the comment in qstringrope_p.h for an overview.
+*/
+
+// Leaves have no children and a non-empty text; inner nodes have two
+// children and no text. An empty rope has no root.
+struct QStringRopeNode : QSharedData
+{
+    using Pointer = QExplicitlySharedDataPointer<const QStringRopeNode>;
+
+    Pointer left;
+    Pointer right;
+    QString text;
+    qsizetype length = 0;
+    int height = 0;
+
+    bool isLeaf() const noexcept { return !left; }
+};
+
+namespace {
+using Node = QStringRopeNode;
+using NodePointer = Node::Pointer;
+
+// Adjacent pieces shorter than this together are merged into one string, and
+// pieces this short are copied instead of sharing the string they are cut
+// from, so that a huge string is not kept alive by a few characters of it.
+constexpr qsizetype MergeLimit = 256;
+
+QString slice(const QString &s, qsizetype position, qsizetype n)
+{
+    if (position == 0 && n == s.size())
+        return s;
+    if (n <= MergeLimit)
+        return QString(s.constData() + position, n);
+    QString::DataPointer d = s.data_ptr();
+    d.ptr += position;
+    d.size = n;
+    return QString(std::move(d));
+}
+
+NodePointer makeLeaf(QString text)
+{
+    if (text.isEmpty())
+        return NodePointer();
+    auto node = new Node;
+    node->length = text.size();
+    node->text = std::move(text);
+    return NodePointer(node);
+}
+
+NodePointer makeNode(NodePointer left, NodePointer right)
+{
+    Q_ASSERT(left && right);
+    auto node = new Node;
+    node->length = left->length + right->length;
+    node->height = 1 + qMax(left->height, right->height);
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return NodePointer(node);
+}
+
+// Makes a node of two trees whose heights differ by at most two.
+NodePointer balance(NodePointer left, NodePointer right)
+{
+    if (right->height > left->height + 1) {
+        const Node *r = right.data();
+        if (r->left->height > r->right->height) {
+            const Node *rl = r->left.data();
+            return makeNode(makeNode(std::move(left), rl->left), makeNode(rl->right, r->right));
+        }
+        return makeNode(makeNode(std::move(left), r->left), r->right);
+    }
+    if (left->height > right->height + 1) {
+        const Node *l = left.data();
+        if (l->right->height > l->left->height) {
+            const Node *lr = l->right.data();
+            return makeNode(makeNode(l->left, lr->left), makeNode(lr->right, std::move(right)));
+        }
+        return makeNode(l->left, makeNode(l->right, std::move(right)));
+    }
+    return makeNode(std::move(left), std::move(right));
+}
+
+bool isShortLeaf(const Node *node) noexcept
+{
+    return node->isLeaf() && node->length < MergeLimit;
+}
+
+// Concatenates two trees. The taller one is descended until the heights
+// match, and a short leaf is descended all the way to be merged with the
+// leaf it ends up next to.
+NodePointer join(NodePointer left, NodePointer right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+    if (left->isLeaf() && right->isLeaf()) {
+        if (left->length + right->length <= MergeLimit)
+            return makeLeaf(left->text + right->text);
+        return makeNode(std::move(left), std::move(right));
+    }
+    if (left->height > right->height + 1 || (!left->isLeaf() && isShortLeaf(right.data()))) {
+        const Node *l = left.data();
+        return balance(l->left, join(l->right, std::move(right)));
+    }
+    if (right->height > left->height + 1 || (!right->isLeaf() && isShortLeaf(left.data()))) {
+        const Node *r = right.data();
+        return balance(join(std::move(left), r->left), r->right);
+    }
+    return makeNode(std::move(left), std::move(right));
+}
+
+std::pair<NodePointer, NodePointer> split(const NodePointer &node, qsizetype position)
+{
+    if (!node || position <= 0)
+        return { NodePointer(), node };
+    if (position >= node->length)
+        return { node, NodePointer() };
+    if (node->isLeaf()) {
+        const QString &text = node->text;
+        return { makeLeaf(slice(text, 0, position)),
+                 makeLeaf(slice(text, position, text.size() - position)) };
+    }
+    const qsizetype leftLength = node->left->length;
+    if (position < leftLength) {
+        auto parts = split(node->left, position);
+        return { std::move(parts.first), join(std::move(parts.second), node->right) };
+    }
+    if (position > leftLength) {
+        auto parts = split(node->right, position - leftLength);
+        return { join(node->left, std::move(parts.first)), std::move(parts.second) };
+    }
+    return { node->left, node->right };
+}
+} // unnamed namespace
+
+QStringRope::QStringRope() noexcept = default;
+
+QStringRope::QStringRope(const QString &text)
+    : root(makeLeaf(text))
+{
+}
+
+QStringRope::QStringRope(QStringView text)
+    : root(makeLeaf(text.toString()))
+{
+}
+
+QStringRope::QStringRope(NodePointer node) noexcept
+    : root(std::move(node))
+{
+}
+
+QStringRope::QStringRope(const QStringRope &other) noexcept = default;
+QStringRope::QStringRope(QStringRope &&other) noexcept = default;
+QStringRope &QStringRope::operator=(const QStringRope &other) noexcept = default;
+QStringRope::~QStringRope() = default;
+
+qsizetype QStringRope::size() const noexcept
+{
+    return root ? root->length : 0;
+}
+
+void QStringRope::clear() noexcept
+{
+    root.reset();
+}
+
+/*!
+    Returns the character at index position \a i, which must be a valid index
+    position in the rope. This is O(log n).
+*/
+QChar QStringRope::at(qsizetype i) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    const Node *node = root.data();
+    while (!node->isLeaf()) {
+        const qsizetype leftLength = node->left->length;
+        if (i < leftLength) {
+            node = node->left.data();
+        } else {
+            i -= leftLength;
+            node = node->right.data();
+        }
+    }
+    return node->text.at(i);
+}
+
+/*!
+    Returns the \a n characters starting at \a position, or all the characters
+    from \a position on if \a n is negative, sharing the pieces with this rope.
+*/
+QStringRope QStringRope::mid(qsizetype position, qsizetype n) const
+{
+    const qsizetype length = size();
+    if (position < 0) {
+        if (n >= 0)
+            n += position;
+        position = 0;
+    }
+    if (position >= length || n == 0)
+        return QStringRope();
+    if (n < 0 || n > length - position)
+        n = length - position;
+    const NodePointer tail = split(root, position).second;
+    return QStringRope(split(tail, n).first);
+}
+
+/*!
+    Inserts \a text at \a position, which must be between 0 and size(). The
+    string is shared, not copied.
+*/
+QStringRope &QStringRope::insert(qsizetype position, const QString &text)
+{
+    return insert(position, QStringRope(text));
+}
+
+QStringRope &QStringRope::insert(qsizetype position, QStringView text)
+{
+    return insert(position, QStringRope(text));
+}
+
+QStringRope &QStringRope::insert(qsizetype position, const QStringRope &text)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    if (text.isEmpty())
+        return *this;
+    auto parts = split(root, position);
+    root = join(join(std::move(parts.first), text.root), std::move(parts.second));
+    return *this;
+}
+
+/*!
+    Removes \a n characters starting at \a position. Characters past the end
+    of the rope are ignored.
+*/
+QStringRope &QStringRope::remove(qsizetype position, qsizetype n)
+{
+    if (position < 0 || n <= 0 || position >= size())
+        return *this;
+    auto head = split(root, position);
+    root = join(std::move(head.first), split(head.second, n).second);
+    return *this;
+}
+
+QStringRope &QStringRope::replace(qsizetype position, qsizetype n, const QString &after)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    auto head = split(root, position);
+    auto tail = split(head.second, n).second;
+    root = join(join(std::move(head.first), makeLeaf(after)), std::move(tail));
+    return *this;
+}
+
+QStringRope &QStringRope::replace(qsizetype position, qsizetype n, QStringView after)
+{
+    return replace(position, n, after.toString());
+}
+
+void QStringRope::truncate(qsizetype position)
+{
+    if (position < size())
+        root = split(root, qMax(position, qsizetype(0))).first;
+}
+
+void QStringRope::copyTo(QChar *out, qsizetype position, qsizetype n) const
+{
+    const ChunkRange range = chunks();
+    for (auto it = range.begin(position); n > 0; ++it) {
+        Q_ASSERT(it != range.end());
+        const qsizetype skip = position - it.position();
+        const qsizetype count = qMin(it->size() - skip, n);
+        memcpy(out, it->data() + skip, count * sizeof(QChar));
+        out += count;
+        position += count;
+        n -= count;
+    }
+}
+
+/*!
+    Returns the text of the rope as a QString. If the rope consists of a
+    single piece, the string it was made from is shared; otherwise the pieces
+    are copied.
+*/
+QString QStringRope::toString() const
+{
+    if (!root)
+        return QString();
+    if (root->isLeaf())
+        return root->text;
+    QString result(root->length, Qt::Uninitialized);
+    copyTo(result.data(), 0, root->length);
+    return result;
+}
+
+/*!
+    Returns the index position of the first occurrence of \a needle at or
+    after \a from, or -1 if there is none. Occurrences spanning pieces are
+    found by searching the last characters of each piece together with the
+    first characters of the next one.
+*/
+qsizetype QStringRope::indexOf(QStringView needle, qsizetype from, Qt::CaseSensitivity cs) const
+{
+    const qsizetype length = size();
+    if (from < 0)
+        from = qMax(from + length, qsizetype(0));
+    if (needle.isEmpty())
+        return from <= length ? from : -1;
+    if (from >= length)
+        return -1;
+
+    const qsizetype overlap = needle.size() - 1;
+    QString carry;  // the last overlap characters of the text searched so far
+    const ChunkRange range = chunks();
+    for (auto it = range.begin(from); it != range.end(); ++it) {
+        QStringView chunk = *it;
+        qsizetype chunkPosition = it.position();
+        if (chunkPosition < from) {
+            chunk = chunk.sliced(from - chunkPosition);
+            chunkPosition = from;
+        }
+        if (!carry.isEmpty()) {
+            const QString seam = carry + chunk.left(overlap);
+            const qsizetype i = QStringView(seam).indexOf(needle, 0, cs);
+            if (i != -1)
+                return chunkPosition - carry.size() + i;
+        }
+        const qsizetype i = chunk.indexOf(needle, 0, cs);
+        if (i != -1)
+            return chunkPosition + i;
+        if (chunk.size() >= overlap)
+            carry = chunk.right(overlap).toString();
+        else if (overlap)
+            carry = QString(carry + chunk).right(overlap);
+    }
+    return -1;
+}
+
+QStringRope::Tokenizer QStringRope::tokenize(QStringView separator, Qt::SplitBehavior behavior,
+                                             Qt::CaseSensitivity cs) const
+{
+    return Tokenizer(this, separator, behavior, cs);
+}
+
+QStringRope::Tokenizer QStringRope::tokenize(QChar separator, Qt::SplitBehavior behavior,
+                                             Qt::CaseSensitivity cs) const
+{
+    return Tokenizer(this, separator, behavior, cs);
+}
+
+bool operator==(const QStringRope &lhs, const QStringRope &rhs) noexcept
+{
+    if (lhs.root == rhs.root)
+        return true;
+    if (lhs.size() != rhs.size())
+        return false;
+    if (rhs.root->isLeaf())
+        return lhs == QStringView(rhs.root->text);
+
+    const QStringRope::ChunkRange range = rhs.chunks();
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        qsizetype position = it.position();
+        QStringView chunk = *it;
+        const QStringRope::ChunkRange lhsRange = lhs.chunks();
+        for (auto lit = lhsRange.begin(position); !chunk.isEmpty(); ++lit) {
+            const qsizetype skip = position - lit.position();
+            const qsizetype n = qMin(lit->size() - skip, chunk.size());
+            if (lit->sliced(skip, n) != chunk.first(n))
+                return false;
+            chunk = chunk.sliced(n);
+            position += n;
+        }
+    }
+    return true;
+}
+
+bool operator==(const QStringRope &lhs, QStringView rhs) noexcept
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    const QStringRope::ChunkRange range = lhs.chunks();
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        if (*it != rhs.sliced(it.position(), it->size()))
+            return false;
+    }
+    return true;
+}
+
+/*!
+    \class QStringRope::ChunkIterator
+    \inmodule QtCore
+    \internal
+
+    Iterates over the pieces of a rope in order, keeping the right subtrees
+    that are still to be visited on a stack.
+*/
+
+QStringRope::ChunkIterator::ChunkIterator(const QStringRopeNode *root, qsizetype position)
+{
+    if (root && position < root->length)
+        descend(root, qMax(position, qsizetype(0)));
+}
+
+// Walks down from node to the leaf containing position, which is relative to
+// node; chunkPosition must be the position of node in the rope.
+void QStringRope::ChunkIterator::descend(const QStringRopeNode *node, qsizetype position)
+{
+    while (!node->isLeaf()) {
+        const qsizetype leftLength = node->left->length;
+        if (position < leftLength) {
+            pending.append(node->right.data());
+            node = node->left.data();
+        } else {
+            position -= leftLength;
+            chunkPosition += leftLength;
+            node = node->right.data();
+        }
+    }
+    chunk = node->text;
+}
+
+QStringRope::ChunkIterator &QStringRope::ChunkIterator::operator++()
+{
+    Q_ASSERT(!chunk.isNull());
+    chunkPosition += chunk.size();
+    if (pending.isEmpty()) {
+        chunk = QStringView();
+        chunkPosition = 0;
+    } else {
+        const QStringRopeNode *node = pending.last();
+        pending.removeLast();
+        descend(node, 0);
+    }
+    return *this;
+}
+
+/*!
+    \class QStringRope::TokenIterator
+    \inmodule QtCore
+    \internal
+
+    Yields the same tokens as QStringTokenizer would for the text of the rope.
+    Tokens within a piece are views of it, others are copied to a buffer.
+*/
+
+QStringRope::TokenIterator::TokenIterator(const Tokenizer *t)
+    : tokenizer(t)
+{
+    advance();
+}
+
+void QStringRope::TokenIterator::advance()
+{
+    Q_ASSERT(tokenizer);
+    const QStringRope *rope = tokenizer->rope;
+    const QStringView needle = tokenizer->needle();
+    while (true) {
+        if (end < 0) {
+            *this = TokenIterator();
+            return;
+        }
+        end = rope->indexOf(needle, start + extra, tokenizer->cs);
+        const qsizetype tokenStart = start;
+        const qsizetype tokenEnd = end >= 0 ? end : rope->size();
+        if (end >= 0) {
+            start = end + needle.size();
+            extra = needle.isEmpty() ? 1 : 0;
+        }
+        if ((tokenizer->behavior & Qt::SkipEmptyParts) && tokenStart == tokenEnd)
+            continue;
+
+        tokenPosition = tokenStart;
+        const qsizetype n = tokenEnd - tokenStart;
+        const ChunkIterator it(rope->root.data(), tokenStart);
+        if (n == 0) {
+            token = QStringView(u"", 0);
+        } else if (tokenEnd <= it.position() + it->size()) {
+            token = it->sliced(tokenStart - it.position(), n);
+        } else {
+            buffer.resize(n);
+            rope->copyTo(buffer.data(), tokenStart, n);
+            token = buffer;
+        }
+        return;
+    }
+}
+
+#if QT_CONFIG(regularexpression)
+/*!
+    \class QStringRope::MatchIterator
+    \inmodule QtCore
+    \internal
+
+    Finds the successive matches of a regular expression in a rope.
+
+    The search for the next match starts with a window reaching from
+    ContextSize characters before the search position to the end of the piece
+    containing it, or a few kilobytes further for short pieces. If the window
+    ends before the rope does, the window is matched with
+    PartialPreferFirstMatch; a partial match means the match may continue past
+    the window, so the window is doubled and the search repeated. Without any
+    match, the search moves on to the end of the window.
+
+    After an empty match the search continues one character further, which
+    gives the same results as QRegularExpressionMatchIterator for all but
+    patterns that can match both an empty and a non-empty string at the same
+    position.
+*/
+
+QStringRope::MatchIterator QStringRope::globalMatch(const QRegularExpression &re,
+                                                    qsizetype from) const
+{
+    return MatchIterator(this, re, from);
+}
+
+QStringRope::MatchIterator::MatchIterator(const QStringRope *r, const QRegularExpression &e,
+                                          qsizetype from)
+    : rope(r), re(e), position(from < 0 ? qMax(from + r->size(), qsizetype(0)) : from)
+{
+    findNext();
+}
+
+QStringRope::Match QStringRope::MatchIterator::next()
+{
+    Q_ASSERT(hasNext());
+    Match match = nextMatch;
+    findNext();
+    return match;
+}
+
+void QStringRope::MatchIterator::findNext()
+{
+    constexpr qsizetype MinimumWindow = 4096;
+    const qsizetype length = rope->size();
+
+    nextMatch = Match();
+    while (position <= length) {
+        const qsizetype windowStart = qMax(position - ContextSize, qsizetype(0));
+        qsizetype windowEnd = length;
+        if (position < length) {
+            const ChunkIterator it(rope->root.data(), position);
+            windowEnd = qMin(qMax(it.position() + it->size(), position + MinimumWindow), length);
+        }
+
+        QRegularExpressionMatch match;
+        while (true) {
+            const QString subject = rope->mid(windowStart, windowEnd - windowStart).toString();
+            const auto type = windowEnd == length ? QRegularExpression::NormalMatch
+                                                  : QRegularExpression::PartialPreferFirstMatch;
+            match = re.match(subject, position - windowStart, type);
+            if (!match.hasPartialMatch())
+                break;
+            windowEnd = qMin(windowEnd + (windowEnd - windowStart), length);
+        }
+
+        if (match.hasMatch()) {
+            nextMatch.match = match;
+            nextMatch.offset = windowStart;
+            const qsizetype matchEnd = windowStart + match.capturedEnd();
+            position = match.capturedLength() ? matchEnd : matchEnd + 1;
+            return;
+        }
+        if (!match.isValid() || windowEnd == length)
+            break;
+        position = windowEnd;
+    }
+    position = length + 1;
+}
+#endif // QT_CONFIG(regularexpression)
+
+QT_END_NAMESPACE
@@ -0,0 +1,373 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGROPE_P_H
+#define QSTRINGROPE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+#if QT_CONFIG(regularexpression)
+#include <QtCore/qregularexpression.h>
+#endif
+
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+/*
+  QStringRope is a string for large texts that are edited in place, such as
+  the buffers of log viewers and code editors.
+
+  The text is kept in a balanced binary tree whose leaves are pieces of
+  QStrings. Pieces share the data of the strings they were made from, so
+  inserting a QString does not copy it and cutting a piece in two is O(1);
+  only short pieces are merged into new strings, to keep character-by-
+  character editing from fragmenting the tree. Nodes are immutable and
+  shared, which makes copies O(1) and lets insert(), remove() and mid() run
+  in O(log n) regardless of the size of the text.
+
+  The text is not contiguous. It can be read piecewise with chunks(), which
+  yields QStringViews, and converted to a QString with toString(). The
+  tokenize() and globalMatch() functions search across chunk boundaries.
+
+  Chunk and token iterators refer to the tree of the rope they were created
+  from and are invalidated by modifying that rope.
+*/
+
+struct QStringRopeNode;
+
+class Q_CORE_EXPORT QStringRope
+{
+    using NodePointer = QExplicitlySharedDataPointer<const QStringRopeNode>;
+
+public:
+    class ChunkIterator;
+    class ChunkRange;
+    class TokenIterator;
+    class Tokenizer;
+#if QT_CONFIG(regularexpression)
+    class Match;
+    class MatchIterator;
+#endif
+
+    QStringRope() noexcept;
+    explicit QStringRope(const QString &text);
+    explicit QStringRope(QStringView text);
+    QStringRope(const QStringRope &other) noexcept;
+    QStringRope(QStringRope &&other) noexcept;
+    QStringRope &operator=(const QStringRope &other) noexcept;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QStringRope)
+    ~QStringRope();
+
+    void swap(QStringRope &other) noexcept { root.swap(other.root); }
+
+    qsizetype size() const noexcept;
+    qsizetype length() const noexcept { return size(); }
+    bool isEmpty() const noexcept { return !root; }
+
+    QChar at(qsizetype i) const;
+    QChar operator[](qsizetype i) const { return at(i); }
+
+    QStringRope mid(qsizetype position, qsizetype n = -1) const;
+    QStringRope first(qsizetype n) const { return mid(0, n); }
+    QStringRope last(qsizetype n) const { return mid(size() - n); }
+
+    QStringRope &insert(qsizetype position, const QString &text);
+    QStringRope &insert(qsizetype position, QStringView text);
+    QStringRope &insert(qsizetype position, const QStringRope &text);
+    QStringRope &append(const QString &text) { return insert(size(), text); }
+    QStringRope &append(QStringView text) { return insert(size(), text); }
+    QStringRope &append(const QStringRope &text) { return insert(size(), text); }
+    QStringRope &prepend(const QString &text) { return insert(0, text); }
+    QStringRope &prepend(QStringView text) { return insert(0, text); }
+    QStringRope &prepend(const QStringRope &text) { return insert(0, text); }
+    QStringRope &remove(qsizetype position, qsizetype n);
+    QStringRope &replace(qsizetype position, qsizetype n, const QString &after);
+    QStringRope &replace(qsizetype position, qsizetype n, QStringView after);
+    void truncate(qsizetype position);
+    void clear() noexcept;
+
+    QString toString() const;
+
+    qsizetype indexOf(QStringView needle, qsizetype from = 0,
+                      Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+    qsizetype indexOf(QChar ch, qsizetype from = 0, Qt::CaseSensitivity cs = Qt::CaseSensitive) const
+    { return indexOf(QStringView(&ch, 1), from, cs); }
+    bool contains(QStringView needle, Qt::CaseSensitivity cs = Qt::CaseSensitive) const
+    { return indexOf(needle, 0, cs) != -1; }
+
+    ChunkRange chunks() const noexcept;
+    Tokenizer tokenize(QStringView separator, Qt::SplitBehavior behavior = Qt::KeepEmptyParts,
+                       Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+    Tokenizer tokenize(QChar separator, Qt::SplitBehavior behavior = Qt::KeepEmptyParts,
+                       Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+#if QT_CONFIG(regularexpression)
+    MatchIterator globalMatch(const QRegularExpression &re, qsizetype from = 0) const;
+#endif
+
+    friend Q_CORE_EXPORT bool operator==(const QStringRope &lhs, const QStringRope &rhs) noexcept;
+    friend bool operator!=(const QStringRope &lhs, const QStringRope &rhs) noexcept
+    { return !(lhs == rhs); }
+    friend Q_CORE_EXPORT bool operator==(const QStringRope &lhs, QStringView rhs) noexcept;
+    friend bool operator!=(const QStringRope &lhs, QStringView rhs) noexcept
+    { return !(lhs == rhs); }
+    friend bool operator==(QStringView lhs, const QStringRope &rhs) noexcept { return rhs == lhs; }
+    friend bool operator!=(QStringView lhs, const QStringRope &rhs) noexcept { return !(rhs == lhs); }
+
+private:
+    explicit QStringRope(NodePointer node) noexcept;
+    void copyTo(QChar *out, qsizetype position, qsizetype n) const;
+
+    NodePointer root;
+};
+
+Q_DECLARE_SHARED(QStringRope)
+
+class Q_CORE_EXPORT QStringRope::ChunkIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = qptrdiff;
+    using value_type = QStringView;
+    using pointer = const QStringView *;
+    using reference = const QStringView &;
+
+    ChunkIterator() noexcept = default;
+
+    reference operator*() const noexcept { return chunk; }
+    pointer operator->() const noexcept { return &chunk; }
+    // offset of the current chunk in the rope
+    qsizetype position() const noexcept { return chunkPosition; }
+
+    ChunkIterator &operator++();
+    ChunkIterator operator++(int) { ChunkIterator it = *this; ++*this; return it; }
+
+    friend bool operator==(const ChunkIterator &lhs, const ChunkIterator &rhs) noexcept
+    { return lhs.chunk.data() == rhs.chunk.data() && lhs.chunk.size() == rhs.chunk.size(); }
+    friend bool operator!=(const ChunkIterator &lhs, const ChunkIterator &rhs) noexcept
+    { return !(lhs == rhs); }
+
+private:
+    friend class QStringRope;
+    ChunkIterator(const QStringRopeNode *root, qsizetype position);
+    void descend(const QStringRopeNode *node, qsizetype offset);
+
+    // the right subtrees still to visit, innermost last
+    QVarLengthArray<const QStringRopeNode *, 48> pending;
+    QStringView chunk;
+    qsizetype chunkPosition = 0;
+};
+
+class QStringRope::ChunkRange
+{
+public:
+    ChunkIterator begin() const { return ChunkIterator(root, 0); }
+    ChunkIterator end() const noexcept { return ChunkIterator(); }
+    // the chunks from the one containing \a position on
+    ChunkIterator begin(qsizetype position) const { return ChunkIterator(root, position); }
+
+private:
+    friend class QStringRope;
+    explicit ChunkRange(const QStringRopeNode *node) noexcept : root(node) {}
+
+    const QStringRopeNode *root;
+};
+
+inline QStringRope::ChunkRange QStringRope::chunks() const noexcept
+{
+    return ChunkRange(root.data());
+}
+
+// Same as the iterators of QStringTokenizer. Tokens that span chunks are
+// copied into a buffer owned by the iterator, so the views are only valid
+// until the iterator is advanced.
+class Q_CORE_EXPORT QStringRope::TokenIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = qptrdiff;
+    using value_type = QStringView;
+    using pointer = const QStringView *;
+    using reference = const QStringView &;
+
+    TokenIterator() noexcept = default;
+
+    reference operator*() const noexcept { return token; }
+    pointer operator->() const noexcept { return &token; }
+    // offset of the current token in the rope
+    qsizetype position() const noexcept { return tokenPosition; }
+
+    TokenIterator &operator++() { advance(); return *this; }
+
+    friend bool operator==(const TokenIterator &lhs, const TokenIterator &rhs) noexcept
+    {
+        return lhs.tokenizer == rhs.tokenizer && lhs.start == rhs.start
+                && lhs.end == rhs.end && lhs.extra == rhs.extra;
+    }
+    friend bool operator!=(const TokenIterator &lhs, const TokenIterator &rhs) noexcept
+    { return !(lhs == rhs); }
+
+private:
+    friend class Tokenizer;
+    TokenIterator(const Tokenizer *tokenizer);
+    void advance();
+
+    // null at the end
+    const Tokenizer *tokenizer = nullptr;
+    QStringView token;
+    qsizetype tokenPosition = 0;
+    // as in QStringTokenizerBase::tokenizer_state
+    qsizetype start = 0;
+    qsizetype end = 0;
+    qsizetype extra = 0;
+    QString buffer;
+};
+
+class QStringRope::Tokenizer
+{
+public:
+    using iterator = TokenIterator;
+    using const_iterator = TokenIterator;
+    using value_type = QStringView;
+
+    TokenIterator begin() const { return TokenIterator(this); }
+    TokenIterator end() const noexcept { return TokenIterator(); }
+    TokenIterator cbegin() const { return begin(); }
+    TokenIterator cend() const noexcept { return end(); }
+
+    template <typename Container>
+    Container toContainer(Container &&c = {}) const
+    {
+        for (QStringView token : *this)
+            c.emplace_back(token.toString());
+        return std::forward<Container>(c);
+    }
+
+private:
+    friend class QStringRope;
+    friend class TokenIterator;
+    Tokenizer(const QStringRope *r, QStringView s, Qt::SplitBehavior b, Qt::CaseSensitivity c) noexcept
+        : rope(r), separator(s), behavior(b), cs(c)
+    {}
+    Tokenizer(const QStringRope *r, QChar s, Qt::SplitBehavior b, Qt::CaseSensitivity c) noexcept
+        : rope(r), behavior(b), cs(c), separatorChar(s), useSeparatorChar(true)
+    {}
+
+    QStringView needle() const noexcept
+    { return useSeparatorChar ? QStringView(&separatorChar, 1) : separator; }
+
+    const QStringRope *rope;
+    QStringView separator;
+    Qt::SplitBehavior behavior;
+    Qt::CaseSensitivity cs;
+    QChar separatorChar;
+    bool useSeparatorChar = false;
+};
+
+#if QT_CONFIG(regularexpression)
+// A match of QStringRope::globalMatch(). The offsets are relative to the rope.
+class Q_CORE_EXPORT QStringRope::Match
+{
+public:
+    bool hasMatch() const { return match.hasMatch(); }
+    int lastCapturedIndex() const { return match.lastCapturedIndex(); }
+
+    QString captured(int nth = 0) const { return match.captured(nth); }
+    QString captured(const QString &name) const { return match.captured(name); }
+    QStringList capturedTexts() const { return match.capturedTexts(); }
+
+    qsizetype capturedStart(int nth = 0) const { return toRope(match.capturedStart(nth)); }
+    qsizetype capturedLength(int nth = 0) const { return match.capturedLength(nth); }
+    qsizetype capturedEnd(int nth = 0) const { return toRope(match.capturedEnd(nth)); }
+    qsizetype capturedStart(const QString &name) const { return toRope(match.capturedStart(name)); }
+    qsizetype capturedEnd(const QString &name) const { return toRope(match.capturedEnd(name)); }
+
+    // the match in the text that was searched, which starts at subjectOffset()
+    QRegularExpressionMatch regularExpressionMatch() const { return match; }
+    qsizetype subjectOffset() const { return offset; }
+
+private:
+    friend class MatchIterator;
+    qsizetype toRope(qsizetype pos) const { return pos < 0 ? -1 : pos + offset; }
+
+    QRegularExpressionMatch match;
+    qsizetype offset = 0;
+};
+
+// Same as QRegularExpressionMatchIterator. The text is searched one chunk at
+// a time, extending the searched window with partial matching when a match
+// may continue into the next chunk. Lookbehind assertions see at most
+// ContextSize characters before the start of the window.
+class Q_CORE_EXPORT QStringRope::MatchIterator
+{
+public:
+    static constexpr qsizetype ContextSize = 256;
+
+    bool hasNext() const { return nextMatch.hasMatch(); }
+    Match next();
+    Match peekNext() const { return nextMatch; }
+
+private:
+    friend class QStringRope;
+    MatchIterator(const QStringRope *rope, const QRegularExpression &re, qsizetype from);
+    void findNext();
+
+    const QStringRope *rope;
+    QRegularExpression re;
+    qsizetype position;         // where the next match may start
+    Match nextMatch;
+};
+#endif // QT_CONFIG(regularexpression)
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGROPE_P_H
@@ -41,6 +41,7 @@
 
 #include <QtCore/qstringalgorithms.h>
 #include <QtCore/qarraydata.h> // for QContainerImplHelper
+#include <QtCore/qbytearrayview.h>
 
 #include <string>
 
@@ -306,6 +307,8 @@ public:
     //
     [[nodiscard]] constexpr bool isNull() const noexcept { return !m_data; }
     [[nodiscard]] constexpr bool isEmpty() const noexcept { return empty(); }
+    [[nodiscard]] bool isValidUtf8() const noexcept
+    { return QByteArrayView(reinterpret_cast<const char *>(data()), size()).isValidUtf8(); }
 #if QT_DEPRECATED_SINCE(6, 0)
     [[nodiscard]]
     Q_DECL_DEPRECATED_X("Use size() and port callers to qsizetype.")
@@ -43,6 +43,7 @@
 #include "qcoreapplication.h"
 
 #include <algorithm>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
@@ -57,9 +58,20 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    QRunnable *takeLocalTask();
+    QRunnable *takeNextTask();
+    void flushLocalTasks();
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // work-stealing mode: runnables started from this thread while the pool
+    // was saturated, all of them with localPriority. Only ever locked after
+    // manager->mutex, never before it.
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
+    int localPriority = 0;
 };
 
 /*
@@ -88,27 +100,32 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // keep draining our own queue without taking the pool's mutex
+                    r = manager->workStealing ? takeLocalTask() : nullptr;
+                } while (r);
                 locker.relock();
             }
 
@@ -116,25 +133,25 @@ void QThreadPoolThread::run()
             if (manager->tooManyThreadsActive())
                 break;
 
-            if (manager->queue.isEmpty()) {
-                r = nullptr;
-                break;
-            }
-
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
-        } while (true);
+            r = manager->workStealing ? takeNextTask() : manager->dequeueTask();
+        } while (r);
 
         // if too many threads are active, expire this thread
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareThreads();
+
+            // Only look at the other threads' queues after having published
+            // that we are idle, see QThreadPoolPrivate::enqueueLocalTask().
+            if (manager->workStealing && (runnable = manager->stealTasks(this))) {
+                manager->waitingThreads.removeOne(this);
+                ++manager->activeThreads;
+                manager->updateSpareThreads();
+                continue;
+            }
+
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
             ++manager->activeThreads;
@@ -146,8 +163,11 @@ void QThreadPoolThread::run()
             }
         }
         if (expired) {
+            if (manager->workStealing)
+                flushLocalTasks();
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareThreads();
             break;
         }
     }
@@ -159,11 +179,61 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+
+    Returns the most recently queued runnable of this thread's own queue,
+    unless the pool's queue has something with a higher priority. Called
+    without holding the pool's mutex.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty() || manager->queuedPriority.loadRelaxed() > localPriority)
+        return nullptr;
+    return localQueue.takeLast();
+}
+
+/*
+    \internal
+
+    Returns the next runnable to run, from either this thread's own queue
+    or the pool's one, whichever has the higher priority. Called with the
+    pool's mutex held.
+*/
+QRunnable *QThreadPoolThread::takeNextTask()
+{
+    QMutexLocker locker(&localMutex);
+    if (!localQueue.isEmpty()
+        && (manager->queue.isEmpty() || manager->queue.first()->priority() <= localPriority)) {
+        return localQueue.takeLast();
+    }
+    locker.unlock();
+    return manager->dequeueTask();
+}
+
+/*
+    \internal
+
+    Moves this thread's own queue to the pool's one before the thread
+    expires. Called with the pool's mutex held.
+*/
+void QThreadPoolThread::flushLocalTasks()
+{
+    QMutexLocker locker(&localMutex);
+    for (QRunnable *r : qAsConst(localQueue))
+        manager->enqueueTask(r, localPriority);
+    localQueue.clear();
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
+    : workStealing(qEnvironmentVariableIntValue("QT_THREADPOOL_WORK_STEALING")),
+      spareThreads(maxThreadCount),
+      queuedPriority(std::numeric_limits<int>::min())
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -172,6 +242,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     if (allThreads.isEmpty()) {
         // always create at least one thread
         startThread(task);
+        updateSpareThreads();
         return true;
     }
 
@@ -183,6 +254,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         // recycle an available thread
         enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateSpareThreads();
         return true;
     }
 
@@ -195,11 +267,13 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
         thread->runnable = task;
         thread->start();
+        updateSpareThreads();
         return true;
     }
 
     // start a new thread
     startThread(task);
+    updateSpareThreads();
     return true;
 }
 
@@ -219,6 +293,24 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     }
     auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    updateQueuedPriority();
+}
+
+QRunnable *QThreadPoolPrivate::dequeueTask()
+{
+    if (queue.isEmpty())
+        return nullptr;
+
+    QueuePage *page = queue.first();
+    QRunnable *runnable = page->pop();
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+        updateQueuedPriority();
+    }
+
+    return runnable;
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -242,8 +334,104 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
         if (page->isFinished()) {
             queue.removeFirst();
             delete page;
+            updateQueuedPriority();
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Puts \a runnable on the calling pool thread's own queue if the pool is
+    saturated, so that neither queuing nor later dequeuing it needs the
+    pool's mutex. Returns \c false if the calling thread does not belong to
+    this pool, or if \a runnable should go through tryStart() instead.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *runnable, int priority)
+{
+    auto *self = qobject_cast<QThreadPoolThread *>(QThread::currentThread());
+    if (!self || self->manager != this || spareThreads.loadRelaxed() > 0)
+        return false;
+
+    {
+        QMutexLocker locker(&self->localMutex);
+        if (!self->localQueue.isEmpty() && self->localPriority != priority)
+            return false;
+        self->localQueue.append(runnable);
+        self->localPriority = priority;
+    }
+
+    // A thread that went idle after the check above updates spareThreads
+    // before locking every local queue in stealTasks(), so it has either
+    // seen our runnable or we now see it as spare and hand the runnable over.
+    if (spareThreads.loadRelaxed() > 0) {
+        QMutexLocker locker(&mutex);
+        QMutexLocker localLocker(&self->localMutex);
+        if (self->localQueue.isEmpty() || self->localQueue.constLast() != runnable)
+            return true; // stolen in the meantime
+        self->localQueue.removeLast();
+        localLocker.unlock();
+
+        if (!tryStart(runnable)) {
+            localLocker.relock();
+            self->localQueue.append(runnable);
+            self->localPriority = priority;
         }
     }
+    return true;
+}
+
+/*!
+    \internal
+
+    Takes the older half of the longest local queue of the other threads,
+    returning the first runnable and moving the rest to \a thief's queue.
+    Called with the mutex held.
+*/
+QRunnable *QThreadPoolPrivate::stealTasks(QThreadPoolThread *thief)
+{
+    QThreadPoolThread *victim = nullptr;
+    qsizetype victimQueueSize = 0;
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        if (thread == thief)
+            continue;
+        QMutexLocker locker(&thread->localMutex);
+        if (thread->localQueue.size() > victimQueueSize) {
+            victim = thread;
+            victimQueueSize = thread->localQueue.size();
+        }
+    }
+
+    if (!victim)
+        return nullptr;
+
+    QMutexLocker victimLocker(&victim->localMutex);
+    if (victim->localQueue.isEmpty())
+        return nullptr;
+
+    QRunnable *runnable = victim->localQueue.takeFirst();
+    qsizetype count = victim->localQueue.size() / 2;
+
+    // only one thread steals at a time, so holding both locks is fine
+    QMutexLocker thiefLocker(&thief->localMutex);
+    if (count && thief->localQueue.isEmpty()) {
+        thief->localPriority = victim->localPriority;
+        while (count--)
+            thief->localQueue.append(victim->localQueue.takeFirst());
+    }
+
+    return runnable;
+}
+
+void QThreadPoolPrivate::updateSpareThreads()
+{
+    spareThreads.storeRelaxed(qMax(0, maxThreadCount - activeThreadCount()));
+}
+
+void QThreadPoolPrivate::updateQueuedPriority()
+{
+    queuedPriority.storeRelaxed(queue.isEmpty() ? std::numeric_limits<int>::min()
+                                                : queue.constFirst()->priority());
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -280,6 +468,7 @@ void QThreadPoolPrivate::reset()
     allThreadsCopy.swap(allThreads);
     expiredThreads.clear();
     waitingThreads.clear();
+    updateSpareThreads();
     mutex.unlock();
 
     for (QThreadPoolThread *thread : qAsConst(allThreadsCopy)) {
@@ -336,6 +525,20 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+    updateQueuedPriority();
+
+    if (workStealing) {
+        QList<QRunnable *> localTasks;
+        for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            localTasks += std::exchange(thread->localQueue, {});
+        }
+        locker.unlock();
+        for (QRunnable *r : qAsConst(localTasks)) {
+            if (r->autoDelete())
+                delete r;
+        }
+    }
 }
 
 /*!
@@ -368,11 +571,20 @@ bool QThreadPool::tryTake(QRunnable *runnable)
             if (page->isFinished()) {
                 d->queue.removeOne(page);
                 delete page;
+                d->updateQueuedPriority();
             }
             return true;
         }
     }
 
+    if (d->workStealing) {
+        for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            if (thread->localQueue.removeOne(runnable))
+                return true;
+        }
+    }
+
     return false;
 }
 
@@ -500,13 +712,18 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->workStealing && d->enqueueLocalTask(runnable, priority))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
-        if (!d->waitingThreads.isEmpty())
+        if (!d->waitingThreads.isEmpty()) {
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->updateSpareThreads();
+        }
     }
 }
 
@@ -636,6 +853,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
 
     d->maxThreadCount = maxThreadCount;
     d->tryToStartMoreThreads();
+    d->updateSpareThreads();
 }
 
 /*! \property QThreadPool::activeThreadCount
@@ -672,6 +890,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSpareThreads();
 }
 
 /*! \property QThreadPool::stackSize
@@ -716,6 +935,7 @@ void QThreadPool::releaseThread()
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
     d->tryToStartMoreThreads();
+    d->updateSpareThreads();
 }
 
 /*!
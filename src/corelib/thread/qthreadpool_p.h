@@ -52,6 +52,7 @@
 //
 //
 
+#include "QtCore/qatomic.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qthread.h"
 #include "QtCore/qwaitcondition.h"
@@ -153,6 +154,7 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    QRunnable *dequeueTask();
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -166,6 +168,11 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    bool enqueueLocalTask(QRunnable *task, int priority);
+    QRunnable *stealTasks(QThreadPoolThread *thief);
+    void updateSpareThreads();
+    void updateQueuedPriority();
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -178,6 +185,15 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+
+    // Work-stealing mode, enabled with QT_THREADPOOL_WORK_STEALING=1: tasks
+    // started from a pool thread while the pool is saturated go to that
+    // thread's own queue, which idle threads steal from. Both atomics are
+    // only written with the mutex held and let pool threads keep working
+    // on their own queue without taking it.
+    const bool workStealing;
+    QAtomicInt spareThreads;    // maxThreadCount - activeThreadCount(), if positive
+    QAtomicInt queuedPriority;  // priority of the first queued task, or INT_MIN
 };
 
 QT_END_NAMESPACE
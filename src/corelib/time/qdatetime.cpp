@@ -2433,6 +2433,11 @@ int QDateTimeParser::startsWithLocalTimeZone(QStringView name)
 // If the date falls outside the 1970 to 2037 range supported by mktime / time_t
 // then null date/time will be returned, you should adjust the date first if
 // you need a guaranteed result.
+#if QT_CONFIG(timezone) && defined(Q_OS_UNIX) && !defined(Q_OS_DARWIN) \
+    && (!defined(Q_OS_ANDROID) || defined(Q_OS_ANDROID_EMBEDDED))
+#  define QT_LOCAL_TIME_FROM_TZ_DATA
+#endif
+
 static qint64 qt_mktime(QDate *date, QTime *time, QDateTimePrivate::DaylightStatus *daylightStatus,
                         QString *abbreviation, bool *ok = nullptr)
 {
@@ -2456,6 +2461,9 @@ static qint64 qt_mktime(QDate *date, QTime *time, QDateTimePrivate::DaylightStat
 #endif // Q_OS_WIN
     time_t secsSinceEpoch = qMkTime(&local);
     if (secsSinceEpoch != time_t(-1)) {
+#if defined(QT_LOCAL_TIME_FROM_TZ_DATA) && defined(__GLIBC__)
+        QTzTimeZonePrivate::noteMkTimeOffset(int(local.tm_gmtoff));
+#endif
         *date = QDate(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
         *time = QTime(local.tm_hour, local.tm_min, local.tm_sec, msec);
 #if defined(Q_OS_WIN)
@@ -2594,6 +2602,46 @@ static qint64 timeToMSecs(QDate date, QTime time)
            + time.msecsSinceStartOfDay();
 }
 
+// Same as qt_localtime(), using the transition table of the local time zone
+// when that settles the answer, which is a lot cheaper
+static bool localTimeFromZoneData(qint64 msecsSinceEpoch, QDate *localDate, QTime *localTime,
+                                  QDateTimePrivate::DaylightStatus *daylightStatus)
+{
+#ifdef QT_LOCAL_TIME_FROM_TZ_DATA
+    int offset;
+    bool isDst;
+    if (QTzTimeZonePrivate::localTimeOffset(msecsSinceEpoch, &offset, &isDst)) {
+        msecsToTime(msecsSinceEpoch + offset * 1000, localDate, localTime);
+        if (daylightStatus)
+            *daylightStatus = isDst ? QDateTimePrivate::DaylightTime : QDateTimePrivate::StandardTime;
+        return true;
+    }
+#endif
+    return qt_localtime(msecsSinceEpoch, localDate, localTime, daylightStatus);
+}
+
+// Same as qt_mktime() for a valid date and time, using the transition table of
+// the local time zone when that settles the answer
+static qint64 mktimeFromZoneData(QDate *date, QTime *time,
+                                 QDateTimePrivate::DaylightStatus *daylightStatus,
+                                 QString *abbreviation)
+{
+#ifdef QT_LOCAL_TIME_FROM_TZ_DATA
+    // the abbreviation comes from libc's tzname[], so needs libc anyway
+    if (!abbreviation) {
+        qint64 utcMSecs;
+        bool isDst;
+        const int dstHint = daylightStatus ? int(*daylightStatus) : -1;
+        if (QTzTimeZonePrivate::localTimeToUtc(timeToMSecs(*date, *time), dstHint, &utcMSecs, &isDst)) {
+            if (daylightStatus)
+                *daylightStatus = isDst ? QDateTimePrivate::DaylightTime : QDateTimePrivate::StandardTime;
+            return utcMSecs;
+        }
+    }
+#endif
+    return qt_mktime(date, time, daylightStatus, abbreviation);
+}
+
 // Convert an MSecs Since Epoch into Local Time
 static bool epochMSecsToLocalTime(qint64 msecs, QDate *localDate, QTime *localTime,
                                   QDateTimePrivate::DaylightStatus *daylightStatus = nullptr)
@@ -2627,7 +2675,7 @@ static bool epochMSecsToLocalTime(qint64 msecs, QDate *localDate, QTime *localTi
         return res;
     } else {
         // Falls inside time_t suported range so can use localtime
-        return qt_localtime(msecs, localDate, localTime, daylightStatus);
+        return localTimeFromZoneData(msecs, localDate, localTime, daylightStatus);
     }
 }
 
@@ -2720,7 +2768,7 @@ static qint64 localMSecsToEpochMSecs(qint64 localMsecs,
     } else {
 
         // Clearly falls inside 1970-2037 suported range so can use mktime
-        qint64 utcMsecs = qt_mktime(&dt, &tm, daylightStatus, abbreviation);
+        qint64 utcMsecs = mktimeFromZoneData(&dt, &tm, daylightStatus, abbreviation);
         if (localDate)
             *localDate = dt;
         if (localTime)
@@ -4010,6 +4058,12 @@ QString QDateTime::toString(Qt::DateFormat format) const
 
     switch (format) {
     case Qt::RFC2822Date:
+        buf.resize(QDateTimeFixedFormat::Rfc2822MaxLength);
+        if (qsizetype length = QDateTimeFixedFormat::formatRfc2822(
+                *this, reinterpret_cast<char16_t *>(buf.data()), buf.size())) {
+            buf.truncate(length);
+            return buf;
+        }
         buf = QLocale::c().toString(*this, u"dd MMM yyyy hh:mm:ss ");
         buf += toOffsetString(Qt::TextDate, offsetFromUtc());
         return buf;
@@ -4038,6 +4092,12 @@ QString QDateTime::toString(Qt::DateFormat format) const
     }
     case Qt::ISODate:
     case Qt::ISODateWithMs: {
+        buf.resize(QDateTimeFixedFormat::IsoMaxLength);
+        if (qsizetype length = QDateTimeFixedFormat::formatIso(
+                *this, reinterpret_cast<char16_t *>(buf.data()), buf.size(), format)) {
+            buf.truncate(length);
+            return buf;
+        }
         const QPair<QDate, QTime> p = getDateTime(d);
         buf = toStringIsoDate(p.first);
         if (buf.isEmpty())
@@ -4799,8 +4859,11 @@ QDateTime QDateTime::fromString(QStringView string, Qt::DateFormat format)
     if (string.isEmpty())
         return QDateTime();
 
+    QDateTimeFixedFormat::Parsed parsed;
     switch (format) {
     case Qt::RFC2822Date: {
+        if (QDateTimeFixedFormat::parseRfc2822(string, &parsed))
+            return QDateTimeFixedFormat::toDateTime(parsed);
         const ParsedRfcDateTime rfc = rfcDateImpl(string);
 
         if (!rfc.date.isValid() || !rfc.time.isValid())
@@ -4812,6 +4875,8 @@ QDateTime QDateTime::fromString(QStringView string, Qt::DateFormat format)
     }
     case Qt::ISODate:
     case Qt::ISODateWithMs: {
+        if (QDateTimeFixedFormat::parseIso(string, &parsed))
+            return QDateTimeFixedFormat::toDateTime(parsed);
         const int size = string.size();
         if (size < 10)
             return QDateTime();
@@ -5035,6 +5100,467 @@ QDateTime QDateTime::fromString(const QString &string, QStringView format, QCale
     return QDateTime();
 }
 
+/*****************************************************************************
+  QDateTimeFixedFormat member functions
+ *****************************************************************************/
+
+/*!
+    \internal
+    \class QDateTimeFixedFormat
+    \inmodule QtCore
+
+    \brief Parses and formats the fixed Qt::ISODate and Qt::RFC2822Date shapes
+    without allocating.
+
+    The parse functions only accept the common, canonical spellings of each
+    format: "yyyy-MM-dd[Thh:mm[:ss[.fff]][Z|±hh[[:]mm]]]" for ISO 8601 and
+    "[ddd, ]d MMM yyyy hh:mm[:ss][ ±hh[mm]]" for RFC 2822. They return false
+    for anything else, including strings the generic QDateTime::fromString()
+    would reject, so that callers can fall back to it; whenever they return
+    true, the result matches what QDateTime::fromString() would produce.
+
+    The format functions write into a caller-supplied buffer, which needs
+    IsoMaxLength or Rfc2822MaxLength characters, and return the number of
+    characters written, or 0 if the date-time is invalid or not representable
+    by the fixed format (for example, years outside the range 0 to 9999).
+*/
+
+namespace {
+
+template <typename Char>
+class FixedFormatText
+{
+public:
+    FixedFormatText(const Char *data, qsizetype size) : m_data(data), m_size(size) {}
+
+    qsizetype size() const { return m_size; }
+    char16_t at(qsizetype i) const
+    { return i < m_size ? char16_t(std::make_unsigned_t<Char>(m_data[i])) : u'\0'; }
+    bool isDigit(qsizetype i) const { return at(i) >= u'0' && at(i) <= u'9'; }
+
+    // Reads exactly count ASCII digits at pos, or returns -1
+    int digits(qsizetype pos, int count) const
+    {
+        int value = 0;
+        for (qsizetype i = pos; i < pos + count; ++i) {
+            if (!isDigit(i))
+                return -1;
+            value = value * 10 + (at(i) - u'0');
+        }
+        return value;
+    }
+
+private:
+    const Char *m_data;
+    qsizetype m_size;
+};
+
+template <typename Char>
+bool parseFixedOffset(const FixedFormatText<Char> &text, qsizetype pos, bool allowColon,
+                      int *offset)
+{
+    const char16_t sign = text.at(pos);
+    if (sign != u'+' && sign != u'-')
+        return false;
+    const qsizetype length = text.size() - pos - 1;
+    int hour = text.digits(pos + 1, 2);
+    int minute = 0;
+    if (length == 4)
+        minute = text.digits(pos + 3, 2);
+    else if (length == 5 && allowColon && text.at(pos + 3) == u':')
+        minute = text.digits(pos + 4, 2);
+    else if (length != 2)
+        return false;
+    if (hour < 0 || minute < 0 || minute > 59)
+        return false;
+    *offset = (hour * 60 + minute) * 60 * (sign == u'-' ? -1 : 1);
+    return true;
+}
+
+template <typename Char>
+bool parseFixedIso(const FixedFormatText<Char> &text, QDateTimeFixedFormat::Parsed *result)
+{
+    const qsizetype size = text.size();
+    if (size < 10 || text.at(4) != u'-' || text.at(7) != u'-')
+        return false;
+    const int year = text.digits(0, 4);
+    const int month = text.digits(5, 2);
+    const int day = text.digits(8, 2);
+    if (year <= 0 || month < 0 || day < 0)
+        return false;
+    result->date = QDate(year, month, day);
+    if (!result->date.isValid())
+        return false;
+    result->spec = Qt::LocalTime;
+    result->offsetFromUtc = 0;
+    result->dateOnly = size == 10;
+    if (result->dateOnly)
+        return true;
+
+    const char16_t separator = text.at(10);
+    if ((separator != u'T' && separator != u't' && separator != u' ') || text.at(13) != u':')
+        return false;
+    const int hour = text.digits(11, 2);
+    const int minute = text.digits(14, 2);
+    int second = 0;
+    int msec = 0;
+    qsizetype pos = 16;
+    if (text.at(pos) == u':') {
+        second = text.digits(pos + 1, 2);
+        pos += 3;
+        if (text.at(pos) == u'.' || text.at(pos) == u',') {
+            const qsizetype start = ++pos;
+            while (text.isDigit(pos))
+                ++pos;
+            const qsizetype count = pos - start;
+            // Nine digits keep the rounding below exact; leave longer ones to the generic parser
+            if (count == 0 || count > 9)
+                return false;
+            int scale = 100;
+            for (qsizetype i = start; i < start + qMin(count, qsizetype(3)); ++i, scale /= 10)
+                msec += (text.at(i) - u'0') * scale;
+            if (count > 3) {
+                // Round to nearest; exact ties are left to the generic parser's rounding
+                const int rest = text.digits(start + 3, int(count - 3));
+                int half = 5;
+                for (qsizetype i = 4; i < count; ++i)
+                    half *= 10;
+                if (rest == half)
+                    return false;
+                if (rest > half && ++msec == 1000)
+                    return false;
+            }
+        }
+    }
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59)
+        return false;
+    result->time = QTime(hour, minute, second, msec);
+
+    if (pos == size)
+        return true;
+    const char16_t zone = text.at(pos);
+    if (zone == u'Z' || zone == u'z') {
+        result->spec = Qt::UTC;
+        return pos + 1 == size;
+    }
+    result->spec = Qt::OffsetFromUTC;
+    return parseFixedOffset(text, pos, true, &result->offsetFromUtc);
+}
+
+template <typename Char>
+bool parseFixedRfc2822(const FixedFormatText<Char> &text, QDateTimeFixedFormat::Parsed *result)
+{
+    const auto matchName = [&text](qsizetype pos, const char *name) {
+        return text.at(pos) == char16_t(name[0]) && text.at(pos + 1) == char16_t(name[1])
+            && text.at(pos + 2) == char16_t(name[2]);
+    };
+
+    qsizetype pos = 0;
+    int dayOfWeek = 0;
+    if (text.at(3) == u',' && text.at(4) == u' ') {
+        static const char dayNames[][4] = { "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+        for (int i = 0; i < 7 && !dayOfWeek; ++i) {
+            if (matchName(0, dayNames[i]))
+                dayOfWeek = i + 1;
+        }
+        if (!dayOfWeek)
+            return false;
+        pos = 5;
+    }
+
+    const int dayLength = text.isDigit(pos + 1) ? 2 : 1;
+    const int day = text.digits(pos, dayLength);
+    pos += dayLength;
+    if (day < 0 || text.at(pos) != u' ' || text.at(pos + 4) != u' ')
+        return false;
+    int month = 0;
+    for (int i = 0; i < 12 && !month; ++i) {
+        if (matchName(pos + 1, qt_shortMonthNames[i]))
+            month = i + 1;
+    }
+    const int year = text.digits(pos + 5, 4);
+    pos += 9;
+    if (!month || year < 0 || text.at(pos) != u' ' || text.at(pos + 3) != u':')
+        return false;
+
+    const int hour = text.digits(pos + 1, 2);
+    const int minute = text.digits(pos + 4, 2);
+    int second = 0;
+    pos += 6;
+    if (text.at(pos) == u':') {
+        second = text.digits(pos + 1, 2);
+        pos += 3;
+    }
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59)
+        return false;
+
+    result->date = QDate(year, month, day);
+    if (!result->date.isValid() || (dayOfWeek && result->date.dayOfWeek() != dayOfWeek))
+        return false;
+    result->time = QTime(hour, minute, second);
+    result->spec = Qt::OffsetFromUTC;
+    result->offsetFromUtc = 0;
+    result->dateOnly = false;
+    if (pos == text.size())
+        return true;
+    return text.at(pos) == u' ' && parseFixedOffset(text, pos + 1, false, &result->offsetFromUtc);
+}
+
+template <typename Char>
+class FixedFormatWriter
+{
+public:
+    explicit FixedFormatWriter(Char *out) : m_out(out), m_begin(out) {}
+
+    void put(char c) { *m_out++ = Char(c); }
+    void put(const char *text, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            put(text[i]);
+    }
+    void putDigits(int value, int count)
+    {
+        for (int i = count - 1; i >= 0; --i, value /= 10)
+            m_out[i] = Char('0' + value % 10);
+        m_out += count;
+    }
+    void putOffset(int offset, bool colon)
+    {
+        put(offset < 0 ? '-' : '+');
+        offset = qAbs(offset) / 60;
+        putDigits(offset / 60, 2);
+        if (colon)
+            put(':');
+        putDigits(offset % 60, 2);
+    }
+    qsizetype size() const { return m_out - m_begin; }
+
+private:
+    Char *m_out;
+    Char *m_begin;
+};
+
+} // unnamed namespace
+
+static qsizetype formatFixed(const QDateTime &dateTime, const QDateTimeData &d, Qt::DateFormat format,
+                             char16_t *wide, char *narrow, qsizetype size)
+{
+    const bool isIso = format != Qt::RFC2822Date;
+    if (size < (isIso ? QDateTimeFixedFormat::IsoMaxLength : QDateTimeFixedFormat::Rfc2822MaxLength)
+        || !dateTime.isValid()) {
+        return 0;
+    }
+    const QPair<QDate, QTime> p = getDateTime(d);
+    const auto parts = QGregorianCalendar::partsFromJulian(p.first.toJulianDay());
+    if (!parts.isValid() || parts.year < 0 || parts.year > 9999)
+        return 0;
+
+    const Qt::TimeSpec spec = getSpec(d);
+    const int offset = spec == Qt::LocalTime || spec == Qt::UTC ? 0 : dateTime.offsetFromUtc();
+    if (qAbs(offset) >= 100 * SECS_PER_HOUR)
+        return 0;
+    const int rfcOffset = isIso ? 0 : dateTime.offsetFromUtc();
+    if (qAbs(rfcOffset) >= 100 * SECS_PER_HOUR)
+        return 0;
+
+    const auto write = [&](auto &out) {
+        const QTime time = p.second;
+        if (isIso) {
+            out.putDigits(parts.year, 4);
+            out.put('-');
+            out.putDigits(parts.month, 2);
+            out.put('-');
+            out.putDigits(parts.day, 2);
+            out.put('T');
+        } else {
+            out.putDigits(parts.day, 2);
+            out.put(' ');
+            out.put(qt_shortMonthNames[parts.month - 1], 3);
+            out.put(' ');
+            out.putDigits(parts.year, 4);
+            out.put(' ');
+        }
+        out.putDigits(time.hour(), 2);
+        out.put(':');
+        out.putDigits(time.minute(), 2);
+        out.put(':');
+        out.putDigits(time.second(), 2);
+        if (!isIso) {
+            out.put(' ');
+            out.putOffset(rfcOffset, false);
+            return out.size();
+        }
+        if (format == Qt::ISODateWithMs) {
+            out.put('.');
+            out.putDigits(time.msec(), 3);
+        }
+        if (spec == Qt::UTC)
+            out.put('Z');
+        else if (spec != Qt::LocalTime)
+            out.putOffset(offset, true);
+        return out.size();
+    };
+    if (wide) {
+        FixedFormatWriter<char16_t> out(wide);
+        return write(out);
+    }
+    FixedFormatWriter<char> out(narrow);
+    return write(out);
+}
+
+/*!
+    \internal
+
+    Parses \a text as a canonical Qt::ISODate date-time into \a result.
+    Returns false if \a text is not in the fixed shape; QDateTime::fromString()
+    may still accept it.
+*/
+bool QDateTimeFixedFormat::parseIso(QStringView text, Parsed *result) noexcept
+{
+    return parseFixedIso(FixedFormatText<char16_t>(text.utf16(), text.size()), result);
+}
+
+/*!
+    \internal
+    \overload
+*/
+bool QDateTimeFixedFormat::parseIso(QLatin1String text, Parsed *result) noexcept
+{
+    return parseFixedIso(FixedFormatText<char>(text.data(), text.size()), result);
+}
+
+/*!
+    \internal
+    \overload
+*/
+bool QDateTimeFixedFormat::parseIso(QUtf8StringView text, Parsed *result) noexcept
+{
+    // Only ASCII is accepted, so UTF-8 can be read byte by byte
+    const char *data = reinterpret_cast<const char *>(text.data());
+    return parseFixedIso(FixedFormatText<char>(data, text.size()), result);
+}
+
+/*!
+    \internal
+
+    Parses \a text as a canonical Qt::RFC2822Date date-time into \a result.
+    Returns false if \a text is not in the fixed shape; QDateTime::fromString()
+    may still accept it.
+*/
+bool QDateTimeFixedFormat::parseRfc2822(QStringView text, Parsed *result) noexcept
+{
+    return parseFixedRfc2822(FixedFormatText<char16_t>(text.utf16(), text.size()), result);
+}
+
+/*!
+    \internal
+    \overload
+*/
+bool QDateTimeFixedFormat::parseRfc2822(QLatin1String text, Parsed *result) noexcept
+{
+    return parseFixedRfc2822(FixedFormatText<char>(text.data(), text.size()), result);
+}
+
+/*!
+    \internal
+    \overload
+*/
+bool QDateTimeFixedFormat::parseRfc2822(QUtf8StringView text, Parsed *result) noexcept
+{
+    const char *data = reinterpret_cast<const char *>(text.data());
+    return parseFixedRfc2822(FixedFormatText<char>(data, text.size()), result);
+}
+
+/*!
+    \internal
+
+    Returns the QDateTime described by \a parsed.
+*/
+QDateTime QDateTimeFixedFormat::toDateTime(const Parsed &parsed)
+{
+    if (parsed.dateOnly)
+        return parsed.date.startOfDay();
+    return QDateTime(parsed.date, parsed.time, parsed.spec, parsed.offsetFromUtc);
+}
+
+/*!
+    \internal
+
+    Returns the date-time in \a text, as QDateTime::fromString() would for
+    \a format, trying the fixed parsers first.
+*/
+QDateTime QDateTimeFixedFormat::fromString(QLatin1String text, Qt::DateFormat format)
+{
+    Parsed parsed;
+    if (format == Qt::RFC2822Date ? parseRfc2822(text, &parsed)
+        : (format == Qt::ISODate || format == Qt::ISODateWithMs) && parseIso(text, &parsed)) {
+        return toDateTime(parsed);
+    }
+    return QDateTime::fromString(QString(text), format);
+}
+
+/*!
+    \internal
+    \overload
+*/
+QDateTime QDateTimeFixedFormat::fromString(QUtf8StringView text, Qt::DateFormat format)
+{
+    Parsed parsed;
+    if (format == Qt::RFC2822Date ? parseRfc2822(text, &parsed)
+        : (format == Qt::ISODate || format == Qt::ISODateWithMs) && parseIso(text, &parsed)) {
+        return toDateTime(parsed);
+    }
+    return QDateTime::fromString(text.toString(), format);
+}
+
+/*!
+    \internal
+
+    Writes \a dateTime in \a format, Qt::ISODate or Qt::ISODateWithMs, to
+    \a buffer, which has room for \a size characters. Returns the number of
+    characters written, or 0 on failure.
+*/
+qsizetype QDateTimeFixedFormat::formatIso(const QDateTime &dateTime, char16_t *buffer,
+                                          qsizetype size, Qt::DateFormat format)
+{
+    Q_ASSERT(format == Qt::ISODate || format == Qt::ISODateWithMs);
+    return formatFixed(dateTime, dateTime.d, format, buffer, nullptr, size);
+}
+
+/*!
+    \internal
+    \overload
+*/
+qsizetype QDateTimeFixedFormat::formatIso(const QDateTime &dateTime, char *buffer,
+                                          qsizetype size, Qt::DateFormat format)
+{
+    Q_ASSERT(format == Qt::ISODate || format == Qt::ISODateWithMs);
+    return formatFixed(dateTime, dateTime.d, format, nullptr, buffer, size);
+}
+
+/*!
+    \internal
+
+    Writes \a dateTime in Qt::RFC2822Date format to \a buffer, which has room
+    for \a size characters. Returns the number of characters written, or 0 on
+    failure.
+*/
+qsizetype QDateTimeFixedFormat::formatRfc2822(const QDateTime &dateTime, char16_t *buffer,
+                                              qsizetype size)
+{
+    return formatFixed(dateTime, dateTime.d, Qt::RFC2822Date, buffer, nullptr, size);
+}
+
+/*!
+    \internal
+    \overload
+*/
+qsizetype QDateTimeFixedFormat::formatRfc2822(const QDateTime &dateTime, char *buffer,
+                                              qsizetype size)
+{
+    return formatFixed(dateTime, dateTime.d, Qt::RFC2822Date, nullptr, buffer, size);
+}
+
 #endif // datestring
 /*!
     \fn QDateTime QDateTime::toLocalTime() const
@@ -386,6 +386,7 @@ private:
     bool equals(const QDateTime &other) const;
     bool precedes(const QDateTime &other) const;
     friend class QDateTimePrivate;
+    friend class QDateTimeFixedFormat;
 
     Data d;
 
@@ -132,6 +132,44 @@ public:
 #endif // timezone
 };
 
+#if QT_CONFIG(datestring)
+class Q_CORE_EXPORT QDateTimeFixedFormat
+{
+public:
+    enum : qsizetype {
+        IsoMaxLength = 29,      // yyyy-MM-ddThh:mm:ss.zzz+hh:mm
+        Rfc2822MaxLength = 26   // dd MMM yyyy hh:mm:ss +hhmm
+    };
+
+    struct Parsed
+    {
+        QDate date;
+        QTime time;
+        Qt::TimeSpec spec = Qt::LocalTime;
+        int offsetFromUtc = 0;
+        bool dateOnly = false;
+    };
+
+    static bool parseIso(QStringView text, Parsed *result) noexcept;
+    static bool parseIso(QLatin1String text, Parsed *result) noexcept;
+    static bool parseIso(QUtf8StringView text, Parsed *result) noexcept;
+    static bool parseRfc2822(QStringView text, Parsed *result) noexcept;
+    static bool parseRfc2822(QLatin1String text, Parsed *result) noexcept;
+    static bool parseRfc2822(QUtf8StringView text, Parsed *result) noexcept;
+    static QDateTime toDateTime(const Parsed &parsed);
+
+    static QDateTime fromString(QLatin1String text, Qt::DateFormat format);
+    static QDateTime fromString(QUtf8StringView text, Qt::DateFormat format);
+
+    static qsizetype formatIso(const QDateTime &dateTime, char16_t *buffer, qsizetype size,
+                               Qt::DateFormat format = Qt::ISODate);
+    static qsizetype formatIso(const QDateTime &dateTime, char *buffer, qsizetype size,
+                               Qt::DateFormat format = Qt::ISODate);
+    static qsizetype formatRfc2822(const QDateTime &dateTime, char16_t *buffer, qsizetype size);
+    static qsizetype formatRfc2822(const QDateTime &dateTime, char *buffer, qsizetype size);
+};
+#endif // datestring
+
 QT_END_NAMESPACE
 
 #endif // QDATETIME_P_H
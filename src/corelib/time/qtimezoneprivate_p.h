@@ -291,13 +291,23 @@ constexpr inline bool operator!=(const QTzTransitionRule &lhs, const QTzTransiti
 { return !operator==(lhs, rhs); }
 
 // These are stored separately from QTzTimeZonePrivate so that they can be
-// cached, avoiding the need to re-parse them from disk constantly.
+// cached, avoiding the need to re-parse them from disk constantly. The lists
+// are shared by all instances for the same zone.
 struct QTzTimeZoneCacheEntry
 {
     QList<QTzTransitionTime> m_tranTimes;
     QList<QTzTransitionRule> m_tranRules;
     QList<QByteArray> m_abbreviations;
     QByteArray m_posixRule;
+    // m_bucketIndex[i] is the index of the last transition at or before
+    // m_bucketStart + (i << BucketShift), or -1; a bucket spans about a year
+    QList<int> m_bucketIndex;
+    qint64 m_bucketStart = 0;
+
+    enum { BucketShift = 35 };
+
+    void buildIndex();
+    int transitionIndex(qint64 atMSecsSinceEpoch) const;
 };
 
 class Q_AUTOTEST_EXPORT QTzTimeZonePrivate final : public QTimeZonePrivate
@@ -342,16 +352,26 @@ public:
     QList<QByteArray> availableTimeZoneIds() const override;
     QList<QByteArray> availableTimeZoneIds(QLocale::Country country) const override;
 
+    // Qt::LocalTime conversions from the zone data libc uses for the local
+    // time zone, without calling localtime_r() or mktime(). These return false
+    // when the data doesn't settle the answer, e.g. for a local time in a gap,
+    // and libc needs to be asked instead.
+    static bool localTimeOffset(qint64 utcMSecs, int *offsetSeconds, bool *isDst);
+    static bool localTimeToUtc(qint64 localMSecs, int dstHint, qint64 *utcMSecs, bool *isDst);
+    // Records the offset of a mktime() result, see localTimeToUtc()
+    static void noteMkTimeOffset(int offsetSeconds);
+
 private:
     void init(const QByteArray &ianaId);
     QList<QTimeZonePrivate::Data> getPosixTransitions(qint64 msNear) const;
 
     Data dataForTzTransition(QTzTransitionTime tran) const;
+    const QTzTransitionRule *ruleFor(qint64 atMSecsSinceEpoch) const;
 #if QT_CONFIG(icu)
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif
     QTzTimeZoneCacheEntry cached_data;
-    QList<QTzTransitionTime> tranCache() const { return cached_data.m_tranTimes; }
+    const QList<QTzTransitionTime> &tranCache() const { return cached_data.m_tranTimes; }
 };
 #endif // Q_OS_UNIX
 
@@ -837,6 +837,99 @@ QTzTimeZoneCacheEntry QTzTimeZoneCache::findEntry(const QByteArray &ianaId)
     return ret;
 }
 
+// Transitions of the POSIX rule are added to the table up to the end of this
+// year, so that lookups for the present and the foreseeable future don't need
+// to evaluate the rule each time.
+static const int posixTableEndYear = 2100;
+
+static void extendTransitionsFromPosixRule(QTzTimeZoneCacheEntry &entry)
+{
+    if (entry.m_posixRule.isEmpty() || entry.m_tranTimes.isEmpty())
+        return;
+    const qint64 lastTran = entry.m_tranTimes.last().atMSecsSinceEpoch;
+    const int startYear = QDateTime::fromMSecsSinceEpoch(lastTran, Qt::UTC).date().year();
+    if (startYear >= posixTableEndYear)
+        return;
+
+    const QList<QTimeZonePrivate::Data> posixTrans =
+        calculatePosixTransitions(entry.m_posixRule, startYear, posixTableEndYear, lastTran);
+    for (const QTimeZonePrivate::Data &data : posixTrans) {
+        if (data.atMSecsSinceEpoch <= entry.m_tranTimes.last().atMSecsSinceEpoch)
+            continue;
+
+        const QByteArray abbreviation = data.abbreviation.toUtf8();
+        int abbreviationIndex = entry.m_abbreviations.indexOf(abbreviation);
+        if (abbreviationIndex == -1) {
+            if (entry.m_abbreviations.size() > 255)
+                return;
+            entry.m_abbreviations.append(abbreviation);
+            abbreviationIndex = entry.m_abbreviations.size() - 1;
+        }
+
+        QTzTransitionRule rule;
+        rule.stdOffset = data.standardTimeOffset;
+        rule.dstOffset = data.daylightTimeOffset;
+        rule.abbreviationIndex = quint8(abbreviationIndex);
+        int ruleIndex = entry.m_tranRules.indexOf(rule);
+        if (ruleIndex == -1) {
+            if (entry.m_tranRules.size() > 255)
+                return;
+            entry.m_tranRules.append(rule);
+            ruleIndex = entry.m_tranRules.size() - 1;
+        }
+
+        QTzTransitionTime tran;
+        tran.atMSecsSinceEpoch = data.atMSecsSinceEpoch;
+        tran.ruleIndex = quint8(ruleIndex);
+        entry.m_tranTimes.append(tran);
+    }
+}
+
+void QTzTimeZoneCacheEntry::buildIndex()
+{
+    m_bucketIndex.clear();
+    if (m_tranTimes.isEmpty())
+        return;
+
+    // Some files start with a "big bang" transition at -2^59 seconds; start
+    // the buckets no earlier than about 1830, earlier times fall back to a
+    // binary search.
+    const qint64 earliest = -(qint64(1) << 42);
+    m_bucketStart = qMax(m_tranTimes.first().atMSecsSinceEpoch, earliest);
+    const qint64 span = m_tranTimes.last().atMSecsSinceEpoch - m_bucketStart;
+    const int buckets = int(qMin((span >> BucketShift) + 1, qint64(1024)));
+    m_bucketIndex.reserve(buckets);
+    int index = -1;
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        const qint64 start = m_bucketStart + (qint64(bucket) << BucketShift);
+        while (index + 1 < m_tranTimes.size() && m_tranTimes.at(index + 1).atMSecsSinceEpoch <= start)
+            ++index;
+        m_bucketIndex.append(index);
+    }
+}
+
+// Returns the index of the last transition at or before atMSecsSinceEpoch,
+// or -1 if there is none.
+int QTzTimeZoneCacheEntry::transitionIndex(qint64 atMSecsSinceEpoch) const
+{
+    const qint64 offset = atMSecsSinceEpoch - m_bucketStart;
+    const qint64 bucket = offset >> BucketShift;
+    if (offset < 0 || bucket >= m_bucketIndex.size()) {
+        auto it = std::partition_point(m_tranTimes.cbegin(), m_tranTimes.cend(),
+                                       [atMSecsSinceEpoch](const QTzTransitionTime &at) {
+                                           return at.atMSecsSinceEpoch <= atMSecsSinceEpoch;
+                                       });
+        return int(it - m_tranTimes.cbegin()) - 1;
+    }
+
+    int index = m_bucketIndex.at(int(bucket));
+    while (index + 1 < m_tranTimes.size()
+           && m_tranTimes.at(index + 1).atMSecsSinceEpoch <= atMSecsSinceEpoch) {
+        ++index;
+    }
+    return index;
+}
+
 QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
 {
     QMutexLocker locker(&m_mutex);
@@ -848,14 +941,21 @@ QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
 
     // ... or build a new entry from scratch
     QTzTimeZoneCacheEntry ret = findEntry(ianaId);
+    extendTransitionsFromPosixRule(ret);
+    ret.buildIndex();
     m_cache[ianaId] = ret;
     return ret;
 }
 
+static QTzTimeZoneCache &tzCache()
+{
+    static QTzTimeZoneCache cache;
+    return cache;
+}
+
 void QTzTimeZonePrivate::init(const QByteArray &ianaId)
 {
-    static QTzTimeZoneCache tzCache;
-    const auto &entry = tzCache.fetchEntry(ianaId);
+    const auto &entry = tzCache().fetchEntry(ianaId);
     if (entry.m_tranTimes.isEmpty() && entry.m_posixRule.isEmpty())
         return; // Invalid after all !
 
@@ -973,17 +1073,23 @@ QString QTzTimeZonePrivate::abbreviation(qint64 atMSecsSinceEpoch) const
 
 int QTzTimeZonePrivate::offsetFromUtc(qint64 atMSecsSinceEpoch) const
 {
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->stdOffset + rule->dstOffset;
     const QTimeZonePrivate::Data tran = data(atMSecsSinceEpoch);
     return tran.offsetFromUtc; // == tran.standardTimeOffset + tran.daylightTimeOffset
 }
 
 int QTzTimeZonePrivate::standardTimeOffset(qint64 atMSecsSinceEpoch) const
 {
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->stdOffset;
     return data(atMSecsSinceEpoch).standardTimeOffset;
 }
 
 int QTzTimeZonePrivate::daylightTimeOffset(qint64 atMSecsSinceEpoch) const
 {
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->dstOffset;
     return data(atMSecsSinceEpoch).daylightTimeOffset;
 }
 
@@ -1014,6 +1120,19 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
     return data;
 }
 
+// Returns the rule data() would use, without building the abbreviation, or
+// nullptr if the POSIX rule has to be evaluated.
+const QTzTransitionRule *QTzTimeZonePrivate::ruleFor(qint64 atMSecsSinceEpoch) const
+{
+    if (tranCache().isEmpty()
+        || (!cached_data.m_posixRule.isEmpty()
+            && tranCache().last().atMSecsSinceEpoch < atMSecsSinceEpoch)) {
+        return nullptr;
+    }
+    const int index = qMax(cached_data.transitionIndex(atMSecsSinceEpoch), 0);
+    return &cached_data.m_tranRules.at(tranCache().at(index).ruleIndex);
+}
+
 QList<QTimeZonePrivate::Data> QTzTimeZonePrivate::getPosixTransitions(qint64 msNear) const
 {
     const int year = QDateTime::fromMSecsSinceEpoch(msNear, Qt::UTC).date().year();
@@ -1044,13 +1163,8 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
         return invalidData();
 
     // Otherwise, use the rule for the most recent or first transition:
-    auto last = std::partition_point(tranCache().cbegin(), tranCache().cend(),
-                                     [forMSecsSinceEpoch] (const QTzTransitionTime &at) {
-                                         return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
-                                     });
-    if (last > tranCache().cbegin())
-        --last;
-    Data data = dataForTzTransition(*last);
+    const int index = qMax(cached_data.transitionIndex(forMSecsSinceEpoch), 0);
+    Data data = dataForTzTransition(tranCache().at(index));
     data.atMSecsSinceEpoch = forMSecsSinceEpoch;
     return data;
 }
@@ -1076,11 +1190,8 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
     }
 
     // Otherwise, if we can find a valid tran, use its rule:
-    auto last = std::partition_point(tranCache().cbegin(), tranCache().cend(),
-                                     [afterMSecsSinceEpoch] (const QTzTransitionTime &at) {
-                                         return at.atMSecsSinceEpoch <= afterMSecsSinceEpoch;
-                                     });
-    return last != tranCache().cend() ? dataForTzTransition(*last) : invalidData();
+    const int index = cached_data.transitionIndex(afterMSecsSinceEpoch) + 1;
+    return index < tranCache().size() ? dataForTzTransition(tranCache().at(index)) : invalidData();
 }
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecsSinceEpoch) const
@@ -1108,6 +1219,145 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
     return last > tranCache().cbegin() ? dataForTzTransition(*--last) : invalidData();
 }
 
+namespace {
+struct LocalZoneData
+{
+    QByteArray tz;              // value of TZ the entry is for, null if unset
+    bool initialized = false;
+    bool usable = false;
+    QTzTimeZoneCacheEntry entry;
+};
+}
+
+// Returns the zone data libc uses for local time, or nullptr if it is not
+// known which data that is. Each thread keeps its own reference, so that the
+// only shared state touched per conversion is the environment.
+static const QTzTimeZoneCacheEntry *localZoneEntry()
+{
+    static thread_local LocalZoneData local;
+    if (local.initialized && qTzMatches(local.tz.isNull() ? nullptr : local.tz.constData()))
+        return local.usable ? &local.entry : nullptr;
+
+    // code relying on tzname[] expects tzset() to have been called by now
+    qTzSet();
+    local.initialized = true;
+    local.usable = false;
+    local.entry = QTzTimeZoneCacheEntry();
+    local.tz = qgetenv("TZ");
+
+    QByteArray name = local.tz;
+    if (name.startsWith(':'))
+        name = name.mid(1);
+    // An empty TZ means UTC to libc, and it resolves relative names against
+    // $TZDIR, neither of which the cache knows about
+    if (!local.tz.isNull()
+        && (name.isEmpty() || name.startsWith('/') || qEnvironmentVariableIsSet("TZDIR"))) {
+        return nullptr;
+    }
+
+    // An empty name reads /etc/localtime, as libc does when TZ is unset
+    QTzTimeZoneCacheEntry entry = tzCache().fetchEntry(local.tz.isNull() ? QByteArray() : name);
+    // leave zones that only have a POSIX rule to libc
+    if (entry.m_tranTimes.isEmpty())
+        return nullptr;
+    local.entry = std::move(entry);
+    local.usable = true;
+    return &local.entry;
+}
+
+// Returns the rule of the transition at index, or nullptr if libc would not
+// use the transition table for the times that follow it.
+static const QTzTransitionRule *localRuleAt(const QTzTimeZoneCacheEntry &entry, int index)
+{
+    if (index < 0)
+        return nullptr;
+    // beyond the table, a rule with daylight-saving time needs evaluating
+    if (index == entry.m_tranTimes.size() - 1 && entry.m_posixRule.contains(','))
+        return nullptr;
+    return &entry.m_tranRules.at(entry.m_tranTimes.at(index).ruleIndex);
+}
+
+bool QTzTimeZonePrivate::localTimeOffset(qint64 utcMSecs, int *offsetSeconds, bool *isDst)
+{
+    const QTzTimeZoneCacheEntry *entry = localZoneEntry();
+    if (!entry)
+        return false;
+    const QTzTransitionRule *rule = localRuleAt(*entry, entry->transitionIndex(utcMSecs));
+    if (!rule)
+        return false;
+    *offsetSeconds = rule->stdOffset + rule->dstOffset;
+    *isDst = rule->dstOffset != 0;
+    return true;
+}
+
+// glibc's mktime() resolves an ambiguous local time by starting from the UTC
+// offset of its previous result, so the answer depends on earlier calls;
+// track that offset to give the same answers without calling it.
+static QBasicAtomicInt lastMkTimeOffset = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+void QTzTimeZonePrivate::noteMkTimeOffset(int offsetSeconds)
+{
+    lastMkTimeOffset.storeRelaxed(offsetSeconds);
+}
+
+bool QTzTimeZonePrivate::localTimeToUtc(qint64 localMSecs, int dstHint, qint64 *utcMSecs, bool *isDst)
+{
+    const QTzTimeZoneCacheEntry *entry = localZoneEntry();
+    if (!entry)
+        return false;
+
+    // Offsets never exceed a day, so any transition that matters is within
+    // two days of the local time. Leave anything but a single one to libc.
+    const qint64 window = 2 * 24 * 3600 * qint64(1000);
+    const int before = entry->transitionIndex(localMSecs - window);
+    const int after = entry->transitionIndex(localMSecs + window);
+    if (after - before > 1)
+        return false;
+    const QTzTransitionRule *beforeRule = localRuleAt(*entry, before);
+    const QTzTransitionRule *afterRule = localRuleAt(*entry, after);
+    if (!beforeRule || !afterRule)
+        return false;
+
+    const qint64 beforeUtc = localMSecs - (beforeRule->stdOffset + beforeRule->dstOffset) * 1000;
+    const QTzTransitionRule *rule = beforeRule;
+    qint64 utc = beforeUtc;
+    if (after != before) {
+        const qint64 at = entry->m_tranTimes.at(after).atMSecsSinceEpoch;
+        const qint64 afterUtc = localMSecs - (afterRule->stdOffset + afterRule->dstOffset) * 1000;
+        const bool beforeValid = beforeUtc < at;
+        const bool afterValid = afterUtc >= at;
+        bool useAfter = afterValid;
+        if (beforeValid && afterValid) {
+#ifdef __GLIBC__
+            const bool afterDst = afterRule->dstOffset != 0;
+            if (dstHint >= 0 && (beforeRule->dstOffset != 0) != afterDst) {
+                useAfter = (dstHint > 0) == afterDst;
+            } else {
+                // Where mktime() would start its search settles which one it finds
+                const int guessOffset = lastMkTimeOffset.loadRelaxed();
+                useAfter = localMSecs - guessOffset * qint64(1000) >= at;
+            }
+#else
+            return false;
+#endif
+        } else if (!beforeValid && !afterValid) { // in a gap
+            return false;
+        }
+        if (useAfter) {
+            rule = afterRule;
+            utc = afterUtc;
+        }
+    }
+
+    const bool dst = rule->dstOffset != 0;
+    if (dstHint >= 0 && dst != (dstHint > 0)) // libc adjusts the time for a wrong hint
+        return false;
+    noteMkTimeOffset(rule->stdOffset + rule->dstOffset);
+    *utcMSecs = utc;
+    *isDst = dst;
+    return true;
+}
+
 bool QTzTimeZonePrivate::isTimeZoneIdAvailable(const QByteArray &ianaId) const
 {
     return tzZones->contains(ianaId);
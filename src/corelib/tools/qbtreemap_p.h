@@ -0,0 +1,933 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBTREEMAP_P_H
+#define QBTREEMAP_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qlist.h"
+#include "qtypeinfo.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*
+  QBTreeMap provides an ordered associative container backed by a B+tree.
+
+  Elements are stored in leaf nodes holding up to a few dozen sorted entries
+  each, with keys and values in separate arrays like in QFlatMap, and the
+  leaves are chained for iteration. Compared to QMap's node-per-element
+  red-black tree this needs one allocation per leaf instead of one per
+  element, and lookups and range scans touch far fewer cache lines. While a
+  map fits into a single leaf it is effectively a QFlatMap.
+
+  The iteration order is the one of QMap and QMultiMap: ascending by key, and
+  for equal keys inserted with insertMulti(), the most recently inserted item
+  comes first.
+
+  Unlike QMap, QBTreeMap is not implicitly shared, and insertions and removals
+  invalidate all iterators.
+*/
+
+template <class Key, class T, class Compare = std::less<Key>>
+class QBTreeMap : private Compare
+{
+    static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+    static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+    // Nodes are sized to span a handful of cache lines.
+    static constexpr int NodeBytes = 1024;
+    static constexpr int LeafCapacity =
+            qBound(8, int(NodeBytes / (sizeof(Key) + sizeof(T))), 128);
+    static constexpr int InnerCapacity =
+            qBound(8, int(NodeBytes / (sizeof(Key) + sizeof(void *))), 128);
+    static constexpr int LeafMinimum = LeafCapacity / 2;
+    static constexpr int InnerMinimum = InnerCapacity / 2;
+
+    template <class U, int N>
+    struct Storage
+    {
+        alignas(U) char data[N * sizeof(U)];
+
+        U *begin() noexcept { return reinterpret_cast<U *>(data); }
+        const U *begin() const noexcept { return reinterpret_cast<const U *>(data); }
+        U &operator[](int i) noexcept { return begin()[i]; }
+        const U &operator[](int i) const noexcept { return begin()[i]; }
+    };
+
+    struct InnerNode;
+
+    struct Node
+    {
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+
+        InnerNode *parent = nullptr;
+        int count = 0;          // elements in a leaf, children in an inner node
+        const bool leaf;
+    };
+
+    struct LeafNode : Node
+    {
+        LeafNode() : Node(true) {}
+
+        LeafNode *prev = nullptr;
+        LeafNode *next = nullptr;
+        Storage<Key, LeafCapacity> keys;
+        Storage<T, LeafCapacity> values;
+    };
+
+    struct InnerNode : Node
+    {
+        InnerNode() : Node(false) {}
+
+        // keys[i] is a lower bound for the keys in children[i + 1]
+        // and an upper bound for those in children[i]
+        Storage<Key, InnerCapacity - 1> keys;
+        Node *children[InnerCapacity];
+    };
+
+    template <class U>
+    class mock_pointer
+    {
+        U ref;
+    public:
+        mock_pointer(U r)
+            : ref(r)
+        {
+        }
+
+        U *operator->()
+        {
+            return &ref;
+        }
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = qsizetype;
+    using key_compare = Compare;
+
+    class const_iterator;
+
+    class iterator
+    {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = std::pair<const Key, T>;
+        using reference = std::pair<const Key &, T &>;
+        using pointer = mock_pointer<reference>;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        iterator() = default;
+
+        const Key &key() const { return l->keys[i]; }
+        T &value() const { return l->values[i]; }
+        reference operator*() const { return { l->keys[i], l->values[i] }; }
+        pointer operator->() const { return { operator*() }; }
+
+        bool operator==(const iterator &o) const { return l == o.l && i == o.i; }
+        bool operator!=(const iterator &o) const { return !operator==(o); }
+
+        iterator &operator++()
+        {
+            if (++i == l->count && l->next) {
+                l = l->next;
+                i = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator r = *this;
+            ++*this;
+            return r;
+        }
+
+        iterator &operator--()
+        {
+            if (i == 0) {
+                l = l->prev;
+                i = l->count;
+            }
+            --i;
+            return *this;
+        }
+
+        iterator operator--(int)
+        {
+            iterator r = *this;
+            --*this;
+            return r;
+        }
+
+    private:
+        friend class QBTreeMap;
+        friend class const_iterator;
+
+        iterator(LeafNode *leaf, int index)
+            : l(leaf), i(index)
+        {
+        }
+
+        LeafNode *l = nullptr;
+        int i = 0;
+    };
+
+    class const_iterator
+    {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = std::pair<const Key, const T>;
+        using reference = std::pair<const Key &, const T &>;
+        using pointer = mock_pointer<reference>;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(iterator o)
+            : l(o.l), i(o.i)
+        {
+        }
+
+        const Key &key() const { return l->keys[i]; }
+        const T &value() const { return l->values[i]; }
+        reference operator*() const { return { l->keys[i], l->values[i] }; }
+        pointer operator->() const { return { operator*() }; }
+
+        bool operator==(const const_iterator &o) const { return l == o.l && i == o.i; }
+        bool operator!=(const const_iterator &o) const { return !operator==(o); }
+
+        const_iterator &operator++()
+        {
+            if (++i == l->count && l->next) {
+                l = l->next;
+                i = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator r = *this;
+            ++*this;
+            return r;
+        }
+
+        const_iterator &operator--()
+        {
+            if (i == 0) {
+                l = l->prev;
+                i = l->count;
+            }
+            --i;
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            const_iterator r = *this;
+            --*this;
+            return r;
+        }
+
+    private:
+        friend class QBTreeMap;
+
+        const_iterator(const LeafNode *leaf, int index)
+            : l(leaf), i(index)
+        {
+        }
+
+        const LeafNode *l = nullptr;
+        int i = 0;
+    };
+
+    QBTreeMap() = default;
+
+    explicit QBTreeMap(const Compare &compare)
+        : Compare(compare)
+    {
+    }
+
+    QBTreeMap(std::initializer_list<value_type> lst)
+    {
+        for (const value_type &v : lst)
+            insert(v.first, v.second);
+    }
+
+    QBTreeMap(const QBTreeMap &other)
+        : Compare(other)
+    {
+        if (other.root) {
+            LeafNode *previous = nullptr;
+            root = clone(other.root, nullptr, &previous);
+            last = previous;
+            n = other.n;
+        }
+    }
+
+    QBTreeMap(QBTreeMap &&other) noexcept
+        : Compare(static_cast<const Compare &>(other))
+    {
+        swap(other);
+    }
+
+    QBTreeMap &operator=(const QBTreeMap &other)
+    {
+        if (this != &other) {
+            QBTreeMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    QBTreeMap &operator=(QBTreeMap &&other) noexcept
+    {
+        QBTreeMap moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    ~QBTreeMap() { clear(); }
+
+    void swap(QBTreeMap &other) noexcept
+    {
+        std::swap(static_cast<Compare &>(*this), static_cast<Compare &>(other));
+        std::swap(root, other.root);
+        std::swap(first, other.first);
+        std::swap(last, other.last);
+        std::swap(n, other.n);
+    }
+
+    size_type count() const noexcept { return n; }
+    size_type size() const noexcept { return n; }
+    bool isEmpty() const noexcept { return n == 0; }
+    bool empty() const noexcept { return n == 0; }
+
+    void clear()
+    {
+        if (root)
+            destroy(root);
+        root = nullptr;
+        first = last = nullptr;
+        n = 0;
+    }
+
+    iterator begin() { return { first, 0 }; }
+    const_iterator begin() const { return { first, 0 }; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator constBegin() const { return begin(); }
+    iterator end() { return { last, last ? last->count : 0 }; }
+    const_iterator end() const { return { last, last ? last->count : 0 }; }
+    const_iterator cend() const { return end(); }
+    const_iterator constEnd() const { return end(); }
+    std::reverse_iterator<iterator> rbegin() { return std::reverse_iterator<iterator>(end()); }
+    std::reverse_iterator<const_iterator> rbegin() const
+    {
+        return std::reverse_iterator<const_iterator>(end());
+    }
+    std::reverse_iterator<iterator> rend() { return std::reverse_iterator<iterator>(begin()); }
+    std::reverse_iterator<const_iterator> rend() const
+    {
+        return std::reverse_iterator<const_iterator>(begin());
+    }
+
+    iterator lower_bound(const Key &key)
+    {
+        auto [leaf, index] = descend(key);
+        return normalized(leaf, index);
+    }
+
+    const_iterator lower_bound(const Key &key) const
+    {
+        return const_cast<QBTreeMap *>(this)->lower_bound(key);
+    }
+
+    iterator upper_bound(const Key &key)
+    {
+        if (!root)
+            return end();
+        Node *node = root;
+        while (!node->leaf) {
+            InnerNode *inner = static_cast<InnerNode *>(node);
+            const Key *keys = inner->keys.begin();
+            node = inner->children[std::upper_bound(keys, keys + inner->count - 1, key, keyLess())
+                                   - keys];
+        }
+        LeafNode *leaf = static_cast<LeafNode *>(node);
+        const Key *keys = leaf->keys.begin();
+        return normalized(leaf, std::upper_bound(keys, keys + leaf->count, key, keyLess()) - keys);
+    }
+
+    const_iterator upper_bound(const Key &key) const
+    {
+        return const_cast<QBTreeMap *>(this)->upper_bound(key);
+    }
+
+    iterator lowerBound(const Key &key) { return lower_bound(key); }
+    const_iterator lowerBound(const Key &key) const { return lower_bound(key); }
+    iterator upperBound(const Key &key) { return upper_bound(key); }
+    const_iterator upperBound(const Key &key) const { return upper_bound(key); }
+
+    std::pair<iterator, iterator> equal_range(const Key &key)
+    {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key &key) const
+    {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    iterator find(const Key &key)
+    {
+        iterator it = lower_bound(key);
+        if (it != end() && !Compare::operator()(key, it.key()))
+            return it;
+        return end();
+    }
+
+    const_iterator find(const Key &key) const
+    {
+        return const_cast<QBTreeMap *>(this)->find(key);
+    }
+
+    bool contains(const Key &key) const
+    {
+        return find(key) != end();
+    }
+
+    size_type count(const Key &key) const
+    {
+        const auto range = equal_range(key);
+        return std::distance(range.first, range.second);
+    }
+
+    T value(const Key &key, const T &defaultValue) const
+    {
+        auto it = find(key);
+        return it == end() ? defaultValue : it.value();
+    }
+
+    T value(const Key &key) const
+    {
+        auto it = find(key);
+        return it == end() ? T() : it.value();
+    }
+
+    T &operator[](const Key &key)
+    {
+        auto [leaf, index] = descend(key);
+        iterator it = normalized(leaf, index);
+        if (it == end() || Compare::operator()(key, it.key()))
+            return insertAt(leaf, index, key, T()).value();
+        return it.value();
+    }
+
+    T operator[](const Key &key) const
+    {
+        return value(key);
+    }
+
+    // Inserts or replaces the value for key.
+    template <class K, class V>
+    std::pair<iterator, bool> insert(K &&key, V &&value)
+    {
+        auto [leaf, index] = descend(key);
+        iterator it = normalized(leaf, index);
+        if (it == end() || Compare::operator()(key, it.key()))
+            return { insertAt(leaf, index, std::forward<K>(key), std::forward<V>(value)), true };
+        it.value() = std::forward<V>(value);
+        return { it, false };
+    }
+
+    // Inserts a new item in front of any existing items with the same key,
+    // like QMultiMap::insert() does.
+    template <class K, class V>
+    iterator insertMulti(K &&key, V &&value)
+    {
+        auto [leaf, index] = descend(key);
+        return insertAt(leaf, index, std::forward<K>(key), std::forward<V>(value));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        LeafNode *leaf = const_cast<LeafNode *>(pos.l);
+        int index = pos.i;
+        Q_ASSERT(leaf && index < leaf->count);
+
+        leaf->keys[index].~Key();
+        closeGap(leaf->keys.begin(), leaf->count, index);
+        leaf->values[index].~T();
+        closeGap(leaf->values.begin(), leaf->count, index);
+        --leaf->count;
+        --n;
+
+        if (leaf == root) {
+            if (leaf->count == 0) {
+                delete leaf;
+                root = nullptr;
+                first = last = nullptr;
+                return end();
+            }
+        } else if (leaf->count < LeafMinimum) {
+            rebalance(leaf, index);
+        }
+        return normalized(leaf, index);
+    }
+
+    // Removes all items with the given key and returns how many there were.
+    size_type remove(const Key &key)
+    {
+        size_type removed = 0;
+        iterator it = lower_bound(key);
+        while (it != end() && !Compare::operator()(key, it.key())) {
+            it = erase(it);
+            ++removed;
+        }
+        return removed;
+    }
+
+    T take(const Key &key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return T();
+        T result = std::move(it.value());
+        erase(it);
+        return result;
+    }
+
+    QList<Key> keys() const
+    {
+        QList<Key> result;
+        result.reserve(n);
+        for (const LeafNode *leaf = first; leaf; leaf = leaf->next) {
+            for (int i = 0; i < leaf->count; ++i)
+                result.append(leaf->keys[i]);
+        }
+        return result;
+    }
+
+    QList<T> values() const
+    {
+        QList<T> result;
+        result.reserve(n);
+        for (const LeafNode *leaf = first; leaf; leaf = leaf->next) {
+            for (int i = 0; i < leaf->count; ++i)
+                result.append(leaf->values[i]);
+        }
+        return result;
+    }
+
+    key_compare key_comp() const noexcept
+    {
+        return static_cast<const key_compare &>(*this);
+    }
+
+private:
+    auto keyLess() const
+    {
+        return [this](const Key &lhs, const Key &rhs) { return Compare::operator()(lhs, rhs); };
+    }
+
+    // Returns the leaf and the position in it where key would be inserted in
+    // front of all equal keys. The position may be one past the last element
+    // of the leaf.
+    std::pair<LeafNode *, int> descend(const Key &key) const
+    {
+        if (!root)
+            return { nullptr, 0 };
+        Node *node = root;
+        while (!node->leaf) {
+            InnerNode *inner = static_cast<InnerNode *>(node);
+            const Key *keys = inner->keys.begin();
+            node = inner->children[std::lower_bound(keys, keys + inner->count - 1, key, keyLess())
+                                   - keys];
+        }
+        LeafNode *leaf = static_cast<LeafNode *>(node);
+        const Key *keys = leaf->keys.begin();
+        return { leaf, int(std::lower_bound(keys, keys + leaf->count, key, keyLess()) - keys) };
+    }
+
+    iterator normalized(LeafNode *leaf, int index)
+    {
+        if (!leaf)
+            return end();
+        if (index == leaf->count && leaf->next)
+            return { leaf->next, 0 };
+        return { leaf, index };
+    }
+
+    // Moves the n elements starting at src to uninitialized memory at dst.
+    template <class U>
+    static void relocate(U *dst, U *src, int n)
+    {
+        if constexpr (QTypeInfo<U>::isRelocatable) {
+            if (n > 0)
+                memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(U));
+        } else if (dst < src) {
+            for (int i = 0; i < n; ++i) {
+                new (dst + i) U(std::move(src[i]));
+                src[i].~U();
+            }
+        } else {
+            for (int i = n - 1; i >= 0; --i) {
+                new (dst + i) U(std::move(src[i]));
+                src[i].~U();
+            }
+        }
+    }
+
+    // Makes room for one element at pos in an array of count elements.
+    template <class U>
+    static void openGap(U *array, int count, int pos)
+    {
+        relocate(array + pos + 1, array + pos, count - pos);
+    }
+
+    // Closes the hole left by an already destroyed element at pos.
+    template <class U>
+    static void closeGap(U *array, int count, int pos)
+    {
+        relocate(array + pos, array + pos + 1, count - pos - 1);
+    }
+
+    template <class K, class V>
+    iterator insertAt(LeafNode *leaf, int index, K &&key, V &&value)
+    {
+        if (!leaf) {
+            leaf = new LeafNode;
+            root = first = last = leaf;
+            index = 0;
+        } else if (leaf->count == LeafCapacity) {
+            LeafNode *right = split(leaf);
+            if (index > leaf->count) {
+                index -= leaf->count;
+                leaf = right;
+            }
+        }
+
+        openGap(leaf->keys.begin(), leaf->count, index);
+        new (&leaf->keys[index]) Key(std::forward<K>(key));
+        openGap(leaf->values.begin(), leaf->count, index);
+        new (&leaf->values[index]) T(std::forward<V>(value));
+        ++leaf->count;
+        ++n;
+        return { leaf, index };
+    }
+
+    static int indexInParent(const Node *node)
+    {
+        const InnerNode *parent = node->parent;
+        return int(std::find(parent->children, parent->children + parent->count, node)
+                   - parent->children);
+    }
+
+    LeafNode *split(LeafNode *leaf)
+    {
+        LeafNode *right = new LeafNode;
+        const int mid = leaf->count / 2;
+        relocate(right->keys.begin(), leaf->keys.begin() + mid, leaf->count - mid);
+        relocate(right->values.begin(), leaf->values.begin() + mid, leaf->count - mid);
+        right->count = leaf->count - mid;
+        leaf->count = mid;
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next)
+            leaf->next->prev = right;
+        else
+            last = right;
+        leaf->next = right;
+
+        insertIntoParent(leaf, right->keys[0], right);
+        return right;
+    }
+
+    InnerNode *split(InnerNode *node)
+    {
+        InnerNode *right = new InnerNode;
+        const int mid = node->count / 2;
+        // keys[mid - 1] moves up to the parent
+        Key separator(std::move(node->keys[mid - 1]));
+        node->keys[mid - 1].~Key();
+        relocate(right->keys.begin(), node->keys.begin() + mid, node->count - mid - 1);
+        std::copy(node->children + mid, node->children + node->count, right->children);
+        right->count = node->count - mid;
+        node->count = mid;
+        for (int i = 0; i < right->count; ++i)
+            right->children[i]->parent = right;
+
+        insertIntoParent(node, separator, right);
+        return right;
+    }
+
+    void insertIntoParent(Node *left, const Key &separator, Node *right)
+    {
+        InnerNode *parent = left->parent;
+        if (!parent) {
+            parent = new InnerNode;
+            parent->children[0] = left;
+            parent->count = 1;
+            left->parent = parent;
+            root = parent;
+        }
+
+        int pos = indexInParent(left);
+        if (parent->count == InnerCapacity) {
+            InnerNode *sibling = split(parent);
+            if (pos >= parent->count) {
+                pos -= parent->count;
+                parent = sibling;
+            }
+        }
+
+        openGap(parent->keys.begin(), parent->count - 1, pos);
+        new (&parent->keys[pos]) Key(separator);
+        std::copy_backward(parent->children + pos + 1, parent->children + parent->count,
+                           parent->children + parent->count + 1);
+        parent->children[pos + 1] = right;
+        right->parent = parent;
+        ++parent->count;
+    }
+
+    // Restores the minimum fill of leaf, adjusting index so that it keeps
+    // referring to the same position in the sequence.
+    void rebalance(LeafNode *&leaf, int &index)
+    {
+        InnerNode *parent = leaf->parent;
+        const int pos = indexInParent(leaf);
+        LeafNode *left = pos > 0 ? static_cast<LeafNode *>(parent->children[pos - 1]) : nullptr;
+        LeafNode *right = pos + 1 < parent->count
+                ? static_cast<LeafNode *>(parent->children[pos + 1]) : nullptr;
+
+        if (left && left->count > LeafMinimum) {
+            openGap(leaf->keys.begin(), leaf->count, 0);
+            relocate(leaf->keys.begin(), left->keys.begin() + left->count - 1, 1);
+            openGap(leaf->values.begin(), leaf->count, 0);
+            relocate(leaf->values.begin(), left->values.begin() + left->count - 1, 1);
+            --left->count;
+            ++leaf->count;
+            ++index;
+            parent->keys[pos - 1] = leaf->keys[0];
+        } else if (right && right->count > LeafMinimum) {
+            relocate(leaf->keys.begin() + leaf->count, right->keys.begin(), 1);
+            closeGap(right->keys.begin(), right->count, 0);
+            relocate(leaf->values.begin() + leaf->count, right->values.begin(), 1);
+            closeGap(right->values.begin(), right->count, 0);
+            ++leaf->count;
+            --right->count;
+            parent->keys[pos] = right->keys[0];
+        } else if (left) {
+            index += left->count;
+            merge(left, leaf);
+            leaf = left;
+            removeChild(parent, pos);
+        } else {
+            merge(leaf, right);
+            removeChild(parent, pos + 1);
+        }
+    }
+
+    void rebalance(InnerNode *node)
+    {
+        InnerNode *parent = node->parent;
+        const int pos = indexInParent(node);
+        InnerNode *left = pos > 0 ? static_cast<InnerNode *>(parent->children[pos - 1]) : nullptr;
+        InnerNode *right = pos + 1 < parent->count
+                ? static_cast<InnerNode *>(parent->children[pos + 1]) : nullptr;
+
+        if (left && left->count > InnerMinimum) {
+            // rotate the last child of left through the parent
+            openGap(node->keys.begin(), node->count - 1, 0);
+            new (&node->keys[0]) Key(std::move(parent->keys[pos - 1]));
+            parent->keys[pos - 1] = std::move(left->keys[left->count - 2]);
+            left->keys[left->count - 2].~Key();
+            std::copy_backward(node->children, node->children + node->count,
+                               node->children + node->count + 1);
+            node->children[0] = left->children[left->count - 1];
+            node->children[0]->parent = node;
+            --left->count;
+            ++node->count;
+        } else if (right && right->count > InnerMinimum) {
+            // rotate the first child of right through the parent
+            new (&node->keys[node->count - 1]) Key(std::move(parent->keys[pos]));
+            parent->keys[pos] = std::move(right->keys[0]);
+            right->keys[0].~Key();
+            closeGap(right->keys.begin(), right->count - 1, 0);
+            node->children[node->count] = right->children[0];
+            node->children[node->count]->parent = node;
+            std::copy(right->children + 1, right->children + right->count, right->children);
+            --right->count;
+            ++node->count;
+        } else if (left) {
+            merge(left, node, parent->keys[pos - 1]);
+            removeChild(parent, pos);
+        } else {
+            merge(node, right, parent->keys[pos]);
+            removeChild(parent, pos + 1);
+        }
+    }
+
+    // Appends all elements of right to left and deletes right.
+    void merge(LeafNode *left, LeafNode *right)
+    {
+        relocate(left->keys.begin() + left->count, right->keys.begin(), right->count);
+        relocate(left->values.begin() + left->count, right->values.begin(), right->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next)
+            right->next->prev = left;
+        else
+            last = left;
+        delete right;
+    }
+
+    // Appends the separator and all children of right to left and deletes right.
+    void merge(InnerNode *left, InnerNode *right, const Key &separator)
+    {
+        new (&left->keys[left->count - 1]) Key(separator);
+        relocate(left->keys.begin() + left->count, right->keys.begin(), right->count - 1);
+        for (int i = 0; i < right->count; ++i) {
+            left->children[left->count + i] = right->children[i];
+            right->children[i]->parent = left;
+        }
+        left->count += right->count;
+        delete right;
+    }
+
+    // Removes children[pos] and the separator in front of it from node.
+    void removeChild(InnerNode *node, int pos)
+    {
+        Q_ASSERT(pos > 0);
+        node->keys[pos - 1].~Key();
+        closeGap(node->keys.begin(), node->count - 1, pos - 1);
+        std::copy(node->children + pos + 1, node->children + node->count, node->children + pos);
+        --node->count;
+
+        if (node == root) {
+            if (node->count == 1) {
+                root = node->children[0];
+                root->parent = nullptr;
+                delete node;
+            }
+        } else if (node->count < InnerMinimum) {
+            rebalance(node);
+        }
+    }
+
+    Node *clone(const Node *node, InnerNode *parent, LeafNode **previous)
+    {
+        if (node->leaf) {
+            const LeafNode *source = static_cast<const LeafNode *>(node);
+            LeafNode *leaf = new LeafNode;
+            leaf->parent = parent;
+            std::uninitialized_copy(source->keys.begin(), source->keys.begin() + source->count,
+                                    leaf->keys.begin());
+            std::uninitialized_copy(source->values.begin(),
+                                    source->values.begin() + source->count, leaf->values.begin());
+            leaf->count = source->count;
+            leaf->prev = *previous;
+            if (*previous)
+                (*previous)->next = leaf;
+            else
+                first = leaf;
+            *previous = leaf;
+            return leaf;
+        }
+
+        const InnerNode *source = static_cast<const InnerNode *>(node);
+        InnerNode *inner = new InnerNode;
+        inner->parent = parent;
+        std::uninitialized_copy(source->keys.begin(), source->keys.begin() + source->count - 1,
+                                inner->keys.begin());
+        for (int i = 0; i < source->count; ++i) {
+            inner->children[i] = clone(source->children[i], inner, previous);
+            inner->count = i + 1;
+        }
+        return inner;
+    }
+
+    static void destroy(Node *node)
+    {
+        if (node->leaf) {
+            LeafNode *leaf = static_cast<LeafNode *>(node);
+            std::destroy(leaf->keys.begin(), leaf->keys.begin() + leaf->count);
+            std::destroy(leaf->values.begin(), leaf->values.begin() + leaf->count);
+            delete leaf;
+        } else {
+            InnerNode *inner = static_cast<InnerNode *>(node);
+            for (int i = 0; i < inner->count; ++i)
+                destroy(inner->children[i]);
+            std::destroy(inner->keys.begin(), inner->keys.begin() + inner->count - 1);
+            delete inner;
+        }
+    }
+
+    Node *root = nullptr;
+    LeafNode *first = nullptr;
+    LeafNode *last = nullptr;
+    size_type n = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QBTREEMAP_P_H
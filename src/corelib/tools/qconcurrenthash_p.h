@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QCONCURRENTHASH_P_H
+#define QCONCURRENTHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+/*! \internal
+
+    QConcurrentHash is a hash table that can be read and written from any
+    number of threads at the same time, meant for caches shared between
+    threads.
+
+    The table is split into shards selected by the high bits of the key's
+    hash, each holding two QHash copies of its items, so the items are stored
+    in QHash's span layout. Lookups don't take any lock: they register as
+    readers of the copy the shard currently publishes and search it.
+    Insertions and removals lock the mutex of the affected shard only. They
+    change the other copy, publish it, wait for the remaining readers of the
+    previous copy to finish, and then apply the same change to that copy as
+    well ("left-right" concurrency control). A write thus costs two QHash
+    operations plus the wait for lookups in progress in the same shard, and
+    the items take twice the memory.
+
+    Keys are hashed with qHash() and the global QHash seed, like QHash does.
+    Values are returned by copy, as another thread might replace them at any
+    time. Consequently, keys and values should be cheap to copy.
+*/
+template <class Key, class T>
+class QConcurrentHash
+{
+    struct Shard
+    {
+        QBasicMutex mutex;
+        QAtomicInt published;
+        QAtomicInteger<qsizetype> size;
+        QHash<Key, T> copies[2];
+
+        // written by every lookup, so keep them away from the data above
+        alignas(64) QAtomicInt readers[2];
+    };
+
+    // Registers as reader of the published copy of a shard for its lifetime.
+    class ReadLocker
+    {
+    public:
+        explicit ReadLocker(const Shard &shard)
+            : s(const_cast<Shard &>(shard))
+        {
+            for (;;) {
+                index = s.published.loadAcquire();
+                // the ordered increment keeps the check below from being
+                // reordered before it
+                s.readers[index].ref();
+                if (Q_LIKELY(s.published.loadAcquire() == index))
+                    break;
+                // a writer published the other copy in the meantime and may
+                // already be changing this one
+                s.readers[index].deref();
+            }
+        }
+        ~ReadLocker() { s.readers[index].deref(); }
+
+        const QHash<Key, T> &copy() const { return s.copies[index]; }
+
+    private:
+        Q_DISABLE_COPY_MOVE(ReadLocker)
+
+        Shard &s;
+        int index;
+    };
+
+    static constexpr int ShardBits = 6;
+
+public:
+    QConcurrentHash()
+        : seed(qGlobalQHashSeed())
+    {
+    }
+
+    qsizetype size() const noexcept
+    {
+        qsizetype result = 0;
+        for (const Shard &shard : shards)
+            result += shard.size.loadRelaxed();
+        return result;
+    }
+
+    bool isEmpty() const noexcept { return size() == 0; }
+
+    bool contains(const Key &key) const
+    {
+        ReadLocker locker(shardFor(key));
+        return locker.copy().contains(key);
+    }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        ReadLocker locker(shardFor(key));
+        return locker.copy().value(key, defaultValue);
+    }
+
+    // Stores the value for key in *value and returns true if key exists.
+    bool lookup(const Key &key, T *value) const
+    {
+        ReadLocker locker(shardFor(key));
+        const auto it = locker.copy().constFind(key);
+        if (it == locker.copy().constEnd())
+            return false;
+        *value = it.value();
+        return true;
+    }
+
+    // Inserts or replaces the value for key. Returns true if key was new.
+    bool insert(const Key &key, const T &value)
+    {
+        return insertImpl(key, value, true);
+    }
+
+    // Inserts value unless key already exists. Returns true if it was inserted.
+    bool tryInsert(const Key &key, const T &value)
+    {
+        return insertImpl(key, value, false);
+    }
+
+    bool remove(const Key &key)
+    {
+        Shard &shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        QHash<Key, T> &copy = writeCopy(shard);
+        if (!copy.remove(key))
+            return false;
+        shard.size.storeRelaxed(copy.size());
+        publish(shard);
+        writeCopy(shard).remove(key);
+        return true;
+    }
+
+    void clear()
+    {
+        for (Shard &shard : shards) {
+            QMutexLocker locker(&shard.mutex);
+            QHash<Key, T> &copy = writeCopy(shard);
+            if (copy.isEmpty())
+                continue;
+            copy.clear();
+            shard.size.storeRelaxed(0);
+            publish(shard);
+            writeCopy(shard).clear();
+        }
+    }
+
+    // Calls f(key, value) for every item. Items inserted or removed by other
+    // threads during the iteration may or may not be visited. f must not
+    // modify the hash, as writers wait for the iteration of a shard to end.
+    template <class Function>
+    void forEach(Function f) const
+    {
+        for (const Shard &shard : shards) {
+            ReadLocker locker(shard);
+            const QHash<Key, T> &copy = locker.copy();
+            for (auto it = copy.constBegin(); it != copy.constEnd(); ++it)
+                f(it.key(), it.value());
+        }
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(QConcurrentHash)
+
+    Shard &shardFor(const Key &key)
+    {
+        return shards[qHash(key, seed) >> (8 * sizeof(size_t) - ShardBits)];
+    }
+    const Shard &shardFor(const Key &key) const
+    {
+        return shards[qHash(key, seed) >> (8 * sizeof(size_t) - ShardBits)];
+    }
+
+    // must be called with the shard's mutex locked
+    static QHash<Key, T> &writeCopy(Shard &shard)
+    {
+        return shard.copies[1 - shard.published.loadRelaxed()];
+    }
+
+    // Makes the changed copy the one readers use, and waits until nobody
+    // reads the other one anymore, so it can be brought up to date.
+    static void publish(Shard &shard)
+    {
+        const int previous = shard.published.fetchAndStoreOrdered(1 - shard.published.loadRelaxed());
+        while (shard.readers[previous].loadAcquire())
+            QThread::yieldCurrentThread();
+    }
+
+    bool insertImpl(const Key &key, const T &value, bool replace)
+    {
+        Shard &shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        QHash<Key, T> &copy = writeCopy(shard);
+        const qsizetype oldSize = copy.size();
+        if (!replace && copy.contains(key))
+            return false;
+        copy.insert(key, value);
+        shard.size.storeRelaxed(copy.size());
+        publish(shard);
+        writeCopy(shard).insert(key, value);
+        return copy.size() != oldSize;
+    }
+
+    const size_t seed;
+    Shard shards[1 << ShardBits];
+};
+
+QT_END_NAMESPACE
+
+#endif // QCONCURRENTHASH_P_H
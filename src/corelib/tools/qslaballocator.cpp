@@ -0,0 +1,237 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qslaballocator_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+namespace {
+
+enum {
+    Granularity = 16,
+    SizeClassCount = 32,            // blocks of up to 512 bytes, header included
+    SlabSize = 64 * 1024
+};
+
+struct ThreadCache;
+
+// Precedes every block handed out while the allocator is enabled. Blocks too
+// large for any size class come from operator new and have no owner.
+struct alignas(Granularity) BlockHeader
+{
+    ThreadCache *owner;
+    int sizeClass;
+};
+static_assert(sizeof(BlockHeader) == Granularity);
+
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+struct Slab
+{
+    Slab *next;
+};
+
+struct ThreadCache
+{
+    ~ThreadCache() = delete;    // caches live forever, blocks may still be in use
+
+    FreeBlock *freeBlocks[SizeClassCount] = {};
+    QAtomicPointer<FreeBlock> remoteFreeBlocks[SizeClassCount];
+    Slab *slabs = nullptr;
+    char *slabCursor = nullptr;
+    char *slabEnd = nullptr;
+    ThreadCache *nextAbandoned = nullptr;
+};
+
+struct AbandonedCaches
+{
+    QBasicMutex mutex;
+    ThreadCache *first = nullptr;
+};
+
+} // unnamed namespace
+
+static AbandonedCaches abandonedCaches;
+
+static thread_local ThreadCache *currentThreadCache = nullptr;
+static thread_local bool threadCacheReleased = false;
+
+namespace {
+struct ThreadCacheReleaser
+{
+    ~ThreadCacheReleaser()
+    {
+        threadCacheReleased = true;
+        ThreadCache *cache = currentThreadCache;
+        if (!cache)
+            return;
+        currentThreadCache = nullptr;
+        QMutexLocker locker(&abandonedCaches.mutex);
+        cache->nextAbandoned = abandonedCaches.first;
+        abandonedCaches.first = cache;
+    }
+};
+} // unnamed namespace
+
+static thread_local ThreadCacheReleaser threadCacheReleaser;
+
+static ThreadCache *threadCache()
+{
+    if (Q_LIKELY(currentThreadCache))
+        return currentThreadCache;
+    if (threadCacheReleased)
+        return nullptr;     // the thread is exiting
+
+    ThreadCache *cache = nullptr;
+    {
+        QMutexLocker locker(&abandonedCaches.mutex);
+        cache = abandonedCaches.first;
+        if (cache)
+            abandonedCaches.first = cache->nextAbandoned;
+    }
+    if (!cache)
+        cache = new ThreadCache;
+    cache->nextAbandoned = nullptr;
+
+    // make sure the cache is handed back when the thread exits
+    (void)threadCacheReleaser;
+    currentThreadCache = cache;
+    return cache;
+}
+
+static FreeBlock *refill(ThreadCache *cache, int sizeClass)
+{
+    // first take back what other threads freed
+    if (FreeBlock *blocks = cache->remoteFreeBlocks[sizeClass].fetchAndStoreAcquire(nullptr))
+        return blocks;
+
+    const size_t blockSize = size_t(sizeClass + 1) * Granularity;
+    if (size_t(cache->slabEnd - cache->slabCursor) < blockSize) {
+        // the rest of the current slab is lost, at most one block
+        char *memory = static_cast<char *>(::operator new(SlabSize));
+        Slab *slab = reinterpret_cast<Slab *>(memory);
+        slab->next = cache->slabs;
+        cache->slabs = slab;
+        cache->slabCursor = memory + Granularity;
+        cache->slabEnd = memory + SlabSize;
+    }
+
+    // carve a handful of blocks at a time, so that rarely used size classes
+    // don't hog slab space
+    FreeBlock *first = nullptr;
+    for (int i = 0; i < 16 && size_t(cache->slabEnd - cache->slabCursor) >= blockSize; ++i) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(cache->slabCursor);
+        block->next = first;
+        first = block;
+        cache->slabCursor += blockSize;
+    }
+    return first;
+}
+
+bool QSlabAllocator::isEnabled() noexcept
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_OBJECT_SLAB_ALLOCATOR") > 0;
+    return enabled;
+}
+
+void *QSlabAllocator::allocate(size_t size)
+{
+    if (!isEnabled())
+        return ::operator new(size);
+
+    const size_t total = size + sizeof(BlockHeader);
+    const int sizeClass = int((total + Granularity - 1) / Granularity) - 1;
+    ThreadCache *cache = sizeClass < SizeClassCount ? threadCache() : nullptr;
+
+    BlockHeader *header;
+    if (!cache) {
+        header = static_cast<BlockHeader *>(::operator new(total));
+    } else {
+        FreeBlock *block = cache->freeBlocks[sizeClass];
+        if (!block)
+            block = refill(cache, sizeClass);
+        cache->freeBlocks[sizeClass] = block->next;
+        header = reinterpret_cast<BlockHeader *>(block);
+    }
+    header->owner = cache;
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+void QSlabAllocator::deallocate(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    if (!isEnabled())
+        return ::operator delete(ptr);
+
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+    ThreadCache *owner = header->owner;
+    if (!owner)
+        return ::operator delete(header);
+
+    const int sizeClass = header->sizeClass;
+    FreeBlock *block = reinterpret_cast<FreeBlock *>(header);
+    if (owner == currentThreadCache) {
+        block->next = owner->freeBlocks[sizeClass];
+        owner->freeBlocks[sizeClass] = block;
+        return;
+    }
+
+    QAtomicPointer<FreeBlock> &remote = owner->remoteFreeBlocks[sizeClass];
+    FreeBlock *head = remote.loadRelaxed();
+    do {
+        block->next = head;
+    } while (!remote.testAndSetRelease(head, block, head));
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSLABALLOCATOR_P_H
+#define QSLABALLOCATOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+/*! \internal
+
+    A size-class allocator with per-thread caches for small, frequently
+    created and destroyed internal objects such as QObjectPrivate,
+    connections and queued meta-call events.
+
+    Each thread allocates from its own free lists, one per 16 byte size class,
+    which are refilled from slabs of memory obtained in bulk. Blocks freed by
+    their owning thread go straight back to its free list; blocks freed by
+    another thread are pushed onto a lock-free list of the owner that it
+    drains the next time it runs out. When a thread exits, its cache is kept
+    and handed over to the next thread that starts allocating.
+
+    Pooled memory is never returned to the system. The allocator is therefore
+    opt-in: it is only used when the QT_OBJECT_SLAB_ALLOCATOR environment
+    variable is set to a non-zero value at the time of the first allocation.
+    Otherwise allocate() and deallocate() forward to the global operator new
+    and delete.
+
+    Classes opt in with Q_DECLARE_SLAB_ALLOCATED, which also covers all of
+    their subclasses.
+*/
+class Q_CORE_EXPORT QSlabAllocator
+{
+public:
+    static void *allocate(size_t size);
+    static void deallocate(void *ptr) noexcept;
+    static bool isEnabled() noexcept;
+};
+
+} // namespace QtPrivate
+
+#define Q_DECLARE_SLAB_ALLOCATED \
+    static void *operator new(size_t size) \
+    { return QtPrivate::QSlabAllocator::allocate(size); } \
+    static void *operator new(size_t, void *where) noexcept { return where; } \
+    static void operator delete(void *ptr) noexcept \
+    { QtPrivate::QSlabAllocator::deallocate(ptr); } \
+    static void operator delete(void *, void *) noexcept {}
+
+QT_END_NAMESPACE
+
+#endif // QSLABALLOCATOR_P_H
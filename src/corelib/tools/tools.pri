@@ -9,6 +9,7 @@ HEADERS +=  \
         tools/qarraydatapointer.h \
         tools/qbitarray.h \
         tools/qcache.h \
+        tools/qconcurrenthash_p.h \
         tools/qcontainerfwd.h \
         tools/qcontainertools_impl.h \
         tools/qcryptographichash.h \
@@ -42,6 +43,7 @@ HEADERS +=  \
         tools/qsharedpointer_impl.h \
         tools/qset.h \
         tools/qsize.h \
+        tools/qslaballocator_p.h \
         tools/qstack.h \
         tools/qtools_p.h \
         tools/qtaggedpointer.h \
@@ -66,6 +68,7 @@ SOURCES += \
         tools/qshareddata.cpp \
         tools/qsharedpointer.cpp \
         tools/qsize.cpp \
+        tools/qslaballocator.cpp \
         tools/qversionnumber.cpp
 
 qtConfig(system-zlib) {
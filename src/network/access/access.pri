@@ -80,6 +80,7 @@ qtConfig(http) {
         access/qdecompresshelper.cpp \
         access/qabstractprotocolhandler.cpp \
         access/qhttp2protocolhandler.cpp \
+        access/qhttp2serverconnection.cpp \
         access/qhttpmultipart.cpp \
         access/qhttpnetworkconnection.cpp \
         access/qhttpnetworkconnectionchannel.cpp \
@@ -87,14 +88,18 @@ qtConfig(http) {
         access/qhttpnetworkreply.cpp \
         access/qhttpnetworkrequest.cpp \
         access/qhttpprotocolhandler.cpp \
+        access/qhttpserver.cpp \
+        access/qhttpserverconnection.cpp \
         access/qhttpthreaddelegate.cpp \
         access/qnetworkreplyhttpimpl.cpp \
-        access/qhttp2configuration.cpp
+        access/qhttp2configuration.cpp \
+        access/qhttpconnectionpoolconfiguration.cpp
 
     HEADERS += \
         access/qdecompresshelper_p.h \
         access/qabstractprotocolhandler_p.h \
         access/qhttp2protocolhandler_p.h \
+        access/qhttp2serverconnection_p.h \
         access/qhttpmultipart.h \
         access/qhttpmultipart_p.h \
         access/qhttpnetworkconnection_p.h \
@@ -103,9 +108,13 @@ qtConfig(http) {
         access/qhttpnetworkreply_p.h \
         access/qhttpnetworkrequest_p.h \
         access/qhttpprotocolhandler_p.h \
+        access/qhttpserver_p.h \
+        access/qhttpserverconnection_p.h \
         access/qhttpthreaddelegate_p.h \
         access/qnetworkreplyhttpimpl_p.h \
-        access/qhttp2configuration.h
+        access/qhttp2configuration.h \
+        access/qhttpconnectionpoolconfiguration.h \
+        access/qhttpconnectionpoolconfiguration_p.h
 
     qtConfig(brotli) {
         QMAKE_USE_PRIVATE += brotli
@@ -72,6 +72,11 @@ public:
     virtual bool sendRequest() = 0;
     void setReply(QHttpNetworkReply *reply);
 
+    // Multiplexing protocols report their requests in flight and how many
+    // of them the peer accepts at once; 0 means one request at a time.
+    virtual quint32 activeStreamCount() const { return 0; }
+    virtual quint32 maxConcurrentStreamCount() const { return 0; }
+
 protected:
     QHttpNetworkConnectionChannel *m_channel;
     QHttpNetworkReply *m_reply;
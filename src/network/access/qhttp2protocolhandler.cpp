@@ -726,7 +726,19 @@ void QHttp2ProtocolHandler::handleRST_STREAM()
     Q_ASSERT(inboundFrame.dataSize() == 4);
 
     Stream &stream = activeStreams[streamID];
-    finishStreamWithError(stream, qFromBigEndian<quint32>(inboundFrame.dataBegin()));
+    const quint32 errorCode = qFromBigEndian<quint32>(inboundFrame.dataBegin());
+    if (errorCode == REFUSE_STREAM && streamOpenedBeforePeerSettings(streamID)
+        && (!stream.data() || stream.data()->reset())) {
+        // 8.1.4: a refused stream was not processed, so the request can
+        // be retried once we respect the limits the peer announced.
+        // deleteActiveStream() schedules sending it again.
+        m_channel->h2RequestsToSend.insert(stream.request().priority(), stream.httpPair);
+        markAsReset(streamID);
+        deleteActiveStream(streamID);
+        return;
+    }
+
+    finishStreamWithError(stream, errorCode);
     markAsReset(stream.streamID);
     deleteActiveStream(stream.streamID);
 }
@@ -758,6 +770,9 @@ void QHttp2ProtocolHandler::handleSETTINGS()
         }
     }
 
+    if (!firstIDAfterPeerSettings)
+        firstIDAfterPeerSettings = nextID;
+
     sendSETTINGS_ACK();
 }
 
@@ -1411,6 +1426,11 @@ void QHttp2ProtocolHandler::deleteActiveStream(quint32 streamID)
         QMetaObject::invokeMethod(this, "sendRequest", Qt::QueuedConnection);
 }
 
+bool QHttp2ProtocolHandler::streamOpenedBeforePeerSettings(quint32 streamID) const
+{
+    return !firstIDAfterPeerSettings || streamID < firstIDAfterPeerSettings;
+}
+
 bool QHttp2ProtocolHandler::streamWasReset(quint32 streamID) const
 {
     const auto it = std::lower_bound(recycledStreams.begin(),
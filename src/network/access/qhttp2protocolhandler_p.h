@@ -95,6 +95,9 @@ public:
     Q_INVOKABLE void handleConnectionClosure();
     Q_INVOKABLE void ensureClientPrefaceSent();
 
+    quint32 activeStreamCount() const override { return quint32(activeStreams.size()); }
+    quint32 maxConcurrentStreamCount() const override { return maxConcurrentStreams; }
+
 private slots:
     void _q_uploadDataReadyRead();
     void _q_replyDestroyed(QObject* reply);
@@ -149,6 +152,7 @@ private:
     void removeFromSuspended(quint32 streamID);
     void deleteActiveStream(quint32 streamID);
     bool streamWasReset(quint32 streamID) const;
+    bool streamOpenedBeforePeerSettings(quint32 streamID) const;
 
     bool prefaceSent = false;
     // In the current implementation we send
@@ -189,6 +193,10 @@ private:
     // it's just a hint and we do not actually enforce it (and we can continue
     // sending requests and creating streams while maxConcurrentStreams allows).
 
+    // Streams below this ID were opened before the peer's SETTINGS told us
+    // its limits, and are retried if refused; 0 until then:
+    quint32 firstIDAfterPeerSettings = 0;
+
     // This is our (client-side) maximum possible receive window size, we set
     // it in a ctor from QHttp2Configuration, it does not change after that.
     // The default is 64Kb:
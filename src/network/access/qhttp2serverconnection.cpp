@@ -0,0 +1,940 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttp2serverconnection_p.h"
+
+#include "http2/bitstreams_p.h"
+
+#include <QtCore/qendian.h>
+#include <QtCore/qloggingcategory.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Http2;
+
+namespace {
+
+// The largest HPACK table we let the client make us maintain:
+const quint32 maxEncoderTableSize = HPack::FieldLookupTable::DefaultSize;
+
+// Advertised as SETTINGS_MAX_HEADER_LIST_SIZE; like the header size limit
+// of HTTP/1.1. A header block compressed to more than this is a connection
+// error, since it cannot be skipped without decoding it.
+const quint32 maxHeaderListSize = 64 * 1024;
+
+// How many in-progress streams a client may reset per second before the
+// connection is closed: opening and cancelling requests at once makes the
+// application do work the client never waits for ("rapid reset").
+const int maxStreamResetsPerSecond = 200;
+
+std::vector<uchar> assemble_hpack_block(const std::vector<Http2::Frame> &frames)
+{
+    std::vector<uchar> hpackBlock;
+
+    quint32 total = 0;
+    for (const auto &frame : frames)
+        total += frame.hpackBlockSize();
+
+    if (!total)
+        return hpackBlock;
+
+    hpackBlock.resize(total);
+    auto dst = hpackBlock.begin();
+    for (const auto &frame : frames) {
+        if (const auto hpackBlockSize = frame.hpackBlockSize()) {
+            const uchar *src = frame.hpackBlockBegin();
+            std::copy(src, src + hpackBlockSize, dst);
+            dst += hpackBlockSize;
+        }
+    }
+
+    return hpackBlock;
+}
+
+bool sum_will_overflow(qint32 windowSize, qint32 delta)
+{
+    if (windowSize > 0)
+        return std::numeric_limits<qint32>::max() - windowSize < delta;
+    return std::numeric_limits<qint32>::min() - windowSize > delta;
+}
+
+// RFC 7540, 8.1.2.2
+bool is_connection_specific(const QByteArray &name)
+{
+    return name == "connection" || name == "keep-alive" || name == "proxy-connection"
+           || name == "transfer-encoding" || name == "upgrade";
+}
+
+} // unnamed namespace
+
+/*!
+    \class QHttp2ServerConnection
+    \internal
+
+    \brief The QHttp2ServerConnection class serves HTTP/2 (RFC 7540).
+
+    Each stream is an exchange of a QHttpServerRequest and a
+    QHttpServerResponse. The stream receive window is returned to the
+    client as the application reads the request body, so a client cannot
+    send more than streamReceiveWindowSize() bytes nobody has read. Response
+    bodies are sent round-robin, within the client's flow control windows,
+    while the socket buffers less than SocketWriteBufferLimit bytes.
+*/
+
+QHttp2ServerConnection::QHttp2ServerConnection(QAbstractSocket *socket, QHttpServer *server)
+    : QHttpServerConnection(socket, server),
+      m_decoder(HPack::FieldLookupTable::DefaultSize),
+      m_encoder(HPack::FieldLookupTable::DefaultSize, true)
+{
+    m_continuedFrames.reserve(20);
+    m_encoder.setCompressStrings(m_http2Configuration.huffmanCompressionEnabled());
+    m_maxSessionRecvWindow = qint32(m_http2Configuration.sessionReceiveWindowSize());
+    m_streamInitialRecvWindow = qint32(m_http2Configuration.streamReceiveWindowSize());
+    m_maxConcurrentStreams = quint32(server->maxConcurrentStreams());
+}
+
+QHttp2ServerConnection::~QHttp2ServerConnection()
+{
+}
+
+void QHttp2ServerConnection::start()
+{
+    sendServerPreface();
+    socketReadyRead();
+}
+
+void QHttp2ServerConnection::startUpgraded(const QByteArray &method, const QByteArray &target,
+                                           const QByteArray &authority,
+                                           const QList<QPair<QByteArray, QByteArray>> &headers,
+                                           const QByteArray &settings)
+{
+    sendServerPreface();
+    // The 101 response acknowledges these settings, RFC 7540, 3.2.1:
+    if (!applySettings(reinterpret_cast<const uchar *>(settings.constData()),
+                       quint32(settings.size()))) {
+        return;
+    }
+
+    QList<QPair<QByteArray, QByteArray>> fields;
+    for (const auto &field : headers) {
+        if (!is_connection_specific(field.first) && field.first != "http2-settings"
+            && field.first != "host" && field.first != "te") {
+            fields.append(field);
+        }
+    }
+
+    QHttpServerRequest *request = createRequest(QHttpServerRequest::Protocol::Http2);
+    setRequestHeader(request, method, target, authority, std::move(fields), 0);
+    setStreamID(request, 1);
+
+    Stream stream;
+    stream.streamID = 1;
+    stream.request = request;
+    stream.response = responseOf(request);
+    stream.sendWindow = m_streamInitialSendWindow;
+    stream.remoteClosed = true;
+    m_streams.emplace(1, std::move(stream));
+    m_lastStreamID = 1;
+
+    QPointer<QHttpServerRequest> guard = request;
+    finishRequestBody(request);
+    if (guard)
+        emitNewRequest(guard);
+    // The client preface may follow the upgrade request right away
+    socketReadyRead();
+}
+
+void QHttp2ServerConnection::sendServerPreface()
+{
+    // 3.5: the server connection preface is a SETTINGS frame
+    m_frameWriter.start(FrameType::SETTINGS, FrameFlag::EMPTY, connectionStreamID);
+    m_frameWriter.append(Settings::MAX_CONCURRENT_STREAMS_ID);
+    m_frameWriter.append(m_maxConcurrentStreams);
+    m_frameWriter.append(Settings::INITIAL_WINDOW_SIZE_ID);
+    m_frameWriter.append(quint32(m_streamInitialRecvWindow));
+    m_frameWriter.append(Settings::MAX_HEADER_LIST_SIZE_ID);
+    m_frameWriter.append(maxHeaderListSize);
+    if (m_http2Configuration.maxFrameSize() != minPayloadLimit) {
+        m_frameWriter.append(Settings::MAX_FRAME_SIZE_ID);
+        m_frameWriter.append(quint32(m_http2Configuration.maxFrameSize()));
+    }
+    m_frameWriter.write(*m_socket);
+
+    // The session window can only be enlarged with WINDOW_UPDATE:
+    if (m_maxSessionRecvWindow > defaultSessionWindowSize)
+        sendWINDOW_UPDATE(connectionStreamID, m_maxSessionRecvWindow - defaultSessionWindowSize);
+    m_sessionRecvWindow = qMax(m_maxSessionRecvWindow, qint32(defaultSessionWindowSize));
+}
+
+void QHttp2ServerConnection::socketReadyRead()
+{
+    if (m_closed || !m_socket)
+        return;
+
+    if (!m_prefaceReceived) {
+        if (m_socket->bytesAvailable() < clientPrefaceLength)
+            return;
+        char preface[clientPrefaceLength] = {};
+        m_socket->read(preface, clientPrefaceLength);
+        if (std::memcmp(preface, Http2clientPreface, clientPrefaceLength) != 0)
+            return connectionError(PROTOCOL_ERROR, "invalid connection preface");
+        m_prefaceReceived = true;
+    }
+
+    while (!m_closed) {
+        const auto result = m_frameReader.read(*m_socket);
+        switch (result) {
+        case FrameStatus::incompleteFrame:
+            return;
+        case FrameStatus::protocolError:
+            return connectionError(PROTOCOL_ERROR, "invalid frame");
+        case FrameStatus::sizeError:
+            return connectionError(FRAME_SIZE_ERROR, "invalid frame size");
+        default:
+            break;
+        }
+
+        Q_ASSERT(result == FrameStatus::goodFrame);
+
+        m_inboundFrame = std::move(m_frameReader.inboundFrame());
+        if (m_inboundFrame.payloadSize() > m_http2Configuration.maxFrameSize())
+            return connectionError(FRAME_SIZE_ERROR, "frame exceeds SETTINGS_MAX_FRAME_SIZE");
+
+        const auto frameType = m_inboundFrame.type();
+        // 3.5: the first frame of the client has to be SETTINGS
+        if (!m_settingsReceived && frameType != FrameType::SETTINGS)
+            return connectionError(PROTOCOL_ERROR, "SETTINGS expected");
+        if (m_continuationExpected && frameType != FrameType::CONTINUATION)
+            return connectionError(PROTOCOL_ERROR, "CONTINUATION expected");
+
+        switch (frameType) {
+        case FrameType::DATA:
+            handleDATA();
+            break;
+        case FrameType::HEADERS:
+            handleHEADERS();
+            break;
+        case FrameType::PRIORITY:
+            handlePRIORITY();
+            break;
+        case FrameType::RST_STREAM:
+            handleRST_STREAM();
+            break;
+        case FrameType::SETTINGS:
+            handleSETTINGS();
+            break;
+        case FrameType::PUSH_PROMISE:
+            // 8.2: clients cannot push
+            return connectionError(PROTOCOL_ERROR, "PUSH_PROMISE from a client");
+        case FrameType::PING:
+            handlePING();
+            break;
+        case FrameType::GOAWAY:
+            handleGOAWAY();
+            break;
+        case FrameType::WINDOW_UPDATE:
+            handleWINDOW_UPDATE();
+            break;
+        case FrameType::CONTINUATION:
+            handleCONTINUATION();
+            break;
+        case FrameType::LAST_FRAME_TYPE:
+            // 5.1 - ignore unknown frames.
+            break;
+        }
+    }
+}
+
+void QHttp2ServerConnection::socketBytesWritten()
+{
+    sendData();
+}
+
+void QHttp2ServerConnection::handleDATA()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::DATA);
+
+    const auto streamID = m_inboundFrame.streamID();
+    if (streamID == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "DATA on stream 0x0");
+    if (streamID > m_lastStreamID)
+        return connectionError(PROTOCOL_ERROR, "DATA on idle stream");
+
+    const qint32 size = qint32(m_inboundFrame.payloadSize());
+    if (size > m_sessionRecvWindow)
+        return connectionError(FLOW_CONTROL_ERROR, "flow control error");
+    m_sessionRecvWindow -= size;
+
+    // Otherwise, the stream was reset or the response was complete
+    // before the request; the data is dropped
+    auto it = m_streams.find(streamID);
+    if (it != m_streams.end()) {
+        Stream &stream = it->second;
+        if (stream.remoteClosed) {
+            resetStream(streamID, STREAM_CLOSED);
+        } else if (size > stream.recvWindow) {
+            resetStream(streamID, FLOW_CONTROL_ERROR);
+        } else if (stream.contentLength != -1
+                   && m_inboundFrame.dataSize() > stream.contentLength - stream.receivedBytes) {
+            // 8.1.2.6: more data than the content-length makes it malformed
+            resetStream(streamID, PROTOCOL_ERROR);
+        } else {
+            stream.recvWindow -= size;
+            const quint32 dataSize = m_inboundFrame.dataSize();
+            const bool endStream = m_inboundFrame.flags().testFlag(FrameFlag::END_STREAM);
+            stream.receivedBytes += dataSize;
+            if (endStream)
+                stream.remoteClosed = true;
+            else // Padding counts against the window, we return it right away
+                returnStreamWindow(stream, size - qint32(dataSize));
+            if (dataSize && stream.request) {
+                const char *src = reinterpret_cast<const char *>(m_inboundFrame.dataBegin());
+                appendRequestBody(stream.request, QByteArray(src, int(dataSize)));
+            }
+            if (endStream)
+                finishStreamBody(streamID);
+        }
+    }
+
+    if (!m_closed && m_sessionRecvWindow < m_maxSessionRecvWindow / 2) {
+        sendWINDOW_UPDATE(connectionStreamID, m_maxSessionRecvWindow - m_sessionRecvWindow);
+        m_sessionRecvWindow = m_maxSessionRecvWindow;
+    }
+}
+
+void QHttp2ServerConnection::handleHEADERS()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::HEADERS);
+
+    const auto streamID = m_inboundFrame.streamID();
+    if (streamID == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "HEADERS on 0x0 stream");
+
+    // 5.3: priorities are ignored; hpackBlockBegin() skips them
+    const bool endHeaders = m_inboundFrame.flags().testFlag(FrameFlag::END_HEADERS);
+    m_continuedFrames.clear();
+    m_continuedHeaderBytes = m_inboundFrame.hpackBlockSize();
+    if (m_continuedHeaderBytes > maxHeaderListSize)
+        return connectionError(ENHANCE_YOUR_CALM, "header block too large");
+    m_continuedFrames.push_back(std::move(m_inboundFrame));
+    if (!endHeaders) {
+        m_continuationExpected = true;
+        return;
+    }
+
+    handleContinuedHEADERS();
+}
+
+void QHttp2ServerConnection::handleCONTINUATION()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::CONTINUATION);
+
+    if (!m_continuationExpected || m_continuedFrames.empty()
+        || m_inboundFrame.streamID() != m_continuedFrames.front().streamID()) {
+        return connectionError(PROTOCOL_ERROR, "CONTINUATION on invalid stream");
+    }
+
+    const bool endHeaders = m_inboundFrame.flags().testFlag(FrameFlag::END_HEADERS);
+    // Bounds both the size of the block and the number of frames, as
+    // each of them carries at least one byte of it
+    const quint32 size = m_inboundFrame.hpackBlockSize();
+    if (!size && !endHeaders)
+        return connectionError(ENHANCE_YOUR_CALM, "empty CONTINUATION");
+    m_continuedHeaderBytes += size;
+    if (m_continuedHeaderBytes > maxHeaderListSize)
+        return connectionError(ENHANCE_YOUR_CALM, "header block too large");
+    m_continuedFrames.push_back(std::move(m_inboundFrame));
+    if (!endHeaders)
+        return;
+
+    m_continuationExpected = false;
+    handleContinuedHEADERS();
+}
+
+void QHttp2ServerConnection::handleContinuedHEADERS()
+{
+    Q_ASSERT(m_continuedFrames.size());
+
+    const auto streamID = m_continuedFrames.front().streamID();
+    const bool endStream = m_continuedFrames.front().flags().testFlag(FrameFlag::END_STREAM);
+
+    // Decoded in any case, to keep the HPACK context in sync:
+    const std::vector<uchar> hpackBlock(assemble_hpack_block(m_continuedFrames));
+    m_continuedFrames.clear();
+    m_continuedHeaderBytes = 0;
+    HPack::HttpHeader header;
+    if (hpackBlock.size()) {
+        HPack::BitIStream inputStream{&hpackBlock[0], &hpackBlock[0] + hpackBlock.size()};
+        if (!m_decoder.decodeHeaderFields(inputStream))
+            return connectionError(COMPRESSION_ERROR, "HPACK decompression failed");
+        header = m_decoder.decodedHeader();
+    }
+    // 6.5.2: the size of the header list counts 32 bytes per field
+    quint64 headerListSize = 0;
+    for (const HPack::HeaderField &field : header)
+        headerListSize += quint64(field.name.size()) + quint64(field.value.size()) + 32;
+
+    auto it = m_streams.find(streamID);
+    if (it != m_streams.end()) {
+        // 8.1: trailers, which we drop; they have to end the stream
+        if (it->second.remoteClosed)
+            return resetStream(streamID, STREAM_CLOSED);
+        if (!endStream)
+            return resetStream(streamID, PROTOCOL_ERROR);
+        it->second.remoteClosed = true;
+        return finishStreamBody(streamID);
+    }
+
+    // A stream we reset, or that is closed already:
+    if (streamID <= m_lastStreamID)
+        return;
+    // 5.1.1: streams initiated by a client use odd identifiers
+    if (!(streamID & 1))
+        return connectionError(PROTOCOL_ERROR, "HEADERS on a stream with even ID");
+
+    m_lastStreamID = streamID;
+    if (m_goingAway || m_streams.size() >= m_maxConcurrentStreams)
+        return sendRST_STREAM(streamID, REFUSE_STREAM);
+    if (headerListSize > maxHeaderListSize)
+        return sendRST_STREAM(streamID, PROTOCOL_ERROR);
+
+    startStream(streamID, header, endStream);
+}
+
+void QHttp2ServerConnection::startStream(quint32 streamID, const HPack::HttpHeader &header,
+                                         bool endStream)
+{
+    QByteArray method;
+    QByteArray path;
+    QByteArray scheme;
+    QByteArray authority;
+    QByteArray host;
+    QList<QPair<QByteArray, QByteArray>> fields;
+    qint64 contentLength = -1;
+    bool regularFieldSeen = false;
+    bool valid = true;
+
+    // 8.1.2: validate the request header
+    for (const HPack::HeaderField &field : header) {
+        if (field.name.startsWith(':')) {
+            QByteArray *value = nullptr;
+            if (field.name == ":method")
+                value = &method;
+            else if (field.name == ":path")
+                value = &path;
+            else if (field.name == ":scheme")
+                value = &scheme;
+            else if (field.name == ":authority")
+                value = &authority;
+            if (!value || !value->isEmpty() || regularFieldSeen) {
+                valid = false;
+                break;
+            }
+            *value = field.value;
+            continue;
+        }
+
+        regularFieldSeen = true;
+        if (is_connection_specific(field.name) || field.name != field.name.toLower()
+            || (field.name == "te" && field.value != "trailers")) {
+            valid = false;
+            break;
+        }
+        if (field.name == "content-length") {
+            bool ok = false;
+            contentLength = field.value.toLongLong(&ok);
+            if (!ok || contentLength < 0) {
+                valid = false;
+                break;
+            }
+        } else if (field.name == "host") {
+            host = field.value;
+        }
+        fields.append({ field.name, field.value });
+    }
+
+    if (method.isEmpty() || (method != "CONNECT" && (path.isEmpty() || scheme.isEmpty())))
+        valid = false;
+    // 8.1.2.6: the DATA frames must add up to the content-length
+    if (endStream && contentLength > 0)
+        valid = false;
+    if (!valid)
+        return sendRST_STREAM(streamID, PROTOCOL_ERROR);
+
+    QHttpServerRequest *request = createRequest(QHttpServerRequest::Protocol::Http2);
+    setRequestHeader(request, std::move(method), std::move(path),
+                     authority.isEmpty() ? host : authority, std::move(fields),
+                     endStream ? 0 : contentLength);
+    setStreamID(request, streamID);
+
+    Stream stream;
+    stream.streamID = streamID;
+    stream.request = request;
+    stream.response = responseOf(request);
+    stream.sendWindow = m_streamInitialSendWindow;
+    stream.recvWindow = m_streamInitialRecvWindow;
+    stream.contentLength = contentLength;
+    stream.remoteClosed = endStream;
+    m_streams.emplace(streamID, std::move(stream));
+
+    QPointer<QHttpServerRequest> guard = request;
+    if (endStream)
+        finishRequestBody(request);
+    if (guard)
+        emitNewRequest(guard);
+}
+
+void QHttp2ServerConnection::finishStreamBody(quint32 streamID)
+{
+    auto it = m_streams.find(streamID);
+    if (it == m_streams.end() || !it->second.request)
+        return;
+    const Stream &stream = it->second;
+    if (stream.contentLength != -1 && stream.receivedBytes != stream.contentLength)
+        return resetStream(streamID, PROTOCOL_ERROR);
+    finishRequestBody(stream.request);
+}
+
+void QHttp2ServerConnection::handlePRIORITY()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::PRIORITY);
+
+    // 5.3: priorities are only a suggestion, we do not follow it
+    if (m_inboundFrame.streamID() == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "PRIORITY on 0x0 stream");
+}
+
+void QHttp2ServerConnection::handleRST_STREAM()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::RST_STREAM);
+
+    const auto streamID = m_inboundFrame.streamID();
+    if (streamID == connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "RST_STREAM on 0x0");
+    if (streamID > m_lastStreamID)
+        return connectionError(PROTOCOL_ERROR, "RST_STREAM on idle stream");
+
+    auto it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return;
+
+    if (!it->second.ended) {
+        if (!m_resetTimer.isValid() || m_resetTimer.elapsed() >= 1000) {
+            m_resetTimer.start();
+            m_resetCount = 0;
+        }
+        if (++m_resetCount > maxStreamResetsPerSecond)
+            return connectionError(ENHANCE_YOUR_CALM, "too many streams reset");
+    }
+
+    QPointer<QHttpServerRequest> request = it->second.request;
+    closeStream(streamID);
+    if (request)
+        abortExchange(request);
+}
+
+void QHttp2ServerConnection::handleSETTINGS()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::SETTINGS);
+
+    if (m_inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "SETTINGS on invalid stream");
+
+    if (m_inboundFrame.flags().testFlag(FrameFlag::ACK)) {
+        if (!m_settingsReceived)
+            return connectionError(PROTOCOL_ERROR, "unexpected SETTINGS ACK");
+        return;
+    }
+
+    m_settingsReceived = true;
+    if (!applySettings(m_inboundFrame.dataBegin(), m_inboundFrame.dataSize()))
+        return;
+
+    m_frameWriter.start(FrameType::SETTINGS, FrameFlag::ACK, connectionStreamID);
+    m_frameWriter.write(*m_socket);
+    // The flow control windows may have grown:
+    sendData();
+}
+
+bool QHttp2ServerConnection::applySettings(const uchar *src, quint32 size)
+{
+    Q_ASSERT(size % 6 == 0);
+
+    for (const uchar *end = src + size; src != end; src += 6) {
+        const Settings identifier = Settings(qFromBigEndian<quint16>(src));
+        const quint32 value = qFromBigEndian<quint32>(src + 2);
+        switch (identifier) {
+        case Settings::HEADER_TABLE_SIZE_ID:
+            m_encoder.setMaxDynamicTableSize(qMin(value, maxEncoderTableSize));
+            break;
+        case Settings::ENABLE_PUSH_ID:
+            if (value > 1) {
+                connectionError(PROTOCOL_ERROR, "SETTINGS invalid server push value");
+                return false;
+            }
+            break;
+        case Settings::INITIAL_WINDOW_SIZE_ID: {
+            if (value > quint32(std::numeric_limits<qint32>::max())) {
+                connectionError(FLOW_CONTROL_ERROR, "SETTINGS invalid initial window size");
+                return false;
+            }
+            // 6.9.2: the change applies to the windows of all streams
+            const qint32 delta = qint32(value) - m_streamInitialSendWindow;
+            m_streamInitialSendWindow = qint32(value);
+            for (auto &entry : m_streams) {
+                Stream &stream = entry.second;
+                if (sum_will_overflow(stream.sendWindow, delta)) {
+                    connectionError(FLOW_CONTROL_ERROR, "SETTINGS window overflow");
+                    return false;
+                }
+                stream.sendWindow += delta;
+                if (delta > 0)
+                    enqueue(stream);
+            }
+            break;
+        }
+        case Settings::MAX_FRAME_SIZE_ID:
+            if (value < minPayloadLimit || value > maxPayloadSize) {
+                connectionError(PROTOCOL_ERROR, "SETTINGS invalid max frame size");
+                return false;
+            }
+            m_peerMaxFrameSize = value;
+            break;
+        default:
+            // MAX_CONCURRENT_STREAMS concerns server push, MAX_HEADER_LIST_SIZE
+            // is advisory, and unknown settings are ignored (6.5.2)
+            break;
+        }
+    }
+    return true;
+}
+
+void QHttp2ServerConnection::handlePING()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::PING);
+
+    if (m_inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
+    if (m_inboundFrame.flags().testFlag(FrameFlag::ACK))
+        return;
+
+    m_frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
+    m_frameWriter.append(m_inboundFrame.dataBegin(), m_inboundFrame.dataBegin() + 8);
+    m_frameWriter.write(*m_socket);
+}
+
+void QHttp2ServerConnection::handleGOAWAY()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::GOAWAY);
+
+    if (m_inboundFrame.streamID() != connectionStreamID)
+        return connectionError(PROTOCOL_ERROR, "GOAWAY on invalid stream");
+
+    // The client starts no more streams; those it started are completed
+    m_goingAway = true;
+    if (m_streams.empty())
+        closeConnection();
+}
+
+void QHttp2ServerConnection::handleWINDOW_UPDATE()
+{
+    Q_ASSERT(m_inboundFrame.type() == FrameType::WINDOW_UPDATE);
+
+    const quint32 delta = qFromBigEndian<quint32>(m_inboundFrame.dataBegin()) & 0x7fffffff;
+    const auto streamID = m_inboundFrame.streamID();
+    if (streamID == connectionStreamID) {
+        if (!delta)
+            return connectionError(PROTOCOL_ERROR, "WINDOW_UPDATE invalid delta");
+        if (sum_will_overflow(m_sessionSendWindow, qint32(delta)))
+            return connectionError(FLOW_CONTROL_ERROR, "WINDOW_UPDATE session window overflow");
+        m_sessionSendWindow += qint32(delta);
+    } else {
+        if (streamID > m_lastStreamID)
+            return connectionError(PROTOCOL_ERROR, "WINDOW_UPDATE on idle stream");
+        auto it = m_streams.find(streamID);
+        if (it == m_streams.end())
+            return;
+        Stream &stream = it->second;
+        if (!delta)
+            return resetStream(streamID, PROTOCOL_ERROR);
+        if (sum_will_overflow(stream.sendWindow, qint32(delta)))
+            return resetStream(streamID, FLOW_CONTROL_ERROR);
+        stream.sendWindow += qint32(delta);
+        enqueue(stream);
+    }
+
+    sendData();
+}
+
+void QHttp2ServerConnection::requestBodyRead(QHttpServerRequest *request, qint64 size)
+{
+    if (Stream *stream = streamOf(request))
+        returnStreamWindow(*stream, qint32(size));
+}
+
+void QHttp2ServerConnection::returnStreamWindow(Stream &stream, qint32 size)
+{
+    if (stream.remoteClosed || m_closed)
+        return;
+
+    // Sent in batches, not for every read
+    stream.consumed += size;
+    if (stream.consumed >= m_streamInitialRecvWindow / 2) {
+        sendWINDOW_UPDATE(stream.streamID, quint32(stream.consumed));
+        stream.recvWindow += stream.consumed;
+        stream.consumed = 0;
+    }
+}
+
+void QHttp2ServerConnection::sendResponseHeaders(QHttpServerResponse *response)
+{
+    Stream *stream = streamOf(response->request());
+    if (!stream || m_closed)
+        return;
+
+    const int statusCode = response->statusCode();
+    stream->suppressBody = response->request()->method() == "HEAD" || statusCode < 200
+                           || statusCode == 204 || statusCode == 304;
+
+    HPack::HttpHeader header;
+    header.reserve(size_t(response->headers().size()) + 1);
+    header.push_back(HPack::HeaderField(":status", QByteArray::number(statusCode)));
+    for (const auto &field : response->headers()) {
+        if (!is_connection_specific(field.first))
+            header.push_back(HPack::HeaderField(field.first, field.second));
+    }
+
+    m_frameWriter.start(FrameType::HEADERS, FrameFlag::EMPTY, stream->streamID);
+    HPack::BitOStream outputStream(m_frameWriter.outboundFrame().buffer);
+    if (!m_encoder.encodeResponse(outputStream, header))
+        return connectionError(INTERNAL_ERROR, "HPACK compression failed");
+    m_frameWriter.writeHEADERS(*m_socket, m_peerMaxFrameSize);
+}
+
+void QHttp2ServerConnection::writeResponseBody(QHttpServerResponse *response, const char *data,
+                                               qint64 size)
+{
+    Stream *stream = streamOf(response->request());
+    if (!stream)
+        return;
+    if (stream->suppressBody) {
+        responseBytesWritten(response, size);
+        return;
+    }
+
+    stream->output.append(QByteArray(data, size));
+    enqueue(*stream);
+    sendData();
+}
+
+void QHttp2ServerConnection::endResponse(QHttpServerResponse *response)
+{
+    Stream *stream = streamOf(response->request());
+    if (!stream)
+        return;
+    if (isResponseTruncated(response))
+        return resetStream(stream->streamID, INTERNAL_ERROR);
+
+    stream->ended = true;
+    enqueue(*stream);
+    sendData();
+}
+
+qint64 QHttp2ServerConnection::pendingResponseBytes(const QHttpServerResponse *response) const
+{
+    const Stream *stream = streamOf(response->request());
+    return stream ? stream->output.byteAmount() : 0;
+}
+
+QHttp2ServerConnection::Stream *QHttp2ServerConnection::streamOf(const QHttpServerRequest *request)
+{
+    if (!request)
+        return nullptr;
+    auto it = m_streams.find(streamID(request));
+    if (it == m_streams.end() || it->second.request != request)
+        return nullptr;
+    return &it->second;
+}
+
+const QHttp2ServerConnection::Stream *
+QHttp2ServerConnection::streamOf(const QHttpServerRequest *request) const
+{
+    return const_cast<QHttp2ServerConnection *>(this)->streamOf(request);
+}
+
+void QHttp2ServerConnection::enqueue(Stream &stream)
+{
+    if (stream.queued || (stream.output.isEmpty() && !stream.ended))
+        return;
+    stream.queued = true;
+    m_sendQueue.push_back(stream.streamID);
+}
+
+void QHttp2ServerConnection::sendData()
+{
+    if (m_sendingData || m_closed || !m_socket)
+        return;
+
+    m_sendingData = true;
+    while (!m_sendQueue.empty() && m_socket->bytesToWrite() < SocketWriteBufferLimit) {
+        const quint32 streamID = m_sendQueue.front();
+        m_sendQueue.pop_front();
+        auto it = m_streams.find(streamID);
+        if (it == m_streams.end())
+            continue;
+
+        Stream &stream = it->second;
+        stream.queued = false;
+        const qint64 pending = stream.output.byteAmount();
+        bool endStream = stream.ended && !pending;
+        if (pending) {
+            const qint32 slot = qMin(stream.sendWindow, m_sessionSendWindow);
+            if (slot <= 0) {
+                if (m_sessionSendWindow <= 0) {
+                    // Every stream waits for the session window
+                    stream.queued = true;
+                    m_sendQueue.push_front(streamID);
+                    break;
+                }
+                // Queued again by WINDOW_UPDATE on this stream
+                continue;
+            }
+
+            const QByteArrayView chunk = stream.output.readPointer();
+            const quint32 size = quint32(std::min<qint64>({ chunk.size(), qint64(slot),
+                                                            qint64(m_peerMaxFrameSize) }));
+            endStream = stream.ended && size == pending;
+            m_frameWriter.start(FrameType::DATA,
+                                endStream ? FrameFlag::END_STREAM : FrameFlag::EMPTY, streamID);
+            m_frameWriter.writeDATA(*m_socket, m_peerMaxFrameSize,
+                                    reinterpret_cast<const uchar *>(chunk.data()), size);
+            stream.output.advanceReadPointer(size);
+            stream.sendWindow -= qint32(size);
+            m_sessionSendWindow -= qint32(size);
+            if (stream.response)
+                responseBytesWritten(stream.response, size);
+        } else if (endStream) {
+            m_frameWriter.start(FrameType::DATA, FrameFlag::END_STREAM, streamID);
+            m_frameWriter.write(*m_socket);
+        }
+
+        if (!endStream) {
+            enqueue(stream);
+            continue;
+        }
+
+        QPointer<QHttpServerRequest> request = stream.request;
+        if (stream.response)
+            responseDrained(stream.response);
+        const bool remoteClosed = stream.remoteClosed;
+        closeStream(streamID);
+        // 8.1: the rest of the request is of no interest anymore
+        if (!remoteClosed) {
+            sendRST_STREAM(streamID, HTTP2_NO_ERROR);
+            if (request) {
+                discardRequestBody(request);
+                finishRequestBody(request);
+            }
+        }
+    }
+    m_sendingData = false;
+}
+
+void QHttp2ServerConnection::closeStream(quint32 streamID)
+{
+    m_streams.erase(streamID);
+    if (m_goingAway && m_streams.empty())
+        closeConnection();
+}
+
+void QHttp2ServerConnection::resetStream(quint32 streamID, quint32 errorCode)
+{
+    sendRST_STREAM(streamID, errorCode);
+    auto it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return;
+
+    QPointer<QHttpServerRequest> request = it->second.request;
+    closeStream(streamID);
+    if (request)
+        abortExchange(request);
+}
+
+void QHttp2ServerConnection::connectionError(Http2::Http2Error errorCode, const char *message)
+{
+    Q_ASSERT(message);
+    if (m_closed)
+        return;
+
+    qCWarning(QT_HTTP2) << "server connection error:" << message;
+
+    m_closed = true;
+    m_goingAway = true;
+    sendGOAWAY(errorCode);
+    closeConnection();
+}
+
+void QHttp2ServerConnection::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
+{
+    m_frameWriter.start(FrameType::WINDOW_UPDATE, FrameFlag::EMPTY, streamID);
+    m_frameWriter.append(delta);
+    m_frameWriter.write(*m_socket);
+}
+
+void QHttp2ServerConnection::sendRST_STREAM(quint32 streamID, quint32 errorCode)
+{
+    m_frameWriter.start(FrameType::RST_STREAM, FrameFlag::EMPTY, streamID);
+    m_frameWriter.append(errorCode);
+    m_frameWriter.write(*m_socket);
+}
+
+void QHttp2ServerConnection::sendGOAWAY(quint32 errorCode)
+{
+    m_frameWriter.start(FrameType::GOAWAY, FrameFlag::EMPTY, connectionStreamID);
+    m_frameWriter.append(m_lastStreamID);
+    m_frameWriter.append(errorCode);
+    m_frameWriter.write(*m_socket);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTP2SERVERCONNECTION_P_H
+#define QHTTP2SERVERCONNECTION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/private/qhttpserverconnection_p.h>
+
+#include <private/http2protocol_p.h>
+#include <private/http2frames_p.h>
+#include <private/hpack_p.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/private/qbytedata_p.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QHttp2ServerConnection : public QHttpServerConnection
+{
+    Q_OBJECT
+public:
+    QHttp2ServerConnection(QAbstractSocket *socket, QHttpServer *server);
+    ~QHttp2ServerConnection() override;
+
+    void start() override;
+    // Continues an HTTP/1.1 connection upgraded with "Upgrade: h2c"
+    // (RFC 7540, 3.2); the request becomes stream 1
+    void startUpgraded(const QByteArray &method, const QByteArray &target,
+                       const QByteArray &authority,
+                       const QList<QPair<QByteArray, QByteArray>> &headers,
+                       const QByteArray &settings);
+
+    void requestBodyRead(QHttpServerRequest *request, qint64 size) override;
+    void sendResponseHeaders(QHttpServerResponse *response) override;
+    void writeResponseBody(QHttpServerResponse *response, const char *data,
+                           qint64 size) override;
+    void endResponse(QHttpServerResponse *response) override;
+    qint64 pendingResponseBytes(const QHttpServerResponse *response) const override;
+
+protected:
+    void socketReadyRead() override;
+    void socketBytesWritten() override;
+
+private:
+    struct Stream
+    {
+        quint32 streamID = 0;
+        QPointer<QHttpServerRequest> request;
+        QPointer<QHttpServerResponse> response;
+        // The response body waiting for flow control or the socket:
+        QByteDataBuffer output;
+        qint32 sendWindow = 0;
+        qint32 recvWindow = 0;
+        // Body bytes read by the application, not yet returned
+        // to the client with WINDOW_UPDATE:
+        qint32 consumed = 0;
+        // The request's content-length, -1 if none, and the body received:
+        qint64 contentLength = -1;
+        qint64 receivedBytes = 0;
+        bool remoteClosed = false;
+        bool suppressBody = false;
+        bool ended = false;
+        bool queued = false;
+    };
+
+    void sendServerPreface();
+    void handleDATA();
+    void handleHEADERS();
+    void handlePRIORITY();
+    void handleRST_STREAM();
+    void handleSETTINGS();
+    void handlePING();
+    void handleGOAWAY();
+    void handleWINDOW_UPDATE();
+    void handleCONTINUATION();
+    void handleContinuedHEADERS();
+
+    bool applySettings(const uchar *src, quint32 size);
+    void startStream(quint32 streamID, const HPack::HttpHeader &header, bool endStream);
+    void finishStreamBody(quint32 streamID);
+    void returnStreamWindow(Stream &stream, qint32 size);
+    void resetStream(quint32 streamID, quint32 errorCode);
+    void connectionError(Http2::Http2Error errorCode, const char *message);
+
+    void sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    void sendRST_STREAM(quint32 streamID, quint32 errorCode);
+    void sendGOAWAY(quint32 errorCode);
+
+    Stream *streamOf(const QHttpServerRequest *request);
+    const Stream *streamOf(const QHttpServerRequest *request) const;
+    void enqueue(Stream &stream);
+    void sendData();
+    void closeStream(quint32 streamID);
+
+    Http2::FrameReader m_frameReader;
+    Http2::Frame m_inboundFrame;
+    Http2::FrameWriter m_frameWriter;
+    HPack::Decoder m_decoder;
+    HPack::Encoder m_encoder;
+    std::vector<Http2::Frame> m_continuedFrames;
+    quint32 m_continuedHeaderBytes = 0;
+
+    std::map<quint32, Stream> m_streams;
+    // Streams with output, served round-robin:
+    std::deque<quint32> m_sendQueue;
+    quint32 m_lastStreamID = 0;
+    quint32 m_maxConcurrentStreams = Http2::maxConcurrentStreams;
+
+    qint32 m_sessionSendWindow = Http2::defaultSessionWindowSize;
+    qint32 m_streamInitialSendWindow = Http2::defaultSessionWindowSize;
+    qint32 m_sessionRecvWindow = Http2::defaultSessionWindowSize;
+    qint32 m_maxSessionRecvWindow = Http2::defaultSessionWindowSize;
+    qint32 m_streamInitialRecvWindow = Http2::defaultSessionWindowSize;
+    quint32 m_peerMaxFrameSize = Http2::minPayloadLimit;
+
+    // Client resets of in-progress streams in the current second:
+    QElapsedTimer m_resetTimer;
+    int m_resetCount = 0;
+
+    bool m_prefaceReceived = false;
+    bool m_settingsReceived = false;
+    bool m_continuationExpected = false;
+    bool m_goingAway = false;
+    bool m_closed = false;
+    bool m_sendingData = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTP2SERVERCONNECTION_P_H
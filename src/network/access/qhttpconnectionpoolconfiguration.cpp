@@ -0,0 +1,467 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpconnectionpoolconfiguration.h"
+#include "qhttpconnectionpoolconfiguration_p.h"
+
+#include "qdebug.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttpConnectionPoolConfiguration
+    \brief The QHttpConnectionPoolConfiguration class controls how
+    QNetworkAccessManager pools its HTTP connections.
+    \since 6.1
+
+    \reentrant
+    \inmodule QtNetwork
+    \ingroup network
+    \ingroup shared
+
+    QNetworkAccessManager keeps the connections it opened to a host and
+    reuses them for subsequent requests to the same host. The connection
+    pool configuration controls:
+
+    \list
+      \li How many connections are opened in parallel to a single host
+          for HTTP/1.1 requests. Browsers traditionally use six, which is
+          also the default; services talking to another service on a
+          fast network often want many more.
+      \li How many HTTP/2 connections are opened to a single host. A single
+          HTTP/2 connection multiplexes all requests, but a server can cap
+          the number of concurrent streams with
+          'SETTINGS_MAX_CONCURRENT_STREAMS'. Once all connections to a host
+          have reached that cap, another connection is opened, up to this
+          limit.
+      \li How long connections whose requests have all finished are kept
+          open, and how many such idle connections are kept at most.
+      \li How many connections QNetworkAccessManager::connectToHost() and
+          QNetworkAccessManager::connectToHostEncrypted() open ahead of
+          the first request.
+    \endlist
+
+    \note The limits for a host are taken from the configuration that is
+    current when the first request to that host is sent. Changing the
+    configuration later only affects hosts the pool is not connected to.
+
+    \sa QNetworkAccessManager::setConnectionPoolConfiguration(),
+        QHttpConnectionPoolStatistics
+*/
+
+namespace {
+// Qt allocates the channels of a connection up front, so keep the
+// per-host limit within reason:
+const int maximumChannelCount = 1024;
+}
+
+class QHttpConnectionPoolConfigurationPrivate : public QSharedData
+{
+public:
+    int maximumConnectionsPerHost = 6;
+    int maximumHttp2ConnectionsPerHost = 1;
+    int maximumIdleConnections = -1;
+    int idleTimeout = 120 * 1000;
+    int preconnectCount = 1;
+};
+
+/*!
+    Default constructs a QHttpConnectionPoolConfiguration object.
+
+    Such a configuration has the following values:
+    \list
+        \li Up to 6 HTTP/1.1 connections per host
+        \li One HTTP/2 connection per host
+        \li No limit on the number of idle connections
+        \li Idle connections are closed after 120 seconds
+        \li connectToHost() opens one connection
+    \endlist
+*/
+QHttpConnectionPoolConfiguration::QHttpConnectionPoolConfiguration()
+    : d(new QHttpConnectionPoolConfigurationPrivate)
+{
+}
+
+/*!
+    Copy-constructs this QHttpConnectionPoolConfiguration.
+*/
+QHttpConnectionPoolConfiguration::QHttpConnectionPoolConfiguration(const QHttpConnectionPoolConfiguration &) = default;
+
+/*!
+    Move-constructs this QHttpConnectionPoolConfiguration from \a other
+*/
+QHttpConnectionPoolConfiguration::QHttpConnectionPoolConfiguration(QHttpConnectionPoolConfiguration &&other) noexcept
+{
+    swap(other);
+}
+
+/*!
+    Copy-assigns \a other to this QHttpConnectionPoolConfiguration.
+*/
+QHttpConnectionPoolConfiguration &QHttpConnectionPoolConfiguration::operator=(const QHttpConnectionPoolConfiguration &) = default;
+
+/*!
+    Move-assigns \a other to this QHttpConnectionPoolConfiguration.
+*/
+QHttpConnectionPoolConfiguration &QHttpConnectionPoolConfiguration::operator=(QHttpConnectionPoolConfiguration &&) noexcept = default;
+
+/*!
+    Destructor.
+*/
+QHttpConnectionPoolConfiguration::~QHttpConnectionPoolConfiguration()
+{
+}
+
+/*!
+    Sets the maximum number of HTTP/1.1 connections QNetworkAccessManager
+    opens in parallel to a single host to \a count. \a count must be
+    between 1 and 1024.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa maximumConnectionsPerHost()
+*/
+bool QHttpConnectionPoolConfiguration::setMaximumConnectionsPerHost(int count)
+{
+    if (count < 1 || count > maximumChannelCount) {
+        qWarning("QHttpConnectionPoolConfiguration: invalid number of connections per host %d", count);
+        return false;
+    }
+
+    d->maximumConnectionsPerHost = count;
+    return true;
+}
+
+/*!
+    Returns the maximum number of HTTP/1.1 connections to a single host.
+    The default is 6.
+*/
+int QHttpConnectionPoolConfiguration::maximumConnectionsPerHost() const
+{
+    return d->maximumConnectionsPerHost;
+}
+
+/*!
+    Sets the maximum number of HTTP/2 connections QNetworkAccessManager
+    opens to a single host to \a count, which must be at least 1.
+
+    A new HTTP/2 connection is only opened when every existing connection
+    to the host already has as many requests in flight as the server
+    allows with 'SETTINGS_MAX_CONCURRENT_STREAMS'. When the limit is
+    reached, further requests wait on the first connection.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa maximumHttp2ConnectionsPerHost()
+*/
+bool QHttpConnectionPoolConfiguration::setMaximumHttp2ConnectionsPerHost(int count)
+{
+    if (count < 1) {
+        qWarning("QHttpConnectionPoolConfiguration: invalid number of HTTP/2 connections per host %d", count);
+        return false;
+    }
+
+    d->maximumHttp2ConnectionsPerHost = count;
+    return true;
+}
+
+/*!
+    Returns the maximum number of HTTP/2 connections to a single host.
+    The default is 1.
+*/
+int QHttpConnectionPoolConfiguration::maximumHttp2ConnectionsPerHost() const
+{
+    return d->maximumHttp2ConnectionsPerHost;
+}
+
+/*!
+    Sets the maximum number of idle connections that are kept open to
+    \a count. A connection is idle when no request is using it. When the
+    limit is exceeded, the connections to the host that has been idle for
+    the longest time are closed first. A negative \a count, the default,
+    means no limit; 0 closes connections as soon as they become idle.
+
+    \sa maximumIdleConnections(), setIdleTimeout()
+*/
+void QHttpConnectionPoolConfiguration::setMaximumIdleConnections(int count)
+{
+    d->maximumIdleConnections = count;
+}
+
+/*!
+    Returns the maximum number of idle connections, or a negative value
+    if there is no limit.
+*/
+int QHttpConnectionPoolConfiguration::maximumIdleConnections() const
+{
+    return d->maximumIdleConnections;
+}
+
+/*!
+    Sets the time in milliseconds after which idle connections to a host
+    are closed to \a msecs, which must not be negative.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa idleTimeout(), setMaximumIdleConnections()
+*/
+bool QHttpConnectionPoolConfiguration::setIdleTimeout(int msecs)
+{
+    if (msecs < 0) {
+        qWarning("QHttpConnectionPoolConfiguration: invalid idle timeout %d", msecs);
+        return false;
+    }
+
+    d->idleTimeout = msecs;
+    return true;
+}
+
+/*!
+    Returns the time in milliseconds after which idle connections are
+    closed. The default is 120000 (two minutes).
+*/
+int QHttpConnectionPoolConfiguration::idleTimeout() const
+{
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the number of connections QNetworkAccessManager::connectToHost()
+    and QNetworkAccessManager::connectToHostEncrypted() open to \a count,
+    which must be at least 1. Pre-warming several connections lets a burst
+    of requests start without waiting for TCP and TLS handshakes. No more
+    than maximumConnectionsPerHost() connections are opened, and only one
+    when the connection negotiates HTTP/2. Several clear text connections
+    are pre-warmed for HTTP/1.1 only, see QNetworkAccessManager::connectToHost().
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa preconnectCount()
+*/
+bool QHttpConnectionPoolConfiguration::setPreconnectCount(int count)
+{
+    if (count < 1) {
+        qWarning("QHttpConnectionPoolConfiguration: invalid preconnect count %d", count);
+        return false;
+    }
+
+    d->preconnectCount = count;
+    return true;
+}
+
+/*!
+    Returns the number of connections opened by
+    QNetworkAccessManager::connectToHost(). The default is 1.
+*/
+int QHttpConnectionPoolConfiguration::preconnectCount() const
+{
+    return d->preconnectCount;
+}
+
+/*!
+    Swaps this configuration with the \a other configuration.
+*/
+void QHttpConnectionPoolConfiguration::swap(QHttpConnectionPoolConfiguration &other) noexcept
+{
+    d.swap(other.d);
+}
+
+/*!
+    \fn bool QHttpConnectionPoolConfiguration::operator==(const QHttpConnectionPoolConfiguration &lhs, const QHttpConnectionPoolConfiguration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs have the same pool parameters.
+*/
+
+/*!
+    \fn bool QHttpConnectionPoolConfiguration::operator!=(const QHttpConnectionPoolConfiguration &lhs, const QHttpConnectionPoolConfiguration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs do not have the same pool
+    parameters.
+*/
+
+/*!
+    \internal
+*/
+bool QHttpConnectionPoolConfiguration::isEqual(const QHttpConnectionPoolConfiguration &other) const noexcept
+{
+    if (d == other.d)
+        return true;
+
+    return d->maximumConnectionsPerHost == other.d->maximumConnectionsPerHost
+           && d->maximumHttp2ConnectionsPerHost == other.d->maximumHttp2ConnectionsPerHost
+           && d->maximumIdleConnections == other.d->maximumIdleConnections
+           && d->idleTimeout == other.d->idleTimeout
+           && d->preconnectCount == other.d->preconnectCount;
+}
+
+/*!
+    \class QHttpConnectionPoolStatistics
+    \brief The QHttpConnectionPoolStatistics class describes the activity
+    of the HTTP connection pool of a QNetworkAccessManager.
+    \since 6.1
+
+    \reentrant
+    \inmodule QtNetwork
+    \ingroup network
+    \ingroup shared
+
+    The counters accumulate from the creation of the QNetworkAccessManager;
+    QNetworkAccessManager::clearConnectionCache() closes the pooled
+    connections but does not reset them. Comparing requestCount() with
+    connectionsOpened() shows how well connections are reused.
+
+    \sa QNetworkAccessManager::connectionPoolStatistics(),
+        QHttpConnectionPoolConfiguration
+*/
+
+/*!
+    Constructs an empty statistics object, with all counters set to zero.
+*/
+QHttpConnectionPoolStatistics::QHttpConnectionPoolStatistics()
+    : d(new QHttpConnectionPoolStatisticsPrivate)
+{
+}
+
+/*!
+    \internal
+*/
+QHttpConnectionPoolStatistics::QHttpConnectionPoolStatistics(QHttpConnectionPoolStatisticsPrivate *dd)
+    : d(dd)
+{
+}
+
+/*!
+    Copy-constructs this QHttpConnectionPoolStatistics.
+*/
+QHttpConnectionPoolStatistics::QHttpConnectionPoolStatistics(const QHttpConnectionPoolStatistics &) = default;
+
+/*!
+    Move-constructs this QHttpConnectionPoolStatistics from \a other
+*/
+QHttpConnectionPoolStatistics::QHttpConnectionPoolStatistics(QHttpConnectionPoolStatistics &&other) noexcept
+{
+    swap(other);
+}
+
+/*!
+    Copy-assigns \a other to this QHttpConnectionPoolStatistics.
+*/
+QHttpConnectionPoolStatistics &QHttpConnectionPoolStatistics::operator=(const QHttpConnectionPoolStatistics &) = default;
+
+/*!
+    Move-assigns \a other to this QHttpConnectionPoolStatistics.
+*/
+QHttpConnectionPoolStatistics &QHttpConnectionPoolStatistics::operator=(QHttpConnectionPoolStatistics &&) noexcept = default;
+
+/*!
+    Destructor.
+*/
+QHttpConnectionPoolStatistics::~QHttpConnectionPoolStatistics()
+{
+}
+
+/*!
+    Returns the number of HTTP requests that were handed to the pool.
+*/
+quint64 QHttpConnectionPoolStatistics::requestCount() const
+{
+    return d->requestCount;
+}
+
+/*!
+    Returns the number of connections the pool has started to open,
+    including the connection attempts made for
+    QNetworkAccessManager::connectToHost().
+*/
+quint64 QHttpConnectionPoolStatistics::connectionsOpened() const
+{
+    return d->connectionsOpened;
+}
+
+/*!
+    Returns the number of HTTP/2 connections that were opened because
+    all existing connections to the host had reached the server's limit
+    of concurrent streams.
+
+    \sa QHttpConnectionPoolConfiguration::setMaximumHttp2ConnectionsPerHost()
+*/
+quint64 QHttpConnectionPoolStatistics::additionalHttp2Connections() const
+{
+    return d->additionalHttp2Connections;
+}
+
+/*!
+    Returns the number of connections closed because they stayed idle
+    longer than the idle timeout.
+
+    \sa QHttpConnectionPoolConfiguration::setIdleTimeout()
+*/
+quint64 QHttpConnectionPoolStatistics::expiredConnections() const
+{
+    return d->expiredConnections;
+}
+
+/*!
+    Returns the number of idle connections closed to stay within the
+    maximum number of idle connections.
+
+    \sa QHttpConnectionPoolConfiguration::setMaximumIdleConnections()
+*/
+quint64 QHttpConnectionPoolStatistics::evictedConnections() const
+{
+    return d->evictedConnections;
+}
+
+/*!
+    Returns the number of connections that are currently open but not
+    used by any request.
+*/
+int QHttpConnectionPoolStatistics::idleConnections() const
+{
+    return d->idleConnections;
+}
+
+/*!
+    Swaps this statistics object with \a other.
+*/
+void QHttpConnectionPoolStatistics::swap(QHttpConnectionPoolStatistics &other) noexcept
+{
+    d.swap(other.d);
+}
+
+QT_END_NAMESPACE
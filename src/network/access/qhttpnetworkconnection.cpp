@@ -102,13 +102,17 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                     || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+                     ? 1 : connectionCount)
+  , channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
   , preConnectRequests(0)
   , connectionType(type)
 {
+    Q_ASSERT(channelCount >= activeChannelCount);
     channels = new QHttpNetworkConnectionChannel[channelCount];
 }
 
@@ -1507,6 +1511,56 @@ void QHttpNetworkConnection::setPeerVerifyName(const QString &peerName)
     d->peerVerifyName = peerName;
 }
 
+void QHttpNetworkConnection::setPoolCounters(const QSharedPointer<QNetworkConnectionPoolCounters> &counters)
+{
+    Q_D(QHttpNetworkConnection);
+    d->poolCounters = counters;
+}
+
+// The number of sockets that are connected or on their way there
+int QHttpNetworkConnection::openChannelCount() const
+{
+    Q_D(const QHttpNetworkConnection);
+    int count = 0;
+    for (int i = 0; i < d->channelCount; ++i) {
+        const QAbstractSocket *socket = d->channels[i].socket;
+        if (socket && socket->state() != QAbstractSocket::UnconnectedState)
+            ++count;
+    }
+    return count;
+}
+
+// True if an HTTP/2 connection has as many requests in flight or waiting
+// for a stream as the peer allows concurrent streams. HTTP/1 connections
+// queue requests for their channels instead and are never saturated.
+bool QHttpNetworkConnection::isHttp2Saturated() const
+{
+    Q_D(const QHttpNetworkConnection);
+    if (d->connectionType != ConnectionTypeHTTP2 && d->connectionType != ConnectionTypeHTTP2Direct)
+        return false;
+
+    const QHttpNetworkConnectionChannel &channel = d->channels[0];
+    quint32 load = quint32(channel.h2RequestsToSend.size());
+    if (const QAbstractProtocolHandler *handler = channel.protocolHandler.data())
+        load += handler->activeStreamCount();
+    return load >= http2StreamLimit();
+}
+
+quint32 QHttpNetworkConnection::http2StreamLimit() const
+{
+    Q_D(const QHttpNetworkConnection);
+    const QAbstractProtocolHandler *handler = d->channels[0].protocolHandler.data();
+    if (const quint32 peerLimit = handler ? handler->maxConcurrentStreamCount() : 0)
+        return qMin(peerLimit, d->http2StreamLimitHint);
+    return d->http2StreamLimitHint;
+}
+
+void QHttpNetworkConnection::setHttp2StreamLimitHint(quint32 limit)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http2StreamLimitHint = limit;
+}
+
 void QHttpNetworkConnection::onlineStateChanged(bool isOnline)
 {
     Q_D(QHttpNetworkConnection);
@@ -69,6 +69,7 @@
 #include <private/qhttpnetworkrequest_p.h>
 #include <private/qhttpnetworkreply_p.h>
 #include <private/qnetconmonitor_p.h>
+#include <private/qnetworkaccesscache_p.h>
 #include <private/http2protocol_p.h>
 
 #include <private/qhttpnetworkconnectionchannel_p.h>
@@ -147,6 +148,13 @@ public:
     QString peerVerifyName() const;
     void setPeerVerifyName(const QString &peerName);
 
+    // Connection pool support
+    void setPoolCounters(const QSharedPointer<QNetworkConnectionPoolCounters> &counters);
+    int openChannelCount() const;
+    bool isHttp2Saturated() const;
+    quint32 http2StreamLimit() const;
+    void setHttp2StreamLimitHint(quint32 limit);
+
 public slots:
     void onlineStateChanged(bool isOnline);
 
@@ -281,6 +289,12 @@ public:
     QHttp2Configuration http2Parameters;
 
     QString peerVerifyName;
+
+    QSharedPointer<QNetworkConnectionPoolCounters> poolCounters;
+    // The concurrent streams limit another connection to the same
+    // host has learned, until our peer announces its own:
+    quint32 http2StreamLimitHint = Http2::maxConcurrentStreams;
+
     // If network status monitoring is enabled, we activate connectionMonitor
     // as soons as one of channels managed to connect to host (and we
     // have a pair of addresses (us,peer).
@@ -330,6 +330,9 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
         // connect to the host if not already connected.
         state = QHttpNetworkConnectionChannel::ConnectingState;
         pendingEncrypt = ssl;
+#ifndef QT_NO_SSL
+        requestSentEarly = false;
+#endif
 
         // reset state
         pipeliningSupported = PipeliningSupportUnknown;
@@ -358,6 +361,9 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
         QString connectHost = connection->d_func()->hostName;
         quint16 connectPort = connection->d_func()->port;
 
+        if (const auto &counters = connection->d_func()->poolCounters)
+            counters->connectionsOpened.fetchAndAddRelaxed(1);
+
 #ifndef QT_NO_NETWORKPROXY
         // HTTPS always use transparent proxy.
         if (connection->d_func()->networkProxy.type() != QNetworkProxy::NoProxy && !ssl) {
@@ -408,6 +414,8 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
             // the QHttpNetworkReply anyway, so let's grow only that and not
             // here and there.
             socket->setReadBufferSize(64*1024);
+
+            sendRequestEarly(sslSocket);
 #else
             // Need to dequeue the request so that we can emit the error.
             if (!reply)
@@ -1180,6 +1188,63 @@ void QHttpNetworkConnectionChannel::emitFinishedWithError(QNetworkReply::Network
 }
 
 #ifndef QT_NO_SSL
+/*!
+    \internal
+
+    Pairs this connecting channel with the next request and writes its
+    header right away, so QSslSocket can send it as TLS 1.3 early data if it
+    resumes a session that allows it (see QSslSessionCache). Otherwise the
+    socket keeps the header until the handshake is done, just as if we had
+    written it from _q_encrypted().
+
+    The server may process early data twice if an attacker replays it, so
+    this is only done when the application opted in through the
+    "Qt-early-data" backend configuration option, and only for idempotent
+    requests without a body going straight to an HTTP/1 server.
+*/
+void QHttpNetworkConnectionChannel::sendRequestEarly(QSslSocket *sslSocket)
+{
+    if (reply || connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP)
+        return;
+    // With both IPv4 and IPv6 available, two channels race and the request
+    // must go to the one that wins, see _q_connected().
+    const auto networkLayerState = connection->d_func()->networkLayerState;
+    if (networkLayerState != QHttpNetworkConnectionPrivate::IPv4
+        && networkLayerState != QHttpNetworkConnectionPrivate::IPv6) {
+        return;
+    }
+#ifndef QT_NO_NETWORKPROXY
+    if (connection->d_func()->networkProxy.type() != QNetworkProxy::NoProxy
+        || connection->transparentProxy().type() != QNetworkProxy::NoProxy) {
+        return;
+    }
+#endif
+    const QSslConfiguration sslConfiguration = sslSocket->sslConfiguration();
+    if (!sslConfiguration.backendConfiguration().value("Qt-early-data").toBool()
+        || sslConfiguration.allowedNextProtocols().contains(QSslConfiguration::ALPNProtocolHTTP2)) {
+        return;
+    }
+
+    const QHttpNetworkRequest next = connection->d_func()->predictNextRequest();
+    switch (next.operation()) {
+    case QHttpNetworkRequest::Get:
+    case QHttpNetworkRequest::Head:
+    case QHttpNetworkRequest::Options:
+        break;
+    default:
+        return;
+    }
+    if (next.uploadByteDevice() || !next.url().userInfo().isEmpty())
+        return;
+
+    if (!connection->d_func()->dequeueRequest(socket) || !reply)
+        return;
+    if (request.withCredentials())
+        connection->d_func()->createAuthorization(socket, request);
+    socket->write(QHttpNetworkRequestPrivate::header(request, false));
+    requestSentEarly = true;
+}
+
 void QHttpNetworkConnectionChannel::_q_encrypted()
 {
     QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
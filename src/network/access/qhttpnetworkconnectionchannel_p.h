@@ -133,6 +133,8 @@ public:
     void ignoreSslErrors(const QList<QSslError> &errors);
     void setSslConfiguration(const QSslConfiguration &config);
     void requeueHttp2Requests(); // when we wanted HTTP/2 but got HTTP/1.1
+    void sendRequestEarly(QSslSocket *sslSocket);
+    bool requestSentEarly = false; // the header went out before the handshake completed
 #endif
     // to emit the signal for all in-flight replies:
     void emitFinishedWithError(QNetworkReply::NetworkError error, const char *message);
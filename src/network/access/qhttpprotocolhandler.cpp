@@ -292,6 +292,16 @@ bool QHttpProtocolHandler::sendRequest()
         replyPrivate->autoDecompress = m_channel->request.d->autoDecompress;
         replyPrivate->pipeliningUsed = false;
 
+#ifndef QT_NO_SSL
+        if (qExchange(m_channel->requestSentEarly, false)) {
+            // The header went out with the handshake, see
+            // QHttpNetworkConnectionChannel::sendRequestEarly().
+            m_channel->state = QHttpNetworkConnectionChannel::WaitingState;
+            sendRequest(); //recurse
+            break;
+        }
+#endif
+
         // if the url contains authentication parameters, use the new ones
         // both channels will use the new authentication parameters
         if (!m_channel->request.url().userInfo().isEmpty() && m_channel->request.withCredentials()) {
@@ -0,0 +1,500 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserver_p.h"
+#include "qhttpserverconnection_p.h"
+#include "qhttp2serverconnection_p.h"
+
+#include <QtNetwork/qtcpsocket.h>
+#if QT_CONFIG(ssl)
+#include <QtNetwork/qsslsocket.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+QByteArray joinedHeaderValues(const QList<QPair<QByteArray, QByteArray>> &headers,
+                              const QByteArray &name)
+{
+    const QByteArray lowerName = name.toLower();
+    // RFC 7540, 8.1.2.5: cookies are split into separate fields in HTTP/2
+    const char *separator = lowerName == "cookie" ? "; " : ", ";
+    QByteArray value;
+    bool found = false;
+    for (const auto &header : headers) {
+        if (header.first != lowerName)
+            continue;
+        if (found)
+            value += separator;
+        value += header.second;
+        found = true;
+    }
+    return value;
+}
+
+// RFC 7230, 3.2.6: token = 1*tchar
+bool isToken(const QByteArray &name)
+{
+    if (name.isEmpty())
+        return false;
+    for (char c : name) {
+        if (!(c >= 'a' && c <= 'z') && !(c >= 'A' && c <= 'Z') && !(c >= '0' && c <= '9')
+            && !(c && std::strchr("!#$%&'*+-.^_`|~", c))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns whether the field can be sent as it is, warns otherwise. Line
+// breaks in a value would let it inject fields or a whole response.
+bool checkField(const char *function, const QByteArray &name, const QByteArray &value)
+{
+    if (!isToken(name)) {
+        qWarning("QHttpServerResponse::%s: invalid field name \"%s\"", function,
+                 name.toPercentEncoding().constData());
+        return false;
+    }
+    if (value.contains('\r') || value.contains('\n') || value.contains('\0')) {
+        qWarning("QHttpServerResponse::%s: invalid value for field \"%s\"", function,
+                 name.constData());
+        return false;
+    }
+    if (name.compare("content-length", Qt::CaseInsensitive) == 0) {
+        const bool digits = !value.isEmpty() && value.size() <= 18
+                            && std::all_of(value.cbegin(), value.cend(), [](char c) {
+            return c >= '0' && c <= '9';
+        });
+        if (!digits) {
+            qWarning("QHttpServerResponse::%s: invalid value for field \"%s\"", function,
+                     name.constData());
+            return false;
+        }
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+/*!
+    \class QHttpServer
+    \internal
+
+    \brief The QHttpServer class accepts HTTP/1.1 and HTTP/2 connections.
+
+    QHttpServer listens like QTcpServer, and emits newRequest() once the
+    header of a request was received, passing the request, a read-only
+    QIODevice that streams its body, and the response, a write-only QIODevice.
+    Both are owned by the connection: they are deleted once the response was
+    passed to the socket and the body of the request was received, or once
+    the connection is lost, which the aborted() signals report.
+
+    HTTP/1.1 connections are kept alive and may pipeline requests; their
+    responses are sent in order. A response without a Content-Length field
+    uses chunked transfer coding. HTTP/2 is negotiated with ALPN when an SSL
+    configuration is set, and used in clear text when the client upgrades an
+    HTTP/1.1 request with "Upgrade: h2c" or starts with the connection preface
+    (prior knowledge).
+
+    Neither direction buffers without bounds: bytesToWrite() of a response
+    grows while the socket cannot keep up, or while an HTTP/2 peer's flow
+    control window is exhausted, and bytesWritten() reports its progress. The
+    connection stops reading a request body once requestBodyBufferSize()
+    bytes of it are waiting to be read.
+*/
+
+QHttpServer::QHttpServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    // The stream window bounds what an HTTP/2 client can send before the
+    // body is read; the session window is returned as soon as data arrives,
+    // so it only has to be large enough not to stall uploads
+    m_http2Configuration.setStreamReceiveWindowSize(quint32(m_requestBodyBufferSize));
+    m_http2Configuration.setSessionReceiveWindowSize(Http2::maxSessionReceiveWindowSize);
+}
+
+QHttpServer::~QHttpServer()
+{
+    close();
+}
+
+/*!
+    Enables or disables HTTP/2. It is enabled by default.
+*/
+void QHttpServer::setHttp2Enabled(bool enable)
+{
+    m_http2Enabled = enable;
+}
+
+/*!
+    Sets the HTTP/2 parameters of new connections to \a configuration. The
+    stream receive window size bounds how much of a request body a client can
+    send before the server reads it.
+*/
+void QHttpServer::setHttp2Configuration(const QHttp2Configuration &configuration)
+{
+    m_http2Configuration = configuration;
+}
+
+#if QT_CONFIG(ssl)
+/*!
+    Makes the server accept TLS connections with \a configuration, which has
+    to contain a local certificate and private key. When HTTP/2 is enabled it
+    is offered with ALPN.
+*/
+void QHttpServer::setSslConfiguration(const QSslConfiguration &configuration)
+{
+    m_sslConfiguration = configuration;
+}
+#endif
+
+/*!
+    Sets the time after which an idle connection is closed to \a msecs.
+*/
+void QHttpServer::setKeepAliveTimeout(int msecs)
+{
+    m_keepAliveTimeout = msecs;
+}
+
+/*!
+    Sets the number of bytes of a request body that are buffered until it is
+    read to \a size. It is also the stream receive window size of HTTP/2.
+*/
+void QHttpServer::setRequestBodyBufferSize(qint64 size)
+{
+    m_requestBodyBufferSize = qBound(qint64(Http2::minPayloadLimit), size,
+                                     qint64(Http2::maxSessionReceiveWindowSize));
+    m_http2Configuration.setStreamReceiveWindowSize(quint32(m_requestBodyBufferSize));
+}
+
+/*!
+    Sets the number of requests on an HTTP/1.1 connection that may wait for
+    their response before the connection stops reading more to \a count.
+*/
+void QHttpServer::setMaxPipelinedRequests(int count)
+{
+    m_maxPipelinedRequests = qMax(count, 1);
+}
+
+/*!
+    Sets the number of streams an HTTP/2 client may have open at the same
+    time to \a count. It is announced as SETTINGS_MAX_CONCURRENT_STREAMS;
+    streams beyond it are refused.
+*/
+void QHttpServer::setMaxConcurrentStreams(int count)
+{
+    m_maxConcurrentStreams = qBound(1, count, int(Http2::maxPeerConcurrentStreams));
+}
+
+/*!
+    Returns the number of open connections.
+*/
+int QHttpServer::connectionCount() const
+{
+    return int(findChildren<QHttpServerConnection *>(QString(), Qt::FindDirectChildrenOnly).size());
+}
+
+void QHttpServer::incomingConnection(qintptr socketDescriptor)
+{
+#if QT_CONFIG(ssl)
+    if (!m_sslConfiguration.isNull()) {
+        auto socket = new QSslSocket(this);
+        QSslConfiguration configuration = m_sslConfiguration;
+        QList<QByteArray> protocols;
+        if (m_http2Enabled)
+            protocols.append(QSslConfiguration::ALPNProtocolHTTP2);
+        protocols.append(QSslConfiguration::NextProtocolHttp1_1);
+        configuration.setAllowedNextProtocols(protocols);
+        socket->setSslConfiguration(configuration);
+        if (!socket->setSocketDescriptor(socketDescriptor)) {
+            delete socket;
+            return;
+        }
+        connect(socket, &QSslSocket::encrypted, this, [this, socket]() {
+            socket->disconnect(this);
+            const QByteArray protocol = socket->sslConfiguration().nextNegotiatedProtocol();
+            startConnection(socket, protocol == QSslConfiguration::ALPNProtocolHTTP2);
+        });
+        // the handshake failed
+        connect(socket, &QAbstractSocket::disconnected, this, [socket]() {
+            socket->deleteLater();
+        });
+        socket->startServerEncryption();
+        return;
+    }
+#endif
+
+    auto socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+    startConnection(socket, false);
+}
+
+void QHttpServer::startConnection(QAbstractSocket *socket, bool http2)
+{
+    if (http2)
+        (new QHttp2ServerConnection(socket, this))->start();
+    else
+        (new QHttp1ServerConnection(socket, this))->start();
+}
+
+/*!
+    \class QHttpServerRequest
+    \internal
+
+    \brief The QHttpServerRequest class is a request received by QHttpServer.
+
+    The device streams the body of the request: readyRead() is emitted as it
+    arrives and readChannelFinished() once it is complete.
+*/
+
+QHttpServerRequest::QHttpServerRequest(QHttpServerConnection *connection, Protocol protocol)
+    : QIODevice(connection), m_connection(connection), m_protocol(protocol)
+{
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QHttpServerRequest::~QHttpServerRequest()
+{
+}
+
+/*!
+    Returns the URL of the request, built from its target and the authority
+    it was sent to.
+*/
+QUrl QHttpServerRequest::url() const
+{
+    if (m_target.startsWith('/'))
+        return QUrl::fromEncoded(m_scheme + "://" + m_authority + m_target);
+    return QUrl::fromEncoded(m_target);
+}
+
+/*!
+    Returns the value of the header field \a name, or the values of all fields
+    with that name joined with commas. Names are compared case-insensitively.
+*/
+QByteArray QHttpServerRequest::header(const QByteArray &name) const
+{
+    return joinedHeaderValues(m_headers, name);
+}
+
+bool QHttpServerRequest::isSequential() const
+{
+    return true;
+}
+
+qint64 QHttpServerRequest::bytesAvailable() const
+{
+    return m_body.byteAmount() + QIODevice::bytesAvailable();
+}
+
+bool QHttpServerRequest::atEnd() const
+{
+    return m_bodyComplete && bytesAvailable() == 0;
+}
+
+qint64 QHttpServerRequest::readData(char *data, qint64 maxSize)
+{
+    const qint64 size = m_body.read(data, maxSize);
+    if (size > 0 && m_connection)
+        m_connection->requestBodyRead(this, size);
+    if (size == 0 && (m_bodyComplete || m_aborted))
+        return -1;
+    return size;
+}
+
+qint64 QHttpServerRequest::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+/*!
+    \class QHttpServerResponse
+    \internal
+
+    \brief The QHttpServerResponse class is the response to a QHttpServerRequest.
+
+    The header is sent with the first write(), with writeHeaders() or with
+    end(). Unless a Content-Length field was set, the body of an HTTP/1.1
+    response is sent in chunks as it is written. bytesToWrite() returns how
+    much of the body the connection holds because the socket or the peer's
+    flow control cannot take it yet; finished() is emitted once end() was
+    called and all of the response was passed to the socket.
+
+    Field names must be tokens and values must not contain line breaks;
+    setHeader() and addHeader() ignore other fields with a warning. Once the
+    header is sent, a body longer than its Content-Length field is refused,
+    and a shorter one makes the connection close the stream (HTTP/2) or the
+    connection (HTTP/1) instead of ending the response normally.
+*/
+
+QHttpServerResponse::QHttpServerResponse(QHttpServerConnection *connection,
+                                         QHttpServerRequest *request)
+    : QIODevice(connection), m_connection(connection), m_request(request)
+{
+    open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+QHttpServerResponse::~QHttpServerResponse()
+{
+}
+
+void QHttpServerResponse::setStatusCode(int code)
+{
+    if (m_headersSent) {
+        qWarning("QHttpServerResponse::setStatusCode: the header was already sent");
+        return;
+    }
+    m_statusCode = code;
+}
+
+void QHttpServerResponse::setHeader(const QByteArray &name, const QByteArray &value)
+{
+    if (!checkField("setHeader", name, value))
+        return;
+    const QByteArray lowerName = name.toLower();
+    m_headers.erase(std::remove_if(m_headers.begin(), m_headers.end(),
+                                   [&lowerName](const QPair<QByteArray, QByteArray> &header) {
+        return header.first == lowerName;
+    }), m_headers.end());
+    m_headers.append({ lowerName, value });
+}
+
+void QHttpServerResponse::addHeader(const QByteArray &name, const QByteArray &value)
+{
+    if (!checkField("addHeader", name, value))
+        return;
+    if (name.compare("content-length", Qt::CaseInsensitive) == 0
+        && !header("content-length").isNull()) {
+        qWarning("QHttpServerResponse::addHeader: the Content-Length field is already set");
+        return;
+    }
+    m_headers.append({ name.toLower(), value });
+}
+
+QByteArray QHttpServerResponse::header(const QByteArray &name) const
+{
+    return joinedHeaderValues(m_headers, name);
+}
+
+/*!
+    Sends the status code and header fields, if they were not sent yet.
+*/
+void QHttpServerResponse::writeHeaders()
+{
+    if (m_headersSent || m_aborted || !m_connection)
+        return;
+    m_headersSent = true;
+    bool ok = false;
+    const qint64 contentLength = header("content-length").toLongLong(&ok);
+    if (ok && hasBody() && m_request->method() != "HEAD")
+        m_contentLength = contentLength;
+    m_connection->sendResponseHeaders(this);
+}
+
+/*!
+    Writes \a data, if any, and finishes the response. If the header was not
+    sent yet and has no Content-Length field, the size of \a data is sent as
+    the content length.
+*/
+void QHttpServerResponse::end(const QByteArray &data)
+{
+    if (m_ended || m_aborted || !m_connection)
+        return;
+    if (!m_headersSent && hasBody() && header("content-length").isNull()
+        && m_request->method() != "HEAD") {
+        setHeader("content-length", QByteArray::number(data.size()));
+    }
+    if (!data.isEmpty())
+        write(data);
+    writeHeaders();
+    if (m_contentLength != -1 && m_bodyBytes < m_contentLength)
+        qWarning("QHttpServerResponse::end: the body is shorter than the Content-Length field");
+    m_ended = true;
+    m_connection->endResponse(this);
+}
+
+bool QHttpServerResponse::isSequential() const
+{
+    return true;
+}
+
+qint64 QHttpServerResponse::bytesToWrite() const
+{
+    return m_connection ? m_connection->pendingResponseBytes(this) : 0;
+}
+
+qint64 QHttpServerResponse::readData(char *, qint64)
+{
+    return -1;
+}
+
+qint64 QHttpServerResponse::writeData(const char *data, qint64 maxSize)
+{
+    if (m_ended || m_aborted || !m_connection) {
+        setErrorString(m_ended ? tr("The response was already ended")
+                               : tr("The connection was closed"));
+        return -1;
+    }
+    writeHeaders();
+    if (m_contentLength != -1 && maxSize > m_contentLength - m_bodyBytes) {
+        qWarning("QHttpServerResponse: the body is longer than the Content-Length field");
+        setErrorString(tr("The body is longer than the Content-Length field"));
+        return -1;
+    }
+    m_bodyBytes += maxSize;
+    if (maxSize > 0)
+        m_connection->writeResponseBody(this, data, maxSize);
+    return maxSize;
+}
+
+// Returns whether the status code allows a body (RFC 7230, 3.3).
+bool QHttpServerResponse::hasBody() const
+{
+    return m_statusCode >= 200 && m_statusCode != 204 && m_statusCode != 304;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,251 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVER_P_H
+#define QHTTPSERVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/qhostaddress.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qhttp2configuration.h>
+#if QT_CONFIG(ssl)
+#include <QtNetwork/qsslconfiguration.h>
+#endif
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qurl.h>
+
+#include <QtCore/private/qbytedata_p.h>
+#include <QtNetwork/private/http2protocol_p.h>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class QHttpServerConnection;
+class QHttpServerResponse;
+
+class Q_NETWORK_EXPORT QHttpServerRequest : public QIODevice
+{
+    Q_OBJECT
+public:
+    enum class Protocol {
+        Http1_0,
+        Http1_1,
+        Http2
+    };
+
+    ~QHttpServerRequest() override;
+
+    Protocol protocol() const { return m_protocol; }
+    QByteArray method() const { return m_method; }
+    QByteArray target() const { return m_target; }
+    QUrl url() const;
+
+    // field names are lower case
+    QList<QPair<QByteArray, QByteArray>> headers() const { return m_headers; }
+    QByteArray header(const QByteArray &name) const;
+    qint64 contentLength() const { return m_contentLength; }
+
+    QHostAddress peerAddress() const { return m_peerAddress; }
+    quint16 peerPort() const { return m_peerPort; }
+    bool isEncrypted() const { return m_scheme == "https"; }
+
+    bool isBodyComplete() const { return m_bodyComplete; }
+    bool isAborted() const { return m_aborted; }
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+    bool atEnd() const override;
+
+Q_SIGNALS:
+    void aborted();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    friend class QHttpServerConnection;
+    QHttpServerRequest(QHttpServerConnection *connection, Protocol protocol);
+
+    QPointer<QHttpServerConnection> m_connection;
+    QHttpServerResponse *m_response = nullptr;
+    Protocol m_protocol;
+    QByteArray m_method;
+    QByteArray m_target;
+    QByteArray m_scheme;
+    QByteArray m_authority;
+    QList<QPair<QByteArray, QByteArray>> m_headers;
+    qint64 m_contentLength = -1;
+    QHostAddress m_peerAddress;
+    quint16 m_peerPort = 0;
+    quint32 m_streamID = 0;
+    QByteDataBuffer m_body;
+    bool m_bodyComplete = false;
+    bool m_aborted = false;
+};
+
+class Q_NETWORK_EXPORT QHttpServerResponse : public QIODevice
+{
+    Q_OBJECT
+public:
+    ~QHttpServerResponse() override;
+
+    QHttpServerRequest *request() const { return m_request; }
+
+    void setStatusCode(int code);
+    int statusCode() const { return m_statusCode; }
+
+    // replaces all fields with the same name, names are compared case-insensitively
+    void setHeader(const QByteArray &name, const QByteArray &value);
+    void addHeader(const QByteArray &name, const QByteArray &value);
+    QByteArray header(const QByteArray &name) const;
+    QList<QPair<QByteArray, QByteArray>> headers() const { return m_headers; }
+
+    void writeHeaders();
+    bool headersSent() const { return m_headersSent; }
+
+    void end(const QByteArray &data = QByteArray());
+    bool isEnded() const { return m_ended; }
+    bool isFinished() const { return m_finished; }
+    bool isAborted() const { return m_aborted; }
+
+    bool isSequential() const override;
+    qint64 bytesToWrite() const override;
+
+Q_SIGNALS:
+    void finished();
+    void aborted();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    friend class QHttpServerConnection;
+    QHttpServerResponse(QHttpServerConnection *connection, QHttpServerRequest *request);
+
+    bool hasBody() const;
+
+    QPointer<QHttpServerConnection> m_connection;
+    QHttpServerRequest *m_request;
+    int m_statusCode = 200;
+    QList<QPair<QByteArray, QByteArray>> m_headers;
+    qint64 m_contentLength = -1; // the body must match it, once the header is sent
+    qint64 m_bodyBytes = 0;
+    qint64 m_unreportedBytes = 0;
+    bool m_headersSent = false;
+    bool m_ended = false;
+    bool m_drained = false;
+    bool m_finished = false;
+    bool m_aborted = false;
+};
+
+class Q_NETWORK_EXPORT QHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit QHttpServer(QObject *parent = nullptr);
+    ~QHttpServer() override;
+
+    void setHttp2Enabled(bool enable);
+    bool isHttp2Enabled() const { return m_http2Enabled; }
+
+    void setHttp2Configuration(const QHttp2Configuration &configuration);
+    QHttp2Configuration http2Configuration() const { return m_http2Configuration; }
+
+#if QT_CONFIG(ssl)
+    void setSslConfiguration(const QSslConfiguration &configuration);
+    QSslConfiguration sslConfiguration() const { return m_sslConfiguration; }
+#endif
+
+    void setKeepAliveTimeout(int msecs);
+    int keepAliveTimeout() const { return m_keepAliveTimeout; }
+
+    void setRequestBodyBufferSize(qint64 size);
+    qint64 requestBodyBufferSize() const { return m_requestBodyBufferSize; }
+
+    void setMaxPipelinedRequests(int count);
+    int maxPipelinedRequests() const { return m_maxPipelinedRequests; }
+
+    void setMaxConcurrentStreams(int count);
+    int maxConcurrentStreams() const { return m_maxConcurrentStreams; }
+
+    int connectionCount() const;
+
+Q_SIGNALS:
+    void newRequest(QHttpServerRequest *request, QHttpServerResponse *response);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    void startConnection(QAbstractSocket *socket, bool http2);
+
+    QHttp2Configuration m_http2Configuration;
+#if QT_CONFIG(ssl)
+    QSslConfiguration m_sslConfiguration;
+#endif
+    qint64 m_requestBodyBufferSize = 1024 * 1024;
+    int m_keepAliveTimeout = 60 * 1000;
+    int m_maxPipelinedRequests = 16;
+    int m_maxConcurrentStreams = Http2::maxConcurrentStreams;
+    bool m_http2Enabled = true;
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVER_P_H
@@ -0,0 +1,1042 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpserverconnection_p.h"
+#include "qhttp2serverconnection_p.h"
+
+#include "http2/http2protocol_p.h"
+
+#if QT_CONFIG(ssl)
+#include <QtNetwork/qsslsocket.h>
+#endif
+
+#include <QtCore/qmetaobject.h>
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// RFC 7230 does not limit the size of a request header, we do:
+const qint64 MaxLineLength = 8 * 1024;
+const qint64 MaxHeaderSize = 64 * 1024;
+const int MaxHeaderFields = 100;
+// Bounds what the socket reads ahead of the parser, so that a client
+// sending a body nobody reads is throttled by TCP flow control:
+const qint64 SocketReadBufferSize = 64 * 1024;
+
+QByteArray reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 100: return QByteArrayLiteral("Continue");
+    case 101: return QByteArrayLiteral("Switching Protocols");
+    case 200: return QByteArrayLiteral("OK");
+    case 201: return QByteArrayLiteral("Created");
+    case 202: return QByteArrayLiteral("Accepted");
+    case 204: return QByteArrayLiteral("No Content");
+    case 206: return QByteArrayLiteral("Partial Content");
+    case 301: return QByteArrayLiteral("Moved Permanently");
+    case 302: return QByteArrayLiteral("Found");
+    case 303: return QByteArrayLiteral("See Other");
+    case 304: return QByteArrayLiteral("Not Modified");
+    case 307: return QByteArrayLiteral("Temporary Redirect");
+    case 308: return QByteArrayLiteral("Permanent Redirect");
+    case 400: return QByteArrayLiteral("Bad Request");
+    case 401: return QByteArrayLiteral("Unauthorized");
+    case 403: return QByteArrayLiteral("Forbidden");
+    case 404: return QByteArrayLiteral("Not Found");
+    case 405: return QByteArrayLiteral("Method Not Allowed");
+    case 408: return QByteArrayLiteral("Request Timeout");
+    case 411: return QByteArrayLiteral("Length Required");
+    case 413: return QByteArrayLiteral("Payload Too Large");
+    case 414: return QByteArrayLiteral("URI Too Long");
+    case 417: return QByteArrayLiteral("Expectation Failed");
+    case 431: return QByteArrayLiteral("Request Header Fields Too Large");
+    case 500: return QByteArrayLiteral("Internal Server Error");
+    case 501: return QByteArrayLiteral("Not Implemented");
+    case 503: return QByteArrayLiteral("Service Unavailable");
+    case 505: return QByteArrayLiteral("HTTP Version Not Supported");
+    default: return QByteArray();
+    }
+}
+
+QByteArray statusLine(int statusCode)
+{
+    return "HTTP/1.1 " + QByteArray::number(statusCode) + ' ' + reasonPhrase(statusCode) + "\r\n";
+}
+
+// Returns whether the comma-separated list \a value contains \a token.
+bool hasToken(const QByteArray &value, const char *token)
+{
+    for (const QByteArray &element : value.split(',')) {
+        if (element.trimmed().compare(token, Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool parseContentLength(const QByteArray &value, qint64 *length)
+{
+    if (value.isEmpty() || value.size() > 18)
+        return false;
+    for (char c : value) {
+        if (c < '0' || c > '9')
+            return false;
+    }
+    *length = value.toLongLong();
+    return true;
+}
+
+} // unnamed namespace
+
+/*!
+    \class QHttpServerConnection
+    \internal
+
+    \brief The QHttpServerConnection class is the base class of the HTTP/1.1
+    and HTTP/2 connections of QHttpServer.
+
+    It owns the socket and the requests and responses of the connection, and
+    reports the progress of responses asynchronously, so that a response never
+    emits bytesWritten() or finished() from within write() or end().
+*/
+
+QHttpServerConnection::QHttpServerConnection(QAbstractSocket *socket, QHttpServer *server)
+    : QObject(server),
+      m_socket(socket),
+      m_server(server),
+      m_http2Configuration(server->http2Configuration()),
+      m_requestBodyBufferSize(server->requestBodyBufferSize()),
+      m_keepAliveTimeout(server->keepAliveTimeout()),
+      m_maxPipelinedRequests(server->maxPipelinedRequests()),
+      m_http2Enabled(server->isHttp2Enabled())
+{
+    socket->setParent(this);
+    // Responses are written in few, large pieces; Nagle's algorithm would
+    // only hold back their ends and the small HTTP/2 control frames
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, &QIODevice::readyRead, this, &QHttpServerConnection::socketReadyRead);
+    connect(socket, &QIODevice::bytesWritten, this, &QHttpServerConnection::socketBytesWritten);
+    connect(socket, &QAbstractSocket::disconnected, this,
+            &QHttpServerConnection::socketDisconnected);
+}
+
+QHttpServerConnection::~QHttpServerConnection()
+{
+}
+
+// Hands the socket, and the responsibility for it, over to \a successor.
+void QHttpServerConnection::handOver(QHttpServerConnection *successor)
+{
+    Q_ASSERT(m_socket);
+    m_socket->disconnect(this);
+    m_socket->setParent(successor);
+    m_socket = nullptr;
+    deleteLater();
+}
+
+bool QHttpServerConnection::isEncrypted() const
+{
+#if QT_CONFIG(ssl)
+    if (auto sslSocket = qobject_cast<QSslSocket *>(m_socket))
+        return sslSocket->isEncrypted();
+#endif
+    return false;
+}
+
+QHttpServerRequest *QHttpServerConnection::createRequest(QHttpServerRequest::Protocol protocol)
+{
+    auto request = new QHttpServerRequest(this, protocol);
+    request->m_response = new QHttpServerResponse(this, request);
+    request->m_scheme = isEncrypted() ? QByteArrayLiteral("https") : QByteArrayLiteral("http");
+    request->m_peerAddress = m_socket->peerAddress();
+    request->m_peerPort = m_socket->peerPort();
+    return request;
+}
+
+void QHttpServerConnection::setRequestHeader(QHttpServerRequest *request, QByteArray method,
+                                             QByteArray target, QByteArray authority,
+                                             QList<QPair<QByteArray, QByteArray>> headers,
+                                             qint64 contentLength)
+{
+    request->m_method = std::move(method);
+    request->m_target = std::move(target);
+    request->m_authority = std::move(authority);
+    request->m_headers = std::move(headers);
+    request->m_contentLength = contentLength;
+}
+
+void QHttpServerConnection::setStreamID(QHttpServerRequest *request, quint32 streamID)
+{
+    request->m_streamID = streamID;
+}
+
+QHttpServerResponse *QHttpServerConnection::responseOf(const QHttpServerRequest *request)
+{
+    return request->m_response;
+}
+
+quint32 QHttpServerConnection::streamID(const QHttpServerRequest *request)
+{
+    return request->m_streamID;
+}
+
+void QHttpServerConnection::emitNewRequest(QHttpServerRequest *request)
+{
+    if (m_server)
+        emit m_server->newRequest(request, request->m_response);
+}
+
+void QHttpServerConnection::appendRequestBody(QHttpServerRequest *request, QByteArray &&data)
+{
+    Q_ASSERT(!request->m_bodyComplete);
+    request->m_body.append(std::move(data));
+    emit request->readyRead();
+}
+
+qint64 QHttpServerConnection::bufferedRequestBody(const QHttpServerRequest *request)
+{
+    return request->m_body.byteAmount();
+}
+
+void QHttpServerConnection::discardRequestBody(QHttpServerRequest *request)
+{
+    request->m_body.clear();
+}
+
+void QHttpServerConnection::finishRequestBody(QHttpServerRequest *request)
+{
+    if (request->m_bodyComplete)
+        return;
+    request->m_bodyComplete = true;
+    emit request->readChannelFinished();
+    releaseIfDone(request);
+}
+
+void QHttpServerConnection::responseBytesWritten(QHttpServerResponse *response, qint64 size)
+{
+    response->m_unreportedBytes += size;
+    scheduleProgressReport(response);
+}
+
+void QHttpServerConnection::responseDrained(QHttpServerResponse *response)
+{
+    response->m_drained = true;
+    scheduleProgressReport(response);
+}
+
+// Returns whether the response ended before the size its header announced.
+bool QHttpServerConnection::isResponseTruncated(const QHttpServerResponse *response)
+{
+    return response->m_contentLength != -1 && response->m_bodyBytes < response->m_contentLength;
+}
+
+void QHttpServerConnection::abortExchange(QHttpServerRequest *request)
+{
+    QHttpServerResponse *response = request->m_response;
+    const bool requestAborted = !request->m_bodyComplete && !request->m_aborted;
+    const bool responseAborted = !response->m_finished && !response->m_aborted;
+    request->m_aborted = true;
+    response->m_aborted = true;
+    if (requestAborted)
+        emit request->aborted();
+    if (responseAborted)
+        emit response->aborted();
+    request->deleteLater();
+    response->deleteLater();
+}
+
+void QHttpServerConnection::closeConnection()
+{
+    if (!m_socket)
+        return;
+    // flushes what was written before
+    m_socket->disconnectFromHost();
+}
+
+void QHttpServerConnection::scheduleProgressReport(QHttpServerResponse *response)
+{
+    if (!m_progressReports.contains(response))
+        m_progressReports.append(response);
+    if (!m_progressReportScheduled) {
+        m_progressReportScheduled = true;
+        QMetaObject::invokeMethod(this, &QHttpServerConnection::reportResponseProgress,
+                                  Qt::QueuedConnection);
+    }
+}
+
+void QHttpServerConnection::reportResponseProgress()
+{
+    m_progressReportScheduled = false;
+    const auto reports = std::move(m_progressReports);
+    m_progressReports.clear();
+    for (const QPointer<QHttpServerResponse> &response : reports) {
+        if (!response || response->m_aborted)
+            continue;
+        if (const qint64 size = std::exchange(response->m_unreportedBytes, 0))
+            emit response->bytesWritten(size);
+        if (response && response->m_drained && !response->m_finished) {
+            response->m_finished = true;
+            emit response->finished();
+            if (response)
+                releaseIfDone(response->m_request);
+        }
+    }
+}
+
+void QHttpServerConnection::releaseIfDone(QHttpServerRequest *request)
+{
+    QHttpServerResponse *response = request->m_response;
+    if (request->m_bodyComplete && response->m_finished) {
+        request->deleteLater();
+        response->deleteLater();
+    }
+}
+
+void QHttpServerConnection::socketDisconnected()
+{
+    const auto requests = findChildren<QHttpServerRequest *>(QString(), Qt::FindDirectChildrenOnly);
+    for (QHttpServerRequest *request : requests) {
+        if (!request->m_bodyComplete || !request->m_response->m_finished)
+            abortExchange(request);
+    }
+    deleteLater();
+}
+
+/*!
+    \class QHttp1ServerConnection
+    \internal
+
+    \brief The QHttp1ServerConnection class serves HTTP/1.0 and HTTP/1.1.
+
+    Requests are parsed straight from the socket, so that bytes following a
+    request header stay in the socket: a pipelined request is only parsed
+    once fewer than maxPipelinedRequests() responses are outstanding, and a
+    body is only read as long as less than requestBodyBufferSize() bytes of
+    it wait to be read. Responses are sent in the order of their requests;
+    the output of a response that cannot be sent yet is queued.
+*/
+
+QHttp1ServerConnection::QHttp1ServerConnection(QAbstractSocket *socket, QHttpServer *server)
+    : QHttpServerConnection(socket, server)
+{
+    m_idleTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, this, [this]() {
+        m_state = State::Closed;
+        closeConnection();
+    });
+}
+
+QHttp1ServerConnection::~QHttp1ServerConnection()
+{
+}
+
+void QHttp1ServerConnection::start()
+{
+    m_socket->setReadBufferSize(SocketReadBufferSize);
+    // Data may have arrived along with the end of a TLS handshake:
+    processInput();
+}
+
+void QHttp1ServerConnection::socketReadyRead()
+{
+    processInput();
+}
+
+void QHttp1ServerConnection::socketBytesWritten()
+{
+    flushOutput();
+}
+
+void QHttp1ServerConnection::processInput()
+{
+    if (m_processingInput || !m_socket || m_socket->state() != QAbstractSocket::ConnectedState)
+        return;
+
+    m_processingInput = true;
+    bool progress = true;
+    while (progress) {
+        switch (m_state) {
+        case State::RequestLine:
+            progress = parseRequestLine();
+            break;
+        case State::Headers:
+            progress = parseHeaders();
+            break;
+        case State::Body:
+        case State::ChunkData:
+            progress = readBody();
+            break;
+        case State::ChunkSize:
+            progress = parseChunkSize();
+            break;
+        case State::ChunkDataEnd:
+            progress = readChunkDataEnd();
+            break;
+        case State::Trailers:
+            progress = parseTrailers();
+            break;
+        case State::Closed:
+            progress = false;
+            break;
+        }
+    }
+    m_processingInput = false;
+    updateIdleTimer();
+}
+
+// Reads a line without its line break; fails the request if it is too long.
+bool QHttp1ServerConnection::readLine(QByteArray *line)
+{
+    if (!m_socket->canReadLine()) {
+        if (m_socket->bytesAvailable() > MaxLineLength)
+            failRequest(m_state == State::RequestLine ? 414 : 431);
+        return false;
+    }
+
+    *line = m_socket->readLine(MaxLineLength + 1);
+    if (!line->endsWith('\n')) {
+        failRequest(m_state == State::RequestLine ? 414 : 431);
+        return false;
+    }
+    line->chop(line->endsWith("\r\n") ? 2 : 1);
+    return true;
+}
+
+bool QHttp1ServerConnection::parseRequestLine()
+{
+    // Resumed once a response was sent:
+    if (m_exchanges.size() >= size_t(m_maxPipelinedRequests))
+        return false;
+    if (tryHttp2Preface())
+        return false;
+
+    QByteArray line;
+    if (!readLine(&line))
+        return false;
+    // RFC 7230, 3.5: ignore empty lines preceding a request
+    if (line.isEmpty())
+        return true;
+
+    const QList<QByteArray> parts = line.split(' ');
+    if (parts.size() != 3 || parts.at(0).isEmpty() || parts.at(1).isEmpty()) {
+        failRequest(400);
+        return false;
+    }
+
+    const QByteArray &version = parts.at(2);
+    if (version == "HTTP/1.1") {
+        m_protocol = QHttpServerRequest::Protocol::Http1_1;
+    } else if (version == "HTTP/1.0") {
+        m_protocol = QHttpServerRequest::Protocol::Http1_0;
+    } else {
+        failRequest(version.startsWith("HTTP/") ? 505 : 400);
+        return false;
+    }
+
+    m_method = parts.at(0);
+    m_target = parts.at(1);
+    m_headers.clear();
+    m_headerBytes = line.size();
+    m_state = State::Headers;
+    return true;
+}
+
+bool QHttp1ServerConnection::parseHeaders()
+{
+    QByteArray line;
+    while (readLine(&line)) {
+        if (line.isEmpty()) {
+            startRequest();
+            return true;
+        }
+
+        m_headerBytes += line.size();
+        if (m_headerBytes > MaxHeaderSize || m_headers.size() >= MaxHeaderFields) {
+            failRequest(431);
+            return false;
+        }
+
+        // RFC 7230, 3.2.4: obsolete line folding and whitespace
+        // before the colon are rejected
+        const int colon = line.indexOf(':');
+        if (colon <= 0 || line.at(0) == ' ' || line.at(0) == '\t'
+            || line.at(colon - 1) == ' ' || line.at(colon - 1) == '\t') {
+            failRequest(400);
+            return false;
+        }
+        m_headers.append({ line.left(colon).toLower(), line.mid(colon + 1).trimmed() });
+    }
+    return false;
+}
+
+void QHttp1ServerConnection::startRequest()
+{
+    ++m_requestCount;
+
+    QByteArray authority;
+    QByteArray connection;
+    QByteArray transferEncoding;
+    QByteArray expect;
+    qint64 contentLength = -1;
+    int hostCount = 0;
+    for (const auto &field : qAsConst(m_headers)) {
+        if (field.first == "host") {
+            authority = field.second;
+            ++hostCount;
+        } else if (field.first == "content-length") {
+            qint64 length = 0;
+            // RFC 7230, 3.3.2: repeated fields have to agree
+            if (!parseContentLength(field.second, &length)
+                || (contentLength != -1 && contentLength != length)) {
+                failRequest(400);
+                return;
+            }
+            contentLength = length;
+        } else if (field.first == "transfer-encoding") {
+            if (!transferEncoding.isEmpty())
+                transferEncoding += ", ";
+            transferEncoding += field.second;
+        } else if (field.first == "connection") {
+            if (!connection.isEmpty())
+                connection += ", ";
+            connection += field.second;
+        } else if (field.first == "expect") {
+            expect = field.second;
+        }
+    }
+
+    const bool http1_1 = m_protocol == QHttpServerRequest::Protocol::Http1_1;
+    // RFC 7230, 5.4
+    if (hostCount > 1 || (http1_1 && hostCount == 0)) {
+        failRequest(400);
+        return;
+    }
+
+    // RFC 7230, 3.3.3: a request with both framings could be smuggling
+    // another one past a proxy
+    const bool chunked = !transferEncoding.isEmpty();
+    if (chunked && contentLength != -1) {
+        failRequest(400);
+        return;
+    }
+    if (chunked && transferEncoding.trimmed().compare("chunked", Qt::CaseInsensitive) != 0) {
+        failRequest(501);
+        return;
+    }
+
+    const bool hasBody = chunked || contentLength > 0;
+    bool expectsContinue = false;
+    if (!expect.isEmpty()) {
+        if (expect.compare("100-continue", Qt::CaseInsensitive) != 0) {
+            failRequest(417);
+            return;
+        }
+        expectsContinue = http1_1 && hasBody;
+    }
+
+    if (tryUpgrade(authority, hasBody))
+        return;
+
+    m_request = createRequest(m_protocol);
+    setRequestHeader(m_request, std::move(m_method), std::move(m_target), authority,
+                     std::move(m_headers), chunked ? -1 : qMax(contentLength, qint64(0)));
+
+    Exchange exchange;
+    exchange.request = m_request;
+    exchange.response = responseOf(m_request);
+    exchange.keepAlive = http1_1 ? !hasToken(connection, "close")
+                                 : hasToken(connection, "keep-alive");
+    exchange.expectsContinue = expectsContinue;
+    m_exchanges.push_back(std::move(exchange));
+
+    QPointer<QHttpServerRequest> request = m_request;
+    if (chunked) {
+        m_state = State::ChunkSize;
+    } else if (contentLength > 0) {
+        m_state = State::Body;
+        m_bodyRemaining = contentLength;
+    } else {
+        finishRequest();
+    }
+
+    flushOutput();
+    if (request)
+        emitNewRequest(request);
+}
+
+bool QHttp1ServerConnection::tryHttp2Preface()
+{
+    // HTTP/2 with prior knowledge, RFC 7540, 3.4
+    if (m_requestCount || !m_http2Enabled || isEncrypted())
+        return false;
+
+    const QByteArray peeked = m_socket->peek(Http2::clientPrefaceLength);
+    if (peeked.isEmpty()
+        || std::memcmp(peeked.constData(), Http2::Http2clientPreface, size_t(peeked.size())) != 0) {
+        return false;
+    }
+    if (peeked.size() < Http2::clientPrefaceLength)
+        return true;
+
+    auto successor = new QHttp2ServerConnection(m_socket, m_server);
+    m_state = State::Closed;
+    m_idleTimer.stop();
+    handOver(successor);
+    successor->start();
+    return true;
+}
+
+bool QHttp1ServerConnection::tryUpgrade(const QByteArray &authority, bool hasBody)
+{
+    // RFC 7540, 3.2: we do not upgrade requests with a body,
+    // we would have to read all of it first
+    if (!m_http2Enabled || isEncrypted() || hasBody || !m_exchanges.empty()
+        || m_protocol != QHttpServerRequest::Protocol::Http1_1) {
+        return false;
+    }
+
+    QByteArray upgrade;
+    QByteArray settings;
+    int settingsCount = 0;
+    for (const auto &field : qAsConst(m_headers)) {
+        if (field.first == "upgrade") {
+            upgrade = field.second;
+        } else if (field.first == "http2-settings") {
+            settings = field.second;
+            ++settingsCount;
+        }
+    }
+    if (!hasToken(upgrade, "h2c") || settingsCount != 1)
+        return false;
+
+    const auto decoded = QByteArray::fromBase64Encoding(settings, QByteArray::Base64UrlEncoding
+                                                        | QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded || decoded.decoded.size() % 6)
+        return false;
+
+    m_socket->write("HTTP/1.1 101 Switching Protocols\r\n"
+                    "connection: Upgrade\r\n"
+                    "upgrade: h2c\r\n\r\n");
+
+    auto successor = new QHttp2ServerConnection(m_socket, m_server);
+    m_state = State::Closed;
+    m_idleTimer.stop();
+    handOver(successor);
+    successor->startUpgraded(m_method, m_target, authority, m_headers, decoded.decoded);
+    return true;
+}
+
+void QHttp1ServerConnection::finishRequest()
+{
+    QPointer<QHttpServerRequest> request = m_request;
+    m_request = nullptr;
+    m_state = State::RequestLine;
+    if (const Exchange *exchange = exchangeOf(request.data())) {
+        // No more requests are read from a connection that will be closed:
+        if (!exchange->keepAlive)
+            m_state = State::Closed;
+    }
+    if (request)
+        finishRequestBody(request);
+    flushOutput();
+}
+
+void QHttp1ServerConnection::failRequest(int statusCode)
+{
+    m_state = State::Closed;
+    if (m_request) {
+        // A malformed body is answered in place of the application's
+        // response, unless that one has already begun.
+        Exchange *exchange = exchangeOf(m_request.data());
+        if (!exchange || (exchange->response && exchange->response->headersSent())) {
+            closeConnection();
+            return;
+        }
+        QHttpServerRequest *request = m_request.data();
+        m_request = nullptr;
+        exchange->request = nullptr;
+        exchange->response = nullptr;
+        exchange->output.clear();
+        exchange->pendingBodyBytes = 0;
+        exchange->errorStatusCode = statusCode;
+        exchange->keepAlive = false;
+        exchange->started = false;
+        exchange->ended = false;
+        abortExchange(request);
+        flushOutput();
+        return;
+    }
+
+    Exchange exchange;
+    exchange.errorStatusCode = statusCode;
+    exchange.keepAlive = false;
+    m_exchanges.push_back(std::move(exchange));
+    flushOutput();
+}
+
+bool QHttp1ServerConnection::readBody()
+{
+    const Exchange *exchange = exchangeOf(m_request.data());
+    const bool discard = !exchange || exchange->discardBody;
+    qint64 size = qMin(m_bodyRemaining, m_socket->bytesAvailable());
+    if (!discard) {
+        // Resumed by requestBodyRead():
+        size = qMin(size, m_requestBodyBufferSize - bufferedRequestBody(m_request));
+    }
+    if (size <= 0)
+        return false;
+
+    QByteArray data = m_socket->read(size);
+    m_bodyRemaining -= data.size();
+    const bool complete = m_bodyRemaining == 0;
+    if (!discard && m_request)
+        appendRequestBody(m_request, std::move(data));
+
+    if (complete) {
+        if (m_state == State::Body)
+            finishRequest();
+        else if (m_state == State::ChunkData)
+            m_state = State::ChunkDataEnd;
+    }
+    return true;
+}
+
+bool QHttp1ServerConnection::parseChunkSize()
+{
+    QByteArray line;
+    if (!readLine(&line))
+        return false;
+
+    // RFC 7230, 4.1: chunk-size is 1*HEXDIG, optionally followed by
+    // extensions, which are ignored. Anything else (signs, "0x", white
+    // space) is rejected, so that a proxy in front of us cannot read a
+    // different body length out of the same bytes.
+    qint64 size = 0;
+    int digits = 0;
+    for (const char c : qAsConst(line)) {
+        int value;
+        if (c >= '0' && c <= '9')
+            value = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value = c - 'A' + 10;
+        else
+            break;
+        size = size * 16 + value;
+        ++digits;
+        if (digits > 15)
+            break;
+    }
+    if (digits == 0 || digits > 15 || (digits < line.size() && line.at(digits) != ';')) {
+        failRequest(400);
+        return false;
+    }
+
+    if (size == 0) {
+        m_state = State::Trailers;
+    } else {
+        m_bodyRemaining = size;
+        m_state = State::ChunkData;
+    }
+    return true;
+}
+
+bool QHttp1ServerConnection::readChunkDataEnd()
+{
+    QByteArray line;
+    if (!readLine(&line))
+        return false;
+    if (!line.isEmpty()) {
+        failRequest(400);
+        return false;
+    }
+    m_state = State::ChunkSize;
+    return true;
+}
+
+bool QHttp1ServerConnection::parseTrailers()
+{
+    // Trailer fields are read, bounded like the header, and dropped
+    QByteArray line;
+    while (readLine(&line)) {
+        if (line.isEmpty()) {
+            finishRequest();
+            return true;
+        }
+        m_headerBytes += line.size();
+        if (m_headerBytes > MaxHeaderSize) {
+            failRequest(431);
+            return false;
+        }
+    }
+    return false;
+}
+
+void QHttp1ServerConnection::requestBodyRead(QHttpServerRequest *request, qint64 size)
+{
+    Q_UNUSED(size);
+    if (request == m_request && m_socket && m_socket->bytesAvailable())
+        resumeInput();
+}
+
+void QHttp1ServerConnection::sendResponseHeaders(QHttpServerResponse *response)
+{
+    Exchange *exchange = exchangeOf(response);
+    if (!exchange)
+        return;
+
+    const QHttpServerRequest *request = response->request();
+    const int statusCode = response->statusCode();
+    const bool http1_1 = request->protocol() == QHttpServerRequest::Protocol::Http1_1;
+    // RFC 7230, 3.3.3
+    exchange->suppressBody = request->method() == "HEAD" || statusCode < 200
+                             || statusCode == 204 || statusCode == 304;
+
+    if (hasToken(response->header("connection"), "close"))
+        exchange->keepAlive = false;
+    // RFC 7231, 5.1.1: the client will not send the body it announced,
+    // unless it gives up waiting for "100 Continue"
+    if (exchange->expectsContinue && !request->isBodyComplete())
+        exchange->keepAlive = false;
+    if (!exchange->suppressBody && response->header("content-length").isNull()) {
+        if (http1_1)
+            exchange->chunked = true;
+        else
+            exchange->keepAlive = false;
+    }
+
+    QByteArray header = statusLine(statusCode);
+    for (const auto &field : response->headers()) {
+        if (field.first == "connection" || field.first == "transfer-encoding")
+            continue;
+        header += field.first + ": " + field.second + "\r\n";
+    }
+    if (exchange->chunked)
+        header += "transfer-encoding: chunked\r\n";
+    if (!exchange->keepAlive)
+        header += "connection: close\r\n";
+    else if (!http1_1)
+        header += "connection: keep-alive\r\n";
+    header += "\r\n";
+
+    writeOutput(*exchange, std::move(header), 0);
+}
+
+void QHttp1ServerConnection::writeResponseBody(QHttpServerResponse *response, const char *data,
+                                               qint64 size)
+{
+    Exchange *exchange = exchangeOf(response);
+    if (!exchange)
+        return;
+    if (exchange->suppressBody) {
+        responseBytesWritten(response, size);
+        return;
+    }
+
+    QByteArray output;
+    if (exchange->chunked) {
+        const QByteArray chunkSize = QByteArray::number(size, 16);
+        output.reserve(chunkSize.size() + size + 4);
+        output += chunkSize;
+        output += "\r\n";
+        output.append(data, size);
+        output += "\r\n";
+    } else {
+        output = QByteArray(data, size);
+    }
+    writeOutput(*exchange, std::move(output), size);
+}
+
+void QHttp1ServerConnection::endResponse(QHttpServerResponse *response)
+{
+    Exchange *exchange = exchangeOf(response);
+    if (!exchange)
+        return;
+
+    if (exchange->chunked)
+        writeOutput(*exchange, QByteArrayLiteral("0\r\n\r\n"), 0);
+    // Closing the connection is the only way to tell the client
+    if (isResponseTruncated(response))
+        exchange->keepAlive = false;
+    exchange->ended = true;
+
+    // The rest of the body is of no interest anymore; it is read and
+    // dropped, unless the connection is going to be closed anyway
+    QHttpServerRequest *request = response->request();
+    if (!request->isBodyComplete()) {
+        exchange->discardBody = true;
+        discardRequestBody(request);
+        resumeInput();
+    }
+    flushOutput();
+}
+
+qint64 QHttp1ServerConnection::pendingResponseBytes(const QHttpServerResponse *response) const
+{
+    const Exchange *exchange = exchangeOf(response);
+    return exchange ? exchange->pendingBodyBytes : 0;
+}
+
+QHttp1ServerConnection::Exchange *QHttp1ServerConnection::exchangeOf(const QObject *requestOrResponse)
+{
+    if (!requestOrResponse)
+        return nullptr;
+    const auto it = std::find_if(m_exchanges.begin(), m_exchanges.end(),
+                                 [requestOrResponse](const Exchange &exchange) {
+        return exchange.request == requestOrResponse || exchange.response == requestOrResponse;
+    });
+    return it == m_exchanges.end() ? nullptr : &*it;
+}
+
+const QHttp1ServerConnection::Exchange *
+QHttp1ServerConnection::exchangeOf(const QObject *requestOrResponse) const
+{
+    return const_cast<QHttp1ServerConnection *>(this)->exchangeOf(requestOrResponse);
+}
+
+void QHttp1ServerConnection::writeOutput(Exchange &exchange, QByteArray &&data, qint64 bodyBytes)
+{
+    // Written right away, unless an earlier response or the socket is in the way
+    if (&exchange == &m_exchanges.front() && exchange.started && exchange.output.empty()
+        && m_socket && m_socket->bytesToWrite() < SocketWriteBufferLimit) {
+        m_socket->write(data);
+        if (bodyBytes)
+            responseBytesWritten(exchange.response, bodyBytes);
+        return;
+    }
+
+    exchange.output.emplace_back(std::move(data), bodyBytes);
+    exchange.pendingBodyBytes += bodyBytes;
+}
+
+void QHttp1ServerConnection::startExchange(Exchange &exchange)
+{
+    exchange.started = true;
+    if (exchange.errorStatusCode) {
+        exchange.output.emplace_back(statusLine(exchange.errorStatusCode)
+                                     + "content-length: 0\r\nconnection: close\r\n\r\n", 0);
+        exchange.ended = true;
+        return;
+    }
+
+    if (exchange.expectsContinue && exchange.response && !exchange.response->headersSent()
+        && exchange.request && !exchange.request->isBodyComplete()) {
+        exchange.output.emplace_front(statusLine(100) + "\r\n", 0);
+        exchange.expectsContinue = false;
+    }
+}
+
+void QHttp1ServerConnection::flushOutput()
+{
+    if (m_flushingOutput || !m_socket)
+        return;
+
+    m_flushingOutput = true;
+    while (!m_exchanges.empty()) {
+        Exchange &exchange = m_exchanges.front();
+        if (!exchange.started)
+            startExchange(exchange);
+
+        while (!exchange.output.empty() && m_socket->bytesToWrite() < SocketWriteBufferLimit) {
+            const QPair<QByteArray, qint64> chunk = std::move(exchange.output.front());
+            exchange.output.pop_front();
+            m_socket->write(chunk.first);
+            if (chunk.second) {
+                exchange.pendingBodyBytes -= chunk.second;
+                if (exchange.response)
+                    responseBytesWritten(exchange.response, chunk.second);
+            }
+        }
+        if (!exchange.output.empty() || !exchange.ended)
+            break;
+
+        if (!exchange.drained) {
+            exchange.drained = true;
+            if (exchange.response)
+                responseDrained(exchange.response);
+        }
+        // The next request is not read before this one's body
+        const bool bodyComplete = !exchange.request || exchange.request->isBodyComplete();
+        if (!bodyComplete && exchange.keepAlive)
+            break;
+
+        const bool keepAlive = exchange.keepAlive;
+        m_exchanges.pop_front();
+        if (!keepAlive) {
+            m_state = State::Closed;
+            closeConnection();
+            break;
+        }
+        // There is room for another pipelined request:
+        resumeInput();
+    }
+    m_flushingOutput = false;
+    updateIdleTimer();
+}
+
+void QHttp1ServerConnection::updateIdleTimer()
+{
+    if (!m_socket)
+        return;
+    // Keeps running while a request header arrives
+    if (m_exchanges.empty() && (m_state == State::RequestLine || m_state == State::Headers)) {
+        if (!m_idleTimer.isActive() && m_keepAliveTimeout >= 0)
+            m_idleTimer.start(m_keepAliveTimeout);
+    } else {
+        m_idleTimer.stop();
+    }
+}
+
+void QHttp1ServerConnection::resumeInput()
+{
+    if (m_resumeScheduled || m_state == State::Closed)
+        return;
+    m_resumeScheduled = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_resumeScheduled = false;
+        processInput();
+    }, Qt::QueuedConnection);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPSERVERCONNECTION_P_H
+#define QHTTPSERVERCONNECTION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/private/qhttpserver_p.h>
+#include <QtNetwork/qabstractsocket.h>
+#include <QtNetwork/qhttp2configuration.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qtimer.h>
+
+#include <deque>
+
+QT_REQUIRE_CONFIG(http);
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QHttpServerConnection : public QObject
+{
+    Q_OBJECT
+public:
+    QHttpServerConnection(QAbstractSocket *socket, QHttpServer *server);
+    ~QHttpServerConnection() override;
+
+    virtual void start() = 0;
+
+    // Called by QHttpServerRequest and QHttpServerResponse:
+    virtual void requestBodyRead(QHttpServerRequest *request, qint64 size) = 0;
+    virtual void sendResponseHeaders(QHttpServerResponse *response) = 0;
+    virtual void writeResponseBody(QHttpServerResponse *response, const char *data,
+                                   qint64 size) = 0;
+    virtual void endResponse(QHttpServerResponse *response) = 0;
+    virtual qint64 pendingResponseBytes(const QHttpServerResponse *response) const = 0;
+
+protected:
+    // We stop writing to the socket once it buffers that much:
+    static const qint64 SocketWriteBufferLimit = 256 * 1024;
+
+    virtual void socketReadyRead() = 0;
+    virtual void socketBytesWritten() = 0;
+
+    void handOver(QHttpServerConnection *successor);
+    bool isEncrypted() const;
+    void closeConnection();
+
+    QHttpServerRequest *createRequest(QHttpServerRequest::Protocol protocol);
+    static void setRequestHeader(QHttpServerRequest *request, QByteArray method,
+                                 QByteArray target, QByteArray authority,
+                                 QList<QPair<QByteArray, QByteArray>> headers,
+                                 qint64 contentLength);
+    static QHttpServerResponse *responseOf(const QHttpServerRequest *request);
+    static void setStreamID(QHttpServerRequest *request, quint32 streamID);
+    static quint32 streamID(const QHttpServerRequest *request);
+    void emitNewRequest(QHttpServerRequest *request);
+
+    void appendRequestBody(QHttpServerRequest *request, QByteArray &&data);
+    static qint64 bufferedRequestBody(const QHttpServerRequest *request);
+    static void discardRequestBody(QHttpServerRequest *request);
+    void finishRequestBody(QHttpServerRequest *request);
+
+    // The progress of a response is reported asynchronously:
+    void responseBytesWritten(QHttpServerResponse *response, qint64 size);
+    void responseDrained(QHttpServerResponse *response);
+    static bool isResponseTruncated(const QHttpServerResponse *response);
+
+    void abortExchange(QHttpServerRequest *request);
+
+    QAbstractSocket *m_socket;
+    QPointer<QHttpServer> m_server;
+    // Copied from the server when the connection starts:
+    QHttp2Configuration m_http2Configuration;
+    qint64 m_requestBodyBufferSize;
+    int m_keepAliveTimeout;
+    int m_maxPipelinedRequests;
+    bool m_http2Enabled;
+
+private:
+    void scheduleProgressReport(QHttpServerResponse *response);
+    void reportResponseProgress();
+    void releaseIfDone(QHttpServerRequest *request);
+    void socketDisconnected();
+
+    QList<QPointer<QHttpServerResponse>> m_progressReports;
+    bool m_progressReportScheduled = false;
+};
+
+class Q_AUTOTEST_EXPORT QHttp1ServerConnection : public QHttpServerConnection
+{
+    Q_OBJECT
+public:
+    QHttp1ServerConnection(QAbstractSocket *socket, QHttpServer *server);
+    ~QHttp1ServerConnection() override;
+
+    void start() override;
+
+    void requestBodyRead(QHttpServerRequest *request, qint64 size) override;
+    void sendResponseHeaders(QHttpServerResponse *response) override;
+    void writeResponseBody(QHttpServerResponse *response, const char *data,
+                           qint64 size) override;
+    void endResponse(QHttpServerResponse *response) override;
+    qint64 pendingResponseBytes(const QHttpServerResponse *response) const override;
+
+protected:
+    void socketReadyRead() override;
+    void socketBytesWritten() override;
+
+private:
+    enum class State {
+        RequestLine,
+        Headers,
+        Body,
+        ChunkSize,
+        ChunkData,
+        ChunkDataEnd,
+        Trailers,
+        Closed
+    };
+
+    // A request and its response; responses are sent in the order
+    // the requests were received:
+    struct Exchange
+    {
+        QPointer<QHttpServerRequest> request;
+        QPointer<QHttpServerResponse> response;
+        // Output that could not be written to the socket yet,
+        // with the number of response body bytes it contains:
+        std::deque<QPair<QByteArray, qint64>> output;
+        qint64 pendingBodyBytes = 0;
+        int errorStatusCode = 0;
+        bool keepAlive = true;
+        bool expectsContinue = false;
+        bool started = false;
+        bool chunked = false;
+        bool suppressBody = false;
+        bool ended = false;
+        bool drained = false;
+        bool discardBody = false;
+    };
+
+    void processInput();
+    bool parseRequestLine();
+    bool parseHeaders();
+    bool readBody();
+    bool parseChunkSize();
+    bool readChunkDataEnd();
+    bool parseTrailers();
+    bool readLine(QByteArray *line);
+
+    bool tryHttp2Preface();
+    void startRequest();
+    bool tryUpgrade(const QByteArray &authority, bool hasBody);
+    void finishRequest();
+    void failRequest(int statusCode);
+
+    Exchange *exchangeOf(const QObject *requestOrResponse);
+    const Exchange *exchangeOf(const QObject *requestOrResponse) const;
+    void writeOutput(Exchange &exchange, QByteArray &&data, qint64 bodyBytes);
+    void flushOutput();
+    void startExchange(Exchange &exchange);
+    void updateIdleTimer();
+    void resumeInput();
+
+    std::deque<Exchange> m_exchanges;
+    QTimer m_idleTimer;
+    State m_state = State::RequestLine;
+
+    // The request being received:
+    QPointer<QHttpServerRequest> m_request;
+    QByteArray m_method;
+    QByteArray m_target;
+    QHttpServerRequest::Protocol m_protocol = QHttpServerRequest::Protocol::Http1_1;
+    QList<QPair<QByteArray, QByteArray>> m_headers;
+    qint64 m_headerBytes = 0;
+    qint64 m_bodyRemaining = 0;
+
+    int m_requestCount = 0;
+    bool m_processingInput = false;
+    bool m_flushingOutput = false;
+    bool m_resumeScheduled = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPSERVERCONNECTION_P_H
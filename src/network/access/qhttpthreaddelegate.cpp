@@ -181,14 +181,21 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
 {
     // Q_OBJECT
 public:
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, nullptr, connectionType)
     {
         setExpires(true);
         setShareable(true);
     }
 
+    // An idle connection costs as many pooled connections as it has sockets open
+    int idleCost() const override
+    {
+        return openChannelCount();
+    }
+
     virtual void dispose() override
     {
 #if 0  // sample code; do this right with the API
@@ -276,6 +283,12 @@ void QHttpThreadDelegate::startRequest()
     if (!connections.hasLocalData()) {
         connections.setLocalData(new QNetworkAccessCache());
     }
+    QNetworkAccessCache *cache = connections.localData();
+    cache->setExpiryTimeout(connectionPoolConfiguration.idleTimeout());
+    cache->setMaximumIdleCost(connectionPoolConfiguration.maximumIdleConnections());
+    cache->setCounters(connectionPoolCounters);
+    if (connectionPoolCounters)
+        connectionPoolCounters->requests.fetchAndAddRelaxed(1);
 
     // check if we have an open connection to this host
     QUrl urlCopy = httpRequest.url();
@@ -321,16 +334,59 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, nullptr, httpRequest.peerVerifyName());
 
+    // An HTTP/2 host can have several connections, the additional ones are
+    // cached under the key of the first with a suffix. Pick the first
+    // connection that has a stream to spare, or the first free slot to
+    // open another one; if all are saturated the request waits on the
+    // first connection.
+    const QByteArray hostKey = cacheKey;
+    const int hostConnections = isH2 && !httpRequest.isPreConnect()
+            ? connectionPoolConfiguration.maximumHttp2ConnectionsPerHost() : 1;
+    QByteArray freeKey;
+    quint32 streamLimit = Http2::maxConcurrentStreams;
+    httpConnection = nullptr;
+    for (int i = 0; i < hostConnections; ++i) {
+        const QByteArray key = i ? hostKey + '#' + QByteArray::number(i) : hostKey;
+        auto connection = static_cast<QNetworkAccessCachedHttpConnection *>(cache->requestEntryNow(key));
+        if (!connection) {
+            if (freeKey.isEmpty())
+                freeKey = key;
+            continue;
+        }
+        if (connection->isHttp2Saturated()) {
+            streamLimit = connection->http2StreamLimit();
+            cache->releaseEntry(key);
+            continue;
+        }
+        httpConnection = connection;
+        cacheKey = key;
+        break;
+    }
+    if (!httpConnection && freeKey.isEmpty()) {
+        cacheKey = hostKey;
+        httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(cache->requestEntryNow(cacheKey));
+    }
+
     // the http object is actually a QHttpNetworkConnection
-    httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        cacheKey = freeKey;
+        const int channelCount = connectionPoolConfiguration.maximumConnectionsPerHost();
+        httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType);
+        httpConnection->setPoolCounters(connectionPoolCounters);
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
+            if (cacheKey != hostKey) {
+                // Do not overload the new connection before its peer
+                // had a chance to announce its limit:
+                httpConnection->setHttp2StreamLimitHint(streamLimit);
+                if (connectionPoolCounters)
+                    connectionPoolCounters->additionalHttp2Connections.fetchAndAddRelaxed(1);
+            }
         }
 #ifndef QT_NO_SSL
         // Set the QSslConfiguration from this QNetworkRequest.
@@ -344,7 +400,7 @@ void QHttpThreadDelegate::startRequest()
 #endif
         httpConnection->setPeerVerifyName(httpRequest.peerVerifyName());
         // cache the QHttpNetworkConnection corresponding to this cache key
-        connections.localData()->addEntry(cacheKey, httpConnection);
+        cache->addEntry(cacheKey, httpConnection);
     } else {
         if (httpRequest.withCredentials()) {
             QNetworkAuthenticationCredential credential = authenticationManager->fetchCachedCredentials(httpRequest.url(), nullptr);
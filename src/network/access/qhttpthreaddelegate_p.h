@@ -63,6 +63,7 @@
 #include "qhttpnetworkrequest_p.h"
 #include "qhttpnetworkconnection_p.h"
 #include "qhttp2configuration.h"
+#include "qhttpconnectionpoolconfiguration.h"
 #include <QSharedPointer>
 #include <QScopedPointer>
 #include "private/qnoncontiguousbytedevice_p.h"
@@ -118,6 +119,8 @@ public:
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
     QHttp2Configuration http2Parameters;
+    QHttpConnectionPoolConfiguration connectionPoolConfiguration;
+    QSharedPointer<QNetworkConnectionPoolCounters> connectionPoolCounters;
 
 protected:
     // The zerocopy download buffer, if used:
@@ -44,6 +44,7 @@
 #include "qnetworkreply_p.h"
 #include "qnetworkrequest.h"
 
+#include <limits>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
@@ -71,9 +72,10 @@ struct QNetworkAccessCache::Node
     CacheableObject *object;
 
     int useCount;
+    int idleCost; // while linked
 
     Node()
-        : older(nullptr), newer(nullptr), object(nullptr), useCount(0)
+        : older(nullptr), newer(nullptr), object(nullptr), useCount(0), idleCost(0)
     { }
 };
 
@@ -103,7 +105,7 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
 }
 
 QNetworkAccessCache::QNetworkAccessCache()
-    : oldest(nullptr), newest(nullptr)
+    : oldest(nullptr), newest(nullptr), expiryMSecs(ExpiryTime * 1000)
 {
 }
 
@@ -131,9 +133,49 @@ void QNetworkAccessCache::clear()
 
     timer.stop();
 
+    if (counters)
+        counters->idleConnections.fetchAndSubRelaxed(idleCost);
+    idleCost = 0;
     oldest = newest = nullptr;
 }
 
+/*!
+    Sets the time unused entries stay in the cache to \a msecs. Entries
+    that are already unused keep their expiry time.
+ */
+void QNetworkAccessCache::setExpiryTimeout(int msecs)
+{
+    expiryMSecs = msecs;
+}
+
+/*!
+    Limits the summed idleCost() of the unused entries to \a cost; when
+    it is exceeded, the entries unused for the longest time are disposed
+    of first. A negative \a cost means no limit.
+ */
+void QNetworkAccessCache::setMaximumIdleCost(int cost)
+{
+    if (maxIdleCost == cost)
+        return;
+    maxIdleCost = cost;
+    updateTimer();
+}
+
+/*!
+    Makes the cache account for the expired and evicted entries and for
+    the cost of the unused entries in \a newCounters.
+ */
+void QNetworkAccessCache::setCounters(const QSharedPointer<QNetworkConnectionPoolCounters> &newCounters)
+{
+    if (counters == newCounters)
+        return;
+    if (counters)
+        counters->idleConnections.fetchAndSubRelaxed(idleCost);
+    counters = newCounters;
+    if (counters)
+        counters->idleConnections.fetchAndAddRelaxed(idleCost);
+}
+
 /*!
     Appends the entry given by \a key to the end of the linked list.
     (i.e., makes it the newest entry)
@@ -158,7 +200,11 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
         oldest = node;
     }
 
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
+    node->timestamp = QDateTime::currentDateTimeUtc().addMSecs(expiryMSecs);
+    node->idleCost = node->object->idleCost();
+    idleCost += node->idleCost;
+    if (counters)
+        counters->idleConnections.fetchAndAddRelaxed(node->idleCost);
     newest = node;
 }
 
@@ -184,6 +230,10 @@ bool QNetworkAccessCache::unlinkEntry(const QByteArray &key)
     if (node->newer)
         node->newer->older = node->older;
 
+    idleCost -= node->idleCost;
+    if (counters)
+        counters->idleConnections.fetchAndSubRelaxed(node->idleCost);
+    node->idleCost = 0;
     node->newer = node->older = nullptr;
     return wasOldest;
 }
@@ -195,15 +245,25 @@ void QNetworkAccessCache::updateTimer()
     if (!oldest)
         return;
 
-    int interval = QDateTime::currentDateTimeUtc().secsTo(oldest->timestamp);
-    if (interval <= 0) {
-        interval = 0;
-    } else {
-        // round up the interval
-        interval = (interval + 15) & ~16;
+    // over the idle budget: dispose of the surplus from the event loop,
+    // the caller may still be using the objects
+    if (maxIdleCost >= 0 && idleCost > maxIdleCost) {
+        timer.start(0, this);
+        return;
     }
 
-    timer.start(interval * 1000, this);
+    const qint64 interval = QDateTime::currentDateTimeUtc().msecsTo(oldest->timestamp);
+    timer.start(int(qBound(qint64(0), interval, qint64(std::numeric_limits<int>::max()))),
+                Qt::CoarseTimer, this);
+}
+
+void QNetworkAccessCache::disposeOldest()
+{
+    Node *node = oldest;
+    unlinkEntry(node->key);
+    node->object->dispose();
+    hash.remove(node->key);
+    delete node;
 }
 
 bool QNetworkAccessCache::emitEntryReady(Node *node, QObject *target, const char *member)
@@ -223,20 +283,18 @@ void QNetworkAccessCache::timerEvent(QTimerEvent *)
     // expire old items
     const QDateTime now = QDateTime::currentDateTimeUtc();
 
-    while (oldest && oldest->timestamp < now) {
-        Node *next = oldest->newer;
-        oldest->object->dispose();
-
-        hash.remove(oldest->key); // oldest gets deleted
-        delete oldest;
-        oldest = next;
+    while (oldest && oldest->timestamp <= now) {
+        if (counters)
+            counters->expiredConnections.fetchAndAddRelaxed(oldest->idleCost);
+        disposeOldest();
     }
 
-    // fixup the list
-    if (oldest)
-        oldest->older = nullptr;
-    else
-        newest = nullptr;
+    // then trim to the idle budget, least recently used first
+    while (oldest && maxIdleCost >= 0 && idleCost > maxIdleCost) {
+        if (counters)
+            counters->evictedConnections.fetchAndAddRelaxed(oldest->idleCost);
+        disposeOldest();
+    }
 
     updateTimer();
 }
@@ -349,7 +407,7 @@ void QNetworkAccessCache::releaseEntry(const QByteArray &key)
         if (node->object->expires)
             linkEntry(key);
 
-        if (oldest == node)
+        if (oldest == node || (maxIdleCost >= 0 && idleCost > maxIdleCost))
             updateTimer();
     }
 }
@@ -53,16 +53,30 @@
 
 #include <QtNetwork/private/qtnetworkglobal_p.h>
 #include "QtCore/qobject.h"
+#include "QtCore/qatomic.h"
 #include "QtCore/qbasictimer.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qhash.h"
 #include "QtCore/qmetatype.h"
+#include "QtCore/qsharedpointer.h"
 
 QT_BEGIN_NAMESPACE
 
 class QNetworkRequest;
 class QUrl;
 
+// Counters of the connection pool that a QNetworkAccessManager keeps in its
+// HTTP thread. The manager reads them from its own thread, hence atomic.
+struct QNetworkConnectionPoolCounters
+{
+    QAtomicInteger<quint64> requests;
+    QAtomicInteger<quint64> connectionsOpened;
+    QAtomicInteger<quint64> additionalHttp2Connections;
+    QAtomicInteger<quint64> expiredConnections;
+    QAtomicInteger<quint64> evictedConnections;
+    QAtomicInt idleConnections;
+};
+
 // this class is not about caching files but about
 // caching objects used by QNetworkAccessManager, e.g. existing TCP connections
 // or credentials.
@@ -83,6 +97,8 @@ public:
         CacheableObject();
         virtual ~CacheableObject();
         virtual void dispose() = 0;
+        // How much of the idle budget the object takes while nobody uses it
+        virtual int idleCost() const { return 1; }
         inline QByteArray cacheKey() const { return key; }
 
     protected:
@@ -102,6 +118,13 @@ public:
     void releaseEntry(const QByteArray &key);
     void removeEntry(const QByteArray &key);
 
+    // Expiry policy of unused entries; a negative cost means no limit
+    void setExpiryTimeout(int msecs);
+    int expiryTimeout() const { return expiryMSecs; }
+    void setMaximumIdleCost(int cost);
+    int maximumIdleCost() const { return maxIdleCost; }
+    void setCounters(const QSharedPointer<QNetworkConnectionPoolCounters> &counters);
+
 signals:
     void entryReady(QNetworkAccessCache::CacheableObject *);
 
@@ -116,9 +139,15 @@ private:
 
     QBasicTimer timer;
 
+    QSharedPointer<QNetworkConnectionPoolCounters> counters;
+    int expiryMSecs;
+    int maxIdleCost = -1;
+    int idleCost = 0;
+
     void linkEntry(const QByteArray &key);
     bool unlinkEntry(const QByteArray &key);
     void updateTimer();
+    void disposeOldest();
     bool emitEntryReady(Node *node, QObject *target, const char *member);
 };
 
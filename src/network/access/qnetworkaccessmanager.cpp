@@ -71,6 +71,8 @@
 #include "QtNetwork/private/http2protocol_p.h"
 
 #if QT_CONFIG(http)
+#include "qhttpconnectionpoolconfiguration.h"
+#include "qhttpconnectionpoolconfiguration_p.h"
 #include "qhttpmultipart.h"
 #include "qhttpmultipart_p.h"
 #include "qnetworkreplyhttpimpl_p.h"
@@ -930,6 +932,8 @@ QNetworkReply *QNetworkAccessManager::deleteResource(const QNetworkRequest &requ
     Initiates a connection to the host given by \a hostName at port \a port, using
     \a sslConfiguration. This function is useful to complete the TCP and SSL handshake
     to a host before the HTTPS request is made, resulting in a lower network latency.
+    As many connections as QHttpConnectionPoolConfiguration::preconnectCount()
+    are opened.
 
     \note Preconnecting a HTTP/2 connection can be done by calling setAllowedNextProtocols()
     on \a sslConfiguration with QSslConfiguration::ALPNProtocolHTTP2 contained in
@@ -956,6 +960,8 @@ void QNetworkAccessManager::connectToHostEncrypted(const QString &hostName, quin
     \a sslConfiguration with \a peerName set to be the hostName used for certificate
     validation. This function is useful to complete the TCP and SSL handshake
     to a host before the HTTPS request is made, resulting in a lower network latency.
+    As many connections as QHttpConnectionPoolConfiguration::preconnectCount()
+    are opened.
 
     \note Preconnecting a HTTP/2 connection can be done by calling setAllowedNextProtocols()
     on \a sslConfiguration with QSslConfiguration::ALPNProtocolHTTP2 contained in
@@ -986,6 +992,10 @@ void QNetworkAccessManager::connectToHostEncrypted(const QString &hostName, quin
         request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
 
     request.setPeerVerifyName(peerName);
+#if QT_CONFIG(http)
+    for (int i = 1; i < d_func()->connectionPoolConfiguration.preconnectCount(); ++i)
+        get(request);
+#endif
     get(request);
 }
 #endif
@@ -996,6 +1006,9 @@ void QNetworkAccessManager::connectToHostEncrypted(const QString &hostName, quin
     Initiates a connection to the host given by \a hostName at port \a port.
     This function is useful to complete the TCP handshake
     to a host before the HTTP request is made, resulting in a lower network latency.
+    As many connections as QHttpConnectionPoolConfiguration::preconnectCount()
+    are opened. If that is more than one, they are HTTP/1.1 connections, used by
+    requests that have QNetworkRequest::Http2AllowedAttribute set to \c false.
 
     \note This function has no possibility to report errors.
 
@@ -1008,6 +1021,16 @@ void QNetworkAccessManager::connectToHost(const QString &hostName, quint16 port)
     url.setPort(port);
     url.setScheme(QLatin1String("preconnect-http"));
     QNetworkRequest request(url);
+#if QT_CONFIG(http)
+    const int preconnectCount = d_func()->connectionPoolConfiguration.preconnectCount();
+    // Clear text HTTP/2 is negotiated with the first request, until then
+    // a connection uses a single socket. Pre-warm HTTP/1.1 connections
+    // if more than one is wanted.
+    if (preconnectCount > 1)
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    for (int i = 1; i < preconnectCount; ++i)
+        get(request);
+#endif
     get(request);
 }
 
@@ -1425,6 +1448,56 @@ void QNetworkAccessManager::setTransferTimeout(int timeout)
     d_func()->transferTimeout = timeout;
 }
 
+#if QT_CONFIG(http)
+/*!
+    \since 6.1
+
+    Returns the configuration of the pool of HTTP connections this
+    manager keeps.
+
+    \sa setConnectionPoolConfiguration(), connectionPoolStatistics()
+*/
+QHttpConnectionPoolConfiguration QNetworkAccessManager::connectionPoolConfiguration() const
+{
+    return d_func()->connectionPoolConfiguration;
+}
+
+/*!
+    \since 6.1
+
+    Sets the configuration of the pool of HTTP connections to
+    \a configuration. It affects the connections the manager opens to
+    hosts it is not connected to yet; call clearConnectionCache() to
+    apply it to all hosts.
+
+    \sa connectionPoolConfiguration(), connectionPoolStatistics()
+*/
+void QNetworkAccessManager::setConnectionPoolConfiguration(const QHttpConnectionPoolConfiguration &configuration)
+{
+    d_func()->connectionPoolConfiguration = configuration;
+}
+
+/*!
+    \since 6.1
+
+    Returns a snapshot of the counters of the pool of HTTP connections.
+
+    \sa setConnectionPoolConfiguration()
+*/
+QHttpConnectionPoolStatistics QNetworkAccessManager::connectionPoolStatistics() const
+{
+    const QNetworkConnectionPoolCounters &counters = *d_func()->connectionPoolCounters;
+    auto dd = new QHttpConnectionPoolStatisticsPrivate;
+    dd->requestCount = counters.requests.loadRelaxed();
+    dd->connectionsOpened = counters.connectionsOpened.loadRelaxed();
+    dd->additionalHttp2Connections = counters.additionalHttp2Connections.loadRelaxed();
+    dd->expiredConnections = counters.expiredConnections.loadRelaxed();
+    dd->evictedConnections = counters.evictedConnections.loadRelaxed();
+    dd->idleConnections = counters.idleConnections.loadRelaxed();
+    return QHttpConnectionPoolStatistics(dd);
+}
+#endif // QT_CONFIG(http)
+
 void QNetworkAccessManagerPrivate::_q_replyFinished(QNetworkReply *reply)
 {
     Q_Q(QNetworkAccessManager);
@@ -65,6 +65,8 @@ class QNetworkProxyFactory;
 class QSslError;
 class QHstsPolicy;
 class QHttpMultiPart;
+class QHttpConnectionPoolConfiguration;
+class QHttpConnectionPoolStatistics;
 
 class QNetworkReplyImplPrivate;
 class QNetworkAccessManagerPrivate;
@@ -148,6 +150,12 @@ public:
     int transferTimeout() const;
     void setTransferTimeout(int timeout = QNetworkRequest::DefaultTransferTimeoutConstant);
 
+#if QT_CONFIG(http)
+    QHttpConnectionPoolConfiguration connectionPoolConfiguration() const;
+    void setConnectionPoolConfiguration(const QHttpConnectionPoolConfiguration &configuration);
+    QHttpConnectionPoolStatistics connectionPoolStatistics() const;
+#endif
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
@@ -66,6 +66,10 @@
 #include "qhstsstore_p.h"
 #endif // QT_CONFIG(settings)
 
+#if QT_CONFIG(http)
+#include "qhttpconnectionpoolconfiguration.h"
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QAuthenticator;
@@ -169,6 +173,13 @@ public:
 
     int transferTimeout = 0;
 
+#if QT_CONFIG(http)
+    QHttpConnectionPoolConfiguration connectionPoolConfiguration;
+    // Shared with the delegates in the HTTP thread
+    QSharedPointer<QNetworkConnectionPoolCounters> connectionPoolCounters
+        = QSharedPointer<QNetworkConnectionPoolCounters>::create();
+#endif
+
     Q_DECLARE_PUBLIC(QNetworkAccessManager)
 };
 
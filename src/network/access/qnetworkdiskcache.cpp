@@ -49,14 +49,21 @@
 #include <qdatastream.h>
 #include <qdatetime.h>
 #include <qdiriterator.h>
+#include <qsavefile.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
 #include <qdebug.h>
+#include <qendian.h>
+
+#include <algorithm>
+#include <vector>
 
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
-#define CACHE_VERSION 8
+#define CACHE_VERSION 9
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
+#define NUM_SUBDIRECTORIES 256
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -77,6 +84,14 @@ QT_BEGIN_NAMESPACE
     Currently you cannot share the same cache files with more than
     one disk cache.
 
+    The files are spread over 256 subdirectories of the cache directory.
+    QNetworkDiskCache keeps an index of their sizes, expiration dates and
+    last use in memory, so that lookups of uncached URLs and the expiry of
+    the cache do not need to touch the disk. The index is saved in the
+    cache directory when the cache is destroyed, and is rebuilt from the
+    file sizes if the application did not shut down cleanly. Files that
+    are evicted by expire() are removed in a background thread.
+
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
 
@@ -113,6 +128,8 @@ QNetworkDiskCache::~QNetworkDiskCache()
 {
     Q_D(QNetworkDiskCache);
     qDeleteAll(d->inserting);
+    d->waitForRemovals();
+    d->saveIndex();
 }
 
 /*!
@@ -142,11 +159,15 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
     Q_D(QNetworkDiskCache);
     if (cacheDir.isEmpty())
         return;
-    d->cacheDirectory = cacheDir;
-    QDir dir(d->cacheDirectory);
-    d->cacheDirectory = dir.absolutePath();
-    if (!d->cacheDirectory.endsWith(QLatin1Char('/')))
-        d->cacheDirectory += QLatin1Char('/');
+    QString cacheDirectory = QDir(cacheDir).absolutePath();
+    if (!cacheDirectory.endsWith(QLatin1Char('/')))
+        cacheDirectory += QLatin1Char('/');
+    if (cacheDirectory != d->cacheDirectory) {
+        d->waitForRemovals();
+        d->saveIndex();
+        d->resetIndex();
+    }
+    d->cacheDirectory = cacheDirectory;
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
@@ -252,10 +273,10 @@ void QNetworkDiskCachePrivate::prepareLayout()
     QDir helper;
     helper.mkpath(cacheDirectory + PREPARED_SLASH);
 
-    //Create directory and subdirectories 0-F
+    //Create directory and subdirectories 00-ff
     helper.mkpath(dataDirectory);
-    for (uint i = 0; i < 16 ; i++) {
-        QString str = QString::number(i, 16);
+    for (uint i = 0; i < NUM_SUBDIRECTORIES; i++) {
+        QString str = QString::number(i, 16).rightJustified(2, QLatin1Char('0'));
         QString subdir = dataDirectory + str;
         helper.mkdir(subdir);
     }
@@ -267,18 +288,22 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
     Q_Q(QNetworkDiskCache);
     Q_ASSERT(cacheItem->metaData.saveToDisk());
 
-    QString fileName = cacheFileName(cacheItem->metaData.url());
+    const quint64 key = cacheKey(cacheItem->metaData.url());
+    QString fileName = cacheFileName(key);
     Q_ASSERT(!fileName.isEmpty());
 
+    ensureIndex();
+    cancelRemoval(fileName);
     if (QFile::exists(fileName)) {
         if (!QFile::remove(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
     }
+    forgetFile(fileName);
 
-    if (currentCacheSize > 0)
-        currentCacheSize += 1024 + cacheItem->size();
+    // make room for the new item before it is stored
+    currentCacheSize += 1024 + cacheItem->size();
     currentCacheSize = q->expire();
     if (!cacheItem->file) {
         QString templateName = tmpCacheFileName();
@@ -294,10 +319,17 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            IndexEntry &entry = index[key];
+            entry.size = cacheItem->file->size();
+            const QDateTime expirationDate = cacheItem->metaData.expirationDate();
+            entry.expiration = expirationDate.isValid() ? expirationDate.toMSecsSinceEpoch() : 0;
+            entry.lastAccess = ++accessClock;
+            indexSize += entry.size;
+            currentCacheSize += entry.size;
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
@@ -342,14 +374,29 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     QString fileName = info.fileName();
     if (!fileName.endsWith(CACHE_POSTFIX))
         return false;
-    qint64 size = info.size();
     if (QFile::remove(file)) {
-        currentCacheSize -= size;
+        forgetFile(file);
         return true;
     }
     return false;
 }
 
+/*!
+    Drops \a file from the index, if it is one of the indexed cache files.
+ */
+void QNetworkDiskCachePrivate::forgetFile(const QString &file)
+{
+    quint64 key;
+    if (!indexLoaded || !cacheKeyOf(file, &key))
+        return;
+    const auto it = index.constFind(key);
+    if (it == index.cend())
+        return;
+    indexSize -= it->size;
+    currentCacheSize -= it->size;
+    index.erase(it);
+}
+
 /*!
     \reimp
 */
@@ -361,7 +408,16 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    if (!url.isValid() || d->cacheDirectory.isEmpty())
+        return QNetworkCacheMetaData();
+    d->ensureIndex();
+    const quint64 key = d->cacheKey(url);
+    if (!d->index.contains(key))
+        return QNetworkCacheMetaData();
+    QNetworkCacheMetaData metaData = fileMetaData(d->cacheFileName(key));
+    if (metaData.isValid())
+        d->touch(key);
+    return metaData;
 }
 
 /*!
@@ -375,12 +431,17 @@ QNetworkCacheMetaData QNetworkDiskCache::fileMetaData(const QString &fileName) c
     qDebug() << "QNetworkDiskCache::fileMetaData()" << fileName;
 #endif
     Q_D(const QNetworkDiskCache);
+    QNetworkDiskCachePrivate *that = const_cast<QNetworkDiskCachePrivate*>(d);
+    // files that expire() evicted may not be removed yet
+    if (d->isPendingRemoval(fileName))
+        return QNetworkCacheMetaData();
     QFile file(fileName);
-    if (!file.open(QFile::ReadOnly))
+    if (!file.open(QFile::ReadOnly)) {
+        that->forgetFile(fileName);
         return QNetworkCacheMetaData();
+    }
     if (!d->lastItem.read(&file, false)) {
         file.close();
-        QNetworkDiskCachePrivate *that = const_cast<QNetworkDiskCachePrivate*>(d);
         that->removeFile(fileName);
     }
     return d->lastItem.metaData;
@@ -402,15 +463,25 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        if (d->cacheDirectory.isEmpty())
+            return nullptr;
+        d->ensureIndex();
+        const quint64 key = d->cacheKey(url);
+        if (!d->index.contains(key))
+            return nullptr;
+        const QString fileName = d->cacheFileName(key);
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            d->forgetFile(fileName);
             return nullptr;
+        }
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
             remove(url);
             return nullptr;
         }
+        d->touch(key);
         if (d->lastItem.data.isOpen()) {
             // compressed
             buffer.reset(new QBuffer);
@@ -500,9 +571,10 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     Returns the current size of the cache.
 
     When the current size of the cache is greater than the maximumCacheSize()
-    older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    cache files are removed until the total size is less then 90% of
+    maximumCacheSize(). Files whose expiration date has passed are removed
+    first, followed by the least recently used ones. The files are selected
+    using the in-memory index and removed in a background thread.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -516,67 +588,20 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
-    if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
-        return d->currentCacheSize;
-
     if (cacheDirectory().isEmpty()) {
         qWarning("QNetworkDiskCache::expire() The cache directory is not set");
         return 0;
     }
 
+    d->ensureIndex();
+    if (d->currentCacheSize < maximumCacheSize())
+        return d->indexSize;
+
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
-            cacheItems.insert(birthTime.isValid() ? birthTime
-                              : info.fileTime(QFile::FileMetadataChangeTime), path);
-            totalSize += info.size();
-        }
-    }
-
-    int removedFiles = 0;
-    qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
-            break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = nullptr;
-                    break;
-                }
-            }
-        }
-
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
-        ++removedFiles;
-        ++i;
-    }
-#if defined(QNETWORKDISKCACHE_DEBUG)
-    if (removedFiles > 0) {
-        qDebug() << "QNetworkDiskCache::expire()"
-                << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
-    }
-#endif
-    return totalSize;
+    d->evict((maximumCacheSize() * 9) / 10);
+    return d->indexSize;
 }
 
 /*!
@@ -592,12 +617,13 @@ void QNetworkDiskCache::clear()
     d->maximumCacheSize = 0;
     d->currentCacheSize = expire();
     d->maximumCacheSize = size;
+    d->waitForRemovals();
 }
 
 /*!
-    Given a URL, generates a unique enough filename (and subdirectory)
+    Given a URL, generates the key of its cache file
  */
-QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+quint64 QNetworkDiskCachePrivate::cacheKey(const QUrl &url)
 {
     QUrl cleanUrl = url;
     cleanUrl.setPassword(QString());
@@ -605,14 +631,26 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
 
     QCryptographicHash hash(QCryptographicHash::Sha1);
     hash.addData(cleanUrl.toEncoded());
-    // convert sha1 to base36 form and return first 8 bytes for use as string
-    const QByteArray id = QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
-    // generates <one-char subdir>/<8-char filname.d>
-    uint code = (uint)id.at(id.length()-1) % 16;
-    QString pathFragment = QString::number(code, 16) + QLatin1Char('/')
-                             + QLatin1String(id) + CACHE_POSTFIX;
+    return qFromBigEndian<quint64>(hash.result().constData());
+}
 
-    return pathFragment;
+/*!
+    Given a cache key, generates the filename (and subdirectory)
+ */
+QString QNetworkDiskCachePrivate::uniqueFileName(quint64 key)
+{
+    // generates <two-char subdir>/<16-char filename.d>, where the
+    // subdirectory is the first byte of the key
+    const QString id = QString::number(key, 16).rightJustified(16, QLatin1Char('0'));
+    return id.left(2) + QLatin1Char('/') + id + CACHE_POSTFIX;
+}
+
+/*!
+    Given a URL, generates a unique enough filename (and subdirectory)
+ */
+QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+{
+    return uniqueFileName(cacheKey(url));
 }
 
 QString QNetworkDiskCachePrivate::tmpCacheFileName() const
@@ -633,6 +671,32 @@ QString QNetworkDiskCachePrivate::cacheFileName(const QUrl &url) const
     return  fullpath;
 }
 
+QString QNetworkDiskCachePrivate::cacheFileName(quint64 key) const
+{
+    return dataDirectory + uniqueFileName(key);
+}
+
+/*!
+    Returns \c true and stores the key in \a key if \a fileName is the
+    name of a file in the data directory.
+ */
+bool QNetworkDiskCachePrivate::cacheKeyOf(const QString &fileName, quint64 *key) const
+{
+    // <dataDirectory><two-char subdir>/<16-char filename.d>
+    const qsizetype length = dataDirectory.size() + 3 + 16 + 2;
+    if (dataDirectory.isEmpty() || fileName.size() != length
+        || !fileName.startsWith(dataDirectory) || !fileName.endsWith(CACHE_POSTFIX)) {
+        return false;
+    }
+    const QStringView relative = QStringView(fileName).mid(dataDirectory.size());
+    const QStringView id = relative.mid(3, 16);
+    if (relative.at(2) != QLatin1Char('/') || relative.left(2) != id.left(2))
+        return false;
+    bool ok;
+    *key = id.toULongLong(&ok, 16);
+    return ok;
+}
+
 /*!
     We compress small text and JavaScript files.
  */
@@ -668,6 +732,7 @@ bool QCacheItem::canCompress() const
 enum
 {
     CacheMagic = 0xe8,
+    IndexMagic = 0xe9,
     CurrentCacheVersion = CACHE_VERSION
 };
 
@@ -736,4 +801,288 @@ bool QCacheItem::read(QFile *device, bool readData)
     return metaData.isValid();
 }
 
+/*!
+    Makes sure that the index of the data directory is in memory.
+
+    The index is read from the file saved by saveIndex(). The file is removed
+    once it has been read, so that it never describes a cache that was
+    modified afterwards; when it is missing, the index is rebuilt by walking
+    the cache directory.
+ */
+void QNetworkDiskCachePrivate::ensureIndex()
+{
+    if (indexLoaded || dataDirectory.isEmpty())
+        return;
+    indexLoaded = true;
+    if (!loadIndex())
+        scanIndex();
+    currentCacheSize = indexSize;
+}
+
+bool QNetworkDiskCachePrivate::loadIndex()
+{
+    QFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    qint32 marker;
+    qint32 version;
+    quint64 clock;
+    qint32 count;
+    in >> marker >> version >> clock >> count;
+    bool ok = in.status() == QDataStream::Ok && marker == IndexMagic
+            && version == CurrentCacheVersion && count >= 0;
+    if (ok) {
+        index.reserve(count);
+        for (qint32 i = 0; i < count; ++i) {
+            quint64 key;
+            IndexEntry entry;
+            in >> key >> entry.size >> entry.expiration >> entry.lastAccess;
+            if (in.status() != QDataStream::Ok) {
+                ok = false;
+                break;
+            }
+            index.insert(key, entry);
+            indexSize += entry.size;
+        }
+    }
+    file.remove();
+
+    if (!ok) {
+        index.clear();
+        indexSize = 0;
+        return false;
+    }
+    accessClock = clock;
+#if defined(QNETWORKDISKCACHE_DEBUG)
+    qDebug() << "QNetworkDiskCache::loadIndex()" << index.size() << "files" << indexSize << "bytes";
+#endif
+    return true;
+}
+
+/*!
+    Rebuilds the index from the files in the cache directory. The files are
+    ordered by their modification time, their expiration dates are unknown.
+
+    Cache files that are not in the data directory were left behind by an
+    older version of the cache, or by an insertion that never completed,
+    and are removed.
+ */
+void QNetworkDiskCachePrivate::scanIndex()
+{
+    struct File
+    {
+        qint64 modified;
+        quint64 key;
+    };
+    std::vector<File> files;
+
+    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
+    QDirIterator it(cacheDirectory, filters, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (!path.endsWith(CACHE_POSTFIX))
+            continue;
+        QFileInfo info = it.fileInfo();
+        quint64 key;
+        if (cacheKeyOf(path, &key)) {
+            index[key].size = info.size();
+            indexSize += info.size();
+            files.push_back({ info.lastModified().toMSecsSinceEpoch(), key });
+            continue;
+        }
+        if (!info.isFile())
+            continue;
+        const bool isInserting = std::any_of(inserting.cbegin(), inserting.cend(),
+                                             [&path](const QCacheItem *item) {
+            return item && item->file && item->file->fileName() == path;
+        });
+        if (!isInserting)
+            scheduleRemoval(path);
+    }
+
+    std::stable_sort(files.begin(), files.end(), [](const File &lhs, const File &rhs) {
+        return lhs.modified < rhs.modified;
+    });
+    for (const File &file : files)
+        index[file.key].lastAccess = ++accessClock;
+
+#if defined(QNETWORKDISKCACHE_DEBUG)
+    qDebug() << "QNetworkDiskCache::scanIndex()" << index.size() << "files" << indexSize << "bytes";
+#endif
+}
+
+void QNetworkDiskCachePrivate::saveIndex()
+{
+    if (!indexLoaded || dataDirectory.isEmpty())
+        return;
+
+    QSaveFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QFile::WriteOnly)) {
+        qWarning() << "QNetworkDiskCache: couldn't save the index" << file.fileName();
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << qint32(IndexMagic) << qint32(CurrentCacheVersion) << accessClock << qint32(index.size());
+    for (auto it = index.cbegin(), end = index.cend(); it != end; ++it)
+        out << it.key() << it->size << it->expiration << it->lastAccess;
+    if (!file.commit())
+        qWarning() << "QNetworkDiskCache: couldn't save the index" << file.fileName();
+}
+
+void QNetworkDiskCachePrivate::resetIndex()
+{
+    index.clear();
+    indexSize = 0;
+    accessClock = 0;
+    indexLoaded = false;
+    currentCacheSize = -1;
+}
+
+/*!
+    Marks the file of \a key as the most recently used one.
+ */
+void QNetworkDiskCachePrivate::touch(quint64 key)
+{
+    const auto it = index.find(key);
+    if (it != index.end())
+        it->lastAccess = ++accessClock;
+}
+
+/*!
+    Removes files from the index until its size is less than \a goal, and
+    schedules their removal from the disk.
+
+    Expired files go first, then the least recently used ones. Since the
+    cache usually only needs to shed a few files, they are taken from a heap
+    instead of sorting the whole index.
+ */
+void QNetworkDiskCachePrivate::evict(qint64 goal)
+{
+    struct Candidate
+    {
+        bool live;
+        quint64 lastAccess;
+        quint64 key;
+    };
+    // a max-heap ordered by this puts the next victim at the front
+    const auto evictsLater = [](const Candidate &lhs, const Candidate &rhs) {
+        if (lhs.live != rhs.live)
+            return lhs.live;
+        return lhs.lastAccess > rhs.lastAccess;
+    };
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    std::vector<Candidate> candidates;
+    candidates.reserve(index.size());
+    for (auto it = index.cbegin(), end = index.cend(); it != end; ++it) {
+        const bool live = it->expiration == 0 || it->expiration > now;
+        candidates.push_back({ live, it->lastAccess, it.key() });
+    }
+    std::make_heap(candidates.begin(), candidates.end(), evictsLater);
+
+    int removedFiles = 0;
+    auto heapEnd = candidates.end();
+    while (indexSize >= goal && heapEnd != candidates.begin()) {
+        std::pop_heap(candidates.begin(), heapEnd, evictsLater);
+        --heapEnd;
+        const auto it = index.constFind(heapEnd->key);
+        indexSize -= it->size;
+        index.erase(it);
+        scheduleRemoval(cacheFileName(heapEnd->key));
+        ++removedFiles;
+    }
+    currentCacheSize = indexSize;
+
+#if defined(QNETWORKDISKCACHE_DEBUG)
+    if (removedFiles > 0) {
+        qDebug() << "QNetworkDiskCache::expire()"
+                << "Removed:" << removedFiles
+                << "Kept:" << index.size();
+    }
+#else
+    Q_UNUSED(removedFiles);
+#endif
+}
+
+/*!
+    Removes \a file from the disk in the background.
+ */
+void QNetworkDiskCachePrivate::scheduleRemoval(const QString &file)
+{
+#if QT_CONFIG(thread)
+    QMutexLocker locker(&removalMutex);
+    if (pendingRemovals.contains(file))
+        return;
+    pendingRemovals.insert(file);
+    removalQueue.append(file);
+    if (!removalScheduled) {
+        removalScheduled = true;
+        removalPool.start([this]() { processRemovals(); });
+    }
+#else
+    QFile::remove(file);
+#endif
+}
+
+#if QT_CONFIG(thread)
+void QNetworkDiskCachePrivate::processRemovals()
+{
+    QMutexLocker locker(&removalMutex);
+    while (!removalQueue.isEmpty()) {
+        const QString file = removalQueue.takeFirst();
+        // cancelRemoval() may have taken it back
+        if (!pendingRemovals.remove(file))
+            continue;
+        removing = file;
+        locker.unlock();
+        QFile::remove(file);
+        locker.relock();
+        removing.clear();
+        removalDone.wakeAll();
+    }
+    removalScheduled = false;
+    removalDone.wakeAll();
+}
+#endif
+
+/*!
+    Makes sure that a pending removal of \a file does not remove the file
+    that is about to be written with this name.
+ */
+void QNetworkDiskCachePrivate::cancelRemoval(const QString &file)
+{
+#if QT_CONFIG(thread)
+    QMutexLocker locker(&removalMutex);
+    pendingRemovals.remove(file);
+    while (removing == file)
+        removalDone.wait(&removalMutex);
+#else
+    Q_UNUSED(file);
+#endif
+}
+
+bool QNetworkDiskCachePrivate::isPendingRemoval(const QString &file) const
+{
+#if QT_CONFIG(thread)
+    QMutexLocker locker(&removalMutex);
+    return pendingRemovals.contains(file) || removing == file;
+#else
+    Q_UNUSED(file);
+    return false;
+#endif
+}
+
+void QNetworkDiskCachePrivate::waitForRemovals()
+{
+#if QT_CONFIG(thread)
+    QMutexLocker locker(&removalMutex);
+    while (removalScheduled)
+        removalDone.wait(&removalMutex);
+#endif
+}
+
 QT_END_NAMESPACE
@@ -57,6 +57,12 @@
 #include <qbuffer.h>
 #include <qhash.h>
 #include <qtemporaryfile.h>
+#if QT_CONFIG(thread)
+#include <qmutex.h>
+#include <qset.h>
+#include <qthreadpool.h>
+#include <qwaitcondition.h>
+#endif
 
 QT_REQUIRE_CONFIG(networkdiskcache);
 
@@ -101,22 +107,73 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
-        {}
+        {
+#if QT_CONFIG(thread)
+            // removals are serialized so that cancelRemoval() only has to
+            // wait for the file that is currently being removed
+            removalPool.setMaxThreadCount(1);
+#endif
+        }
+
+    // What the index knows about a file in the data directory, keyed by
+    // cacheKey(). lastAccess is a logical clock rather than a time stamp, so
+    // that the LRU order is exact and survives clock changes.
+    struct IndexEntry
+    {
+        qint64 size = 0;
+        qint64 expiration = 0; // msecs since epoch, 0 if unknown
+        quint64 lastAccess = 0;
+    };
 
+    static quint64 cacheKey(const QUrl &url);
+    static QString uniqueFileName(quint64 key);
     static QString uniqueFileName(const QUrl &url);
     QString cacheFileName(const QUrl &url) const;
+    QString cacheFileName(quint64 key) const;
+    bool cacheKeyOf(const QString &fileName, quint64 *key) const;
     QString tmpCacheFileName() const;
     bool removeFile(const QString &file);
+    void forgetFile(const QString &file);
     void storeItem(QCacheItem *item);
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    void ensureIndex();
+    bool loadIndex();
+    void scanIndex();
+    void saveIndex();
+    void resetIndex();
+    void touch(quint64 key);
+    void evict(qint64 goal);
+
+    void scheduleRemoval(const QString &file);
+    void cancelRemoval(const QString &file);
+    bool isPendingRemoval(const QString &file) const;
+    void waitForRemovals();
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
 
+    QHash<quint64, IndexEntry> index;
+    qint64 indexSize = 0;
+    quint64 accessClock = 0;
+    bool indexLoaded = false;
+
+#if QT_CONFIG(thread)
+    void processRemovals();
+
+    mutable QMutex removalMutex;
+    QWaitCondition removalDone;
+    QList<QString> removalQueue;
+    QSet<QString> pendingRemovals;
+    QString removing;
+    bool removalScheduled = false;
+    QThreadPool removalPool;
+#endif
+
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
@@ -788,6 +788,9 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
     // Propagate Http/2 settings:
     delegate->http2Parameters = request.http2Configuration();
+    // ... and the connection pool policy of the manager:
+    delegate->connectionPoolConfiguration = managerPrivate->connectionPoolConfiguration;
+    delegate->connectionPoolCounters = managerPrivate->connectionPoolCounters;
 
     // For the synchronous HTTP, this is the normal way the delegate gets deleted
     // For the asynchronous HTTP this is a safety measure, the delegate deletes itself when HTTP is finished
@@ -41,7 +41,11 @@ qtConfig(dnslookup) {
 }
 
 unix {
-    !integrity:qtConfig(dnslookup): SOURCES += kernel/qdnslookup_unix.cpp
+    !integrity:qtConfig(dnslookup) {
+        HEADERS += kernel/qdnsresolver_p.h
+        SOURCES += kernel/qdnslookup_unix.cpp \
+                   kernel/qdnsresolver.cpp
+    }
 
     SOURCES += kernel/qhostinfo_unix.cpp
 
@@ -52,7 +56,8 @@ unix {
 }
 
 android:qtConfig(dnslookup) {
-    SOURCES -= kernel/qdnslookup_unix.cpp
+    HEADERS -= kernel/qdnsresolver_p.h
+    SOURCES -= kernel/qdnslookup_unix.cpp kernel/qdnsresolver.cpp
     SOURCES += kernel/qdnslookup_android.cpp
 }
 
@@ -87,6 +87,10 @@ public:
     QList<QDnsDomainNameRecord> pointerRecords;
     QList<QDnsServiceRecord> serviceRecords;
     QList<QDnsTextRecord> textRecords;
+
+    // For how long a negative answer may be cached, from the SOA record
+    // in its authority section; 0 if there was none.
+    quint32 negativeTimeToLive = 0;
 };
 
 class QDnsLookupPrivate : public QObjectPrivate
@@ -124,6 +128,10 @@ public:
     { }
     void run() override;
 
+    // Parses a DNS response message; also used by QDnsResolver.
+    static void parseReply(const unsigned char *response, int responseLength,
+                           QDnsLookupReply *reply);
+
 signals:
     void finished(const QDnsLookupReply &reply);
 
@@ -222,12 +222,26 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         }
     }
 
-    unsigned char *response = buffer.data();
+    parseReply(buffer.data(), responseLength, reply);
+}
+
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength,
+                                    QDnsLookupReply *reply)
+{
+    // Load dn_expand on demand.
+    resolveLibrary();
+    if (!local_dn_expand) {
+        reply->error = QDnsLookup::ResolverError;
+        reply->errorString = tr("Resolver functions not found");
+        return;
+    }
+
     // Check the response header. Though res_nquery returns -1 as a
     // responseLength in case of error, we still can extract the
     // exact error code from the response.
-    HEADER *header = (HEADER*)response;
+    const HEADER *header = reinterpret_cast<const HEADER *>(response);
     const int answerCount = ntohs(header->ancount);
+    const int authorityCount = ntohs(header->nscount);
     switch (header->rcode) {
     case NOERROR:
         break;
@@ -240,9 +254,11 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         reply->errorString = tr("Server failure");
         return;
     case NXDOMAIN:
+        // Go on reading the authority section, which tells for how
+        // long the name is known not to exist.
         reply->error = QDnsLookup::NotFoundError;
         reply->errorString = tr("Non existent domain");
-        return;
+        break;
     case REFUSED:
         reply->error = QDnsLookup::ServerRefusedError;
         reply->errorString = tr("Server refused to answer");
@@ -255,14 +271,16 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
 
     // Check the reply is valid.
     if (responseLength < int(sizeof(HEADER))) {
-        reply->error = QDnsLookup::InvalidReplyError;
-        reply->errorString = tr("Invalid reply received");
+        if (reply->error == QDnsLookup::NoError) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+        }
         return;
     }
 
     // Skip the query host, type (2 bytes) and class (2 bytes).
     char host[PACKETSZ], answer[PACKETSZ];
-    unsigned char *p = response + sizeof(HEADER);
+    const unsigned char *p = response + sizeof(HEADER);
     int status = local_dn_expand(response, response + responseLength, p, host, sizeof(host));
     if (status < 0) {
         reply->error = QDnsLookup::InvalidReplyError;
@@ -270,10 +288,16 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         return;
     }
     p += status + 4;
+    const unsigned char *const end = response + responseLength;
+    if (p > end) {
+        reply->error = QDnsLookup::InvalidReplyError;
+        reply->errorString = tr("Invalid reply received");
+        return;
+    }
 
     // Extract results.
     int answerIndex = 0;
-    while ((p < response + responseLength) && (answerIndex < answerCount)) {
+    while ((p < end) && (answerIndex < answerCount + authorityCount)) {
         status = local_dn_expand(response, response + responseLength, p, host, sizeof(host));
         if (status < 0) {
             reply->error = QDnsLookup::InvalidReplyError;
@@ -283,6 +307,12 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         const QString name = QUrl::fromAce(host);
 
         p += status;
+        // The record's type, class, TTL and RDATA length, then its RDATA
+        if (end - p < 10) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+            return;
+        }
         const quint16 type = (p[0] << 8) | p[1];
         p += 2; // RR type
         p += 2; // RR class
@@ -290,6 +320,31 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         p += 4;
         const quint16 size = (p[0] << 8) | p[1];
         p += 2;
+        if (end - p < size) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+            return;
+        }
+
+        if (answerIndex >= answerCount || reply->error != QDnsLookup::NoError) {
+            // RFC 2308, 5: a negative answer may be cached for the lower
+            // of the SOA record's TTL and its MINIMUM field.
+            if (type == ns_t_soa) {
+                const unsigned char *soa = p;
+                for (int i = 0; i < 2 && soa; ++i) { // MNAME and RNAME
+                    status = local_dn_expand(response, response + responseLength, soa,
+                                             answer, sizeof(answer));
+                    soa = status < 0 ? nullptr : soa + status;
+                }
+                if (soa && soa + 20 <= p + size) {
+                    const quint32 minimum = (soa[16] << 24) | (soa[17] << 16) | (soa[18] << 8) | soa[19];
+                    reply->negativeTimeToLive = qMin(ttl, minimum);
+                }
+            }
+            p += size;
+            answerIndex++;
+            continue;
+        }
 
         if (type == QDnsLookup::A) {
             if (size != 4) {
@@ -351,6 +406,11 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             record.d->value = QUrl::fromAce(answer);
             reply->pointerRecords.append(record);
         } else if (type == QDnsLookup::MX) {
+            if (size < 2) {
+                reply->error = QDnsLookup::InvalidReplyError;
+                reply->errorString = tr("Invalid mail exchange record");
+                return;
+            }
             const quint16 preference = (p[0] << 8) | p[1];
             status = local_dn_expand(response, response + responseLength, p + 2, answer, sizeof(answer));
             if (status < 0) {
@@ -365,6 +425,11 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             record.d->timeToLive = ttl;
             reply->mailExchangeRecords.append(record);
         } else if (type == QDnsLookup::SRV) {
+            if (size < 6) {
+                reply->error = QDnsLookup::InvalidReplyError;
+                reply->errorString = tr("Invalid service record");
+                return;
+            }
             const quint16 priority = (p[0] << 8) | p[1];
             const quint16 weight = (p[2] << 8) | p[3];
             const quint16 port = (p[4] << 8) | p[5];
@@ -383,7 +448,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             record.d->weight = weight;
             reply->serviceRecords.append(record);
         } else if (type == QDnsLookup::TXT) {
-            unsigned char *txt = p;
+            const unsigned char *txt = p;
             QDnsTextRecord record;
             record.d->name = name;
             record.d->timeToLive = ttl;
@@ -395,7 +460,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
                     reply->errorString = tr("Invalid text record");
                     return;
                 }
-                record.d->values << QByteArray((char*)txt, length);
+                record.d->values << QByteArray((const char*)txt, length);
                 txt += length;
             }
             reply->textRecords.append(record);
@@ -416,6 +481,15 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     return;
 }
 
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength,
+                                    QDnsLookupReply *reply)
+{
+    Q_UNUSED(response);
+    Q_UNUSED(responseLength);
+    reply->error = QDnsLookup::ResolverError;
+    reply->errorString = tr("Resolver library can't be loaded: No runtime library loading support");
+}
+
 #endif /* QT_CONFIG(library) */
 
 QT_END_NAMESPACE
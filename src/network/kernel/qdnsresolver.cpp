@@ -0,0 +1,525 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdnsresolver_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrandom.h>
+#include <QtCore/qset.h>
+#include <QtCore/qurl.h>
+#include <QtNetwork/qnetworkdatagram.h>
+#if QT_CONFIG(networkinterface)
+#include <QtNetwork/qnetworkinterface.h>
+#endif
+#include <QtNetwork/qtcpsocket.h>
+#include <QtNetwork/qudpsocket.h>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+enum {
+    HeaderSize = 12,
+    TypeA = 1,
+    TypeAAAA = 28
+};
+
+/*
+    Reads the name servers, search domains and options from
+    /etc/resolv.conf, like res_ninit() does.
+*/
+QDnsResolverConfiguration QDnsResolverConfiguration::systemConfiguration()
+{
+    QDnsResolverConfiguration configuration;
+    QFile file(QStringLiteral("/etc/resolv.conf"));
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine();
+            const QList<QByteArray> fields = line.simplified().split(' ');
+            if (fields.size() < 2 || fields.first().startsWith('#')
+                || fields.first().startsWith(';')) {
+                continue;
+            }
+            const QByteArray &keyword = fields.first();
+            if (keyword == "nameserver") {
+                const QHostAddress address(QString::fromLatin1(fields.at(1)));
+                if (!address.isNull())
+                    configuration.nameservers.append({ address, 53 });
+            } else if (keyword == "domain" || keyword == "search") {
+                configuration.searchDomains.clear();
+                for (int i = 1; i < fields.size(); ++i)
+                    configuration.searchDomains.append(QString::fromLatin1(fields.at(i)));
+            } else if (keyword == "options") {
+                for (int i = 1; i < fields.size(); ++i) {
+                    const QByteArray &option = fields.at(i);
+                    const int separator = option.indexOf(':');
+                    if (separator == -1)
+                        continue;
+                    bool ok = false;
+                    const int value = option.mid(separator + 1).toInt(&ok);
+                    if (!ok)
+                        continue;
+                    const QByteArray name = option.left(separator);
+                    if (name == "ndots")
+                        configuration.ndots = qBound(0, value, 15);
+                    else if (name == "timeout")
+                        configuration.timeout = qBound(1, value, 30) * 1000;
+                    else if (name == "attempts")
+                        configuration.attempts = qBound(1, value, 5);
+                }
+            }
+        }
+    }
+
+#if QT_CONFIG(networkinterface)
+    const QList<QHostAddress> localAddresses = QNetworkInterface::allAddresses();
+    configuration.ipv6 = std::any_of(localAddresses.cbegin(), localAddresses.cend(),
+                                     [](const QHostAddress &address) {
+        return address.protocol() == QAbstractSocket::IPv6Protocol && !address.isLoopback()
+                && !address.isLinkLocal();
+    });
+#endif
+    return configuration;
+}
+
+// Returns the question section for name and type, or an empty array if
+// name cannot be encoded.
+static QByteArray encodeQuestion(const QByteArray &name, quint16 type)
+{
+    QByteArray question;
+    const QList<QByteArray> labels = name.split('.');
+    for (int i = 0; i < labels.size(); ++i) {
+        const QByteArray &label = labels.at(i);
+        if (label.isEmpty() && i == labels.size() - 1)
+            break;
+        if (label.isEmpty() || label.size() > 63)
+            return QByteArray();
+        question += char(label.size());
+        question += label;
+    }
+    if (question.isEmpty() || question.size() > 254)
+        return QByteArray();
+    question += '\0';
+    const uchar footer[] = { uchar(type >> 8), uchar(type), 0, 1 }; // class IN
+    question.append(reinterpret_cast<const char *>(footer), sizeof(footer));
+    return question;
+}
+
+QDnsResolverQuery::QDnsResolverQuery(const QByteArray &name, quint16 type,
+                                     const QDnsResolverConfiguration &configuration,
+                                     QObject *parent)
+    : QObject(parent), type(type), configuration(configuration),
+      question(encodeQuestion(name, type)), id(quint16(QRandomGenerator::global()->generate()))
+{
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &QDnsResolverQuery::nextAttempt);
+}
+
+void QDnsResolverQuery::start()
+{
+    if (question.isEmpty()) {
+        reply.error = QDnsLookup::InvalidRequestError;
+        reply.errorString = tr("Invalid domain name");
+        finish();
+    } else if (configuration.nameservers.isEmpty()) {
+        reply.error = QDnsLookup::ResolverError;
+        reply.errorString = tr("No name servers");
+        finish();
+    } else {
+        sendDatagram();
+    }
+}
+
+void QDnsResolverQuery::sendDatagram()
+{
+    if (!udpSocket) {
+        udpSocket = new QUdpSocket(this);
+        connect(udpSocket, &QUdpSocket::readyRead, this, &QDnsResolverQuery::readDatagrams);
+    }
+    const uchar header[HeaderSize] = { uchar(id >> 8), uchar(id),
+                                       0x01, 0x00, // recursion desired
+                                       0, 1, 0, 0, 0, 0, 0, 0 };
+    QByteArray message(reinterpret_cast<const char *>(header), sizeof(header));
+    message += question;
+    const QDnsResolverConfiguration::Nameserver &server =
+            configuration.nameservers.at(serverIndex);
+    udpSocket->writeDatagram(message, server.address, server.port);
+    timer.start(configuration.timeout);
+}
+
+void QDnsResolverQuery::readDatagrams()
+{
+    while (udpSocket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = udpSocket->receiveDatagram();
+        const bool fromNameserver = std::any_of(configuration.nameservers.cbegin(),
+                                                configuration.nameservers.cend(),
+                                                [&datagram](const QDnsResolverConfiguration::Nameserver &server) {
+            return server.address.isEqual(datagram.senderAddress(),
+                                          QHostAddress::TolerantConversion)
+                    && server.port == datagram.senderPort();
+        });
+        if (fromNameserver)
+            processResponse(datagram.data(), false);
+        if (isFinished || tcpSocket)
+            return;
+    }
+}
+
+void QDnsResolverQuery::sendOverTcp()
+{
+    tcpBuffer.clear();
+    QTcpSocket *socket = new QTcpSocket(this);
+    tcpSocket = socket;
+    const uchar header[HeaderSize + 2] = { uchar((HeaderSize + question.size()) >> 8),
+                                           uchar(HeaderSize + question.size()),
+                                           uchar(id >> 8), uchar(id),
+                                           0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0 };
+    QByteArray message(reinterpret_cast<const char *>(header), sizeof(header));
+    message += question;
+    connect(socket, &QTcpSocket::connected, this, [socket, message]() {
+        socket->write(message);
+    });
+    connect(socket, &QTcpSocket::readyRead, this, &QDnsResolverQuery::readTcp);
+    connect(socket, &QTcpSocket::errorOccurred, this, [this, socket]() {
+        if (socket == tcpSocket)
+            nextAttempt();
+    }, Qt::QueuedConnection);
+    const QDnsResolverConfiguration::Nameserver &server =
+            configuration.nameservers.at(serverIndex);
+    tcpSocket->connectToHost(server.address, server.port);
+    timer.start(configuration.timeout);
+}
+
+void QDnsResolverQuery::readTcp()
+{
+    tcpBuffer += tcpSocket->readAll();
+    if (tcpBuffer.size() < 2)
+        return;
+    const int size = qFromBigEndian<quint16>(tcpBuffer.constData());
+    if (tcpBuffer.size() < 2 + size)
+        return;
+    processResponse(tcpBuffer.mid(2, size), true);
+    if (!isFinished && tcpSocket)
+        nextAttempt();
+}
+
+void QDnsResolverQuery::nextAttempt()
+{
+    if (isFinished)
+        return;
+    if (tcpSocket) {
+        tcpSocket->disconnect(this);
+        tcpSocket->deleteLater();
+        tcpSocket = nullptr;
+    }
+    if (++serverIndex == configuration.nameservers.size()) {
+        serverIndex = 0;
+        if (++attempt == configuration.attempts) {
+            if (reply.error == QDnsLookup::NoError) {
+                reply.error = QDnsLookup::ResolverError;
+                reply.errorString = tr("Name server timeout");
+            }
+            finish();
+            return;
+        }
+    }
+    sendDatagram();
+}
+
+void QDnsResolverQuery::processResponse(const QByteArray &response, bool overTcp)
+{
+    // Anything that does not answer our question is ignored.
+    const uchar *data = reinterpret_cast<const uchar *>(response.constData());
+    if (response.size() < HeaderSize + question.size()
+        || qFromBigEndian<quint16>(data) != id || !(data[2] & 0x80)
+        || qFromBigEndian<quint16>(data + 4) != 1
+        || qstrnicmp(response.constData() + HeaderSize, question.size(),
+                     question.constData(), question.size()) != 0) {
+        return;
+    }
+
+    // Truncated: ask the same server again over TCP
+    if ((data[2] & 0x02) && !overTcp) {
+        sendOverTcp();
+        return;
+    }
+
+    QDnsLookupReply result;
+    QDnsLookupRunnable::parseReply(data, response.size(), &result);
+    switch (result.error) {
+    case QDnsLookup::NoError:
+    case QDnsLookup::NotFoundError:
+        reply = result;
+        finish();
+        break;
+    default:
+        // Another server may know better
+        reply.error = result.error;
+        reply.errorString = result.errorString;
+        if (!overTcp)
+            nextAttempt();
+        break;
+    }
+}
+
+void QDnsResolverQuery::finish()
+{
+    timer.stop();
+    if (udpSocket)
+        udpSocket->disconnect(this);
+    if (tcpSocket)
+        tcpSocket->disconnect(this);
+    isFinished = true;
+    emit finished();
+}
+
+namespace {
+// The names in /etc/hosts, which the system's resolver answers for
+class HostsFile
+{
+public:
+    bool contains(const QString &name)
+    {
+        const QMutexLocker locker(&mutex);
+        const QFileInfo info(QStringLiteral("/etc/hosts"));
+        const QDateTime modified = info.lastModified();
+        if (modified != lastModified) {
+            lastModified = modified;
+            read();
+        }
+        return names.contains(name);
+    }
+
+private:
+    void read()
+    {
+        names.clear();
+        QFile file(QStringLiteral("/etc/hosts"));
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return;
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            const int comment = line.indexOf('#');
+            if (comment != -1)
+                line.truncate(comment);
+            const QList<QByteArray> fields = line.simplified().split(' ');
+            for (int i = 1; i < fields.size(); ++i)
+                names.insert(QString::fromLatin1(fields.at(i)).toLower());
+        }
+    }
+
+    QMutex mutex;
+    QDateTime lastModified;
+    QSet<QString> names;
+};
+}
+
+Q_GLOBAL_STATIC(HostsFile, hostsFile)
+
+QDnsResolver::QDnsResolver(const QDnsResolverConfiguration &configuration, QObject *parent)
+    : QObject(parent), configuration(configuration)
+{
+}
+
+QDnsResolver::~QDnsResolver()
+{
+    qDeleteAll(lookups);
+}
+
+/*
+    Returns whether name is for us. Names that the system's resolver
+    may answer differently are not: literal addresses, names in the
+    hosts file, mDNS names and names that are first looked up with the
+    search domains appended.
+*/
+bool QDnsResolver::canResolve(const QString &name) const
+{
+    if (configuration.nameservers.isEmpty() || !QHostAddress(name).isNull())
+        return false;
+
+    QString lowerName = name.toLower();
+    const bool absolute = lowerName.endsWith(QLatin1Char('.'));
+    if (absolute)
+        lowerName.chop(1);
+    if (lowerName.isEmpty() || QUrl::toAce(lowerName).isEmpty())
+        return false;
+    if (!absolute && !configuration.searchDomains.isEmpty()
+        && lowerName.count(QLatin1Char('.')) < configuration.ndots) {
+        return false;
+    }
+    if (!lowerName.contains(QLatin1Char('.')) || lowerName.endsWith(QLatin1String(".local"))
+        || lowerName.endsWith(QLatin1String(".localhost"))) {
+        return false;
+    }
+    return !hostsFile()->contains(lowerName);
+}
+
+void QDnsResolver::lookup(const QString &name)
+{
+    if (lookups.contains(name))
+        return;
+
+    Lookup *lookup = new Lookup;
+    lookups.insert(name, lookup);
+    lookup->resolutionDelay.setSingleShot(true);
+    connect(&lookup->resolutionDelay, &QTimer::timeout, this, [this, name]() { complete(name); });
+
+    const QByteArray aceName = QUrl::toAce(name);
+    lookup->ipv4 = new QDnsResolverQuery(aceName, TypeA, configuration, lookup);
+    connect(lookup->ipv4, &QDnsResolverQuery::finished, this, [this, name]() { queryFinished(name); });
+    if (configuration.ipv6) {
+        lookup->ipv6 = new QDnsResolverQuery(aceName, TypeAAAA, configuration, lookup);
+        connect(lookup->ipv6, &QDnsResolverQuery::finished, this,
+                [this, name]() { queryFinished(name); });
+        lookup->ipv6->start();
+    }
+    lookup->ipv4->start();
+}
+
+void QDnsResolver::queryFinished(const QString &name)
+{
+    Lookup *lookup = lookups.value(name);
+    if (!lookup)
+        return;
+    if (lookup->ipv4->isFinished && (!lookup->ipv6 || lookup->ipv6->isFinished)) {
+        complete(name);
+    } else if (lookup->ipv4->isFinished && !lookup->ipv4->reply.hostAddressRecords.isEmpty()
+               && !lookup->resolutionDelay.isActive()) {
+        lookup->resolutionDelay.start(resolutionDelay);
+    }
+}
+
+static QString normalizedOwnerName(QString name)
+{
+    if (name.endsWith(QLatin1Char('.')))
+        name.chop(1);
+    return std::move(name).toLower();
+}
+
+// The names an answer to a query for \a name may carry addresses for:
+// the name itself and the targets of the CNAME chain starting there.
+static QSet<QString> ownerNames(const QString &name, const QDnsLookupReply &reply)
+{
+    QSet<QString> owners = { normalizedOwnerName(QUrl::fromAce(QUrl::toAce(name))) };
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (const QDnsDomainNameRecord &record : reply.canonicalNameRecords) {
+            const QString target = normalizedOwnerName(record.value());
+            if (!owners.contains(target) && owners.contains(normalizedOwnerName(record.name()))) {
+                owners.insert(target);
+                grown = true;
+            }
+        }
+    }
+    return owners;
+}
+
+void QDnsResolver::complete(const QString &name)
+{
+    Lookup *lookup = lookups.take(name);
+    if (!lookup)
+        return;
+
+    QHostInfo info;
+    info.setHostName(name);
+    QList<QHostAddress> addresses;
+    quint32 timeToLive = std::numeric_limits<quint32>::max();
+    quint32 negativeTimeToLive = std::numeric_limits<quint32>::max();
+    bool negative = true;
+    // IPv6 first, as QAbstractSocket interleaves the families from there
+    for (QDnsResolverQuery *query : { lookup->ipv6, lookup->ipv4 }) {
+        if (!query || !query->isFinished)
+            continue;
+        const QDnsLookupReply &reply = query->reply;
+        const auto protocol = query->type == TypeA ? QAbstractSocket::IPv4Protocol
+                                                   : QAbstractSocket::IPv6Protocol;
+        // Records for other names are not part of the answer
+        const QSet<QString> owners = ownerNames(name, reply);
+        for (const QDnsHostAddressRecord &record : reply.hostAddressRecords) {
+            if (record.value().protocol() != protocol || addresses.contains(record.value())
+                || !owners.contains(normalizedOwnerName(record.name()))) {
+                continue;
+            }
+            addresses.append(record.value());
+            timeToLive = qMin(timeToLive, record.timeToLive());
+        }
+        for (const QDnsDomainNameRecord &record : reply.canonicalNameRecords) {
+            if (owners.contains(normalizedOwnerName(record.name())))
+                timeToLive = qMin(timeToLive, record.timeToLive());
+        }
+        if (reply.error != QDnsLookup::NoError && reply.error != QDnsLookup::NotFoundError)
+            negative = false;
+        negativeTimeToLive = qMin(negativeTimeToLive, reply.negativeTimeToLive);
+    }
+    // A negative answer without an SOA record must not be cached (RFC 2308, section 5);
+    // replies without one report 0, which keeps the result out of the cache.
+    if (negativeTimeToLive == std::numeric_limits<quint32>::max())
+        negativeTimeToLive = 0;
+    // We may be called from a query's signal, so the queries
+    // are deleted later, and must not call us anymore.
+    lookup->resolutionDelay.stop();
+    lookup->ipv4->disconnect(this);
+    if (lookup->ipv6)
+        lookup->ipv6->disconnect(this);
+    lookup->deleteLater();
+
+    int result = -1;
+    if (!addresses.isEmpty()) {
+        info.setAddresses(addresses);
+        result = int(qMin(timeToLive, quint32(std::numeric_limits<int>::max())));
+    } else if (negative && (configuration.searchDomains.isEmpty()
+                            || name.endsWith(QLatin1Char('.')))) {
+        // Without search domains to try, the name does not exist
+        info.setError(QHostInfo::HostNotFound);
+        info.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Host not found"));
+        result = int(qMin(negativeTimeToLive, quint32(std::numeric_limits<int>::max())));
+    } else {
+        info.setError(QHostInfo::UnknownError);
+        info.setErrorString(QCoreApplication::translate("QHostInfo", "Unknown error"));
+    }
+    emit finished(name, info, result);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDNSRESOLVER_P_H
+#define QDNSRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "QtNetwork/qhostaddress.h"
+#include "QtNetwork/qhostinfo.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qobject.h"
+#include "QtCore/qstringlist.h"
+#include "QtCore/qtimer.h"
+#include "qdnslookup_p.h"
+
+QT_REQUIRE_CONFIG(dnslookup);
+QT_REQUIRE_CONFIG(udpsocket);
+
+QT_BEGIN_NAMESPACE
+
+class QTcpSocket;
+class QUdpSocket;
+
+class Q_NETWORK_EXPORT QDnsResolverConfiguration
+{
+public:
+    struct Nameserver {
+        QHostAddress address;
+        quint16 port = 53;
+    };
+
+    QList<Nameserver> nameservers;
+    QStringList searchDomains;
+    int ndots = 1;
+    int timeout = 5000; // per attempt, in milliseconds
+    int attempts = 2;
+    // Whether to ask for AAAA records, like AI_ADDRCONFIG does when the
+    // host has no IPv6 address
+    bool ipv6 = true;
+
+    static QDnsResolverConfiguration systemConfiguration();
+};
+
+// Asks the name servers one question, retrying with the next one on
+// timeouts and failures, and over TCP if the answer was truncated.
+class QDnsResolverQuery : public QObject
+{
+    Q_OBJECT
+public:
+    QDnsResolverQuery(const QByteArray &name, quint16 type,
+                      const QDnsResolverConfiguration &configuration, QObject *parent);
+
+    void start();
+
+    const quint16 type;
+    QDnsLookupReply reply;
+    bool isFinished = false;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    void sendDatagram();
+    void readDatagrams();
+    void sendOverTcp();
+    void readTcp();
+    void nextAttempt();
+    void processResponse(const QByteArray &response, bool overTcp);
+    void finish();
+
+    const QDnsResolverConfiguration &configuration;
+    QByteArray question;
+    quint16 id = 0;
+    int serverIndex = 0;
+    int attempt = 0;
+    QUdpSocket *udpSocket = nullptr;
+    QTcpSocket *tcpSocket = nullptr;
+    QByteArray tcpBuffer;
+    QTimer timer;
+};
+
+// Resolves host names by sending A and AAAA queries in parallel from a
+// single thread, without blocking it. Lookups it cannot answer for sure
+// finish with a negative timeToLive, and are for the system's resolver.
+class QDnsResolver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QDnsResolver(const QDnsResolverConfiguration &configuration,
+                          QObject *parent = nullptr);
+    ~QDnsResolver();
+
+    // Thread-safe
+    bool canResolve(const QString &name) const;
+
+    void lookup(const QString &name);
+
+    // RFC 8305, 3: how long to wait for the AAAA answer once the A
+    // answer has arrived
+    static const int resolutionDelay = 50;
+
+Q_SIGNALS:
+    void finished(const QString &name, const QHostInfo &info, int timeToLive);
+
+private:
+    struct Lookup : QObject
+    {
+        QDnsResolverQuery *ipv4 = nullptr;
+        QDnsResolverQuery *ipv6 = nullptr;
+        QTimer resolutionDelay;
+    };
+
+    void queryFinished(const QString &name);
+    void complete(const QString &name);
+
+    const QDnsResolverConfiguration configuration;
+    QHash<QString, Lookup *> lookups;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDNSRESOLVER_P_H
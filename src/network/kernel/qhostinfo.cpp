@@ -41,6 +41,9 @@
 
 #include "qhostinfo.h"
 #include "qhostinfo_p.h"
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+#include "qdnsresolver_p.h"
+#endif
 #include <qplatformdefs.h>
 
 #include "QtCore/qscopedpointer.h"
@@ -244,6 +247,12 @@ bool QHostInfoResult::event(QEvent *event)
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
     for performance improvements.
+    \note On Unix systems, setting the environment variable \c QT_DNS_RESOLVER
+    to 1 makes lookupHost() query the name servers listed in
+    \c{/etc/resolv.conf} directly, asking for IPv4 and IPv6 addresses in
+    parallel and caching the results for as long as their time-to-live
+    allows. Names that the system resolves by other means, such as the
+    hosts file, are still looked up by the operating system.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492},
     {https://tools.ietf.org/html/rfc6724}{RFC 6724}
@@ -841,7 +850,10 @@ int QHostInfo::lookupHostImpl(const QString &name,
         if (receiver && member)
             QObject::connect(&runnable->resultEmitter, SIGNAL(resultsReady(QHostInfo)),
                                 receiver, member, Qt::QueuedConnection);
-        manager->scheduleLookup(runnable);
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+        if (!manager->scheduleDnsLookup(runnable))
+#endif
+            manager->scheduleLookup(runnable);
     }
     return id;
 }
@@ -918,6 +930,13 @@ QHostInfoLookupManager::QHostInfoLookupManager() : wasDeleted(false)
                      Qt::DirectConnection);
     threadPool.setMaxThreadCount(20); // do up to 20 DNS lookups in parallel
 #endif
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    if (qEnvironmentVariableIntValue("QT_DNS_RESOLVER")) {
+        const QDnsResolverConfiguration configuration =
+                QDnsResolverConfiguration::systemConfiguration();
+        setDnsResolverConfiguration(&configuration);
+    }
+#endif
 }
 
 QHostInfoLookupManager::~QHostInfoLookupManager()
@@ -928,6 +947,12 @@ QHostInfoLookupManager::~QHostInfoLookupManager()
 
     // don't qDeleteAll currentLookups, the QThreadPool has ownership
     clear();
+
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    // the resolver is deleted when its thread finishes
+    dnsResolverThread.quit();
+    dnsResolverThread.wait();
+#endif
 }
 
 void QHostInfoLookupManager::clear()
@@ -939,6 +964,11 @@ void QHostInfoLookupManager::clear()
 #if QT_CONFIG(thread)
         qDeleteAll(postponedLookups);
         postponedLookups.clear();
+#endif
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+        for (const QList<QHostInfoRunnable *> &waiting : qAsConst(dnsLookups))
+            qDeleteAll(waiting);
+        dnsLookups.clear();
 #endif
         scheduledLookups.clear();
         finishedLookups.clear();
@@ -1046,6 +1076,18 @@ void QHostInfoLookupManager::abortLookup(int id)
         }
     }
 
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    // is waiting for the resolver? delete and return
+    for (QList<QHostInfoRunnable *> &waiting : dnsLookups) {
+        for (int i = 0; i < waiting.length(); i++) {
+            if (waiting.at(i)->id == id) {
+                delete waiting.takeAt(i);
+                return;
+            }
+        }
+    }
+#endif
+
     if (!abortedLookups.contains(id))
         abortedLookups.append(id);
 }
@@ -1076,6 +1118,101 @@ void QHostInfoLookupManager::lookupFinished(QHostInfoRunnable *r)
     rescheduleWithMutexHeld();
 }
 
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+void QHostInfoLookupManager::setDnsResolverConfiguration(const QDnsResolverConfiguration *configuration)
+{
+    QMutexLocker locker(&mutex);
+    if (wasDeleted)
+        return;
+
+    if (dnsResolver) {
+        dnsResolver->disconnect();
+        dnsResolver->deleteLater();
+        dnsResolver = nullptr;
+        // the system's resolver takes over
+        for (const QList<QHostInfoRunnable *> &waiting : qAsConst(dnsLookups)) {
+            for (QHostInfoRunnable *r : waiting)
+                scheduledLookups.enqueue(r);
+        }
+        dnsLookups.clear();
+        rescheduleWithMutexHeld();
+    }
+
+    if (configuration) {
+        if (!dnsResolverThread.isRunning()) {
+            dnsResolverThread.setObjectName(QStringLiteral("Qt DNS resolver"));
+            dnsResolverThread.start();
+        }
+        dnsResolver = new QDnsResolver(*configuration);
+        dnsResolver->moveToThread(&dnsResolverThread);
+        QObject::connect(&dnsResolverThread, &QThread::finished,
+                         dnsResolver, &QObject::deleteLater);
+        QObject::connect(dnsResolver, &QDnsResolver::finished, dnsResolver,
+                         [this](const QString &name, const QHostInfo &info, int timeToLive) {
+            dnsLookupFinished(name, info, timeToLive);
+        }, Qt::DirectConnection);
+    }
+    locker.unlock();
+
+    cache.clear();
+}
+
+// called by QHostInfo
+bool QHostInfoLookupManager::scheduleDnsLookup(QHostInfoRunnable *r)
+{
+    QMutexLocker locker(&this->mutex);
+
+    if (wasDeleted || !dnsResolver || !dnsResolver->canResolve(r->toBeLookedUp))
+        return false;
+
+    // only one lookup per host name is sent to the resolver
+    QList<QHostInfoRunnable *> &waiting = dnsLookups[r->toBeLookedUp];
+    waiting.append(r);
+    if (waiting.size() == 1) {
+        QDnsResolver *resolver = dnsResolver;
+        const QString name = r->toBeLookedUp;
+        QMetaObject::invokeMethod(resolver, [resolver, name]() { resolver->lookup(name); },
+                                  Qt::QueuedConnection);
+    }
+    return true;
+}
+
+// called from the QDnsResolver's thread
+void QHostInfoLookupManager::dnsLookupFinished(const QString &name, const QHostInfo &info,
+                                               int timeToLive)
+{
+    QMutexLocker locker(&this->mutex);
+
+    if (wasDeleted)
+        return;
+
+    const QList<QHostInfoRunnable *> waiting = dnsLookups.take(name);
+    if (timeToLive < 0) {
+        // the name servers could not tell, ask the system's resolver
+        for (QHostInfoRunnable *r : waiting)
+            scheduledLookups.enqueue(r);
+        rescheduleWithMutexHeld();
+        return;
+    }
+
+    if (cache.isEnabled())
+        cache.put(name, info, timeToLive);
+    for (QHostInfoRunnable *r : waiting) {
+        QHostInfo result = info;
+        result.setLookupId(r->id);
+        r->resultEmitter.postResultsReady(result);
+        delete r;
+    }
+}
+
+void qt_qhostinfo_set_dns_resolver(const QDnsResolverConfiguration *configuration)
+{
+    QHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (manager)
+        manager->setDnsResolverConfiguration(configuration);
+}
+#endif // QT_HOSTINFO_DNS_RESOLVER
+
 // This function returns immediately when we had a result in the cache, else it will later emit a signal
 QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char *member, bool *valid, int *id)
 {
@@ -1125,7 +1262,7 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 }
 #endif
 
-// cache for 60 seconds
+// cache for 60 seconds, or the DNS records' time to live
 // cache 128 items
 QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
 {
@@ -1140,7 +1277,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
     *valid = false;
     if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+        if (element->age.elapsed() < element->lifetime)
             *valid = true;
         return element->info;
 
@@ -1158,10 +1295,28 @@ void QHostInfoCache::put(const QString &name, const QHostInfo &info)
     if (info.error() != QHostInfo::NoError)
         return;
 
+    insert(name, info, max_age);
+}
+
+void QHostInfoCache::put(const QString &name, const QHostInfo &info, int timeToLive)
+{
+    // negative answers are kept no longer than the system's resolver results
+    if (info.error() == QHostInfo::HostNotFound)
+        timeToLive = qMin(timeToLive, max_age);
+    else if (info.error() != QHostInfo::NoError)
+        return;
+
+    if (timeToLive > 0)
+        insert(name, info, qMin(timeToLive, max_ttl));
+}
+
+void QHostInfoCache::insert(const QString &name, const QHostInfo &info, int lifetime)
+{
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
     element->age = QElapsedTimer();
     element->age.start();
+    element->lifetime = lifetime * qint64(1000);
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
@@ -65,6 +65,7 @@
 #include "QtCore/qthreadpool.h"
 #endif
 #include "QtCore/qrunnable.h"
+#include "QtCore/qhash.h"
 #include "QtCore/qlist.h"
 #include "QtCore/qqueue.h"
 #include <QElapsedTimer>
@@ -74,8 +75,18 @@
 
 #include <atomic>
 
+#if QT_CONFIG(dnslookup) && QT_CONFIG(udpsocket) && QT_CONFIG(thread) \
+    && defined(Q_OS_UNIX) && !defined(Q_OS_ANDROID) && !defined(Q_OS_INTEGRITY)
+#  define QT_HOSTINFO_DNS_RESOLVER
+#endif
+
 QT_BEGIN_NAMESPACE
 
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+class QDnsResolver;
+class QDnsResolverConfiguration;
+#endif
+
 
 class QHostInfoResult : public QObject
 {
@@ -150,15 +161,24 @@ QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *rec
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
 void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolution);
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+// Resolves host names with a QDnsResolver using configuration, or with the
+// system's resolver if it is null. Clears the cache.
+void Q_NETWORK_EXPORT qt_qhostinfo_set_dns_resolver(const QDnsResolverConfiguration *configuration);
+#endif
 
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    // Upper bound for the time to live of DNS records, in seconds
+    static const int max_ttl = 3600;
 
     QHostInfo get(const QString &name, bool *valid);
     void put(const QString &name, const QHostInfo &info);
+    // Caches a DNS answer, including a negative one, for timeToLive seconds
+    void put(const QString &name, const QHostInfo &info, int timeToLive);
     void clear();
 
     bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
@@ -170,7 +190,9 @@ private:
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        qint64 lifetime; // msecs
     };
+    void insert(const QString &name, const QHostInfo &info, int lifetime);
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
 };
@@ -206,6 +228,14 @@ public:
     void lookupFinished(QHostInfoRunnable *r);
     bool wasAborted(int id);
 
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    void setDnsResolverConfiguration(const QDnsResolverConfiguration *configuration);
+    // called from QHostInfo, returns false if the name is for the system's resolver
+    bool scheduleDnsLookup(QHostInfoRunnable *r);
+    // called from the QDnsResolver's thread
+    void dnsLookupFinished(const QString &name, const QHostInfo &info, int timeToLive);
+#endif
+
     QHostInfoCache cache;
 
     friend class QHostInfoRunnable;
@@ -220,6 +250,13 @@ protected:
 
 #if QT_CONFIG(thread)
     QThreadPool threadPool;
+#endif
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    // Lookups waiting for the resolver, which handles all of them in its
+    // own thread, by host name
+    QHash<QString, QList<QHostInfoRunnable *>> dnsLookups;
+    QDnsResolver *dnsResolver = nullptr;
+    QThread dnsResolverThread;
 #endif
     QMutex mutex;
 
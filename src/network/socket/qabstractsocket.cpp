@@ -476,6 +476,7 @@
 #include <qpointer.h>
 #include <qtimer.h>
 #include <qelapsedtimer.h>
+#include <qfile.h>
 #include <qscopedvaluerollback.h>
 #include <qvarlengtharray.h>
 
@@ -571,6 +572,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       isBuffered(false),
       hasPendingData(false),
       connectTimer(nullptr),
+      attemptDelayTimer(nullptr),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
       state(QAbstractSocket::UnconnectedState),
@@ -578,6 +580,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       preferredNetworkLayerProtocol(QAbstractSocket::UnknownNetworkLayerProtocol)
 {
     writeBufferChunkSize = QABSTRACTSOCKET_BUFFERSIZE;
+    parkedAttempt.d = this;
 }
 
 /*! \internal
@@ -600,6 +603,8 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    pendingFileWrites.clear();
+    discardParkedAttempt();
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -609,6 +614,8 @@ void QAbstractSocketPrivate::resetSocketLayer()
     }
     if (connectTimer)
         connectTimer->stop();
+    if (attemptDelayTimer)
+        attemptDelayTimer->stop();
 }
 
 /*! \internal
@@ -827,7 +834,7 @@ bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
     if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
-        && socketEngine->bytesToWrite() == 0)) {
+        && pendingFileWrites.isEmpty() && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
            (socketEngine && socketEngine->isValid()) ? "yes" : "no", writeBuffer.isEmpty() ? "yes" : "no");
@@ -844,7 +851,13 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
+    // Send the next queued file region once the data written before it is gone.
+    if (!pendingFileWrites.isEmpty() && pendingFileWrites.constFirst().bufferedBefore == 0)
+        return writeFileToSocket();
+
     qint64 nextSize = writeBuffer.nextDataBlockSize();
+    if (!pendingFileWrites.isEmpty())
+        nextSize = qMin(nextSize, pendingFileWrites.constFirst().bufferedBefore);
     const char *ptr = writeBuffer.readPointer();
 
     // Attempt to write it all in one chunk.
@@ -868,19 +881,119 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (!pendingFileWrites.isEmpty())
+            pendingFileWrites.first().bufferedBefore -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (writeBuffer.isEmpty() && pendingFileWrites.isEmpty() && socketEngine
+        && !socketEngine->bytesToWrite()) {
+        socketEngine->setWriteNotificationEnabled(false);
+    }
+    if (state == QAbstractSocket::ClosingState)
+        q->disconnectFromHost();
+
+    return written > 0;
+}
+
+/*! \internal
+
+    Sends the file region at the head of the queue, which must not be
+    preceded by any buffered data, to the socket. The kernel copies the
+    data from the file to the socket directly where the socket engine
+    supports it.
+
+    Emits bytesWritten().
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+    Q_Q(QAbstractSocket);
+    PendingFileWrite &fileWrite = pendingFileWrites.first();
+    if (!fileWrite.file || !fileWrite.file->isOpen()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File closed before it was written"));
+        q->abort();
+        return false;
+    }
+
+    const qint64 written = socketEngine->sendFile(fileWrite.file, fileWrite.offset,
+                                                  fileWrite.length);
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        // an unexpected error so close the socket.
+        q->abort();
+        return false;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes written to the network",
+           written);
+#endif
+
+    if (written > 0) {
+        fileWrite.offset += written;
+        fileWrite.length -= written;
+        if (fileWrite.length == 0)
+            pendingFileWrites.removeFirst();
+
+        emitBytesWritten(written);
+    }
+
+    if (writeBuffer.isEmpty() && pendingFileWrites.isEmpty() && socketEngine
+        && !socketEngine->bytesToWrite()) {
         socketEngine->setWriteNotificationEnabled(false);
+    }
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
 
     return written > 0;
 }
 
+/*! \internal
+
+    Queues \a length bytes of \a file, starting at \a offset, behind the
+    data already in the write buffer. Returns \a length, or -1 if the socket
+    can't send files.
+*/
+qint64 QAbstractSocketPrivate::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    if (state == QAbstractSocket::UnconnectedState || !socketEngine) {
+        setError(QAbstractSocket::UnknownSocketError, QAbstractSocket::tr("Socket is not connected"));
+        return -1;
+    }
+    if (socketType != QAbstractSocket::TcpSocket) {
+        setError(QAbstractSocket::UnsupportedSocketOperationError,
+                 QAbstractSocket::tr("Operation on socket is not supported"));
+        return -1;
+    }
+
+    qint64 bufferedBefore = writeBuffer.size();
+    for (const PendingFileWrite &fileWrite : qAsConst(pendingFileWrites))
+        bufferedBefore -= fileWrite.bufferedBefore;
+    pendingFileWrites.append({file, offset, length, bufferedBefore});
+
+    socketEngine->setWriteNotificationEnabled(true);
+    return length;
+}
+
+/*! \internal
+
+    Returns the number of bytes of queued file regions not sent yet.
+*/
+qint64 QAbstractSocketPrivate::pendingFileBytes() const
+{
+    qint64 bytes = 0;
+    for (const PendingFileWrite &fileWrite : pendingFileWrites)
+        bytes += fileWrite.length;
+    return bytes;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -891,7 +1004,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || !pendingFileWrites.isEmpty()) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -988,6 +1101,37 @@ void QAbstractSocketPrivate::startConnectingByName(const QString &host)
 
 #endif // !QT_NO_NETWORKPROXY
 
+/*! \internal
+
+    Reorders \a addresses so that the IPv6 and IPv4 addresses alternate,
+    starting with the family of the first address (RFC 8305, section 4).
+    A host that is unreachable over one family then only delays the
+    connection by one attempt.
+*/
+static QList<QHostAddress> interleaveAddressFamilies(const QList<QHostAddress> &addresses)
+{
+    if (addresses.isEmpty())
+        return addresses;
+
+    const QAbstractSocket::NetworkLayerProtocol firstFamily = addresses.first().protocol();
+    QList<QHostAddress> first;
+    QList<QHostAddress> second;
+    for (const QHostAddress &address : addresses)
+        (address.protocol() == firstFamily ? first : second) += address;
+    if (second.isEmpty())
+        return addresses;
+
+    QList<QHostAddress> result;
+    result.reserve(addresses.size());
+    for (int i = 0; i < qMax(first.size(), second.size()); ++i) {
+        if (i < first.size())
+            result += first.at(i);
+        if (i < second.size())
+            result += second.at(i);
+    }
+    return result;
+}
+
 /*! \internal
 
     Slot connected to QHostInfo::lookupHost() in connectToHost(). This
@@ -1009,7 +1153,7 @@ void QAbstractSocketPrivate::_q_startConnecting(const QHostInfo &hostInfo)
     // Only add the addresses for the preferred network layer.
     // Or all if preferred network layer is not set.
     if (preferredNetworkLayerProtocol == QAbstractSocket::UnknownNetworkLayerProtocol || preferredNetworkLayerProtocol == QAbstractSocket::AnyIPProtocol) {
-        addresses = hostInfo.addresses();
+        addresses = interleaveAddressFamilies(hostInfo.addresses());
     } else {
         const auto candidates = hostInfo.addresses();
         for (const QHostAddress &address : candidates) {
@@ -1070,6 +1214,13 @@ void QAbstractSocketPrivate::_q_startConnecting(const QHostInfo &hostInfo)
 void QAbstractSocketPrivate::_q_connectToNextAddress()
 {
     Q_Q(QAbstractSocket);
+    if (parkedAttempt.engine) {
+        // The attempt that was started earlier is still pending; carry on
+        // with it before trying any further addresses.
+        promoteParkedAttempt();
+        return;
+    }
+
     do {
         // Check for more pending addresses
         if (addresses.isEmpty()) {
@@ -1144,6 +1295,21 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
             }
             int connectTimeout = DefaultConnectTimeout;
             connectTimer->start(connectTimeout);
+
+            if (socketType == QAbstractSocket::TcpSocket
+#ifndef QT_NO_NETWORKPROXY
+                && proxyInUse.type() == QNetworkProxy::NoProxy
+#endif
+                && !addresses.isEmpty() && addresses.first() != host) {
+                if (!attemptDelayTimer) {
+                    attemptDelayTimer = new QTimer(q);
+                    attemptDelayTimer->setSingleShot(true);
+                    QObject::connect(attemptDelayTimer, &QTimer::timeout,
+                                     q, [this] { startParallelAttempt(); },
+                                     Qt::DirectConnection);
+                }
+                attemptDelayTimer->start(connectionAttemptDelay);
+            }
         }
 
         // Wait for a write notification that will eventually call
@@ -1205,7 +1371,7 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
 
     connectTimer->stop();
 
-    if (addresses.isEmpty()) {
+    if (addresses.isEmpty() && !parkedAttempt.engine) {
         state = QAbstractSocket::UnconnectedState;
         setError(QAbstractSocket::SocketTimeoutError,
                  QAbstractSocket::tr("Connection timed out"));
@@ -1216,6 +1382,113 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
     }
 }
 
+/*! \internal
+
+    Called by attemptDelayTimer when the current connection attempt has
+    not completed yet. Parks the attempt and starts connecting to the next
+    address, so that both attempts race.
+*/
+void QAbstractSocketPrivate::startParallelAttempt()
+{
+    if (state != QAbstractSocket::ConnectingState || !socketEngine || parkedAttempt.engine
+        || socketEngine->state() != QAbstractSocket::ConnectingState
+        || addresses.isEmpty() || addresses.first() == host) {
+        return;
+    }
+
+    QAbstractSocketEngine *engine = socketEngine;
+    const QHostAddress engineHost = host;
+    socketEngine = nullptr;
+    if (!initSocketLayer(addresses.first().protocol())) {
+        // keep waiting for the pending attempt only
+        resetSocketLayer();
+        socketEngine = engine;
+        connectTimer->start(DefaultConnectTimeout);
+        return;
+    }
+
+    parkedAttempt.engine = engine;
+    parkedAttempt.host = engineHost;
+    engine->setReceiver(&parkedAttempt);
+
+    host = addresses.takeFirst();
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::startParallelAttempt(), connecting to %s:%i besides %s",
+           host.toString().toLatin1().constData(), port,
+           engineHost.toString().toLatin1().constData());
+#endif
+    if (socketEngine->connectToHost(host, port)) {
+        fetchConnectionParameters();
+        return;
+    }
+    if (socketEngine->state() != QAbstractSocket::ConnectingState) {
+        promoteParkedAttempt();
+        return;
+    }
+
+    connectTimer->start(DefaultConnectTimeout);
+    socketEngine->setWriteNotificationEnabled(true);
+}
+
+/*! \internal
+
+    Called when the parked connection attempt completed. If it connected,
+    it replaces the current attempt; otherwise, it is dropped.
+*/
+void QAbstractSocketPrivate::parkedAttemptFinished()
+{
+    if (parkedAttempt.engine->state() != QAbstractSocket::ConnectedState) {
+#if defined(QABSTRACTSOCKET_DEBUG)
+        qDebug("QAbstractSocketPrivate::parkedAttemptFinished(), connection to %s failed",
+               parkedAttempt.host.toString().toLatin1().constData());
+#endif
+        discardParkedAttempt();
+        return;
+    }
+
+    promoteParkedAttempt();
+    _q_testConnection();
+}
+
+/*! \internal
+
+    Drops the current connection attempt and continues with the parked one.
+*/
+void QAbstractSocketPrivate::promoteParkedAttempt()
+{
+    QAbstractSocketEngine *engine = parkedAttempt.engine;
+    parkedAttempt.engine = nullptr;
+    resetSocketLayer();
+
+    socketEngine = engine;
+    host = parkedAttempt.host;
+    socketEngine->setReceiver(this);
+    if (socketEngine->state() != QAbstractSocket::ConnectingState)
+        return;
+
+    connectTimer->start(DefaultConnectTimeout);
+    if (!addresses.isEmpty() && addresses.first() != host)
+        attemptDelayTimer->start(connectionAttemptDelay);
+    socketEngine->setWriteNotificationEnabled(true);
+}
+
+/*! \internal
+
+    Closes the parked connection attempt, if any.
+*/
+void QAbstractSocketPrivate::discardParkedAttempt()
+{
+    if (!parkedAttempt.engine)
+        return;
+
+    QAbstractSocketEngine *engine = parkedAttempt.engine;
+    parkedAttempt.engine = nullptr;
+    engine->close();
+    engine->disconnect();
+    // this may be called from one of the engine's notifications
+    engine->deleteLater();
+}
+
 /*! \internal
 
     Reads data from the socket layer into the read buffer. Returns
@@ -1325,6 +1598,10 @@ void QAbstractSocketPrivate::fetchConnectionParameters()
 {
     Q_Q(QAbstractSocket);
 
+    discardParkedAttempt();
+    if (attemptDelayTimer)
+        attemptDelayTimer->stop();
+
     peerName = hostName;
     if (socketEngine) {
         if (q->isReadable()) {
@@ -1774,7 +2051,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->pendingFileBytes();
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2252,7 +2529,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (d->writeBuffer.isEmpty() && d->pendingFileWrites.isEmpty())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2269,7 +2546,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  !d->writeBuffer.isEmpty() || !d->pendingFileWrites.isEmpty(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2386,6 +2663,7 @@ void QAbstractSocket::abort()
     qDebug("QAbstractSocket::abort()");
 #endif
     d->setWriteChannelCount(0);
+    d->pendingFileWrites.clear();
     d->abortCalled = true;
     close();
 }
@@ -2416,6 +2694,54 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 6.1
+
+    Queues \a length bytes of \a file, starting at byte \a offset, for
+    sending after all data written to the socket so far. If \a length is -1
+    (the default), everything from \a offset to the end of the file is sent.
+    Returns the number of bytes queued, or -1 if an error occurred.
+
+    On platforms that support it, the operating system copies the data from
+    the file to an unencrypted TCP socket directly, so that it never passes
+    through the socket's write buffer. Otherwise the data is read in chunks as
+    the socket is ready to send it. A QSslSocket in encrypted mode reads the
+    whole region and buffers it like write() does. Either way, bytesWritten()
+    is emitted as the data is sent and the region counts towards
+    bytesToWrite() until then.
+
+    \a file must be open for reading and must stay open until its data has
+    been sent; if it is closed or deleted before that, the socket reports an
+    error and aborts the connection. The position of \a file is unspecified
+    after this call.
+
+    \sa write(), bytesToWrite()
+*/
+qint64 QAbstractSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::writeFile: file is not open for reading");
+        return -1;
+    }
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::writeFile: socket is not open for writing");
+        return -1;
+    }
+
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize) {
+        qWarning("QAbstractSocket::writeFile: offset %lld is outside of the file", offset);
+        return -1;
+    }
+    if (length < 0 || length > fileSize - offset)
+        length = fileSize - offset;
+    if (length == 0)
+        return 0;
+
+    return d->writeFile(file, offset, length);
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2469,7 +2795,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && d->writeBuffer.isEmpty() && d->pendingFileWrites.isEmpty()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2700,7 +3026,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || !d->pendingFileWrites.isEmpty() || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -55,6 +55,7 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -96,6 +97,10 @@ public:
     void _q_testConnection();
     void _q_abortConnectionAttempt();
 
+    void startParallelAttempt();
+    void parkedAttemptFinished();
+    void promoteParkedAttempt();
+    void discardParkedAttempt();
     bool emittedReadyRead;
     bool emittedBytesWritten;
 
@@ -137,18 +142,53 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    bool writeFileToSocket();
+    virtual qint64 writeFile(QFile *file, qint64 offset, qint64 length);
+    qint64 pendingFileBytes() const;
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
     void setError(QAbstractSocket::SocketError errorCode, const QString &errorString);
     void setErrorAndEmit(QAbstractSocket::SocketError errorCode, const QString &errorString);
 
+    // A file region queued by writeFile(). It is sent once the
+    // bufferedBefore bytes of the write buffer preceding it have been sent.
+    struct PendingFileWrite {
+        QPointer<QFile> file;
+        qint64 offset;
+        qint64 length;
+        qint64 bufferedBefore;
+    };
+    QList<PendingFileWrite> pendingFileWrites;
+
     qint64 readBufferMaxSize;
     bool isBuffered;
     bool hasPendingData;
 
     QTimer *connectTimer;
 
+    // Happy Eyeballs (RFC 8305): when a connection attempt has not
+    // completed after connectionAttemptDelay, it is parked and the next
+    // address is tried besides it; whichever connects first is kept.
+    struct ParkedAttempt : public QAbstractSocketEngineReceiver
+    {
+        void readNotification() override {}
+        void writeNotification() override {}
+        void closeNotification() override {}
+        void exceptionNotification() override {}
+        void connectionNotification() override { d->parkedAttemptFinished(); }
+#ifndef QT_NO_NETWORKPROXY
+        void proxyAuthenticationRequired(const QNetworkProxy &, QAuthenticator *) override {}
+#endif
+
+        QAbstractSocketPrivate *d = nullptr;
+        QAbstractSocketEngine *engine = nullptr;
+        QHostAddress host;
+    };
+    ParkedAttempt parkedAttempt;
+    QTimer *attemptDelayTimer;
+    static const int connectionAttemptDelay = 250;
+
     int hostLookupId;
 
     QAbstractSocket::SocketType socketType;
@@ -41,6 +41,7 @@
 
 #include "qnativesocketengine_p.h"
 
+#include "qfile.h"
 #include "qmutex.h"
 #include "qnetworkproxy.h"
 
@@ -145,6 +146,79 @@ void QAbstractSocketEngine::setError(QAbstractSocket::SocketError error, const Q
     d->socketErrorString = errorString;
 }
 
+/*!
+    Writes up to \a len bytes of \a file, starting at \a offset, to the
+    socket. Returns the number of bytes written, which may be less than
+    \a len, or -1 if an error occurred. The position of \a file is
+    unspecified afterwards.
+
+    This default implementation reads a chunk of the file and passes it to
+    write(); engines that can have the operating system copy the data from
+    the file to the socket directly reimplement it.
+*/
+qint64 QAbstractSocketEngine::sendFile(QFile *file, qint64 offset, qint64 len)
+{
+    char buffer[16 * 1024];
+    qint64 readBytes = -1;
+    if (file->seek(offset))
+        readBytes = file->read(buffer, qMin(len, qint64(sizeof(buffer))));
+    if (readBytes <= 0) {
+        setError(QAbstractSocket::UnknownSocketError,
+                 readBytes < 0 ? file->errorString() : tr("Unexpected end of file"));
+        return -1;
+    }
+    return write(buffer, readBytes);
+}
+
+/*!
+    Reads up to \a count datagrams of at most \a maxlen bytes each. The
+    datagram at index \e i is stored at \a data + \e i * \a maxlen, its size
+    in \a sizes[\e i] and, if requested by \a options, its IP header fields in
+    \a headers[\e i].
+
+    Returns the number of datagrams read. If no datagram could be read, the
+    return value of readDatagram() for the first one is returned instead.
+
+    This default implementation calls readDatagram() in a loop; engines that
+    can receive several datagrams in one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(int count, char *data, qint64 maxlen, qint64 *sizes,
+                                         QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    for (int i = 0; i < count; ++i) {
+#ifndef QT_NO_UDPSOCKET
+        if (i > 0 && !hasPendingDatagrams())
+            return i;
+#endif
+        const qint64 result = readDatagram(data + i * maxlen, maxlen, headers ? headers + i : nullptr,
+                                           options);
+        if (result < 0)
+            return i ? i : int(result);
+        sizes[i] = result;
+    }
+    return count;
+}
+
+/*!
+    Writes the \a count datagrams described by \a data, \a sizes and
+    \a headers, in order, and returns the number of datagrams sent. Sending
+    stops at the first datagram that could not be sent; if that was the first
+    one, the return value of writeDatagram() is returned instead.
+
+    This default implementation calls writeDatagram() in a loop; engines that
+    can send several datagrams in one system call reimplement it.
+*/
+int QAbstractSocketEngine::writeDatagrams(int count, const char * const *data, const qint64 *sizes,
+                                          const QIpPacketHeader *headers)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint64 result = writeDatagram(data[i], sizes[i], headers[i]);
+        if (result < 0)
+            return i ? i : int(result);
+    }
+    return count;
+}
+
 void QAbstractSocketEngine::setReceiver(QAbstractSocketEngineReceiver *receiver)
 {
     d_func()->receiver = receiver;
@@ -62,6 +62,7 @@ QT_BEGIN_NAMESPACE
 
 class QAuthenticator;
 class QAbstractSocketEnginePrivate;
+class QFile;
 #ifndef QT_NO_NETWORKINTERFACE
 class QNetworkInterface;
 #endif
@@ -141,6 +142,7 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 sendFile(QFile *file, qint64 offset, qint64 len);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -159,6 +161,10 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+    virtual int readDatagrams(int count, char *data, qint64 maxlen, qint64 *sizes,
+                              QIpPacketHeader *headers = nullptr, PacketHeaderOptions = WantNone);
+    virtual int writeDatagrams(int count, const char * const *data, const qint64 *sizes,
+                               const QIpPacketHeader *headers);
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
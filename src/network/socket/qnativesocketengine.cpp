@@ -117,6 +117,7 @@
 #include "qnativesocketengine_p.h"
 
 #include <qabstracteventdispatcher.h>
+#include <qfile.h>
 #include <qsocketnotifier.h>
 #include <qnetworkinterface.h>
 
@@ -870,6 +871,60 @@ qint64 QNativeSocketEngine::readDatagram(char *data, qint64 maxSize, QIpPacketHe
     return d->nativeReceiveDatagram(data, maxSize, header, options);
 }
 
+/*!
+    Reads up to \a count datagrams of at most \a maxSize bytes each into
+    consecutive \a maxSize byte slots of \a data, storing their sizes in
+    \a sizes and their IP header fields in \a headers according to the
+    request in \a options. Returns the number of datagrams read, -2 if none
+    was pending, or -1 if an error occurred.
+
+    On Linux, all datagrams are received with a single recvmmsg() call.
+
+    \sa readDatagram()
+*/
+int QNativeSocketEngine::readDatagrams(int count, char *data, qint64 maxSize, qint64 *sizes,
+                                       QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef Q_OS_LINUX
+    if (maxSize > 0)
+        return d->nativeReceiveDatagrams(count, data, maxSize, sizes, headers, options);
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::readDatagrams(count, data, maxSize, sizes, headers, options);
+}
+
+/*!
+    Writes \a count datagrams, the \e i-th of which has \a sizes[\e i] bytes
+    at \a data[\e i] and is sent according to \a headers[\e i]. Returns the
+    number of datagrams written, -2 if the first one would have blocked, or -1
+    if an error occurred while sending the first one.
+
+    On Linux, all datagrams are sent with a single sendmmsg() call.
+
+    \sa writeDatagram()
+*/
+int QNativeSocketEngine::writeDatagrams(int count, const char * const *data, const qint64 *sizes,
+                                        const QIpPacketHeader *headers)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef Q_OS_LINUX
+    return d->nativeSendDatagrams(count, data, sizes, headers);
+#else
+    Q_UNUSED(d);
+    return QAbstractSocketEngine::writeDatagrams(count, data, sizes, headers);
+#endif
+}
+
 /*!
     Writes a datagram of size \a size bytes to the socket from
     \a data to the destination contained in \a header, and returns the
@@ -918,6 +973,32 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Writes up to \a size bytes of \a file, starting at \a offset, to the
+    socket. Returns the number of bytes written, or -1 if an error occurred.
+
+    On Linux, the data is copied from the file to the socket by the kernel
+    with sendfile(). Otherwise, and for files without a native handle, it
+    is read into memory and written like write() does.
+*/
+qint64 QNativeSocketEngine::sendFile(QFile *file, qint64 offset, qint64 size)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+#ifdef Q_OS_LINUX
+    if (file->handle() != -1) {
+        const qint64 written = d->nativeSendFile(file->handle(), offset, size);
+        if (written != -2)
+            return written;
+        // -2: sendfile() can't handle this file, fall back to copying
+    }
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::sendFile(file, offset, size);
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
@@ -146,6 +146,7 @@ public:
 
     qint64 read(char *data, qint64 maxlen) override;
     qint64 write(const char *data, qint64 len) override;
+    qint64 sendFile(QFile *file, qint64 offset, qint64 len) override;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -164,6 +165,10 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
                         PacketHeaderOptions = WantNone) override;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
+    int readDatagrams(int count, char *data, qint64 maxlen, qint64 *sizes,
+                      QIpPacketHeader *headers = nullptr, PacketHeaderOptions = WantNone) override;
+    int writeDatagrams(int count, const char * const *data, const qint64 *sizes,
+                       const QIpPacketHeader *headers) override;
     qint64 bytesToWrite() const override;
 
 #if 0   // currently unused
@@ -277,8 +282,23 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#ifdef Q_OS_LINUX
+    int nativeReceiveDatagrams(int count, char *data, qint64 maxLength, qint64 *sizes,
+                               QIpPacketHeader *headers, QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(int count, const char * const *data, const qint64 *sizes,
+                            const QIpPacketHeader *headers);
+#endif
+#ifndef Q_OS_WIN
+    void parseDatagramHeader(msghdr *msg, const qt_sockaddr *aa, QIpPacketHeader *header) const;
+    void setupDatagramHeader(msghdr *msg, quintptr *cbuf, qt_sockaddr *aa, const QIpPacketHeader &header);
+    int setReceiveDatagramError() const;
+    int setSendDatagramError() const;
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#ifdef Q_OS_LINUX
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -69,6 +69,10 @@
     pendingDatagramSize() to obtain the size of the first pending
     datagram, and readDatagram() or receiveDatagram() to read it.
 
+    Applications that move many small datagrams can use writeDatagrams() and
+    receiveDatagrams() instead, which transfer a whole batch of datagrams
+    with a single system call where the operating system supports it.
+
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
 
@@ -103,6 +107,8 @@
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
 
+#include <QtCore/qvarlengtharray.h>
+
 QT_BEGIN_NAMESPACE
 
 #ifndef QT_NO_UDPSOCKET
@@ -125,8 +131,23 @@ public:
 
     inline bool ensureInitialized(const QHostAddress &remoteAddress)
     { return doEnsureInitialized(QHostAddress(), 0, remoteAddress); }
+
+    bool canSendTo(const QHostAddress &address) const;
+
+    // Reused by receiveDatagrams(); never larger than MaxDatagramBufferSize
+    QByteArray receiveBuffer;
 };
 
+// Most datagrams passed to the socket engine in one batch; this is the
+// limit Linux applies to a single recvmmsg() or sendmmsg() call
+static const int MaxDatagramBatchSize = 1024;
+
+// Largest UDP payload; no receiveDatagrams() slot needs to be larger
+static const qint64 MaxDatagramSize = 65536;
+
+// Most memory a socket keeps for the receive buffer of receiveDatagrams()
+static const qint64 MaxDatagramBufferSize = 1024 * 1024;
+
 bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, quint16 bindPort,
                                             const QHostAddress &remoteAddress)
 {
@@ -147,6 +168,30 @@ bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, qui
     return true;
 }
 
+/*!
+    \internal
+
+    Returns \c true if the socket, which must be initialized, can send a
+    datagram to \a address: a socket that is not dual-stack can only reach
+    addresses of its own protocol, counting IPv4-mapped IPv6 addresses as IPv4.
+*/
+bool QUdpSocketPrivate::canSendTo(const QHostAddress &address) const
+{
+    switch (socketEngine->protocol()) {
+    case QAbstractSocket::IPv4Protocol:
+        if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+            bool isIPv4 = false;
+            address.toIPv4Address(&isIPv4);
+            return isIPv4;
+        }
+        return true;
+    case QAbstractSocket::IPv6Protocol:
+        return address.protocol() != QAbstractSocket::IPv4Protocol;
+    default:
+        return true;
+    }
+}
+
 /*!
     Creates a QUdpSocket object.
 
@@ -431,6 +476,94 @@ qint64 QUdpSocket::writeDatagram(const QNetworkDatagram &datagram)
     return sent;
 }
 
+/*!
+    \since 6.1
+
+    Sends the datagrams in \a datagrams, in order, as if by calling
+    writeDatagram() for each of them. Where the operating system supports it,
+    several datagrams are handed to it in a single system call, which makes
+    this function considerably cheaper than a writeDatagram() loop for
+    many small datagrams.
+
+    Returns the number of datagrams sent, which can be less than the size of
+    \a datagrams if the socket's send buffer filled up, or -1 if not even the
+    first datagram could be sent. The bytesWritten() signal is emitted once
+    for all datagrams sent.
+
+    All datagrams are sent through the same socket. If it is bound to an IPv4
+    or an IPv6 address rather than being dual-stack, a batch that holds a
+    destination of the other protocol is rejected as a whole: nothing is sent,
+    -1 is returned and the error is set to
+    QAbstractSocket::UnsupportedSocketOperationError.
+
+    \warning Calling this function on a connected UDP socket may
+    result in an error and no packet being sent. If you are using a
+    connected socket, use write() to send datagrams.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+qsizetype QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qint64(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+    for (const QNetworkDatagram &datagram : datagrams) {
+        if (!d->canSendTo(datagram.destinationAddress())) {
+            d->setErrorAndEmit(QAbstractSocket::UnsupportedSocketOperationError,
+                               tr("Destination address does not match the protocol of the socket"));
+            return -1;
+        }
+    }
+
+    qsizetype sentCount = 0;
+    qint64 sentBytes = 0;
+    while (sentCount < datagrams.size()) {
+        const int count = int(qMin<qsizetype>(datagrams.size() - sentCount, MaxDatagramBatchSize));
+        QVarLengthArray<const char *, 16> data(count);
+        QVarLengthArray<qint64, 16> sizes(count);
+        QVarLengthArray<QIpPacketHeader, 16> headers(count);
+        for (int i = 0; i < count; ++i) {
+            const QNetworkDatagram &datagram = datagrams.at(sentCount + i);
+            data[i] = datagram.d->data.constData();
+            sizes[i] = datagram.d->data.size();
+            headers[i] = datagram.d->header;
+        }
+
+        const int sent = d->socketEngine->writeDatagrams(count, data.constData(), sizes.constData(),
+                                                         headers.constData());
+        if (sent < 0) {
+            if (sentCount)
+                break;
+            d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+            if (sent == -2) {
+                // Socket engine reports EAGAIN. Treat as a temporary error.
+                d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                                   tr("Unable to send a datagram"));
+            } else {
+                d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+            }
+            return -1;
+        }
+
+        for (int i = 0; i < sent; ++i)
+            sentBytes += sizes[i];
+        sentCount += sent;
+        if (sent < count)
+            break;
+    }
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    emit bytesWritten(sentBytes);
+    return sentCount;
+}
+
 /*!
     \since 5.8
 
@@ -476,6 +609,76 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.1
+
+    Receives up to \a maxCount pending datagrams, each no larger than
+    \a maxSize bytes, and returns them as QNetworkDatagram objects carrying
+    the same information that receiveDatagram() provides. Where the operating
+    system supports it, all datagrams are received with a single system
+    call.
+
+    Returns an empty list if no datagram was pending or an error occurred.
+
+    If \a maxSize is too small, the rest of each larger datagram will be
+    lost. If \a maxSize is -1 (the default), every datagram is received
+    whole, whatever its size. Fewer than \a maxCount datagrams are received
+    at once if \a maxCount times \a maxSize exceeds 1 MiB, which with the
+    default \a maxSize limits a batch to 16 datagrams; pass a smaller
+    \a maxSize to receive more of them at once. The socket keeps the receive
+    buffer for the next call.
+
+    \sa receiveDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qint64(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    if (maxCount <= 0)
+        return QList<QNetworkDatagram>();
+    // Sizing the slots from the first pending datagram would truncate
+    // larger ones later in the batch, so the default fits any datagram
+    if (maxSize < 0 || maxSize > MaxDatagramSize)
+        maxSize = MaxDatagramSize;
+    int count = int(qMin<qsizetype>(maxCount, MaxDatagramBatchSize));
+    if (maxSize > 0)
+        count = int(qBound(qint64(1), MaxDatagramBufferSize / maxSize, qint64(count)));
+
+    if (d->receiveBuffer.size() < count * maxSize)
+        d->receiveBuffer.resize(count * maxSize);
+    char *buffer = d->receiveBuffer.data();
+    QVarLengthArray<qint64, 16> sizes(count);
+    QVarLengthArray<QIpPacketHeader, 16> headers(count);
+    const int received = d->socketEngine->readDatagrams(count, buffer, maxSize, sizes.data(),
+                                                        headers.data(), QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (received < 0) {
+        if (received == -2) {
+            // No pending datagram. Treat as a temporary error.
+            d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                               tr("No datagram available for reading"));
+        } else {
+            d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        }
+        return QList<QNetworkDatagram>();
+    }
+
+    QList<QNetworkDatagram> result;
+    result.reserve(received);
+    for (int i = 0; i < received; ++i) {
+        QNetworkDatagram datagram(QByteArray(buffer + i * maxSize, sizes[i]));
+        datagram.d->header = std::move(headers[i]);
+        result.append(std::move(datagram));
+    }
+    return result;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
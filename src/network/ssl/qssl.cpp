@@ -153,7 +153,9 @@ Q_LOGGING_CATEGORY(lcSsl, "qt.network.ssl");
     option can allow connections for legacy servers, but it introduces the
     possibility that an attacker could inject plaintext into the SSL session.
     \value SslOptionDisableSessionSharing Disables SSL session sharing via
-    the session ID handshake attribute.
+    the session ID handshake attribute. This also keeps client sockets of the
+    OpenSSL backend from storing their sessions in, and resuming sessions from,
+    the cache shared by all sockets of the process.
     \value SslOptionDisableSessionPersistence Disables storing the SSL session
     in ASN.1 format as returned by QSslConfiguration::sessionTicket(). Enabling
     this feature adds memory overhead of approximately 1K per used session
@@ -1004,6 +1004,15 @@ QMap<QByteArray, QVariant> QSslConfiguration::backendConfiguration() const
     {https://www.openssl.org/docs/manmaster/man3/SSL_CONF_cmd.html#EXAMPLES}{examples}
     show how to use some of the options.
 
+    The OpenSSL backend also understands the \c{"Qt-early-data"} option, which
+    enables TLS 1.3 early data (0-RTT) on client sockets. A \c true value
+    makes the data written before the handshake go out with the first flight
+    of a resumed session, if the server allows it; QNetworkAccessManager
+    then does so for GET, HEAD and OPTIONS requests over HTTP/1. Early data
+    can be replayed by an attacker, so only send data that is safe to
+    process twice. Server sockets ignore the option and never accept early
+    data.
+
     \note The backend-specific configuration will be applied after the general
     configuration. Using the backend-specific configuration to set a general
     configuration option again will overwrite the general configuration option.
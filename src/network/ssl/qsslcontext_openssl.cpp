@@ -49,6 +49,12 @@
 #include "private/qsslsocket_openssl_p.h"
 #include "private/qsslsocket_openssl_symbols_p.h"
 #include "private/qssldiffiehellmanparameters_p.h"
+#include "private/qsslsessioncache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrandom.h>
 
 #include <vector>
 
@@ -56,6 +62,98 @@ QT_BEGIN_NAMESPACE
 
 Q_GLOBAL_STATIC(bool, forceSecurityLevel)
 
+namespace {
+// The session ticket keys shared by all server contexts of the process.
+// Tickets are issued with the current key, which is replaced every
+// SessionTicketKeyLifetime; the previous key is kept for as long again to
+// decrypt the tickets issued before, and such tickets are renewed. A ticket
+// is thus accepted for at least one and at most two key lifetimes.
+class SessionTicketKeys
+{
+public:
+    // Two hours, OpenSSL's default session timeout for TLS
+    static constexpr qint64 SessionTicketKeyLifetime = 2 * 60 * 60 * 1000;
+
+    struct Key
+    {
+        unsigned char name[16];
+        unsigned char hmacSecret[32];
+        unsigned char aesKey[32];
+    };
+
+    // Returns the key to issue a ticket with.
+    Key current()
+    {
+        QMutexLocker locker(&mutex);
+        rotate();
+        return keys[0];
+    }
+
+    // Finds the key a ticket was issued with, reporting in \a renew whether
+    // the ticket should be replaced by one issued with the current key.
+    bool find(const unsigned char *name, Key *key, bool *renew)
+    {
+        QMutexLocker locker(&mutex);
+        rotate();
+        for (int i = 0; i < keyCount; ++i) {
+            if (memcmp(keys[i].name, name, sizeof keys[i].name) == 0) {
+                *key = keys[i];
+                *renew = i > 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void rotate()
+    {
+        if (keyCount && age.elapsed() < SessionTicketKeyLifetime)
+            return;
+        // After an idle period the previous key may have expired as well
+        keyCount = keyCount && age.elapsed() < 2 * SessionTicketKeyLifetime ? 2 : 1;
+        keys[1] = keys[0];
+        QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(&keys[0]),
+                                              sizeof(Key) / sizeof(quint32));
+        age.start();
+    }
+
+    QMutex mutex;
+    QElapsedTimer age;
+    Key keys[2];
+    int keyCount = 0;
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(SessionTicketKeys, sessionTicketKeys)
+
+static int q_ssl_session_ticket_key_callback(SSL *, unsigned char *keyName, unsigned char *iv,
+                                             EVP_CIPHER_CTX *cipherContext, HMAC_CTX *hmacContext,
+                                             int encrypt)
+{
+    SessionTicketKeys *keys = sessionTicketKeys();
+    if (!keys)
+        return -1;
+
+    SessionTicketKeys::Key key;
+    bool renew = false;
+    if (encrypt) {
+        key = keys->current();
+        memcpy(keyName, key.name, sizeof key.name);
+        if (q_RAND_bytes(iv, 16) <= 0)
+            return -1;
+    } else if (!keys->find(keyName, &key, &renew)) {
+        // An unknown or expired key; fall back to a full handshake
+        return 0;
+    }
+
+    if (!q_EVP_CipherInit_ex(cipherContext, q_EVP_aes_256_cbc(), nullptr, key.aesKey, iv, encrypt)
+        || !q_HMAC_Init_ex(hmacContext, key.hmacSecret, sizeof key.hmacSecret, q_EVP_sha256(), nullptr)) {
+        return -1;
+    }
+    return renew ? 2 : 1;
+}
+
 Q_NETWORK_EXPORT void qt_ForceTlsSecurityLevel()
 {
     *forceSecurityLevel() = true;
@@ -638,6 +736,20 @@ init_context:
     if (sslContext->sslConfiguration.peerVerifyDepth() != 0)
         q_SSL_CTX_set_verify_depth(sslContext->ctx, sslContext->sslConfiguration.peerVerifyDepth());
 
+    // Every server socket gets its own context, whose random ticket keys would
+    // make the tickets it issues useless to any other socket of the same
+    // server. Share rotating keys within the process instead, and tie sessions to
+    // the configuration that established them, so only an equivalent server
+    // context resumes them.
+    if (mode == QSslSocket::SslServerMode && !isDtls) {
+        q_SSL_CTX_set_tlsext_ticket_key_cb(sslContext->ctx, q_ssl_session_ticket_key_callback);
+        const QByteArray sessionIdContext = QCryptographicHash::hash(
+                    QSslSessionCache::cacheKey(QString(), 0, configuration), QCryptographicHash::Sha256);
+        q_SSL_CTX_set_session_id_context(sslContext->ctx,
+                                         reinterpret_cast<const unsigned char *>(sessionIdContext.constData()),
+                                         unsigned(sessionIdContext.size()));
+    }
+
     // set persisted session if the user set it
     if (!configuration.sessionTicket().isEmpty())
         sslContext->setSessionASN1(configuration.sessionTicket());
@@ -718,7 +830,7 @@ void QSslContext::applyBackendConfig(QSslContext *sslContext)
         q_SSL_CONF_CTX_set_flags(cctx.data(), SSL_CONF_FLAG_FILE);
 
         for (auto i = conf.constBegin(); i != conf.constEnd(); ++i) {
-            if (i.key() == "Qt-OCSP-response") // This never goes to SSL_CONF_cmd().
+            if (i.key().startsWith("Qt-")) // Our own options never go to SSL_CONF_cmd().
                 continue;
 
             if (!i.value().canConvert(QMetaType(QMetaType::QByteArray))) {
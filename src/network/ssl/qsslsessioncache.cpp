@@ -0,0 +1,318 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsslsessioncache_p.h"
+
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslcipher.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslellipticcurve.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qglobal.h>
+
+#include <algorithm>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QSslSessionCache
+    \brief The QSslSessionCache class keeps TLS sessions for resumption by
+    later connections to the same peer.
+
+    QSslContext keeps the session of the last handshake made with it, which
+    only helps sockets sharing that context (as the channels of one
+    QHttpNetworkConnection do). This cache is process-wide instead: client
+    sockets store their sessions here once the handshake succeeds and offer
+    them again when they connect to the same peer name and port with an
+    equivalent configuration, see cacheKey().
+
+    Sessions are kept in their serialized (DER) form and are single-use:
+    take() removes the session it returns, so a session ticket is never
+    offered twice, as RFC 8446 recommends for TLS 1.3. Servers usually issue
+    more than one ticket per connection, so up to SessionsPerPeer sessions
+    are kept for every key. The cache is bounded by maximumSize() sessions,
+    the least recently used peers are evicted first.
+
+    All functions are thread-safe.
+*/
+
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+QSslSessionCache::QSslSessionCache()
+    : cache(DefaultMaximumSize)
+{
+}
+
+/*!
+    Returns the cache used by all QSslSocket instances of this process.
+*/
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+/*!
+    Returns the key under which sessions for \a peerName and \a port are
+    stored when connecting with \a configuration.
+
+    A session must only be resumed by a socket that would have accepted the
+    handshake that created it, so the key includes a digest of everything in
+    \a configuration that affects either the handshake or the verification of
+    the peer.
+*/
+QByteArray QSslSessionCache::cacheKey(const QString &peerName, quint16 port,
+                                      const QSslConfiguration &configuration)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const auto addNumber = [&hash](qint64 value) {
+        hash.addData(reinterpret_cast<const char *>(&value), sizeof value);
+    };
+    const auto addBytes = [&hash, &addNumber](const QByteArray &bytes) {
+        addNumber(bytes.size());
+        hash.addData(bytes);
+    };
+
+    addNumber(configuration.protocol());
+    int options = 0;
+    for (int option = QSsl::SslOptionDisableEmptyFragments;
+         option <= QSsl::SslOptionDisableServerCipherPreference; option <<= 1) {
+        if (configuration.testSslOption(QSsl::SslOption(option)))
+            options |= option;
+    }
+    addNumber(options);
+    addNumber(configuration.peerVerifyMode());
+    addNumber(configuration.peerVerifyDepth());
+    addNumber(configuration.ocspStaplingEnabled());
+    addNumber(configuration.missingCertificateIsFatal());
+
+    const auto localChain = configuration.localCertificateChain();
+    addNumber(localChain.size());
+    for (const QSslCertificate &certificate : localChain)
+        addBytes(certificate.toDer());
+    const auto caCertificates = configuration.caCertificates();
+    addNumber(caCertificates.size());
+    for (const QSslCertificate &certificate : caCertificates)
+        addBytes(certificate.toDer());
+
+    const auto ciphers = configuration.ciphers();
+    addNumber(ciphers.size());
+    for (const QSslCipher &cipher : ciphers)
+        addBytes(cipher.name().toLatin1());
+    const auto curves = configuration.ellipticCurves();
+    addNumber(curves.size());
+    for (const QSslEllipticCurve &curve : curves)
+        addBytes(curve.shortName().toLatin1());
+    const auto protocols = configuration.allowedNextProtocols();
+    addNumber(protocols.size());
+    for (const QByteArray &protocol : protocols)
+        addBytes(protocol);
+
+    // Keys starting with "Qt-" are ours and do not reach the TLS library.
+    const auto backendConfiguration = configuration.backendConfiguration();
+    for (auto it = backendConfiguration.cbegin(), end = backendConfiguration.cend(); it != end; ++it) {
+        if (it.key().startsWith("Qt-"))
+            continue;
+        addBytes(it.key());
+        addBytes(it.value().toString().toUtf8());
+    }
+
+    QByteArray key = peerName.toLower().toUtf8();
+    key += ':';
+    key += QByteArray::number(port);
+    key += '/';
+    key += hash.result();
+    return key;
+}
+
+/*!
+    Stores the serialized \a session under \a key. It expires after
+    \a lifetimeHint seconds, the hint the server sent with its session
+    ticket, or after DefaultLifetime seconds if there was no hint.
+
+    \sa take()
+*/
+void QSslSessionCache::insert(const QByteArray &key, const QByteArray &session, int lifetimeHint)
+{
+    // RFC 8446, 4.6.1: tickets are never valid for more than seven days.
+    constexpr int MaximumLifetime = 7 * 24 * 60 * 60;
+    if (session.isEmpty())
+        return;
+    if (lifetimeHint <= 0)
+        lifetimeHint = DefaultLifetime;
+
+    QMutexLocker locker(&mutex);
+    const qsizetype perPeer = qMin<qsizetype>(SessionsPerPeer, cache.maxCost());
+    if (perPeer <= 0)
+        return;
+
+    std::unique_ptr<Sessions> sessions(cache.take(key));
+    if (!sessions)
+        sessions.reset(new Sessions);
+    const auto expired = std::remove_if(sessions->begin(), sessions->end(), [](const Session &s) {
+        return s.expiry.hasExpired();
+    });
+    stats.expirations += sessions->end() - expired;
+    sessions->erase(expired, sessions->end());
+
+    sessions->append({session, QDeadlineTimer(qint64(qMin(lifetimeHint, MaximumLifetime)) * 1000)});
+    ++stats.insertions;
+    while (sessions->size() > perPeer) {
+        sessions->removeFirst();
+        ++stats.evictions;
+    }
+
+    const qsizetype cost = sessions->size();
+    const qsizetype costBefore = cache.totalCost();
+    cache.insert(key, sessions.release(), cost);
+    stats.evictions += costBefore + cost - cache.totalCost();
+}
+
+/*!
+    Removes the most recent session stored under \a key from the cache and
+    returns it, or returns an empty QByteArray if there is no session that
+    has not expired yet.
+*/
+QByteArray QSslSessionCache::take(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    ++stats.lookups;
+
+    std::unique_ptr<Sessions> sessions(cache.take(key));
+    if (!sessions)
+        return QByteArray();
+
+    const auto expired = std::remove_if(sessions->begin(), sessions->end(), [](const Session &s) {
+        return s.expiry.hasExpired();
+    });
+    stats.expirations += sessions->end() - expired;
+    sessions->erase(expired, sessions->end());
+
+    QByteArray session;
+    if (!sessions->isEmpty()) {
+        session = sessions->takeLast().der;
+        ++stats.hits;
+    }
+    if (!sessions->isEmpty()) {
+        const qsizetype cost = sessions->size();
+        cache.insert(key, sessions.release(), cost);
+    }
+    return session;
+}
+
+/*!
+    Removes all sessions from the cache. The statistics are not reset.
+*/
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+/*!
+    Counts a handshake in which the server accepted a session taken from
+    this cache.
+*/
+void QSslSessionCache::recordResumption()
+{
+    QMutexLocker locker(&mutex);
+    ++stats.resumptions;
+}
+
+/*!
+    Counts a handshake that sent early data; \a accepted tells if the server
+    processed it or if it had to be sent again after the handshake.
+*/
+void QSslSessionCache::recordEarlyData(bool accepted)
+{
+    QMutexLocker locker(&mutex);
+    if (accepted)
+        ++stats.earlyDataAccepted;
+    else
+        ++stats.earlyDataRejected;
+}
+
+/*!
+    Returns the maximum number of sessions the cache keeps.
+*/
+int QSslSessionCache::maximumSize() const
+{
+    QMutexLocker locker(&mutex);
+    return int(cache.maxCost());
+}
+
+/*!
+    Sets the maximum number of sessions the cache keeps to \a sessions,
+    evicting the least recently used peers if needed. Setting it to 0
+    disables the cache.
+*/
+void QSslSessionCache::setMaximumSize(int sessions)
+{
+    QMutexLocker locker(&mutex);
+    const qsizetype costBefore = cache.totalCost();
+    cache.setMaxCost(qMax(sessions, 0));
+    stats.evictions += costBefore - cache.totalCost();
+}
+
+/*!
+    Returns the number of sessions in the cache, including those that have
+    expired but were not looked up since.
+*/
+int QSslSessionCache::size() const
+{
+    QMutexLocker locker(&mutex);
+    return int(cache.totalCost());
+}
+
+QSslSessionCache::Statistics QSslSessionCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void QSslSessionCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    stats = Statistics();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSLSESSIONCACHE_P_H
+#define QSSLSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+QT_REQUIRE_CONFIG(ssl);
+
+QT_BEGIN_NAMESPACE
+
+class QSslConfiguration;
+
+class Q_NETWORK_EXPORT QSslSessionCache
+{
+public:
+    struct Statistics
+    {
+        quint64 lookups = 0;
+        quint64 hits = 0;
+        quint64 insertions = 0;
+        quint64 evictions = 0;   // dropped to stay within maximumSize()
+        quint64 expirations = 0; // dropped because their lifetime had passed
+        quint64 resumptions = 0; // handshakes the server completed with a cached session
+        quint64 earlyDataAccepted = 0;
+        quint64 earlyDataRejected = 0;
+
+        double hitRate() const { return lookups ? double(hits) / double(lookups) : 0.0; }
+        double resumptionRate() const { return hits ? double(resumptions) / double(hits) : 0.0; }
+    };
+
+    static constexpr int DefaultMaximumSize = 1024; // sessions
+    static constexpr int SessionsPerPeer = 2;
+    static constexpr int DefaultLifetime = 300;    // seconds, if the server gave no hint
+
+    QSslSessionCache();
+
+    static QSslSessionCache *instance();
+    static QByteArray cacheKey(const QString &peerName, quint16 port,
+                               const QSslConfiguration &configuration);
+
+    void insert(const QByteArray &key, const QByteArray &session, int lifetimeHint);
+    QByteArray take(const QByteArray &key);
+    void clear();
+
+    void recordResumption();
+    void recordEarlyData(bool accepted);
+
+    int maximumSize() const;
+    void setMaximumSize(int sessions);
+    int size() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Session
+    {
+        QByteArray der;
+        QDeadlineTimer expiry;
+    };
+    using Sessions = QList<Session>;
+
+    mutable QMutex mutex;
+    QCache<QByteArray, Sessions> cache; // the cost of an entry is its number of sessions
+    Statistics stats;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSLSESSIONCACHE_P_H
@@ -398,6 +398,7 @@
 
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qurl.h>
 #include <QtCore/qelapsedtimer.h>
@@ -2556,6 +2557,38 @@ bool QSslSocketPrivate::flush()
     return plainSocket && plainSocket->flush();
 }
 
+/*!
+    \internal
+
+    Unencrypted sockets hand the file region to the plain socket, which can
+    send it without copying. Encrypted data has to pass through the TLS
+    backend, so the region is read and buffered like write() does.
+*/
+qint64 QSslSocketPrivate::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_Q(QSslSocket);
+    if (mode == QSslSocket::UnencryptedMode && !autoStartHandshake)
+        return plainSocket->writeFile(file, offset, length);
+
+    if (!file->seek(offset)) {
+        setError(QAbstractSocket::UnknownSocketError, file->errorString());
+        return -1;
+    }
+    char buffer[16 * 1024];
+    for (qint64 remaining = length; remaining > 0; ) {
+        const qint64 readBytes = file->read(buffer, qMin(remaining, qint64(sizeof(buffer))));
+        if (readBytes <= 0) {
+            setError(QAbstractSocket::UnknownSocketError,
+                     readBytes < 0 ? file->errorString() : QSslSocket::tr("Unexpected end of file"));
+            return -1;
+        }
+        if (q->write(buffer, readBytes) < 0)
+            return -1;
+        remaining -= readBytes;
+    }
+    return length;
+}
+
 /*!
     \internal
 */
@@ -66,6 +66,7 @@
 #include "qsslpresharedkeyauthenticator.h"
 #include "qsslpresharedkeyauthenticator_p.h"
 #include "qocspresponse_p.h"
+#include "qsslsessioncache_p.h"
 #include "qsslkey.h"
 
 #ifdef Q_OS_WIN
@@ -738,6 +739,34 @@ bool QSslSocketBackendPrivate::initSslContext()
         }
     }
 
+    sessionCacheKey.clear();
+    cachedSessionOffered = false;
+    earlyData.clear();
+    earlyDataDone = false;
+    // Only clients send early data. A server could not tell replayed early
+    // data apart: OpenSSL's anti-replay check needs a single session cache
+    // shared by all of the server's contexts, and each socket has its own.
+    earlyDataEnabled = false;
+    if (mode == QSslSocket::SslClientMode) {
+        earlyDataEnabled = configuration.backendConfig.value("Qt-early-data").toBool();
+        if (!(configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+            QString peerName = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
+            if (peerName.isEmpty())
+                peerName = hostName;
+            sessionCacheKey = QSslSessionCache::cacheKey(peerName, q->peerPort(), q->sslConfiguration());
+            // A session set by the user or shared through our QSslContext
+            // takes precedence over the cache.
+            if (!q_SSL_get_session(ssl)) {
+                const QByteArray cached = QSslSessionCache::instance()->take(sessionCacheKey);
+                const auto *data = reinterpret_cast<const unsigned char *>(cached.constData());
+                if (SSL_SESSION *session = cached.isEmpty() ? nullptr : q_d2i_SSL_SESSION(nullptr, &data, cached.size())) {
+                    cachedSessionOffered = q_SSL_set_session(ssl, session) == 1;
+                    q_SSL_SESSION_free(session); // SSL_set_session() took a reference
+                }
+            }
+        }
+    }
+
     // Clear the session.
     errorList.clear();
 
@@ -1405,7 +1434,14 @@ bool QSslSocketBackendPrivate::startHandshake()
     q_SSL_set_ex_data(ssl, s_indexForSSLExtraData + socketOffsetInExData, this);
     q_SSL_set_info_callback(ssl, qt_AlertInfoCallback);
 
-    int result = (mode == QSslSocket::SslClientMode) ? q_SSL_connect(ssl) : q_SSL_accept(ssl);
+    int result;
+    if (mode == QSslSocket::SslClientMode) {
+        if (earlyDataEnabled && !earlyDataDone)
+            writeEarlyData();
+        result = q_SSL_connect(ssl);
+    } else {
+        result = q_SSL_accept(ssl);
+    }
     q_SSL_set_ex_data(ssl, s_indexForSSLExtraData + errorOffsetInExData, nullptr);
     // Note, unlike errors as external data on SSL object, we do not unset
     // a callback/ex-data if alert notifications are enabled: an alert can
@@ -1593,6 +1629,59 @@ void QSslSocketBackendPrivate::storePeerCertificates()
     }
 }
 
+void QSslSocketBackendPrivate::storeSessionInCache(SSL_SESSION *session)
+{
+    if (!session)
+        return;
+#ifdef TLS1_3_VERSION
+    if (!q_SSL_SESSION_is_resumable(session))
+        return;
+#endif // TLS1_3_VERSION
+
+    const int sessionSize = q_i2d_SSL_SESSION(session, nullptr);
+    if (sessionSize <= 0)
+        return;
+    QByteArray der(sessionSize, Qt::Uninitialized);
+    auto data = reinterpret_cast<unsigned char *>(der.data());
+    if (!q_i2d_SSL_SESSION(session, &data))
+        return;
+
+    QSslSessionCache::instance()->insert(sessionCacheKey, der,
+                                         int(q_SSL_SESSION_get_ticket_lifetime_hint(session)));
+}
+
+/*!
+    \internal
+
+    Sends what was written to the socket before the handshake started as
+    TLS 1.3 early data, if the session we resume allows it. The data is kept
+    until the handshake tells whether the server accepted it.
+*/
+void QSslSocketBackendPrivate::writeEarlyData()
+{
+    earlyDataDone = true;
+#ifdef TLS1_3_VERSION
+    SSL_SESSION *session = q_SSL_get_session(ssl);
+    if (!session || writeBuffer.isEmpty())
+        return;
+    const qint64 maxEarlyData = q_SSL_SESSION_get_max_early_data(session);
+    if (maxEarlyData <= 0)
+        return;
+
+    earlyData.resize(int(qMin(writeBuffer.size(), maxEarlyData)));
+    writeBuffer.peek(earlyData.data(), earlyData.size());
+    size_t written = 0;
+    if (q_SSL_write_early_data(ssl, earlyData.constData(), size_t(earlyData.size()), &written) <= 0) {
+        // Not fatal, the data will go out once the handshake is done.
+        logAndClearErrorQueue();
+        earlyData.clear();
+        return;
+    }
+    earlyData.truncate(int(written));
+    writeBuffer.free(earlyData.size());
+#endif // TLS1_3_VERSION
+}
+
 int QSslSocketBackendPrivate::handleNewSessionTicket(SSL *connection)
 {
     // If we return 1, this means we own the session, but we don't.
@@ -1602,6 +1691,9 @@ int QSslSocketBackendPrivate::handleNewSessionTicket(SSL *connection)
 
     Q_ASSERT(connection);
 
+    if (!sessionCacheKey.isEmpty() && sslErrors.isEmpty() && q_SSL_version(connection) >= 0x304)
+        storeSessionInCache(q_SSL_get_session(connection));
+
     if (q->sslConfiguration().testSslOption(QSsl::SslOptionDisableSessionPersistence)) {
         // We silently ignore, do nothing, remove from cache.
         return 0;
@@ -2139,8 +2231,32 @@ void QSslSocketBackendPrivate::continueHandshake()
     if (readBufferMaxSize)
         plainSocket->setReadBufferSize(readBufferMaxSize);
 
-    if (q_SSL_session_reused(ssl))
+    if (q_SSL_session_reused(ssl)) {
         configuration.peerSessionShared = true;
+        if (cachedSessionOffered)
+            QSslSessionCache::instance()->recordResumption();
+    }
+
+    // TLS 1.3 sessions arrive with NewSessionTicket messages after the
+    // handshake, see handleNewSessionTicket(). Sessions that needed ignored
+    // verification errors are not for sharing with other sockets.
+    if (!sessionCacheKey.isEmpty() && sslErrors.isEmpty() && q_SSL_version(ssl) < 0x304)
+        storeSessionInCache(q_SSL_get_session(ssl));
+
+    qint64 earlyDataWritten = 0;
+#ifdef TLS1_3_VERSION
+    if (!earlyData.isEmpty()) {
+        const bool accepted = q_SSL_get_early_data_status(ssl) == SSL_EARLY_DATA_ACCEPTED;
+        QSslSessionCache::instance()->recordEarlyData(accepted);
+        if (accepted) {
+            earlyDataWritten = earlyData.size();
+        } else {
+            // The server ignored it, send it again as ordinary application data.
+            memcpy(writeBuffer.reserveFront(earlyData.size()), earlyData.constData(), earlyData.size());
+        }
+        earlyData.clear();
+    }
+#endif // TLS1_3_VERSION
 
 #ifdef QT_DECRYPT_SSL_TRAFFIC
     if (q_SSL_get_session(ssl)) {
@@ -2222,6 +2338,12 @@ void QSslSocketBackendPrivate::continueHandshake()
 
     connectionEncrypted = true;
     emit q->encrypted();
+    if (earlyDataWritten && !emittedBytesWritten) {
+        emittedBytesWritten = true;
+        emit q->bytesWritten(earlyDataWritten);
+        emittedBytesWritten = false;
+        emit q->channelBytesWritten(0, earlyDataWritten);
+    }
     if (autoStartHandshake && pendingClose) {
         pendingClose = false;
         q->disconnectFromHost();
@@ -87,6 +87,7 @@
 #include <openssl/bn.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/pem.h>
 #include <openssl/pkcs12.h>
 #include <openssl/pkcs7.h>
@@ -177,6 +178,16 @@ public:
     QList<QSslError> ocspErrors;
     QByteArray ocspResponseDer;
 
+    // Session resumption through QSslSessionCache and TLS 1.3 early data:
+    void storeSessionInCache(SSL_SESSION *session);
+    void writeEarlyData();
+
+    QByteArray sessionCacheKey; // empty if this socket does not use the cache
+    bool cachedSessionOffered = false;
+    bool earlyDataEnabled = false; // send buffered data with the ClientHello
+    bool earlyDataDone = false;
+    QByteArray earlyData; // kept until the server accepts it
+
     Q_AUTOTEST_EXPORT static long setupOpenSslOptions(QSsl::SslProtocol protocol, QSsl::SslOptions sslOptions);
     static QSslCipher QSslCipher_from_SSL_CIPHER(const SSL_CIPHER *cipher);
     static QList<QSslCertificate> STACKOFX509_to_QSslCertificates(STACK_OF(X509) *x509);
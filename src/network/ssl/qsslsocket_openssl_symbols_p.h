@@ -303,6 +303,11 @@ using NewSessionCallback = int (*)(SSL *, SSL_SESSION *);
 void q_SSL_CTX_sess_set_new_cb(SSL_CTX *ctx, NewSessionCallback cb);
 int q_SSL_SESSION_is_resumable(const SSL_SESSION *s);
 
+// TLS 1.3 early data (0-RTT), see QSslSocketBackendPrivate::writeEarlyData().
+int q_SSL_write_early_data(SSL *s, const void *buf, size_t num, size_t *written);
+int q_SSL_get_early_data_status(const SSL *s);
+uint32_t q_SSL_SESSION_get_max_early_data(const SSL_SESSION *s);
+
 #define q_SSL_CTX_set_session_cache_mode(ctx,m) \
     q_SSL_CTX_ctrl(ctx,SSL_CTRL_SET_SESS_CACHE_MODE,m,NULL)
 
@@ -415,6 +420,8 @@ const EVP_CIPHER *q_EVP_aes_256_cbc();
 #endif // OPENSSL_NO_AES
 
 Q_AUTOTEST_EXPORT const EVP_MD *q_EVP_sha1();
+const EVP_MD *q_EVP_sha256();
+int q_HMAC_Init_ex(HMAC_CTX *ctx, const void *key, int len, const EVP_MD *md, ENGINE *impl);
 int q_EVP_PKEY_assign(EVP_PKEY *a, int b, void *r);
 Q_AUTOTEST_EXPORT int q_EVP_PKEY_set1_RSA(EVP_PKEY *a, RSA *b);
 Q_AUTOTEST_EXPORT int q_EVP_PKEY_set1_DSA(EVP_PKEY *a, DSA *b);
@@ -497,6 +504,7 @@ int q_SSL_CTX_use_certificate_file(SSL_CTX *a, const char *b, int c);
 int q_SSL_CTX_use_PrivateKey(SSL_CTX *a, EVP_PKEY *b);
 int q_SSL_CTX_use_RSAPrivateKey(SSL_CTX *a, RSA *b);
 int q_SSL_CTX_use_PrivateKey_file(SSL_CTX *a, const char *b, int c);
+int q_SSL_CTX_set_session_id_context(SSL_CTX *ctx, const unsigned char *sid_ctx, unsigned int sid_ctx_len);
 X509_STORE *q_SSL_CTX_get_cert_store(const SSL_CTX *a);
 SSL_CONF_CTX *q_SSL_CONF_CTX_new();
 void q_SSL_CONF_CTX_free(SSL_CONF_CTX *a);
@@ -612,6 +620,8 @@ void q_PKCS12_free(PKCS12 *pkcs12);
 #define q_BIO_get_mem_data(b, pp) (int)q_BIO_ctrl(b,BIO_CTRL_INFO,0,(char *)pp)
 #define q_BIO_pending(b) (int)q_BIO_ctrl(b,BIO_CTRL_PENDING,0,NULL)
 #define q_SSL_CTX_set_mode(ctx,op) q_SSL_CTX_ctrl((ctx),SSL_CTRL_MODE,(op),NULL)
+#define q_SSL_CTX_set_tlsext_ticket_key_cb(ctx, cb) \
+    q_SSL_CTX_callback_ctrl((ctx), SSL_CTRL_SET_TLSEXT_TICKET_KEY_CB, GenericCallbackType(cb))
 #define q_sk_GENERAL_NAME_num(st) q_SKM_sk_num(GENERAL_NAME, (st))
 #define q_sk_GENERAL_NAME_value(st, i) q_SKM_sk_value(GENERAL_NAME, (st), (i))
 
@@ -191,6 +191,7 @@ public:
     virtual qint64 peek(char *data, qint64 maxSize) override;
     virtual QByteArray peek(qint64 maxSize) override;
     bool flush() override;
+    qint64 writeFile(QFile *file, qint64 offset, qint64 length) override;
 
     // Platform specific functions
     virtual void startClientEncryption() = 0;
@@ -29,12 +29,41 @@
 #include <QCoreApplication>
 #include <QLoggingCategory>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #ifdef Q_CC_GNU
 #define NEVER_INLINE __attribute__((__noinline__))
 #else
 #define NEVER_INLINE
 #endif
 
+// With the "shutdown" argument, a thread logs while the application and the
+// asynchronous logger are destroyed. Constructed first, this object is
+// destroyed last, and stops the thread then.
+struct ShutdownLogger {
+    ~ShutdownLogger()
+    {
+        if (!thread.joinable())
+            return;
+        stop.store(true);
+        thread.join();
+        qDebug("after shutdown");
+    }
+
+    void start()
+    {
+        thread = std::thread([this] {
+            for (int i = 0; !stop.load(); ++i)
+                qDebug("tick %d", i);
+        });
+    }
+
+    std::atomic<bool> stop { false };
+    std::thread thread;
+} shutdownLogger;
+
 struct T {
     T() { qDebug("static constructor"); }
     ~T() { qDebug("static destructor"); }
@@ -65,6 +94,12 @@ int main(int argc, char **argv)
     QCoreApplication app(argc, argv);
     app.setApplicationName("tst_qlogging");
 
+    if (argc > 1 && qstrcmp(argv[1], "shutdown") == 0) {
+        shutdownLogger.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return 0;
+    }
+
     qSetMessagePattern("[%{type}] %{message}");
 
     qDebug("qDebug");
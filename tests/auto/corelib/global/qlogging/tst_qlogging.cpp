@@ -32,8 +32,15 @@
 #if QT_CONFIG(process)
 # include <QtCore/QProcess>
 #endif
+#if QT_CONFIG(thread)
+# include <QtCore/QMutex>
+# include <QtCore/QSemaphore>
+# include <QtCore/QThread>
+#endif
 #include <QtTest/QTest>
 
+#include <QtCore/private/qlogging_p.h>
+
 class tst_qmessagehandler : public QObject
 {
     Q_OBJECT
@@ -56,11 +63,18 @@ private slots:
 
     void qMessagePattern_data();
     void qMessagePattern();
+    void setMessagePattern_data();
     void setMessagePattern();
 
     void formatLogMessage_data();
     void formatLogMessage();
 
+#if QT_CONFIG(thread)
+    void asyncLogging();
+    void asyncLoggingDrop();
+    void asyncLoggingShutdown();
+#endif
+
 private:
     QStringList m_baseEnvironment;
 };
@@ -667,16 +681,16 @@ void tst_qmessagehandler::qMessagePattern_data()
 
     // %{file} is tricky because of shadow builds
     QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << true << (QList<QByteArray>()
-            << "debug  39 T::T static constructor"
+            << "debug  68 T::T static constructor"
             //  we can't be sure whether the QT_MESSAGE_PATTERN is already destructed
             << "static destructor"
-            << "debug tst_qlogging 60 MyClass::myFunction from_a_function 34"
-            << "debug tst_qlogging 70 main qDebug"
-            << "info tst_qlogging 71 main qInfo"
-            << "warning tst_qlogging 72 main qWarning"
-            << "critical tst_qlogging 73 main qCritical"
-            << "warning tst_qlogging 76 main qDebug with category"
-            << "debug tst_qlogging 80 main qDebug2");
+            << "debug tst_qlogging 89 MyClass::myFunction from_a_function 34"
+            << "debug tst_qlogging 105 main qDebug"
+            << "info tst_qlogging 106 main qInfo"
+            << "warning tst_qlogging 107 main qWarning"
+            << "critical tst_qlogging 108 main qCritical"
+            << "warning tst_qlogging 111 main qDebug with category"
+            << "debug tst_qlogging 115 main qDebug2");
 
 
     QTest::newRow("invalid") << "PREFIX: %{unknown} %{message}" << false << (QList<QByteArray>()
@@ -813,6 +827,15 @@ void tst_qmessagehandler::qMessagePattern()
 #endif
 }
 
+void tst_qmessagehandler::setMessagePattern_data()
+{
+    QTest::addColumn<QByteArray>("asyncLogging");
+
+    QTest::newRow("sync") << QByteArray();
+    QTest::newRow("async") << QByteArray("1");
+    QTest::newRow("async-drop") << QByteArray("drop");
+}
+
 void tst_qmessagehandler::setMessagePattern()
 {
 #if !QT_CONFIG(process)
@@ -842,6 +865,9 @@ void tst_qmessagehandler::setMessagePattern()
     std::copy_if(m_baseEnvironment.cbegin(), m_baseEnvironment.cend(),
                  std::back_inserter(environment),
                  doesNotStartWith(QLatin1String("QT_MESSAGE_PATTERN")));
+    QFETCH(QByteArray, asyncLogging);
+    if (!asyncLogging.isEmpty())
+        environment.append(QLatin1String("QT_LOGGING_ASYNC=") + QLatin1String(asyncLogging));
     process.setEnvironment(environment);
 
     process.start(appExe);
@@ -924,6 +950,183 @@ void tst_qmessagehandler::formatLogMessage()
     QCOMPARE(r, result);
 }
 
+#if QT_CONFIG(thread)
+struct AsyncMessage
+{
+    QtMsgType type;
+    QByteArray file;
+    int line;
+    QByteArray function;
+    QByteArray category;
+    QString message;
+    QThread *thread;
+};
+
+static QMutex asyncMessagesMutex;
+static QList<AsyncMessage> asyncMessages;
+static QSemaphore *asyncHandlerGate = nullptr;
+
+static void asyncMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    if (asyncHandlerGate)
+        asyncHandlerGate->acquire();
+    QMutexLocker locker(&asyncMessagesMutex);
+    asyncMessages.append({ type, context.file, context.line, context.function, context.category,
+                           msg, QThread::currentThread() });
+}
+
+void tst_qmessagehandler::asyncLogging()
+{
+    constexpr int ThreadCount = 4;
+    constexpr int MessageCount = 2000;
+
+    asyncMessages.clear();
+    qInstallMessageHandler(asyncMessageHandler);
+    QtPrivate::setAsyncLoggingEnabled(true, { 4096, QtPrivate::LogOverflowPolicy::Block });
+    QVERIFY(QtPrivate::isAsyncLoggingEnabled());
+
+    int line = 0;
+    QList<QThread *> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.append(QThread::create([t, &line] {
+            for (int i = 0; i < MessageCount; ++i) {
+                qInfo("%d %d", t, i); line = __LINE__;
+            }
+        }));
+        threads.last()->start();
+    }
+    qWarning("main"); const int mainLine = __LINE__;
+    for (QThread *thread : qAsConst(threads))
+        QVERIFY(thread->wait());
+    QVERIFY(QtPrivate::flushAsyncLogging());
+    qDeleteAll(threads);
+
+    QtPrivate::setAsyncLoggingEnabled(false);
+    QVERIFY(!QtPrivate::isAsyncLoggingEnabled());
+    qInstallMessageHandler(nullptr);
+
+    QMutexLocker locker(&asyncMessagesMutex);
+    QCOMPARE(asyncMessages.size(), ThreadCount * MessageCount + 1);
+    QList<int> next(ThreadCount);
+    bool sawMain = false;
+    for (const AsyncMessage &m : qAsConst(asyncMessages)) {
+        QVERIFY(m.thread != QThread::currentThread());
+        QCOMPARE(m.file, QByteArray(__FILE__));
+        QCOMPARE(m.category, QByteArray("default"));
+        if (m.type == QtWarningMsg) {
+            QCOMPARE(m.message, QString("main"));
+            QCOMPARE(m.line, mainLine);
+            QCOMPARE(m.function, QByteArray(Q_FUNC_INFO));
+            sawMain = true;
+            continue;
+        }
+        QCOMPARE(m.type, QtInfoMsg);
+        QCOMPARE(m.line, line);
+        const QStringList parts = m.message.split(QLatin1Char(' '));
+        QCOMPARE(parts.size(), 2);
+        const int t = parts.at(0).toInt();
+        QVERIFY(t >= 0 && t < ThreadCount);
+        // messages of a thread arrive in the order they were logged
+        QCOMPARE(parts.at(1).toInt(), next[t]++);
+    }
+    QVERIFY(sawMain);
+    for (int t = 0; t < ThreadCount; ++t)
+        QCOMPARE(next.at(t), MessageCount);
+    asyncMessages.clear();
+}
+
+void tst_qmessagehandler::asyncLoggingDrop()
+{
+    constexpr int MessageCount = 1000;
+
+    asyncMessages.clear();
+    QSemaphore gate;
+    asyncHandlerGate = &gate;
+    qInstallMessageHandler(asyncMessageHandler);
+    QtPrivate::setAsyncLoggingEnabled(true, { 4096, QtPrivate::LogOverflowPolicy::Drop });
+
+    // the first message keeps the writer thread waiting in the handler, so the
+    // buffer fills up and the rest are dropped without blocking
+    QThread *thread = QThread::create([] {
+        for (int i = 0; i < MessageCount; ++i)
+            qDebug("%d", i);
+    });
+    thread->start();
+    QVERIFY(thread->wait());
+    delete thread;
+
+    gate.release(MessageCount + 1);
+    QVERIFY(QtPrivate::flushAsyncLogging());
+    asyncHandlerGate = nullptr;
+    QtPrivate::setAsyncLoggingEnabled(false);
+    qInstallMessageHandler(nullptr);
+    QCOMPARE(QtPrivate::droppedAsyncLogMessages(), quint64(0));
+
+    // every message is either delivered or counted in a report
+    QMutexLocker locker(&asyncMessagesMutex);
+    int delivered = 0;
+    int dropped = 0;
+    int next = 0;
+    for (const AsyncMessage &m : qAsConst(asyncMessages)) {
+        if (m.category == "qt.core.logging") {
+            QCOMPARE(m.type, QtWarningMsg);
+            const QStringList words = m.message.split(QLatin1Char(' '));
+            QVERIFY2(words.size() > 1 && words.at(0) == QLatin1String("Dropped"),
+                     qPrintable(m.message));
+            dropped += words.at(1).toInt();
+        } else {
+            QCOMPARE(m.type, QtDebugMsg);
+            const int i = m.message.toInt();
+            QVERIFY(i >= next);
+            next = i + 1;
+            ++delivered;
+        }
+    }
+    QVERIFY(dropped > 0);
+    QCOMPARE(delivered + dropped, MessageCount);
+    asyncMessages.clear();
+}
+
+void tst_qmessagehandler::asyncLoggingShutdown()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    // A thread logs while the application and the logger are destroyed, and
+    // after: the writer thread is then gone, messages must not get lost, nor
+    // block the thread.
+    QProcess process;
+    QStringList environment = m_baseEnvironment;
+    environment.append(QLatin1String("QT_LOGGING_ASYNC=1"));
+    process.setEnvironment(environment);
+    process.start(QLatin1String(HELPER_BINARY), { QLatin1String("shutdown") });
+    QVERIFY2(process.waitForStarted(), qPrintable(process.errorString()));
+    QVERIFY(process.waitForFinished(60000));
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+
+    QByteArray output = process.readAllStandardError();
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    // the messages of the thread are all there, in order
+    QList<QByteArray> others;
+    int next = 0;
+    for (const QByteArray &line : output.split('\n')) {
+        if (line.startsWith("tick ")) {
+            QCOMPARE(line, "tick " + QByteArray::number(next));
+            ++next;
+        } else if (!line.isEmpty()) {
+            others.append(line);
+        }
+    }
+    QVERIFY(next > 0);
+    QCOMPARE(others, QList<QByteArray>({ "static constructor", "static destructor",
+                                         "after shutdown" }));
+    QVERIFY(output.endsWith("after shutdown\n"));
+#endif // QT_CONFIG(process)
+}
+#endif // QT_CONFIG(thread)
 
 QTEST_MAIN(tst_qmessagehandler)
 #include "tst_qlogging.moc"
@@ -48,6 +48,12 @@ android: SUBDIRS -= qeventdispatcher
 # This test is only applicable on Windows
 !win32*: SUBDIRS -= qwineventnotifier
 
+# The epoll backend of the UNIX event dispatcher
+linux:!android {
+    SUBDIRS += qeventdispatcher_epoll
+    qtHaveModule(network):qtConfig(private_tests): SUBDIRS += qsocketnotifier_epoll
+}
+
 android|uikit: SUBDIRS -= qobject qsharedmemory qsystemsemaphore
 
 !qtConfig(systemsemaphore): SUBDIRS -= \
@@ -59,6 +59,10 @@ public:
           eventDispatcher(QAbstractEventDispatcher::instance(thread()))
     { }
 
+#ifdef TEST_EVENT_DISPATCHER_EPOLL
+    static void initMain() { qputenv("QT_EVENT_DISPATCHER_EPOLL", "1"); }
+#endif
+
 private slots:
     void initTestCase();
     void registerTimer();
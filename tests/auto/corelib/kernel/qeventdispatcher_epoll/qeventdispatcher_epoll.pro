@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qeventdispatcher_epoll
+QT = core testlib
+SOURCES += ../qeventdispatcher/tst_qeventdispatcher.cpp
+DEFINES += TEST_EVENT_DISPATCHER_EPOLL
@@ -158,6 +158,7 @@ private slots:
     void functorReferencesConnection();
     void disconnectDisconnects();
     void singleShotConnection();
+    void batchedConnection();
 };
 
 struct QObjectCreatedOnShutdown
@@ -8107,6 +8108,244 @@ void tst_QObject::singleShotConnection()
     }
 }
 
+class BatchedSender : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void valueChanged(int value);
+};
+
+class BatchedReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    QList<int> values;
+    QList<QThread *> threads;
+    int metaCallEvents = 0;
+    QThread *moveTo = nullptr;
+    BatchedSender *echo = nullptr;
+
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::MetaCall)
+            ++metaCallEvents;
+        return QObject::event(e);
+    }
+
+public slots:
+    void record(int value)
+    {
+        values.append(value);
+        threads.append(QThread::currentThread());
+        if (moveTo) {
+            moveToThread(moveTo);
+            moveTo = nullptr;
+        }
+        if (echo)
+            emit echo->valueChanged(value + 1);
+    }
+};
+
+void tst_QObject::batchedConnection()
+{
+    const auto batchedQueued = Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection);
+
+    {
+        // All emissions are delivered in order, by a single event
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        &receiver, &BatchedReceiver::record, batchedQueued));
+        for (int i = 0; i < 100; ++i)
+            emit sender.valueChanged(i);
+        QVERIFY(receiver.values.isEmpty());
+
+        QCoreApplication::sendPostedEvents(&receiver);
+        QCOMPARE(receiver.values.size(), 100);
+        for (int i = 0; i < 100; ++i)
+            QCOMPARE(receiver.values.at(i), i);
+        QCOMPARE(receiver.metaCallEvents, 1);
+
+        // the next emission starts a new batch
+        emit sender.valueChanged(100);
+        QCoreApplication::sendPostedEvents(&receiver);
+        QCOMPARE(receiver.values.size(), 101);
+        QCOMPARE(receiver.metaCallEvents, 2);
+    }
+
+    {
+        // A call queued while a batch is delivered goes to the next batch
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        receiver.echo = &sender;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        &receiver, &BatchedReceiver::record, batchedQueued));
+        emit sender.valueChanged(0);
+        for (int i = 1; i <= 3; ++i) {
+            QCoreApplication::sendPostedEvents(&receiver);
+            QCOMPARE(receiver.values.size(), i);
+            QCOMPARE(receiver.metaCallEvents, i);
+        }
+        receiver.echo = nullptr;
+        QCoreApplication::sendPostedEvents(&receiver);
+        QCOMPARE(receiver.values, QList<int>() << 0 << 1 << 2 << 3);
+    }
+
+    {
+        // Removing the posted event does not stop later batches; the calls
+        // queued before are delivered with the next one
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        &receiver, &BatchedReceiver::record, batchedQueued));
+        emit sender.valueChanged(0);
+        QCoreApplication::removePostedEvents(&receiver);
+        QCoreApplication::sendPostedEvents(&receiver);
+        QVERIFY(receiver.values.isEmpty());
+
+        emit sender.valueChanged(1);
+        QCoreApplication::sendPostedEvents(&receiver);
+        QCOMPARE(receiver.values, QList<int>() << 0 << 1);
+        QCOMPARE(receiver.metaCallEvents, 1);
+    }
+
+    {
+        // A sender that never stops emitting does not starve the receiver's
+        // other events
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        &receiver, &BatchedReceiver::record,
+                        Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+
+        QAtomicInt stop;
+        QScopedPointer<QThread> producer(QThread::create([&sender, &stop] {
+            for (int i = 0; !stop.loadAcquire(); ++i) {
+                emit sender.valueChanged(i);
+                if (i % 64 == 0)
+                    QThread::yieldCurrentThread();
+            }
+        }));
+        producer->start();
+        QTRY_VERIFY(receiver.values.size() > 1000);
+
+        bool timerFired = false;
+        QTimer::singleShot(0, this, [&timerFired] { timerFired = true; });
+        QTRY_VERIFY(timerFired);
+        stop.storeRelease(1);
+        QVERIFY(producer->wait());
+
+        QCoreApplication::sendPostedEvents(&receiver);
+        for (int i = 0; i < receiver.values.size(); ++i)
+            QCOMPARE(receiver.values.at(i), i);
+    }
+
+    {
+        // String based connections and disconnection
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QMetaObject::Connection c = connect(&sender, SIGNAL(valueChanged(int)),
+                                            &receiver, SLOT(record(int)), batchedQueued);
+        QVERIFY(c);
+        emit sender.valueChanged(1);
+        QVERIFY(QObject::disconnect(c));
+        emit sender.valueChanged(2);
+        QCoreApplication::sendPostedEvents(&receiver);
+        QCOMPARE(receiver.values, QList<int>() << 1);
+    }
+
+    {
+        // Emissions from other threads, the order of each thread is kept
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        &receiver, &BatchedReceiver::record,
+                        Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+
+        const int threadCount = 4;
+        const int emissions = 1000;
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([&sender, t] {
+                for (int i = 0; i < emissions; ++i)
+                    emit sender.valueChanged(t * emissions + i);
+            }));
+            threads.back()->start();
+        }
+        for (auto &thread : threads)
+            QVERIFY(thread->wait());
+
+        QTRY_COMPARE(receiver.values.size(), threadCount * emissions);
+        QVERIFY(receiver.metaCallEvents < threadCount * emissions);
+        QList<int> last(threadCount, -1);
+        for (int value : qAsConst(receiver.values)) {
+            const int t = value / emissions;
+            QVERIFY(last.at(t) < value);
+            last[t] = value;
+        }
+    }
+
+    {
+        // Delete the receiver from inside the slot, the rest of the batch is dropped
+        SenderObject sender;
+        QPointer<DeleteThisReceiver> p = new DeleteThisReceiver;
+        DeleteThisReceiver::counter = 0;
+
+        QVERIFY(connect(&sender, &SenderObject::signal1,
+                        p.get(), &DeleteThisReceiver::deleteThis, batchedQueued));
+        sender.emitSignal1();
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QCOMPARE(DeleteThisReceiver::counter, 0);
+
+        QTRY_COMPARE(DeleteThisReceiver::counter, 1);
+        QVERIFY(!p);
+        QTest::qWait(0);
+        QCOMPARE(DeleteThisReceiver::counter, 1);
+    }
+
+    {
+        // Move the receiver to another thread from inside the slot, the rest
+        // of the batch is delivered there
+        QThread thread;
+        thread.start();
+
+        BatchedSender sender;
+        BatchedReceiver *receiver = new BatchedReceiver;
+        receiver->moveTo = &thread;
+        QVERIFY(connect(&sender, &BatchedSender::valueChanged,
+                        receiver, &BatchedReceiver::record, batchedQueued));
+        for (int i = 0; i < 10; ++i)
+            emit sender.valueChanged(i);
+
+        QCoreApplication::sendPostedEvents(receiver);
+        QCOMPARE(receiver->thread(), &thread);
+
+        QSemaphore done;
+        QList<int> values;
+        QList<QThread *> threads;
+        QMetaObject::invokeMethod(receiver, [&] {
+            values = receiver->values;
+            threads = receiver->threads;
+            delete receiver;
+            done.release();
+        }, Qt::QueuedConnection);
+        QVERIFY(done.tryAcquire(1, 5000));
+
+        QCOMPARE(values.size(), 10);
+        for (int i = 0; i < 10; ++i)
+            QCOMPARE(values.at(i), i);
+        QCOMPARE(threads.first(), QThread::currentThread());
+        for (int i = 1; i < 10; ++i)
+            QCOMPARE(threads.at(i), &thread);
+
+        thread.quit();
+        QVERIFY(thread.wait());
+    }
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 static_assert(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 static_assert(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
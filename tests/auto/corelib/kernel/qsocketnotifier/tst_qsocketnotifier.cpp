@@ -53,11 +53,17 @@
 class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
+public:
+#ifdef TEST_EVENT_DISPATCHER_EPOLL
+    static void initMain() { qputenv("QT_EVENT_DISPATCHER_EPOLL", "1"); }
+#endif
+
 private slots:
     void unexpectedDisconnection();
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void closedDuplicatedDescriptor();
 #endif
     void asyncMultipleDatagram();
     void activationReason_data();
@@ -314,6 +320,48 @@ void tst_QSocketNotifier::posixSockets()
     }
     qt_safe_close(posixSocket);
 }
+
+void tst_QSocketNotifier::closedDuplicatedDescriptor()
+{
+    int stale[2];
+    QCOMPARE(qt_safe_pipe(stale, O_NONBLOCK), 0);
+    int fresh[2];
+    QCOMPARE(qt_safe_pipe(fresh, O_NONBLOCK), 0);
+    const int duplicate = qt_safe_dup(stale[0]);
+    QVERIFY(duplicate >= 0);
+
+    // close the descriptor while it is watched; the duplicate keeps the pipe
+    // open, and it becomes readable afterwards
+    const int fd = stale[0];
+    {
+        QSocketNotifier notifier(fd, QSocketNotifier::Read);
+        qt_safe_close(fd);
+    }
+    QCOMPARE(qt_safe_write(stale[1], "x", 1), qint64(1));
+
+    // reuse the number for another pipe, which must only report its own data
+    QVERIFY(qt_safe_dup2(fresh[0], fd) != -1);
+    qt_safe_close(fresh[0]);
+    {
+        QSocketNotifier notifier(fd, QSocketNotifier::Read);
+        QSignalSpy readSpy(&notifier, &QSocketNotifier::activated);
+        QVERIFY(readSpy.isValid());
+
+        QTest::qWait(100);
+        QCOMPARE(readSpy.count(), 0);
+
+        QCOMPARE(qt_safe_write(fresh[1], "y", 1), qint64(1));
+        QTRY_VERIFY(readSpy.count() > 0);
+        char c;
+        QCOMPARE(qt_safe_read(fd, &c, 1), qint64(1));
+        QCOMPARE(c, 'y');
+    }
+
+    qt_safe_close(fd);
+    qt_safe_close(fresh[1]);
+    qt_safe_close(duplicate);
+    qt_safe_close(stale[1]);
+}
 #endif
 
 void tst_QSocketNotifier::async_readDatagramSlot()
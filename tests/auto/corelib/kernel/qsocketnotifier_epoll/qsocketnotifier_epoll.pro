@@ -0,0 +1,9 @@
+CONFIG += testcase
+TARGET = tst_qsocketnotifier_epoll
+QT = core-private network-private testlib
+SOURCES = ../qsocketnotifier/tst_qsocketnotifier.cpp
+DEFINES += TEST_EVENT_DISPATCHER_EPOLL
+
+requires(qtConfig(private_tests))
+
+include(../../../network/socket/platformsocketengine/platformsocketengine.pri)
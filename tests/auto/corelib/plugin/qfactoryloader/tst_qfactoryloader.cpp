@@ -30,7 +30,16 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qplugin.h>
+#include <QtCore/qpluginloader.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
+#if QT_CONFIG(library)
+#include <QtCore/qlibrary.h>
+#ifdef QT_BUILD_INTERNAL
+#include <private/qpluginmetadatacache_p.h>
+#endif
+#endif
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -51,6 +60,7 @@ public slots:
     void initTestCase();
 
 private slots:
+    void metaDataCache();
     void usingTwoFactoriesFromSameDir();
 };
 
@@ -68,6 +78,98 @@ void tst_QFactoryLoader::initTestCase()
     QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
 #if QT_CONFIG(library)
     QCoreApplication::setLibraryPaths(QStringList(QFileInfo(binFolder).absolutePath()));
+#endif
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void tst_QFactoryLoader::metaDataCache()
+{
+#if !QT_CONFIG(library) || !defined(QT_SHARED)
+    QSKIP("This test requires plugins to be loaded from disk");
+#elif !defined(QT_BUILD_INTERNAL)
+    QSKIP("This test requires a developer build of Qt");
+#else
+    // must run before any other test has scanned the plugins
+    QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+    if (!cache)
+        QSKIP("The plugin metadata cache is disabled");
+    cache->clear();
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData().size(), 1);
+
+    // scanning the directory wrote the cache
+    QVERIFY(QFile::exists(cache->cacheFilePath()));
+
+    const QDir binDir(QFINDTESTDATA(binFolderC));
+    const QStringList files = binDir.entryList(QDir::Files);
+    QStringList plugins;
+    for (const QString &file : files) {
+        const QString fileName = QFileInfo(binDir.filePath(file)).canonicalFilePath();
+        if (QLibrary::isLibrary(fileName))
+            plugins << fileName;
+    }
+    QCOMPARE(plugins.size(), 2);
+
+    QStringList iids;
+    for (const QString &fileName : qAsConst(plugins)) {
+        const auto stamp = QPluginMetaDataCache::stamp(fileName);
+        QVERIFY(stamp.isValid());
+        QJsonObject metaData;
+        QCOMPARE(cache->lookup(fileName, stamp, &metaData), QPluginMetaDataCache::IsAPlugin);
+        iids << metaData.value(QLatin1String("IID")).toString();
+
+        // a changed file must be scanned again
+        auto changed = stamp;
+        ++changed.modificationTime;
+        QCOMPARE(cache->lookup(fileName, changed, &metaData), QPluginMetaDataCache::NotCached);
+    }
+    iids.sort();
+    QCOMPARE(iids, QStringList() << QLatin1String(PluginInterface1_iid)
+                                 << QLatin1String(PluginInterface2_iid));
+
+    // files that are not plugins are remembered too
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    const QString notAPlugin = tempDir.filePath(QLatin1String("notaplugin.")
+                                              + QFileInfo(plugins.first()).suffix());
+    QFile file(notAPlugin);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("this is not a plugin");
+    file.close();
+
+    const QString canonical = QFileInfo(notAPlugin).canonicalFilePath();
+    QJsonObject metaData;
+    QCOMPARE(cache->lookup(canonical, QPluginMetaDataCache::stamp(canonical), &metaData),
+             QPluginMetaDataCache::NotCached);
+    QString errorString;
+    {
+        QPluginLoader pluginLoader(notAPlugin);
+        QVERIFY(pluginLoader.metaData().isEmpty());
+        errorString = pluginLoader.errorString();
+    }
+    QString cachedErrorString;
+    QCOMPARE(cache->lookup(canonical, QPluginMetaDataCache::stamp(canonical), &metaData,
+                           &cachedErrorString),
+             QPluginMetaDataCache::IsNotAPlugin);
+    QVERIFY(!cachedErrorString.isEmpty());
+
+    // the cached result reports the same error as scanning the file did
+    {
+        QPluginLoader pluginLoader(notAPlugin);
+        QVERIFY(pluginLoader.metaData().isEmpty());
+        QCOMPARE(pluginLoader.errorString(), errorString);
+    }
+
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(" either");
+    file.close();
+    QCOMPARE(cache->lookup(canonical, QPluginMetaDataCache::stamp(canonical), &metaData),
+             QPluginMetaDataCache::NotCached);
+
+    cache->clear();
+    QVERIFY(!QFile::exists(cache->cacheFilePath()));
 #endif
 }
 
@@ -148,6 +148,8 @@ private Q_SLOTS:
 
     void parseErrorOffset_data();
     void parseErrorOffset();
+    void vectorScanning_data();
+    void vectorScanning();
 
     void implicitValueType();
     void implicitDocumentType();
@@ -3110,6 +3112,112 @@ void tst_QtJson::parseErrorOffset()
     QCOMPARE(error.offset, errorOffset);
 }
 
+void tst_QtJson::vectorScanning_data()
+{
+    // The parser scans strings and whitespace 16 or 32 bytes at a time;
+    // these rows put the interesting bytes at the edges of those chunks.
+    // A string starts right after the opening quote at offset 2.
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("errorOffset");
+
+    const auto string = [](const QByteArray &content) {
+        return "[\"" + content + "\"]";
+    };
+    const QByteArray a(48, 'a');
+    const QByteArray whitespace = QByteArray(" \t\r\n").repeated(12);
+    for (int size : { 15, 16, 17, 31, 32, 33, 47, 48 }) {
+        QTest::addRow("string-%d", size)
+                << string(a.left(size)) << QJsonValue(QString(a.left(size)))
+                << int(QJsonParseError::NoError) << 0;
+        QTest::addRow("escape-at-%d", size)
+                << string(a.left(size) + "\\t" + a.left(20))
+                << QJsonValue(QString(a.left(size) + '\t' + a.left(20)))
+                << int(QJsonParseError::NoError) << 0;
+        QTest::addRow("whitespace-%d", size)
+                << "[" + whitespace.left(size) + "1" + whitespace.left(size) + "]"
+                << QJsonValue(1) << int(QJsonParseError::NoError) << 0;
+    }
+    QTest::newRow("escaped-quote-at-15")
+            << string(a.left(14) + "\\\"" + a.left(20))
+            << QJsonValue(QString(a.left(14) + '"' + a.left(20)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("escaped-quote-at-31")
+            << string(a.left(30) + "\\\"" + a.left(20))
+            << QJsonValue(QString(a.left(30) + '"' + a.left(20)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("escape-then-ascii")
+            << string("\\n" + a + "\\u00e9" + a)
+            << QJsonValue(QLatin1Char('\n') + QString(a) + QChar(0xe9) + QString(a))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("control-characters")
+            << string(a.left(5) + "\x01\x1f\x7f" + a.left(30))
+            << QJsonValue(QString(a.left(5) + "\x01\x1f\x7f" + a.left(30)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("non-ascii-inside")
+            << string(a.left(5) + "\xc3\xa9" + a.left(30))
+            << QJsonValue(QString::fromUtf8(a.left(5) + "\xc3\xa9" + a.left(30)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("non-ascii-across-16")
+            << string(a.left(15) + "\xc3\xa9" + a.left(20))
+            << QJsonValue(QString::fromUtf8(a.left(15) + "\xc3\xa9" + a.left(20)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("non-ascii-across-32")
+            << string(a.left(31) + "\xe2\x82\xac" + a.left(20))
+            << QJsonValue(QString::fromUtf8(a.left(31) + "\xe2\x82\xac" + a.left(20)))
+            << int(QJsonParseError::NoError) << 0;
+
+    QTest::newRow("invalid-utf8-inside")
+            << string(a.left(20) + "\xff" + a.left(20))
+            << QJsonValue() << int(QJsonParseError::IllegalUTF8String) << 22;
+    QTest::newRow("invalid-utf8-at-32")
+            << string(a.left(32) + "\xff" + a.left(20))
+            << QJsonValue() << int(QJsonParseError::IllegalUTF8String) << 34;
+    QTest::newRow("invalid-utf8-after-escape")
+            << string("\\t" + a.left(20) + "\xff")
+            << QJsonValue() << int(QJsonParseError::IllegalUTF8String) << 24;
+    QTest::newRow("unknown-escape-at-16")
+            << string(a.left(16) + "\\x" + a.left(20))
+            << QJsonValue(QString(a.left(16) + 'x' + a.left(20)))
+            << int(QJsonParseError::NoError) << 0;
+    QTest::newRow("invalid-escape-at-16")
+            << string(a.left(16) + "\\u12x4" + a.left(20))
+            << QJsonValue() << int(QJsonParseError::IllegalEscapeSequence) << 22;
+    QTest::newRow("unterminated-string-mid-chunk")
+            << "[\"" + a.left(20) << QJsonValue()
+            << int(QJsonParseError::UnterminatedString) << 23;
+    QTest::newRow("unterminated-string-at-32")
+            << "[\"" + a.left(32) << QJsonValue()
+            << int(QJsonParseError::UnterminatedString) << 35;
+    QTest::newRow("unterminated-escaped-string")
+            << "[\"\\t" + a.left(20) << QJsonValue()
+            << int(QJsonParseError::UnterminatedString) << 25;
+    QTest::newRow("whitespace-to-end-mid-chunk")
+            << "[1," + whitespace.left(20) << QJsonValue()
+            << int(QJsonParseError::UnterminatedArray) << 23;
+    QTest::newRow("whitespace-to-end-at-32")
+            << "[1" + whitespace.left(32) << QJsonValue()
+            << int(QJsonParseError::UnterminatedArray) << 34;
+}
+
+void tst_QtJson::vectorScanning()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonValue, value);
+    QFETCH(int, error);
+    QFETCH(int, errorOffset);
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    QCOMPARE(int(parseError.error), error);
+    QCOMPARE(parseError.offset, errorOffset);
+    if (error == QJsonParseError::NoError) {
+        QCOMPARE(doc.array().size(), 1);
+        QCOMPARE(doc.array().at(0), value);
+    }
+}
+
 void tst_QtJson::implicitValueType()
 {
     QJsonObject rootObject{
@@ -0,0 +1,5 @@
+QT = core testlib
+TARGET = tst_qcborvalueview
+CONFIG += testcase
+SOURCES += \
+    tst_qcborvalueview.cpp
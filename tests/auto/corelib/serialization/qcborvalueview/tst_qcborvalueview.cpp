@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qcborvalueview.h>
+#include <QtCore/qcborarray.h>
+#include <QtCore/qcbormap.h>
+#include <QtTest>
+
+class tst_QCborValueView : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void basics_data();
+    void basics();
+    void strings();
+    void arrays();
+    void maps();
+    void tagged();
+    void indefiniteLength();
+    void sharesData();
+    void malformed_data();
+    void malformed();
+};
+
+void tst_QCborValueView::basics_data()
+{
+    QTest::addColumn<QCborValue>("value");
+
+    QTest::newRow("integer") << QCborValue(42);
+    QTest::newRow("negative") << QCborValue(-1000000);
+    QTest::newRow("int64-min") << QCborValue(std::numeric_limits<qint64>::min());
+    QTest::newRow("double") << QCborValue(1.5);
+    QTest::newRow("false") << QCborValue(false);
+    QTest::newRow("true") << QCborValue(true);
+    QTest::newRow("null") << QCborValue(nullptr);
+    QTest::newRow("undefined") << QCborValue(QCborValue::Undefined);
+    QTest::newRow("simple-type") << QCborValue(QCborSimpleType(42));
+    QTest::newRow("string") << QCborValue("Hello");
+    QTest::newRow("bytearray") << QCborValue(QByteArray("\x01\x02\x03", 3));
+    QTest::newRow("array") << QCborValue(QCborArray{1, "two", 3.5});
+    QTest::newRow("map") << QCborValue(QCborMap{{"a", 1}, {2, "b"}});
+}
+
+void tst_QCborValueView::basics()
+{
+    QFETCH(QCborValue, value);
+
+    const QByteArray encoded = value.toCbor();
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    QCOMPARE(view.type(), value.type());
+    QCOMPARE(view.toInteger(-7), value.toInteger(-7));
+    QCOMPARE(view.toDouble(-7), value.toDouble(-7));
+    QCOMPARE(view.toBool(true), value.toBool(true));
+    QCOMPARE(view.toString(), value.toString());
+    QCOMPARE(view.toByteArray(), value.toByteArray());
+    QCOMPARE(view.toSimpleType(), value.toSimpleType());
+    QCOMPARE(view.isSimpleType(), value.isSimpleType());
+    QCOMPARE(view.rawData().toByteArray(), encoded);
+    QCOMPARE(view.toCborValue(), value);
+
+    const QCborValueView copy = view;
+    QCOMPARE(copy.type(), value.type());
+    QVERIFY(QCborValueView().isInvalid());
+}
+
+void tst_QCborValueView::strings()
+{
+    const QByteArray encoded = QCborValue(QString::fromUtf8("d\xc3\xa9j\xc3\xa0 vu")).toCbor();
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    QVERIFY(view.isString());
+    QCOMPARE(view.toString(), QString::fromUtf8("d\xc3\xa9j\xc3\xa0 vu"));
+    QCOMPARE(view.rawStringData(), QByteArrayView("d\xc3\xa9j\xc3\xa0 vu"));
+    QVERIFY(view.rawStringData().data() == encoded.constData() + 1);
+    QCOMPARE(view.toByteArray(QByteArray("default")), QByteArray("default"));
+}
+
+void tst_QCborValueView::arrays()
+{
+    QCborArray array;
+    for (int i = 0; i < 1000; ++i)
+        array.append(i % 3 ? QCborValue(i) : QCborValue(QCborArray{i, QString::number(i)}));
+    const QByteArray encoded = QCborValue(array).toCbor();
+
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    QVERIFY(view.isArray());
+    QCOMPARE(view.size(), array.size());
+    for (qsizetype i : {0, 1, 999, 3, 500, 2}) {
+        QCOMPARE(view.at(i).toCborValue(), array.at(i));
+        QCOMPARE(view[i].toCborValue(), array.at(i));
+    }
+    QCOMPARE(view[998].toInteger(), qint64(998));
+    QCOMPARE(view[999][0].toInteger(), qint64(999));
+    QCOMPARE(view[300][1].toString(), QStringLiteral("300"));
+    QVERIFY(view.at(1000).isInvalid());
+    QVERIFY(view.at(-1).isInvalid());
+    QVERIFY(view.at(0).at(5).isInvalid());
+    QVERIFY(view[1]["key"].isInvalid());
+
+    const QCborValueView empty = QCborValueView::fromCbor(QCborValue(QCborArray()).toCbor());
+    QCOMPARE(empty.size(), qsizetype(0));
+    QVERIFY(empty.at(0).isInvalid());
+}
+
+void tst_QCborValueView::maps()
+{
+    QCborMap map;
+    for (int i = 0; i < 500; ++i)
+        map.insert(QString("key%1").arg(i), QCborMap{{"value", i}, {-i, "negative"}});
+    map.insert(QString::fromUtf8("cl\xc3\xa9"), "utf8");
+    map.insert(QCborValue(QCborArray{1, 2}), "array key");
+    const QByteArray encoded = QCborValue(map).toCbor();
+
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    QVERIFY(view.isMap());
+    QCOMPARE(view.size(), map.size());
+    QCOMPARE(view["key42"]["value"].toInteger(), qint64(42));
+    QCOMPARE(view[QLatin1String("key499")][QStringView(u"value")].toInteger(), qint64(499));
+    QCOMPARE(view["key7"].value(-7).toString(), QStringLiteral("negative"));
+    QCOMPARE(view[QString::fromUtf8("cl\xc3\xa9")].toString(), QStringLiteral("utf8"));
+    QCOMPARE(view[QLatin1String("cl\xe9")].toString(), QStringLiteral("utf8"));
+    QVERIFY(view.contains(QLatin1String("key0")));
+    QVERIFY(!view.contains(QLatin1String("key500")));
+    QVERIFY(!view.contains(qint64(1)));
+    QVERIFY(view["missing"].isInvalid());
+    QVERIFY(view[0].isInvalid());
+
+    // the first of duplicate keys wins, like in QCborMap
+    const QByteArray duplicates = QByteArray::fromHex("a2616101616102");   // {"a": 1, "a": 2}
+    QCOMPARE(QCborValueView::fromCbor(duplicates)["a"].toInteger(), qint64(1));
+}
+
+void tst_QCborValueView::tagged()
+{
+    const QCborValue value(QCborKnownTags::Signature, QCborArray{1, 2});
+    const QCborValueView view = QCborValueView::fromCbor(value.toCbor());
+    QVERIFY(view.isTag());
+    QCOMPARE(view.tag(), QCborTag(QCborKnownTags::Signature));
+    QCOMPARE(view.taggedValue()[1].toInteger(), qint64(2));
+    QVERIFY(view[0].isInvalid());
+
+    // extended types are only recognized when decoding
+    const QDateTime dt = QDateTime::fromString("2020-11-18T12:00:00Z", Qt::ISODate);
+    const QCborValueView dateView = QCborValueView::fromCbor(QCborValue(dt).toCbor());
+    QVERIFY(dateView.isTag());
+    QCOMPARE(dateView.toCborValue().toDateTime(), dt);
+}
+
+void tst_QCborValueView::indefiniteLength()
+{
+    // [_ "ab", (_ "c", "de"), {_ "k": (_ h'01', h'02')}]
+    const QByteArray encoded = QByteArray::fromHex("9f626162" "7f6163626465ff"
+                                                   "bf616b5f41014102ffff" "ff");
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    QVERIFY(view.isArray());
+    QCOMPARE(view.size(), qsizetype(3));
+    QCOMPARE(view[0].toString(), QStringLiteral("ab"));
+    QCOMPARE(view[1].toString(), QStringLiteral("cde"));
+    QVERIFY(view[1].rawStringData().isNull());
+    QCOMPARE(view[2].size(), qsizetype(1));
+    QCOMPARE(view[2]["k"].toByteArray(), QByteArray("\x01\x02", 2));
+    QCOMPARE(view[2]["k"].isByteArray(), true);
+    QCOMPARE(view.rawData().size(), encoded.size());
+    QCOMPARE(view.toCborValue(), QCborValue::fromCbor(encoded));
+}
+
+void tst_QCborValueView::sharesData()
+{
+    QByteArray encoded = QCborValue(QCborMap{{"name", "value"}}).toCbor();
+    const QCborValueView view = QCborValueView::fromCbor(encoded);
+    const char *before = view["name"].rawStringData().data();
+    QVERIFY(before >= encoded.constData() && before < encoded.constData() + encoded.size());
+
+    // modifying the original detaches it, the view keeps the old data
+    encoded.fill('\0');
+    QCOMPARE(view["name"].toString(), QStringLiteral("value"));
+
+    const QByteArray raw = QCborValue(QCborArray{1, 2, 3}).toCbor();
+    const QCborValueView rawView = QCborValueView::fromRawData(raw.constData(), raw.size());
+    QCOMPARE(rawView[2].toInteger(), qint64(3));
+    QVERIFY(rawView[2].rawData().data() == raw.constData() + 3);
+}
+
+void tst_QCborValueView::malformed_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("reserved-additional") << QByteArray::fromHex("1c");
+    QTest::newRow("truncated-integer") << QByteArray::fromHex("1a0102");
+    QTest::newRow("truncated-string") << QByteArray::fromHex("6561");
+    QTest::newRow("truncated-array") << QByteArray::fromHex("830102");
+    QTest::newRow("huge-array") << QByteArray::fromHex("9bffffffffffffffff00");
+    QTest::newRow("unterminated-indefinite") << QByteArray::fromHex("9f0102");
+    QTest::newRow("stray-break") << QByteArray::fromHex("81ff");
+    QTest::newRow("indefinite-integer") << QByteArray::fromHex("1f");
+    QTest::newRow("bad-chunk") << QByteArray::fromHex("7f4161ff");
+}
+
+void tst_QCborValueView::malformed()
+{
+    QFETCH(QByteArray, data);
+
+    const QCborValueView view = QCborValueView::fromCbor(data);
+    QVERIFY(view.rawData().isNull());
+    QVERIFY(view.toCborValue().isInvalid());
+    QVERIFY(view.at(5).isInvalid());
+    QVERIFY(view["key"].isInvalid());
+    QCOMPARE(view.toString(), QString());
+}
+
+QTEST_MAIN(tst_QCborValueView)
+#include "tst_qcborvalueview.moc"
@@ -0,0 +1,5 @@
+QT = core testlib
+TARGET = tst_qjsonstreamreader
+CONFIG += testcase
+SOURCES += \
+    tst_qjsonstreamreader.cpp
@@ -0,0 +1,395 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qbuffer.h>
+#include <QtTest>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void tokens_data();
+    void tokens();
+    void incremental_data() { tokens_data(); }
+    void incremental();
+    void device_data() { tokens_data(); }
+    void device();
+    void strings_data();
+    void strings();
+    void rawTextSharesInput();
+    void numbers_data();
+    void numbers();
+    void errors_data();
+    void errors();
+    void waitsForMoreData();
+    void deepNesting();
+    void skipCurrentValue();
+};
+
+// Reads all tokens from the reader and describes them in a compact form
+static QString tokenString(QJsonStreamReader &reader)
+{
+    QStringList result;
+    forever {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::NoToken:
+            if (!reader.atEnd())
+                result << "...";
+            return result.join(' ');
+        case QJsonStreamReader::Invalid:
+            result << "!";
+            return result.join(' ');
+        case QJsonStreamReader::StartObject:
+            result << "{";
+            break;
+        case QJsonStreamReader::EndObject:
+            result << "}";
+            break;
+        case QJsonStreamReader::StartArray:
+            result << "[";
+            break;
+        case QJsonStreamReader::EndArray:
+            result << "]";
+            break;
+        case QJsonStreamReader::Name:
+            result << reader.toString() + ':';
+            break;
+        case QJsonStreamReader::String:
+            result << '"' + reader.toString() + '"';
+            break;
+        case QJsonStreamReader::Number:
+            result << (reader.isInteger() ? QString::number(reader.toInteger())
+                                          : QString::number(reader.toDouble()));
+            break;
+        case QJsonStreamReader::Bool:
+            result << (reader.toBool() ? "true" : "false");
+            break;
+        case QJsonStreamReader::Null:
+            result << "null";
+            break;
+        }
+    }
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-object") << QByteArray("{}") << "{ }";
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << "[ ]";
+    QTest::newRow("literals") << QByteArray("[true,false,null]") << "[ true false null ]";
+    QTest::newRow("object")
+            << QByteArray("{\"a\": 1, \"b\": \"x\", \"c\": [2, {\"d\": null}]}")
+            << "{ a: 1 b: \"x\" c: [ 2 { d: null } ] }";
+    QTest::newRow("whitespace")
+            << QByteArray("\r\n\t{\n  \"key\" :\t[ 1 ,\n 2 ]\n}\n")
+            << "{ key: [ 1 2 ] }";
+    QTest::newRow("unicode")
+            << QByteArray("{\"gr\xc3\xbc\xc3\x9f\":\"\xe2\x82\xac \xf0\x9f\x98\x80\"}")
+            << QString::fromUtf8("{ gr\xc3\xbc\xc3\x9f: \"\xe2\x82\xac \xf0\x9f\x98\x80\" }");
+    QTest::newRow("escapes")
+            << QByteArray(R"(["a\"b\\c\/d\n\té😀"])")
+            << QString::fromUtf8("[ \"a\"b\\c/d\n\t\xc3\xa9\xf0\x9f\x98\x80\" ]");
+    QTest::newRow("sequence")
+            << QByteArray("{\"a\":1}\n{\"a\":2}\n[]\n")
+            << "{ a: 1 } { a: 2 } [ ]";
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(tokenString(reader), expected);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.currentOffset(), qint64(json.size()));
+}
+
+void tst_QJsonStreamReader::incremental()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    // feed one byte at a time; the reader must produce the same tokens
+    QJsonStreamReader reader;
+    QStringList result;
+    for (char c : qAsConst(json)) {
+        reader.addData(QByteArray(1, c));
+        const QString tokens = tokenString(reader);
+        QVERIFY2(tokens.endsWith("..."), qPrintable(tokens));
+        if (tokens.size() > 3)
+            result << tokens.chopped(4);
+    }
+    QVERIFY(!reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(result.join(' '), expected);
+}
+
+void tst_QJsonStreamReader::device()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(tokenString(reader), expected);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+
+    if (QTest::currentDataTag() == QLatin1String("sequence"))
+        return;
+
+    // a large document spans many reads from the device
+    int tokensPerValue = 0;
+    for (QJsonStreamReader counter(json); counter.readNext() != QJsonStreamReader::NoToken; )
+        ++tokensPerValue;
+    QByteArray large = "[";
+    for (int i = 0; i < 10000; ++i)
+        large += json + ',';
+    large += "null]";
+    QBuffer largeBuffer(&large);
+    QVERIFY(largeBuffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&largeBuffer);
+    int count = 0;
+    while (reader.readNext() != QJsonStreamReader::NoToken)
+        ++count;
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.currentOffset(), qint64(large.size()));
+    QCOMPARE(count, 10000 * tokensPerValue + 3);
+}
+
+void tst_QJsonStreamReader::strings_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+    QTest::addColumn<bool>("hasEscapes");
+
+    QTest::newRow("empty") << QByteArray("\"\"") << QString() << false;
+    QTest::newRow("ascii") << QByteArray("\"Hello\"") << "Hello" << false;
+    QTest::newRow("utf8") << QByteArray("\"\xc3\xa9t\xc3\xa9\"")
+                          << QString::fromUtf8("\xc3\xa9t\xc3\xa9") << false;
+    QTest::newRow("escaped-quote") << QByteArray(R"("\"")") << "\"" << true;
+    QTest::newRow("escaped-unicode") << QByteArray(R"("\u0041\u00df")")
+                                     << QString::fromUtf8("A\xc3\x9f") << true;
+    QTest::newRow("lone-surrogate") << QByteArray(R"("\ud800")")
+                                    << QString(QChar(0xd800)) << true;
+    QTest::newRow("unknown-escape") << QByteArray(R"("\q")") << "q" << true;
+}
+
+void tst_QJsonStreamReader::strings()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+    QFETCH(bool, hasEscapes);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.hasEscapeSequences(), hasEscapes);
+    QCOMPARE(reader.rawText(), QByteArrayView(json).sliced(1, json.size() - 2));
+    QCOMPARE(reader.text().toString(), expected);
+    QCOMPARE(reader.toString(), expected);
+
+    // same result as QJsonDocument
+    const QJsonDocument doc = QJsonDocument::fromJson('[' + json + ']');
+    QCOMPARE(doc.array().at(0).toString(), expected);
+}
+
+void tst_QJsonStreamReader::rawTextSharesInput()
+{
+    const QByteArray json = "{\"name\":\"value\"}";
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.rawText(), QByteArrayView("name"));
+    QVERIFY(reader.rawText().data() == json.constData() + 2);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QVERIFY(reader.rawText().data() == json.constData() + 9);
+
+    // tokens without text
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QVERIFY(reader.rawText().isNull());
+    QVERIFY(reader.text().isNull());
+}
+
+void tst_QJsonStreamReader::numbers_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("isInteger");
+    QTest::addColumn<qint64>("integer");
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("zero") << QByteArray("0") << true << qint64(0) << 0.;
+    QTest::newRow("negative") << QByteArray("-42") << true << qint64(-42) << -42.;
+    QTest::newRow("int64-max") << QByteArray("9223372036854775807") << true
+                               << std::numeric_limits<qint64>::max() << 9223372036854775807.;
+    QTest::newRow("int64-min") << QByteArray("-9223372036854775808") << true
+                               << std::numeric_limits<qint64>::min() << -9223372036854775808.;
+    QTest::newRow("integral-fraction") << QByteArray("3.000") << true << qint64(3) << 3.;
+    QTest::newRow("exponent") << QByteArray("1e3") << true << qint64(1000) << 1000.;
+    QTest::newRow("fraction") << QByteArray("-0.5") << false << qint64(0) << -0.5;
+    QTest::newRow("small") << QByteArray("1.5e-10") << false << qint64(0) << 1.5e-10;
+    QTest::newRow("too-large") << QByteArray("18446744073709551616") << false << qint64(0)
+                               << 18446744073709551616.;
+}
+
+void tst_QJsonStreamReader::numbers()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, isInteger);
+    QFETCH(qint64, integer);
+    QFETCH(double, value);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.isInteger(), isInteger);
+    QCOMPARE(reader.toInteger(), integer);
+    QCOMPARE(reader.toDouble(), value);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\":1") << QJsonParseError::UnterminatedObject << 6;
+    QTest::newRow("object-garbage") << QByteArray("{\"a\":1 2}") << QJsonParseError::UnterminatedObject << 7;
+    QTest::newRow("object-name") << QByteArray("{1:2}") << QJsonParseError::UnterminatedObject << 1;
+    QTest::newRow("trailing-comma-object") << QByteArray("{\"a\":1,}") << QJsonParseError::MissingObject << 7;
+    QTest::newRow("missing-name-separator") << QByteArray("{\"a\" 1}") << QJsonParseError::MissingNameSeparator << 5;
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2") << QJsonParseError::UnterminatedArray << 5;
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]") << QJsonParseError::MissingValueSeparator << 3;
+    QTest::newRow("trailing-comma-array") << QByteArray("[1,]") << QJsonParseError::IllegalValue << 3;
+    QTest::newRow("illegal-value") << QByteArray("[x]") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("illegal-literal") << QByteArray("[nul]") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("truncated-literal") << QByteArray("tru") << QJsonParseError::IllegalValue << 0;
+    QTest::newRow("illegal-number") << QByteArray("[-]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("illegal-fraction") << QByteArray("[1.]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("illegal-exponent") << QByteArray("[1e+]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("leading-zero") << QByteArray("[01]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("illegal-escape") << QByteArray(R"(["\u12x4"])") << QJsonParseError::IllegalEscapeSequence << 2;
+    QTest::newRow("illegal-utf8") << QByteArray("[\"\xc3\x28\"]") << QJsonParseError::IllegalUTF8String << 2;
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc") << QJsonParseError::UnterminatedString << 1;
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(int, offset);
+
+    QJsonStreamReader reader(json);
+    while (reader.readNext() != QJsonStreamReader::Invalid)
+        QVERIFY2(!reader.atEnd(), "parser did not report an error");
+    QVERIFY(reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.error().error, error);
+    QCOMPARE(reader.error().offset, offset);
+    QCOMPARE(reader.errorString(), reader.error().errorString());
+
+    // the error is sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+
+    reader.clear();
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStreamReader::waitsForMoreData()
+{
+    QJsonStreamReader reader;
+    reader.addData("[12");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    // the number may continue
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.atEnd());
+    reader.addData("34, \"ab");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), qint64(1234));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    reader.addData("c\"]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.toString(), QStringLiteral("abc"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::deepNesting()
+{
+    const QByteArray ok = QByteArray(1024, '[') + QByteArray(1024, ']');
+    QJsonStreamReader reader(ok);
+    int maxDepth = 0;
+    while (reader.readNext() != QJsonStreamReader::NoToken)
+        maxDepth = qMax(maxDepth, reader.depth());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(maxDepth, 1024);
+
+    const QByteArray tooDeep = QByteArray(1025, '[') + QByteArray(1025, ']');
+    reader.clear();
+    reader.addData(tooDeep);
+    while (reader.readNext() != QJsonStreamReader::Invalid)
+        QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.error().error, QJsonParseError::DeepNesting);
+}
+
+void tst_QJsonStreamReader::skipCurrentValue()
+{
+    QJsonStreamReader reader(QByteArray(R"({"a": {"b": [1, {"c": 2}]}, "d": 3, "e": [4]})"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.toString(), QStringLiteral("d"));
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
@@ -5,6 +5,8 @@ SUBDIRS = \
     qcborstreamwriter \
     qcborvalue \
     qcborvalue_json \
+    qcborvalueview \
+    qjsonstreamreader \
     qdatastream \
     qdatastream_core_pixmap \
     qtextstream \
@@ -86,6 +86,7 @@ private slots:
     void stringToFloat();
     void doubleToString_data();
     void doubleToString();
+    void doubleToCLocale();
     void strtod_data();
     void strtod();
     void long_long_conversion_data();
@@ -1163,6 +1164,79 @@ void tst_QLocale::doubleToString()
     QCOMPARE(locale.toString(num, mode, precision), numStr);
 }
 
+void tst_QLocale::doubleToCLocale()
+{
+    // The direct C locale formatter must match QString::asprintf() and
+    // QLocale::toString(), which still go through QLocaleData::doubleToString()
+    const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.5, 10.0, 100.0, 1e10, 1234567.0, 0.000123,
+        0.00001, 1e-5, 1e-7, 123456789012.0, 1e21, 1e22, 1.7976931348623157e308, 5e-324,
+        2.2250738585072014e-308, 3.14159265358979, -2.718281828459045, 1.0 / 3, 2.0 / 3,
+        99999.5, 0.99999999, 9.5, 95.0, 1e100, -1e-100,
+        qInf(), -qInf(), qQNaN()
+    };
+    const int precisions[] = { QLocale::FloatingPointShortest, 0, 1, 2, 6, 10, 17, 25 };
+    const struct {
+        const char *printf;
+        uint flags;
+    } flagSets[] = {
+        { "", 0 },
+        { "#", QLocaleData::ShowBase | QLocaleData::AddTrailingZeroes | QLocaleData::ForcePoint },
+        { "+", QLocaleData::AlwaysShowSign },
+        { " ", QLocaleData::BlankBeforePositive },
+    };
+    const struct {
+        char conversion;
+        QLocaleData::DoubleForm form;
+    } forms[] = {
+        { 'e', QLocaleData::DFExponent }, { 'f', QLocaleData::DFDecimal },
+        { 'g', QLocaleData::DFSignificantDigits }, { 'E', QLocaleData::DFExponent },
+        { 'G', QLocaleData::DFSignificantDigits }
+    };
+
+    char narrow[128];
+    char16_t wide[128];
+    for (double value : values) {
+        for (const auto &form : forms) {
+            for (int precision : precisions) {
+                for (const auto &flagSet : flagSets) {
+                    const QByteArray format = QByteArray("%") + flagSet.printf + ".*"
+                        + form.conversion;
+                    QString expected;
+                    if (precision != QLocale::FloatingPointShortest)
+                        expected = QString::asprintf(format.constData(), precision, value);
+                    else if (!*flagSet.printf) // asprintf() has no shortest mode
+                        expected = QLocale::c().toString(value, form.conversion, precision);
+                    else
+                        continue;
+                    uint flags = flagSet.flags | QLocaleData::ZeroPadExponent;
+                    if (form.conversion < 'a')
+                        flags |= QLocaleData::CapitalEorX;
+                    const qsizetype length = qt_doubleToCLocale(value, form.form, precision, flags,
+                                                                narrow, sizeof(narrow));
+                    if (length < 0)
+                        continue; // too long for the direct path; callers fall back
+                    const QByteArray context = format + " of " + QByteArray::number(value, 'g', 17)
+                        + " with precision " + QByteArray::number(precision);
+                    QVERIFY2(QLatin1String(narrow, length) == expected, context);
+                    QCOMPARE(qt_doubleToCLocale(value, form.form, precision, flags, wide, 128),
+                             length);
+                    QVERIFY2(QStringView(wide, length) == expected, context);
+                }
+            }
+        }
+    }
+
+    // Too short a buffer fails rather than truncating
+    QCOMPARE(qt_doubleToCLocale(1.0 / 3, QLocaleData::DFSignificantDigits,
+                                QLocale::FloatingPointShortest, 0, narrow, 5), qsizetype(-1));
+    // Shortest always fits the documented buffer size
+    QVERIFY(qt_doubleToCLocale(-2.2250738585072014e-308, QLocaleData::DFSignificantDigits,
+                               QLocale::FloatingPointShortest,
+                               QLocaleData::ZeroPadExponent | QLocaleData::ForcePoint,
+                               narrow, QDoubleToCLocaleBufferSize) > 0);
+}
+
 void tst_QLocale::strtod_data()
 {
     QTest::addColumn<QString>("num_str");
@@ -29,6 +29,7 @@
 
 #include <QtTest/QtTest>
 
+#include <qrandom.h>
 #include <qstringconverter.h>
 #include <qthreadpool.h>
 
@@ -57,6 +58,9 @@ private slots:
     void utf8stateful_data();
     void utf8stateful();
 
+    void utf8LongMixed_data();
+    void utf8LongMixed();
+
     void utfHeaders_data();
     void utfHeaders();
 
@@ -1420,6 +1424,102 @@ void tst_QStringConverter::utf8stateful()
     }
 }
 
+void tst_QStringConverter::utf8LongMixed_data()
+{
+    QTest::addColumn<QByteArrayList>("pieces");
+    QTest::addColumn<quint32>("seed");
+
+    // Each piece decodes the same way on its own as it does in the middle of
+    // any of the others, so the long strings built from them can be checked
+    // against the concatenation of the short ones (which don't use SIMD).
+    const QByteArrayList ascii = { "a", "Z", " ", "0", "\n", QByteArray("\0", 1) };
+    const QByteArrayList twoBytes = { "\xc2\x80", "\xc3\xa9", "\xce\xb1", "\xd0\x96", "\xdf\xbf" };
+    const QByteArrayList threeBytes = { "\xe0\xa0\x80", "\xe4\xb8\xad", "\xed\x9f\xbf", "\xee\x80\x80",
+                                        "\xef\xbb\xbf", "\xef\xbf\xbf" };
+    const QByteArrayList fourBytes = { "\xf0\x90\x80\x80", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf" };
+    const QByteArrayList invalid = {
+        "\x80", "\xbf",                   // lone continuation bytes
+        "\xc0\xaf", "\xc1\xbf",           // overlong two-byte
+        "\xe0\x80\xaf", "\xe0\x9f\xbf",   // overlong three-byte
+        "\xed\xa0\x80", "\xed\xbf\xbf",   // surrogates
+        "\xf0\x80\x80\xaf", "\xf0\x8f\xbf\xbf", // overlong four-byte
+        "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", // above U+10FFFF
+        "\xf8", "\xff"
+    };
+
+    for (quint32 seed = 1; seed <= 4; ++seed) {
+        const QByteArray suffix = '-' + QByteArray::number(seed);
+        QTest::addRow("ascii+2%s", suffix.constData()) << ascii + twoBytes << seed;
+        QTest::addRow("2-bytes%s", suffix.constData()) << twoBytes << seed;
+        QTest::addRow("3-bytes%s", suffix.constData()) << threeBytes << seed;
+        QTest::addRow("4-bytes%s", suffix.constData()) << fourBytes << seed;
+        QTest::addRow("mixed%s", suffix.constData()) << ascii + twoBytes + threeBytes + fourBytes << seed;
+        QTest::addRow("mixed+invalid%s", suffix.constData())
+                << ascii + twoBytes + threeBytes + fourBytes + invalid << seed;
+    }
+}
+
+void tst_QStringConverter::utf8LongMixed()
+{
+    QFETCH(QByteArrayList, pieces);
+    QFETCH(quint32, seed);
+
+    QRandomGenerator rng(seed);
+    QByteArray utf8;
+    QString expected;
+    bool valid = true;
+    for (int i = 0; i < 1000; ++i) {
+        // long runs of a single piece and of a few ones, too
+        const QByteArray &piece = pieces.at(rng.bounded(int(pieces.size())));
+        const int repeat = rng.bounded(8) ? 1 : rng.bounded(1, 40);
+        QStringDecoder pieceDecoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless
+                                    | QStringDecoder::Flag::ConvertInitialBom);
+        const QString decoded = pieceDecoder(piece);
+        for (int j = 0; j < repeat; ++j) {
+            utf8 += piece;
+            expected += decoded;
+        }
+        valid = valid && !decoded.contains(QChar::ReplacementCharacter);
+    }
+
+    // try every alignment of the blocks too (and don't start with a BOM)
+    for (int offset = 1; offset <= 64; ++offset) {
+        const QByteArray input = QByteArray(offset, 'x') + utf8;
+        const QString output = QString(offset, u'x') + expected;
+
+        QCOMPARE(QString::fromUtf8(input), output);
+        QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::ConvertInitialBom);
+        QCOMPARE(QString(decoder(input)), output);
+        QCOMPARE(decoder.hasError(), !valid);
+        QCOMPARE(QByteArrayView(input).isValidUtf8(), valid);
+        QCOMPARE(input.isValidUtf8(), valid);
+        QCOMPARE(QUtf8StringView(input).isValidUtf8(), valid);
+        if (!valid)
+            continue;
+
+        QCOMPARE(output.toUtf8(), input);
+        QStringEncoder encoder(QStringEncoder::Utf8);
+        QCOMPARE(QByteArray(encoder(output)), input);
+        QVERIFY(!encoder.hasError());
+
+        // unpaired low surrogates are replaced
+        QString withSurrogates;
+        QByteArray encoded;
+        for (qsizetype i = 0; i < output.size(); ) {
+            qsizetype n = qMin<qsizetype>(37, output.size() - i);
+            if (output.at(i + n - 1).isHighSurrogate())
+                ++n;    // don't split a surrogate pair
+            const QStringView chunk = QStringView(output).sliced(i, n);
+            i += n;
+            withSurrogates += chunk;
+            withSurrogates += QChar(0xdc00);
+            encoded += chunk.toUtf8();
+            encoded += '?';
+        }
+        QCOMPARE(withSurrogates.toUtf8(), encoded);
+    }
+}
+
 void tst_QStringConverter::utfHeaders_data()
 {
     QTest::addColumn<QStringConverter::Encoding>("encoding");
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qstringrope
+QT = core-private testlib
+SOURCES = tst_qstringrope.cpp
@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <private/qstringrope_p.h>
+#include <qregularexpression.h>
+#include <qstring.h>
+#include <qstringtokenizer.h>
+
+#include <random>
+
+class tst_QStringRope : public QObject
+{
+    Q_OBJECT
+private slots:
+    void constructing();
+    void insertion();
+    void removal();
+    void mid();
+    void sharing();
+    void chunks();
+    void compareWithQString();
+    void indexOf_data();
+    void indexOf();
+    void tokenize_data();
+    void tokenize();
+    void globalMatch_data();
+    void globalMatch();
+};
+
+// Pieces that are long enough together not to be merged, so that the rope
+// has chunk boundaries every few hundred characters.
+static QStringRope fragmented(const QString &text, qsizetype seed = 0)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<qsizetype> pieceSize(130, 250);
+    QStringRope rope;
+    for (qsizetype i = 0; i < text.size(); ) {
+        const qsizetype n = qMin(pieceSize(generator), text.size() - i);
+        rope.append(text.mid(i, n));
+        i += n;
+    }
+    return rope;
+}
+
+static qsizetype chunkCount(const QStringRope &rope)
+{
+    const QStringRope::ChunkRange range = rope.chunks();
+    return std::distance(range.begin(), range.end());
+}
+
+static QStringList toStringList(const QList<QStringView> &views)
+{
+    QStringList result;
+    for (QStringView view : views)
+        result.append(view.toString());
+    return result;
+}
+
+static QString repeated(const QString &pattern, qsizetype size)
+{
+    QString result;
+    while (result.size() < size)
+        result += pattern;
+    result.truncate(size);
+    return result;
+}
+
+void tst_QStringRope::constructing()
+{
+    QStringRope empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), 0);
+    QVERIFY(empty.toString().isNull());
+    QCOMPARE(chunkCount(empty), 0);
+    QVERIFY(empty == QStringView());
+    QVERIFY(QStringRope(QString()).isEmpty());
+    QVERIFY(QStringRope(QStringView(u"")).isEmpty());
+
+    const QString text = QStringLiteral("Hello, world");
+    QStringRope rope(text);
+    QCOMPARE(rope.size(), text.size());
+    QCOMPARE(rope.toString(), text);
+    QVERIFY(rope == QStringView(text));
+    QCOMPARE(rope.at(4), QLatin1Char('o'));
+    QCOMPARE(rope[7], QLatin1Char('w'));
+
+    QStringRope copy = rope;
+    QVERIFY(copy == rope);
+    copy.clear();
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(rope.toString(), text);
+}
+
+void tst_QStringRope::insertion()
+{
+    QStringRope rope;
+    rope.append(u"world");
+    rope.prepend(QStringLiteral("Hello "));
+    rope.insert(5, u",");
+    rope.append(QStringRope(QStringLiteral("!")));
+    QCOMPARE(rope.toString(), QStringLiteral("Hello, world!"));
+    rope.insert(rope.size(), QString());
+    QCOMPARE(rope.size(), 13);
+
+    // typing character by character merges into few pieces
+    QStringRope typed;
+    QString reference;
+    for (int i = 0; i < 10000; ++i) {
+        const QChar c(u'a' + i % 26);
+        typed.append(QStringView(&c, 1));
+        reference.append(c);
+    }
+    QVERIFY(typed == reference);
+    QVERIFY(chunkCount(typed) <= reference.size() / 128);
+    for (qsizetype i = 0; i < reference.size(); i += 97)
+        QCOMPARE(typed.at(i), reference.at(i));
+}
+
+void tst_QStringRope::removal()
+{
+    const QString text = repeated(QStringLiteral("0123456789"), 5000);
+    QStringRope rope = fragmented(text);
+    QString reference = text;
+
+    rope.remove(100, 1000);
+    reference.remove(100, 1000);
+    QVERIFY(rope == reference);
+
+    rope.remove(rope.size() - 10, 100);
+    reference.remove(reference.size() - 10, 100);
+    QVERIFY(rope == reference);
+
+    rope.remove(-1, 10);
+    rope.remove(rope.size(), 10);
+    rope.remove(0, 0);
+    QVERIFY(rope == reference);
+
+    rope.replace(10, 20, QStringLiteral("replaced"));
+    reference.replace(10, 20, QStringLiteral("replaced"));
+    QVERIFY(rope == reference);
+
+    rope.truncate(1234);
+    reference.truncate(1234);
+    QVERIFY(rope == reference);
+    rope.truncate(-1);
+    QVERIFY(rope.isEmpty());
+}
+
+void tst_QStringRope::mid()
+{
+    const QString text = repeated(QStringLiteral("abcdefghijklmnopqrstuvwxyz"), 3000);
+    const QStringRope rope = fragmented(text);
+    QVERIFY(chunkCount(rope) > 10);
+
+    QCOMPARE(rope.mid(0).toString(), text);
+    QCOMPARE(rope.mid(100, 1000).toString(), text.mid(100, 1000));
+    QCOMPARE(rope.mid(2500).toString(), text.mid(2500));
+    QCOMPARE(rope.mid(-10, 20).toString(), text.mid(-10, 20));
+    QCOMPARE(rope.mid(-10).toString(), text.mid(-10));
+    QVERIFY(rope.mid(text.size()).isEmpty());
+    QVERIFY(rope.mid(10, 0).isEmpty());
+    QCOMPARE(rope.first(10).toString(), text.first(10));
+    QCOMPARE(rope.last(10).toString(), text.last(10));
+}
+
+void tst_QStringRope::sharing()
+{
+    const QString text = repeated(QStringLiteral("shared "), 100000);
+    QStringRope rope(text);
+    QCOMPARE(rope.toString().constData(), text.constData());
+
+    // large pieces refer to the original string
+    const QStringRope middle = rope.mid(1000, 50000);
+    QCOMPARE(chunkCount(middle), 1);
+    QCOMPARE(middle.chunks().begin()->data(), text.constData() + 1000);
+
+    rope.insert(5000, QStringLiteral("inserted"));
+    QCOMPARE(rope.size(), text.size() + 8);
+    QCOMPARE(rope.chunks().begin()->data(), text.constData());
+    QCOMPARE(rope.mid(5000, 8).toString(), QStringLiteral("inserted"));
+
+    // the copy is not affected by changes to the original
+    const QStringRope copy = rope;
+    rope.remove(0, 100000);
+    QCOMPARE(copy.size(), text.size() + 8);
+    QVERIFY(copy.mid(5008) == QStringView(text).sliced(5000));
+}
+
+void tst_QStringRope::chunks()
+{
+    const QString text = repeated(QStringLiteral("chunky "), 4000);
+    const QStringRope rope = fragmented(text, 1);
+
+    QString concatenated;
+    qsizetype expectedPosition = 0;
+    const QStringRope::ChunkRange range = rope.chunks();
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        QVERIFY(!it->isEmpty());
+        QCOMPARE(it.position(), expectedPosition);
+        expectedPosition += it->size();
+        concatenated += *it;
+    }
+    QCOMPARE(concatenated, text);
+
+    for (qsizetype position : { 0, 1, 999, 1000, 2345, 3999 }) {
+        auto it = range.begin(position);
+        QVERIFY(it.position() <= position);
+        QVERIFY(it.position() + it->size() > position);
+        QCOMPARE(it->at(position - it.position()), text.at(position));
+    }
+    QVERIFY(range.begin(text.size()) == range.end());
+}
+
+void tst_QStringRope::compareWithQString()
+{
+    std::mt19937 generator(42);
+    QString reference;
+    QStringRope rope;
+    for (int i = 0; i < 3000; ++i) {
+        const qsizetype size = reference.size();
+        const qsizetype position = std::uniform_int_distribution<qsizetype>(0, size)(generator);
+        switch (generator() % 4) {
+        case 0:
+        case 1: {
+            const qsizetype n = std::uniform_int_distribution<qsizetype>(1, 600)(generator);
+            const QString text = repeated(QString::number(i) + QLatin1Char(' '), n);
+            reference.insert(position, text);
+            rope.insert(position, text);
+            break;
+        }
+        case 2: {
+            const qsizetype n = std::uniform_int_distribution<qsizetype>(0, 300)(generator);
+            reference.remove(position, n);
+            rope.remove(position, n);
+            break;
+        }
+        case 3: {
+            const qsizetype n = std::uniform_int_distribution<qsizetype>(0, 300)(generator);
+            const QStringRope piece = rope.mid(position, n);
+            QVERIFY(piece == QStringView(reference).mid(position, n));
+            rope.insert(0, piece);
+            reference.insert(0, reference.mid(position, n));
+            break;
+        }
+        }
+        QCOMPARE(rope.size(), reference.size());
+    }
+    QCOMPARE(rope.toString(), reference);
+    QVERIFY(rope == fragmented(reference));
+    QVERIFY(rope != fragmented(reference.chopped(1) + QLatin1Char('x')));
+}
+
+void tst_QStringRope::indexOf_data()
+{
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<qsizetype>("from");
+    QTest::addColumn<bool>("caseInsensitive");
+
+    QTest::newRow("char") << QStringLiteral("x") << qsizetype(0) << false;
+    QTest::newRow("word") << QStringLiteral("needle") << qsizetype(0) << false;
+    QTest::newRow("word-from") << QStringLiteral("needle") << qsizetype(5000) << false;
+    QTest::newRow("word-negative") << QStringLiteral("needle") << qsizetype(-700) << false;
+    QTest::newRow("word-ci") << QStringLiteral("NEEDLE") << qsizetype(0) << true;
+    QTest::newRow("long") << repeated(QStringLiteral("needle"), 700) << qsizetype(0) << false;
+    QTest::newRow("empty") << QString() << qsizetype(17) << false;
+    QTest::newRow("missing") << QStringLiteral("haystack!") << qsizetype(0) << false;
+}
+
+void tst_QStringRope::indexOf()
+{
+    QFETCH(QString, needle);
+    QFETCH(qsizetype, from);
+    QFETCH(bool, caseInsensitive);
+    const Qt::CaseSensitivity cs = caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive;
+
+    QString text = repeated(QStringLiteral("haystack "), 10000);
+    // occurrences at every offset relative to the piece boundaries
+    for (qsizetype i = 1; i < 20; ++i)
+        text.replace(i * i * 23, 6, QStringLiteral("needle"));
+    text.replace(text.size() - 4300, 4200, repeated(QStringLiteral("needle"), 4200));
+    text[text.size() - 3] = QLatin1Char('x');
+    const QStringRope rope = fragmented(text, 7);
+
+    qsizetype expected = text.indexOf(needle, from, cs);
+    qsizetype actual = rope.indexOf(needle, from, cs);
+    QCOMPARE(actual, expected);
+    while (expected != -1 && !needle.isEmpty()) {
+        expected = text.indexOf(needle, expected + 1, cs);
+        actual = rope.indexOf(needle, actual + 1, cs);
+        QCOMPARE(actual, expected);
+    }
+    QCOMPARE(rope.contains(needle, cs), text.contains(needle, cs));
+}
+
+void tst_QStringRope::tokenize_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("separator");
+
+    QTest::newRow("empty") << QString() << QStringLiteral(",");
+    QTest::newRow("no-separator") << repeated(QStringLiteral("abc"), 1000) << QStringLiteral(",");
+    QTest::newRow("words") << repeated(QStringLiteral("lorem ipsum dolor sit amet "), 2000)
+                           << QStringLiteral(" ");
+    QTest::newRow("empty-parts") << repeated(QStringLiteral("a,,bc,,,def,"), 1000)
+                                 << QStringLiteral(",");
+    QTest::newRow("long-separator") << repeated(QStringLiteral("token<sep>sep<<sep>"), 1000)
+                                    << QStringLiteral("<sep>");
+    QTest::newRow("empty-separator") << repeated(QStringLiteral("xyz"), 200) << QString();
+}
+
+void tst_QStringRope::tokenize()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, separator);
+    const QStringRope rope = fragmented(text, 3);
+
+    for (Qt::SplitBehavior behavior : { Qt::KeepEmptyParts, Qt::SkipEmptyParts }) {
+        const auto expected = toStringList(QStringTokenizer(text, separator, behavior).toContainer());
+        const auto actual = rope.tokenize(separator, behavior).toContainer<QStringList>();
+        QCOMPARE(actual, expected);
+    }
+
+    // positions refer to the rope
+    const auto tokenizer = rope.tokenize(separator);
+    for (auto it = tokenizer.begin(); it != tokenizer.end(); ++it)
+        QCOMPARE(*it, QStringView(text).mid(it.position(), it->size()));
+
+    if (separator.size() == 1) {
+        const auto actual = rope.tokenize(separator.at(0), Qt::SkipEmptyParts).toContainer<QStringList>();
+        QCOMPARE(actual, toStringList(QStringTokenizer(text, separator.at(0), Qt::SkipEmptyParts)
+                                              .toContainer()));
+    }
+}
+
+void tst_QStringRope::globalMatch_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("word") << QStringLiteral("\\bfox\\w*");
+    QTest::newRow("captures") << QStringLiteral("(\\w+) (\\d+)");
+    QTest::newRow("spanning") << QStringLiteral("quick.*?dog");
+    QTest::newRow("long") << QStringLiteral("jumps(?:[^!]*)!");
+    QTest::newRow("end") << QStringLiteral("\\d+$");
+    QTest::newRow("lookbehind") << QStringLiteral("(?<=lazy )\\w+");
+    QTest::newRow("empty") << QStringLiteral("x*");
+    QTest::newRow("none") << QStringLiteral("cat");
+}
+
+void tst_QStringRope::globalMatch()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    QVERIFY(re.isValid());
+
+    QString text;
+    for (int i = 0; i < 1000; ++i) {
+        text += QStringLiteral("the quick brown fox%1 jumps over the lazy dog %2 ").arg(i).arg(i * 7);
+        if (i % 100 == 0)
+            text += repeated(QStringLiteral("jumps over "), 10000) + QLatin1Char('!');
+    }
+    text += QStringLiteral("42");
+    const QStringRope rope = fragmented(text, 5);
+
+    QRegularExpressionMatchIterator expected = re.globalMatch(text);
+    QStringRope::MatchIterator actual = rope.globalMatch(re);
+    while (expected.hasNext()) {
+        QVERIFY(actual.hasNext());
+        const QRegularExpressionMatch e = expected.next();
+        const QStringRope::Match a = actual.next();
+        QCOMPARE(a.capturedStart(), e.capturedStart());
+        QCOMPARE(a.capturedEnd(), e.capturedEnd());
+        QCOMPARE(a.capturedTexts(), e.capturedTexts());
+        for (int i = 0; i <= e.lastCapturedIndex(); ++i)
+            QCOMPARE(a.capturedStart(i), e.capturedStart(i));
+    }
+    QVERIFY(!actual.hasNext());
+
+    // starting in the middle
+    expected = re.globalMatch(text, 30000);
+    actual = rope.globalMatch(re, 30000);
+    QCOMPARE(actual.hasNext(), expected.hasNext());
+    if (expected.hasNext())
+        QCOMPARE(actual.next().capturedStart(), expected.next().capturedStart());
+}
+
+QTEST_APPLESS_MAIN(tst_QStringRope)
+#include "tst_qstringrope.moc"
@@ -20,6 +20,7 @@ SUBDIRS = \
     qstringiterator \
     qstringlist \
     qstringmatcher \
+    qstringrope \
     qstringtokenizer \
     qstringview \
     qtextboundaryfinder
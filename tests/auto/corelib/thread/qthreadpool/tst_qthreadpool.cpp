@@ -101,6 +101,7 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void workStealing();
 
 private:
     QMutex m_functionTestMutex;
@@ -1310,5 +1311,43 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::workStealing()
+{
+    qputenv("QT_THREADPOOL_WORK_STEALING", "1");
+    QThreadPool threadPool;
+    qunsetenv("QT_THREADPOOL_WORK_STEALING");
+    threadPool.setMaxThreadCount(4);
+
+    // a binary tree of tasks, all but the root started from pool threads
+    const int depth = 10;
+    QAtomicInt count;
+    std::function<void(int)> spawn = [&](int level) {
+        threadPool.start([&, level] {
+            if (level > 0) {
+                spawn(level - 1);
+                spawn(level - 1);
+            }
+            count.ref();
+        });
+    };
+    spawn(depth);
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.loadRelaxed(), (1 << (depth + 1)) - 1);
+
+    // with its only thread busy, runnables started from it stay in its own
+    // queue, from where they can still be taken
+    threadPool.setMaxThreadCount(1);
+    bool taken = false;
+    threadPool.start([&] {
+        QRunnable *runnable = QRunnable::create([] {});
+        threadPool.start(runnable);
+        taken = threadPool.tryTake(runnable);
+        if (taken)
+            delete runnable;
+    });
+    QVERIFY(threadPool.waitForDone());
+    QVERIFY(taken);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -142,6 +142,8 @@ private Q_SLOTS:
     void daylightTransitions() const;
     void timeZones() const;
     void systemTimeZoneChange() const;
+    void localTimeMatchesLibc_data() const;
+    void localTimeMatchesLibc() const;
 
     void invalid_data() const;
     void invalid() const;
@@ -848,6 +850,10 @@ void tst_QDateTime::toString_isoDate()
     QString result = datetime.toString(format);
     QCOMPARE(result, expected);
 
+    char buffer[QDateTimeFixedFormat::IsoMaxLength];
+    const qsizetype length = QDateTimeFixedFormat::formatIso(datetime, buffer, sizeof(buffer), format);
+    QCOMPARE(QLatin1String(buffer, length), expected);
+
     QDateTime resultDatetime = QDateTime::fromString(result, format);
     // If expecting invalid result the datetime may still be valid, i.e. year < 0 or > 9999
     if (!expected.isEmpty()) {
@@ -1021,6 +1027,10 @@ void tst_QDateTime::toString_rfcDate()
     QString actual(dt.toString(Qt::RFC2822Date));
     QLocale::setDefault(oldLocale);
     QCOMPARE(actual, formatted);
+
+    char buffer[QDateTimeFixedFormat::Rfc2822MaxLength];
+    const qsizetype length = QDateTimeFixedFormat::formatRfc2822(dt, buffer, sizeof(buffer));
+    QCOMPARE(QLatin1String(buffer, length), formatted);
 }
 
 void tst_QDateTime::toString_enumformat()
@@ -2600,6 +2610,12 @@ void tst_QDateTime::fromStringDateFormat()
 
     QDateTime dateTime = QDateTime::fromString(dateTimeStr, dateFormat);
     QCOMPARE(dateTime, expected);
+
+    const QByteArray utf8 = dateTimeStr.toUtf8();
+    QCOMPARE(QDateTimeFixedFormat::fromString(QUtf8StringView(utf8), dateFormat), expected);
+    const QByteArray latin1 = dateTimeStr.toLatin1();
+    if (QString::fromLatin1(latin1) == dateTimeStr)
+        QCOMPARE(QDateTimeFixedFormat::fromString(QLatin1String(latin1), dateFormat), expected);
 }
 
 # if QT_CONFIG(datetimeparser)
@@ -3816,6 +3832,58 @@ void tst_QDateTime::systemTimeZoneChange() const
 #endif
 }
 
+void tst_QDateTime::localTimeMatchesLibc_data() const
+{
+    QTest::addColumn<QByteArray>("zone");
+    QTest::newRow("Oslo") << QByteArray("Europe/Oslo");
+    QTest::newRow("London, with colon") << QByteArray(":Europe/London");
+    QTest::newRow("New York") << QByteArray("America/New_York");
+    QTest::newRow("Sydney") << QByteArray("Australia/Sydney");
+    QTest::newRow("Kolkata") << QByteArray("Asia/Kolkata");
+    QTest::newRow("Lord Howe") << QByteArray("Australia/Lord_Howe");
+    QTest::newRow("POSIX rule") << QByteArray("CET-1CEST,M3.5.0,M10.5.0/3");
+}
+
+void tst_QDateTime::localTimeMatchesLibc() const
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Compares with localtime_r(), which needs a Unix system");
+#else
+    QFETCH(QByteArray, zone);
+    const QByteArray name = zone.startsWith(':') ? zone.mid(1) : zone;
+    if (!name.contains(',') && !QFile::exists(QLatin1String("/usr/share/zoneinfo/") + QLatin1String(name)))
+        QSKIP("Zone not installed");
+    TimeZoneRollback useZone(zone);
+
+    // Every 7h 13m from 1971 to 2037, hitting all times of day near transitions
+    const qint64 step = (7 * 60 + 13) * 60 * qint64(1000);
+    const qint64 end = QDate(2037, 12, 1).startOfDay(Qt::UTC).toMSecsSinceEpoch();
+    for (qint64 msecs = QDate(1971, 1, 1).startOfDay(Qt::UTC).toMSecsSinceEpoch();
+         msecs < end; msecs += step) {
+        const time_t secs = time_t(msecs / 1000);
+        tm local;
+        QVERIFY(localtime_r(&secs, &local));
+        const QDateTime expected(QDate(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday),
+                                 QTime(local.tm_hour, local.tm_min, local.tm_sec), Qt::UTC);
+
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs, Qt::LocalTime);
+        QCOMPARE(QDateTime(dt.date(), dt.time(), Qt::UTC), expected);
+        QCOMPARE(dt.isDaylightTime(), local.tm_isdst > 0);
+
+        // Back from the local date and time, which may be ambiguous
+        const qint64 back = QDateTime(dt.date(), dt.time(), Qt::LocalTime).toMSecsSinceEpoch();
+        if (back != msecs) {
+            const time_t backSecs = time_t(back / 1000);
+            tm backLocal;
+            QVERIFY(localtime_r(&backSecs, &backLocal));
+            QCOMPARE(backLocal.tm_hour, local.tm_hour);
+            QCOMPARE(backLocal.tm_min, local.tm_min);
+            QCOMPARE(backLocal.tm_mday, local.tm_mday);
+        }
+    }
+#endif
+}
+
 void tst_QDateTime::invalid_data() const
 {
     QTest::addColumn<QDateTime>("when");
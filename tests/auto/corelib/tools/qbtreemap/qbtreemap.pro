@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qbtreemap
+QT = core-private testlib
+SOURCES = tst_qbtreemap.cpp
@@ -0,0 +1,348 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <private/qbtreemap_p.h>
+#include <qmap.h>
+#include <qstring.h>
+
+#include <random>
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+private slots:
+    void constructing();
+    void insertion();
+    void multiInsertion();
+    void removal();
+    void iterators();
+    void bounds();
+    void statefulComparator();
+    void compareWithQMap_data();
+    void compareWithQMap();
+    void compareWithQMultiMap();
+};
+
+// Big enough values to keep the nodes small, so that the tests build trees
+// several levels deep.
+struct Padded
+{
+    Padded(int v = 0) : value(v) {}
+    int value;
+    char padding[120] = {};
+    bool operator==(const Padded &other) const { return value == other.value; }
+};
+
+template <class Map, class Reference>
+static bool sameContents(const Map &map, const Reference &reference)
+{
+    if (map.size() != reference.size())
+        return false;
+    auto it = map.begin();
+    for (auto ref = reference.begin(); ref != reference.end(); ++ref, ++it) {
+        if (it == map.end() || !(it.key() == ref.key()) || !(it.value() == ref.value()))
+            return false;
+    }
+    if (it != map.end())
+        return false;
+
+    // and backwards
+    auto ref = reference.end();
+    while (ref != reference.begin()) {
+        --ref;
+        --it;
+        if (!(it.key() == ref.key()) || !(it.value() == ref.value()))
+            return false;
+    }
+    return it == map.begin();
+}
+
+void tst_QBTreeMap::constructing()
+{
+    using Map = QBTreeMap<int, QString>;
+    Map empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), Map::size_type(0));
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(empty.find(1) == empty.end());
+    QVERIFY(empty.lower_bound(1) == empty.end());
+
+    Map map{ { 3, QStringLiteral("three") }, { 1, QStringLiteral("one") },
+             { 2, QStringLiteral("two") } };
+    QCOMPARE(map.size(), Map::size_type(3));
+    QCOMPARE(map.keys(), QList<int>({ 1, 2, 3 }));
+    QCOMPARE(map.values(), QStringList({ "one", "two", "three" }));
+
+    Map copy(map);
+    QCOMPARE(copy.keys(), map.keys());
+    copy.insert(4, QStringLiteral("four"));
+    QCOMPARE(map.size(), Map::size_type(3));
+
+    Map moved(std::move(copy));
+    QCOMPARE(moved.size(), Map::size_type(4));
+    QVERIFY(copy.isEmpty());
+
+    copy = moved;
+    QCOMPARE(copy.keys(), moved.keys());
+    copy.clear();
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(moved.size(), Map::size_type(4));
+}
+
+void tst_QBTreeMap::insertion()
+{
+    QBTreeMap<QString, int> map;
+    auto result = map.insert(QStringLiteral("foo"), 1);
+    QVERIFY(result.second);
+    QCOMPARE(result.first.key(), QStringLiteral("foo"));
+    QCOMPARE(result.first.value(), 1);
+
+    result = map.insert(QStringLiteral("foo"), 2);
+    QVERIFY(!result.second);
+    QCOMPARE(result.first.value(), 2);
+    QCOMPARE(map.size(), qsizetype(1));
+
+    map[QStringLiteral("bar")] = 3;
+    ++map[QStringLiteral("foo")];
+    QCOMPARE(map.value(QStringLiteral("bar")), 3);
+    QCOMPARE(map.value(QStringLiteral("foo")), 3);
+    QCOMPARE(map.value(QStringLiteral("baz")), 0);
+    QCOMPARE(map.value(QStringLiteral("baz"), 42), 42);
+    QVERIFY(!map.contains(QStringLiteral("baz")));
+    QCOMPARE(map.keys(), QStringList({ "bar", "foo" }));
+
+    const QBTreeMap<QString, int> &constMap = map;
+    QCOMPARE(constMap[QStringLiteral("bar")], 3);
+    QCOMPARE(constMap[QStringLiteral("baz")], 0);
+    QVERIFY(!map.contains(QStringLiteral("baz")));
+}
+
+void tst_QBTreeMap::multiInsertion()
+{
+    QBTreeMap<int, int> map;
+    QMultiMap<int, int> reference;
+    for (int i = 0; i < 2000; ++i) {
+        map.insertMulti(i % 7, i);
+        reference.insert(i % 7, i);
+    }
+    QVERIFY(sameContents(map, reference));
+    QCOMPARE(map.count(3), reference.count(3));
+
+    // the most recently inserted item comes first
+    QCOMPARE(map.find(3).value(), 1998);
+    QCOMPARE(map.value(3), reference.value(3));
+
+    const auto range = map.equal_range(3);
+    QCOMPARE(std::distance(range.first, range.second), ptrdiff_t(reference.count(3)));
+    for (auto it = range.first; it != range.second; ++it)
+        QCOMPARE(it.key(), 3);
+
+    QCOMPARE(map.remove(3), reference.remove(3));
+    QVERIFY(!map.contains(3));
+    QVERIFY(sameContents(map, reference));
+}
+
+void tst_QBTreeMap::removal()
+{
+    QBTreeMap<int, Padded> map;
+    for (int i = 0; i < 5000; ++i)
+        map.insert(i, i);
+
+    QCOMPARE(map.remove(-1), qsizetype(0));
+    QCOMPARE(map.remove(17), qsizetype(1));
+    QVERIFY(!map.contains(17));
+    QCOMPARE(map.take(18).value, 18);
+    QVERIFY(!map.contains(18));
+    QCOMPARE(map.take(18).value, 0);
+
+    // erase every other element, checking the returned iterators
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end(); ) {
+        if (expected == 17 || expected == 18)
+            ++expected;
+        if (expected == 17 || expected == 18)
+            ++expected;
+        QCOMPARE(it.key(), expected);
+        it = (expected % 2) ? map.erase(it) : std::next(it);
+        ++expected;
+    }
+    QCOMPARE(map.size(), qsizetype(2499));
+    for (auto it = map.begin(); it != map.end(); ++it)
+        QCOMPARE(it.key() % 2, 0);
+
+    // and the rest from the back
+    while (!map.isEmpty())
+        map.erase(std::prev(map.end()));
+    QVERIFY(map.begin() == map.end());
+
+    map.insert(1, 1);
+    QCOMPARE(map.size(), qsizetype(1));
+}
+
+void tst_QBTreeMap::iterators()
+{
+    QBTreeMap<int, Padded> map;
+    for (int i = 999; i >= 0; --i)
+        map.insert(i * 2, i);
+
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end(); ++it, expected += 2) {
+        QCOMPARE(it.key(), expected);
+        QCOMPARE((*it).second.value, expected / 2);
+        QCOMPARE(it->first, expected);
+    }
+    QCOMPARE(expected, 2000);
+
+    for (auto it = map.rbegin(); it != map.rend(); ++it) {
+        expected -= 2;
+        QCOMPARE((*it).first, expected);
+    }
+    QCOMPARE(expected, 0);
+
+    for (auto it = map.begin(); it != map.end(); ++it)
+        it.value() = Padded(-it.key());
+    const QBTreeMap<int, Padded> &constMap = map;
+    for (auto it = constMap.constBegin(); it != constMap.constEnd(); ++it)
+        QCOMPARE(it.value().value, -it.key());
+
+    QBTreeMap<int, Padded>::const_iterator cit = map.begin();
+    QVERIFY(cit == constMap.begin());
+}
+
+void tst_QBTreeMap::bounds()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 10000; i += 10)
+        map.insert(i, i);
+
+    QCOMPARE(map.lower_bound(-5).key(), 0);
+    QCOMPARE(map.lower_bound(0).key(), 0);
+    QCOMPARE(map.upper_bound(0).key(), 10);
+    for (int i = 1; i < 9990; i += 7) {
+        const int next = (i / 10 + 1) * 10;
+        const int lower = i % 10 == 0 ? i : next;
+        QCOMPARE(map.lower_bound(i).key(), lower);
+        QCOMPARE(map.lowerBound(i).key(), lower);
+        QCOMPARE(map.upper_bound(i).key(), next);
+        QCOMPARE(map.upperBound(i).key(), next);
+    }
+    QVERIFY(map.lower_bound(9991) == map.end());
+    QVERIFY(map.upper_bound(9990) == map.end());
+    QCOMPARE(map.lower_bound(9990).key(), 9990);
+}
+
+void tst_QBTreeMap::statefulComparator()
+{
+    struct CountingCompare
+    {
+        mutable int *count;
+        bool operator()(int lhs, int rhs) const { ++*count; return lhs > rhs; }
+    };
+
+    int count = 0;
+    QBTreeMap<int, int, CountingCompare> map(CountingCompare{ &count });
+    for (int i = 0; i < 100; ++i)
+        map.insert(i, i);
+    QVERIFY(count > 0);
+    QCOMPARE(map.begin().key(), 99);
+    QCOMPARE(std::prev(map.end()).key(), 0);
+
+    auto copy = map;
+    count = 0;
+    QVERIFY(copy.contains(50));
+    QVERIFY(count > 0);
+}
+
+void tst_QBTreeMap::compareWithQMap_data()
+{
+    QTest::addColumn<int>("keyRange");
+
+    QTest::newRow("dense") << 300;
+    QTest::newRow("sparse") << 100000;
+}
+
+void tst_QBTreeMap::compareWithQMap()
+{
+    QFETCH(int, keyRange);
+
+    std::mt19937 generator(keyRange);
+    QBTreeMap<int, Padded> map;
+    QMap<int, Padded> reference;
+    for (int i = 0; i < 30000; ++i) {
+        const int key = generator() % keyRange;
+        switch (generator() % 4) {
+        case 0:
+        case 1:
+            QCOMPARE(map.insert(key, i).second, !reference.contains(key));
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(map.remove(key), reference.remove(key));
+            break;
+        case 3: {
+            auto it = map.lower_bound(key);
+            auto ref = reference.lowerBound(key);
+            QCOMPARE(it == map.end(), ref == reference.end());
+            if (ref != reference.end()) {
+                QCOMPARE(it.key(), ref.key());
+                map.erase(it);
+                reference.erase(ref);
+            }
+            break;
+        }
+        }
+    }
+    QVERIFY(sameContents(map, reference));
+
+    const QBTreeMap<int, Padded> copy = map;
+    QVERIFY(sameContents(copy, reference));
+}
+
+void tst_QBTreeMap::compareWithQMultiMap()
+{
+    std::mt19937 generator(42);
+    QBTreeMap<int, Padded> map;
+    QMultiMap<int, Padded> reference;
+    for (int i = 0; i < 30000; ++i) {
+        const int key = generator() % 500;
+        if (generator() % 4) {
+            map.insertMulti(key, i);
+            reference.insert(key, i);
+        } else {
+            QCOMPARE(map.remove(key), reference.remove(key));
+        }
+    }
+    QVERIFY(sameContents(map, reference));
+    for (int key = 0; key < 500; ++key)
+        QCOMPARE(map.count(key), reference.count(key));
+}
+
+QTEST_APPLESS_MAIN(tst_QBTreeMap)
+#include "tst_qbtreemap.moc"
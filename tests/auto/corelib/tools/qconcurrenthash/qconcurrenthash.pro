@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qconcurrenthash
+QT = core-private testlib
+SOURCES = tst_qconcurrenthash.cpp
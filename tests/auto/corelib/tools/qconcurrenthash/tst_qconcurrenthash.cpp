@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <private/qconcurrenthash_p.h>
+#include <qset.h>
+#include <qstring.h>
+#include <qthread.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void basics();
+    void replaceAndRemove();
+    void forEach();
+    void reclamation();
+    void concurrentAccess();
+};
+
+void tst_QConcurrentHash::basics()
+{
+    QConcurrentHash<QString, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), qsizetype(0));
+    QVERIFY(!hash.contains(QStringLiteral("foo")));
+    QCOMPARE(hash.value(QStringLiteral("foo")), 0);
+    QCOMPARE(hash.value(QStringLiteral("foo"), -1), -1);
+
+    int value = 0;
+    QVERIFY(!hash.lookup(QStringLiteral("foo"), &value));
+
+    for (int i = 0; i < 10000; ++i)
+        QVERIFY(hash.insert(QString::number(i), i));
+    QCOMPARE(hash.size(), qsizetype(10000));
+
+    for (int i = 0; i < 10000; ++i) {
+        QVERIFY(hash.lookup(QString::number(i), &value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!hash.contains(QStringLiteral("10000")));
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(QStringLiteral("1")));
+    QVERIFY(hash.insert(QStringLiteral("1"), 1));
+    QCOMPARE(hash.value(QStringLiteral("1")), 1);
+}
+
+void tst_QConcurrentHash::replaceAndRemove()
+{
+    QConcurrentHash<int, QString> hash;
+    QVERIFY(hash.insert(1, QStringLiteral("one")));
+    QVERIFY(!hash.insert(1, QStringLiteral("uno")));
+    QCOMPARE(hash.value(1), QStringLiteral("uno"));
+    QVERIFY(!hash.tryInsert(1, QStringLiteral("eins")));
+    QCOMPARE(hash.value(1), QStringLiteral("uno"));
+    QVERIFY(hash.tryInsert(2, QStringLiteral("two")));
+    QCOMPARE(hash.size(), qsizetype(2));
+
+    QVERIFY(hash.remove(1));
+    QVERIFY(!hash.remove(1));
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.size(), qsizetype(1));
+    QCOMPARE(hash.value(2), QStringLiteral("two"));
+}
+
+void tst_QConcurrentHash::forEach()
+{
+    QConcurrentHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * i);
+    for (int i = 0; i < 1000; i += 3)
+        hash.remove(i);
+
+    QSet<int> seen;
+    hash.forEach([&](int key, int value) {
+        QCOMPARE(value, key * key);
+        QVERIFY(key % 3 != 0);
+        seen.insert(key);
+    });
+    QCOMPARE(seen.size(), hash.size());
+}
+
+struct Tracked
+{
+    static QAtomicInt alive;
+
+    Tracked(int v = 0) : value(v) { alive.ref(); }
+    Tracked(const Tracked &other) : value(other.value) { alive.ref(); }
+    Tracked &operator=(const Tracked &other) = default;
+    ~Tracked() { alive.deref(); }
+
+    int value;
+};
+QAtomicInt Tracked::alive;
+
+void tst_QConcurrentHash::reclamation()
+{
+    const int before = Tracked::alive.loadRelaxed();
+    {
+        QConcurrentHash<int, Tracked> hash;
+        for (int i = 0; i < 100000; ++i) {
+            hash.insert(i % 10, Tracked(i));
+            if (i % 7 == 0)
+                hash.remove(i % 10);
+        }
+        QCOMPARE(hash.value(9).value, 99999);
+
+        // replaced and removed values are freed right away; each item is
+        // kept in both copies of its shard
+        QCOMPARE(Tracked::alive.loadRelaxed() - before, 2 * int(hash.size()));
+    }
+    QCOMPARE(Tracked::alive.loadRelaxed(), before);
+}
+
+void tst_QConcurrentHash::concurrentAccess()
+{
+    // Writers keep the invariant value % KeyCount == key, which readers check.
+    enum { KeyCount = 5000, WriterIterations = 100000 };
+
+    QConcurrentHash<int, qint64> hash;
+    QAtomicInt stop;
+    QAtomicInt failures;
+
+    std::vector<std::unique_ptr<QThread>> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back(QThread::create([&, t] {
+            quint32 state = t + 1;
+            while (!stop.loadRelaxed()) {
+                state = state * 1103515245u + 12345u;
+                const int key = int((state >> 8) % KeyCount);
+                qint64 value;
+                if (hash.lookup(key, &value) && value % KeyCount != key)
+                    failures.ref();
+            }
+        }));
+        readers.back()->start();
+    }
+
+    std::vector<std::unique_ptr<QThread>> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back(QThread::create([&, t] {
+            quint32 state = t + 100;
+            for (int i = 0; i < WriterIterations; ++i) {
+                state = state * 1103515245u + 12345u;
+                const int key = int((state >> 8) % KeyCount);
+                if (state % 3)
+                    hash.insert(key, qint64(i) * KeyCount + key);
+                else
+                    hash.remove(key);
+            }
+        }));
+        writers.back()->start();
+    }
+
+    for (const auto &writer : writers)
+        QVERIFY(writer->wait(60000));
+    stop.storeRelaxed(1);
+    for (const auto &reader : readers)
+        QVERIFY(reader->wait(60000));
+
+    QCOMPARE(failures.loadRelaxed(), 0);
+    qsizetype count = 0;
+    hash.forEach([&](int key, qint64 value) {
+        QCOMPARE(value % KeyCount, key);
+        ++count;
+    });
+    QCOMPARE(count, hash.size());
+}
+
+QTEST_MAIN(tst_QConcurrentHash)
+#include "tst_qconcurrenthash.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qslaballocator
+QT = core-private testlib
+SOURCES = tst_qslaballocator.cpp
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <private/qslaballocator_p.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using QtPrivate::QSlabAllocator;
+
+class tst_QSlabAllocator : public QObject
+{
+    Q_OBJECT
+public:
+    static void initMain() { qputenv("QT_OBJECT_SLAB_ALLOCATOR", "1"); }
+
+private slots:
+    void initTestCase();
+    void sameThread();
+    void crossThreadFree();
+};
+
+// 40 bytes and the block header make up size class 3, which nothing else
+// allocates from the test's own threads
+static const size_t BlockSize = 40;
+
+void tst_QSlabAllocator::initTestCase()
+{
+    if (!QSlabAllocator::isEnabled())
+        QSKIP("The slab allocator was used before QT_OBJECT_SLAB_ALLOCATOR could be set");
+}
+
+void tst_QSlabAllocator::sameThread()
+{
+    void *first = QSlabAllocator::allocate(BlockSize);
+    void *second = QSlabAllocator::allocate(BlockSize);
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(first != second);
+    QCOMPARE(quintptr(first) % 16, quintptr(0));
+    QCOMPARE(quintptr(second) % 16, quintptr(0));
+    memset(first, 1, BlockSize);
+    memset(second, 2, BlockSize);
+
+    // a block freed by its own thread is the next one handed out
+    QSlabAllocator::deallocate(second);
+    QCOMPARE(QSlabAllocator::allocate(BlockSize), second);
+    QSlabAllocator::deallocate(second);
+    QSlabAllocator::deallocate(first);
+
+    // blocks too large for any size class come from operator new
+    void *large = QSlabAllocator::allocate(4096);
+    QVERIFY(large);
+    memset(large, 3, 4096);
+    QSlabAllocator::deallocate(large);
+
+    QSlabAllocator::deallocate(nullptr);
+}
+
+void tst_QSlabAllocator::crossThreadFree()
+{
+    const int count = 100;
+    std::vector<void *> blocks;
+    bool contentsIntact = true;
+    QSemaphore allocated;
+    QSemaphore freed;
+
+    // thread A allocates and only exits once thread B freed all of its
+    // blocks, which therefore end up on A's list of remotely freed blocks
+    std::thread a([&] {
+        for (int i = 0; i < count; ++i) {
+            void *block = QSlabAllocator::allocate(BlockSize);
+            memset(block, i, BlockSize);
+            blocks.push_back(block);
+        }
+        allocated.release();
+        freed.acquire();
+    });
+    std::thread b([&] {
+        allocated.acquire();
+        for (int i = 0; i < count; ++i) {
+            const uchar *block = static_cast<const uchar *>(blocks[i]);
+            contentsIntact = contentsIntact && std::all_of(block, block + BlockSize, [i](uchar c) {
+                return c == uchar(i);
+            });
+            QSlabAllocator::deallocate(blocks[i]);
+        }
+        freed.release();
+    });
+    b.join();
+    a.join();
+    QVERIFY(contentsIntact);
+
+    // A's cache is handed over to the next thread that allocates, which gets
+    // the blocks freed by B once the ones A had carved but not used run out
+    std::vector<void *> reused;
+    std::thread c([&] {
+        for (int i = 0; i < count + 16; ++i) {
+            void *block = QSlabAllocator::allocate(BlockSize);
+            memset(block, 0xff, BlockSize);
+            reused.push_back(block);
+        }
+        for (void *block : reused)
+            QSlabAllocator::deallocate(block);
+    });
+    c.join();
+
+    for (void *block : blocks)
+        QVERIFY(std::find(reused.cbegin(), reused.cend(), block) != reused.cend());
+}
+
+QTEST_GUILESS_MAIN(tst_QSlabAllocator)
+#include "tst_qslaballocator.moc"
@@ -5,8 +5,10 @@ SUBDIRS=\
     qalgorithms \
     qarraydata \
     qbitarray \
+    qbtreemap \
     qcache \
     qcommandlineparser \
+    qconcurrenthash \
     qcontiguouscache \
     qcryptographichash \
     qeasingcurve \
@@ -35,6 +37,7 @@ SUBDIRS=\
     qset \
     qsharedpointer \
     qsize \
+    qslaballocator \
     qsizef \
     qstl \
     qtimeline \
@@ -12,6 +12,8 @@ SUBDIRS=\
    qnetworkcachemetadata \
    qhttpnetworkreply \
    qabstractnetworkcache \
+   qhttpserver \
+   qhttpconnectionpool \
    hpack \
    http2 \
    hsts \
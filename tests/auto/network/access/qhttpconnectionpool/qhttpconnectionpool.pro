@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qhttpconnectionpool
+SOURCES += tst_qhttpconnectionpool.cpp
+
+QT = core network network-private testlib
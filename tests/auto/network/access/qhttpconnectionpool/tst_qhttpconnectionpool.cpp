@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/private/qhttpserver_p.h>
+#include <QtNetwork/qhttpconnectionpoolconfiguration.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QHttpConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void configuration();
+    void connectionsPerHost_data();
+    void connectionsPerHost();
+    void idleTimeout();
+    void maximumIdleConnections();
+    void preconnect();
+    void http2StreamLimit_data();
+    void http2StreamLimit();
+
+private:
+    void holdResponses(int count);
+    QUrl url(const QString &host = QStringLiteral("127.0.0.1")) const;
+    QNetworkRequest http1Request(const QString &host = QStringLiteral("127.0.0.1")) const;
+    bool getAll(QNetworkAccessManager *manager, const QNetworkRequest &request, int count);
+
+    std::unique_ptr<QHttpServer> server;
+    QList<QHttpServerResponse *> heldResponses;
+    int maxHeldResponses = 0;
+};
+
+void tst_QHttpConnectionPool::init()
+{
+    server.reset(new QHttpServer);
+    heldResponses.clear();
+    maxHeldResponses = 0;
+}
+
+void tst_QHttpConnectionPool::cleanup()
+{
+    server.reset();
+}
+
+// Holds back the responses until count requests are waiting, so the
+// requests must have been sent on that many streams or connections at once.
+void tst_QHttpConnectionPool::holdResponses(int count)
+{
+    disconnect(server.get(), &QHttpServer::newRequest, this, nullptr);
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [this, count](QHttpServerRequest *, QHttpServerResponse *response) {
+        heldResponses.append(response);
+        maxHeldResponses = qMax(maxHeldResponses, int(heldResponses.size()));
+        if (heldResponses.size() < count)
+            return;
+        for (QHttpServerResponse *held : qExchange(heldResponses, {}))
+            held->end("ok");
+    });
+}
+
+QUrl tst_QHttpConnectionPool::url(const QString &host) const
+{
+    return QUrl(QStringLiteral("http://") + host + QLatin1Char(':')
+                + QString::number(server->serverPort()) + QStringLiteral("/"));
+}
+
+// Clear text requests that may be upgraded to HTTP/2 use a single
+// connection until the server answers the first one.
+QNetworkRequest tst_QHttpConnectionPool::http1Request(const QString &host) const
+{
+    QNetworkRequest request(url(host));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    return request;
+}
+
+bool tst_QHttpConnectionPool::getAll(QNetworkAccessManager *manager,
+                                     const QNetworkRequest &request, int count)
+{
+    std::vector<std::unique_ptr<QNetworkReply>> replies;
+    for (int i = 0; i < count; ++i)
+        replies.emplace_back(manager->get(request));
+    const bool finished = QTest::qWaitFor([&replies]() {
+        return std::all_of(replies.begin(), replies.end(),
+                           [](const auto &reply) { return reply->isFinished(); });
+    }, 10000);
+    if (!finished)
+        return false;
+    for (const auto &reply : replies) {
+        if (reply->error() != QNetworkReply::NoError || reply->readAll() != "ok")
+            return false;
+    }
+    return true;
+}
+
+void tst_QHttpConnectionPool::configuration()
+{
+    QHttpConnectionPoolConfiguration configuration;
+    QCOMPARE(configuration.maximumConnectionsPerHost(), 6);
+    QCOMPARE(configuration.maximumHttp2ConnectionsPerHost(), 1);
+    QCOMPARE(configuration.maximumIdleConnections(), -1);
+    QCOMPARE(configuration.idleTimeout(), 120000);
+    QCOMPARE(configuration.preconnectCount(), 1);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("invalid number of connections"));
+    QVERIFY(!configuration.setMaximumConnectionsPerHost(0));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("invalid number of connections"));
+    QVERIFY(!configuration.setMaximumConnectionsPerHost(1025));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("invalid number of HTTP/2 connections"));
+    QVERIFY(!configuration.setMaximumHttp2ConnectionsPerHost(0));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("invalid idle timeout"));
+    QVERIFY(!configuration.setIdleTimeout(-1));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("invalid preconnect count"));
+    QVERIFY(!configuration.setPreconnectCount(0));
+    QCOMPARE(configuration, QHttpConnectionPoolConfiguration());
+
+    QVERIFY(configuration.setMaximumConnectionsPerHost(64));
+    QVERIFY(configuration.setMaximumHttp2ConnectionsPerHost(4));
+    configuration.setMaximumIdleConnections(16);
+    QVERIFY(configuration.setIdleTimeout(0));
+    QVERIFY(configuration.setPreconnectCount(8));
+    QVERIFY(configuration != QHttpConnectionPoolConfiguration());
+
+    QNetworkAccessManager manager;
+    QCOMPARE(manager.connectionPoolConfiguration(), QHttpConnectionPoolConfiguration());
+    manager.setConnectionPoolConfiguration(configuration);
+    QCOMPARE(manager.connectionPoolConfiguration(), configuration);
+    QCOMPARE(manager.connectionPoolConfiguration().maximumConnectionsPerHost(), 64);
+
+    const QHttpConnectionPoolStatistics statistics = manager.connectionPoolStatistics();
+    QCOMPARE(statistics.requestCount(), quint64(0));
+    QCOMPARE(statistics.connectionsOpened(), quint64(0));
+    QCOMPARE(statistics.idleConnections(), 0);
+}
+
+void tst_QHttpConnectionPool::connectionsPerHost_data()
+{
+    QTest::addColumn<int>("limit");
+    QTest::addColumn<int>("requests");
+
+    QTest::newRow("default") << 0 << 12;
+    QTest::newRow("16") << 16 << 16;
+    QTest::newRow("50") << 50 << 50;
+}
+
+void tst_QHttpConnectionPool::connectionsPerHost()
+{
+    QFETCH(int, limit);
+    QFETCH(int, requests);
+
+    const int expected = limit ? limit : 6;
+    holdResponses(expected);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    if (limit) {
+        QHttpConnectionPoolConfiguration configuration;
+        QVERIFY(configuration.setMaximumConnectionsPerHost(limit));
+        manager.setConnectionPoolConfiguration(configuration);
+    }
+
+    QVERIFY(getAll(&manager, http1Request(), requests));
+    QCOMPARE(maxHeldResponses, expected);
+    QCOMPARE(server->connectionCount(), expected);
+
+    const QHttpConnectionPoolStatistics statistics = manager.connectionPoolStatistics();
+    QCOMPARE(statistics.requestCount(), quint64(requests));
+    QCOMPARE(statistics.connectionsOpened(), quint64(expected));
+    QTRY_COMPARE(manager.connectionPoolStatistics().idleConnections(), expected);
+}
+
+void tst_QHttpConnectionPool::idleTimeout()
+{
+    holdResponses(1);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    QVERIFY(configuration.setIdleTimeout(200));
+    manager.setConnectionPoolConfiguration(configuration);
+
+    QVERIFY(getAll(&manager, http1Request(), 1));
+    QCOMPARE(server->connectionCount(), 1);
+
+    // The connection is closed once it was idle for the timeout
+    QTRY_COMPARE(manager.connectionPoolStatistics().expiredConnections(), quint64(1));
+    QCOMPARE(manager.connectionPoolStatistics().idleConnections(), 0);
+    QTRY_COMPARE(server->connectionCount(), 0);
+
+    // ... and a new one is opened for the next request
+    QVERIFY(getAll(&manager, http1Request(), 1));
+    QCOMPARE(manager.connectionPoolStatistics().connectionsOpened(), quint64(2));
+}
+
+void tst_QHttpConnectionPool::maximumIdleConnections()
+{
+    holdResponses(1);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    configuration.setMaximumIdleConnections(1);
+    manager.setConnectionPoolConfiguration(configuration);
+
+    QVERIFY(getAll(&manager, http1Request(QStringLiteral("127.0.0.1")), 1));
+    QTRY_COMPARE(manager.connectionPoolStatistics().idleConnections(), 1);
+
+    // A second host goes over the limit, the least recently used
+    // connection is closed
+    QVERIFY(getAll(&manager, http1Request(QStringLiteral("localhost")), 1));
+    QTRY_COMPARE(manager.connectionPoolStatistics().evictedConnections(), quint64(1));
+    QCOMPARE(manager.connectionPoolStatistics().idleConnections(), 1);
+    QTRY_COMPARE(server->connectionCount(), 1);
+}
+
+void tst_QHttpConnectionPool::preconnect()
+{
+    holdResponses(3);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    QVERIFY(configuration.setPreconnectCount(3));
+    manager.setConnectionPoolConfiguration(configuration);
+
+    manager.connectToHost(QStringLiteral("127.0.0.1"), server->serverPort());
+    QTRY_COMPARE(server->connectionCount(), 3);
+    QTRY_COMPARE(manager.connectionPoolStatistics().idleConnections(), 3);
+
+    // The pre-warmed connections serve the requests, none is added
+    QVERIFY(getAll(&manager, http1Request(), 3));
+    QCOMPARE(maxHeldResponses, 3);
+    QCOMPARE(manager.connectionPoolStatistics().connectionsOpened(), quint64(3));
+    QCOMPARE(server->connectionCount(), 3);
+}
+
+void tst_QHttpConnectionPool::http2StreamLimit_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("concurrency");
+
+    QTest::newRow("single-connection") << 1 << 2;
+    QTest::newRow("three-connections") << 3 << 6;
+}
+
+void tst_QHttpConnectionPool::http2StreamLimit()
+{
+    QFETCH(int, connections);
+    QFETCH(int, concurrency);
+
+    server->setMaxConcurrentStreams(2);
+    holdResponses(1);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    QVERIFY(configuration.setMaximumHttp2ConnectionsPerHost(connections));
+    manager.setConnectionPoolConfiguration(configuration);
+
+    QNetworkRequest request(url());
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+
+    // Learn the server's limit first
+    QVERIFY(getAll(&manager, request, 1));
+
+    holdResponses(concurrency);
+    maxHeldResponses = 0;
+    QVERIFY(getAll(&manager, request, 6));
+    QCOMPARE(maxHeldResponses, concurrency);
+    QCOMPARE(server->connectionCount(), connections);
+
+    const QHttpConnectionPoolStatistics statistics = manager.connectionPoolStatistics();
+    QCOMPARE(statistics.requestCount(), quint64(7));
+    QCOMPARE(statistics.additionalHttp2Connections(), quint64(connections - 1));
+    QCOMPARE(statistics.connectionsOpened(), quint64(connections));
+}
+
+QTEST_MAIN(tst_QHttpConnectionPool)
+#include "tst_qhttpconnectionpool.moc"
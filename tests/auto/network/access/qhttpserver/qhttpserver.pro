@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qhttpserver
+SOURCES += tst_qhttpserver.cpp
+
+QT = core core-private network network-private testlib
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,939 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/private/qhttpserver_p.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qtcpsocket.h>
+#if QT_CONFIG(ssl)
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslsocket.h>
+#endif
+
+#include <memory>
+
+struct RawResponse
+{
+    int statusCode = 0;
+    QList<QPair<QByteArray, QByteArray>> headers;
+    QByteArray body;
+    bool chunked = false;
+
+    QByteArray header(const QByteArray &name) const
+    {
+        for (const auto &field : headers) {
+            if (field.first.compare(name, Qt::CaseInsensitive) == 0)
+                return field.second;
+        }
+        return QByteArray();
+    }
+};
+
+// Parses one response from the front of buffer, removing it from there.
+static bool parseResponse(QByteArray *buffer, RawResponse *response, bool isHead, bool closed)
+{
+    const int headerEnd = buffer->indexOf("\r\n\r\n");
+    if (headerEnd == -1)
+        return false;
+
+    RawResponse result;
+    const QList<QByteArray> lines = buffer->left(headerEnd).split('\n');
+    const QList<QByteArray> statusLine = lines.first().trimmed().split(' ');
+    if (statusLine.size() < 2)
+        return false;
+    result.statusCode = statusLine.at(1).toInt();
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines.at(i).indexOf(':');
+        result.headers.append({ lines.at(i).left(colon).trimmed().toLower(),
+                                lines.at(i).mid(colon + 1).trimmed() });
+    }
+
+    int pos = headerEnd + 4;
+    const bool hasBody = !isHead && result.statusCode >= 200 && result.statusCode != 204
+                         && result.statusCode != 304;
+    if (!hasBody) {
+        // no body
+    } else if (result.header("transfer-encoding") == "chunked") {
+        result.chunked = true;
+        forever {
+            const int lineEnd = buffer->indexOf("\r\n", pos);
+            if (lineEnd == -1)
+                return false;
+            const int size = buffer->mid(pos, lineEnd - pos).toInt(nullptr, 16);
+            if (buffer->size() < lineEnd + 2 + size + 2)
+                return false;
+            result.body += buffer->mid(lineEnd + 2, size);
+            pos = lineEnd + 2 + size + 2;
+            if (size == 0)
+                break;
+        }
+    } else if (!result.header("content-length").isNull()) {
+        const int size = result.header("content-length").toInt();
+        if (buffer->size() < pos + size)
+            return false;
+        result.body = buffer->mid(pos, size);
+        pos += size;
+    } else {
+        // delimited by closing the connection
+        if (!closed)
+            return false;
+        result.body = buffer->mid(pos);
+        pos = buffer->size();
+    }
+
+    buffer->remove(0, pos);
+    *response = result;
+    return true;
+}
+
+class RawClient
+{
+public:
+    bool connectTo(quint16 port)
+    {
+        socket.connectToHost(QHostAddress::LocalHost, port);
+        return QTest::qWaitFor([this]() {
+            return socket.state() == QAbstractSocket::ConnectedState;
+        }, 5000);
+    }
+
+    bool readResponse(RawResponse *response, bool isHead = false)
+    {
+        while (!parseResponse(&buffer, response, isHead, false)) {
+            const bool received = QTest::qWaitFor([this]() {
+                return socket.bytesAvailable() > 0
+                        || socket.state() != QAbstractSocket::ConnectedState;
+            }, 5000);
+            if (socket.bytesAvailable() > 0) {
+                buffer += socket.readAll();
+            } else if (!received) {
+                return false;
+            } else {
+                // closed: a close-delimited body is complete
+                return parseResponse(&buffer, response, isHead, true);
+            }
+        }
+        return true;
+    }
+
+    bool waitForDisconnected()
+    {
+        return QTest::qWaitFor([this]() {
+            buffer += socket.readAll();
+            return socket.state() == QAbstractSocket::UnconnectedState;
+        }, 5000);
+    }
+
+    QTcpSocket socket;
+    QByteArray buffer;
+};
+
+// Writes HTTP/2 frames by hand, to send what QNetworkAccessManager won't
+class RawHttp2Client : public RawClient
+{
+public:
+    enum FrameType { Data = 0x0, Headers = 0x1, RstStream = 0x3, Settings = 0x4, GoAway = 0x7,
+                     Continuation = 0x9 };
+    enum Flag { EndStream = 0x1, EndHeaders = 0x4 };
+
+    bool connectTo(quint16 port)
+    {
+        if (!RawClient::connectTo(port))
+            return false;
+        socket.write("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+        writeFrame(Settings, 0, 0);
+        return true;
+    }
+
+    void writeFrame(quint8 type, quint8 flags, quint32 streamID,
+                    const QByteArray &payload = QByteArray())
+    {
+        const uchar header[9] = { uchar(payload.size() >> 16), uchar(payload.size() >> 8),
+                                  uchar(payload.size()), type, flags, uchar(streamID >> 24),
+                                  uchar(streamID >> 16), uchar(streamID >> 8), uchar(streamID) };
+        socket.write(reinterpret_cast<const char *>(header), sizeof(header));
+        socket.write(payload);
+    }
+
+    // GET / with static table entries, RFC 7541, appendix A
+    static QByteArray requestHeaderBlock()
+    {
+        return QByteArray("\x82\x86\x84\x01\x09localhost", 14);
+    }
+
+    // Reads frames until one of type; returns its payload
+    bool readFrame(quint8 type, QByteArray *payload = nullptr, quint8 *flags = nullptr)
+    {
+        forever {
+            while (buffer.size() >= 9) {
+                const int size = (uchar(buffer.at(0)) << 16) | (uchar(buffer.at(1)) << 8)
+                                 | uchar(buffer.at(2));
+                if (buffer.size() < 9 + size)
+                    break;
+                const quint8 frameType = quint8(buffer.at(3));
+                const quint8 frameFlags = quint8(buffer.at(4));
+                const QByteArray framePayload = buffer.mid(9, size);
+                buffer.remove(0, 9 + size);
+                if (frameType == type) {
+                    if (payload)
+                        *payload = framePayload;
+                    if (flags)
+                        *flags = frameFlags;
+                    return true;
+                }
+            }
+            const bool received = QTest::qWaitFor([this]() {
+                return socket.bytesAvailable() > 0
+                        || socket.state() != QAbstractSocket::ConnectedState;
+            }, 5000);
+            if (!socket.bytesAvailable() || !received)
+                return false;
+            buffer += socket.readAll();
+        }
+    }
+
+    // Returns the error code of the GOAWAY frame sent by the server
+    quint32 readGoAway()
+    {
+        QByteArray payload;
+        if (!readFrame(GoAway, &payload) || payload.size() < 8)
+            return quint32(-1);
+        return qFromBigEndian<quint32>(payload.constData() + 4);
+    }
+};
+
+class tst_QHttpServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void keepAlive();
+    void http10();
+    void pipelining();
+    void chunkedResponse();
+    void headResponse();
+    void requestBody_data();
+    void requestBody();
+    void expectContinue();
+    void badRequest_data();
+    void badRequest();
+    void badChunkSize_data();
+    void badChunkSize();
+    void requestBodyBackpressure();
+    void responseProgress();
+    void invalidResponseFields();
+    void responseContentLength();
+    void http2_data();
+    void http2();
+    void http2LargeBodies();
+    void http2MaxHeaderListSize();
+    void http2ContinuationFlood();
+    void http2RapidReset();
+    void http2RequestContentLength_data();
+    void http2RequestContentLength();
+
+private:
+    void echoRequests();
+    void startServer();
+
+    std::unique_ptr<QHttpServer> server;
+};
+
+void tst_QHttpServer::init()
+{
+    server.reset(new QHttpServer);
+}
+
+void tst_QHttpServer::cleanup()
+{
+    server.reset();
+}
+
+void tst_QHttpServer::startServer()
+{
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+}
+
+// Responds with the method, the target and the body of each request.
+void tst_QHttpServer::echoRequests()
+{
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [](QHttpServerRequest *request, QHttpServerResponse *response) {
+        auto respond = [request, response]() {
+            if (!request->isBodyComplete() || response->isEnded())
+                return;
+            response->setHeader("Content-Type", "text/plain");
+            response->end(request->method() + ' ' + request->target() + ' ' + request->readAll());
+        };
+        connect(request, &QHttpServerRequest::readChannelFinished, response, respond);
+        respond();
+    });
+}
+
+void tst_QHttpServer::keepAlive()
+{
+    echoRequests();
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    for (int i = 0; i < 3; ++i) {
+        client.socket.write("GET /" + QByteArray::number(i) + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        RawResponse response;
+        QVERIFY(client.readResponse(&response));
+        QCOMPARE(response.statusCode, 200);
+        QCOMPARE(response.body, "GET /" + QByteArray::number(i) + ' ');
+        QCOMPARE(response.header("content-type"), QByteArray("text/plain"));
+        QCOMPARE(response.header("connection"), QByteArray());
+    }
+    QCOMPARE(server->connectionCount(), 1);
+
+    client.socket.write("GET /last HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.header("connection"), QByteArray("close"));
+    QVERIFY(client.waitForDisconnected());
+    QTRY_COMPARE(server->connectionCount(), 0);
+}
+
+void tst_QHttpServer::http10()
+{
+    echoRequests();
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("GET /a HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.body, QByteArray("GET /a "));
+    QCOMPARE(response.header("connection"), QByteArray("keep-alive"));
+
+    // Without keep-alive, the connection is closed
+    client.socket.write("GET /b HTTP/1.0\r\n\r\n");
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.body, QByteArray("GET /b "));
+    QCOMPARE(response.header("connection"), QByteArray("close"));
+    QVERIFY(client.waitForDisconnected());
+}
+
+void tst_QHttpServer::pipelining()
+{
+    // Responds in reverse order, once all requests arrived
+    QList<QPointer<QHttpServerResponse>> responses;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&responses](QHttpServerRequest *request, QHttpServerResponse *response) {
+        response->setHeader("x-target", request->target());
+        responses.append(response);
+    });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    QByteArray requests;
+    for (int i = 0; i < 3; ++i)
+        requests += "GET /" + QByteArray::number(i) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    client.socket.write(requests);
+
+    QTRY_COMPARE(responses.size(), 3);
+    for (int i = 2; i >= 0; --i) {
+        QVERIFY(responses.at(i));
+        responses.at(i)->end("response " + QByteArray::number(i));
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        RawResponse response;
+        QVERIFY(client.readResponse(&response));
+        QCOMPARE(response.header("x-target"), "/" + QByteArray::number(i));
+        QCOMPARE(response.body, "response " + QByteArray::number(i));
+    }
+}
+
+void tst_QHttpServer::chunkedResponse()
+{
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [](QHttpServerRequest *, QHttpServerResponse *response) {
+        response->write("first ");
+        QTimer::singleShot(10, response, [response]() {
+            response->write("second");
+            response->end();
+        });
+    });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QVERIFY(response.chunked);
+    QCOMPARE(response.body, QByteArray("first second"));
+
+    // HTTP/1.0 clients get a body delimited by the end of the connection
+    RawClient client10;
+    QVERIFY(client10.connectTo(server->serverPort()));
+    client10.socket.write("GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    QVERIFY(client10.readResponse(&response));
+    QVERIFY(!response.chunked);
+    QCOMPARE(response.header("connection"), QByteArray("close"));
+    QCOMPARE(response.body, QByteArray("first second"));
+}
+
+void tst_QHttpServer::headResponse()
+{
+    echoRequests();
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("HEAD /x HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                        "GET /y HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response, true));
+    QCOMPARE(response.statusCode, 200);
+    QVERIFY(response.body.isEmpty());
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.body, QByteArray("GET /y "));
+}
+
+void tst_QHttpServer::requestBody_data()
+{
+    QTest::addColumn<QByteArray>("request");
+
+    QTest::newRow("content-length")
+            << QByteArray("POST /p HTTP/1.1\r\nHost: localhost\r\nContent-Length: 11\r\n\r\n"
+                          "hello world");
+    QTest::newRow("chunked")
+            << QByteArray("POST /p HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+                          "5;ext=1\r\nhello\r\n6\r\n world\r\n0\r\nTrailer: x\r\n\r\n");
+}
+
+void tst_QHttpServer::requestBody()
+{
+    QFETCH(QByteArray, request);
+
+    echoRequests();
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    // Byte by byte, and then all at once
+    for (char c : qAsConst(request)) {
+        client.socket.write(&c, 1);
+        client.socket.flush();
+    }
+    client.socket.write(request);
+
+    for (int i = 0; i < 2; ++i) {
+        RawResponse response;
+        QVERIFY(client.readResponse(&response));
+        QCOMPARE(response.statusCode, 200);
+        QCOMPARE(response.body, QByteArray("POST /p hello world"));
+    }
+}
+
+void tst_QHttpServer::expectContinue()
+{
+    echoRequests();
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("PUT /c HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4\r\n"
+                        "Expect: 100-continue\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.statusCode, 100);
+
+    client.socket.write("body");
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.statusCode, 200);
+    QCOMPARE(response.body, QByteArray("PUT /c body"));
+}
+
+void tst_QHttpServer::badRequest_data()
+{
+    QTest::addColumn<QByteArray>("request");
+    QTest::addColumn<int>("statusCode");
+
+    QTest::newRow("garbage") << QByteArray("garbage\r\n\r\n") << 400;
+    QTest::newRow("no-host") << QByteArray("GET / HTTP/1.1\r\n\r\n") << 400;
+    QTest::newRow("version") << QByteArray("GET / HTTP/3.0\r\nHost: x\r\n\r\n") << 505;
+    QTest::newRow("content-length")
+            << QByteArray("POST / HTTP/1.1\r\nHost: x\r\nContent-Length: -1\r\n\r\n") << 400;
+    QTest::newRow("both-framings")
+            << QByteArray("POST / HTTP/1.1\r\nHost: x\r\nContent-Length: 1\r\n"
+                          "Transfer-Encoding: chunked\r\n\r\n") << 400;
+    QTest::newRow("transfer-coding")
+            << QByteArray("POST / HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: gzip\r\n\r\n") << 501;
+    QTest::newRow("long-header")
+            << "GET / HTTP/1.1\r\nHost: x\r\nX: " + QByteArray(16 * 1024, 'x') + "\r\n\r\n" << 431;
+    QTest::newRow("expectation")
+            << QByteArray("GET / HTTP/1.1\r\nHost: x\r\nExpect: something\r\n\r\n") << 417;
+}
+
+void tst_QHttpServer::badRequest()
+{
+    QFETCH(QByteArray, request);
+    QFETCH(int, statusCode);
+
+    int requestCount = 0;
+    connect(server.get(), &QHttpServer::newRequest, this, [&requestCount]() { ++requestCount; });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write(request);
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.statusCode, statusCode);
+    QCOMPARE(response.header("connection"), QByteArray("close"));
+    QVERIFY(client.waitForDisconnected());
+    QCOMPARE(requestCount, 0);
+}
+
+void tst_QHttpServer::badChunkSize_data()
+{
+    QTest::addColumn<QByteArray>("chunkSize");
+
+    QTest::newRow("hex-prefix") << QByteArray("0x10");
+    QTest::newRow("plus") << QByteArray("+10");
+    QTest::newRow("minus") << QByteArray("-10");
+    QTest::newRow("leading-space") << QByteArray(" 10");
+    QTest::newRow("trailing-space") << QByteArray("10 ");
+    QTest::newRow("space-before-extension") << QByteArray("10 ;ext");
+    QTest::newRow("empty") << QByteArray("");
+    QTest::newRow("extension-only") << QByteArray(";ext");
+    QTest::newRow("garbage") << QByteArray("1g");
+    QTest::newRow("too-long") << QByteArray("1000000000000000");
+}
+
+void tst_QHttpServer::badChunkSize()
+{
+    QFETCH(QByteArray, chunkSize);
+
+    echoRequests();
+    bool aborted = false;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&aborted](QHttpServerRequest *request) {
+        connect(request, &QHttpServerRequest::aborted, [&aborted]() { aborted = true; });
+    });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("POST / HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n"
+                        + chunkSize + "\r\n" + QByteArray(16, 'x') + "\r\n0\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.statusCode, 400);
+    QCOMPARE(response.header("connection"), QByteArray("close"));
+    QVERIFY(client.waitForDisconnected());
+    QVERIFY(aborted);
+}
+
+void tst_QHttpServer::requestBodyBackpressure()
+{
+    const qint64 bufferSize = 64 * 1024;
+    const qint64 bodySize = 16 * 1024 * 1024;
+    server->setRequestBodyBufferSize(bufferSize);
+
+    QPointer<QHttpServerRequest> serverRequest;
+    QPointer<QHttpServerResponse> serverResponse;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        serverRequest = request;
+        serverResponse = response;
+    });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("POST / HTTP/1.1\r\nHost: localhost\r\nContent-Length: "
+                        + QByteArray::number(bodySize) + "\r\n\r\n");
+    const QByteArray block(64 * 1024, 'b');
+    for (qint64 written = 0; written < bodySize; written += block.size())
+        client.socket.write(block);
+
+    QTRY_VERIFY(serverRequest);
+    QTRY_COMPARE(serverRequest->bytesAvailable(), bufferSize);
+    // The client cannot get rid of its data, and the server does not take more
+    QTest::qWait(200);
+    QCOMPARE(serverRequest->bytesAvailable(), bufferSize);
+    QVERIFY(client.socket.bytesToWrite() > 0);
+
+    qint64 received = 0;
+    QVERIFY(QTest::qWaitFor([&]() {
+        received += serverRequest->readAll().size();
+        return serverRequest->atEnd();
+    }, 20000));
+    QCOMPARE(received, bodySize);
+
+    serverResponse->end("done");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.body, QByteArray("done"));
+}
+
+void tst_QHttpServer::responseProgress()
+{
+    const QByteArray body(8 * 1024 * 1024, 'r');
+    qint64 bytesWritten = 0;
+    qint64 maxBytesToWrite = 0;
+    bool finished = false;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *, QHttpServerResponse *response) {
+        connect(response, &QIODevice::bytesWritten, this, [&](qint64 size) {
+            bytesWritten += size;
+        });
+        connect(response, &QHttpServerResponse::finished, this, [&]() { finished = true; });
+        response->setHeader("content-length", QByteArray::number(body.size()));
+        for (int i = 0; i < body.size(); i += 1024 * 1024) {
+            response->write(body.mid(i, 1024 * 1024));
+            maxBytesToWrite = qMax(maxBytesToWrite, response->bytesToWrite());
+        }
+        response->end();
+        QVERIFY(!finished);
+    });
+    startServer();
+
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.body.size(), body.size());
+    QTRY_VERIFY(finished);
+    QCOMPARE(bytesWritten, qint64(body.size()));
+    // The connection queued what the socket could not take
+    QVERIFY(maxBytesToWrite > 0);
+}
+
+void tst_QHttpServer::invalidResponseFields()
+{
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [](QHttpServerRequest *, QHttpServerResponse *response) {
+        response->setHeader("bad name", "value");
+        response->addHeader("x-bad:name", "value");
+        response->setHeader("x-injected", "value\r\nx-evil: yes");
+        response->addHeader("x-injected", "value\nx-evil: yes");
+        response->setHeader("x-nul", QByteArray("a\0b", 3));
+        response->setHeader("content-length", "2, 2");
+        response->setHeader("x-good", "value");
+        response->end("ok");
+    });
+    startServer();
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::setHeader: invalid field name \"bad%20name\"");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::addHeader: invalid field name \"x-bad%3Aname\"");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::setHeader: invalid value for field \"x-injected\"");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::addHeader: invalid value for field \"x-injected\"");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::setHeader: invalid value for field \"x-nul\"");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::setHeader: invalid value for field \"content-length\"");
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    RawResponse response;
+    QVERIFY(client.readResponse(&response));
+    QCOMPARE(response.statusCode, 200);
+    QCOMPARE(response.body, QByteArray("ok"));
+    QCOMPARE(response.header("x-good"), QByteArray("value"));
+    QCOMPARE(response.header("content-length"), QByteArray("2"));
+    for (const auto &field : response.headers) {
+        QVERIFY(field.first != "x-injected");
+        QVERIFY(field.first != "x-evil");
+        QVERIFY(field.first != "x-nul");
+        QVERIFY(!field.first.contains("name"));
+    }
+}
+
+void tst_QHttpServer::responseContentLength()
+{
+    qint64 tooLong = 0;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&tooLong](QHttpServerRequest *, QHttpServerResponse *response) {
+        response->setHeader("content-length", "10");
+        tooLong = response->write("0123456789x");
+        response->write("01234");
+        response->end();
+    });
+    startServer();
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse: the body is longer than the Content-Length field");
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QHttpServerResponse::end: the body is shorter than the Content-Length field");
+    RawClient client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    client.socket.write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    // The client can only tell the body is truncated by the closed connection
+    QVERIFY(client.waitForDisconnected());
+    QCOMPARE(tooLong, qint64(-1));
+    QVERIFY(client.buffer.contains("\r\ncontent-length: 10\r\n"));
+    QVERIFY(client.buffer.endsWith("\r\n\r\n01234"));
+}
+
+void tst_QHttpServer::http2_data()
+{
+    QTest::addColumn<QNetworkRequest::Attribute>("attribute");
+    QTest::addColumn<bool>("encrypted");
+
+    QTest::newRow("h2c-upgrade") << QNetworkRequest::Http2AllowedAttribute << false;
+    QTest::newRow("h2c-direct") << QNetworkRequest::Http2DirectAttribute << false;
+#if QT_CONFIG(ssl)
+    if (QSslSocket::supportsSsl())
+        QTest::newRow("h2-alpn") << QNetworkRequest::Http2AllowedAttribute << true;
+#endif
+}
+
+void tst_QHttpServer::http2()
+{
+    QFETCH(QNetworkRequest::Attribute, attribute);
+    QFETCH(bool, encrypted);
+
+    if (encrypted) {
+#if QT_CONFIG(ssl)
+        QFile keyFile(SRCDIR "certs/fluke.key");
+        QVERIFY(keyFile.open(QIODevice::ReadOnly));
+        QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+        configuration.setPrivateKey(QSslKey(keyFile.readAll(), QSsl::Rsa));
+        configuration.setLocalCertificate(QSslCertificate::fromPath(SRCDIR "certs/fluke.cert").first());
+        configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+        server->setSslConfiguration(configuration);
+#endif
+    }
+
+    QList<QHttpServerRequest::Protocol> protocols;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&protocols](QHttpServerRequest *request, QHttpServerResponse *response) {
+        protocols.append(request->protocol());
+        auto respond = [request, response]() {
+            if (!request->isBodyComplete() || response->isEnded())
+                return;
+            response->setHeader("x-url", request->url().toEncoded());
+            response->end(request->method() + ' ' + request->readAll());
+        };
+        connect(request, &QHttpServerRequest::readChannelFinished, response, respond);
+        respond();
+    });
+    startServer();
+
+    QNetworkAccessManager manager;
+    const QString scheme = encrypted ? QStringLiteral("https") : QStringLiteral("http");
+    const QUrl url(scheme + QStringLiteral("://localhost:") + QString::number(server->serverPort())
+                   + QStringLiteral("/path?q=1"));
+
+    // The first request is upgraded, the others are sent on the same
+    // HTTP/2 connection
+    for (int i = 0; i < 3; ++i) {
+        QNetworkRequest request(url);
+        request.setAttribute(attribute, true);
+        std::unique_ptr<QNetworkReply> reply(i == 0 ? manager.get(request)
+                                                    : manager.post(request, "body " + QByteArray::number(i)));
+#if QT_CONFIG(ssl)
+        reply->ignoreSslErrors();
+#endif
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+        QCOMPARE(reply->rawHeader("x-url"), url.toEncoded());
+        QCOMPARE(reply->readAll(), i == 0 ? QByteArray("GET ") : "POST body " + QByteArray::number(i));
+    }
+
+    QCOMPARE(protocols.size(), 3);
+    for (QHttpServerRequest::Protocol protocol : qAsConst(protocols))
+        QCOMPARE(protocol, QHttpServerRequest::Protocol::Http2);
+    QCOMPARE(server->connectionCount(), 1);
+}
+
+void tst_QHttpServer::http2LargeBodies()
+{
+    // More than the flow control windows of both sides
+    const QByteArray uploaded(4 * 1024 * 1024, 'u');
+    const QByteArray downloaded(2 * 1024 * 1024, 'd');
+    server->setRequestBodyBufferSize(128 * 1024);
+    QHttp2Configuration configuration = server->http2Configuration();
+    configuration.setStreamReceiveWindowSize(128 * 1024);
+    server->setHttp2Configuration(configuration);
+
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *response) {
+        auto received = std::make_shared<qint64>(0);
+        auto read = [=]() {
+            *received += request->readAll().size();
+            if (!request->isBodyComplete() || response->isEnded())
+                return;
+            response->setHeader("x-received", QByteArray::number(*received));
+            response->end(downloaded);
+        };
+        connect(request, &QIODevice::readyRead, response, read);
+        connect(request, &QHttpServerRequest::readChannelFinished, response, read);
+    });
+    startServer();
+
+    QNetworkAccessManager manager;
+    QHttp2Configuration clientConfiguration;
+    clientConfiguration.setStreamReceiveWindowSize(256 * 1024);
+    clientConfiguration.setSessionReceiveWindowSize(256 * 1024);
+    QNetworkRequest request(QUrl(QStringLiteral("http://localhost:")
+                                 + QString::number(server->serverPort())));
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    request.setHttp2Configuration(clientConfiguration);
+    std::unique_ptr<QNetworkReply> reply(manager.post(request, uploaded));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 20000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->rawHeader("x-received").toLongLong(), qint64(uploaded.size()));
+    QCOMPARE(reply->readAll(), downloaded);
+}
+
+void tst_QHttpServer::http2MaxHeaderListSize()
+{
+    startServer();
+
+    RawHttp2Client client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    QByteArray payload;
+    quint8 flags = 0;
+    do {
+        QVERIFY(client.readFrame(RawHttp2Client::Settings, &payload, &flags));
+    } while (flags);
+
+    quint32 maxHeaderListSize = 0;
+    for (int i = 0; i + 6 <= payload.size(); i += 6) {
+        if (qFromBigEndian<quint16>(payload.constData() + i) == 0x6)
+            maxHeaderListSize = qFromBigEndian<quint32>(payload.constData() + i + 2);
+    }
+    QCOMPARE(maxHeaderListSize, quint32(64 * 1024));
+}
+
+void tst_QHttpServer::http2ContinuationFlood()
+{
+    int requestCount = 0;
+    connect(server.get(), &QHttpServer::newRequest, this, [&requestCount]() { ++requestCount; });
+    startServer();
+
+    RawHttp2Client client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    QTest::ignoreMessage(QtWarningMsg, "server connection error: header block too large");
+    client.writeFrame(RawHttp2Client::Headers, RawHttp2Client::EndStream, 1,
+                      RawHttp2Client::requestHeaderBlock());
+    // Never ends the header block
+    for (int i = 0; i < 16 && client.socket.state() == QAbstractSocket::ConnectedState; ++i) {
+        client.writeFrame(RawHttp2Client::Continuation, 0, 1, QByteArray(16 * 1024, '\x80'));
+        client.socket.flush();
+    }
+    QCOMPARE(client.readGoAway(), quint32(0xb)); // ENHANCE_YOUR_CALM
+    QVERIFY(client.waitForDisconnected());
+    QCOMPARE(requestCount, 0);
+}
+
+void tst_QHttpServer::http2RapidReset()
+{
+    int requestCount = 0;
+    connect(server.get(), &QHttpServer::newRequest, this, [&requestCount]() { ++requestCount; });
+    startServer();
+
+    RawHttp2Client client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    QTest::ignoreMessage(QtWarningMsg, "server connection error: too many streams reset");
+    // Each request is cancelled as soon as it was sent
+    const QByteArray cancel("\0\0\0\x8", 4);
+    for (quint32 streamID = 1; streamID < 2 * 300; streamID += 2) {
+        client.writeFrame(RawHttp2Client::Headers,
+                          RawHttp2Client::EndStream | RawHttp2Client::EndHeaders, streamID,
+                          RawHttp2Client::requestHeaderBlock());
+        client.writeFrame(RawHttp2Client::RstStream, 0, streamID, cancel);
+    }
+    QCOMPARE(client.readGoAway(), quint32(0xb)); // ENHANCE_YOUR_CALM
+    QVERIFY(client.waitForDisconnected());
+    QVERIFY(requestCount > 0);
+    QVERIFY(requestCount < 300);
+}
+
+void tst_QHttpServer::http2RequestContentLength_data()
+{
+    QTest::addColumn<QList<QByteArray>>("frames");
+    QTest::addColumn<bool>("endStreamOnHeaders");
+
+    QTest::newRow("longer") << QList<QByteArray> { "abcd" } << false;
+    QTest::newRow("longer-split") << QList<QByteArray> { "ab", "cd" } << false;
+    QTest::newRow("shorter") << QList<QByteArray> { "ab" } << false;
+    QTest::newRow("no-data") << QList<QByteArray>() << true;
+}
+
+void tst_QHttpServer::http2RequestContentLength()
+{
+    QFETCH(QList<QByteArray>, frames);
+    QFETCH(bool, endStreamOnHeaders);
+
+    QByteArray body;
+    bool bodyComplete = false;
+    connect(server.get(), &QHttpServer::newRequest, this,
+            [&](QHttpServerRequest *request, QHttpServerResponse *) {
+        connect(request, &QIODevice::readyRead, this, [&, request]() { body += request->readAll(); });
+        connect(request, &QIODevice::readChannelFinished, this, [&]() { bodyComplete = true; });
+    });
+    startServer();
+
+    RawHttp2Client client;
+    QVERIFY(client.connectTo(server->serverPort()));
+    // POST / with "content-length: 3", as a literal field with an indexed name
+    const QByteArray headerBlock = QByteArray("\x83\x86\x84\x01\x09localhost", 14)
+                                   + QByteArray("\x0f\x0d\x01" "3", 4);
+    client.writeFrame(RawHttp2Client::Headers,
+                      RawHttp2Client::EndHeaders
+                              | (endStreamOnHeaders ? RawHttp2Client::EndStream : 0),
+                      1, headerBlock);
+    for (int i = 0; i < frames.size(); ++i) {
+        client.writeFrame(RawHttp2Client::Data,
+                          i == frames.size() - 1 ? RawHttp2Client::EndStream : 0, 1, frames.at(i));
+    }
+
+    QByteArray payload;
+    QVERIFY(client.readFrame(RawHttp2Client::RstStream, &payload));
+    QCOMPARE(qFromBigEndian<quint32>(payload.constData()), quint32(0x1)); // PROTOCOL_ERROR
+    QVERIFY(!bodyComplete);
+    QVERIFY(body.size() < 3);
+}
+
+QTEST_MAIN(tst_QHttpServer)
+#include "tst_qhttpserver.moc"
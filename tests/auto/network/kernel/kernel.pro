@@ -2,6 +2,7 @@ TEMPLATE=subdirs
 SUBDIRS=\
    qdnslookup \
    qdnslookup_appless \
+   qdnsresolver \
    qhostinfo \
    qnetworkproxyfactory \
    qauthenticator \
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qdnsresolver
+SOURCES += tst_qdnsresolver.cpp
+
+QT = core network network-private testlib
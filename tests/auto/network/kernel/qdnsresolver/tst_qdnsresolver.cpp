@@ -0,0 +1,517 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/qhostinfo.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+#include <QtNetwork/qudpsocket.h>
+#include <QtNetwork/private/qhostinfo_p.h>
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+#include <QtNetwork/private/qdnsresolver_p.h>
+#endif
+
+#ifdef Q_OS_UNIX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <memory>
+
+// A minimal authoritative name server answering A and AAAA queries
+// from a table, over UDP and TCP on the same port.
+class DnsServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Zone {
+        QList<QHostAddress> addresses;
+        quint32 ttl = 300;
+        quint8 rcode = 0;
+        bool truncate = false;
+        // Adds a record whose RDATA runs past the end of the message
+        bool malformed = false;
+        // Answers with a CNAME to this name, followed by its addresses
+        QByteArray canonicalName = {};
+        // Addresses answered under a name that was not asked for
+        QList<QHostAddress> unrelatedAddresses = {};
+    };
+
+    bool listen()
+    {
+        if (!udp.bind(QHostAddress::LocalHost, 0))
+            return false;
+        connect(&udp, &QUdpSocket::readyRead, this, &DnsServer::readDatagrams);
+        connect(&tcp, &QTcpServer::newConnection, this, &DnsServer::acceptConnection);
+        return tcp.listen(QHostAddress::LocalHost, udp.localPort());
+    }
+    quint16 port() const { return udp.localPort(); }
+
+    QHash<QByteArray, Zone> zones;
+    quint32 negativeTtl = 60;
+    bool sendSoa = true;
+    int udpQueries = 0;
+    int tcpQueries = 0;
+    QList<quint16> queryTypes;
+
+private:
+    void readDatagrams()
+    {
+        while (udp.hasPendingDatagrams()) {
+            QHostAddress sender;
+            quint16 senderPort;
+            QByteArray query(int(udp.pendingDatagramSize()), Qt::Uninitialized);
+            udp.readDatagram(query.data(), query.size(), &sender, &senderPort);
+            ++udpQueries;
+            const QByteArray response = respond(query, false);
+            if (!response.isEmpty())
+                udp.writeDatagram(response, sender, senderPort);
+        }
+    }
+
+    void acceptConnection()
+    {
+        while (QTcpSocket *socket = tcp.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+                while (socket->bytesAvailable() >= 2) {
+                    uchar length[2];
+                    socket->peek(reinterpret_cast<char *>(length), 2);
+                    const int size = (length[0] << 8) | length[1];
+                    if (socket->bytesAvailable() < size + 2)
+                        return;
+                    socket->skip(2);
+                    ++tcpQueries;
+                    const QByteArray response = respond(socket->read(size), true);
+                    const uchar prefix[2] = { uchar(response.size() >> 8), uchar(response.size()) };
+                    socket->write(reinterpret_cast<const char *>(prefix), 2);
+                    socket->write(response);
+                }
+            });
+        }
+    }
+
+    static QByteArray encodeName(const QByteArray &name)
+    {
+        QByteArray encoded;
+        for (const QByteArray &label : name.split('.'))
+            encoded += char(label.size()) + label;
+        return encoded + '\0';
+    }
+
+    static void writeAddress(QDataStream &stream, const QByteArray &owner, quint16 type,
+                             quint32 ttl, const QHostAddress &address)
+    {
+        if (owner.isEmpty())
+            stream << quint16(0xc00c);
+        else
+            stream.writeRawData(owner.constData(), owner.size());
+        stream << type << quint16(1) << ttl;
+        if (type == 1) {
+            stream << quint16(4) << address.toIPv4Address();
+        } else {
+            const Q_IPV6ADDR bytes = address.toIPv6Address();
+            stream << quint16(16);
+            stream.writeRawData(reinterpret_cast<const char *>(bytes.c), 16);
+        }
+    }
+
+    QByteArray respond(const QByteArray &query, bool overTcp)
+    {
+        if (query.size() < 12)
+            return QByteArray();
+
+        // the question: labels followed by QTYPE and QCLASS
+        QByteArray name;
+        int offset = 12;
+        while (offset < query.size() && query.at(offset)) {
+            const int length = uchar(query.at(offset));
+            if (!name.isEmpty())
+                name += '.';
+            name += query.mid(offset + 1, length).toLower();
+            offset += length + 1;
+        }
+        offset += 5;
+        if (offset > query.size())
+            return QByteArray();
+        const quint16 type = (uchar(query.at(offset - 4)) << 8) | uchar(query.at(offset - 3));
+        queryTypes += type;
+
+        const auto matchesType = [type](const QHostAddress &address) {
+            return (type == 1 && address.protocol() == QAbstractSocket::IPv4Protocol)
+                || (type == 28 && address.protocol() == QAbstractSocket::IPv6Protocol);
+        };
+        auto it = zones.constFind(name);
+        QByteArray canonicalName = {};
+        if (it != zones.constEnd() && !it->canonicalName.isEmpty()) {
+            canonicalName = it->canonicalName;
+            it = zones.constFind(canonicalName);
+        }
+        QList<QHostAddress> answers;
+        QList<QHostAddress> unrelated;
+        quint8 rcode = 3; // NXDOMAIN
+        bool truncate = false;
+        bool malformed = false;
+        quint32 ttl = 0;
+        if (it != zones.constEnd()) {
+            rcode = it->rcode;
+            malformed = it->malformed;
+            truncate = it->truncate && !overTcp;
+            ttl = it->ttl;
+            for (const QHostAddress &address : it->addresses) {
+                if (matchesType(address))
+                    answers += address;
+            }
+            for (const QHostAddress &address : it->unrelatedAddresses) {
+                if (matchesType(address))
+                    unrelated += address;
+            }
+        }
+        if (!canonicalName.isEmpty() && rcode == 3)
+            rcode = 0;
+        if (truncate) {
+            answers.clear();
+            unrelated.clear();
+            canonicalName.clear();
+        }
+        const bool negative = (rcode == 0 || rcode == 3) && answers.isEmpty() && !truncate;
+        const QByteArray target = encodeName(canonicalName);
+        static const QByteArray unrelatedOwner = encodeName("unrelated.test");
+
+        QByteArray response;
+        QDataStream stream(&response, QIODevice::WriteOnly);
+        stream.writeRawData(query.constData(), 2);
+        stream << quint16(0x8000 | 0x0080 | (truncate ? 0x0200 : 0)
+                          | (uchar(query.at(2)) & 0x01) << 8 | rcode);
+        stream << quint16(1)
+               << quint16(answers.size() + unrelated.size() + (malformed ? 1 : 0)
+                          + (canonicalName.isEmpty() ? 0 : 1))
+               << quint16(negative && sendSoa ? 1 : 0) << quint16(0);
+        stream.writeRawData(query.constData() + 12, offset - 12);
+        if (!canonicalName.isEmpty()) {
+            stream << quint16(0xc00c) << quint16(5) << quint16(1) << ttl << quint16(target.size());
+            stream.writeRawData(target.constData(), target.size());
+        }
+        for (const QHostAddress &address : qAsConst(answers))
+            writeAddress(stream, canonicalName.isEmpty() ? QByteArray() : target, type, ttl, address);
+        for (const QHostAddress &address : qAsConst(unrelated))
+            writeAddress(stream, unrelatedOwner, type, ttl, address);
+        if (malformed) {
+            stream << quint16(0xc00c) << quint16(99) << quint16(1) << ttl << quint16(0xffff);
+            stream.writeRawData("\x7f\0", 2);
+            return response;
+        }
+        if (negative && sendSoa) {
+            static const char mname[] = "\2ns\4test";
+            static const char rname[] = "\4root\4test";
+            stream << quint16(0xc00c) << quint16(6) << quint16(1) << negativeTtl
+                   << quint16(sizeof(mname) + sizeof(rname) + 20);
+            stream.writeRawData(mname, sizeof(mname));
+            stream.writeRawData(rname, sizeof(rname));
+            stream << quint32(1) << quint32(3600) << quint32(600) << quint32(86400) << negativeTtl;
+        }
+        return response;
+    }
+
+    QUdpSocket udp;
+    QTcpServer tcp;
+};
+
+class tst_QDnsResolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void parallelQueries();
+    void timeToLive();
+    void negativeCaching();
+    void negativeAnswerWithoutSoa();
+    void canonicalName();
+    void unrelatedRecords();
+    void truncatedResponse();
+    void serverFailure();
+    void malformedResponse();
+    void happyEyeballs();
+
+private:
+    QHostInfo lookup(const QString &name);
+    void useResolver(const QList<DnsServer *> &servers);
+
+    std::unique_ptr<DnsServer> server;
+};
+
+void tst_QDnsResolver::initTestCase()
+{
+#ifndef QT_HOSTINFO_DNS_RESOLVER
+    QSKIP("The built-in DNS resolver is not available on this platform");
+#endif
+}
+
+void tst_QDnsResolver::init()
+{
+    server.reset(new DnsServer);
+    QVERIFY(server->listen());
+    useResolver({ server.get() });
+}
+
+void tst_QDnsResolver::cleanup()
+{
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    qt_qhostinfo_set_dns_resolver(nullptr);
+#endif
+    server.reset();
+}
+
+void tst_QDnsResolver::useResolver(const QList<DnsServer *> &servers)
+{
+#ifdef QT_HOSTINFO_DNS_RESOLVER
+    QDnsResolverConfiguration configuration;
+    for (DnsServer *s : servers)
+        configuration.nameservers.append({ QHostAddress(QHostAddress::LocalHost), s->port() });
+    configuration.timeout = 500;
+    configuration.attempts = 1;
+    configuration.ipv6 = true;
+    qt_qhostinfo_set_dns_resolver(&configuration);
+#else
+    Q_UNUSED(servers);
+#endif
+}
+
+QHostInfo tst_QDnsResolver::lookup(const QString &name)
+{
+    QHostInfo result;
+    bool finished = false;
+    QHostInfo::lookupHost(name, this, [&](const QHostInfo &info) {
+        result = info;
+        finished = true;
+    });
+    if (!QTest::qWaitFor([&] { return finished; }, 10000))
+        result.setError(QHostInfo::UnknownError);
+    return result;
+}
+
+void tst_QDnsResolver::parallelQueries()
+{
+    server->zones.insert("dual.example.test",
+                         { { QHostAddress(QHostAddress::LocalHost),
+                             QHostAddress(QHostAddress::LocalHostIPv6) } });
+
+    const QHostInfo info = lookup(QStringLiteral("dual.example.test"));
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    const QList<QHostAddress> expected = { QHostAddress(QHostAddress::LocalHostIPv6),
+                                           QHostAddress(QHostAddress::LocalHost) };
+    QCOMPARE(info.addresses(), expected);
+    QCOMPARE(server->udpQueries, 2);
+    QVERIFY(server->queryTypes.contains(1));
+    QVERIFY(server->queryTypes.contains(28));
+}
+
+void tst_QDnsResolver::timeToLive()
+{
+    DnsServer::Zone zone;
+    zone.addresses = { QHostAddress(QHostAddress::LocalHost) };
+    zone.ttl = 1;
+    server->zones.insert("short.example.test", zone);
+
+    QCOMPARE(lookup(QStringLiteral("short.example.test")).addresses(), zone.addresses);
+    const int queries = server->udpQueries;
+    QCOMPARE(lookup(QStringLiteral("short.example.test")).addresses(), zone.addresses);
+    QCOMPARE(server->udpQueries, queries);
+
+    // the cached entry expires with the record
+    QTest::qWait(1200);
+    QCOMPARE(lookup(QStringLiteral("short.example.test")).addresses(), zone.addresses);
+    QCOMPARE(server->udpQueries, 2 * queries);
+}
+
+void tst_QDnsResolver::negativeCaching()
+{
+    const QHostInfo info = lookup(QStringLiteral("missing.example.test"));
+    QCOMPARE(info.error(), QHostInfo::HostNotFound);
+    QVERIFY(info.addresses().isEmpty());
+    const int queries = server->udpQueries;
+    QVERIFY(queries > 0);
+
+    QCOMPARE(lookup(QStringLiteral("missing.example.test")).error(), QHostInfo::HostNotFound);
+    QCOMPARE(server->udpQueries, queries);
+}
+
+void tst_QDnsResolver::negativeAnswerWithoutSoa()
+{
+    // Without an SOA record there is no negative TTL, so nothing is cached
+    server->sendSoa = false;
+    QCOMPARE(lookup(QStringLiteral("nosoa.example.test")).error(), QHostInfo::HostNotFound);
+    const int queries = server->udpQueries;
+    QVERIFY(queries > 0);
+
+    QCOMPARE(lookup(QStringLiteral("nosoa.example.test")).error(), QHostInfo::HostNotFound);
+    QCOMPARE(server->udpQueries, 2 * queries);
+}
+
+void tst_QDnsResolver::canonicalName()
+{
+    DnsServer::Zone alias;
+    alias.canonicalName = "target.example.test";
+    server->zones.insert("alias.example.test", alias);
+    server->zones.insert("target.example.test",
+                         { { QHostAddress(QStringLiteral("192.0.2.4")) } });
+
+    const QHostInfo info = lookup(QStringLiteral("alias.example.test"));
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress(QStringLiteral("192.0.2.4")) });
+}
+
+void tst_QDnsResolver::unrelatedRecords()
+{
+    // Addresses for names outside the query and its CNAME chain are ignored
+    DnsServer::Zone zone;
+    zone.addresses = { QHostAddress(QStringLiteral("192.0.2.5")) };
+    zone.unrelatedAddresses = { QHostAddress(QStringLiteral("192.0.2.6")),
+                                QHostAddress(QStringLiteral("2001:db8::6")) };
+    server->zones.insert("mixed.example.test", zone);
+
+    QCOMPARE(lookup(QStringLiteral("mixed.example.test")).addresses(), zone.addresses);
+
+    // and an answer made of them alone is no answer
+    DnsServer::Zone poisoned;
+    poisoned.unrelatedAddresses = zone.unrelatedAddresses;
+    server->zones.insert("poisoned.example.test", poisoned);
+    QVERIFY(lookup(QStringLiteral("poisoned.example.test")).addresses().isEmpty());
+}
+
+void tst_QDnsResolver::truncatedResponse()
+{
+    DnsServer::Zone zone;
+    zone.addresses = { QHostAddress(QStringLiteral("192.0.2.1")) };
+    zone.truncate = true;
+    server->zones.insert("large.example.test", zone);
+
+    const QHostInfo info = lookup(QStringLiteral("large.example.test"));
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), zone.addresses);
+    QVERIFY(server->tcpQueries > 0);
+}
+
+void tst_QDnsResolver::serverFailure()
+{
+    // the failing server is skipped in favour of the next one
+    DnsServer::Zone failure;
+    failure.rcode = 2; // SERVFAIL
+    server->zones.insert("failover.example.test", failure);
+
+    DnsServer secondServer;
+    QVERIFY(secondServer.listen());
+    secondServer.zones.insert("failover.example.test",
+                              { { QHostAddress(QStringLiteral("192.0.2.2")) } });
+    useResolver({ server.get(), &secondServer });
+
+    const QHostInfo info = lookup(QStringLiteral("failover.example.test"));
+    QCOMPARE(info.error(), QHostInfo::NoError);
+    QCOMPARE(info.addresses(), QList<QHostAddress>{ QHostAddress(QStringLiteral("192.0.2.2")) });
+    QVERIFY(server->udpQueries > 0);
+    QVERIFY(secondServer.udpQueries > 0);
+}
+
+void tst_QDnsResolver::malformedResponse()
+{
+    // The valid record before the broken one is not used either
+    DnsServer::Zone zone;
+    zone.addresses = { QHostAddress(QStringLiteral("192.0.2.3")),
+                       QHostAddress(QStringLiteral("2001:db8::3")) };
+    zone.malformed = true;
+    server->zones.insert("malformed.example.test", zone);
+
+    const QHostInfo info = lookup(QStringLiteral("malformed.example.test"));
+    QVERIFY(server->udpQueries > 0);
+    for (const QHostAddress &address : qAsConst(zone.addresses))
+        QVERIFY(!info.addresses().contains(address));
+}
+
+void tst_QDnsResolver::happyEyeballs()
+{
+#if defined(Q_OS_LINUX)
+    // A listening socket on ::1 whose accept queue is full drops further
+    // SYNs, so connecting to it hangs; 127.0.0.1 on the same port works.
+    const int blackhole = ::socket(AF_INET6, SOCK_STREAM, 0);
+    QVERIFY(blackhole != -1);
+    const auto closeBlackhole = qScopeGuard([blackhole] { ::close(blackhole); });
+    const int on = 1;
+    ::setsockopt(blackhole, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on));
+    sockaddr_in6 address = {};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_loopback;
+    if (::bind(blackhole, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+        QSKIP("IPv6 loopback is not available");
+    QCOMPARE(::listen(blackhole, 0), 0);
+    socklen_t length = sizeof(address);
+    ::getsockname(blackhole, reinterpret_cast<sockaddr *>(&address), &length);
+    const quint16 port = qFromBigEndian(address.sin6_port);
+
+    QTcpServer ipv4Server;
+    if (!ipv4Server.listen(QHostAddress::LocalHost, port))
+        QSKIP("Cannot listen on the same port over IPv4");
+
+    QTcpSocket filler[2];
+    for (QTcpSocket &socket : filler)
+        socket.connectToHost(QHostAddress::LocalHostIPv6, port);
+    QTest::qWait(100);
+
+    server->zones.insert("eyeballs.example.test",
+                         { { QHostAddress(QHostAddress::LocalHostIPv6),
+                             QHostAddress(QHostAddress::LocalHost) } });
+
+    QTcpSocket socket;
+    QElapsedTimer timer;
+    timer.start();
+    socket.connectToHost(QStringLiteral("eyeballs.example.test"), port);
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::ConnectedState, 5000);
+    QVERIFY2(timer.elapsed() < 1000, QByteArray::number(timer.elapsed()));
+    QCOMPARE(socket.peerAddress(), QHostAddress(QHostAddress::LocalHost));
+    QCOMPARE(socket.peerName(), QStringLiteral("eyeballs.example.test"));
+
+    // the connection keeps working once the IPv6 attempt was abandoned
+    QTRY_VERIFY(ipv4Server.hasPendingConnections());
+    std::unique_ptr<QTcpSocket> peer(ipv4Server.nextPendingConnection());
+    socket.write("ping");
+    QTRY_COMPARE(peer->bytesAvailable(), qint64(4));
+    QCOMPARE(peer->readAll(), QByteArray("ping"));
+#else
+    QSKIP("This test needs a listening socket that drops connection attempts");
+#endif
+}
+
+QTEST_MAIN(tst_QDnsResolver)
+#include "tst_qdnsresolver.moc"
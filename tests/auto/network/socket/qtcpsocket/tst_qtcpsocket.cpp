@@ -60,6 +60,7 @@
 #endif
 #include <QRandomGenerator>
 #include <QStringList>
+#include <QTemporaryFile>
 #include <QTcpServer>
 #include <QTcpSocket>
 #ifndef QT_NO_SSL
@@ -201,6 +202,7 @@ private slots:
     void serverDisconnectWithBuffered();
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
+    void writeFile();
     void readNotificationsAfterBind();
 
 protected slots:
@@ -3197,6 +3199,63 @@ void tst_QTcpSocket::writeOnReadBufferOverflow()
     delete socket;
 }
 
+// Test that file regions are sent in order with the data written around them
+void tst_QTcpSocket::writeFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QByteArray contents;
+    for (int i = 0; i < 200000; ++i)
+        contents.append(char('a' + i % 26));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer tcpServer;
+    QTcpSocket *socket = newSocket();
+
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::writeFile: socket is not open for writing");
+    QCOMPARE(socket->writeFile(&file), qint64(-1));
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY2(tcpServer.waitForNewConnection(5000), "Network timeout");
+    QTcpSocket *newConnection = tcpServer.nextPendingConnection();
+    QVERIFY(newConnection != nullptr);
+
+    QSignalSpy bytesWrittenSpy(socket, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(socket->write("head"), qint64(4));
+    QCOMPARE(socket->writeFile(&file, 10, 100000), qint64(100000));
+    QCOMPARE(socket->write("middle"), qint64(6));
+    QCOMPARE(socket->writeFile(&file, 150000), qint64(50000));
+    QCOMPARE(socket->writeFile(&file, contents.size()), qint64(0));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    const QByteArray expected = "head" + contents.mid(10, 100000) + "middle"
+            + contents.mid(150000) + "tail";
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        socket->flush();
+        if (!newConnection->bytesAvailable())
+            QVERIFY(newConnection->waitForReadyRead(5000));
+        received += newConnection->readAll();
+    }
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    qint64 bytesWritten = 0;
+    for (const QList<QVariant> &arguments : qAsConst(bytesWrittenSpy))
+        bytesWritten += arguments.at(0).toLongLong();
+    QCOMPARE(bytesWritten, qint64(expected.size()));
+
+    delete newConnection;
+    delete socket;
+}
+
 // Test that the socket does not enable the read notifications in bind()
 void tst_QTcpSocket::readNotificationsAfterBind()
 {
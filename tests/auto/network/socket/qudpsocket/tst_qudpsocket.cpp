@@ -90,6 +90,7 @@ private slots:
     void bindAndConnectToHost();
     void pendingDatagramSize();
     void writeDatagram();
+    void batchedDatagrams();
     void performance();
     void bindMode();
     void writeDatagramToNonExistingPeer_data();
@@ -911,6 +912,86 @@ void tst_QUdpSocket::writeDatagram()
     }
 }
 
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+    QVERIFY2(receiver.bind(QHostAddress::LocalHost, 0), receiver.errorString().toLatin1().constData());
+    QUdpSocket sender;
+    QVERIFY2(sender.bind(QHostAddress::LocalHost, 0), sender.errorString().toLatin1().constData());
+
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 20; ++i) {
+        QNetworkDatagram datagram(QByteArray(i + 1, char('a' + i)), QHostAddress::LocalHost,
+                                  receiver.localPort());
+        datagrams.append(datagram);
+    }
+
+    QSignalSpy bytesspy(&sender, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(sender.writeDatagrams(datagrams), qsizetype(datagrams.size()));
+    QCOMPARE(bytesspy.count(), 1);
+    QCOMPARE(bytesspy.at(0).at(0).toLongLong(), qint64(20 * 21 / 2));
+    QCOMPARE(sender.writeDatagrams(QList<QNetworkDatagram>()), qsizetype(0));
+
+    QList<QNetworkDatagram> received;
+    while (received.size() < datagrams.size()) {
+        if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(5000))
+            QSKIP("UDP packets lost, unable to complete the test.");
+        // a batch may hold fewer datagrams than asked for
+        received += receiver.receiveDatagrams(16, 32);
+    }
+
+    QCOMPARE(received.size(), datagrams.size());
+    for (int i = 0; i < received.size(); ++i) {
+        const QNetworkDatagram &datagram = received.at(i);
+        QVERIFY(datagram.isValid());
+        QCOMPARE(datagram.data(), datagrams.at(i).data());
+        QCOMPARE(datagram.senderAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(datagram.senderPort(), int(sender.localPort()));
+        QCOMPARE(datagram.destinationPort(), int(receiver.localPort()));
+    }
+    QVERIFY(!receiver.hasPendingDatagrams());
+
+    // datagrams larger than maxSize are truncated
+    QCOMPARE(sender.writeDatagrams(datagrams.mid(15)), qsizetype(5));
+    received.clear();
+    while (received.size() < 5) {
+        if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(5000))
+            QSKIP("UDP packets lost, unable to complete the test.");
+        received += receiver.receiveDatagrams(5, 17);
+    }
+    for (int i = 0; i < received.size(); ++i)
+        QCOMPARE(received.at(i).data(), datagrams.at(15 + i).data().left(17));
+
+    // the default size fits datagrams larger than the first pending one
+    QNetworkDatagram large(QByteArray(4000, 'x'), QHostAddress::LocalHost, receiver.localPort());
+    QCOMPARE(sender.writeDatagrams(QList<QNetworkDatagram>() << datagrams.at(0) << large),
+             qsizetype(2));
+    received.clear();
+    while (received.size() < 2) {
+        if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(5000))
+            QSKIP("UDP packets lost, unable to complete the test.");
+        received += receiver.receiveDatagrams(2);
+    }
+    QCOMPARE(received.at(0).data(), datagrams.at(0).data());
+    QCOMPARE(received.at(1).data(), large.data());
+
+    // an IPv4 socket cannot send to IPv6 destinations, so the batch is
+    // rejected before anything is sent
+    QSignalSpy errorspy(&sender, &QUdpSocket::errorOccurred);
+    bytesspy.clear();
+    QNetworkDatagram ipv6(QByteArray("ipv6"), QHostAddress::LocalHostIPv6, receiver.localPort());
+    QCOMPARE(sender.writeDatagrams(QList<QNetworkDatagram>() << datagrams.at(0) << ipv6),
+             qsizetype(-1));
+    QCOMPARE(sender.error(), QAbstractSocket::UnsupportedSocketOperationError);
+    QCOMPARE(errorspy.count(), 1);
+    QCOMPARE(bytesspy.count(), 0);
+    QVERIFY(!receiver.waitForReadyRead(100));
+}
+
 void tst_QUdpSocket::performance()
 {
     QByteArray arr(8192, '@');
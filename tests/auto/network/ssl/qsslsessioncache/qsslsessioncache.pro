@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qsslsessioncache
+SOURCES += tst_qsslsessioncache.cpp
+
+QT = core network network-private testlib
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,492 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/private/qsslsessioncache_p.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslsocket.h>
+#include <QtNetwork/qtcpserver.h>
+
+#include <QtCore/qprocess.h>
+#include <QtCore/qstandardpaths.h>
+
+#include <memory>
+
+// Accepts TLS connections and echoes what it receives.
+class SslServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QSslConfiguration configuration;
+    QByteArray received;
+    qint64 earlyBytes = -1; // readable when encrypted() was emitted
+    int connections = 0;
+
+protected:
+    void incomingConnection(qintptr handle) override
+    {
+        auto socket = new QSslSocket(this);
+        if (!socket->setSocketDescriptor(handle)) {
+            delete socket;
+            return;
+        }
+        ++connections;
+        earlyBytes = -1;
+        socket->setSslConfiguration(configuration);
+        connect(socket, &QSslSocket::encrypted, this, [this, socket] {
+            earlyBytes = socket->bytesAvailable();
+        });
+        connect(socket, &QSslSocket::readyRead, this, [this, socket] {
+            const QByteArray data = socket->readAll();
+            received += data;
+            socket->write(data);
+        });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        socket->startServerEncryption();
+    }
+};
+
+// QSslSocket does not accept early data, so the early data tests talk to
+// "openssl s_server": it prints what it receives and sends what it reads
+// from its standard input.
+class OpenSslServer
+{
+public:
+    ~OpenSslServer() { stop(); }
+
+    bool start(quint16 port, bool earlyData)
+    {
+        const QString program = QStandardPaths::findExecutable(QStringLiteral("openssl"));
+        if (program.isEmpty())
+            return false;
+        QStringList arguments = { QStringLiteral("s_server"), QStringLiteral("-tls1_3"),
+                                  QStringLiteral("-accept"), QString::number(port),
+                                  QStringLiteral("-cert"), QStringLiteral(SRCDIR "certs/fluke.cert"),
+                                  QStringLiteral("-key"), QStringLiteral(SRCDIR "certs/fluke.key") };
+        if (earlyData)
+            arguments << QStringLiteral("-early_data");
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process.start(program, arguments);
+        if (!process.waitForStarted())
+            return false;
+        QDeadlineTimer deadline(10000);
+        while (!output().contains("ACCEPT\n") && process.state() == QProcess::Running
+               && !deadline.hasExpired()) {
+            process.waitForReadyRead(int(deadline.remainingTime()));
+        }
+        return output().contains("ACCEPT\n");
+    }
+
+    void stop()
+    {
+        if (process.state() == QProcess::NotRunning)
+            return;
+        process.kill();
+        process.waitForFinished();
+    }
+
+    QByteArray output()
+    {
+        received += process.readAllStandardOutput();
+        return received;
+    }
+
+    QProcess process;
+    QByteArray received;
+};
+
+class tst_QSslSessionCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void cacheKey();
+    void takeIsSingleUse();
+    void boundedSize();
+    void expiredSessions();
+
+    void resumesCachedSession();
+    void configurationChangesKey();
+    void disabledBySessionSharingOption();
+    void serverRefusesEarlyData();
+    void earlyDataAccepted();
+    void earlyDataRejected();
+    void networkAccessManagerEarlyData();
+
+private:
+    QSslConfiguration clientConfiguration() const;
+    void roundTrip(const QSslConfiguration &configuration, const QByteArray &payload);
+    bool startOpenSslServer(bool earlyData);
+    void openSslRoundTrip(const QSslConfiguration &configuration, const QByteArray &payload);
+
+    QSslConfiguration serverConfiguration;
+    SslServer server;
+    OpenSslServer openSslServer;
+    quint16 openSslPort = 0;
+};
+
+void tst_QSslSessionCache::initTestCase()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("TLS is not supported");
+    if (QSslSocket::sslLibraryVersionNumber() < 0x10101000L)
+        QSKIP("These tests need TLS 1.3 (OpenSSL 1.1.1)");
+
+    QFile keyFile(SRCDIR "certs/fluke.key");
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+    serverConfiguration = QSslConfiguration::defaultConfiguration();
+    serverConfiguration.setPrivateKey(QSslKey(keyFile.readAll(), QSsl::Rsa));
+    const auto certificates = QSslCertificate::fromPath(SRCDIR "certs/fluke.cert");
+    QVERIFY(!certificates.isEmpty());
+    serverConfiguration.setLocalCertificate(certificates.first());
+    serverConfiguration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    serverConfiguration.setProtocol(QSsl::TlsV1_3OrLater);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+}
+
+void tst_QSslSessionCache::init()
+{
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    cache->setMaximumSize(QSslSessionCache::DefaultMaximumSize);
+    cache->clear();
+    cache->resetStatistics();
+
+    server.configuration = serverConfiguration;
+    server.received.clear();
+    server.connections = 0;
+    openSslServer.stop();
+}
+
+QSslConfiguration tst_QSslSessionCache::clientConfiguration() const
+{
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setProtocol(QSsl::TlsV1_3OrLater);
+    return configuration;
+}
+
+// Connects, sends payload before the handshake even started and waits for
+// it to come back, which also delivers the server's session tickets.
+void tst_QSslSessionCache::roundTrip(const QSslConfiguration &configuration,
+                                     const QByteArray &payload)
+{
+    server.received.clear();
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    QByteArray echo;
+    connect(&socket, &QSslSocket::readyRead, this, [&] { echo += socket.readAll(); });
+    socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server.serverPort());
+    socket.write(payload);
+    QTRY_COMPARE(echo, payload);
+    QVERIFY(socket.isEncrypted());
+    QCOMPARE(server.received, payload);
+    socket.disconnectFromHost();
+}
+
+// Starts "openssl s_server", on the same port each time in a test function
+// so that the client can try to resume its session.
+bool tst_QSslSessionCache::startOpenSslServer(bool earlyData)
+{
+    if (!openSslPort) {
+        QTcpServer probe;
+        if (!probe.listen(QHostAddress::LocalHost))
+            return false;
+        openSslPort = probe.serverPort();
+    }
+    openSslServer.stop();
+    openSslServer.received.clear();
+    return openSslServer.start(openSslPort, earlyData);
+}
+
+// Like roundTrip(), with openSslServer answering "pong". The clean shutdown
+// matters: the server drops a session that ends without a close_notify.
+void tst_QSslSessionCache::openSslRoundTrip(const QSslConfiguration &configuration,
+                                            const QByteArray &payload)
+{
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    QByteArray answer;
+    connect(&socket, &QSslSocket::readyRead, this, [&] { answer += socket.readAll(); });
+    socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), openSslPort);
+    socket.write(payload);
+    QTRY_VERIFY(openSslServer.output().contains(payload));
+    QVERIFY(socket.isEncrypted());
+    openSslServer.process.write("pong\n");
+    QTRY_COMPARE(answer, QByteArray("pong\n"));
+    socket.disconnectFromHost();
+    QTRY_COMPARE(socket.state(), QAbstractSocket::UnconnectedState);
+}
+
+void tst_QSslSessionCache::cacheKey()
+{
+    const QSslConfiguration configuration = clientConfiguration();
+    const QByteArray key = QSslSessionCache::cacheKey(QStringLiteral("example.com"), 443, configuration);
+    QCOMPARE(QSslSessionCache::cacheKey(QStringLiteral("Example.COM"), 443, configuration), key);
+    QVERIFY(QSslSessionCache::cacheKey(QStringLiteral("example.org"), 443, configuration) != key);
+    QVERIFY(QSslSessionCache::cacheKey(QStringLiteral("example.com"), 8443, configuration) != key);
+
+    QSslConfiguration other = configuration;
+    other.setPeerVerifyMode(QSslSocket::VerifyPeer);
+    QVERIFY(QSslSessionCache::cacheKey(QStringLiteral("example.com"), 443, other) != key);
+    other = configuration;
+    other.setAllowedNextProtocols({ QByteArrayLiteral("http/1.1") });
+    QVERIFY(QSslSessionCache::cacheKey(QStringLiteral("example.com"), 443, other) != key);
+
+    // Options handled by Qt itself do not change the handshake.
+    other = configuration;
+    other.setBackendConfigurationOption("Qt-early-data", true);
+    QCOMPARE(QSslSessionCache::cacheKey(QStringLiteral("example.com"), 443, other), key);
+}
+
+void tst_QSslSessionCache::takeIsSingleUse()
+{
+    QSslSessionCache cache;
+    cache.insert("a", "first", 0);
+    cache.insert("a", "second", 0);
+    cache.insert("a", "third", 0);
+    QCOMPARE(cache.size(), int(QSslSessionCache::SessionsPerPeer));
+
+    QCOMPARE(cache.take("a"), QByteArray("third"));
+    QCOMPARE(cache.take("a"), QByteArray("second"));
+    QVERIFY(cache.take("a").isEmpty());
+    QVERIFY(cache.take("b").isEmpty());
+    QCOMPARE(cache.size(), 0);
+
+    const QSslSessionCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.insertions, quint64(3));
+    QCOMPARE(statistics.evictions, quint64(1));
+    QCOMPARE(statistics.lookups, quint64(4));
+    QCOMPARE(statistics.hits, quint64(2));
+    QCOMPARE(statistics.hitRate(), 0.5);
+}
+
+void tst_QSslSessionCache::boundedSize()
+{
+    QSslSessionCache cache;
+    cache.setMaximumSize(4);
+    for (const char *key : { "a", "b", "c" }) {
+        cache.insert(key, QByteArray(key) + "1", 0);
+        cache.insert(key, QByteArray(key) + "2", 0);
+    }
+    // "a" was the least recently used peer.
+    QCOMPARE(cache.size(), 4);
+    QCOMPARE(cache.statistics().evictions, quint64(2));
+    QVERIFY(cache.take("a").isEmpty());
+    QCOMPARE(cache.take("b"), QByteArray("b2"));
+
+    cache.setMaximumSize(1);
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.take("c"), QByteArray());
+    QCOMPARE(cache.take("b"), QByteArray("b1"));
+
+    cache.setMaximumSize(0);
+    cache.insert("d", "d1", 0);
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.take("d").isEmpty());
+}
+
+void tst_QSslSessionCache::expiredSessions()
+{
+    QSslSessionCache cache;
+    cache.insert("a", "short", 1);
+    cache.insert("a", "long", 60);
+    QTest::qWait(1100);
+    QCOMPARE(cache.take("a"), QByteArray("long"));
+    QVERIFY(cache.take("a").isEmpty());
+    QCOMPARE(cache.statistics().expirations, quint64(1));
+}
+
+void tst_QSslSessionCache::resumesCachedSession()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    roundTrip(clientConfiguration(), "ping");
+    if (QTest::currentTestFailed())
+        return;
+    QSslSessionCache::Statistics statistics = cache->statistics();
+    QCOMPARE(statistics.lookups, quint64(1));
+    QCOMPARE(statistics.hits, quint64(0));
+    QVERIFY(statistics.insertions > 0);
+    QCOMPARE(statistics.resumptions, quint64(0));
+
+    roundTrip(clientConfiguration(), "pong");
+    if (QTest::currentTestFailed())
+        return;
+    statistics = cache->statistics();
+    QCOMPARE(statistics.lookups, quint64(2));
+    QCOMPARE(statistics.hits, quint64(1));
+    QCOMPARE(statistics.resumptions, quint64(1));
+    QCOMPARE(statistics.resumptionRate(), 1.0);
+    QCOMPARE(server.connections, 2);
+}
+
+void tst_QSslSessionCache::configurationChangesKey()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    roundTrip(clientConfiguration(), "ping");
+    if (QTest::currentTestFailed())
+        return;
+
+    QSslConfiguration other = clientConfiguration();
+    other.setPeerVerifyDepth(3);
+    roundTrip(other, "pong");
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(cache->statistics().hits, quint64(0));
+
+    roundTrip(clientConfiguration(), "ping");
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(cache->statistics().hits, quint64(1));
+    QCOMPARE(cache->statistics().resumptions, quint64(1));
+}
+
+void tst_QSslSessionCache::disabledBySessionSharingOption()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+    roundTrip(configuration, "ping");
+    if (QTest::currentTestFailed())
+        return;
+    roundTrip(configuration, "pong");
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(cache->statistics().lookups, quint64(0));
+    QCOMPARE(cache->size(), 0);
+}
+
+void tst_QSslSessionCache::serverRefusesEarlyData()
+{
+    // Early data can be replayed, so a server socket ignores the option and
+    // its session tickets do not let the client send any.
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    server.configuration.setBackendConfigurationOption("Qt-early-data", true);
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setBackendConfigurationOption("Qt-early-data", true);
+    roundTrip(configuration, "hello");
+    if (QTest::currentTestFailed())
+        return;
+    roundTrip(configuration, "early hello");
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(server.earlyBytes, qint64(0));
+    QCOMPARE(cache->statistics().resumptions, quint64(1));
+    QCOMPARE(cache->statistics().earlyDataAccepted, quint64(0));
+    QCOMPARE(cache->statistics().earlyDataRejected, quint64(0));
+}
+
+void tst_QSslSessionCache::earlyDataAccepted()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    if (!startOpenSslServer(true))
+        QSKIP("openssl s_server is not available");
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setBackendConfigurationOption("Qt-early-data", true);
+
+    // The first handshake is a full one, nothing to resume yet.
+    openSslRoundTrip(configuration, "hello");
+    if (QTest::currentTestFailed())
+        return;
+    QTRY_VERIFY(openSslServer.output().contains("No early data received"));
+    QCOMPARE(cache->statistics().earlyDataAccepted, quint64(0));
+
+    openSslRoundTrip(configuration, "early hello");
+    if (QTest::currentTestFailed())
+        return;
+    QTRY_VERIFY(openSslServer.output().contains("End of early data"));
+    QCOMPARE(cache->statistics().earlyDataAccepted, quint64(1));
+    QCOMPARE(cache->statistics().resumptions, quint64(1));
+}
+
+void tst_QSslSessionCache::earlyDataRejected()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    if (!startOpenSslServer(true))
+        QSKIP("openssl s_server is not available");
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setBackendConfigurationOption("Qt-early-data", true);
+    openSslRoundTrip(configuration, "hello");
+    if (QTest::currentTestFailed())
+        return;
+
+    // The session allows early data, but the restarted server no longer
+    // takes it: the data must arrive anyway, after the handshake.
+    if (!startOpenSslServer(false))
+        QSKIP("openssl s_server is not available");
+    openSslRoundTrip(configuration, "early hello");
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(cache->statistics().earlyDataRejected, quint64(1));
+    QCOMPARE(cache->statistics().earlyDataAccepted, quint64(0));
+}
+
+void tst_QSslSessionCache::networkAccessManagerEarlyData()
+{
+    const QSslSessionCache *cache = QSslSessionCache::instance();
+    if (!startOpenSslServer(true))
+        QSKIP("openssl s_server is not available");
+
+    QSslConfiguration configuration = clientConfiguration();
+    configuration.setBackendConfigurationOption("Qt-early-data", true);
+    QNetworkRequest request(QUrl(QStringLiteral("https://127.0.0.1:%1/").arg(openSslPort)));
+    request.setSslConfiguration(configuration);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+
+    for (int i = 0; i < 2; ++i) {
+        openSslServer.received.clear();
+        QNetworkAccessManager manager;
+        std::unique_ptr<QNetworkReply> reply(manager.get(request));
+        QTRY_VERIFY(openSslServer.output().contains("GET / HTTP/1.1\r\n"));
+        QTRY_VERIFY(openSslServer.output().contains("\r\n\r\n"));
+        openSslServer.process.write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), QByteArray("ok"));
+        // QNetworkAccessManager does not wait for its close_notify to go
+        // out, and the server would then drop the session: close from there.
+        openSslServer.process.write("q\n");
+        QTRY_VERIFY(openSslServer.output().contains("DONE\n"));
+    }
+    QTRY_VERIFY(openSslServer.output().contains("End of early data"));
+    QCOMPARE(cache->statistics().resumptions, quint64(1));
+    QCOMPARE(cache->statistics().earlyDataAccepted, quint64(1));
+}
+
+QTEST_MAIN(tst_QSslSessionCache)
+#include "tst_qsslsessioncache.moc"
@@ -9,7 +9,8 @@ SUBDIRS=\
    qsslerror
 
 qtConfig(ssl) {
-    SUBDIRS += qsslkey
+    SUBDIRS += qsslkey \
+               qsslsessioncache
     qtConfig(private_tests) {
         SUBDIRS += \
             qsslsocket \
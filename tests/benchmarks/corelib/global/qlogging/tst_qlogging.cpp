@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/private/qlogging_p.h>
+#include <QtTest/QTest>
+
+#include <stdio.h>
+
+// Measures what logging a message costs the thread that logs it, with the
+// message handler writing formatted messages to the null device like a slow
+// sink would, for synchronous and asynchronous logging.
+class tst_QLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void callerCost_data();
+    void callerCost();
+
+private:
+    static void nullDeviceHandler(QtMsgType type, const QMessageLogContext &context,
+                                  const QString &message);
+    static FILE *nullDevice;
+};
+
+FILE *tst_QLogging::nullDevice = nullptr;
+
+void tst_QLogging::nullDeviceHandler(QtMsgType type, const QMessageLogContext &context,
+                                     const QString &message)
+{
+    const QByteArray formatted = qFormatLogMessage(type, context, message).toLocal8Bit();
+    fwrite(formatted.constData(), 1, formatted.size(), nullDevice);
+    fputc('\n', nullDevice);
+    fflush(nullDevice);
+}
+
+void tst_QLogging::initTestCase()
+{
+#ifdef Q_OS_WIN
+    nullDevice = fopen("NUL", "w");
+#else
+    nullDevice = fopen("/dev/null", "w");
+#endif
+    QVERIFY(nullDevice);
+}
+
+void tst_QLogging::cleanupTestCase()
+{
+    fclose(nullDevice);
+}
+
+void tst_QLogging::cleanup()
+{
+    QtPrivate::setAsyncLoggingEnabled(false);
+    qInstallMessageHandler(nullptr);
+}
+
+enum LoggingMode { Synchronous, AsyncBlock, AsyncDrop };
+Q_DECLARE_METATYPE(LoggingMode)
+
+void tst_QLogging::callerCost_data()
+{
+    QTest::addColumn<LoggingMode>("mode");
+    QTest::addColumn<int>("threadCount");
+
+    const int maxThreads = qMax(QThread::idealThreadCount() * 2, 8);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        const QByteArray suffix = ':' + QByteArray::number(threads);
+        QTest::newRow("sync" + suffix) << Synchronous << threads;
+        QTest::newRow("async-block" + suffix) << AsyncBlock << threads;
+        QTest::newRow("async-drop" + suffix) << AsyncDrop << threads;
+    }
+}
+
+// Reports the average time a call to qInfo() takes in the logging threads.
+void tst_QLogging::callerCost()
+{
+    QFETCH(LoggingMode, mode);
+    QFETCH(int, threadCount);
+    constexpr int MessageCount = 20000;
+
+    qInstallMessageHandler(nullDeviceHandler);
+    qSetMessagePattern(QStringLiteral("%{time} [%{type}] %{threadid} %{category}: %{message}"));
+    if (mode != Synchronous) {
+        QtPrivate::AsyncLoggingOptions options;
+        if (mode == AsyncDrop)
+            options.overflowPolicy = QtPrivate::LogOverflowPolicy::Drop;
+        QtPrivate::setAsyncLoggingEnabled(true, options);
+    }
+
+    QList<qint64> elapsed(threadCount);
+    QList<QThread *> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.append(QThread::create([&elapsed, t] {
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < MessageCount; ++i)
+                qInfo("message %d of thread %d with a payload of typical length", i, t);
+            elapsed[t] = timer.nsecsElapsed();
+        }));
+    }
+    for (QThread *thread : qAsConst(threads))
+        thread->start();
+    for (QThread *thread : qAsConst(threads))
+        QVERIFY(thread->wait());
+    qDeleteAll(threads);
+    QVERIFY(QtPrivate::flushAsyncLogging());
+
+    qint64 total = 0;
+    for (qint64 e : qAsConst(elapsed))
+        total += e;
+    QTest::setBenchmarkResult(qreal(total) / (qint64(threadCount) * MessageCount),
+                              QTest::WalltimeNanoseconds);
+}
+
+QTEST_MAIN(tst_QLogging)
+
+#include "tst_qlogging.moc"
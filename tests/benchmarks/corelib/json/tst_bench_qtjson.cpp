@@ -28,7 +28,9 @@
 
 #include <QtTest>
 #include <qjsondocument.h>
+#include <qjsonarray.h>
 #include <qjsonobject.h>
+#include <qjsonstreamreader.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -43,8 +45,18 @@ private Q_SLOTS:
     void cleanup();
 
     void parseNumbers();
+    void serializeNumbers();
+    void doubleToText_data();
+    void doubleToText();
+    void textToDouble();
     void parseJson();
     void parseJsonToVariant();
+    void parseLargeDocument_data();
+    void parseLargeDocument();
+    void streamJson();
+    void streamJsonFromDevice();
+    void streamThroughput_data();
+    void streamThroughput();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -89,6 +101,95 @@ void BenchmarkQtJson::parseNumbers()
     }
 }
 
+void BenchmarkQtJson::serializeNumbers()
+{
+    QString testFile = QFINDTESTDATA("numbers.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file numbers.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QBENCHMARK {
+        QByteArray json = doc.toJson(QJsonDocument::Compact);
+    }
+}
+
+static QList<double> benchmarkDoubles()
+{
+    QList<double> values;
+    values.reserve(1000);
+    double value = 1.0 / 7;
+    for (int i = 0; i < 1000; ++i) {
+        values.append(value);
+        value = value * -3.7 + 0.123;
+        if (qAbs(value) > 1e12)
+            value = 1 / value;
+    }
+    return values;
+}
+
+void BenchmarkQtJson::doubleToText_data()
+{
+    QTest::addColumn<int>("sink");
+    QTest::newRow("QByteArray::number") << 0;
+    QTest::newRow("QString::number") << 1;
+    QTest::newRow("QTextStream") << 2;
+    QTest::newRow("QJsonDocument") << 3;
+}
+
+void BenchmarkQtJson::doubleToText()
+{
+    QFETCH(int, sink);
+    const QList<double> values = benchmarkDoubles();
+    QJsonArray array;
+    for (double value : values)
+        array.append(value);
+
+    // the total length keeps the results from being optimized away
+    qsizetype length = 0;
+    QBENCHMARK {
+        switch (sink) {
+        case 0:
+            for (double value : values)
+                length += QByteArray::number(value, 'g', QLocale::FloatingPointShortest).size();
+            break;
+        case 1:
+            for (double value : values)
+                length += QString::number(value, 'g', QLocale::FloatingPointShortest).size();
+            break;
+        case 2: {
+            QString text;
+            QTextStream stream(&text);
+            stream.setRealNumberPrecision(QLocale::FloatingPointShortest);
+            for (double value : values)
+                stream << value << ' ';
+            stream.flush();
+            length += text.size();
+            break;
+        }
+        case 3:
+            length += QJsonDocument(array).toJson(QJsonDocument::Compact).size();
+            break;
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+void BenchmarkQtJson::textToDouble()
+{
+    QStringList texts;
+    for (double value : benchmarkDoubles())
+        texts.append(QString::number(value, 'g', QLocale::FloatingPointShortest));
+
+    double sum = 0;
+    QBENCHMARK {
+        for (const QString &text : qAsConst(texts))
+            sum += text.toDouble();
+    }
+    QVERIFY(qIsFinite(sum));
+}
+
 void BenchmarkQtJson::parseJson()
 {
     QString testFile = QFINDTESTDATA("test.json");
@@ -117,6 +218,142 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseLargeDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    const QByteArray testJson = QJsonDocument::fromJson(file.readAll()).toJson(QJsonDocument::Compact);
+
+    constexpr int Size = 8 * 1024 * 1024;
+    auto makeArray = [](const QByteArray &element) {
+        QByteArray data = "[";
+        while (data.size() < Size)
+            data += element + ',';
+        data.back() = ']';
+        return data;
+    };
+
+    const QByteArray compact = makeArray(testJson);
+    QTest::newRow("compact") << compact;
+    QTest::newRow("indented") << QJsonDocument::fromJson(compact).toJson(QJsonDocument::Indented);
+    QTest::newRow("integers") << makeArray("[1, -23, 456, 7890123, -4567890123456]");
+    QTest::newRow("doubles") << makeArray("[0.5, -2.25, 3.14159, 1.5e-7, 6.02214076e23]");
+    QTest::newRow("ascii-strings") << makeArray('"' + QByteArray(200, 'a') + '"');
+    QTest::newRow("utf8-strings")
+            << makeArray('"' + QByteArray(50, 'a') + QByteArray("\xc3\xa9\xe2\x82\xac").repeated(20) + '"');
+    QTest::newRow("escaped-strings")
+            << makeArray('"' + QByteArray(100, 'a') + "\\n\\\"" + QByteArray(100, 'b') + '"');
+}
+
+// Reports the parsing throughput of QJsonDocument::fromJson() for several
+// megabytes of JSON of different shapes
+void BenchmarkQtJson::parseLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QElapsedTimer timer;
+    timer.start();
+    int rounds = 0;
+    do {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        ++rounds;
+    } while (timer.elapsed() < 1000);
+
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+    QTest::setBenchmarkResult(qreal(json.size()) * rounds * 1e9 / elapsed,
+                              QTest::BytesPerSecond);
+}
+
+static int readAllTokens(QJsonStreamReader &reader)
+{
+    int count = 0;
+    while (reader.readNext() != QJsonStreamReader::NoToken) {
+        if (reader.tokenType() == QJsonStreamReader::Invalid)
+            return -1;
+        if (reader.tokenType() == QJsonStreamReader::Number)
+            reader.toDouble();
+        ++count;
+    }
+    return count;
+}
+
+void BenchmarkQtJson::streamJson()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        QVERIFY(readAllTokens(reader) > 0);
+    }
+}
+
+void BenchmarkQtJson::streamJsonFromDevice()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+
+    QBENCHMARK {
+        file.seek(0);
+        QJsonStreamReader reader(&file);
+        QVERIFY(readAllTokens(reader) > 0);
+    }
+}
+
+void BenchmarkQtJson::streamThroughput_data()
+{
+    QTest::addColumn<bool>("streaming");
+
+    QTest::newRow("QJsonDocument") << false;
+    QTest::newRow("QJsonStreamReader") << true;
+}
+
+// Reports the parsing throughput for a few megabytes of JSON
+void BenchmarkQtJson::streamThroughput()
+{
+    QFETCH(bool, streaming);
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    const QByteArray testJson = file.readAll();
+
+    QByteArray data = "[";
+    while (data.size() < 8 * 1024 * 1024)
+        data += testJson + ',';
+    data.back() = ']';
+
+    QElapsedTimer timer;
+    timer.start();
+    int rounds = 0;
+    do {
+        if (streaming) {
+            QJsonStreamReader reader(data);
+            QVERIFY(readAllTokens(reader) > 0);
+        } else {
+            QJsonDocument doc = QJsonDocument::fromJson(data);
+            QVERIFY(doc.isArray());
+        }
+        ++rounds;
+    } while (timer.elapsed() < 1000);
+
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+    QTest::setBenchmarkResult(qreal(data.size()) * rounds * 1e9 / elapsed,
+                              QTest::BytesPerSecond);
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
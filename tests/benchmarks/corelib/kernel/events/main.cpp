@@ -30,6 +30,12 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#include <private/qeventdispatcher_unix_p.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +89,30 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class SignalProducer : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void produced(int value);
+};
+
+class SignalConsumer : public QObject
+{
+    Q_OBJECT
+
+public:
+    int expected = 0;
+    int received = 0;
+
+public slots:
+    void consume(int)
+    {
+        if (++received == expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +126,10 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void socketNotifiers_data();
+    void socketNotifiers();
+    void crossThreadSignals_data();
+    void crossThreadSignals();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +203,118 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::socketNotifiers_data()
+{
+    QTest::addColumn<bool>("epoll");
+    QTest::addColumn<int>("count");
+    for (int count : { 10, 100, 1000, 10000, 50000 }) {
+        QTest::addRow("poll, %d notifiers", count) << false << count;
+#ifdef Q_OS_LINUX
+        QTest::addRow("epoll, %d notifiers", count) << true << count;
+#endif
+    }
+}
+
+void EventsBench::socketNotifiers()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("This benchmark requires QEventDispatcherUNIX");
+#else
+    QFETCH(bool, epoll);
+    QFETCH(int, count);
+
+    rlimit limit;
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    const rlim_t needed = rlim_t(count) + 64;
+    if (limit.rlim_cur < needed) {
+        if (limit.rlim_max < needed)
+            QSKIP("Not enough file descriptors available");
+        limit.rlim_cur = needed;
+        QCOMPARE(setrlimit(RLIMIT_NOFILE, &limit), 0);
+    }
+
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", epoll ? "1" : "0");
+    QEventDispatcherUNIX dispatcher;
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+
+    // The read end of the pipe never becomes readable; every idle notifier
+    // watches a duplicate of it. The write end is always ready, so each
+    // iteration has exactly one notifier to activate.
+    int fds[2];
+    QCOMPARE(pipe(fds), 0);
+
+    QList<QSocketNotifier *> notifiers;
+    notifiers.reserve(count + 1);
+    for (int i = 0; i < count; ++i) {
+        int fd = dup(fds[0]);
+        QVERIFY(fd >= 0);
+        notifiers << new QSocketNotifier(fd, QSocketNotifier::Read);
+    }
+    notifiers << new QSocketNotifier(fds[1], QSocketNotifier::Write);
+
+    // take the notifiers away from the thread's own dispatcher
+    for (QSocketNotifier *notifier : qAsConst(notifiers)) {
+        notifier->setEnabled(false);
+        dispatcher.registerSocketNotifier(notifier);
+    }
+
+    QBENCHMARK {
+        dispatcher.processEvents(QEventLoop::AllEvents);
+    }
+
+    for (QSocketNotifier *notifier : qAsConst(notifiers)) {
+        dispatcher.unregisterSocketNotifier(notifier);
+        if (notifier->socket() != fds[1])
+            close(notifier->socket());
+    }
+    qDeleteAll(notifiers);
+    close(fds[0]);
+    close(fds[1]);
+#endif
+}
+
+void EventsBench::crossThreadSignals_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("producers");
+    for (int producers : { 1, 4 }) {
+        QTest::addRow("queued, %d producers", producers) << false << producers;
+        QTest::addRow("batched, %d producers", producers) << true << producers;
+    }
+}
+
+void EventsBench::crossThreadSignals()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, producers);
+    const int emissions = 100000;
+
+    SignalProducer producer;
+    SignalConsumer consumer;
+    Qt::ConnectionType type = Qt::QueuedConnection;
+    if (batched)
+        type = Qt::ConnectionType(type | Qt::BatchedConnection);
+    connect(&producer, &SignalProducer::produced, &consumer, &SignalConsumer::consume, type);
+
+    QBENCHMARK {
+        consumer.received = 0;
+        consumer.expected = producers * emissions;
+        QList<QThread *> threads;
+        for (int i = 0; i < producers; ++i) {
+            threads << QThread::create([&producer] {
+                for (int j = 0; j < emissions; ++j)
+                    emit producer.produced(j);
+            });
+            threads.last()->start();
+        }
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -51,6 +51,7 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void object_churn_benchmark();
 
     void stdAllocator();
 };
@@ -305,6 +306,26 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+// Exercises the allocations internal to QObject: the d-pointer, connections
+// and queued meta-call events. Run with QT_OBJECT_SLAB_ALLOCATOR=1 to compare
+// against the pooling allocator.
+void QObjectBenchmark::object_churn_benchmark()
+{
+    Object sender;
+    QBENCHMARK {
+        QObject parent;
+        for (int i = 0; i < 64; ++i) {
+            Object *receiver = new Object;
+            receiver->setParent(&parent);
+            QObject::connect(&sender, &Object::signal0, receiver, &Object::slot0);
+            QObject::connect(&sender, &Object::signal0, receiver, &Object::slot0,
+                             Qt::QueuedConnection);
+        }
+        emit sender.signal0();
+        QCoreApplication::sendPostedEvents();
+    }
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
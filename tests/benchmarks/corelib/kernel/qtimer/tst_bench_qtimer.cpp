@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qtimer.h>
+#include <QtTest/QtTest>
+
+#include <memory>
+#include <vector>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void restartBasicTimers_data();
+    void restartBasicTimers();
+    void restartTimers_data();
+    void restartTimers();
+    void startAndStopBasicTimers_data();
+    void startAndStopBasicTimers();
+};
+
+static void addTimerRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    for (int count : { 1000, 10000, 100000 }) {
+        QTest::addRow("precise, %d timers", count) << count << Qt::PreciseTimer;
+        QTest::addRow("coarse, %d timers", count) << count << Qt::CoarseTimer;
+        QTest::addRow("very coarse, %d timers", count) << count << Qt::VeryCoarseTimer;
+    }
+}
+
+// Idle timeouts of a few seconds, spread out so that the timers don't
+// all share the same expiry time.
+static int interval(int i)
+{
+    return 5000 + (i * 7) % 10000;
+}
+
+void tst_QTimer::restartBasicTimers_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::restartBasicTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    std::vector<QBasicTimer> timers(count);
+    for (int i = 0; i < count; ++i)
+        timers[i].start(interval(i), timerType, this);
+
+    // restarting a running timer stops and starts it again, like a
+    // per-connection idle timeout being reset on activity
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            timers[i].start(interval(i), timerType, this);
+    }
+}
+
+void tst_QTimer::restartTimers_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::restartTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    std::vector<std::unique_ptr<QTimer>> timers;
+    timers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        timers.emplace_back(new QTimer);
+        timers.back()->setTimerType(timerType);
+        timers.back()->setInterval(interval(i));
+        timers.back()->start();
+    }
+
+    QBENCHMARK {
+        for (const auto &timer : timers)
+            timer->start();
+    }
+}
+
+void tst_QTimer::startAndStopBasicTimers_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::startAndStopBasicTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    // timers that are stopped in a different order than they were started
+    std::vector<QBasicTimer> timers(count);
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            timers[i].start(interval(i), timerType, this);
+        for (int i = 0; i < count; i += 2)
+            timers[i].stop();
+        for (int i = 1; i < count; i += 2)
+            timers[i].stop();
+    }
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_bench_qtimer.moc"
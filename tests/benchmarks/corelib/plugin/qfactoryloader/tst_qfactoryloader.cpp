@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDirIterator>
+#include <QtCore/QLibrary>
+#include <QtCore/QLibraryInfo>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QStandardPaths>
+#include <QtTest/QtTest>
+#ifdef QT_BUILD_INTERNAL
+#include <private/qpluginmetadatacache_p.h>
+#endif
+
+class tst_bench_QFactoryLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void scanPlugins_data();
+    void scanPlugins();
+
+private:
+    QStringList plugins;
+};
+
+void tst_bench_QFactoryLoader::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    const QString pluginsPath = QLibraryInfo::path(QLibraryInfo::PluginsPath);
+    QDirIterator it(pluginsPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString fileName = it.next();
+        if (QLibrary::isLibrary(fileName))
+            plugins << it.fileInfo().canonicalFilePath();
+    }
+    if (plugins.isEmpty())
+        QSKIP("No plugins found in the Qt plugin directory");
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        QSKIP("The plugin metadata cache is disabled");
+}
+
+void tst_bench_QFactoryLoader::cleanupTestCase()
+{
+#ifdef QT_BUILD_INTERNAL
+    if (QPluginMetaDataCache *cache = QPluginMetaDataCache::instance())
+        cache->clear();
+#endif
+}
+
+void tst_bench_QFactoryLoader::scanPlugins_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("uncached") << false;
+    QTest::newRow("cached") << true;
+}
+
+// Reads the metadata of every plugin shipped with Qt, which is what happens
+// on application startup when the plugin directories are scanned.
+void tst_bench_QFactoryLoader::scanPlugins()
+{
+    QFETCH(bool, cached);
+
+#ifdef QT_BUILD_INTERNAL
+    QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+    QVERIFY(cache);
+    cache->clear();
+#endif
+
+    const auto scanAll = [this]() {
+        qsizetype found = 0;
+        for (const QString &fileName : qAsConst(plugins)) {
+            // the QLibraryPrivate is destroyed with the loader, so every
+            // iteration starts from scratch
+            QPluginLoader loader(fileName);
+            if (!loader.metaData().isEmpty())
+                ++found;
+        }
+        return found;
+    };
+
+    // the first scan fills the cache, the public switch bypasses it
+    const qsizetype expected = scanAll();
+    if (!cached)
+        qputenv("QT_NO_PLUGIN_CACHE", "1");
+#ifdef QT_BUILD_INTERNAL
+    else
+        cache->save();
+#endif
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = scanAll();
+    }
+    qunsetenv("QT_NO_PLUGIN_CACHE");
+    QCOMPARE(found, expected);
+}
+
+QTEST_MAIN(tst_bench_QFactoryLoader)
+
+#include "tst_qfactoryloader.moc"
@@ -48,6 +48,13 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void fromUtf8_data();
+    void fromUtf8();
+    void toUtf8_data() { fromUtf8_data(); }
+    void toUtf8();
+    void isValidUtf8_data() { fromUtf8_data(); }
+    void isValidUtf8();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -187,6 +194,74 @@ void tst_QString::toCaseFolded()
     }
 }
 
+void tst_QString::fromUtf8_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    // about 4 kB of text in each script, with the spaces and punctuation of
+    // real text
+    auto repeated = [](const char *sample) {
+        QByteArray result;
+        while (result.size() < 4096)
+            result += sample;
+        return result;
+    };
+
+    QTest::newRow("ascii") << repeated("The quick brown fox jumps over the lazy dog. ");
+    QTest::newRow("latin1") << repeated("Voix ambigu\xc3\xab d'un c\xc5\x93ur qui au z\xc3\xa9phyr "
+                                        "pr\xc3\xa9" "f\xc3\xa8re les jattes de kiwis. ");
+    QTest::newRow("greek") << repeated("\xce\xa4\xce\xb1\xcf\x87\xce\xaf\xcf\x83\xcf\x84\xce\xb7 "
+                                       "\xce\xb1\xce\xbb\xcf\x8e\xcf\x80\xce\xb7\xce\xbe "
+                                       "\xce\xb2\xce\xb1\xcf\x86\xce\xae\xcf\x82 (fox). ");
+    QTest::newRow("cyrillic") << repeated("\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 "
+                                          "\xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+                                          "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85 "
+                                          "\xd0\xb1\xd1\x83\xd0\xbb\xd0\xbe\xd0\xba. ");
+    QTest::newRow("cjk") << repeated("\xe6\x95\x8f\xe6\x8d\xb7\xe7\x9a\x84\xe6\xa3\x95\xe8\x89\xb2"
+                                     "\xe7\x8b\x90\xe7\x8b\xb8\xe8\xb7\xb3\xe8\xbf\x87\xe4\xba\x86"
+                                     "\xe9\x82\xa3\xe5\x8f\xaa\xe6\x87\x92\xe7\x8b\x97\xe3\x80\x82");
+    QTest::newRow("cjk+ascii") << repeated("Qt \xe6\x98\xaf\xe4\xb8\x80\xe4\xb8\xaa C++ "
+                                           "\xe6\xa1\x86\xe6\x9e\xb6 (framework), "
+                                           "\xe7\x89\x88\xe6\x9c\xac 6.0. ");
+    QTest::newRow("emoji") << repeated("\xf0\x9f\x98\x80\xf0\x9f\x91\x8d\xf0\x9f\x8e\x89 ok! "
+                                       "\xf0\x9f\x90\xb1\xf0\x9f\x90\xb6 ");
+    QTest::newRow("mixed") << repeated("Caf\xc3\xa9 \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0 "
+                                       "\xe6\x9d\xb1\xe4\xba\xac \xf0\x9f\x97\xbc "
+                                       "\xce\x91\xce\xb8\xce\xae\xce\xbd\xce\xb1 -> 42. ");
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    QBENCHMARK {
+        QString::fromUtf8(utf8);
+    }
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QByteArray, utf8);
+    const QString s = QString::fromUtf8(utf8);
+
+    QByteArray r;
+    QBENCHMARK {
+        r = s.toUtf8();
+    }
+    QVERIFY(!r.isEmpty());
+}
+
+void tst_QString::isValidUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    bool result = false;
+    QBENCHMARK {
+        result = QByteArrayView(utf8).isValidUtf8();
+    }
+    QVERIFY(result);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtCore/QStringTokenizer>
+#include <QtTest/QtTest>
+#include <private/qstringrope_p.h>
+
+class tst_bench_QStringRope : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void randomEdits_data();
+    void randomEdits();
+    void typing_data() { randomEdits_data(); }
+    void typing();
+    void tokenizeLines_data() { randomEdits_data(); }
+    void tokenizeLines();
+};
+
+enum { EditCount = 1000 };
+
+static QString sampleText(qsizetype size)
+{
+    const QString line = QStringLiteral("The quick brown fox jumps over the lazy dog.\n");
+    QString text;
+    text.reserve(size + line.size());
+    while (text.size() < size)
+        text += line;
+    text.truncate(size);
+    return text;
+}
+
+template <class String>
+static void editRandomly(String &s)
+{
+    const QString word = QStringLiteral("inserted ");
+    quint32 state = 1;
+    for (int i = 0; i < EditCount; ++i) {
+        state = state * 1103515245u + 12345u;
+        const qsizetype position = qsizetype((state >> 8) % quint32(s.size()));
+        if (state & 0x80)
+            s.insert(position, word);
+        else
+            s.remove(position, word.size());
+    }
+}
+
+void tst_bench_QStringRope::randomEdits_data()
+{
+    QTest::addColumn<bool>("rope");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 10000, 1000000, 10000000 }) {
+        const QByteArray suffix = ", " + QByteArray::number(size) + " chars";
+        QTest::newRow(("QString" + suffix).constData()) << false << size;
+        QTest::newRow(("QStringRope" + suffix).constData()) << true << size;
+    }
+}
+
+void tst_bench_QStringRope::randomEdits()
+{
+    QFETCH(bool, rope);
+    QFETCH(int, size);
+    const QString text = sampleText(size);
+
+    if (rope) {
+        QBENCHMARK {
+            QStringRope s(text);
+            editRandomly(s);
+        }
+    } else {
+        QBENCHMARK {
+            QString s = text;
+            editRandomly(s);
+        }
+    }
+}
+
+// Appends characters one at a time in the middle of the text, as an editor
+// does when typing.
+void tst_bench_QStringRope::typing()
+{
+    QFETCH(bool, rope);
+    QFETCH(int, size);
+    const QString text = sampleText(size);
+    const qsizetype cursor = size / 2;
+
+    if (rope) {
+        QBENCHMARK {
+            QStringRope s(text);
+            for (int i = 0; i < EditCount; ++i)
+                s.insert(cursor + i, QStringView(u"x"));
+        }
+    } else {
+        QBENCHMARK {
+            QString s = text;
+            for (int i = 0; i < EditCount; ++i)
+                s.insert(cursor + i, u'x');
+        }
+    }
+}
+
+void tst_bench_QStringRope::tokenizeLines()
+{
+    QFETCH(bool, rope);
+    QFETCH(int, size);
+    QString text = sampleText(size);
+    // a rope after some editing, with the text spread over many pieces
+    QStringRope edited(text);
+    editRandomly(edited);
+    text = edited.toString();
+
+    qsizetype total = 0;
+    if (rope) {
+        QBENCHMARK {
+            for (QStringView line : edited.tokenize(u'\n'))
+                total += line.size();
+        }
+    } else {
+        QBENCHMARK {
+            for (QStringView line : QStringTokenizer(text, u'\n'))
+                total += line.size();
+        }
+    }
+    QVERIFY(total > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QStringRope)
+
+#include "main.moc"
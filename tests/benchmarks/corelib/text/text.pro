@@ -4,6 +4,7 @@ SUBDIRS = \
         qchar \
         qlocale \
         qstringbuilder \
-        qstringlist
+        qstringlist \
+        qstringrope
 
 *g++*: SUBDIRS += qstring
@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void manyTinyTasks_data();
+    void manyTinyTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,66 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class CountingRunnable : public QRunnable
+{
+public:
+    CountingRunnable(QThreadPool *pool, QAtomicInt *counter, int depth)
+        : pool(pool), counter(counter), depth(depth)
+    { }
+
+    void run() override
+    {
+        // spawn a binary tree of tasks from within the pool
+        if (depth > 0) {
+            pool->start(new CountingRunnable(pool, counter, depth - 1));
+            pool->start(new CountingRunnable(pool, counter, depth - 1));
+        }
+        counter->fetchAndAddRelaxed(1);
+    }
+
+private:
+    QThreadPool *pool;
+    QAtomicInt *counter;
+    int depth;
+};
+
+void tst_QThreadPool::manyTinyTasks_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<bool>("fromPool");
+
+    QTest::newRow("global queue, started externally") << false << false;
+    QTest::newRow("global queue, started from pool threads") << false << true;
+    QTest::newRow("work stealing, started externally") << true << false;
+    QTest::newRow("work stealing, started from pool threads") << true << true;
+}
+
+void tst_QThreadPool::manyTinyTasks()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(bool, fromPool);
+
+    // a tree of this depth has 2^17 - 1 nodes
+    const int depth = 16;
+    const int taskCount = (1 << (depth + 1)) - 1;
+
+    qputenv("QT_THREADPOOL_WORK_STEALING", workStealing ? "1" : "0");
+    QThreadPool threadPool;
+    qunsetenv("QT_THREADPOOL_WORK_STEALING");
+
+    QAtomicInt counter;
+    QBENCHMARK {
+        counter.storeRelaxed(0);
+        if (fromPool) {
+            threadPool.start(new CountingRunnable(&threadPool, &counter, depth));
+        } else {
+            for (int i = 0; i < taskCount; ++i)
+                threadPool.start(new CountingRunnable(&threadPool, &counter, 0));
+        }
+        threadPool.waitForDone();
+    }
+    QCOMPARE(counter.loadRelaxed(), taskCount);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
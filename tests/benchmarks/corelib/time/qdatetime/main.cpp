@@ -31,6 +31,7 @@
 #include <QTest>
 #include <QList>
 #include <qdebug.h>
+#include <private/qdatetime_p.h>
 
 class tst_QDateTime : public QObject
 {
@@ -77,6 +78,9 @@ private Q_SLOTS:
     void toString();
     void toStringTextFormat();
     void toStringIsoFormat();
+    void toStringIsoFixedFormat();
+    void toStringRfcFormat();
+    void toStringRfcFixedFormat();
     void addDays();
     void addDaysTz();
     void addMSecs();
@@ -97,9 +101,14 @@ private Q_SLOTS:
     void fromString();
     void fromStringText();
     void fromStringIso();
+    void fromStringIsoUtf8();
+    void fromStringRfc();
+    void fromStringRfcUtf8();
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
+    void localTimeFromEpochThroughput();
+    void localTimeToEpochThroughput();
 };
 
 QList<QDateTime> tst_QDateTime::daily(qint64 start, qint64 end)
@@ -337,6 +346,35 @@ void tst_QDateTime::toStringIsoFormat()
     }
 }
 
+void tst_QDateTime::toStringIsoFixedFormat()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    char buffer[QDateTimeFixedFormat::IsoMaxLength];
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            QDateTimeFixedFormat::formatIso(test, buffer, sizeof(buffer));
+    }
+}
+
+void tst_QDateTime::toStringRfcFormat()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            test.toString(Qt::RFC2822Date);
+    }
+}
+
+void tst_QDateTime::toStringRfcFixedFormat()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    char buffer[QDateTimeFixedFormat::Rfc2822MaxLength];
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            QDateTimeFixedFormat::formatRfc2822(test, buffer, sizeof(buffer));
+    }
+}
+
 void tst_QDateTime::addDays()
 {
     const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2020);
@@ -538,6 +576,33 @@ void tst_QDateTime::fromStringIso()
     }
 }
 
+void tst_QDateTime::fromStringIsoUtf8()
+{
+    const QUtf8StringView input = u8"2010-01-01T13:28:34.999+01:00";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTimeFixedFormat::fromString(input, Qt::ISODate);
+    }
+}
+
+void tst_QDateTime::fromStringRfc()
+{
+    QString input = "Fri, 01 Jan 2010 13:28:34 +0100";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::RFC2822Date);
+    }
+}
+
+void tst_QDateTime::fromStringRfcUtf8()
+{
+    const QUtf8StringView input = u8"Fri, 01 Jan 2010 13:28:34 +0100";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTimeFixedFormat::fromString(input, Qt::RFC2822Date);
+    }
+}
+
 void tst_QDateTime::fromMSecsSinceEpoch()
 {
     const int start = JULIAN_DAY_2010 - JULIAN_DAY_1970;
@@ -569,6 +634,33 @@ void tst_QDateTime::fromMSecsSinceEpochTz()
     }
 }
 
+// Hourly timestamps over a decade, in both directions between UTC and local
+// time, as when processing logs.
+void tst_QDateTime::localTimeFromEpochThroughput()
+{
+    const qint64 start = qint64(JULIAN_DAY_2010 - JULIAN_DAY_1970) * MSECS_PER_DAY;
+    const qint64 end = qint64(JULIAN_DAY_2020 - JULIAN_DAY_1970) * MSECS_PER_DAY;
+    int offsets = 0;
+    QBENCHMARK {
+        for (qint64 msecs = start; msecs < end; msecs += 3600 * 1000)
+            offsets += QDateTime::fromMSecsSinceEpoch(msecs).offsetFromUtc();
+    }
+    Q_UNUSED(offsets);
+}
+
+void tst_QDateTime::localTimeToEpochThroughput()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2020);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const QDateTime &day : list) {
+            for (int hour = 0; hour < 24; ++hour)
+                sum += day.addSecs(hour * 3600 + 1800).toMSecsSinceEpoch();
+        }
+    }
+    Q_UNUSED(sum);
+}
+
 QTEST_MAIN(tst_QDateTime)
 
 #include "main.moc"
@@ -1,5 +1,5 @@
 CONFIG += benchmark
-QT = core testlib
+QT = core-private testlib
 
 TARGET = tst_bench_qdatetime
 SOURCES += main.cpp
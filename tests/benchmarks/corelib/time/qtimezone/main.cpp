@@ -49,6 +49,10 @@ private Q_SLOTS:
     void transitionsForward();
     void transitionsReverse_data() { transitionList_data(); }
     void transitionsReverse();
+    void offsetFromUtc_data() { transitionList_data(); }
+    void offsetFromUtc();
+    void toTimeZoneThroughput_data() { transitionList_data(); }
+    void toTimeZoneThroughput();
 };
 
 static QList<QByteArray> enoughZones()
@@ -161,6 +165,34 @@ void tst_QTimeZone::transitionsReverse()
     }
 }
 
+void tst_QTimeZone::offsetFromUtc()
+{
+    QFETCH(QByteArray, name);
+    const QTimeZone zone = name.isEmpty() ? QTimeZone::systemTimeZone() : QTimeZone(name);
+    const QDateTime start = QDate(2000, 1, 1).startOfDay(Qt::UTC);
+    const QDateTime end = QDate(2030, 1, 1).startOfDay(Qt::UTC);
+    int sum = 0;
+    QBENCHMARK {
+        for (QDateTime when = start; when < end; when = when.addDays(7))
+            sum += zone.offsetFromUtc(when);
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_QTimeZone::toTimeZoneThroughput()
+{
+    QFETCH(QByteArray, name);
+    const QTimeZone zone = name.isEmpty() ? QTimeZone::systemTimeZone() : QTimeZone(name);
+    const qint64 start = QDate(2015, 1, 1).startOfDay(Qt::UTC).toMSecsSinceEpoch();
+    const qint64 end = QDate(2025, 1, 1).startOfDay(Qt::UTC).toMSecsSinceEpoch();
+    int sum = 0;
+    QBENCHMARK {
+        for (qint64 msecs = start; msecs < end; msecs += 3600 * 1000)
+            sum += QDateTime::fromMSecsSinceEpoch(msecs, zone).time().hour();
+    }
+    Q_UNUSED(sum);
+}
+
 QTEST_MAIN(tst_QTimeZone)
 
 #include "main.moc"
@@ -26,9 +26,13 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <private/qbtreemap_p.h>
 
 #include <qtest.h>
 
+enum Container { Hash, Map, BTreeMap };
+Q_DECLARE_METATYPE(Container)
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -52,30 +56,34 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<Container>("container");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("btreemap--" + sizeString).constData()) << BTreeMap << size;
     }
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
+    case BTreeMap:
+        testInsert<QBTreeMap<int, int> >(size);
+        break;
     }
 }
 
@@ -84,15 +92,16 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<Container>("container");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("btreemap--" + sizeString).constData()) << BTreeMap << size;
     }
 }
 
@@ -115,13 +124,19 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    case BTreeMap:
+        testLookup<QBTreeMap<int, int> >(size);
+        break;
     }
 }
 
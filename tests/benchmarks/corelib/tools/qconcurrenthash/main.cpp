@@ -0,0 +1,230 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QThread>
+#include <QtTest/QtTest>
+#include <private/qconcurrenthash_p.h>
+
+#include <memory>
+#include <vector>
+
+class tst_bench_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readWriteMix_data();
+    void readWriteMix();
+};
+
+enum { KeyCount = 100000, OperationsPerThread = 200000 };
+
+// What a shared cache looks like without QConcurrentHash.
+class LockedHash
+{
+public:
+    bool lookup(int key, qint64 *value) const
+    {
+        QReadLocker locker(&lock);
+        const auto it = hash.constFind(key);
+        if (it == hash.constEnd())
+            return false;
+        *value = *it;
+        return true;
+    }
+
+    void insert(int key, qint64 value)
+    {
+        QWriteLocker locker(&lock);
+        hash.insert(key, value);
+    }
+
+    void remove(int key)
+    {
+        QWriteLocker locker(&lock);
+        hash.remove(key);
+    }
+
+private:
+    mutable QReadWriteLock lock;
+    QHash<int, qint64> hash;
+};
+
+// QHash's span layout behind one lock per shard, the way QConcurrentHash
+// splits its table.
+class StripedHash
+{
+    enum { ShardBits = 6 };
+
+    struct alignas(64) Shard
+    {
+        mutable QReadWriteLock lock;
+        QHash<int, qint64> hash;
+    };
+
+public:
+    bool lookup(int key, qint64 *value) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        const auto it = shard.hash.constFind(key);
+        if (it == shard.hash.constEnd())
+            return false;
+        *value = *it;
+        return true;
+    }
+
+    void insert(int key, qint64 value)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        shard.hash.insert(key, value);
+    }
+
+    void remove(int key)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        shard.hash.remove(key);
+    }
+
+private:
+    const Shard &shardFor(int key) const
+    {
+        return shards[qHash(key, seed) >> (8 * sizeof(size_t) - ShardBits)];
+    }
+    Shard &shardFor(int key)
+    {
+        return shards[qHash(key, seed) >> (8 * sizeof(size_t) - ShardBits)];
+    }
+
+    const size_t seed = qGlobalQHashSeed();
+    Shard shards[1 << ShardBits];
+};
+
+class ConcurrentHash
+{
+public:
+    bool lookup(int key, qint64 *value) const { return hash.lookup(key, value); }
+    void insert(int key, qint64 value) { hash.insert(key, value); }
+    void remove(int key) { hash.remove(key); }
+
+private:
+    QConcurrentHash<int, qint64> hash;
+};
+
+template <class Hash>
+static qint64 runThread(Hash &hash, int seed, int writePercent)
+{
+    quint32 state = seed;
+    qint64 sum = 0;
+    for (int i = 0; i < OperationsPerThread; ++i) {
+        state = state * 1103515245u + 12345u;
+        const int key = int((state >> 8) % KeyCount);
+        if (int(state % 100) < writePercent) {
+            if (state & 0x80)
+                hash.insert(key, i);
+            else
+                hash.remove(key);
+        } else {
+            qint64 value;
+            if (hash.lookup(key, &value))
+                sum += value;
+        }
+    }
+    return sum;
+}
+
+template <class Hash>
+static void runMix(int threadCount, int writePercent)
+{
+    Hash hash;
+    for (int key = 0; key < KeyCount; key += 2)
+        hash.insert(key, key);
+
+    // keep the lookup results, so the reads can't be optimized away
+    QAtomicInteger<qint64> total;
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([&hash, &total, t, writePercent] {
+                total.fetchAndAddRelaxed(runThread(hash, t + 1, writePercent));
+            }));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+    QVERIFY(total.loadRelaxed() > 0);
+}
+
+void tst_bench_QConcurrentHash::readWriteMix_data()
+{
+    QTest::addColumn<int>("implementation");
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("writePercent");
+
+    const int idealThreadCount = qMax(2, QThread::idealThreadCount());
+    for (int threads : { 1, idealThreadCount }) {
+        for (int writePercent : { 0, 10, 50 }) {
+            const QByteArray suffix = QByteArray::number(threads) + " threads, "
+                    + QByteArray::number(writePercent) + "% writes";
+            QTest::newRow(("QReadWriteLock+QHash, " + suffix).constData())
+                    << 0 << threads << writePercent;
+            QTest::newRow(("striped QReadWriteLock+QHash, " + suffix).constData())
+                    << 1 << threads << writePercent;
+            QTest::newRow(("QConcurrentHash, " + suffix).constData())
+                    << 2 << threads << writePercent;
+        }
+    }
+}
+
+void tst_bench_QConcurrentHash::readWriteMix()
+{
+    QFETCH(int, implementation);
+    QFETCH(int, threadCount);
+    QFETCH(int, writePercent);
+
+    switch (implementation) {
+    case 0:
+        runMix<LockedHash>(threadCount, writePercent);
+        break;
+    case 1:
+        runMix<StripedHash>(threadCount, writePercent);
+        break;
+    case 2:
+        runMix<ConcurrentHash>(threadCount, writePercent);
+        break;
+    }
+}
+
+QTEST_MAIN(tst_bench_QConcurrentHash)
+
+#include "main.moc"
@@ -31,6 +31,9 @@
 #include <QString>
 #include <QTest>
 #include <qdebug.h>
+#include <private/qbtreemap_p.h>
+
+#include <random>
 
 
 class tst_QMap : public QObject
@@ -61,6 +64,16 @@ private slots:
     void insertion_string_int2_hint();
 
     void insertMap();
+
+    void randomInsertion_data() { backends(); }
+    void randomInsertion();
+    void randomLookup_data() { backends(); }
+    void randomLookup();
+    void rangeScan_data() { backends(); }
+    void rangeScan();
+
+private:
+    void backends();
 };
 
 
@@ -284,6 +297,102 @@ void tst_QMap::insertMap()
     }
 }
 
+// Compare QMap with the B+tree based QBTreeMap for large maps with random
+// keys, where QMap's node-per-element layout hurts most.
+
+void tst_QMap::backends()
+{
+    QTest::addColumn<bool>("btree");
+
+    QTest::newRow("QMap") << false;
+    QTest::newRow("QBTreeMap") << true;
+}
+
+static QList<qint64> randomKeys(int count)
+{
+    std::mt19937_64 generator(count);
+    QList<qint64> keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
+        keys.append(qint64(generator() >> 1));
+    return keys;
+}
+
+template <class Map>
+static void randomInsertionImpl(const QList<qint64> &keys)
+{
+    QBENCHMARK {
+        Map map;
+        for (qint64 key : keys)
+            map.insert(key, key);
+    }
+}
+
+void tst_QMap::randomInsertion()
+{
+    QFETCH(bool, btree);
+    const QList<qint64> keys = randomKeys(1000000);
+    if (btree)
+        randomInsertionImpl<QBTreeMap<qint64, qint64>>(keys);
+    else
+        randomInsertionImpl<QMap<qint64, qint64>>(keys);
+}
+
+template <class Map>
+static void randomLookupImpl(const QList<qint64> &keys)
+{
+    Map map;
+    for (qint64 key : keys)
+        map.insert(key, key);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (qint64 key : keys)
+            sum += map.value(key);
+    }
+    QVERIFY(sum != 0);
+}
+
+void tst_QMap::randomLookup()
+{
+    QFETCH(bool, btree);
+    const QList<qint64> keys = randomKeys(1000000);
+    if (btree)
+        randomLookupImpl<QBTreeMap<qint64, qint64>>(keys);
+    else
+        randomLookupImpl<QMap<qint64, qint64>>(keys);
+}
+
+template <class Map>
+static void rangeScanImpl(const QList<qint64> &keys)
+{
+    Map map;
+    for (qint64 key : keys)
+        map.insert(key, key);
+
+    // 1000 scans over 1000 consecutive entries each
+    const Map &constMap = map;
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            auto it = constMap.lowerBound(keys.at(i));
+            for (int j = 0; j < 1000 && it != constMap.constEnd(); ++j, ++it)
+                sum += it.value();
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void tst_QMap::rangeScan()
+{
+    QFETCH(bool, btree);
+    const QList<qint64> keys = randomKeys(1000000);
+    if (btree)
+        rangeScanImpl<QBTreeMap<qint64, qint64>>(keys);
+    else
+        rangeScanImpl<QMap<qint64, qint64>>(keys);
+}
+
 QTEST_MAIN(tst_QMap)
 
 #include "main.moc"
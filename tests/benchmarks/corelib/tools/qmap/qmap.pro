@@ -1,5 +1,5 @@
 CONFIG += benchmark
-QT = core testlib
+QT = core-private testlib
 
 INCLUDEPATH += .
 TARGET = tst_bench_qmap
@@ -3,7 +3,9 @@ SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
         qnetworkreply \
         qnetworkreply_from_cache \
-        qnetworkdiskcache
+        qnetworkdiskcache \
+        qhttpserver \
+        qhttpconnectionpool
 
 qtConfig(private_tests): \
     SUBDIRS += \
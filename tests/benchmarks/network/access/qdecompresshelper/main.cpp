@@ -36,6 +36,8 @@ class tst_QDecompressHelper : public QObject
 private slots:
     void decompress_data();
     void decompress();
+    void decompressStreaming_data();
+    void decompressStreaming();
 };
 
 void tst_QDecompressHelper::decompress_data()
@@ -91,6 +93,44 @@ void tst_QDecompressHelper::decompress()
     }
 }
 
+void tst_QDecompressHelper::decompressStreaming_data()
+{
+    decompress_data();
+}
+
+// Feeds the compressed data in network-sized chunks and drains the output in
+// between, the way QHttpNetworkReply drives the helper
+void tst_QDecompressHelper::decompressStreaming()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(QString, fileName);
+
+    QFile file { fileName };
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray compressed = file.readAll();
+    const qsizetype chunkSize = 16 * 1024;
+    QByteArray out(64 * 1024, Qt::Uninitialized);
+    QBENCHMARK {
+        QDecompressHelper helper;
+        helper.setEncoding(encoding);
+        QVERIFY(helper.isValid());
+
+        qsizetype bytes = 0;
+        for (qsizetype offset = 0; offset < compressed.size(); offset += chunkSize) {
+            helper.feed(compressed.mid(offset, chunkSize));
+            while (helper.hasData()) {
+                const qsizetype bytesRead = helper.read(out.data(), out.size());
+                QVERIFY(bytesRead >= 0);
+                if (bytesRead == 0)
+                    break;
+                bytes += bytesRead;
+            }
+        }
+
+        QCOMPARE(bytes, 50 * 1024 * 1024);
+    }
+}
+
 QTEST_MAIN(tst_QDecompressHelper)
 
 #include "main.moc"
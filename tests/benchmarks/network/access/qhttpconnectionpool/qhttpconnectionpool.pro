@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_qhttpconnectionpool
+
+QT -= gui
+QT += core-private network network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_bench_qhttpconnectionpool.cpp
@@ -0,0 +1,231 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// Measures the throughput of QNetworkAccessManager against a server on
+// localhost for different connection pool configurations.
+
+#include <QtTest/QtTest>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtNetwork/private/qhttpserver_p.h>
+#include <QtNetwork/qhttpconnectionpoolconfiguration.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+
+#include <functional>
+#include <memory>
+
+// QTest::qWaitFor() sleeps between its checks, which would dominate
+// the latency of a request; this waits for a notification instead.
+static bool waitFor(const std::function<bool()> &isDone, QEventLoop *loop)
+{
+    QDeadlineTimer deadline(60000);
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, loop, &QEventLoop::quit);
+    timer.start(60000);
+    while (!isDone() && !deadline.hasExpired())
+        loop->exec();
+    return isDone();
+}
+
+// Serves "/<size>" with a body of that size, allowing at most
+// maxStreams concurrent streams on each HTTP/2 connection.
+class ServerThread : public QThread
+{
+public:
+    explicit ServerThread(int maxStreams) : maxStreams(maxStreams) { }
+
+    ~ServerThread() override
+    {
+        quit();
+        wait();
+    }
+
+    quint16 start()
+    {
+        QThread::start();
+        ready.acquire();
+        return port;
+    }
+
+protected:
+    void run() override
+    {
+        QHttpServer server;
+        server.setMaxConcurrentStreams(maxStreams);
+        const QByteArray payload(1024 * 1024, 'x');
+        QObject::connect(&server, &QHttpServer::newRequest,
+                         [&payload](QHttpServerRequest *request, QHttpServerResponse *response) {
+            const int size = request->target().mid(1).toInt();
+            response->end(QByteArray::fromRawData(payload.constData(), size));
+        });
+        server.listen(QHostAddress::LocalHost);
+        port = server.serverPort();
+        ready.release();
+        exec();
+    }
+
+private:
+    QSemaphore ready;
+    int maxStreams;
+    quint16 port = 0;
+};
+
+class tst_bench_QHttpConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void http1_data();
+    void http1();
+    void http2_data();
+    void http2();
+
+private:
+    void run(QNetworkAccessManager *manager, const QNetworkRequest &request, int concurrent);
+
+    std::unique_ptr<ServerThread> serverThread;
+    quint16 port = 0;
+};
+
+void tst_bench_QHttpConnectionPool::initTestCase()
+{
+    serverThread.reset(new ServerThread(8));
+    port = serverThread->start();
+    QVERIFY(port);
+}
+
+// Sends 500 requests, keeping up to concurrent of them in flight
+void tst_bench_QHttpConnectionPool::run(QNetworkAccessManager *manager,
+                                        const QNetworkRequest &request, int concurrent)
+{
+    const int total = 500;
+    QEventLoop loop;
+    int sent = 0;
+    int finished = 0;
+    bool failed = false;
+    std::function<void()> sendRequest = [&]() {
+        ++sent;
+        QNetworkReply *reply = manager->get(request);
+        connect(reply, &QNetworkReply::finished, reply, [&, reply]() {
+            reply->deleteLater();
+            failed |= reply->error() != QNetworkReply::NoError;
+            ++finished;
+            if (sent < total)
+                sendRequest();
+            else if (finished == total)
+                loop.quit();
+        });
+    };
+    for (int i = 0; i < concurrent; ++i)
+        sendRequest();
+    QVERIFY(waitFor([&]() { return finished == total; }, &loop));
+    QVERIFY(!failed);
+}
+
+void tst_bench_QHttpConnectionPool::http1_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("concurrent");
+    QTest::addColumn<int>("size");
+
+    for (int connections : { 1, 6, 16 }) {
+        for (int concurrent : { 1, 16, 64 }) {
+            for (int size : { 0, 16 * 1024 }) {
+                QTest::addRow("%d-connections-%d-concurrent-%dB", connections, concurrent, size)
+                        << connections << concurrent << size;
+            }
+        }
+    }
+}
+
+// HTTP/1.1 requests, spread over up to connections sockets
+void tst_bench_QHttpConnectionPool::http1()
+{
+    QFETCH(int, connections);
+    QFETCH(int, concurrent);
+    QFETCH(int, size);
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    QVERIFY(configuration.setMaximumConnectionsPerHost(connections));
+    manager.setConnectionPoolConfiguration(configuration);
+    QNetworkRequest request(QUrl(QStringLiteral("http://127.0.0.1:%1/%2").arg(port).arg(size)));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    // Opening the connections is not part of the measurement
+    run(&manager, request, connections);
+
+    QBENCHMARK {
+        run(&manager, request, concurrent);
+    }
+}
+
+void tst_bench_QHttpConnectionPool::http2_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("concurrent");
+    QTest::addColumn<int>("size");
+
+    for (int connections : { 1, 4 }) {
+        for (int concurrent : { 8, 32 }) {
+            for (int size : { 0, 16 * 1024 }) {
+                QTest::addRow("%d-connections-%d-concurrent-%dB", connections, concurrent, size)
+                        << connections << concurrent << size;
+            }
+        }
+    }
+}
+
+// HTTP/2 requests with prior knowledge against a server that allows
+// 8 concurrent streams per connection
+void tst_bench_QHttpConnectionPool::http2()
+{
+    QFETCH(int, connections);
+    QFETCH(int, concurrent);
+    QFETCH(int, size);
+
+    QNetworkAccessManager manager;
+    QHttpConnectionPoolConfiguration configuration;
+    QVERIFY(configuration.setMaximumHttp2ConnectionsPerHost(connections));
+    manager.setConnectionPoolConfiguration(configuration);
+    QNetworkRequest request(QUrl(QStringLiteral("http://127.0.0.1:%1/%2").arg(port).arg(size)));
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    run(&manager, request, concurrent);
+
+    QBENCHMARK {
+        run(&manager, request, concurrent);
+    }
+}
+
+QTEST_MAIN(tst_bench_QHttpConnectionPool)
+
+#include "tst_bench_qhttpconnectionpool.moc"
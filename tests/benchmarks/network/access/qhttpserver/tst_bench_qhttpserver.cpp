@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// A load generator for QHttpServer, running against a server on localhost
+// in another thread.
+
+#include <QtTest/QtTest>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtNetwork/private/qhttpserver_p.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qtcpsocket.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// QTest::qWaitFor() sleeps between its checks, which would dominate
+// the latency of a request; this waits for a notification instead.
+static bool waitFor(const std::function<bool()> &isDone, QEventLoop *loop)
+{
+    QDeadlineTimer deadline(60000);
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, loop, &QEventLoop::quit);
+    timer.start(60000);
+    while (!isDone() && !deadline.hasExpired())
+        loop->exec();
+    return isDone();
+}
+
+// Serves "/<size>" with a body of that size, after reading the request body.
+class ServerThread : public QThread
+{
+public:
+    ~ServerThread() override
+    {
+        quit();
+        wait();
+    }
+
+    quint16 start()
+    {
+        QThread::start();
+        ready.acquire();
+        return port;
+    }
+
+protected:
+    void run() override
+    {
+        QHttpServer server;
+        const QByteArray payload(16 * 1024 * 1024, 'x');
+        QObject::connect(&server, &QHttpServer::newRequest,
+                         [&payload](QHttpServerRequest *request, QHttpServerResponse *response) {
+            auto respond = [request, response, &payload]() {
+                request->skip(request->bytesAvailable());
+                if (!request->isBodyComplete() || response->isEnded())
+                    return;
+                const int size = request->target().mid(1).toInt();
+                response->end(QByteArray::fromRawData(payload.constData(), size));
+            };
+            QObject::connect(request, &QIODevice::readyRead, response, respond);
+            QObject::connect(request, &QHttpServerRequest::readChannelFinished, response, respond);
+            respond();
+        });
+        server.listen(QHostAddress::LocalHost);
+        port = server.serverPort();
+        ready.release();
+        exec();
+    }
+
+private:
+    QSemaphore ready;
+    quint16 port = 0;
+};
+
+// Sends GET requests over one connection, keeping up to depth of
+// them in flight, and parses the responses.
+class LoadClient
+{
+public:
+    LoadClient(quint16 port, const QByteArray &target, int depth, QEventLoop *loop)
+        : request("GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n"), loop(loop),
+          depth(depth)
+    {
+        QObject::connect(&socket, &QIODevice::readyRead, [this]() { readResponses(); });
+        socket.connectToHost(QHostAddress::LocalHost, port);
+        socket.waitForConnected();
+    }
+
+    void start(int count)
+    {
+        remaining = count;
+        inFlight = 0;
+        sendRequests();
+    }
+
+    bool isDone() const { return remaining == 0 && inFlight == 0; }
+
+private:
+    void sendRequests()
+    {
+        QByteArray requests;
+        while (inFlight < depth && remaining > 0) {
+            requests += request;
+            ++inFlight;
+            --remaining;
+        }
+        if (!requests.isEmpty())
+            socket.write(requests);
+    }
+
+    void readResponses()
+    {
+        buffer += socket.readAll();
+        forever {
+            if (bodyRemaining < 0) {
+                const int headerEnd = buffer.indexOf("\r\n\r\n", bufferPos);
+                if (headerEnd == -1)
+                    break;
+                const int field = buffer.indexOf("content-length: ", bufferPos);
+                const int fieldEnd = buffer.indexOf("\r\n", field);
+                bodyRemaining = buffer.mid(field + 16, fieldEnd - field - 16).toLongLong();
+                bufferPos = headerEnd + 4;
+            }
+            const qint64 size = qMin(bodyRemaining, qint64(buffer.size() - bufferPos));
+            bufferPos += size;
+            bodyRemaining -= size;
+            if (bodyRemaining > 0)
+                break;
+            bodyRemaining = -1;
+            --inFlight;
+        }
+        buffer.remove(0, bufferPos);
+        bufferPos = 0;
+        sendRequests();
+        if (isDone())
+            loop->quit();
+    }
+
+    QTcpSocket socket;
+    QByteArray request;
+    QByteArray buffer;
+    QEventLoop *loop;
+    int bufferPos = 0;
+    qint64 bodyRemaining = -1;
+    int depth;
+    int remaining = 0;
+    int inFlight = 0;
+};
+
+class tst_bench_QHttpServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void http1_data();
+    void http1();
+    void http2_data();
+    void http2();
+    void upload_data();
+    void upload();
+
+private:
+    std::unique_ptr<ServerThread> serverThread;
+    quint16 port = 0;
+};
+
+void tst_bench_QHttpServer::initTestCase()
+{
+    serverThread.reset(new ServerThread);
+    port = serverThread->start();
+    QVERIFY(port);
+}
+
+void tst_bench_QHttpServer::http1_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("size");
+
+    for (int connections : { 1, 8 }) {
+        for (int depth : { 1, 16 }) {
+            for (int size : { 0, 1024, 64 * 1024 }) {
+                QTest::addRow("%d-connections-depth-%d-%dB", connections, depth, size)
+                        << connections << depth << size;
+            }
+        }
+    }
+}
+
+// Requests over keep-alive connections, pipelined for a depth > 1
+void tst_bench_QHttpServer::http1()
+{
+    QFETCH(int, connections);
+    QFETCH(int, depth);
+    QFETCH(int, size);
+
+    const int requestsPerConnection = 1000 / connections;
+    QEventLoop loop;
+    std::vector<std::unique_ptr<LoadClient>> clients;
+    for (int i = 0; i < connections; ++i)
+        clients.emplace_back(new LoadClient(port, '/' + QByteArray::number(size), depth, &loop));
+
+    QBENCHMARK {
+        for (const auto &client : clients)
+            client->start(requestsPerConnection);
+        QVERIFY(waitFor([&clients]() {
+            return std::all_of(clients.begin(), clients.end(),
+                               [](const std::unique_ptr<LoadClient> &client) {
+                return client->isDone();
+            });
+        }, &loop));
+    }
+}
+
+void tst_bench_QHttpServer::http2_data()
+{
+    QTest::addColumn<int>("concurrent");
+    QTest::addColumn<int>("size");
+
+    for (int concurrent : { 1, 16 }) {
+        for (int size : { 0, 1024, 64 * 1024 })
+            QTest::addRow("%d-streams-%dB", concurrent, size) << concurrent << size;
+    }
+}
+
+// Requests with prior knowledge over one connection, keeping a
+// number of streams open
+void tst_bench_QHttpServer::http2()
+{
+    QFETCH(int, concurrent);
+    QFETCH(int, size);
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request(QUrl(QStringLiteral("http://localhost:%1/%2").arg(port).arg(size)));
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    const int total = 500;
+    QEventLoop loop;
+
+    QBENCHMARK {
+        int sent = 0;
+        int finished = 0;
+        std::function<void()> sendRequest = [&]() {
+            ++sent;
+            QNetworkReply *reply = manager.get(request);
+            connect(reply, &QNetworkReply::finished, reply, [&, reply]() {
+                reply->deleteLater();
+                ++finished;
+                if (sent < total)
+                    sendRequest();
+                else if (finished == total)
+                    loop.quit();
+            });
+        };
+        for (int i = 0; i < concurrent; ++i)
+            sendRequest();
+        QVERIFY(waitFor([&]() { return finished == total; }, &loop));
+    }
+}
+
+void tst_bench_QHttpServer::upload_data()
+{
+    QTest::addColumn<bool>("http2");
+
+    QTest::newRow("http/1.1") << false;
+    QTest::newRow("h2c") << true;
+}
+
+// Streams a request body into the server
+void tst_bench_QHttpServer::upload()
+{
+    QFETCH(bool, http2);
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request(QUrl(QStringLiteral("http://localhost:%1/0").arg(port)));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, http2);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, http2);
+    const QByteArray body(16 * 1024 * 1024, 'u');
+    QEventLoop loop;
+
+    QBENCHMARK {
+        std::unique_ptr<QNetworkReply> reply(manager.post(request, body));
+        connect(reply.get(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        QVERIFY(waitFor([&reply]() { return reply->isFinished(); }, &loop));
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+    }
+}
+
+QTEST_MAIN(tst_bench_QHttpServer)
+
+#include "tst_bench_qhttpserver.moc"
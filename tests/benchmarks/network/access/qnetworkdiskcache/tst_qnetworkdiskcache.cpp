@@ -42,6 +42,8 @@ enum Numbers { NumFakeCacheObjects   = 200,    //entries in pre-populated cache
                NumInsertions  = 100,           //insertions to be timed
                NumRemovals    = 100,           //removals to be timed
                NumReadContent = 100,           //meta requests to be timed
+               NumLargeCacheObjects = 20000,   //entries in a large pre-populated cache
+               NumLargeLookups = 10000,        //lookups to be timed in the large cache
                HugeCacheLimit = 50*1024*1024,  // max size for a big cache
                TinyCacheLimit = 1*512*1024}; //  max size for a tiny cache
 
@@ -53,7 +55,8 @@ class tst_qnetworkdiskcache : public QObject
 {
     Q_OBJECT
 private:
-    void injectFakeData();
+    void injectFakeData(quint32 count = NumFakeCacheObjects);
+    void setupLargeCache(const QString &cacheRootDirectory);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
@@ -77,6 +80,15 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeLargeLookup_data();
+    void timeLargeLookup();
+    void timeLargeInsertion_data();
+    void timeLargeInsertion();
+    void timeLargeExpiration_data();
+    void timeLargeExpiration();
+    void timeLargeReopen_data();
+    void timeLargeReopen();
 };
 
 
@@ -323,11 +335,134 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+void tst_qnetworkdiskcache::timeLargeLookup_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+}
+
+//Times metaData() lookups in a large cache, half of them for
+//URLs that are not cached
+void tst_qnetworkdiskcache::timeLargeLookup()
+{
+    QFETCH(QString, cacheRootDirectory);
+    setupLargeCache(cacheRootDirectory);
+
+    QBENCHMARK_ONCE {
+        for (quint32 i = 0; i < NumLargeLookups; i++) {
+            QUrl url(fakeURLbase + QString::number(i * 4));
+            QNetworkCacheMetaData meta = cache->metaData(url);
+            QCOMPARE(meta.isValid(), i * 4 < NumLargeCacheObjects);
+        }
+    }
+
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeInsertion_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+}
+
+//Times insertions into a large cache that is at its size limit,
+//so that insertions cause evictions
+void tst_qnetworkdiskcache::timeLargeInsertion()
+{
+    QFETCH(QString, cacheRootDirectory);
+    setupLargeCache(cacheRootDirectory);
+    cache->setMaximumCacheSize(cache->cacheSize());
+
+    QBENCHMARK_ONCE {
+        for (quint32 i = NumLargeCacheObjects; i < (NumLargeCacheObjects + NumInsertions); i++) {
+            QNetworkCacheMetaData meta;
+            meta.setUrl(QUrl(fakeURLbase + QString::number(i)));
+            meta.setSaveToDisk(true);
+
+            QIODevice *device = cache->prepare(meta);
+            device->write(payload);
+            cache->insert(device);
+        }
+    }
+
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeExpiration_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+}
+
+//Times shrinking a large cache to half of its size
+void tst_qnetworkdiskcache::timeLargeExpiration()
+{
+    QFETCH(QString, cacheRootDirectory);
+    setupLargeCache(cacheRootDirectory);
+    const qint64 size = cache->cacheSize();
+
+    QBENCHMARK_ONCE {
+        cache->setMaximumCacheSize(size / 2);
+    }
+    QVERIFY(cache->cacheSize() < size / 2);
+
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeReopen_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+}
+
+//Times the first lookup in a large cache that was used before,
+//which has to load the index of the cache
+void tst_qnetworkdiskcache::timeLargeReopen()
+{
+    QFETCH(QString, cacheRootDirectory);
+    setupLargeCache(cacheRootDirectory);
+    cleanupCacheObject();
+
+    QBENCHMARK_ONCE {
+        initCacheObject();
+        cache->setCacheDirectory(cacheDir);
+        QVERIFY(cache->metaData(QUrl(fakeURLbase + QString::number(0))).isValid());
+    }
+
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+//Creates a cache with NumLargeCacheObjects entries
+void tst_qnetworkdiskcache::setupLargeCache(const QString &cacheRootDirectory)
+{
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject();
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+
+    injectFakeData(NumLargeCacheObjects); // SLOW
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
-void tst_qnetworkdiskcache::injectFakeData()
+void tst_qnetworkdiskcache::injectFakeData(quint32 count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -335,7 +470,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (quint32 i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qtcpsocket
+
+QT = network testlib
+
+CONFIG += release
+
+SOURCES += tst_qtcpsocket.cpp
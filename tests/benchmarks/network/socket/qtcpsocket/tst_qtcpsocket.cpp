@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtTest/QtTest>
+#include <QtCore/qtemporaryfile.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+
+class tst_QTcpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sendFile_data();
+    void sendFile();
+
+private:
+    QTemporaryFile file;
+};
+
+void tst_QTcpSocket::initTestCase()
+{
+    QVERIFY(file.open());
+    QByteArray block(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < block.size(); ++i)
+        block[i] = char(i * 7);
+    for (int i = 0; i < 16; ++i)
+        QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.flush());
+}
+
+void tst_QTcpSocket::sendFile_data()
+{
+    // zeroCopy selects QAbstractSocket::writeFile() over reading the file
+    // into memory in chunks and passing them to write()
+    QTest::addColumn<qint64>("size");
+    QTest::addColumn<bool>("zeroCopy");
+    for (qint64 size : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+        QTest::addRow("%lldKiB-write", size / 1024) << size << false;
+        QTest::addRow("%lldKiB-writeFile", size / 1024) << size << true;
+    }
+}
+
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH(qint64, size);
+    QFETCH(bool, zeroCopy);
+    const qint64 chunkSize = 64 * 1024;
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket sender;
+    sender.connectToHost(server.serverAddress(), server.serverPort());
+    QVERIFY(sender.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *receiver = server.nextPendingConnection();
+    QVERIFY(receiver);
+
+    QByteArray buffer(chunkSize, Qt::Uninitialized);
+    QBENCHMARK {
+        qint64 queued = 0;
+        if (zeroCopy) {
+            QCOMPARE(sender.writeFile(&file, 0, size), size);
+            queued = size;
+        } else {
+            QVERIFY(file.seek(0));
+        }
+
+        qint64 received = 0;
+        while (received < size) {
+            // keep at most one chunk buffered, as a server streaming a file would
+            if (queued < size && sender.bytesToWrite() < chunkSize) {
+                const QByteArray chunk = file.read(qMin(chunkSize, size - queued));
+                QCOMPARE(sender.write(chunk), qint64(chunk.size()));
+                queued += chunk.size();
+            }
+            sender.flush();
+            if (!receiver->bytesAvailable())
+                QVERIFY(receiver->waitForReadyRead(5000));
+            received += receiver->read(buffer.data(), buffer.size());
+        }
+        QCOMPARE(sender.bytesToWrite(), qint64(0));
+    }
+}
+
+QTEST_MAIN(tst_QTcpSocket)
+#include "tst_qtcpsocket.moc"
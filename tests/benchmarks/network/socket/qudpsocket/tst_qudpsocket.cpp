@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void datagramThroughput_data();
+    void datagramThroughput();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,61 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::datagramThroughput_data()
+{
+    // batchSize 0 uses writeDatagram()/receiveDatagram() for every datagram
+    QTest::addColumn<int>("batchSize");
+    QTest::addColumn<int>("size");
+    for (int size : {64, 1200}) {
+        for (int batchSize : {0, 1, 16, 64})
+            QTest::addRow("%d-bytes-batch-%d", size, batchSize) << batchSize << size;
+    }
+}
+
+// Each iteration moves 1024 datagrams over the loopback interface, so the
+// packet rate is 1024 divided by the time per iteration
+void tst_QUdpSocket::datagramThroughput()
+{
+    QFETCH(int, batchSize);
+    QFETCH(int, size);
+    const int datagramCount = 1024;
+    // stay well below the default receive buffer size so nothing is dropped
+    const int chunkSize = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    const QNetworkDatagram datagram(QByteArray(size, 'a'), QHostAddress::LocalHost,
+                                    receiver.localPort());
+    const QList<QNetworkDatagram> batch(qMax(batchSize, 1), datagram);
+
+    QBENCHMARK {
+        for (int done = 0; done < datagramCount; done += chunkSize) {
+            for (int sent = 0; sent < chunkSize; ) {
+                if (batchSize) {
+                    const qsizetype result = sender.writeDatagrams(batch);
+                    QVERIFY(result > 0);
+                    sent += result;
+                } else {
+                    QCOMPARE(sender.writeDatagram(datagram), qint64(size));
+                    ++sent;
+                }
+            }
+            for (int received = 0; received < chunkSize; ) {
+                if (!receiver.hasPendingDatagrams())
+                    QVERIFY(receiver.waitForReadyRead(5000));
+                if (batchSize) {
+                    received += receiver.receiveDatagrams(batchSize, size).size();
+                } else {
+                    QVERIFY(receiver.receiveDatagram(size).isValid());
+                    ++received;
+                }
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 SUBDIRS = \
         qlocalsocket \
         qtcpserver \
+        qtcpsocket \
         qudpsocket
@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = tst_bench_qsslsessioncache
+
+QT -= gui
+QT += network network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_bench_qsslsessioncache.cpp
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+// Measures the cost of a TLS connection to a server on localhost, from
+// connectToHostEncrypted() to the first byte echoed back, with a full
+// handshake and with a session resumed from QSslSessionCache. QSslSocket
+// does not accept TLS 1.3 early data, so the server here cannot measure it.
+
+#include <QtTest/QtTest>
+#include <QtNetwork/private/qsslsessioncache_p.h>
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslsocket.h>
+#include <QtNetwork/qtcpserver.h>
+
+#include <functional>
+
+// QTest::qWaitFor() sleeps between its checks, which would dominate
+// the time of a handshake; this waits for a notification instead.
+static bool waitFor(const std::function<bool()> &isDone, QEventLoop *loop)
+{
+    QDeadlineTimer deadline(60000);
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, loop, &QEventLoop::quit);
+    timer.start(60000);
+    while (!isDone() && !deadline.hasExpired())
+        loop->exec();
+    return isDone();
+}
+
+class EchoServer : public QTcpServer
+{
+public:
+    QSslConfiguration configuration;
+
+protected:
+    void incomingConnection(qintptr handle) override
+    {
+        auto socket = new QSslSocket(this);
+        if (!socket->setSocketDescriptor(handle)) {
+            delete socket;
+            return;
+        }
+        socket->setSslConfiguration(configuration);
+        connect(socket, &QSslSocket::readyRead, socket, [socket] {
+            socket->write(socket->readAll());
+        });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        socket->startServerEncryption();
+    }
+};
+
+class tst_QSslSessionCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void handshake_data();
+    void handshake();
+
+private:
+    bool connectAndEcho(const QSslConfiguration &configuration);
+
+    EchoServer server;
+};
+
+void tst_QSslSessionCache::initTestCase()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("TLS is not supported");
+
+    QFile keyFile(SRCDIR "certs/fluke.key");
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPrivateKey(QSslKey(keyFile.readAll(), QSsl::Rsa));
+    const auto certificates = QSslCertificate::fromPath(SRCDIR "certs/fluke.cert");
+    QVERIFY(!certificates.isEmpty());
+    configuration.setLocalCertificate(certificates.first());
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    server.configuration = configuration;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+}
+
+bool tst_QSslSessionCache::connectAndEcho(const QSslConfiguration &configuration)
+{
+    QEventLoop loop;
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    QByteArray echo;
+    connect(&socket, &QSslSocket::readyRead, &loop, [&] {
+        echo += socket.readAll();
+        loop.quit();
+    });
+    connect(&socket, &QSslSocket::errorOccurred, &loop, &QEventLoop::quit);
+    socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server.serverPort());
+    socket.write("x");
+    const bool echoed = waitFor([&] {
+        return !echo.isEmpty() || socket.state() == QAbstractSocket::UnconnectedState;
+    }, &loop);
+    socket.abort();
+    return echoed && echo == "x";
+}
+
+void tst_QSslSessionCache::handshake_data()
+{
+    QTest::addColumn<bool>("resume");
+
+    QTest::newRow("full") << false;
+    QTest::newRow("resumed") << true;
+}
+
+void tst_QSslSessionCache::handshake()
+{
+    QFETCH(bool, resume);
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, !resume);
+
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    cache->clear();
+    QVERIFY(connectAndEcho(configuration)); // leaves a session to resume
+    cache->resetStatistics();
+
+    QBENCHMARK {
+        QVERIFY(connectAndEcho(configuration));
+    }
+
+    const QSslSessionCache::Statistics statistics = cache->statistics();
+    if (resume)
+        QCOMPARE(statistics.resumptions, statistics.lookups);
+    else
+        QCOMPARE(statistics.resumptions, quint64(0));
+}
+
+QTEST_MAIN(tst_QSslSessionCache)
+
+#include "tst_bench_qsslsessioncache.moc"